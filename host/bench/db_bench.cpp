@@ -0,0 +1,104 @@
+// Write amplification de db_store en el PC: la carga de db_manager_benchmark
+// (una muestra por minuto y un ajuste por hora) con commits cada 1, 10 y 60
+// muestras, sobre el dispositivo en RAM y sobre un fichero. Cuenta lo que
+// llega al dispositivo (db_blockdev, no las estadísticas de db_store) por
+// cada byte de payload. RAM y fichero tienen que dar los mismos bytes.
+//
+//   host_db_bench [samples]
+
+#include "controllers/db_manager/db_manager.h"
+#include "config.h"
+#include "esp_timer.h"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+
+#define BENCH_SEGMENTS  16
+#define BENCH_SECTOR    4096
+
+static db_store_t db;       // Estático: no cabe con holgura en la pila
+
+typedef struct {
+    uint64_t user_bytes;
+    uint64_t device_bytes;
+    uint64_t erased_bytes;
+    uint32_t compactions;
+    uint32_t evicted;
+    uint64_t elapsed_us;
+} wa_result_t;
+
+static wa_result_t run(db_blockdev_t* dev, uint32_t samples, uint32_t commit_every) {
+    db_store_open(&db, dev, DB_SEGMENT_BYTES, DB_BATCH_BYTES, 0);
+    db_store_format(&db);
+    const uint64_t written0 = dev->bytes_written;
+    const uint32_t erases0 = dev->erases;
+
+    const int64_t t0 = esp_timer_get_time();
+    for (uint32_t i = 0; i < samples; i++) {
+        const uint32_t v = i * 3;
+        db_store_append(&db, DB_SERIES_STEPS, i, &v, sizeof(v));
+        if (i % 60 == 0) db_store_put(&db, "steps_day", &v, sizeof(v));
+        if (i % commit_every == commit_every - 1) db_store_commit(&db);
+        if (db_store_free_segments(&db) < DB_COMPACT_FREE_SEGMENTS) db_store_compact(&db);
+    }
+    db_store_commit(&db);
+
+    db_store_stats_t st;
+    db_store_get_stats(&db, &st);
+    wa_result_t r;
+    r.user_bytes = st.user_bytes;
+    r.device_bytes = dev->bytes_written - written0;
+    r.erased_bytes = (uint64_t)(dev->erases - erases0) * dev->erase_size;
+    r.compactions = st.compactions;
+    r.evicted = st.evicted_samples;
+    r.elapsed_us = esp_timer_get_time() - t0;
+    db_store_close(&db);
+    return r;
+}
+
+int main(int argc, char** argv) {
+    const uint32_t samples = argc > 1 ? (uint32_t)strtoul(argv[1], nullptr, 10) : DB_BENCH_SAMPLES;
+    static const uint32_t commit_every[] = { 1, 10, 60 };
+    const uint32_t dev_bytes = BENCH_SEGMENTS * DB_SEGMENT_BYTES;
+    if (samples == 0) return 1;
+
+    char tmpl[] = "/tmp/db_bench_XXXXXX";
+    const char* dir = mkdtemp(tmpl);
+    if (!dir) return 1;
+    const std::string path = std::string(dir) + "/db.bin";
+
+    db_blockdev_t* devs[2] = { db_blockdev_ram_create(dev_bytes, BENCH_SECTOR),
+                               db_blockdev_file_open(path.c_str(), dev_bytes, BENCH_SECTOR) };
+    int failures = 0;
+    printf("DBWA,device,samples,commit_every,user_bytes,device_bytes,wa_x100,erased_bytes,erase_x100,compactions,evicted,us_per_sample\n");
+    for (uint32_t every : commit_every) {
+        wa_result_t r[2] = {};
+        for (int d = 0; d < 2; d++) {
+            if (!devs[d]) {
+                failures++;
+                continue;
+            }
+            r[d] = run(devs[d], samples, every);
+            printf("DBWA,%s,%lu,%lu,%llu,%llu,%llu,%llu,%llu,%lu,%lu,%llu\n", devs[d]->name,
+                   (unsigned long)samples, (unsigned long)every, (unsigned long long)r[d].user_bytes,
+                   (unsigned long long)r[d].device_bytes,
+                   (unsigned long long)(r[d].user_bytes ? r[d].device_bytes * 100 / r[d].user_bytes : 0),
+                   (unsigned long long)r[d].erased_bytes,
+                   (unsigned long long)(r[d].user_bytes ? r[d].erased_bytes * 100 / r[d].user_bytes : 0),
+                   (unsigned long)r[d].compactions, (unsigned long)r[d].evicted,
+                   (unsigned long long)(r[d].elapsed_us / samples));
+        }
+        // El backend no cambia lo que escribe db_store
+        if (r[0].device_bytes != r[1].device_bytes || r[0].erased_bytes != r[1].erased_bytes ||
+            r[0].device_bytes < r[0].user_bytes) {
+            fprintf(stderr, "commit_every %lu: RAM y fichero no coinciden\n", (unsigned long)every);
+            failures++;
+        }
+    }
+
+    for (db_blockdev_t* dev : devs) db_blockdev_destroy(dev);
+    remove(path.c_str());
+    rmdir(dir);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,54 @@
+// Benchmark de led_fx en el PC: las mismas líneas LEDBENCH que leds_benchmark
+// en la placa (ver controllers/leds/README.md), con los "ciclos" del reloj de
+// 1 GHz de los shims, es decir, nanosegundos.
+//
+//   host_led_bench [frames]
+
+#include "controllers/leds/led_fx.h"
+#include "config.h"
+#include "esp_cpu.h"
+#include "esp_private/esp_clk.h"
+#include <cstdio>
+#include <cstdlib>
+
+#define MAX_PIXELS 1024
+
+int main(int argc, char** argv) {
+    const uint32_t frames = argc > 1 ? (uint32_t)strtoul(argv[1], nullptr, 10) : LEDS_BENCH_FRAMES;
+    static const uint16_t sizes[] = { 8, 60, 256, MAX_PIXELS };
+    static const led_fx_effect_t effects[] = { LED_FX_SOLID, LED_FX_GRADIENT, LED_FX_BREATHE, LED_FX_SECONDS };
+    static uint8_t buf[MAX_PIXELS * 3];
+    if (frames == 0) return 1;
+
+    led_fx_params_t p = {};
+    p.color = { 255, 96, 0 };
+    p.brightness = LEDS_BRIGHTNESS_DEFAULT;
+    p.period_ms = LEDS_PERIOD_MS_DEFAULT;
+    p.second = 45;
+    for (int i = 0; i < LED_FX_CELLS; i++) {
+        p.seconds[i] = led_fx_hue((uint16_t)(i * LED_FX_HUE_MAX / LED_FX_CELLS));
+    }
+
+    const uint32_t cpu_hz = (uint32_t)esp_clk_cpu_freq();
+    uint32_t checksum = 0;
+    printf("LEDBENCH,effect,pixels,frames,cycles_per_frame,ns_per_pixel,frames_per_s\n");
+    for (led_fx_effect_t effect : effects) {
+        p.effect = effect;
+        for (uint16_t n : sizes) {
+            uint64_t cycles = 0;
+            for (uint32_t f = 0; f < frames; f++) {
+                const uint32_t c0 = esp_cpu_get_cycle_count();
+                led_fx_render(&p, f * 33, buf, n);
+                cycles += esp_cpu_get_cycle_count() - c0;
+                checksum += buf[(f % n) * 3];   // Que el compilador no se salte el frame
+            }
+            const uint32_t per_frame = (uint32_t)(cycles / frames);
+            const uint32_t ns_per_px = (uint32_t)((uint64_t)per_frame * 1000000 / (cpu_hz / 1000) / n);
+            printf("LEDBENCH,%s,%u,%lu,%lu,%lu,%lu\n", led_fx_name(effect), n, (unsigned long)frames,
+                   (unsigned long)per_frame, (unsigned long)ns_per_px,
+                   (unsigned long)(per_frame ? cpu_hz / per_frame : 0));
+        }
+    }
+    fprintf(stderr, "checksum %lu\n", (unsigned long)checksum);
+    return 0;
+}
@@ -0,0 +1,57 @@
+// Benchmark de vistas en el PC: el mismo ui_benchmark que corre en la placa,
+// sobre el display sin panel y el reloj virtual del build de host.
+//
+//   host_view_bench [frames]
+//
+// Imprime las líneas BENCH, STYLEAUDIT y VLISTBENCH (ver
+// controllers/ui_benchmark/README.md) y termina con error si alguna vista deja
+// de comportarse como una vista que solo redibuja lo que cambia.
+
+#include "controllers/ui_benchmark/ui_benchmark.h"
+#include "config.h"
+#include "esp_log.h"
+#include <cstdio>
+#include <cstdlib>
+
+static int failures = 0;
+
+static void expect(bool ok, const ui_benchmark_result_t& r, const char* what) {
+    if (!ok) {
+        fprintf(stderr, "FAIL %s: %s (frames %lu, dirty %lu, inputs %lu, px %llu)\n", r.view, what,
+                (unsigned long)r.frames, (unsigned long)r.dirty_frames, (unsigned long)r.inputs,
+                (unsigned long long)r.invalidated_px);
+        failures++;
+    }
+}
+
+int main(int argc, char** argv) {
+    const uint32_t frames = argc > 1 ? (uint32_t)strtoul(argv[1], nullptr, 10) : UI_BENCHMARK_FRAMES;
+    esp_log_level_set("*", ESP_LOG_WARN);
+
+    screen_t* screen = screen_init();
+    ui_benchmark_run(screen, frames);
+    ui_benchmark_style_audit(screen, THEME_AUDIT_ROUNDS);
+    ui_benchmark_virtual_list(screen, VLIST_BENCH_ITEMS, frames * 10);
+
+    // Con sus timers y sus entradas, cada vista invalida mucho menos que una
+    // pantalla por frame. Clock solo cambia una vez por segundo.
+    const uint64_t full_px = (uint64_t)SCREEN_WIDTH * SCREEN_HEIGHT;
+    ui_benchmark_result_t r;
+
+    ui_benchmark_run_view(screen, VIEW_CLOCK, frames, &r);
+    expect(r.frames == frames, r, "la vista se fue durante la medida");
+    expect(r.dirty_frames > 0, r, "el timer de 1 s no redibujó nada");
+    expect(r.dirty_frames * 4 < r.frames, r, "redibuja casi todos los frames");
+    expect(r.invalidated_px * 8 < r.frames * full_px, r, "invalida demasiado");
+
+    ui_benchmark_run_view(screen, VIEW_SETTINGS, frames, &r);
+    expect(r.inputs > 0, r, "no recibió pulsaciones");
+    expect(r.dirty_frames > 0, r, "las pulsaciones no movieron la selección");
+    expect(r.invalidated_px < r.frames * full_px, r, "invalida la pantalla entera en cada frame");
+
+    ui_benchmark_run_view(screen, VIEW_SPECTRUM, frames, &r);
+    expect(r.dirty_frames > 0, r, "las barras no se movieron");
+    expect(r.invalidated_px < r.frames * full_px, r, "invalida la pantalla entera en cada frame");
+
+    return failures ? 1 : 0;
+}
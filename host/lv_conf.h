@@ -0,0 +1,55 @@
+/**
+ * lv_conf.h del build de host (LVGL 9.2). En la placa LVGL se configura por
+ * Kconfig (CONFIG_LV_CONF_SKIP en sdkconfig); aquí se repiten los valores de
+ * sdkconfig que cambian el render o la memoria. Lo demás queda con los valores
+ * por defecto de lv_conf_internal.h.
+ */
+#ifndef LV_CONF_H
+#define LV_CONF_H
+
+#define LV_COLOR_DEPTH              16
+
+/* El heap lo da mem_manager como en la placa (CONFIG_LV_USE_CUSTOM_MALLOC):
+ * tiers y arenas sobre el multi_heap del shim */
+#define LV_USE_STDLIB_MALLOC        LV_STDLIB_CUSTOM
+#define LV_USE_STDLIB_STRING        LV_STDLIB_BUILTIN
+#define LV_USE_STDLIB_SPRINTF       LV_STDLIB_BUILTIN
+
+#define LV_DEF_REFR_PERIOD          33
+#define LV_DPI_DEF                  130
+#define LV_USE_OS                   LV_OS_NONE
+
+#define LV_DRAW_BUF_STRIDE_ALIGN    1
+#define LV_DRAW_BUF_ALIGN           4
+#define LV_DRAW_LAYER_SIMPLE_BUF_SIZE (24 * 1024)
+#define LV_USE_DRAW_SW              1
+#define LV_DRAW_SW_DRAW_UNIT_CNT    1
+#define LV_DRAW_SW_COMPLEX          1
+#define LV_DRAW_SW_SHADOW_CACHE_SIZE 0
+#define LV_DRAW_SW_CIRCLE_CACHE_SIZE 4
+#define LV_USE_DRAW_SW_ASM          LV_DRAW_SW_ASM_NONE
+#define LV_COLOR_MIX_ROUND_OFS      128
+#define LV_GRADIENT_MAX_STOPS       2
+#define LV_CACHE_DEF_SIZE           0
+#define LV_IMAGE_HEADER_CACHE_DEF_CNT 0
+
+#define LV_USE_LOG                  1
+#define LV_LOG_LEVEL                LV_LOG_LEVEL_WARN
+#define LV_LOG_PRINTF               1
+#define LV_USE_ASSERT_NULL          1
+#define LV_USE_ASSERT_MALLOC        1
+
+#define LV_USE_PRIVATE_API          1
+
+#define LV_FONT_MONTSERRAT_14       1
+#define LV_FONT_MONTSERRAT_20       1
+#define LV_FONT_MONTSERRAT_24       1
+#define LV_FONT_MONTSERRAT_36       1
+#define LV_FONT_DEFAULT             &lv_font_montserrat_14
+
+#define LV_USE_SNAPSHOT             1
+#define LV_USE_THEME_DEFAULT        1
+#define LV_USE_SYSMON               0
+#define LV_BUILD_EXAMPLES           0
+
+#endif /*LV_CONF_H*/
@@ -0,0 +1,6 @@
+#ifndef HOST_BUTTON_GPIO_H
+#define HOST_BUTTON_GPIO_H
+
+#include "iot_button.h"
+
+#endif
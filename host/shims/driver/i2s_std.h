@@ -0,0 +1,154 @@
+#ifndef HOST_DRIVER_I2S_STD_H
+#define HOST_DRIVER_I2S_STD_H
+
+// Build de host: canal I2S de recepción simulado. Reserva dma_desc_num
+// buffers de dma_frame_num muestras de 16 bits, como el driver. Las muestras
+// entran con host_i2s_rx_push; cada buffer que se llena se entrega a on_recv
+// en el hilo que empuja (hace de ISR) y el siguiente buffer del anillo pasa a
+// llenarse, aunque la tarea aún no haya terminado con él.
+
+#include "driver/gpio.h"
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef enum {
+    I2S_NUM_0 = 0,
+    I2S_NUM_1 = 1,
+    I2S_NUM_MAX,
+} i2s_port_t;
+
+typedef enum {
+    I2S_ROLE_MASTER,
+    I2S_ROLE_SLAVE,
+} i2s_role_t;
+
+typedef enum {
+    I2S_DATA_BIT_WIDTH_8BIT = 8,
+    I2S_DATA_BIT_WIDTH_16BIT = 16,
+    I2S_DATA_BIT_WIDTH_24BIT = 24,
+    I2S_DATA_BIT_WIDTH_32BIT = 32,
+} i2s_data_bit_width_t;
+
+typedef enum {
+    I2S_SLOT_BIT_WIDTH_AUTO = 0,
+    I2S_SLOT_BIT_WIDTH_16BIT = 16,
+    I2S_SLOT_BIT_WIDTH_32BIT = 32,
+} i2s_slot_bit_width_t;
+
+typedef enum {
+    I2S_SLOT_MODE_MONO = 1,
+    I2S_SLOT_MODE_STEREO = 2,
+} i2s_slot_mode_t;
+
+typedef enum {
+    I2S_STD_SLOT_LEFT = 1,
+    I2S_STD_SLOT_RIGHT = 2,
+    I2S_STD_SLOT_BOTH = 3,
+} i2s_std_slot_mask_t;
+
+#define I2S_GPIO_UNUSED GPIO_NUM_NC
+
+typedef struct i2s_channel_obj_t* i2s_chan_handle_t;
+
+typedef struct {
+    i2s_port_t id;
+    i2s_role_t role;
+    uint32_t dma_desc_num;
+    uint32_t dma_frame_num;
+    bool auto_clear;
+    int intr_priority;
+} i2s_chan_config_t;
+
+typedef struct {
+    uint32_t sample_rate_hz;
+    int clk_src;
+    uint32_t mclk_multiple;
+} i2s_std_clk_config_t;
+
+typedef struct {
+    i2s_data_bit_width_t data_bit_width;
+    i2s_slot_bit_width_t slot_bit_width;
+    i2s_slot_mode_t slot_mode;
+    i2s_std_slot_mask_t slot_mask;
+    uint32_t ws_width;
+    bool ws_pol;
+    bool bit_shift;
+} i2s_std_slot_config_t;
+
+typedef struct {
+    gpio_num_t mclk;
+    gpio_num_t bclk;
+    gpio_num_t ws;
+    gpio_num_t dout;
+    gpio_num_t din;
+} i2s_std_gpio_config_t;
+
+typedef struct {
+    i2s_std_clk_config_t clk_cfg;
+    i2s_std_slot_config_t slot_cfg;
+    i2s_std_gpio_config_t gpio_cfg;
+} i2s_std_config_t;
+
+typedef struct {
+    void* data;                 // Obsoleto en IDF 5.4, igual a dma_buf
+    void* dma_buf;
+    size_t size;
+} i2s_event_data_t;
+
+typedef bool (*i2s_isr_callback_t)(i2s_chan_handle_t handle, i2s_event_data_t* event, void* user_ctx);
+
+typedef struct {
+    i2s_isr_callback_t on_recv;
+    i2s_isr_callback_t on_recv_q_ovf;
+    i2s_isr_callback_t on_sent;
+    i2s_isr_callback_t on_send_q_ovf;
+} i2s_event_callbacks_t;
+
+static inline i2s_chan_config_t host_i2s_channel_default_config(i2s_port_t id, i2s_role_t role) {
+    i2s_chan_config_t cfg = { id, role, 6, 240, false, 0 };
+    return cfg;
+}
+
+static inline i2s_std_clk_config_t host_i2s_std_clk_default_config(uint32_t rate) {
+    i2s_std_clk_config_t cfg = { rate, 0, 256 };
+    return cfg;
+}
+
+static inline i2s_std_slot_config_t host_i2s_std_philips_slot_default_config(i2s_data_bit_width_t bits,
+                                                                             i2s_slot_mode_t mode) {
+    i2s_std_slot_config_t cfg = { bits, I2S_SLOT_BIT_WIDTH_AUTO, mode,
+                                  mode == I2S_SLOT_MODE_MONO ? I2S_STD_SLOT_LEFT : I2S_STD_SLOT_BOTH,
+                                  (uint32_t)bits, false, true };
+    return cfg;
+}
+
+#define I2S_CHANNEL_DEFAULT_CONFIG(id, role) host_i2s_channel_default_config(id, role)
+#define I2S_STD_CLK_DEFAULT_CONFIG(rate) host_i2s_std_clk_default_config(rate)
+#define I2S_STD_PHILIPS_SLOT_DEFAULT_CONFIG(bits, mode) host_i2s_std_philips_slot_default_config(bits, mode)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Solo recepción: tx_handle tiene que ser nullptr
+esp_err_t i2s_new_channel(const i2s_chan_config_t* chan_cfg, i2s_chan_handle_t* tx_handle, i2s_chan_handle_t* rx_handle);
+// Solo datos de 16 bits en mono, lo que entrega el DMA a microphone.cpp
+esp_err_t i2s_channel_init_std_mode(i2s_chan_handle_t handle, const i2s_std_config_t* std_cfg);
+esp_err_t i2s_channel_register_event_callback(i2s_chan_handle_t handle, const i2s_event_callbacks_t* callbacks,
+                                              void* user_data);
+esp_err_t i2s_channel_enable(i2s_chan_handle_t handle);
+esp_err_t i2s_channel_disable(i2s_chan_handle_t handle);
+
+// Solo en el PC: 'count' muestras al DMA del canal RX de 'port'. Devuelve los
+// buffers completados (y entregados a on_recv); 0 sin canal o con él parado.
+uint32_t host_i2s_rx_push(i2s_port_t port, const int16_t* samples, uint32_t count);
+// El canal RX de 'port' está habilitado
+bool host_i2s_rx_enabled(i2s_port_t port);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef HOST_ESP_LCD_PANEL_IO_H
+#define HOST_ESP_LCD_PANEL_IO_H
+
+// Build de host: la parte de esp_lcd que usa el flush. El panel es el simulado
+// de host_panel.h (src/panel_host.cpp), que llama a on_color_trans_done desde
+// su hilo de "DMA" como lo haría el ISR del SPI.
+
+#include <stdbool.h>
+#include "esp_err.h"
+
+typedef struct esp_lcd_panel_io_t* esp_lcd_panel_io_handle_t;
+typedef struct esp_lcd_panel_t* esp_lcd_panel_handle_t;
+
+typedef struct {
+    int reserved;
+} esp_lcd_panel_io_event_data_t;
+
+typedef bool (*esp_lcd_panel_io_color_trans_done_cb_t)(esp_lcd_panel_io_handle_t io,
+                                                       esp_lcd_panel_io_event_data_t* edata, void* user_ctx);
+
+typedef struct {
+    esp_lcd_panel_io_color_trans_done_cb_t on_color_trans_done;
+} esp_lcd_panel_io_callbacks_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+esp_err_t esp_lcd_panel_io_register_event_callbacks(esp_lcd_panel_io_handle_t io,
+                                                    const esp_lcd_panel_io_callbacks_t* cbs, void* user_ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
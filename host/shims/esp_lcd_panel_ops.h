@@ -0,0 +1,19 @@
+#ifndef HOST_ESP_LCD_PANEL_OPS_H
+#define HOST_ESP_LCD_PANEL_OPS_H
+
+#include "esp_lcd_panel_io.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Encola la transferencia del rectángulo [x_start, x_end) × [y_start, y_end);
+// 'color_data' debe seguir intacto hasta su on_color_trans_done
+esp_err_t esp_lcd_panel_draw_bitmap(esp_lcd_panel_handle_t panel, int x_start, int y_start, int x_end, int y_end,
+                                    const void* color_data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,6 @@
+#ifndef HOST_ESP_LCD_PANEL_VENDOR_H
+#define HOST_ESP_LCD_PANEL_VENDOR_H
+
+#include "esp_lcd_panel_io.h"
+
+#endif
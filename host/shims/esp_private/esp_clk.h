@@ -0,0 +1,15 @@
+#ifndef HOST_ESP_CLK_H
+#define HOST_ESP_CLK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 1 GHz: un ciclo de esp_cpu_get_cycle_count es un nanosegundo
+int esp_clk_cpu_freq(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef HOST_ESP_RANDOM_H
+#define HOST_ESP_RANDOM_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Build de host: secuencia fija (xorshift) para que dos ejecuciones coincidan
+uint32_t esp_random(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
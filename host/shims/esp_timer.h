@@ -0,0 +1,19 @@
+#ifndef HOST_ESP_TIMER_H
+#define HOST_ESP_TIMER_H
+
+// Build de host: tiempo real (monotónico) en µs. Sirve para medir; el reloj
+// de LVGL y de los "ticks" de FreeRTOS es el virtual de host_clock.h.
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int64_t esp_timer_get_time(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef HOST_FREERTOS_H
+#define HOST_FREERTOS_H
+
+// Build de host: tipos de FreeRTOS sin planificador. Un tick es un milisegundo
+// del reloj virtual (host_clock.h), que solo avanza al "dormir".
+
+#include <stdint.h>
+#include "host_clock.h"
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+#define pdFALSE             0
+#define pdTRUE              1
+#define pdFAIL              pdFALSE
+#define pdPASS              pdTRUE
+#define portMAX_DELAY       ((TickType_t)0xFFFFFFFF)
+#define configTICK_RATE_HZ  1000
+#define portTICK_PERIOD_MS  (1000 / configTICK_RATE_HZ)
+#define pdMS_TO_TICKS(ms)   ((TickType_t)(((uint64_t)(ms) * configTICK_RATE_HZ) / 1000))
+#define configMAX_TASK_NAME_LEN 16
+
+// Spinlock de las secciones críticas de ESP-IDF. En el PC solo hace falta el tipo
+// (multi_heap_set_lock lo recibe y el shim usa su propio mutex).
+typedef struct {
+    uint32_t owner;
+    uint32_t count;
+} portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED { 0, 0 }
+
+// esp_attr.h, que en la placa llega a través de portmacro.h
+#define IRAM_ATTR
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef HOST_FREERTOS_SEMPHR_H
+#define HOST_FREERTOS_SEMPHR_H
+
+#include "freertos/FreeRTOS.h"
+
+// Build de host: semáforos contadores con mutex + condition_variable. Como las
+// notificaciones de tarea, esperan en tiempo real (un tick = 1 ms de reloj de
+// pared). Un mutex es un binario que empieza dado, sin herencia de prioridad.
+typedef struct QueueDefinition* SemaphoreHandle_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void);
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max_count, UBaseType_t initial_count);
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+void vSemaphoreDelete(SemaphoreHandle_t sem);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem);
+// Desde el "ISR" (en el PC, el hilo del periférico simulado); nunca pide cambio de tarea
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t sem, BaseType_t* higher_priority_task_woken);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
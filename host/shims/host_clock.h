@@ -0,0 +1,22 @@
+#ifndef HOST_CLOCK_H
+#define HOST_CLOCK_H
+
+// Reloj virtual del build de host, en milisegundos. Lo leen el tick de LVGL
+// (screen_host.cpp) y xTaskGetTickCount; solo avanza con vTaskDelay,
+// vTaskDelayUntil o host_clock_advance_ms. Así un benchmark de 60 frames a
+// 30 FPS recorre dos segundos de timers de LVGL sin esperar dos segundos.
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+uint32_t host_clock_ms(void);
+void host_clock_advance_ms(uint32_t ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef HOST_COMPAT_H
+#define HOST_COMPAT_H
+
+// Se incluye en todas las unidades del build de host (-include). Añade lo que
+// newlib da en la placa y la libc del PC puede no tener.
+
+#include <string.h>
+
+#if defined(__GLIBC__) && (__GLIBC__ < 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ < 38))
+// strlcpy llegó a glibc en la 2.38
+static inline size_t strlcpy(char* dst, const char* src, size_t size) {
+    const size_t len = strlen(src);
+    if (size) {
+        const size_t n = len < size - 1 ? len : size - 1;
+        memcpy(dst, src, n);
+        dst[n] = '\0';
+    }
+    return len;
+}
+#endif
+
+#endif
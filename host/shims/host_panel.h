@@ -0,0 +1,40 @@
+#ifndef HOST_PANEL_H
+#define HOST_PANEL_H
+
+// Panel simulado del build de host (src/panel_host.cpp), detrás de las
+// funciones de esp_lcd. Cada draw_bitmap se encola en un bus serie que tarda
+// ns_per_byte por byte; al terminar, el hilo del bus copia el rectángulo a la
+// GRAM del panel y llama a on_color_trans_done, como el ISR del SPI en la placa.
+// Con ns_per_byte = 0 la transferencia termina dentro de draw_bitmap.
+
+#include <stdint.h>
+#include "esp_lcd_panel_io.h"
+
+typedef struct {
+    uint32_t transfers;     // draw_bitmap aceptados
+    uint64_t bytes;         // Bytes de píxel transferidos
+    uint32_t max_queued;    // Transferencias en el bus o esperándolo a la vez
+    uint32_t overwritten;   // Buffers que cambiaron antes de terminar su transferencia
+} host_panel_stats_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void host_panel_create(uint16_t width, uint16_t height, esp_lcd_panel_io_handle_t* io, esp_lcd_panel_handle_t* panel);
+// Espera a que el bus quede libre y libera el panel y su io
+void host_panel_delete(esp_lcd_panel_handle_t panel);
+void host_panel_set_ns_per_byte(esp_lcd_panel_handle_t panel, uint32_t ns_per_byte);
+// Tras 'ok_transfers' draw_bitmap aceptados, el siguiente devuelve ESP_FAIL
+void host_panel_fail_after(esp_lcd_panel_handle_t panel, uint32_t ok_transfers);
+void host_panel_wait_idle(esp_lcd_panel_handle_t panel);
+// GRAM del panel, width × height píxeles RGB565 tal como llegaron por el bus
+const uint16_t* host_panel_pixels(esp_lcd_panel_handle_t panel);
+void host_panel_get_stats(esp_lcd_panel_handle_t panel, host_panel_stats_t* out);
+void host_panel_reset_stats(esp_lcd_panel_handle_t panel);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
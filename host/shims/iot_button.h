@@ -0,0 +1,9 @@
+#ifndef HOST_IOT_BUTTON_H
+#define HOST_IOT_BUTTON_H
+
+// Build de host: button_manager se sustituye por host/src/button_host.cpp y
+// de iot_button solo hace falta el tipo del handle
+
+typedef struct button_dev_t* button_handle_t;
+
+#endif
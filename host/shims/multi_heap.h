@@ -0,0 +1,47 @@
+#ifndef HOST_MULTI_HEAP_H
+#define HOST_MULTI_HEAP_H
+
+// Build de host: la API de multi_heap de ESP-IDF sobre una región que el
+// llamante reserva (con heap_caps_malloc, es decir, malloc). Dentro de la región
+// hay un first-fit con lista de huecos ordenada por dirección y fusión al
+// liberar, no el TLSF de la placa: la fragmentación no sale idéntica, pero el
+// bloque libre mayor y el mínimo de libres se calculan igual.
+
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct multi_heap_info* multi_heap_handle_t;
+
+typedef struct {
+    size_t total_free_bytes;
+    size_t total_allocated_bytes;
+    size_t largest_free_block;
+    size_t minimum_free_bytes;
+    size_t allocated_blocks;
+    size_t free_blocks;
+    size_t total_blocks;
+} multi_heap_info_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// La cabecera del heap vive al principio de la región; nullptr si no cabe
+multi_heap_handle_t multi_heap_register(void* start, size_t size);
+// Sin efecto: cada heap del shim ya se serializa con su propio mutex
+void multi_heap_set_lock(multi_heap_handle_t heap, void* lock);
+void* multi_heap_malloc(multi_heap_handle_t heap, size_t size);
+void multi_heap_free(multi_heap_handle_t heap, void* p);
+// nullptr si no cabe; el bloque original sigue siendo válido
+void* multi_heap_realloc(multi_heap_handle_t heap, void* p, size_t size);
+size_t multi_heap_free_size(multi_heap_handle_t heap);
+size_t multi_heap_minimum_free_size(multi_heap_handle_t heap);
+void multi_heap_get_info(multi_heap_handle_t heap, multi_heap_info_t* info);
+// Recorre los bloques y la lista de huecos; false si algo no cuadra
+bool multi_heap_check(multi_heap_handle_t heap, bool print_errors);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,9 @@
+#ifndef HOST_SDKCONFIG_H
+#define HOST_SDKCONFIG_H
+
+// Build de host: sin CONFIG_IDF_TARGET_*, así que el código elige siempre las
+// rutas portables (kernels escalares, sin PM ni estadísticas de FreeRTOS)
+
+#define CONFIG_FREERTOS_HZ 1000
+
+#endif
@@ -0,0 +1,72 @@
+// button_manager del build de host: sin iot_button ni GPIO. Las pulsaciones
+// solo entran por button_manager_inject y se despachan con la misma regla que
+// en la placa (handler de la vista activa o, si es nullptr, el por defecto).
+
+#include "controllers/button_manager/button_manager.h"
+#include "utils/spsc_queue.h"
+#include "esp_timer.h"
+
+#define BUTTON_EVENT_QUEUE_SIZE 16     // Como en button_manager.cpp
+
+static button_handler_t default_handlers[BUTTON_COUNT] = { nullptr };
+static const button_handler_t* view_handlers = nullptr;
+
+typedef struct {
+    button_id_t button;
+    int64_t timestamp_us;
+} button_event_t;
+
+static SpscQueue<button_event_t, BUTTON_EVENT_QUEUE_SIZE> inject_queue;
+static button_latency_stats_t latency_stats = {};
+static uint64_t latency_total_us = 0;
+
+void button_manager_init() {
+}
+
+void button_manager_register_default_handler(button_id_t button, button_handler_t handler) {
+    if (button < BUTTON_COUNT) {
+        default_handlers[button] = handler;
+    }
+}
+
+void button_manager_set_view_handlers(const button_handler_t* handlers) {
+    view_handlers = handlers;
+}
+
+bool button_manager_inject(button_id_t button) {
+    if (button >= BUTTON_COUNT) return false;
+    const button_event_t ev = { button, esp_timer_get_time() };
+    if (!inject_queue.push(ev)) {
+        latency_stats.dropped++;
+        return false;
+    }
+    return true;
+}
+
+void button_manager_process_events() {
+    button_event_t ev;
+    while (inject_queue.pop(ev)) {
+        button_handler_t handler = view_handlers ? view_handlers[ev.button] : nullptr;
+        if (!handler) {
+            handler = default_handlers[ev.button];
+        }
+        if (handler) {
+            handler();
+        }
+
+        const uint32_t latency = (uint32_t)(esp_timer_get_time() - ev.timestamp_us);
+        latency_stats.events++;
+        latency_stats.last_us = latency;
+        latency_total_us += latency;
+        latency_stats.avg_us = (uint32_t)(latency_total_us / latency_stats.events);
+        if (latency_stats.min_us == 0 || latency < latency_stats.min_us) latency_stats.min_us = latency;
+        if (latency > latency_stats.max_us) latency_stats.max_us = latency;
+    }
+}
+
+void button_manager_set_wakeup_task(TaskHandle_t task) {
+}
+
+void button_manager_get_latency_stats(button_latency_stats_t* out) {
+    if (out) *out = latency_stats;
+}
@@ -0,0 +1,211 @@
+// Controladores de hardware del build de host. Implementan solo lo que usan las
+// vistas, screen_views.cpp y los benchmarks de UI, con datos sintéticos que
+// dependen del reloj virtual: dos ejecuciones iguales dan los mismos frames.
+// Los módulos puros (led_fx, buzzer_seq, mic_dsp, step_detector, db_store,
+// dlog_format, mem_manager, fs_manager...) se enlazan reales desde main/.
+
+#include "controllers/buzzer/buzzer.h"
+#include "controllers/db_manager/db_manager.h"
+#include "controllers/dlog/dlog.h"
+#include "controllers/leds/leds.h"
+#include "controllers/microphone/microphone.h"
+#include "controllers/pedometer/pedometer.h"
+#include "controllers/sd_card/sd_card.h"
+#include "controllers/telemetry/telemetry.h"
+#include "controllers/ui_pipeline/ui_pipeline.h"
+#include "esp_log.h"
+#include "host_clock.h"
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+static const char* TAG = "HOST";
+
+// Un paso cada HOST_STEP_PERIOD_MS y un bloque de micrófono cada MIC_VIEW_PERIOD_MS
+#define HOST_STEP_PERIOD_MS 500
+
+// --- dlog: sin tarea decodificadora, las macros DLOGx escriben en directo -----
+
+esp_err_t dlog_init() {
+    return ESP_OK;
+}
+
+bool dlog_write(const dlog_desc_t* desc, const char* tag, const uint32_t* words, uint32_t count) {
+    return false;
+}
+
+void dlog_flush() {
+}
+
+void dlog_get_stats(dlog_stats_t* out) {
+    *out = {};
+}
+
+// --- sd_card: sin tarjeta -----------------------------------------------------
+
+bool sd_card_is_mounted() {
+    return false;
+}
+
+// --- db_manager: clave/valor en memoria ---------------------------------------
+
+static std::map<std::string, std::vector<uint8_t>> db_kv;
+
+bool db_manager_is_ready() {
+    return true;
+}
+
+esp_err_t db_put(const char* key, const void* value, uint16_t len) {
+    const uint8_t* bytes = (const uint8_t*)value;
+    db_kv[key].assign(bytes, bytes + len);
+    return ESP_OK;
+}
+
+int db_get(const char* key, void* value, uint16_t cap) {
+    auto it = db_kv.find(key);
+    if (it == db_kv.end()) return -1;
+    const size_t n = it->second.size() < cap ? it->second.size() : cap;
+    memcpy(value, it->second.data(), n);
+    return (int)it->second.size();
+}
+
+esp_err_t db_commit() {
+    return ESP_OK;
+}
+
+void db_manager_get_stats(db_manager_stats_t* out) {
+    *out = {};
+}
+
+// --- ui_pipeline: solo el límite de FPS (el benchmark maneja LVGL directamente)
+
+static uint32_t fps_cap = UI_FPS_CAP_DEFAULT;
+
+void ui_pipeline_set_fps_cap(uint32_t fps) {
+    fps_cap = fps;
+}
+
+void ui_pipeline_get_stats(ui_pipeline_stats_t* out) {
+    *out = {};
+    out->fps_cap = fps_cap;
+    out->fps = fps_cap;
+}
+
+// --- pedometer: camina a ritmo constante sobre el reloj virtual ---------------
+
+static uint32_t steps_offset = 0;
+
+bool pedometer_is_running() {
+    return true;
+}
+
+void pedometer_get_snapshot(pedometer_snapshot_t* out) {
+    out->steps = host_clock_ms() / HOST_STEP_PERIOD_MS - steps_offset;
+    out->cadence_spm = 60000 / HOST_STEP_PERIOD_MS;
+}
+
+void pedometer_reset_steps() {
+    steps_offset = host_clock_ms() / HOST_STEP_PERIOD_MS;
+}
+
+// --- microphone: un espectro que se desplaza, un bloque nuevo por periodo de la vista
+
+static bool spectrum_enabled = false;
+
+bool microphone_is_running() {
+    return true;
+}
+
+void microphone_set_spectrum_enabled(bool enabled) {
+    spectrum_enabled = enabled;
+}
+
+void microphone_get_levels(mic_levels_t* out) {
+    *out = {};
+    out->seq = host_clock_ms() / MIC_VIEW_PERIOD_MS + 1;
+    // Onda triangular por banda, desfasada: todas las barras cambian cada bloque
+    for (int i = 0; i < MIC_SPECTRUM_BANDS; i++) {
+        const uint32_t phase = (out->seq * 9 + i * 23) % 510;
+        out->bands[i] = spectrum_enabled ? (uint8_t)(phase < 255 ? phase : 510 - phase) : 0;
+    }
+    out->rms_dbfs_x10 = (int16_t)(-400 + (int)(out->seq % 200));
+    out->peak_dbfs_x10 = out->rms_dbfs_x10 + 60;
+}
+
+void microphone_get_stats(mic_stats_t* out) {
+    *out = {};
+    out->running = true;
+    out->capturing = spectrum_enabled;
+    out->source = "host";
+}
+
+// --- telemetry: valores que cambian una vez por muestra -----------------------
+
+bool telemetry_is_running() {
+    return true;
+}
+
+void telemetry_get(telemetry_snapshot_t* out) {
+    memset(out, 0, sizeof(*out));
+    const uint32_t sample = host_clock_ms() / TELEMETRY_PERIOD_MS;
+    out->samples = sample;
+    out->window = sample < TELEMETRY_HISTORY ? sample : TELEMETRY_HISTORY;
+    out->uptime_s = host_clock_ms() / 1000;
+
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    out->lv_total = mon.total_size;
+
+    const uint32_t values[TELEM_METRIC_COUNT] = {
+        200 * 1024 - (sample % 8) * 1024, 96 * 1024, 7 * 1024 * 1024, 4 * 1024 * 1024,
+        (uint32_t)(mon.total_size - mon.free_size), mon.frag_pct, fps_cap, 20 + sample % 30, 5 + sample % 10,
+    };
+    for (int i = 0; i < TELEM_METRIC_COUNT; i++) {
+        out->metrics[i] = { values[i], values[i], values[i], values[i] };
+    }
+
+    static const char* const task_names[] = { "ui_render", "ui_flush", "IDLE0", "IDLE1" };
+    out->task_count = sizeof(task_names) / sizeof(task_names[0]);
+    for (int i = 0; i < out->task_count; i++) {
+        strlcpy(out->tasks[i].name, task_names[i], sizeof(out->tasks[i].name));
+        out->tasks[i].cpu_pct = (uint8_t)((sample * (i + 3)) % 50);
+        out->tasks[i].stack_free = 1024 + 256 * i;
+    }
+}
+
+// --- leds y buzzer: sin salida, solo el estado que muestra Settings -----------
+
+static led_fx_effect_t leds_effect = LED_FX_SECONDS;
+static uint8_t buzzer_volume = BUZZER_VOLUME_DEFAULT;
+
+bool leds_is_running() {
+    return true;
+}
+
+void leds_set_effect(led_fx_effect_t effect) {
+    leds_effect = effect;
+}
+
+led_fx_effect_t leds_get_effect() {
+    return leds_effect;
+}
+
+void leds_set_second(uint8_t second, led_rgb_t color) {
+}
+
+bool buzzer_is_running() {
+    return true;
+}
+
+bool buzzer_play(const buzzer_step_t* melody, bool interrupt) {
+    return true;
+}
+
+void buzzer_set_volume(uint8_t level) {
+    buzzer_volume = level < BUZZER_VOLUME_LEVELS ? level : BUZZER_VOLUME_LEVELS - 1;
+}
+
+uint8_t buzzer_get_volume() {
+    return buzzer_volume;
+}
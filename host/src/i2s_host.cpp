@@ -0,0 +1,118 @@
+// Canal I2S de recepción del build de host (driver/i2s_std.h). Los buffers
+// DMA forman un anillo: host_i2s_rx_push escribe en el actual y, al llenarlo,
+// lo entrega a on_recv y pasa al siguiente sin esperar a nadie, igual que el
+// GDMA. Si la tarea va atrasada, sus bloques se pisan como en la placa.
+
+#include "driver/i2s_std.h"
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+struct i2s_channel_obj_t {
+    std::mutex lock;
+    i2s_port_t id;
+    uint32_t desc_num;
+    uint32_t frame_num;
+    int16_t* bufs;              // desc_num × frame_num muestras
+    uint32_t current;           // Buffer que se está llenando
+    uint32_t filled;            // Muestras ya escritas en él
+    bool configured;
+    bool enabled;
+    i2s_isr_callback_t on_recv;
+    void* user;
+};
+
+static i2s_chan_handle_t rx_channels[I2S_NUM_MAX] = {};
+
+esp_err_t i2s_new_channel(const i2s_chan_config_t* chan_cfg, i2s_chan_handle_t* tx_handle,
+                          i2s_chan_handle_t* rx_handle) {
+    if (!chan_cfg || tx_handle || !rx_handle || chan_cfg->id >= I2S_NUM_MAX) return ESP_ERR_INVALID_ARG;
+    if (rx_channels[chan_cfg->id]) return ESP_ERR_NOT_FOUND;
+    if (chan_cfg->dma_desc_num < 2 || chan_cfg->dma_frame_num == 0) return ESP_ERR_INVALID_ARG;
+
+    i2s_chan_handle_t ch = new i2s_channel_obj_t();
+    ch->id = chan_cfg->id;
+    ch->desc_num = chan_cfg->dma_desc_num;
+    ch->frame_num = chan_cfg->dma_frame_num;
+    // Alineados a 4 bytes como los del DMA: mic_dsp_level lee de 32 en 32 bits
+    ch->bufs = (int16_t*)aligned_alloc(4, ((ch->desc_num * ch->frame_num * sizeof(int16_t)) + 3) & ~(size_t)3);
+    if (!ch->bufs) {
+        delete ch;
+        return ESP_ERR_NO_MEM;
+    }
+    memset(ch->bufs, 0, ch->desc_num * ch->frame_num * sizeof(int16_t));
+    rx_channels[ch->id] = ch;
+    *rx_handle = ch;
+    return ESP_OK;
+}
+
+esp_err_t i2s_channel_init_std_mode(i2s_chan_handle_t handle, const i2s_std_config_t* std_cfg) {
+    if (!handle || !std_cfg) return ESP_ERR_INVALID_ARG;
+    if (std_cfg->slot_cfg.data_bit_width != I2S_DATA_BIT_WIDTH_16BIT ||
+        std_cfg->slot_cfg.slot_mode != I2S_SLOT_MODE_MONO) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    std::lock_guard<std::mutex> guard(handle->lock);
+    handle->configured = true;
+    return ESP_OK;
+}
+
+esp_err_t i2s_channel_register_event_callback(i2s_chan_handle_t handle, const i2s_event_callbacks_t* callbacks,
+                                              void* user_data) {
+    if (!handle || !callbacks) return ESP_ERR_INVALID_ARG;
+    std::lock_guard<std::mutex> guard(handle->lock);
+    if (handle->enabled) return ESP_ERR_INVALID_STATE;
+    handle->on_recv = callbacks->on_recv;
+    handle->user = user_data;
+    return ESP_OK;
+}
+
+esp_err_t i2s_channel_enable(i2s_chan_handle_t handle) {
+    if (!handle) return ESP_ERR_INVALID_ARG;
+    std::lock_guard<std::mutex> guard(handle->lock);
+    if (!handle->configured || handle->enabled) return ESP_ERR_INVALID_STATE;
+    handle->enabled = true;
+    handle->filled = 0;
+    return ESP_OK;
+}
+
+esp_err_t i2s_channel_disable(i2s_chan_handle_t handle) {
+    if (!handle) return ESP_ERR_INVALID_ARG;
+    std::lock_guard<std::mutex> guard(handle->lock);
+    if (!handle->enabled) return ESP_ERR_INVALID_STATE;
+    handle->enabled = false;
+    return ESP_OK;
+}
+
+uint32_t host_i2s_rx_push(i2s_port_t port, const int16_t* samples, uint32_t count) {
+    i2s_chan_handle_t ch = port < I2S_NUM_MAX ? rx_channels[port] : nullptr;
+    if (!ch) return 0;
+
+    uint32_t completed = 0;
+    std::lock_guard<std::mutex> guard(ch->lock);
+    while (ch->enabled && count > 0) {
+        int16_t* buf = ch->bufs + ch->current * ch->frame_num;
+        const uint32_t n = count < ch->frame_num - ch->filled ? count : ch->frame_num - ch->filled;
+        memcpy(buf + ch->filled, samples, n * sizeof(int16_t));
+        ch->filled += n;
+        samples += n;
+        count -= n;
+        if (ch->filled < ch->frame_num) break;
+
+        ch->filled = 0;
+        ch->current = (ch->current + 1) % ch->desc_num;
+        completed++;
+        if (ch->on_recv) {
+            i2s_event_data_t event = { buf, buf, ch->frame_num * sizeof(int16_t) };
+            ch->on_recv(ch, &event, ch->user);
+        }
+    }
+    return completed;
+}
+
+bool host_i2s_rx_enabled(i2s_port_t port) {
+    i2s_chan_handle_t ch = port < I2S_NUM_MAX ? rx_channels[port] : nullptr;
+    if (!ch) return false;
+    std::lock_guard<std::mutex> guard(ch->lock);
+    return ch->enabled;
+}
@@ -0,0 +1,263 @@
+// Implementación de los shims de ESP-IDF y FreeRTOS del build de host
+// (cabeceras en host/shims). Un solo hilo "de UI": esperar es avanzar el reloj
+// virtual. Las tareas de fondo (p. ej. el writer de la SD) son std::thread.
+
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "esp_cpu.h"
+#include "esp_random.h"
+#include "esp_rom_crc.h"
+#include "esp_private/esp_clk.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "host_clock.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+
+// Lo que devuelven las consultas de heap libre: no hay un límite real que medir
+#define HOST_HEAP_REPORT_BYTES  (256 * 1024)
+#define HOST_CPU_FREQ_HZ        1000000000
+
+static std::atomic<uint32_t> clock_ms{0};
+static esp_log_level_t log_level = ESP_LOG_INFO;
+static uint32_t random_state = 0x12345678;
+
+static const std::chrono::steady_clock::time_point host_start = std::chrono::steady_clock::now();
+
+uint32_t host_clock_ms(void) {
+    return clock_ms.load(std::memory_order_relaxed);
+}
+
+void host_clock_advance_ms(uint32_t ms) {
+    clock_ms.fetch_add(ms, std::memory_order_relaxed);
+}
+
+int64_t esp_timer_get_time(void) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - host_start).count();
+}
+
+uint32_t esp_cpu_get_cycle_count(void) {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - host_start).count();
+}
+
+int esp_clk_cpu_freq(void) {
+    return HOST_CPU_FREQ_HZ;
+}
+
+uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t* buf, uint32_t len) {
+    crc = ~crc;
+    while (len--) {
+        crc ^= *buf++;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+uint32_t esp_random(void) {
+    uint32_t x = random_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    random_state = x;
+    return x;
+}
+
+void vTaskDelay(TickType_t ticks) {
+    host_clock_advance_ms(ticks * portTICK_PERIOD_MS);
+    std::this_thread::yield();
+}
+
+void vTaskDelayUntil(TickType_t* previous_wake, TickType_t increment) {
+    const TickType_t target = *previous_wake + increment;
+    const TickType_t now = xTaskGetTickCount();
+    if ((int32_t)(target - now) > 0) {
+        vTaskDelay(target - now);
+    }
+    *previous_wake = target;
+}
+
+TickType_t xTaskGetTickCount(void) {
+    return host_clock_ms() / portTICK_PERIOD_MS;
+}
+
+// Contador de notificaciones de una tarea (o del hilo principal)
+struct tskTaskControlBlock {
+    std::mutex lock;
+    std::condition_variable cv;
+    uint32_t notifications = 0;
+};
+
+static thread_local TaskHandle_t current_task = nullptr;
+
+static TaskHandle_t task_self() {
+    if (!current_task) current_task = new tskTaskControlBlock();
+    return current_task;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t stack_bytes, void* arg,
+                                   UBaseType_t priority, TaskHandle_t* out, BaseType_t core) {
+    TaskHandle_t task = new tskTaskControlBlock();
+    if (out) *out = task;
+    // Las tareas de FreeRTOS no terminan: el hilo vive hasta el final del proceso
+    std::thread([fn, arg, task]() {
+        current_task = task;
+        fn(arg);
+    }).detach();
+    return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks) {
+    TaskHandle_t self = task_self();
+    std::unique_lock<std::mutex> guard(self->lock);
+    auto ready = [self]() { return self->notifications > 0; };
+    if (ticks == portMAX_DELAY) {
+        self->cv.wait(guard, ready);
+    } else {
+        self->cv.wait_for(guard, std::chrono::milliseconds(ticks * portTICK_PERIOD_MS), ready);
+    }
+    const uint32_t value = self->notifications;
+    if (value) self->notifications = clear_on_exit ? 0 : value - 1;
+    return value;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    {
+        std::lock_guard<std::mutex> guard(task->lock);
+        task->notifications++;
+    }
+    task->cv.notify_one();
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higher_priority_woken) {
+    xTaskNotifyGive(task);
+    if (higher_priority_woken) *higher_priority_woken = pdFALSE;
+}
+
+// Semáforo contador: 'count' hasta 'max_count', Take espera en tiempo real
+struct QueueDefinition {
+    std::mutex lock;
+    std::condition_variable cv;
+    UBaseType_t count = 0;
+    UBaseType_t max_count = 1;
+};
+
+static SemaphoreHandle_t semaphore_new(UBaseType_t max_count, UBaseType_t initial_count) {
+    SemaphoreHandle_t sem = new QueueDefinition();
+    sem->max_count = max_count;
+    sem->count = initial_count;
+    return sem;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void) {
+    return semaphore_new(1, 0);
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max_count, UBaseType_t initial_count) {
+    return semaphore_new(max_count, initial_count);
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void) {
+    return semaphore_new(1, 1);
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t sem) {
+    delete sem;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks) {
+    std::unique_lock<std::mutex> guard(sem->lock);
+    auto ready = [sem]() { return sem->count > 0; };
+    if (ticks == portMAX_DELAY) {
+        sem->cv.wait(guard, ready);
+    } else if (!sem->cv.wait_for(guard, std::chrono::milliseconds(ticks * portTICK_PERIOD_MS), ready)) {
+        return pdFALSE;
+    }
+    sem->count--;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem) {
+    {
+        std::lock_guard<std::mutex> guard(sem->lock);
+        if (sem->count >= sem->max_count) return pdFALSE;
+        sem->count++;
+    }
+    sem->cv.notify_one();
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t sem, BaseType_t* higher_priority_task_woken) {
+    if (higher_priority_task_woken) *higher_priority_task_woken = pdFALSE;
+    return xSemaphoreGive(sem);
+}
+
+void* heap_caps_malloc(size_t size, uint32_t caps) {
+    return malloc(size);
+}
+
+void* heap_caps_calloc(size_t n, size_t size, uint32_t caps) {
+    return calloc(n, size);
+}
+
+void* heap_caps_aligned_alloc(size_t alignment, size_t size, uint32_t caps) {
+    return aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+
+void heap_caps_free(void* ptr) {
+    free(ptr);
+}
+
+size_t heap_caps_get_free_size(uint32_t caps) {
+    return HOST_HEAP_REPORT_BYTES;
+}
+
+size_t heap_caps_get_largest_free_block(uint32_t caps) {
+    return HOST_HEAP_REPORT_BYTES;
+}
+
+const char* esp_err_to_name(esp_err_t code) {
+    switch (code) {
+        case ESP_OK: return "ESP_OK";
+        case ESP_FAIL: return "ESP_FAIL";
+        case ESP_ERR_NO_MEM: return "ESP_ERR_NO_MEM";
+        case ESP_ERR_INVALID_ARG: return "ESP_ERR_INVALID_ARG";
+        case ESP_ERR_INVALID_STATE: return "ESP_ERR_INVALID_STATE";
+        case ESP_ERR_INVALID_SIZE: return "ESP_ERR_INVALID_SIZE";
+        case ESP_ERR_NOT_FOUND: return "ESP_ERR_NOT_FOUND";
+        case ESP_ERR_NOT_SUPPORTED: return "ESP_ERR_NOT_SUPPORTED";
+        case ESP_ERR_TIMEOUT: return "ESP_ERR_TIMEOUT";
+        case ESP_ERR_INVALID_RESPONSE: return "ESP_ERR_INVALID_RESPONSE";
+        case ESP_ERR_INVALID_CRC: return "ESP_ERR_INVALID_CRC";
+        case ESP_ERR_INVALID_VERSION: return "ESP_ERR_INVALID_VERSION";
+        case ESP_ERR_NOT_FINISHED: return "ESP_ERR_NOT_FINISHED";
+        default: return "UNKNOWN ERROR";
+    }
+}
+
+void esp_log_level_set(const char* tag, esp_log_level_t level) {
+    log_level = level;
+}
+
+uint32_t esp_log_timestamp(void) {
+    return host_clock_ms();
+}
+
+void esp_log_write(esp_log_level_t level, const char* tag, const char* format, ...) {
+    if (level > log_level) return;
+    va_list args;
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+}
@@ -0,0 +1,245 @@
+// multi_heap del build de host (shims/multi_heap.h). La región se parte en
+// bloques contiguos con una cabecera de 16 bytes; los libres forman una lista
+// ordenada por dirección, así que al liberar basta mirar el hueco anterior y
+// el siguiente para fusionar. Los tamaños de bloque incluyen la cabecera.
+
+#include "multi_heap.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+#define HEAP_ALIGN 16
+
+typedef struct heap_block {
+    size_t size;                // Bytes del bloque, cabecera incluida
+    size_t used;                // 0 = hueco
+} heap_block_t;
+static_assert(sizeof(heap_block_t) == HEAP_ALIGN, "La cabecera mantiene la alineación de los datos");
+
+// Un hueco guarda el enlace al siguiente en sus datos
+typedef struct heap_free {
+    heap_block_t hdr;
+    struct heap_free* next;
+} heap_free_t;
+
+#define HEAP_MIN_BLOCK (sizeof(heap_free_t) + HEAP_ALIGN - sizeof(heap_free_t) % HEAP_ALIGN)
+
+struct multi_heap_info {
+    std::mutex lock;
+    uint8_t* start;
+    uint8_t* end;
+    heap_free_t* free_list;
+    size_t free_bytes;
+    size_t minimum_free_bytes;
+    size_t allocated_blocks;
+};
+
+static size_t heap_round(size_t size) {
+    return (size + HEAP_ALIGN - 1) & ~(size_t)(HEAP_ALIGN - 1);
+}
+
+static size_t block_size_for(size_t size) {
+    const size_t bytes = heap_round(sizeof(heap_block_t) + (size ? size : 1));
+    return bytes < HEAP_MIN_BLOCK ? HEAP_MIN_BLOCK : bytes;
+}
+
+static heap_block_t* block_of(void* p) {
+    return (heap_block_t*)p - 1;
+}
+
+// Mete 'b' en la lista de huecos en su sitio y lo fusiona con los vecinos
+static void heap_insert_free(multi_heap_handle_t heap, heap_free_t* b) {
+    b->hdr.used = 0;
+    heap_free_t* prev = nullptr;
+    heap_free_t* next = heap->free_list;
+    while (next && next < b) {
+        prev = next;
+        next = next->next;
+    }
+
+    if (next && (uint8_t*)b + b->hdr.size == (uint8_t*)next) {
+        b->hdr.size += next->hdr.size;
+        next = next->next;
+    }
+    b->next = next;
+    if (prev && (uint8_t*)prev + prev->hdr.size == (uint8_t*)b) {
+        prev->hdr.size += b->hdr.size;
+        prev->next = next;
+    } else if (prev) {
+        prev->next = b;
+    } else {
+        heap->free_list = b;
+    }
+}
+
+// Toma 'bytes' del principio del hueco 'b' (ya fuera de la lista) y devuelve el resto
+static void heap_split(multi_heap_handle_t heap, heap_block_t* b, size_t bytes) {
+    if (b->size - bytes >= HEAP_MIN_BLOCK) {
+        heap_free_t* rest = (heap_free_t*)((uint8_t*)b + bytes);
+        rest->hdr.size = b->size - bytes;
+        b->size = bytes;
+        heap_insert_free(heap, rest);
+    }
+}
+
+static void heap_note_free(multi_heap_handle_t heap) {
+    if (heap->free_bytes < heap->minimum_free_bytes) heap->minimum_free_bytes = heap->free_bytes;
+}
+
+multi_heap_handle_t multi_heap_register(void* start, size_t size) {
+    uint8_t* base = (uint8_t*)(((uintptr_t)start + HEAP_ALIGN - 1) & ~(uintptr_t)(HEAP_ALIGN - 1));
+    const size_t head = heap_round(sizeof(multi_heap_info));
+    if (!start || (size_t)(base - (uint8_t*)start) + head + HEAP_MIN_BLOCK > size) return nullptr;
+
+    multi_heap_handle_t heap = new (base) multi_heap_info();
+    heap->start = base + head;
+    heap->end = heap->start + ((size - (base - (uint8_t*)start) - head) & ~(size_t)(HEAP_ALIGN - 1));
+    heap_free_t* all = (heap_free_t*)heap->start;
+    all->hdr.size = heap->end - heap->start;
+    all->hdr.used = 0;
+    all->next = nullptr;
+    heap->free_list = all;
+    heap->free_bytes = all->hdr.size;
+    heap->minimum_free_bytes = heap->free_bytes;
+    return heap;
+}
+
+void multi_heap_set_lock(multi_heap_handle_t heap, void* lock) {
+}
+
+void* multi_heap_malloc(multi_heap_handle_t heap, size_t size) {
+    if (!heap) return nullptr;
+    const size_t bytes = block_size_for(size);
+
+    std::lock_guard<std::mutex> guard(heap->lock);
+    heap_free_t* prev = nullptr;
+    for (heap_free_t* b = heap->free_list; b; prev = b, b = b->next) {
+        if (b->hdr.size < bytes) continue;
+        if (prev) {
+            prev->next = b->next;
+        } else {
+            heap->free_list = b->next;
+        }
+        heap_split(heap, &b->hdr, bytes);
+        b->hdr.used = 1;
+        heap->free_bytes -= b->hdr.size;
+        heap->allocated_blocks++;
+        heap_note_free(heap);
+        return &b->hdr + 1;
+    }
+    return nullptr;
+}
+
+void multi_heap_free(multi_heap_handle_t heap, void* p) {
+    if (!heap || !p) return;
+    heap_block_t* b = block_of(p);
+
+    std::lock_guard<std::mutex> guard(heap->lock);
+    heap->free_bytes += b->size;
+    heap->allocated_blocks--;
+    heap_insert_free(heap, (heap_free_t*)b);
+}
+
+void* multi_heap_realloc(multi_heap_handle_t heap, void* p, size_t size) {
+    if (!p) return multi_heap_malloc(heap, size);
+    if (!size) {
+        multi_heap_free(heap, p);
+        return nullptr;
+    }
+    heap_block_t* b = block_of(p);
+    const size_t bytes = block_size_for(size);
+    {
+        std::lock_guard<std::mutex> guard(heap->lock);
+        if (bytes <= b->size) {
+            const size_t before = b->size;
+            heap_split(heap, b, bytes);
+            heap->free_bytes += before - b->size;
+            return p;
+        }
+
+        // Crecer sobre el hueco que viene justo detrás, si lo hay y basta
+        heap_free_t* prev = nullptr;
+        heap_free_t* next = heap->free_list;
+        while (next && (uint8_t*)next < (uint8_t*)b) {
+            prev = next;
+            next = next->next;
+        }
+        if (next && (uint8_t*)b + b->size == (uint8_t*)next && b->size + next->hdr.size >= bytes) {
+            if (prev) {
+                prev->next = next->next;
+            } else {
+                heap->free_list = next->next;
+            }
+            heap->free_bytes -= next->hdr.size;
+            b->size += next->hdr.size;
+            const size_t grown = b->size;
+            heap_split(heap, b, bytes);
+            heap->free_bytes += grown - b->size;
+            heap_note_free(heap);
+            return p;
+        }
+    }
+
+    void* np = multi_heap_malloc(heap, size);
+    if (!np) return nullptr;
+    memcpy(np, p, b->size - sizeof(heap_block_t));
+    multi_heap_free(heap, p);
+    return np;
+}
+
+size_t multi_heap_free_size(multi_heap_handle_t heap) {
+    std::lock_guard<std::mutex> guard(heap->lock);
+    return heap->free_bytes;
+}
+
+size_t multi_heap_minimum_free_size(multi_heap_handle_t heap) {
+    std::lock_guard<std::mutex> guard(heap->lock);
+    return heap->minimum_free_bytes;
+}
+
+void multi_heap_get_info(multi_heap_handle_t heap, multi_heap_info_t* info) {
+    *info = {};
+    std::lock_guard<std::mutex> guard(heap->lock);
+    for (const heap_free_t* b = heap->free_list; b; b = b->next) {
+        const size_t usable = b->hdr.size - sizeof(heap_block_t);
+        if (usable > info->largest_free_block) info->largest_free_block = usable;
+        info->free_blocks++;
+    }
+    info->total_free_bytes = heap->free_bytes;
+    info->total_allocated_bytes = (heap->end - heap->start) - heap->free_bytes;
+    info->minimum_free_bytes = heap->minimum_free_bytes;
+    info->allocated_blocks = heap->allocated_blocks;
+    info->total_blocks = info->allocated_blocks + info->free_blocks;
+}
+
+bool multi_heap_check(multi_heap_handle_t heap, bool print_errors) {
+    std::lock_guard<std::mutex> guard(heap->lock);
+    size_t free_bytes = 0;
+    size_t used_blocks = 0;
+    const heap_free_t* expected = heap->free_list;
+    uint8_t* p = heap->start;
+    while (p < heap->end) {
+        const heap_block_t* b = (const heap_block_t*)p;
+        if (b->size < HEAP_MIN_BLOCK || b->size % HEAP_ALIGN || p + b->size > heap->end) {
+            if (print_errors) printf("multi_heap: bloque corrupto en %p\n", (void*)p);
+            return false;
+        }
+        if (b->used) {
+            used_blocks++;
+        } else {
+            // Los huecos aparecen en el mismo orden que en la lista y nunca seguidos
+            if ((const void*)b != expected || (expected->next && (uint8_t*)expected->next == p + b->size)) {
+                if (print_errors) printf("multi_heap: lista de huecos inconsistente en %p\n", (void*)p);
+                return false;
+            }
+            free_bytes += b->size;
+            expected = expected->next;
+        }
+        p += b->size;
+    }
+    const bool ok = !expected && free_bytes == heap->free_bytes && used_blocks == heap->allocated_blocks;
+    if (!ok && print_errors) printf("multi_heap: contadores inconsistentes\n");
+    return ok;
+}
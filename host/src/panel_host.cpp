@@ -0,0 +1,200 @@
+// Panel simulado del build de host (host_panel.h). Un hilo hace de bus SPI:
+// atiende las transferencias en orden, cada una termina cuando le toca según
+// ns_per_byte y entonces se copia a la GRAM y se llama a on_color_trans_done.
+// Al encolar se guarda un hash del buffer y al terminar se vuelve a calcular:
+// si no coincide, alguien escribió en un buffer que aún estaba en el bus.
+
+#include "host_panel.h"
+#include "esp_lcd_panel_ops.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct esp_lcd_panel_io_t {
+    esp_lcd_panel_io_color_trans_done_cb_t on_color_trans_done = nullptr;
+    void* user_ctx = nullptr;
+};
+
+typedef struct {
+    int x1, y1, x2, y2;
+    const uint8_t* data;
+    size_t bytes;
+    uint64_t hash;
+    std::chrono::steady_clock::time_point done_at;
+} panel_transfer_t;
+
+struct esp_lcd_panel_t {
+    esp_lcd_panel_io_t* io = nullptr;
+    uint16_t width = 0;
+    uint16_t height = 0;
+    std::vector<uint16_t> gram;
+    uint32_t ns_per_byte = 0;
+    int64_t fail_after = -1;
+
+    std::mutex lock;
+    std::condition_variable cv;
+    std::deque<panel_transfer_t> queue;
+    uint32_t pending = 0;           // Encoladas y aún sin on_color_trans_done
+    std::chrono::steady_clock::time_point bus_free_at;
+    std::thread bus;
+    bool stop = false;
+    host_panel_stats_t stats = {};
+};
+
+// FNV-1a: basta para ver si el buffer cambió
+static uint64_t panel_hash(const uint8_t* data, size_t bytes) {
+    uint64_t h = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < bytes; i++) {
+        h = (h ^ data[i]) * 0x100000001b3ull;
+    }
+    return h;
+}
+
+static void panel_complete(esp_lcd_panel_t* panel, const panel_transfer_t& t) {
+    const int width = t.x2 - t.x1;
+    const uint16_t* src = (const uint16_t*)t.data;
+    for (int y = t.y1; y < t.y2; y++, src += width) {
+        memcpy(&panel->gram[(size_t)y * panel->width + t.x1], src, width * sizeof(uint16_t));
+    }
+    const bool overwritten = panel_hash(t.data, t.bytes) != t.hash;
+    {
+        std::lock_guard<std::mutex> guard(panel->lock);
+        if (overwritten) panel->stats.overwritten++;
+    }
+
+    esp_lcd_panel_io_t* io = panel->io;
+    if (io->on_color_trans_done) {
+        esp_lcd_panel_io_event_data_t edata = {};
+        io->on_color_trans_done(io, &edata, io->user_ctx);
+    }
+}
+
+static void panel_bus_loop(esp_lcd_panel_t* panel) {
+    std::unique_lock<std::mutex> guard(panel->lock);
+    while (true) {
+        panel->cv.wait(guard, [panel]() { return panel->stop || !panel->queue.empty(); });
+        if (panel->queue.empty()) return;
+
+        const auto done_at = panel->queue.front().done_at;
+        guard.unlock();
+        std::this_thread::sleep_until(done_at);
+        guard.lock();
+        const panel_transfer_t t = panel->queue.front();
+        panel->queue.pop_front();
+
+        guard.unlock();
+        panel_complete(panel, t);
+        guard.lock();
+        panel->pending--;
+        panel->cv.notify_all();
+    }
+}
+
+void host_panel_create(uint16_t width, uint16_t height, esp_lcd_panel_io_handle_t* io, esp_lcd_panel_handle_t* panel) {
+    esp_lcd_panel_t* p = new esp_lcd_panel_t();
+    p->io = new esp_lcd_panel_io_t();
+    p->width = width;
+    p->height = height;
+    p->gram.assign((size_t)width * height, 0);
+    *io = p->io;
+    *panel = p;
+}
+
+void host_panel_delete(esp_lcd_panel_handle_t panel) {
+    if (!panel) return;
+    host_panel_wait_idle(panel);
+    {
+        std::lock_guard<std::mutex> guard(panel->lock);
+        panel->stop = true;
+    }
+    panel->cv.notify_all();
+    if (panel->bus.joinable()) panel->bus.join();
+    delete panel->io;
+    delete panel;
+}
+
+void host_panel_set_ns_per_byte(esp_lcd_panel_handle_t panel, uint32_t ns_per_byte) {
+    std::lock_guard<std::mutex> guard(panel->lock);
+    panel->ns_per_byte = ns_per_byte;
+}
+
+void host_panel_fail_after(esp_lcd_panel_handle_t panel, uint32_t ok_transfers) {
+    std::lock_guard<std::mutex> guard(panel->lock);
+    panel->fail_after = ok_transfers;
+}
+
+void host_panel_wait_idle(esp_lcd_panel_handle_t panel) {
+    std::unique_lock<std::mutex> guard(panel->lock);
+    panel->cv.wait(guard, [panel]() { return panel->pending == 0; });
+}
+
+const uint16_t* host_panel_pixels(esp_lcd_panel_handle_t panel) {
+    return panel->gram.data();
+}
+
+void host_panel_get_stats(esp_lcd_panel_handle_t panel, host_panel_stats_t* out) {
+    std::lock_guard<std::mutex> guard(panel->lock);
+    *out = panel->stats;
+}
+
+void host_panel_reset_stats(esp_lcd_panel_handle_t panel) {
+    std::lock_guard<std::mutex> guard(panel->lock);
+    panel->stats = {};
+}
+
+esp_err_t esp_lcd_panel_io_register_event_callbacks(esp_lcd_panel_io_handle_t io,
+                                                    const esp_lcd_panel_io_callbacks_t* cbs, void* user_ctx) {
+    if (!io || !cbs) return ESP_ERR_INVALID_ARG;
+    io->on_color_trans_done = cbs->on_color_trans_done;
+    io->user_ctx = user_ctx;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_draw_bitmap(esp_lcd_panel_handle_t panel, int x_start, int y_start, int x_end, int y_end,
+                                    const void* color_data) {
+    if (!panel || x_start >= x_end || y_start >= y_end || x_end > panel->width || y_end > panel->height) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    panel_transfer_t t;
+    t.x1 = x_start;
+    t.y1 = y_start;
+    t.x2 = x_end;
+    t.y2 = y_end;
+    t.data = (const uint8_t*)color_data;
+    t.bytes = (size_t)(x_end - x_start) * (y_end - y_start) * sizeof(uint16_t);
+    t.hash = panel_hash(t.data, t.bytes);
+
+    std::unique_lock<std::mutex> guard(panel->lock);
+    if (panel->fail_after == 0) {
+        panel->fail_after = -1;
+        return ESP_FAIL;
+    }
+    if (panel->fail_after > 0) panel->fail_after--;
+    panel->stats.transfers++;
+    panel->stats.bytes += t.bytes;
+
+    if (panel->ns_per_byte == 0) {
+        // Bus instantáneo: el "ISR" salta antes de que draw_bitmap vuelva
+        if (panel->stats.max_queued < 1) panel->stats.max_queued = 1;
+        guard.unlock();
+        panel_complete(panel, t);
+        return ESP_OK;
+    }
+
+    // El bus es serie: empieza cuando termina la anterior
+    const auto now = std::chrono::steady_clock::now();
+    const auto start = panel->bus_free_at > now ? panel->bus_free_at : now;
+    t.done_at = start + std::chrono::nanoseconds((uint64_t)t.bytes * panel->ns_per_byte);
+    panel->bus_free_at = t.done_at;
+    panel->queue.push_back(t);
+    panel->pending++;
+    if (panel->pending > panel->stats.max_queued) panel->stats.max_queued = panel->pending;
+    if (!panel->bus.joinable()) panel->bus = std::thread(panel_bus_loop, panel);
+    panel->cv.notify_all();
+    return ESP_OK;
+}
@@ -0,0 +1,103 @@
+// Particiones del build de host (esp_partition.h): cada una es un fichero.
+// esp_partition_read usa pread y esp_partition_mmap, mmap de solo lectura.
+
+#include "esp_partition.h"
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <fcntl.h>
+#include <map>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+typedef struct {
+    esp_partition_t part;
+    std::string path;
+} host_partition_t;
+
+typedef struct {
+    void* addr;
+    size_t len;
+} host_mapping_t;
+
+// deque: los esp_partition_t no se mueven al registrar más
+static std::deque<host_partition_t> partitions;
+static std::map<esp_partition_mmap_handle_t, host_mapping_t> mappings;
+static esp_partition_mmap_handle_t next_handle = 1;
+
+static const host_partition_t* host_partition_of(const esp_partition_t* part) {
+    for (const host_partition_t& p : partitions) {
+        if (&p.part == part) return &p;
+    }
+    return nullptr;
+}
+
+esp_err_t host_partition_add_file(const char* label, uint8_t subtype, const char* path) {
+    struct stat st;
+    if (stat(path, &st) != 0) return ESP_ERR_NOT_FOUND;
+
+    host_partition_t p = {};
+    p.part.type = ESP_PARTITION_TYPE_DATA;
+    p.part.subtype = (esp_partition_subtype_t)subtype;
+    p.part.size = (uint32_t)st.st_size;
+    p.part.erase_size = 4096;
+    p.part.readonly = true;
+    snprintf(p.part.label, sizeof(p.part.label), "%s", label);
+    p.path = path;
+    partitions.push_back(p);
+    return ESP_OK;
+}
+
+const esp_partition_t* esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                                                const char* label) {
+    for (const host_partition_t& p : partitions) {
+        if (type != ESP_PARTITION_TYPE_ANY && p.part.type != type) continue;
+        if (subtype != ESP_PARTITION_SUBTYPE_ANY && p.part.subtype != subtype) continue;
+        if (label && strcmp(p.part.label, label) != 0) continue;
+        return &p.part;
+    }
+    return nullptr;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t* partition, size_t src_offset, void* dst, size_t size) {
+    const host_partition_t* p = host_partition_of(partition);
+    if (!p) return ESP_ERR_INVALID_ARG;
+    if (src_offset + size > partition->size) return ESP_ERR_INVALID_SIZE;
+
+    const int fd = open(p->path.c_str(), O_RDONLY);
+    if (fd < 0) return ESP_FAIL;
+    const ssize_t n = pread(fd, dst, size, (off_t)src_offset);
+    close(fd);
+    return n == (ssize_t)size ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t esp_partition_mmap(const esp_partition_t* partition, size_t offset, size_t size,
+                             esp_partition_mmap_memory_t memory, const void** out_ptr,
+                             esp_partition_mmap_handle_t* out_handle) {
+    const host_partition_t* p = host_partition_of(partition);
+    if (!p || !out_ptr || !out_handle || size == 0) return ESP_ERR_INVALID_ARG;
+    if (offset + size > partition->size) return ESP_ERR_INVALID_SIZE;
+
+    // mmap pide un offset alineado a página: se proyecta desde el inicio de la página
+    const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    const size_t skip = offset % page;
+    const int fd = open(p->path.c_str(), O_RDONLY);
+    if (fd < 0) return ESP_FAIL;
+    void* addr = mmap(nullptr, size + skip, PROT_READ, MAP_PRIVATE, fd, (off_t)(offset - skip));
+    close(fd);
+    if (addr == MAP_FAILED) return ESP_ERR_NO_MEM;
+
+    *out_handle = next_handle++;
+    mappings[*out_handle] = { addr, size + skip };
+    *out_ptr = (const uint8_t*)addr + skip;
+    return ESP_OK;
+}
+
+void esp_partition_munmap(esp_partition_mmap_handle_t handle) {
+    auto it = mappings.find(handle);
+    if (it == mappings.end()) return;
+    munmap(it->second.addr, it->second.len);
+    mappings.erase(it);
+}
@@ -0,0 +1,97 @@
+// Display del build de host. Sustituye a screen_manager.cpp (SPI, ST7789,
+// backlight) por el panel simulado de host_panel.h; el camino de flush
+// (screen_flush.cpp) y la gestión de vistas (screen_views.cpp) se enlazan tal
+// cual. Por defecto el bus es instantáneo: el fin de transferencia llega dentro
+// de draw_bitmap y los benchmarks no esperan a nadie.
+
+#include "controllers/screen_manager/screen_manager.h"
+#include "controllers/draw_accel/draw_accel.h"
+#include "config.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "host_clock.h"
+#include "host_panel.h"
+
+// Adelanto sobre host_clock_ms que dejó un reloj alternativo (ver screen_set_tick_cb)
+static uint32_t tick_offset_ms = 0;
+
+// El tick de LVGL es el reloj virtual: solo avanza cuando el código "duerme"
+static uint32_t screen_tick_get_cb() {
+    return host_clock_ms() + tick_offset_ms;
+}
+
+screen_t* screen_init() {
+    const screen_render_config_t cfg = {
+        .mode = SCREEN_RENDER_PARTIAL,
+        .strip_lines = SCREEN_STRIP_LINES,
+        .bounce_lines = SCREEN_BOUNCE_LINES,
+    };
+    return screen_init_with_config(&cfg);
+}
+
+screen_t* screen_init_with_config(const screen_render_config_t* cfg) {
+    screen_t* screen = new screen_t();
+    screen->render_cfg = *cfg;
+    host_panel_create(SCREEN_WIDTH, SCREEN_HEIGHT, &screen->io_handle, &screen->panel_handle);
+    screen_init_lvgl(screen);
+    return screen;
+}
+
+void screen_init_lvgl(screen_t* screen) {
+    lv_init();
+    lv_tick_set_cb(screen_tick_get_cb);
+
+    screen_flush_setup(screen);
+    screen->fps_last_us = (int64_t)host_clock_ms() * 1000;
+
+#if DRAW_ACCEL_ENABLED
+    draw_accel_init();
+#endif
+}
+
+void screen_set_tick_cb(lv_tick_get_cb_t cb) {
+    if (!cb) {
+        // Como en la placa: el reloj de ui_replay avanza sin vTaskDelay y deja
+        // host_clock_ms atrás; se sigue desde el mayor de los dos
+        const uint32_t left = lv_tick_get();
+        const uint32_t real = screen_tick_get_cb();
+        if ((int32_t)(left - real) > 0) {
+            tick_offset_ms += left - real;
+        }
+        cb = screen_tick_get_cb;
+    }
+    lv_tick_set_cb(cb);
+}
+
+void screen_get_render_info(screen_t* screen, screen_render_info_t* out) {
+    if (!screen || !out) return;
+
+    // FPS en tiempo virtual, que es el que ven los timers de las vistas
+    const int64_t now = (int64_t)host_clock_ms() * 1000;
+    const uint32_t frames = screen->frames_flushed;
+    const int64_t elapsed_us = now - screen->fps_last_us;
+
+    out->mode = screen->render_cfg.mode;
+    out->internal_ram_bytes = screen->internal_ram_bytes;
+    out->psram_bytes = screen->psram_bytes;
+    out->frames_flushed = frames;
+    out->fps = elapsed_us > 0 ? (uint32_t)((uint64_t)(frames - screen->fps_last_frames) * 1000000 / elapsed_us) : 0;
+
+    screen->fps_last_frames = frames;
+    screen->fps_last_us = now;
+}
+
+void screen_deinit(screen_t* screen) {
+    if (screen) {
+        // A diferencia de la placa, los tests crean varias pantallas: el display se va con ella
+        if (screen->lvgl_disp) lv_display_delete(screen->lvgl_disp);
+        host_panel_delete(screen->panel_handle);
+        if (screen->flush_done_sem) vSemaphoreDelete(screen->flush_done_sem);
+        if (screen->bounce_free_sem) vSemaphoreDelete(screen->bounce_free_sem);
+        heap_caps_free(screen->lvgl_buf1);
+        heap_caps_free(screen->lvgl_buf2);
+        heap_caps_free(screen->bounce_buf[0]);
+        heap_caps_free(screen->bounce_buf[1]);
+        delete screen;
+    }
+}
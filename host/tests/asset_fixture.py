@@ -0,0 +1,173 @@
+#!/usr/bin/env python3
+"""Imágenes y fuente de prueba para el pack de assets del build de host.
+
+Escribe en <dir>:
+  images/*.bin  imágenes binarias de LVGL 9 (RGB565 y RGB565A8)
+  fonts/*.bin   una fuente en el formato de lv_font_conv --format bin --no-compress,
+                con cmaps format0_tiny, sparse_tiny y sparse_full
+  expect.txt    lo que los tests deben leer del pack una vez convertido:
+                  image <nombre> <cf> <w> <h> <stride>
+                  font <nombre> <line_height> <base_line> <bpp> <cmaps> <glifos> <underline_pos> <underline_thick>
+                  glyph <fuente> <codepoint> <adv> <box_w> <box_h> <ofs_x> <ofs_y> <bitmap en hex>
+
+Todo es determinista: los mismos bytes en cada ejecución.
+
+  asset_fixture.py <dir>
+"""
+
+import os
+import struct
+import sys
+
+LV_IMAGE_HEADER_MAGIC = 0x19
+CF_RGB565 = 0x12
+CF_RGB565A8 = 0x14
+
+CMAP_FORMAT0_TINY, CMAP_SPARSE_FULL, CMAP_SPARSE_TINY = 2, 1, 3
+
+FONT_BPP = 2
+FONT_XY_BITS = 5
+FONT_WH_BITS = 5
+FONT_ADV_BITS = 6
+FONT_ASCENT = 10
+FONT_DESCENT = -3
+FONT_UNDERLINE = (-2, 1)
+
+
+class BitWriter:
+    def __init__(self):
+        self.buf = bytearray()
+        self.nbits = 0
+
+    def write(self, value, n):
+        for i in range(n - 1, -1, -1):
+            if self.nbits % 8 == 0:
+                self.buf.append(0)
+            if (value >> i) & 1:
+                self.buf[-1] |= 0x80 >> (self.nbits % 8)
+            self.nbits += 1
+
+
+def image_bin(cf, w, h, stride, data):
+    return struct.pack('<BBHHHHH', LV_IMAGE_HEADER_MAGIC, cf, 0, w, h, stride, 0) + data
+
+
+def make_images(out_dir, expect):
+    # Degradado opaco, con un stride mayor que el ancho
+    w, h, stride = 20, 10, 44
+    rgb = bytearray()
+    for y in range(h):
+        for x in range(w):
+            rgb += struct.pack('<H', ((x * 3) << 11 | (y * 6) << 5 | (x + y)) & 0xFFFF)
+        rgb += b'\xAA' * (stride - w * 2)
+    images = [('ramp', CF_RGB565, w, h, stride, bytes(rgb))]
+
+    # RGB565A8: plano de color y plano alfa
+    w, h = 7, 5
+    color = b''.join(struct.pack('<H', (i * 2731) & 0xFFFF) for i in range(w * h))
+    alpha = bytes((i * 37) & 0xFF for i in range(w * h))
+    images.append(('badge', CF_RGB565A8, w, h, w * 2, color + alpha))
+
+    os.makedirs(os.path.join(out_dir, 'images'), exist_ok=True)
+    for name, cf, w, h, stride, data in images:
+        with open(os.path.join(out_dir, 'images', name + '.bin'), 'wb') as f:
+            f.write(image_bin(cf, w, h, stride, data))
+        expect.append('image %s %d %d %d %d' % (name, cf, w, h, stride))
+
+
+def glyph_shape(gid):
+    w = 3 + gid % 5
+    h = 4 + gid % 7
+    adv = w + 1 + gid % 2
+    ofs_x = gid % 3 - 1
+    ofs_y = -(gid % 4)
+    pixels = [(i * 7 + gid) % (1 << FONT_BPP) for i in range(w * h)]
+    return adv, w, h, ofs_x, ofs_y, pixels
+
+
+def table(tag, body):
+    return struct.pack('<I4s', 8 + len(body), tag) + body
+
+
+def make_font(out_dir, expect):
+    name = 'fixture_font'
+    # (codepoint, gid): tres cmaps que no se solapan
+    digits = [(0x30 + i, 1 + i) for i in range(10)]
+    letters = [(0x41, 11), (0x5A, 12), (0xE9, 13)]
+    arrows = [(0x2190, 15), (0x2192, 14)]      # sparse_full: el orden de glifos no sigue al de códigos
+    glyph_count = 16
+
+    # glyf: un flujo de bits por glifo, cada uno empezando en byte; el 0 está vacío
+    glyf = bytearray()
+    offsets = [0]
+    for gid in range(1, glyph_count):
+        adv, w, h, ofs_x, ofs_y, pixels = glyph_shape(gid)
+        offsets.append(8 + len(glyf))
+        bits = BitWriter()
+        bits.write(adv, FONT_ADV_BITS)
+        bits.write(ofs_x & ((1 << FONT_XY_BITS) - 1), FONT_XY_BITS)
+        bits.write(ofs_y & ((1 << FONT_XY_BITS) - 1), FONT_XY_BITS)
+        bits.write(w, FONT_WH_BITS)
+        bits.write(h, FONT_WH_BITS)
+        for p in pixels:
+            bits.write(p, FONT_BPP)
+        glyf += bits.buf
+
+    loca = struct.pack('<I', glyph_count) + struct.pack('<%dH' % glyph_count, *offsets)
+
+    # cmap: registros de 16 bytes y después las listas (offsets desde el inicio de la tabla)
+    cmap_records = []
+    lists = bytearray()
+    lists_base = 8 + 4 + 16 * 3
+
+    cmap_records.append((0, 0x30, 10, 1, 0, CMAP_FORMAT0_TINY))
+
+    sparse_ofs = lists_base + len(lists)
+    for cp, _ in letters:
+        lists += struct.pack('<H', cp - 0x41)
+    cmap_records.append((sparse_ofs, 0x41, 0xE9 - 0x41 + 1, 11, len(letters), CMAP_SPARSE_TINY))
+
+    full_ofs = lists_base + len(lists)
+    for cp, _ in arrows:
+        lists += struct.pack('<H', cp - 0x2190)
+    for _, gid in arrows:
+        lists += struct.pack('<H', gid - 14)
+    cmap_records.append((full_ofs, 0x2190, 3, 14, len(arrows), CMAP_SPARSE_FULL))
+
+    cmap = struct.pack('<I', len(cmap_records))
+    for data_ofs, start, length, gid_start, entries, fmt in cmap_records:
+        cmap += struct.pack('<IIHHHBB', data_ofs, start, length, gid_start, entries, fmt, 0)
+    cmap += lists
+
+    head = struct.pack('<IHHHhHhHhhHHBBBBBBBBBB', 1, 4, 12, FONT_ASCENT, FONT_DESCENT, FONT_ASCENT,
+                       FONT_DESCENT, 0, FONT_DESCENT, FONT_ASCENT, 0, 0,
+                       0, 0, 0, FONT_BPP, FONT_XY_BITS, FONT_WH_BITS, FONT_ADV_BITS, 0, 0, 0)
+    head += struct.pack('<hH', *FONT_UNDERLINE)
+
+    os.makedirs(os.path.join(out_dir, 'fonts'), exist_ok=True)
+    with open(os.path.join(out_dir, 'fonts', name + '.bin'), 'wb') as f:
+        f.write(table(b'head', head) + table(b'cmap', cmap) + table(b'loca', loca) + table(b'glyf', glyf))
+
+    expect.append('font %s %d %d %d %d %d %d %d' % (name, FONT_ASCENT - FONT_DESCENT, -FONT_DESCENT, FONT_BPP,
+                                                    len(cmap_records), glyph_count, *FONT_UNDERLINE))
+    for cp, gid in digits + letters + arrows:
+        adv, w, h, ofs_x, ofs_y, pixels = glyph_shape(gid)
+        bits = BitWriter()
+        for p in pixels:
+            bits.write(p, FONT_BPP)
+        expect.append('glyph %s %d %d %d %d %d %d %s' % (name, cp, adv, w, h, ofs_x, ofs_y, bits.buf.hex()))
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.exit(__doc__)
+    out_dir = sys.argv[1]
+    expect = []
+    make_images(out_dir, expect)
+    make_font(out_dir, expect)
+    with open(os.path.join(out_dir, 'expect.txt'), 'w') as f:
+        f.write('\n'.join(expect) + '\n')
+
+
+if __name__ == '__main__':
+    main()
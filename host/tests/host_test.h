@@ -0,0 +1,38 @@
+// Aserciones de los tests de host. Un fallo no corta el test: se imprime con
+// su línea y el test sigue, así una ejecución enseña todos los casos rotos.
+// main() termina con "return host_test_result();".
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include <cstdio>
+
+static int host_test_failures = 0;
+
+#define CHECK(cond)                                                                 \
+    do {                                                                            \
+        if (!(cond)) {                                                              \
+            fprintf(stderr, "%s:%d: CHECK(%s)\n", __FILE__, __LINE__, #cond);       \
+            host_test_failures++;                                                   \
+        }                                                                           \
+    } while (0)
+
+#define CHECK_EQ(a, b)                                                              \
+    do {                                                                            \
+        const long long check_a_ = (long long)(a);                                  \
+        const long long check_b_ = (long long)(b);                                  \
+        if (check_a_ != check_b_) {                                                 \
+            fprintf(stderr, "%s:%d: CHECK_EQ(%s, %s): %lld != %lld\n", __FILE__,    \
+                    __LINE__, #a, #b, check_a_, check_b_);                          \
+            host_test_failures++;                                                   \
+        }                                                                           \
+    } while (0)
+
+static inline int host_test_result() {
+    if (host_test_failures) {
+        fprintf(stderr, "%d comprobaciones fallidas\n", host_test_failures);
+        return 1;
+    }
+    return 0;
+}
+
+#endif
@@ -0,0 +1,372 @@
+// Lector del pack de assets (asset_pack_format.h) sobre un pack real de
+// tools/pack_assets.py: el CRC del índice con esp_rom_crc32_le como en
+// fs_manager, la búsqueda de cada asset, los nombres que no están y los packs
+// corruptos o truncados que asset_pack_check debe rechazar. Las imágenes y la
+// fuente de asset_fixture.py se comparan con su expect.txt: cabecera, píxeles
+// y, en la fuente, cmaps, glyph_dsc y bitmap de cada glifo. Al final mide la
+// búsqueda en el pack mapeado frente a abrir un fichero por asset (ABENCH).
+//
+//   test_asset_pack <pack.bin> <directorio de entrada con el que se generó>
+
+#include "host_test.h"
+#include "controllers/fs_manager/asset_pack_format.h"
+#include "esp_partition.h"
+#include "esp_rom_crc.h"
+#include "esp_timer.h"
+#include <dirent.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#define ASSET_BENCH_PACK_ITERATIONS 2000
+#define ASSET_BENCH_FILE_ITERATIONS 100
+#define LV_IMAGE_BIN_HEADER_SIZE    12      // lv_image_header_t al principio de un .bin de LVGL
+#define IMAGE_CF_RGB565A8           0x14    // LV_COLOR_FORMAT_RGB565A8
+
+// lv_font_fmt_txt_cmap_type_t
+enum { CMAP_FORMAT0_FULL, CMAP_SPARSE_FULL, CMAP_FORMAT0_TINY, CMAP_SPARSE_TINY };
+
+static const char* const asset_dirs[] = { "raw", "images", "fonts" };
+static const asset_type_t asset_dir_types[] = { ASSET_TYPE_RAW, ASSET_TYPE_IMAGE, ASSET_TYPE_FONT };
+
+static std::vector<uint8_t> read_file(const std::string& path) {
+    std::vector<uint8_t> data;
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return data;
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) {
+        data.insert(data.end(), chunk, chunk + n);
+    }
+    fclose(f);
+    return data;
+}
+
+static std::vector<std::string> list_dir(const std::string& path) {
+    std::vector<std::string> names;
+    DIR* dir = opendir(path.c_str());
+    if (!dir) return names;
+    while (const dirent* ent = readdir(dir)) {
+        if (ent->d_name[0] != '.') names.push_back(ent->d_name);
+    }
+    closedir(dir);
+    return names;
+}
+
+static std::string strip_ext(const std::string& fname) {
+    return fname.substr(0, fname.rfind('.'));
+}
+
+static uint32_t index_crc(const std::vector<uint8_t>& pack) {
+    const asset_pack_header_t* hdr = (const asset_pack_header_t*)pack.data();
+    return esp_rom_crc32_le(0, pack.data() + sizeof(asset_pack_header_t),
+                            hdr->data_offset - sizeof(asset_pack_header_t));
+}
+
+static void test_lookup(const std::vector<uint8_t>& pack, const std::string& input_dir) {
+    const asset_pack_header_t* hdr = (const asset_pack_header_t*)pack.data();
+    CHECK(asset_pack_check(pack.data(), pack.size()));
+    CHECK_EQ(hdr->total_size, pack.size());
+    CHECK_EQ(index_crc(pack), hdr->index_crc32);
+
+    // Cada fichero de entrada está en el pack con el tipo de su directorio y
+    // alineado; los raw con sus bytes, las imágenes con los que siguen a la cabecera
+    uint32_t found = 0;
+    for (size_t d = 0; d < sizeof(asset_dirs) / sizeof(asset_dirs[0]); d++) {
+        const std::string dir = input_dir + "/" + asset_dirs[d];
+        for (const std::string& fname : list_dir(dir)) {
+            const asset_pack_entry_t* e = asset_pack_find(pack.data(), strip_ext(fname).c_str());
+            CHECK(e != nullptr);
+            if (!e) continue;
+            found++;
+            CHECK_EQ(e->type, asset_dir_types[d]);
+            CHECK_EQ(e->offset % ASSET_PACK_DATA_ALIGN, 0);
+            CHECK(e->offset >= hdr->data_offset && e->offset + e->size <= hdr->total_size);
+
+            std::vector<uint8_t> expected = read_file(dir + "/" + fname);
+            if (e->type == ASSET_TYPE_FONT) continue;
+            if (e->type == ASSET_TYPE_IMAGE) {
+                CHECK(expected.size() >= LV_IMAGE_BIN_HEADER_SIZE);
+                expected.erase(expected.begin(), expected.begin() + LV_IMAGE_BIN_HEADER_SIZE);
+            }
+            CHECK_EQ(e->size, expected.size());
+            CHECK(expected.empty() || memcmp(pack.data() + e->offset, expected.data(), expected.size()) == 0);
+        }
+    }
+    CHECK(found > 0);
+    CHECK_EQ(found, hdr->entry_count);
+
+    // Índice ordenado por hash (la búsqueda binaria depende de ello)
+    const asset_pack_entry_t* entries = (const asset_pack_entry_t*)(pack.data() + sizeof(asset_pack_header_t));
+    for (uint32_t i = 1; i < hdr->entry_count; i++) {
+        CHECK(entries[i - 1].name_hash < entries[i].name_hash);
+    }
+
+    CHECK(asset_pack_find(pack.data(), "") == nullptr);
+    CHECK(asset_pack_find(pack.data(), "__missing__") == nullptr);
+    CHECK(asset_pack_find(pack.data(), "sixteenx") == nullptr);
+}
+
+// La cabecera de la entrada sustituye a la del .bin de LVGL: cf, w, h y stride
+static void test_image(const std::vector<uint8_t>& pack, const std::string& input_dir, std::istringstream& line) {
+    std::string name;
+    unsigned cf, w, h, stride;
+    line >> name >> cf >> w >> h >> stride;
+
+    const asset_pack_entry_t* e = asset_pack_find(pack.data(), name.c_str());
+    CHECK(e != nullptr);
+    if (!e) return;
+    CHECK_EQ(e->type, ASSET_TYPE_IMAGE);
+    CHECK_EQ(e->cf, cf);
+    CHECK_EQ(e->w, w);
+    CHECK_EQ(e->h, h);
+    CHECK_EQ(e->stride, stride);
+
+    const std::vector<uint8_t> bin = read_file(input_dir + "/images/" + name + ".bin");
+    CHECK(bin.size() >= LV_IMAGE_BIN_HEADER_SIZE);
+    if (bin.size() < LV_IMAGE_BIN_HEADER_SIZE) return;
+    uint16_t bin_w, bin_h, bin_stride;
+    memcpy(&bin_w, &bin[4], 2);
+    memcpy(&bin_h, &bin[6], 2);
+    memcpy(&bin_stride, &bin[8], 2);
+    CHECK_EQ(bin[1], e->cf);
+    CHECK_EQ(bin_w, e->w);
+    CHECK_EQ(bin_h, e->h);
+    CHECK_EQ(bin_stride, e->stride);
+    // Con RGB565A8 el plano alfa va detrás del de color
+    const uint32_t planes = cf == IMAGE_CF_RGB565A8 ? 2 : 1;
+    CHECK(e->size >= (uint32_t)stride * h + (planes - 1) * w * h);
+}
+
+// Misma resolución que lv_font_get_glyph_dsc_fmt_txt, leyendo el asset tal cual está en el pack
+static uint32_t font_glyph_id(const uint8_t* asset, const asset_font_header_t* fh, uint32_t cp) {
+    const asset_font_cmap_t* cmaps = (const asset_font_cmap_t*)(asset + fh->cmaps_offset);
+    for (uint16_t i = 0; i < fh->cmap_num; i++) {
+        const asset_font_cmap_t& c = cmaps[i];
+        if (cp < c.range_start || cp - c.range_start >= c.range_length) continue;
+        const uint32_t rcp = cp - c.range_start;
+        const uint16_t* unicode_list = (const uint16_t*)(asset + c.unicode_list_offset);
+
+        switch (c.type) {
+        case CMAP_FORMAT0_TINY:
+            return c.glyph_id_start + rcp;
+        case CMAP_FORMAT0_FULL:
+            return c.glyph_id_start + asset[c.glyph_id_ofs_list_offset + rcp];
+        case CMAP_SPARSE_TINY:
+        case CMAP_SPARSE_FULL:
+            for (uint16_t k = 0; k < c.list_length; k++) {
+                if (unicode_list[k] != rcp) continue;
+                if (c.type == CMAP_SPARSE_TINY) return c.glyph_id_start + k;
+                return c.glyph_id_start + ((const uint16_t*)(asset + c.glyph_id_ofs_list_offset))[k];
+            }
+            return 0;
+        }
+    }
+    return 0;
+}
+
+static void test_font(const std::vector<uint8_t>& pack, std::istringstream& line) {
+    std::string name;
+    int line_height, base_line, bpp, cmaps, glyphs, ul_pos, ul_thick;
+    line >> name >> line_height >> base_line >> bpp >> cmaps >> glyphs >> ul_pos >> ul_thick;
+
+    const asset_pack_entry_t* e = asset_pack_find(pack.data(), name.c_str());
+    CHECK(e != nullptr);
+    if (!e) return;
+    CHECK_EQ(e->type, ASSET_TYPE_FONT);
+    const asset_font_header_t* fh = (const asset_font_header_t*)(pack.data() + e->offset);
+    CHECK_EQ(fh->line_height, line_height);
+    CHECK_EQ(fh->base_line, base_line);
+    CHECK_EQ(fh->bpp, bpp);
+    CHECK_EQ(fh->cmap_num, cmaps);
+    CHECK_EQ(fh->glyph_count, glyphs);
+    CHECK_EQ(fh->underline_position, ul_pos);
+    CHECK_EQ(fh->underline_thickness, ul_thick);
+    CHECK(fh->glyph_dsc_offset + fh->glyph_count * 8 <= fh->bitmap_offset);
+    CHECK(fh->cmaps_offset + fh->cmap_num * sizeof(asset_font_cmap_t) <= e->size);
+    // Las cmaps se usan en su sitio: sus listas de uint16_t tienen que estar alineadas
+    CHECK_EQ(e->offset % 4, 0);
+}
+
+static void test_glyph(const std::vector<uint8_t>& pack, std::istringstream& line) {
+    std::string font, hex;
+    uint32_t cp;
+    int adv, box_w, box_h, ofs_x, ofs_y;
+    line >> font >> cp >> adv >> box_w >> box_h >> ofs_x >> ofs_y >> hex;
+
+    const asset_pack_entry_t* e = asset_pack_find(pack.data(), font.c_str());
+    if (!e) return;
+    const uint8_t* asset = pack.data() + e->offset;
+    const asset_font_header_t* fh = (const asset_font_header_t*)asset;
+
+    const uint32_t gid = font_glyph_id(asset, fh, cp);
+    CHECK(gid > 0 && gid < fh->glyph_count);
+    if (gid == 0 || gid >= fh->glyph_count) {
+        fprintf(stderr, "  glifo U+%04X sin cmap\n", (unsigned)cp);
+        return;
+    }
+
+    // lv_font_fmt_txt_glyph_dsc_t: bitmap_index:20 | adv_w:12 (en 1/16 px), box y offsets
+    const uint8_t* dsc = asset + fh->glyph_dsc_offset + gid * 8;
+    uint32_t word;
+    memcpy(&word, dsc, 4);
+    const uint32_t bitmap_index = word & 0xFFFFF;
+    CHECK_EQ(word >> 20, adv * 16);
+    CHECK_EQ(dsc[4], box_w);
+    CHECK_EQ(dsc[5], box_h);
+    CHECK_EQ((int8_t)dsc[6], ofs_x);
+    CHECK_EQ((int8_t)dsc[7], ofs_y);
+
+    // Bitmap: píxeles seguidos MSB primero, sin relleno entre filas
+    const size_t bytes = (box_w * box_h * fh->bpp + 7) / 8;
+    CHECK_EQ(hex.size(), bytes * 2);
+    CHECK(fh->bitmap_offset + bitmap_index + bytes <= e->size);
+    bool same = hex.size() == bytes * 2;
+    for (size_t i = 0; same && i < bytes; i++) {
+        same = strtoul(hex.substr(i * 2, 2).c_str(), nullptr, 16) == asset[fh->bitmap_offset + bitmap_index + i];
+    }
+    CHECK(same);
+}
+
+static void test_fixture(const std::vector<uint8_t>& pack, const std::string& input_dir) {
+    std::ifstream expect(input_dir + "/expect.txt");
+    CHECK(expect.good());
+    uint32_t images = 0, fonts = 0, glyphs = 0;
+    std::string text;
+    while (std::getline(expect, text)) {
+        std::istringstream line(text);
+        std::string kind;
+        line >> kind;
+        if (kind == "image") {
+            test_image(pack, input_dir, line);
+            images++;
+        } else if (kind == "font") {
+            test_font(pack, line);
+            fonts++;
+        } else if (kind == "glyph") {
+            test_glyph(pack, line);
+            glyphs++;
+        }
+    }
+    CHECK(images > 0 && fonts > 0 && glyphs > 0);
+
+    // Un código fuera de todas las cmaps, y otro dentro del rango de la sparse sin estar en su lista
+    const asset_pack_entry_t* e = asset_pack_find(pack.data(), "fixture_font");
+    if (!e) return;
+    const uint8_t* asset = pack.data() + e->offset;
+    CHECK_EQ(font_glyph_id(asset, (const asset_font_header_t*)asset, 0x20), 0);
+    CHECK_EQ(font_glyph_id(asset, (const asset_font_header_t*)asset, 0x42), 0);
+    CHECK_EQ(font_glyph_id(asset, (const asset_font_header_t*)asset, 0x2191), 0);
+}
+
+static void test_rejects(const std::vector<uint8_t>& pack) {
+    // Truncado: ni cabecera, ni el pack entero
+    CHECK(!asset_pack_check(pack.data(), sizeof(asset_pack_header_t) - 1));
+    CHECK(!asset_pack_check(pack.data(), pack.size() - 1));
+
+    std::vector<uint8_t> bad = pack;
+    asset_pack_header_t* hdr = (asset_pack_header_t*)bad.data();
+    hdr->magic ^= 1;
+    CHECK(!asset_pack_check(bad.data(), bad.size()));
+
+    bad = pack;
+    hdr = (asset_pack_header_t*)bad.data();
+    hdr->version++;
+    CHECK(!asset_pack_check(bad.data(), bad.size()));
+
+    // Índice que se solapa con la tabla de nombres
+    bad = pack;
+    hdr = (asset_pack_header_t*)bad.data();
+    hdr->entry_count++;
+    CHECK(!asset_pack_check(bad.data(), bad.size()));
+
+    bad = pack;
+    hdr = (asset_pack_header_t*)bad.data();
+    hdr->data_offset = hdr->total_size + 16;
+    CHECK(!asset_pack_check(bad.data(), bad.size()));
+
+    // Un nombre cambiado pasa asset_pack_check pero no el CRC
+    bad = pack;
+    hdr = (asset_pack_header_t*)bad.data();
+    bad[hdr->names_offset] ^= 0x20;
+    CHECK(asset_pack_check(bad.data(), bad.size()));
+    CHECK(index_crc(bad) != hdr->index_crc32);
+}
+
+// Búsqueda en el pack mapeado desde su fichero, como lo monta fs_manager, frente
+// al camino de un fichero por asset: abrir <dir>/<tipo>/<nombre>.bin y leer su cabecera
+static void bench_lookup(const char* pack_path, const std::string& input_dir) {
+    CHECK_EQ(host_partition_add_file("bench_pack", 0x40, pack_path), ESP_OK);
+    const esp_partition_t* part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                                           (esp_partition_subtype_t)0x40, "bench_pack");
+    CHECK(part != nullptr);
+    if (!part) return;
+    const void* ptr = nullptr;
+    esp_partition_mmap_handle_t handle;
+    CHECK_EQ(esp_partition_mmap(part, 0, part->size, ESP_PARTITION_MMAP_DATA, &ptr, &handle), ESP_OK);
+    const uint8_t* base = (const uint8_t*)ptr;
+    CHECK(asset_pack_check(base, part->size));
+
+    std::vector<std::string> names, paths;
+    for (const char* sub : asset_dirs) {
+        for (const std::string& fname : list_dir(input_dir + "/" + sub)) {
+            names.push_back(strip_ext(fname));
+            paths.push_back(input_dir + "/" + sub + "/" + fname);
+        }
+    }
+    const uint32_t n = (uint32_t)names.size();
+    CHECK(n > 0);
+    if (n == 0) return;
+
+    printf("ABENCH,test,entries,iterations,ns_per_op\n");
+    uint32_t found = 0;
+    int64_t t0 = esp_timer_get_time();
+    for (uint32_t it = 0; it < ASSET_BENCH_PACK_ITERATIONS; it++) {
+        for (const std::string& name : names) found += asset_pack_find(base, name.c_str()) != nullptr;
+    }
+    const int64_t pack_ns = (esp_timer_get_time() - t0) * 1000 / ((int64_t)ASSET_BENCH_PACK_ITERATIONS * n);
+    printf("ABENCH,lookup,%lu,%u,%lld\n", (unsigned long)n, ASSET_BENCH_PACK_ITERATIONS, (long long)pack_ns);
+    CHECK_EQ(found, ASSET_BENCH_PACK_ITERATIONS * n);
+
+    t0 = esp_timer_get_time();
+    for (uint32_t it = 0; it < ASSET_BENCH_PACK_ITERATIONS; it++) {
+        found += asset_pack_find(base, "__missing__") != nullptr;
+    }
+    const int64_t miss_ns = (esp_timer_get_time() - t0) * 1000 / ASSET_BENCH_PACK_ITERATIONS;
+    printf("ABENCH,miss,%lu,%u,%lld\n", (unsigned long)n, ASSET_BENCH_PACK_ITERATIONS, (long long)miss_ns);
+
+    uint8_t header[LV_IMAGE_BIN_HEADER_SIZE];
+    uint32_t opened = 0;
+    t0 = esp_timer_get_time();
+    for (uint32_t it = 0; it < ASSET_BENCH_FILE_ITERATIONS; it++) {
+        for (const std::string& path : paths) {
+            FILE* f = fopen(path.c_str(), "rb");
+            if (!f) continue;
+            opened += fread(header, 1, sizeof(header), f) > 0 || feof(f);
+            fclose(f);
+        }
+    }
+    const int64_t file_ns = (esp_timer_get_time() - t0) * 1000 / ((int64_t)ASSET_BENCH_FILE_ITERATIONS * n);
+    printf("ABENCH,per_file,%lu,%u,%lld\n", (unsigned long)n, ASSET_BENCH_FILE_ITERATIONS, (long long)file_ns);
+    CHECK_EQ(opened, ASSET_BENCH_FILE_ITERATIONS * n);
+    CHECK(pack_ns < file_ns);
+
+    esp_partition_munmap(handle);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        fprintf(stderr, "uso: %s <pack.bin> <dir de entrada>\n", argv[0]);
+        return 2;
+    }
+    const std::vector<uint8_t> pack = read_file(argv[1]);
+    CHECK(pack.size() >= sizeof(asset_pack_header_t));
+    if (pack.size() < sizeof(asset_pack_header_t)) return host_test_result();
+
+    test_lookup(pack, argv[2]);
+    test_fixture(pack, argv[2]);
+    test_rejects(pack);
+    bench_lookup(argv[1], argv[2]);
+    return host_test_result();
+}
@@ -0,0 +1,310 @@
+// buzzer_seq con un PWM simulado y un gptimer simulado: el "ISR" llama a
+// buzzer_seq_advance en la alarma que pide, con una latencia configurable, y
+// el PWM apunta cada cambio con su instante programado y el aplicado.
+// Comprueba la tabla de notas, el orden y los instantes de cada melodía, que
+// la latencia no se acumule, la cola (espera, interrupción, parada, llena) y
+// un productor en otro hilo contra el consumidor.
+
+#include "host_test.h"
+#include "controllers/buzzer/buzzer_seq.h"
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+struct ToneChange {
+    uint16_t freq_hz;
+    uint64_t at_us;         // Instante programado por el secuenciador
+    uint64_t applied_us;    // Cuándo corrió el ISR que lo aplicó
+};
+
+struct MockPwm {
+    uint16_t freq_hz = 0;
+    uint64_t now_us = 0;
+    std::vector<ToneChange> log;
+    std::vector<uint64_t> stalls;   // Alarmas atendidas con más de STALL_US de retraso
+};
+
+#define JITTER_US 300
+#define STALL_US 25000
+
+static void mock_tone(uint16_t freq_hz, uint64_t at_us, void* ctx) {
+    MockPwm* pwm = (MockPwm*)ctx;
+    CHECK(freq_hz != pwm->freq_hz);     // Solo se avisa si la frecuencia cambia
+    pwm->freq_hz = freq_hz;
+    pwm->log.push_back({ freq_hz, at_us, pwm->now_us });
+}
+
+// Latencia del ISR en cada alarma (µs)
+typedef uint32_t (*latency_fn)(uint32_t alarm);
+
+static uint32_t no_latency(uint32_t) { return 0; }
+
+// Como la tarea 'buzzer': alarma inmediata en 'now' y, desde ahí, cada alarma
+// en el instante que devuelve buzzer_seq_advance hasta que no queda nada
+static void run_timer(buzzer_seq_t* seq, MockPwm* pwm, uint64_t now_us, latency_fn latency) {
+    pwm->now_us = now_us;
+    uint64_t next = buzzer_seq_advance(seq, now_us, mock_tone, pwm);
+    for (uint32_t alarm = 0; next; alarm++) {
+        CHECK(next > pwm->now_us || next == pwm->now_us);
+        const uint32_t late = latency(alarm);
+        pwm->now_us = next + late;
+        if (late > JITTER_US) pwm->stalls.push_back(pwm->now_us);
+        next = buzzer_seq_advance(seq, pwm->now_us, mock_tone, pwm);
+    }
+}
+
+// Cambios que debe producir 'melody' empezando en 'start_us', sin repetir
+// frecuencia; devuelve el final
+static uint64_t expected_changes(const buzzer_step_t* melody, uint64_t start_us, uint16_t* freq,
+                                 std::vector<ToneChange>* out) {
+    uint64_t t = start_us;
+    for (const buzzer_step_t* s = melody; s->ms; s++) {
+        const uint16_t hz = buzzer_note_hz(s->note);
+        if (hz != *freq) out->push_back({ hz, t, 0 });
+        *freq = hz;
+        t += (uint64_t)s->ms * 1000;
+    }
+    if (*freq != 0) out->push_back({ 0, t, 0 });
+    *freq = 0;
+    return t;
+}
+
+static void check_schedule(const MockPwm& pwm, const std::vector<ToneChange>& expect) {
+    CHECK_EQ(pwm.log.size(), expect.size());
+    for (size_t i = 0; i < pwm.log.size() && i < expect.size(); i++) {
+        CHECK_EQ(pwm.log[i].freq_hz, expect[i].freq_hz);
+        CHECK_EQ(pwm.log[i].at_us, expect[i].at_us);
+        CHECK(pwm.log[i].applied_us >= pwm.log[i].at_us);
+    }
+}
+
+static void test_note_table() {
+    CHECK_EQ(buzzer_note_hz(BUZZER_NOTE_REST), 0);
+    CHECK_EQ(buzzer_note_hz(69), 440);
+    CHECK_EQ(buzzer_note_hz(81), 880);
+    CHECK_EQ(buzzer_note_hz(128), 0);
+    CHECK_EQ(buzzer_note_hz(255), 0);
+    for (int n = 1; n < 128; n++) {
+        const double exact = 440.0 * pow(2.0, (n - 69) / 12.0);
+        CHECK(fabs(buzzer_note_hz((uint8_t)n) - exact) <= 0.5);
+        CHECK(buzzer_note_hz((uint8_t)n) >= buzzer_note_hz((uint8_t)(n - 1)));
+    }
+}
+
+// Cada melodía incluida, sola y sin latencia: cambios exactos y aplicados a tiempo
+static void test_melodies() {
+    const buzzer_step_t* melodies[] = { buzzer_melody_click, buzzer_melody_confirm, buzzer_melody_error,
+                                        buzzer_melody_startup };
+    for (const buzzer_step_t* melody : melodies) {
+        static buzzer_seq_t seq;
+        buzzer_seq_init(&seq);
+        MockPwm pwm;
+        CHECK(buzzer_seq_is_idle(&seq));
+        CHECK(buzzer_seq_post(&seq, melody, false));
+        CHECK(!buzzer_seq_is_idle(&seq));
+        run_timer(&seq, &pwm, 1000, no_latency);
+
+        std::vector<ToneChange> expect;
+        uint16_t freq = 0;
+        expected_changes(melody, 1000, &freq, &expect);
+        check_schedule(pwm, expect);
+        for (const ToneChange& c : pwm.log) CHECK_EQ(c.applied_us, c.at_us);
+        CHECK(buzzer_seq_is_idle(&seq));
+        CHECK_EQ(seq.played, 1);
+        CHECK_EQ(seq.preempted, 0);
+        CHECK_EQ(pwm.freq_hz, 0);
+    }
+}
+
+// Latencia del ISR de 0 a JITTER_US y, de vez en cuando, una escritura en
+// flash que lo retrasa STALL_US (más que varias notas): los instantes
+// programados no se mueven y la melodía acaba a su hora
+static uint32_t jitter_latency(uint32_t alarm) {
+    if (alarm % 37 == 36) return STALL_US;
+    return (uint32_t)(rand() % (JITTER_US + 1));
+}
+
+static void test_latency_does_not_accumulate() {
+    static buzzer_step_t melody[201];
+    for (int i = 0; i < 200; i++) {
+        melody[i].note = (i % 3 == 2) ? BUZZER_NOTE_REST : (uint8_t)(60 + i % 24);
+        melody[i].ms = (uint16_t)(5 + (i * 7) % 16);
+    }
+    melody[200] = { 0, 0 };
+
+    static buzzer_seq_t seq;
+    buzzer_seq_init(&seq);
+    MockPwm pwm;
+    srand(42);
+    CHECK(buzzer_seq_post(&seq, melody, false));
+    run_timer(&seq, &pwm, 500, jitter_latency);
+
+    std::vector<ToneChange> expect;
+    uint16_t freq = 0;
+    const uint64_t end = expected_changes(melody, 500, &freq, &expect);
+    check_schedule(pwm, expect);
+    CHECK_EQ(pwm.log.back().at_us, end);
+
+    // Solo llegan tarde los cambios que recupera la alarma de un parón, y
+    // nunca más que el parón; después de él la melodía sigue en su sitio
+    CHECK(!pwm.stalls.empty());
+    for (const ToneChange& c : pwm.log) {
+        const uint64_t late = c.applied_us - c.at_us;
+        if (late <= JITTER_US) continue;
+        bool in_stall = false;
+        for (uint64_t t : pwm.stalls) in_stall |= t == c.applied_us;
+        CHECK(in_stall);
+        CHECK(late <= STALL_US + JITTER_US);
+    }
+    CHECK_EQ(seq.played, 1);
+}
+
+// Sin 'interrupt', la segunda melodía empieza justo donde acaba la primera,
+// aunque el ISR de ese final llegue tarde
+static uint32_t late_latency(uint32_t) { return 700; }
+
+static void test_queued_back_to_back() {
+    static buzzer_seq_t seq;
+    buzzer_seq_init(&seq);
+    MockPwm pwm;
+    CHECK(buzzer_seq_post(&seq, buzzer_melody_click, false));
+    CHECK(buzzer_seq_post(&seq, buzzer_melody_confirm, false));
+    CHECK(buzzer_seq_post(&seq, buzzer_melody_error, false));
+    run_timer(&seq, &pwm, 0, late_latency);
+
+    std::vector<ToneChange> expect;
+    uint16_t freq = 0;
+    uint64_t t = 0;
+    for (const buzzer_step_t* melody : { buzzer_melody_click, buzzer_melody_confirm, buzzer_melody_error }) {
+        // El silencio final y la primera nota de la siguiente caen en el mismo
+        // instante; la tarea solo aplica el último cambio
+        t = expected_changes(melody, t, &freq, &expect);
+    }
+    check_schedule(pwm, expect);
+    CHECK_EQ(seq.played, 3);
+    CHECK_EQ(seq.preempted, 0);
+}
+
+// Con 'interrupt', la nueva corta la actual en el instante del comando
+static void test_interrupt_and_stop() {
+    static buzzer_seq_t seq;
+    buzzer_seq_init(&seq);
+    MockPwm pwm;
+
+    CHECK(buzzer_seq_post(&seq, buzzer_melody_error, false));
+    pwm.now_us = 1000;
+    uint64_t next = buzzer_seq_advance(&seq, 1000, mock_tone, &pwm);
+    CHECK_EQ(next, 1000 + 120 * 1000);
+    CHECK_EQ(pwm.freq_hz, buzzer_note_hz(76));
+
+    // Llamar antes de tiempo no cambia nada
+    pwm.now_us = 50000;
+    CHECK_EQ(buzzer_seq_advance(&seq, 50000, mock_tone, &pwm), next);
+    CHECK_EQ(pwm.log.size(), 1);
+
+    CHECK(buzzer_seq_post(&seq, buzzer_melody_confirm, true));
+    next = buzzer_seq_advance(&seq, 50000, mock_tone, &pwm);
+    CHECK_EQ(seq.preempted, 1);
+    CHECK_EQ(pwm.log.back().freq_hz, buzzer_note_hz(88));
+    CHECK_EQ(pwm.log.back().at_us, 50000);
+    CHECK_EQ(next, 50000 + 60 * 1000);
+
+    // Parar: comando nulo con 'interrupt', silencio al momento
+    CHECK(buzzer_seq_post(&seq, nullptr, true));
+    pwm.now_us = 70000;
+    CHECK_EQ(buzzer_seq_advance(&seq, 70000, mock_tone, &pwm), 0);
+    CHECK_EQ(pwm.freq_hz, 0);
+    CHECK_EQ(pwm.log.back().at_us, 70000);
+    CHECK_EQ(seq.preempted, 2);
+    CHECK_EQ(seq.played, 0);
+    CHECK(buzzer_seq_is_idle(&seq));
+
+    // Una melodía vacía no suena ni cuenta
+    static const buzzer_step_t empty[] = { { 0, 0 } };
+    CHECK(buzzer_seq_post(&seq, empty, false));
+    const size_t changes = pwm.log.size();
+    run_timer(&seq, &pwm, 80000, no_latency);
+    CHECK_EQ(pwm.log.size(), changes);
+    CHECK(buzzer_seq_is_idle(&seq));
+}
+
+// Dos pasos seguidos con la misma nota: un solo cambio de frecuencia
+static void test_same_note_merged() {
+    static const buzzer_step_t melody[] = { { 69, 10 }, { 69, 15 }, { 0, 5 }, { 0, 5 }, { 0, 0 } };
+    static buzzer_seq_t seq;
+    buzzer_seq_init(&seq);
+    MockPwm pwm;
+    CHECK(buzzer_seq_post(&seq, melody, false));
+    run_timer(&seq, &pwm, 0, no_latency);
+    CHECK_EQ(pwm.log.size(), 2);
+    CHECK_EQ(pwm.log[0].freq_hz, 440);
+    CHECK_EQ(pwm.log[1].freq_hz, 0);
+    CHECK_EQ(pwm.log[1].at_us, 25000);
+    CHECK_EQ(seq.played, 1);
+}
+
+static void test_queue_full() {
+    static buzzer_seq_t seq;
+    buzzer_seq_init(&seq);
+    MockPwm pwm;
+    for (int i = 0; i < BUZZER_SEQ_QUEUE_DEPTH; i++) CHECK(buzzer_seq_post(&seq, buzzer_melody_click, false));
+    CHECK(!buzzer_seq_post(&seq, buzzer_melody_click, false));
+    CHECK_EQ(seq.dropped, 1);
+
+    run_timer(&seq, &pwm, 0, no_latency);
+    CHECK_EQ(seq.played, BUZZER_SEQ_QUEUE_DEPTH);
+    // Los 8 clicks, uno detrás de otro cada 12 ms
+    CHECK_EQ(pwm.log.size(), 2 * BUZZER_SEQ_QUEUE_DEPTH);
+    for (size_t i = 0; i < pwm.log.size(); i++) {
+        CHECK_EQ(pwm.log[i].freq_hz, i % 2 ? 0 : buzzer_note_hz(96));
+        CHECK_EQ(pwm.log[i].at_us, (i + 1) / 2 * 12 * 1000);
+    }
+}
+
+// Productor real en otro hilo (la tarea de UI) y consumidor con reloj simulado
+// (el ISR): ninguna melodía se pierde ni se repite
+static void test_threaded_producer() {
+    static const buzzer_step_t beep[] = { { 72, 1 }, { 0, 1 }, { 0, 0 } };
+    static buzzer_seq_t seq;
+    buzzer_seq_init(&seq);
+    const uint32_t total = 2000;
+    std::atomic<bool> done{false};
+
+    std::thread producer([&] {
+        for (uint32_t i = 0; i < total; i++) {
+            while (!buzzer_seq_post(&seq, beep, false)) std::this_thread::yield();
+        }
+        done.store(true);
+    });
+
+    MockPwm pwm;
+    uint64_t now = 0;
+    while (!done.load() || !buzzer_seq_is_idle(&seq)) {
+        pwm.now_us = now;
+        const uint64_t next = buzzer_seq_advance(&seq, now, mock_tone, &pwm);
+        now = next ? next : now + 100;
+    }
+    producer.join();
+
+    CHECK_EQ(seq.played, total);
+    CHECK_EQ(seq.preempted, 0);
+    CHECK_EQ(pwm.freq_hz, 0);
+    // Cada beep es exactamente un tono y un silencio
+    uint32_t tones = 0;
+    for (const ToneChange& c : pwm.log) tones += c.freq_hz != 0;
+    CHECK_EQ(tones, total);
+}
+
+int main() {
+    test_note_table();
+    test_melodies();
+    test_latency_does_not_accumulate();
+    test_queued_back_to_back();
+    test_interrupt_and_stop();
+    test_same_note_merged();
+    test_queue_full();
+    test_threaded_producer();
+    return host_test_result();
+}
@@ -0,0 +1,317 @@
+// db_store con la geometría de la placa (DB_SEGMENT_BYTES en sectores de
+// 4 KB), primero sobre un db_blockdev en RAM y después sobre uno en fichero:
+// * claves y muestras sobreviven a un remontaje;
+// * un segmento con la cabecera borrada y el cuerpo sucio (borrado
+//   interrumpido) se borra al montar antes de reutilizarlo;
+// * cortes de alimentación aleatorios en escrituras y en borrados: tras
+//   remontar siguen todos los lotes confirmados, ninguno a medias, y el
+//   almacén acepta más datos sin CRC erróneos al releerlos. Con el fichero,
+//   cada arranque lo vuelve a abrir desde cero.
+// Solo con el fichero:
+// * el mismo corte que en RAM deja en el fichero, reabierto, los mismos bytes
+//   (escrituras a medias y medio sector borrado incluidos);
+// * ninguna escritura ni borrado vuelve sin su fsync, así que lo que llega
+//   al disco respeta el orden de la flash (los datos del lote antes que su COMMIT).
+
+#include "host_test.h"
+#include "controllers/db_manager/db_store.h"
+#include "config.h"
+#include <cstdlib>
+#include <string>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#define SECTOR_BYTES    4096
+#define DEV_SEGMENTS    16
+#define DEV_BYTES       (DEV_SEGMENTS * DB_SEGMENT_BYTES)
+#define CUT_TRIALS      60
+#define FILE_MATCH_TRIALS 10
+#define SERIES_A        1
+#define SERIES_B        2
+
+static db_store_t db;       // Estático, como en db_manager: no cabe con holgura en la pila
+
+// fsync de libc sustituido para contar las llamadas del backend de fichero
+static uint32_t fsync_calls = 0;
+
+extern "C" int fsync(int fd) {
+    fsync_calls++;
+    return (int)syscall(SYS_fsync, fd);
+}
+
+// Operaciones reales del fichero y cuántas volvieron con éxito sin fsync
+static int (*file_write_op)(db_blockdev_t* dev, uint32_t offset, const void* src, uint32_t len);
+static int (*file_erase_op)(db_blockdev_t* dev, uint32_t offset, uint32_t len);
+static uint32_t file_ops = 0;
+static uint32_t unsynced_ops = 0;
+
+static int synced_write(db_blockdev_t* dev, uint32_t offset, const void* src, uint32_t len) {
+    const uint32_t before = fsync_calls;
+    const int r = file_write_op(dev, offset, src, len);
+    file_ops++;
+    if (r == 0 && fsync_calls == before) unsynced_ops++;
+    return r;
+}
+
+static int synced_erase(db_blockdev_t* dev, uint32_t offset, uint32_t len) {
+    const uint32_t before = fsync_calls;
+    const int r = file_erase_op(dev, offset, len);
+    file_ops++;
+    if (r == 0 && fsync_calls == before) unsynced_ops++;
+    return r;
+}
+
+static db_blockdev_t* file_open(const char* path) {
+    db_blockdev_t* dev = db_blockdev_file_open(path, DEV_BYTES, SECTOR_BYTES);
+    CHECK(dev != nullptr);
+    if (!dev) return nullptr;
+    file_write_op = dev->write;
+    file_erase_op = dev->erase;
+    dev->write = synced_write;
+    dev->erase = synced_erase;
+    return dev;
+}
+
+// Vuelve la alimentación. Un fichero se abre otra vez, como en el siguiente
+// arranque: solo cuenta lo que llegó a él, no lo que guardaba el FILE* anterior
+static db_blockdev_t* power_on(db_blockdev_t* dev, const char* path) {
+    db_blockdev_power_restore(dev);
+    if (!path) return dev;
+    db_blockdev_t* fresh = file_open(path);
+    if (!fresh) return dev;
+    db_blockdev_destroy(dev);
+    return fresh;
+}
+
+typedef struct {
+    uint32_t first;
+    uint32_t last;
+    uint32_t count;
+    bool values_ok;
+} range_t;
+
+static bool range_cb(uint16_t series, uint32_t ts, const void* value, uint16_t len, void* user) {
+    range_t* r = (range_t*)user;
+    uint32_t v;
+    memcpy(&v, value, sizeof(v));
+    if (len != sizeof(v) || v != ts * 3 + series) r->values_ok = false;
+    if (r->count == 0 || ts < r->first) r->first = ts;
+    if (r->count == 0 || ts > r->last) r->last = ts;
+    r->count++;
+    return true;
+}
+
+static range_t query_all(uint16_t series) {
+    range_t r = { 0, 0, 0, true };
+    db_store_query(&db, series, 0, UINT32_MAX, range_cb, &r);
+    return r;
+}
+
+// Muestras [from, to) de 'series', commit cada 37 y compactación como la tarea db.
+// Devuelve la siguiente sin escribir; *committed, la primera sin confirmar.
+static uint32_t write_samples(uint16_t series, uint32_t from, uint32_t to, uint32_t* committed) {
+    uint32_t i = from;
+    for (; i < to; i++) {
+        const uint32_t v = i * 3 + series;
+        if (db_store_append(&db, series, i, &v, sizeof(v)) != DB_OK) break;
+        if (i % 37 == 36) {
+            if (db_store_commit(&db) != DB_OK) break;
+            if (committed) *committed = i + 1;
+        }
+        if (db_store_free_segments(&db) < DB_COMPACT_FREE_SEGMENTS && db_store_compact(&db) != DB_OK) break;
+    }
+    return i;
+}
+
+static bool segment_erased(db_blockdev_t* dev, uint32_t seg) {
+    static uint8_t buf[DB_SEGMENT_BYTES];
+    db_blockdev_read(dev, seg * DB_SEGMENT_BYTES, buf, sizeof(buf));
+    for (uint32_t i = 0; i < sizeof(buf); i++) {
+        if (buf[i] != 0xFF) return false;
+    }
+    return true;
+}
+
+static void test_reopen(db_blockdev_t** devp, const char* path) {
+    db_blockdev_t* dev = *devp;
+    CHECK_EQ(db_store_open(&db, dev, DB_SEGMENT_BYTES, DB_BATCH_BYTES, 0), DB_OK);
+    CHECK_EQ(db_store_format(&db), DB_OK);
+    const uint8_t brightness = 80;
+    CHECK_EQ(db_store_put(&db, "brightness", &brightness, sizeof(brightness)), DB_OK);
+    uint32_t committed = 0;
+    CHECK_EQ(write_samples(SERIES_A, 0, 3000, &committed), 3000);
+    CHECK_EQ(db_store_commit(&db), DB_OK);
+    db_store_close(&db);
+
+    dev = *devp = power_on(dev, path);
+    CHECK_EQ(db_store_open(&db, dev, DB_SEGMENT_BYTES, DB_BATCH_BYTES, 0), DB_OK);
+    uint8_t value = 0;
+    CHECK_EQ(db_store_get(&db, "brightness", &value, sizeof(value)), 1);
+    CHECK_EQ(value, 80);
+    CHECK_EQ(db_store_get(&db, "missing", &value, sizeof(value)), DB_ERR_NOT_FOUND);
+    const range_t r = query_all(SERIES_A);
+    CHECK(r.values_ok);
+    CHECK_EQ(r.count, 3000);
+    CHECK_EQ(r.last, 2999);
+
+    db_store_stats_t st;
+    db_store_get_stats(&db, &st);
+    CHECK_EQ(st.torn_batches, 0);
+    CHECK_EQ(st.crc_errors, 0);
+    db_store_close(&db);
+}
+
+// El estado que dejaba un borrado cortado tras el primer sector: cabecera
+// borrada y registros viejos detrás. El montaje tiene que borrarlo entero.
+static void test_erased_header_dirty_body(db_blockdev_t* dev) {
+    CHECK_EQ(db_store_open(&db, dev, DB_SEGMENT_BYTES, DB_BATCH_BYTES, 0), DB_OK);
+    CHECK_EQ(db_store_format(&db), DB_OK);
+    uint32_t committed = 0;
+    write_samples(SERIES_A, 0, 2 * DB_SEGMENT_BYTES / 20, &committed);
+    CHECK_EQ(db_store_commit(&db), DB_OK);
+    CHECK(db.segs[0].seq != 0);
+    db_store_close(&db);
+
+    CHECK_EQ(db_blockdev_erase(dev, 0, SECTOR_BYTES), 0);
+    CHECK(!segment_erased(dev, 0));
+
+    CHECK_EQ(db_store_open(&db, dev, DB_SEGMENT_BYTES, DB_BATCH_BYTES, 0), DB_OK);
+    CHECK_EQ(db.segs[0].seq, 0);
+    CHECK(segment_erased(dev, 0));
+    db_store_close(&db);
+}
+
+static void cut_trial(db_blockdev_t** devp, const char* path, uint32_t trial, bool erase_cut) {
+    db_blockdev_t* dev = *devp = power_on(*devp, path);
+    CHECK_EQ(db_store_open(&db, dev, DB_SEGMENT_BYTES, DB_BATCH_BYTES, 0), DB_OK);
+    CHECK_EQ(db_store_format(&db), DB_OK);
+    // Los borrados solo llegan con la compactación: se escribe hasta cortar
+    if (erase_cut) {
+        db_blockdev_erase_cut_after(dev, 1 + rand() % (8 * DB_SEGMENT_BYTES / SECTOR_BYTES));
+    } else {
+        db_blockdev_power_cut_after(dev, 1 + rand() % (2 * DEV_BYTES));
+    }
+
+    uint32_t committed = 0;
+    const uint32_t written = write_samples(SERIES_A, 0, UINT32_MAX, &committed);
+    CHECK(dev->powered_off);
+    db_store_close(&db);
+
+    dev = *devp = power_on(dev, path);
+    CHECK_EQ(db_store_open(&db, dev, DB_SEGMENT_BYTES, DB_BATCH_BYTES, 0), DB_OK);
+    const range_t a = query_all(SERIES_A);
+    // Recicladas las más antiguas, lo recuperado es un rango continuo que
+    // llega al menos hasta el último lote confirmado
+    const bool ok = a.values_ok && (committed == 0 ? a.count == 0 || a.last <= written
+                                                   : a.count > 0 && a.last + 1 >= committed &&
+                                                     a.last <= written && a.count == a.last - a.first + 1);
+    if (!ok) {
+        fprintf(stderr, "%s trial %u (%s): committed %u written %u recovered %u [%u, %u]\n", dev->name, trial,
+                erase_cut ? "erase" : "write", committed, written, a.count, a.first, a.last);
+    }
+    CHECK(ok);
+    db_store_stats_t recovered;
+    db_store_get_stats(&db, &recovered);
+
+    // Media vuelta al dispositivo: se reutilizan los segmentos que dejó el corte
+    const uint32_t more = DEV_BYTES / 20 / 2;
+    CHECK_EQ(write_samples(SERIES_B, 0, more, nullptr), more);
+    CHECK_EQ(db_store_commit(&db), DB_OK);
+    db_store_close(&db);
+
+    CHECK_EQ(db_store_open(&db, dev, DB_SEGMENT_BYTES, DB_BATCH_BYTES, 0), DB_OK);
+    const range_t b = query_all(SERIES_B);
+    CHECK(b.values_ok);
+    CHECK_EQ(b.last, more - 1);
+    CHECK_EQ(b.count, b.last - b.first + 1);
+    // El lote roto por el corte puede seguir ahí; ninguno más
+    db_store_stats_t st;
+    db_store_get_stats(&db, &st);
+    CHECK(st.torn_batches <= recovered.torn_batches);
+    CHECK(st.crc_errors <= recovered.crc_errors);
+    db_store_close(&db);
+}
+
+// El mismo trabajo con el mismo corte sobre RAM y sobre el fichero; el
+// fichero, reabierto tras el corte, tiene que tener la imagen de RAM byte a byte
+static void test_file_matches_ram(db_blockdev_t* ram, db_blockdev_t** file, const char* path,
+                                  uint32_t trial, bool erase_cut) {
+    const uint32_t cut = erase_cut ? 1 + rand() % (8 * DB_SEGMENT_BYTES / SECTOR_BYTES)
+                                   : 1 + rand() % (2 * DEV_BYTES);
+    db_blockdev_t* devs[2] = { ram, *file };
+    uint32_t written[2];
+    for (int i = 0; i < 2; i++) {
+        db_blockdev_power_restore(devs[i]);
+        CHECK_EQ(db_blockdev_erase(devs[i], 0, DEV_BYTES), 0);
+        CHECK_EQ(db_store_open(&db, devs[i], DB_SEGMENT_BYTES, DB_BATCH_BYTES, 0), DB_OK);
+        CHECK_EQ(db_store_format(&db), DB_OK);
+        if (erase_cut) {
+            db_blockdev_erase_cut_after(devs[i], cut);
+        } else {
+            db_blockdev_power_cut_after(devs[i], cut);
+        }
+        uint32_t committed = 0;
+        written[i] = write_samples(SERIES_A, 0, UINT32_MAX, &committed);
+        CHECK(devs[i]->powered_off);
+        db_store_close(&db);
+    }
+    CHECK_EQ(written[0], written[1]);
+
+    *file = power_on(*file, path);
+    db_blockdev_power_restore(ram);
+    static uint8_t a[DB_SEGMENT_BYTES], b[DB_SEGMENT_BYTES];
+    uint32_t diff_at = UINT32_MAX;
+    for (uint32_t off = 0; off < DEV_BYTES && diff_at == UINT32_MAX; off += sizeof(a)) {
+        CHECK_EQ(db_blockdev_read(ram, off, a, sizeof(a)), 0);
+        CHECK_EQ(db_blockdev_read(*file, off, b, sizeof(b)), 0);
+        for (uint32_t i = 0; i < sizeof(a); i++) {
+            if (a[i] != b[i]) {
+                diff_at = off + i;
+                break;
+            }
+        }
+    }
+    if (diff_at != UINT32_MAX) {
+        fprintf(stderr, "trial %u (%s, corte %u): el fichero difiere de RAM en el byte %u\n", trial,
+                erase_cut ? "erase" : "write", cut, diff_at);
+    }
+    CHECK_EQ(diff_at, UINT32_MAX);
+}
+
+static void run_suite(db_blockdev_t** dev, const char* path) {
+    test_reopen(dev, path);
+    test_erased_header_dirty_body(*dev);
+
+    srand(1234);
+    for (uint32_t trial = 0; trial < CUT_TRIALS; trial++) {
+        cut_trial(dev, path, trial, trial % 2 == 1);
+    }
+}
+
+int main() {
+    db_blockdev_t* ram = db_blockdev_ram_create(DEV_BYTES, SECTOR_BYTES);
+    CHECK(ram != nullptr);
+    if (!ram) return host_test_result();
+    run_suite(&ram, nullptr);
+
+    char tmpl[] = "/tmp/db_store_XXXXXX";
+    const char* dir = mkdtemp(tmpl);
+    CHECK(dir != nullptr);
+    if (!dir) return host_test_result();
+    const std::string path = std::string(dir) + "/db.bin";
+    db_blockdev_t* file = file_open(path.c_str());
+    if (file) {
+        run_suite(&file, path.c_str());
+        for (uint32_t trial = 0; trial < FILE_MATCH_TRIALS; trial++) {
+            test_file_matches_ram(ram, &file, path.c_str(), trial, trial % 2 == 1);
+        }
+        CHECK(file_ops > 0);
+        CHECK_EQ(unsynced_ops, 0);
+        db_blockdev_destroy(file);
+    }
+    remove(path.c_str());
+    rmdir(dir);
+
+    db_blockdev_destroy(ram);
+    return host_test_result();
+}
@@ -0,0 +1,131 @@
+// Kernels RGB565 de draw_accel frente a LVGL: los spans contra
+// lv_color_16_16_mix en todas las alineaciones y longitudes cortas, el swap
+// contra lv_draw_sw_rgb565_swap, y la unidad de dibujo entera contra lv_draw_sw
+// con draw_accel_benchmark (rectángulos con y sin radio, opacos y con mezcla).
+// En el PC se prueba la versión escalar; la placa corre el mismo
+// draw_accel_benchmark con el PIE.
+
+#include "host_test.h"
+#include "controllers/draw_accel/draw_accel.h"
+#include "controllers/screen_manager/screen_manager.h"
+#include "esp_log.h"
+#include <cstring>
+
+#define SPAN_MAX 48
+#define SPAN_GUARD 0xDEAD
+
+static uint32_t rng = 0x2545F491;
+
+static uint16_t next_pixel() {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return (uint16_t)rng;
+}
+
+// Fondo con tramos repetidos: el kernel reutiliza el resultado cuando no cambia
+static void fill_background(uint16_t* buf, uint32_t len) {
+    for (uint32_t i = 0; i < len; i++) {
+        buf[i] = (i > 0 && (next_pixel() & 3) == 0) ? buf[i - 1] : next_pixel();
+    }
+}
+
+static void test_blend_spans() {
+    static const lv_opa_t opas[] = { 0, 1, 2, 3, 4, 11, 12, 50, 127, 128, 200, 251, 252, 253, 254, 255 };
+    alignas(16) uint16_t buf[SPAN_MAX + 16];
+    uint16_t expect[SPAN_MAX + 16];
+
+    for (lv_opa_t opa : opas) {
+        for (uint32_t offset = 0; offset < 8; offset++) {
+            for (uint32_t len = 0; len <= SPAN_MAX; len++) {
+                const uint16_t color = next_pixel();
+                fill_background(buf, SPAN_MAX + 16);
+                buf[offset + len] = SPAN_GUARD;
+                memcpy(expect, buf, sizeof(buf));
+                for (uint32_t i = 0; i < len; i++) {
+                    uint16_t& px = expect[offset + i];
+                    if (opa >= LV_OPA_MAX) px = color;
+                    else if (opa > LV_OPA_MIN) px = lv_color_16_16_mix(color, px, opa);
+                }
+
+                draw_accel_blend_rgb565(buf + offset, len, color, opa);
+                CHECK(memcmp(buf, expect, sizeof(buf)) == 0);
+            }
+        }
+    }
+}
+
+static void test_fill_spans() {
+    alignas(16) uint16_t buf[SPAN_MAX + 16];
+    for (uint32_t offset = 0; offset < 8; offset++) {
+        for (uint32_t len = 0; len <= SPAN_MAX; len++) {
+            memset(buf, 0, sizeof(buf));
+            draw_accel_fill_rgb565(buf + offset, len, 0xA5F3);
+            for (uint32_t i = 0; i < SPAN_MAX + 16; i++) {
+                const bool inside = i >= offset && i < offset + len;
+                CHECK_EQ(buf[i], inside ? 0xA5F3 : 0);
+            }
+        }
+    }
+}
+
+static void test_blend_mask() {
+    uint16_t buf[SPAN_MAX];
+    uint16_t expect[SPAN_MAX];
+    lv_opa_t mask[SPAN_MAX];
+    static const lv_opa_t opas[] = { LV_OPA_COVER, LV_OPA_70, LV_OPA_30 };
+
+    for (lv_opa_t opa : opas) {
+        const uint16_t color = next_pixel();
+        fill_background(buf, SPAN_MAX);
+        for (int i = 0; i < SPAN_MAX; i++) {
+            mask[i] = (lv_opa_t)(i * 255 / (SPAN_MAX - 1));
+        }
+        memcpy(expect, buf, sizeof(buf));
+        for (int i = 0; i < SPAN_MAX; i++) {
+            const lv_opa_t m = opa >= LV_OPA_MAX ? mask[i] : (lv_opa_t)LV_OPA_MIX2(mask[i], opa);
+            if (m) expect[i] = lv_color_16_16_mix(color, expect[i], m);
+        }
+        draw_accel_blend_mask_rgb565(buf, SPAN_MAX, color, mask, opa);
+        CHECK(memcmp(buf, expect, sizeof(buf)) == 0);
+    }
+}
+
+static void test_swap() {
+    alignas(16) uint16_t src[SPAN_MAX + 16];
+    alignas(16) uint16_t dst[SPAN_MAX + 16];
+    alignas(16) uint16_t ref[SPAN_MAX + 16];
+
+    for (uint32_t src_off = 0; src_off < 8; src_off++) {
+        for (uint32_t dst_off = 0; dst_off < 8; dst_off++) {
+            for (uint32_t len = 0; len <= SPAN_MAX; len++) {
+                fill_background(src, SPAN_MAX + 16);
+                memcpy(ref, src, sizeof(src));
+                lv_draw_sw_rgb565_swap(ref + src_off, len);
+
+                memset(dst, 0, sizeof(dst));
+                draw_accel_swap_copy_rgb565(dst + dst_off, src + src_off, len);
+                CHECK(memcmp(dst + dst_off, ref + src_off, len * sizeof(uint16_t)) == 0);
+                CHECK(dst_off == 0 || dst[dst_off - 1] == 0);
+                CHECK(dst[dst_off + len] == 0);
+
+                draw_accel_swap_rgb565(src + src_off, len);
+                CHECK(memcmp(src, ref, sizeof(src)) == 0);
+            }
+        }
+    }
+}
+
+int main() {
+    esp_log_level_set("*", ESP_LOG_WARN);
+    // LVGL inicializado y la unidad registrada (screen_init_lvgl, DRAW_ACCEL_ENABLED)
+    screen_init();
+
+    test_fill_spans();
+    test_blend_spans();
+    test_blend_mask();
+    test_swap();
+    CHECK(draw_accel_benchmark(SCREEN_WIDTH * SCREEN_STRIP_LINES));
+
+    return host_test_result();
+}
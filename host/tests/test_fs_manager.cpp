@@ -0,0 +1,159 @@
+// fs_manager real sobre el pack de asset_fixture.py registrado como la
+// partición "assets" (partition_host.cpp la mapea desde el fichero). Sin
+// partición init falla; con ella, los descriptores de imagen y la fuente que
+// construye fs_manager apuntan al pack y LVGL resuelve cada glifo de
+// expect.txt con lv_font_get_glyph_dsc. Termina con fs_manager_benchmark.
+//
+//   test_fs_manager <pack.bin> <directorio de entrada con el que se generó>
+
+#include "host_test.h"
+#include "controllers/fs_manager/fs_manager.h"
+#include "config.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+#include <fstream>
+#include <sstream>
+#include <string>
+
+static uint32_t images_checked = 0;
+
+static void test_image(std::istringstream& line) {
+    std::string name;
+    unsigned cf, w, h, stride;
+    line >> name >> cf >> w >> h >> stride;
+
+    const lv_image_dsc_t* img = fs_manager_get_image(name.c_str());
+    CHECK(img != nullptr);
+    if (!img) return;
+    CHECK_EQ(img->header.magic, LV_IMAGE_HEADER_MAGIC);
+    CHECK_EQ(img->header.cf, cf);
+    CHECK_EQ(img->header.w, w);
+    CHECK_EQ(img->header.h, h);
+    CHECK_EQ(img->header.stride, stride);
+
+    // Los píxeles no se copian: el descriptor apunta a los bytes del pack
+    size_t size = 0;
+    const void* raw = fs_manager_get_raw(name.c_str(), &size);
+    CHECK(img->data == raw);
+    CHECK_EQ(img->data_size, size);
+
+    // Segundo acceso: el mismo descriptor, y el tipo tiene que coincidir
+    CHECK(fs_manager_get_image(name.c_str()) == img);
+    CHECK(fs_manager_get_font(name.c_str()) == nullptr);
+    images_checked++;
+}
+
+static std::string test_font(std::istringstream& line) {
+    std::string name;
+    int line_height, base_line, bpp, cmaps, glyphs, ul_pos, ul_thick;
+    line >> name >> line_height >> base_line >> bpp >> cmaps >> glyphs >> ul_pos >> ul_thick;
+
+    const lv_font_t* font = fs_manager_get_font(name.c_str());
+    CHECK(font != nullptr);
+    if (!font) return name;
+    CHECK_EQ(font->line_height, line_height);
+    CHECK_EQ(font->base_line, base_line);
+    CHECK_EQ(font->underline_position, ul_pos);
+    CHECK_EQ(font->underline_thickness, ul_thick);
+    const lv_font_fmt_txt_dsc_t* dsc = (const lv_font_fmt_txt_dsc_t*)font->dsc;
+    CHECK_EQ(dsc->bpp, bpp);
+    CHECK_EQ(dsc->cmap_num, cmaps);
+    CHECK(fs_manager_get_font(name.c_str()) == font);
+    CHECK(fs_manager_get_image(name.c_str()) == nullptr);
+    return name;
+}
+
+static void test_glyph(std::istringstream& line) {
+    std::string name, hex;
+    uint32_t cp;
+    int adv, box_w, box_h, ofs_x, ofs_y;
+    line >> name >> cp >> adv >> box_w >> box_h >> ofs_x >> ofs_y >> hex;
+
+    const lv_font_t* font = fs_manager_get_font(name.c_str());
+    if (!font) return;
+    lv_font_glyph_dsc_t g = {};
+    const bool found = lv_font_get_glyph_dsc(font, &g, cp, 0);
+    CHECK(found);
+    if (!found) {
+        fprintf(stderr, "  U+%04X sin glifo\n", (unsigned)cp);
+        return;
+    }
+    CHECK_EQ(g.adv_w, adv);
+    CHECK_EQ(g.box_w, box_w);
+    CHECK_EQ(g.box_h, box_h);
+    CHECK_EQ(g.ofs_x, ofs_x);
+    CHECK_EQ(g.ofs_y, ofs_y);
+
+    // El bitmap que LVGL leerá para este glifo, directamente del pack
+    const lv_font_fmt_txt_dsc_t* dsc = (const lv_font_fmt_txt_dsc_t*)font->dsc;
+    const uint8_t* bitmap = dsc->glyph_bitmap + dsc->glyph_dsc[g.gid.index].bitmap_index;
+    const size_t bytes = (box_w * box_h * dsc->bpp + 7) / 8;
+    bool same = hex.size() == bytes * 2;
+    for (size_t i = 0; same && i < bytes; i++) {
+        same = strtoul(hex.substr(i * 2, 2).c_str(), nullptr, 16) == bitmap[i];
+    }
+    CHECK(same);
+}
+
+static void test_pack(const std::string& input_dir) {
+    std::ifstream expect(input_dir + "/expect.txt");
+    CHECK(expect.good());
+    std::string text, font_name;
+    uint32_t fonts = 0;
+    while (std::getline(expect, text)) {
+        std::istringstream line(text);
+        std::string kind;
+        line >> kind;
+        if (kind == "image") {
+            test_image(line);
+        } else if (kind == "font") {
+            font_name = test_font(line);
+            fonts++;
+        } else if (kind == "glyph") {
+            test_glyph(line);
+        }
+    }
+    CHECK(images_checked > 0 && fonts > 0);
+
+    // Código dentro del rango de la cmap sparse pero fuera de su lista
+    const lv_font_t* font = fs_manager_get_font(font_name.c_str());
+    lv_font_glyph_dsc_t g = {};
+    CHECK(font != nullptr);
+    if (font) CHECK(!lv_font_get_glyph_dsc(font, &g, 0x42, 0));
+
+    static const lv_font_t fallback = {};
+    CHECK(fs_manager_font_or("__missing__", &fallback) == &fallback);
+    CHECK(fs_manager_font_or(font_name.c_str(), &fallback) == font);
+
+    fs_manager_stats_t st;
+    fs_manager_get_stats(&st);
+    CHECK(st.mounted);
+    CHECK_EQ(st.images_built, images_checked);
+    CHECK_EQ(st.fonts_built, fonts);
+    CHECK(st.misses > 0 && st.misses < st.lookups);
+    CHECK(st.ram_bytes < st.pack_bytes);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        fprintf(stderr, "uso: %s <pack.bin> <dir de entrada>\n", argv[0]);
+        return 2;
+    }
+    esp_log_level_set("*", ESP_LOG_WARN);
+    lv_init();
+
+    // Sin partición no hay pack y las búsquedas fallan
+    CHECK_EQ(fs_manager_init(), ESP_ERR_NOT_FOUND);
+    CHECK(!fs_manager_is_mounted());
+    CHECK(fs_manager_get_image("ramp") == nullptr);
+
+    CHECK_EQ(host_partition_add_file(FS_ASSET_PARTITION_LABEL, FS_ASSET_PARTITION_SUBTYPE, argv[1]), ESP_OK);
+    CHECK_EQ(fs_manager_init(), ESP_OK);
+    CHECK_EQ(fs_manager_init(), ESP_OK);
+    CHECK(fs_manager_is_mounted());
+    if (!fs_manager_is_mounted()) return host_test_result();
+
+    test_pack(argv[2]);
+    fs_manager_benchmark(FS_ASSET_BENCH_ITERATIONS);
+    return host_test_result();
+}
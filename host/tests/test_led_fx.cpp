@@ -0,0 +1,254 @@
+// Efectos de led_fx frente a versiones de referencia escritas a lo directo
+// (divisiones exactas, sin Q16), en tiras de 1 a 1024 píxeles: escala, tonos,
+// gamma, degradado, respiración y el mapeo de celdas de Seconds. Además, que
+// los efectos estáticos no dependan del tiempo y que ninguno escriba fuera de
+// los 'count' píxeles.
+
+#include "host_test.h"
+#include "controllers/leds/led_fx.h"
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+
+#define MAX_PIXELS 1024
+#define GUARD 0xA5
+
+static const uint32_t counts[] = { 1, 2, 7, 8, 59, 60, 61, 100, 256, 1000, MAX_PIXELS };
+
+static uint8_t gamma_lut[256];
+static int gamma_max_step = 0;
+
+static led_fx_params_t make_params(led_fx_effect_t effect) {
+    led_fx_params_t p = {};
+    p.effect = effect;
+    p.color = { 255, 96, 0 };
+    p.brightness = 200;
+    p.period_ms = 4000;
+    p.second = 45;
+    for (int i = 0; i < LED_FX_CELLS; i++) {
+        p.seconds[i] = led_fx_hue((uint16_t)(i * LED_FX_HUE_MAX / LED_FX_CELLS));
+    }
+    return p;
+}
+
+// Frame con bytes de guarda detrás de los 'count' píxeles
+static void render(const led_fx_params_t* p, uint32_t t_ms, uint8_t* grb, uint32_t count) {
+    memset(grb, GUARD, (MAX_PIXELS + 1) * 3);
+    led_fx_render(p, t_ms, grb, count);
+    for (uint32_t i = count * 3; i < (count + 1) * 3; i++) CHECK_EQ(grb[i], GUARD);
+}
+
+static void ref_pixel(uint8_t* px, led_rgb_t c, uint8_t brightness) {
+    px[0] = gamma_lut[c.g * (brightness + 1) >> 8];
+    px[1] = gamma_lut[c.r * (brightness + 1) >> 8];
+    px[2] = gamma_lut[c.b * (brightness + 1) >> 8];
+}
+
+static void test_scale8() {
+    for (int v = 0; v < 256; v++) {
+        CHECK_EQ(led_fx_scale8((uint8_t)v, 255), v);
+        CHECK_EQ(led_fx_scale8((uint8_t)v, 0), 0);
+        for (int s = 0; s < 256; s++) {
+            const int got = led_fx_scale8((uint8_t)v, (uint8_t)s);
+            CHECK(fabs(got - v * s / 255.0) < 1.0);
+            if (s > 0) CHECK(got >= led_fx_scale8((uint8_t)v, (uint8_t)(s - 1)));
+        }
+    }
+}
+
+// Rueda continua: dos tonos seguidos (también 1535 → 0) difieren como mucho
+// en 1 por canal, y siempre hay un canal a 255 y otro a 0
+static void test_hue() {
+    led_rgb_t prev = led_fx_hue(LED_FX_HUE_MAX - 1);
+    for (int h = 0; h < LED_FX_HUE_MAX; h++) {
+        const led_rgb_t c = led_fx_hue((uint16_t)h);
+        CHECK(abs(c.r - prev.r) <= 1 && abs(c.g - prev.g) <= 1 && abs(c.b - prev.b) <= 1);
+        const int hi = c.r > c.g ? (c.r > c.b ? c.r : c.b) : (c.g > c.b ? c.g : c.b);
+        const int lo = c.r < c.g ? (c.r < c.b ? c.r : c.b) : (c.g < c.b ? c.g : c.b);
+        CHECK_EQ(hi, 255);
+        CHECK_EQ(lo, 0);
+        prev = c;
+    }
+    const led_rgb_t red = led_fx_hue(0), green = led_fx_hue(512), blue = led_fx_hue(1024);
+    CHECK(red.r == 255 && red.g == 0 && red.b == 0);
+    CHECK(green.r == 0 && green.g == 255 && green.b == 0);
+    CHECK(blue.r == 0 && blue.g == 0 && blue.b == 255);
+}
+
+// La tabla gamma no está en la API: se lee con Solid gris a brillo máximo
+static void read_gamma() {
+    static uint8_t grb[(MAX_PIXELS + 1) * 3];
+    led_fx_params_t p = make_params(LED_FX_SOLID);
+    p.brightness = 255;
+    for (int v = 0; v < 256; v++) {
+        p.color = { (uint8_t)v, (uint8_t)v, (uint8_t)v };
+        render(&p, 0, grb, 1);
+        CHECK(grb[0] == grb[1] && grb[1] == grb[2]);
+        gamma_lut[v] = grb[0];
+    }
+}
+
+static void test_gamma() {
+    CHECK_EQ(gamma_lut[0], 0);
+    CHECK_EQ(gamma_lut[255], 255);
+    for (int v = 0; v < 256; v++) {
+        const double exact = 255.0 * pow(v / 255.0, 2.2);
+        CHECK(fabs(gamma_lut[v] - exact) <= 1.0);
+        if (v > 0) {
+            CHECK(gamma_lut[v] >= gamma_lut[v - 1]);
+            if (gamma_lut[v] - gamma_lut[v - 1] > gamma_max_step) gamma_max_step = gamma_lut[v] - gamma_lut[v - 1];
+        }
+    }
+}
+
+static void test_static_effects() {
+    static uint8_t grb[(MAX_PIXELS + 1) * 3];
+    static uint8_t later[(MAX_PIXELS + 1) * 3];
+    uint8_t px[3];
+
+    for (uint32_t n : counts) {
+        led_fx_params_t p = make_params(LED_FX_OFF);
+        render(&p, 0, grb, n);
+        for (uint32_t i = 0; i < n * 3; i++) CHECK_EQ(grb[i], 0);
+
+        // Solid con un color de canales distintos (bucle) y gris (memset)
+        p.effect = LED_FX_SOLID;
+        for (led_rgb_t c : { led_rgb_t{ 255, 96, 0 }, led_rgb_t{ 77, 77, 77 } }) {
+            p.color = c;
+            render(&p, 0, grb, n);
+            ref_pixel(px, c, p.brightness);
+            for (uint32_t i = 0; i < n; i++) CHECK(memcmp(grb + i * 3, px, 3) == 0);
+        }
+
+        // Ninguno cambia con el tiempo
+        for (led_fx_effect_t effect : { LED_FX_OFF, LED_FX_SOLID, LED_FX_SECONDS }) {
+            p = make_params(effect);
+            CHECK(!led_fx_is_animated(effect));
+            render(&p, 0, grb, n);
+            memcpy(later, grb, sizeof(later));
+            render(&p, 123457, grb, n);
+            CHECK(memcmp(grb, later, n * 3) == 0);
+        }
+    }
+}
+
+// Celda del píxel i = ⌊i·60/count⌋; la 0 nunca se enciende
+static void test_seconds() {
+    static uint8_t grb[(MAX_PIXELS + 1) * 3];
+    uint8_t px[3];
+    const led_rgb_t off = { 0, 0, 0 };
+
+    for (uint32_t n : counts) {
+        for (uint8_t second : { 0, 1, 30, 45, 59 }) {
+            led_fx_params_t p = make_params(LED_FX_SECONDS);
+            p.second = second;
+            render(&p, 0, grb, n);
+            for (uint32_t i = 0; i < n; i++) {
+                const uint32_t cell = i * LED_FX_CELLS / n;
+                const bool lit = cell > 0 && cell <= second;
+                ref_pixel(px, lit ? p.seconds[cell] : off, p.brightness);
+                CHECK(memcmp(grb + i * 3, px, 3) == 0);
+            }
+        }
+    }
+
+    // Con un LED por celda, cada LED enseña su segundo
+    led_fx_params_t p = make_params(LED_FX_SECONDS);
+    p.second = 59;
+    render(&p, 0, grb, LED_FX_CELLS);
+    for (uint32_t i = 1; i < LED_FX_CELLS; i++) {
+        ref_pixel(px, p.seconds[i], p.brightness);
+        CHECK(memcmp(grb + i * 3, px, 3) == 0);
+    }
+}
+
+// Tono exacto del píxel i: (t % period)·1536/period + i·1536/count. El Q16
+// puede quedarse un tono por debajo, que tras la gamma es como mucho un escalón.
+static void test_gradient() {
+    static uint8_t grb[(MAX_PIXELS + 1) * 3];
+    uint8_t px[3];
+    static const uint32_t times[] = { 0, 1, 999, 2000, 3999, 4000, 100003 };
+
+    for (uint32_t n : counts) {
+        for (uint32_t t : times) {
+            led_fx_params_t p = make_params(LED_FX_GRADIENT);
+            render(&p, t, grb, n);
+            const uint64_t base = (uint64_t)(t % p.period_ms) * LED_FX_HUE_MAX / p.period_ms;
+            for (uint32_t i = 0; i < n; i++) {
+                const uint32_t hue = (uint32_t)((base + (uint64_t)i * LED_FX_HUE_MAX / n) % LED_FX_HUE_MAX);
+                ref_pixel(px, led_fx_hue((uint16_t)hue), p.brightness);
+                for (int c = 0; c < 3; c++) CHECK(abs(grb[i * 3 + c] - px[c]) <= gamma_max_step);
+            }
+        }
+    }
+
+    // period_ms = 0 no divide por cero; una vuelta entera vuelve al principio
+    static uint8_t first[(MAX_PIXELS + 1) * 3];
+    led_fx_params_t p = make_params(LED_FX_GRADIENT);
+    p.period_ms = 0;
+    render(&p, 1234, grb, 60);
+    p.period_ms = 1000;
+    render(&p, 250, first, 60);
+    render(&p, 1250, grb, 60);
+    CHECK(memcmp(first, grb, 60 * 3) == 0);
+    render(&p, 500, grb, 60);
+    CHECK(memcmp(first, grb, 60 * 3) != 0);
+}
+
+// Triángulo 0..255..0 sobre el brillo: apagado al principio, igual que Solid
+// a mitad de periodo, y el mismo valor en todos los píxeles
+static void test_breathe() {
+    static uint8_t grb[(MAX_PIXELS + 1) * 3];
+    uint8_t px[3];
+
+    for (uint32_t n : counts) {
+        led_fx_params_t p = make_params(LED_FX_BREATHE);
+        for (uint32_t t = 0; t < 2 * p.period_ms; t += 97) {
+            render(&p, t, grb, n);
+            const uint32_t phase = (t % p.period_ms) * 512 / p.period_ms;
+            const uint32_t level = phase < 256 ? phase : 511 - phase;
+            ref_pixel(px, p.color, (uint8_t)(level * (p.brightness + 1) >> 8));
+            for (uint32_t i = 0; i < n; i++) CHECK(memcmp(grb + i * 3, px, 3) == 0);
+        }
+
+        render(&p, 0, grb, n);
+        for (uint32_t i = 0; i < n * 3; i++) CHECK_EQ(grb[i], 0);
+    }
+
+    static uint8_t solid[(MAX_PIXELS + 1) * 3];
+    led_fx_params_t p = make_params(LED_FX_BREATHE);
+    p.brightness = 255;
+    render(&p, p.period_ms / 2, grb, 60);
+    p.effect = LED_FX_SOLID;
+    render(&p, 0, solid, 60);
+    CHECK(memcmp(grb, solid, 60 * 3) == 0);
+}
+
+static void test_misc() {
+    CHECK(strcmp(led_fx_name(LED_FX_OFF), "Off") == 0);
+    CHECK(strcmp(led_fx_name(LED_FX_SECONDS), "Seconds") == 0);
+    CHECK(strcmp(led_fx_name(LED_FX_COUNT), "?") == 0);
+    CHECK(led_fx_is_animated(LED_FX_GRADIENT));
+    CHECK(led_fx_is_animated(LED_FX_BREATHE));
+
+    // count = 0 no escribe nada
+    static uint8_t grb[(MAX_PIXELS + 1) * 3];
+    for (int e = 0; e < LED_FX_COUNT; e++) {
+        led_fx_params_t p = make_params((led_fx_effect_t)e);
+        render(&p, 500, grb, 0);
+    }
+}
+
+int main() {
+    test_scale8();
+    test_hue();
+    read_gamma();
+    test_gamma();
+    test_static_effects();
+    test_seconds();
+    test_gradient();
+    test_breathe();
+    test_misc();
+    return host_test_result();
+}
@@ -0,0 +1,238 @@
+// mem_manager real sobre el multi_heap del shim. Primero las piezas: los
+// bloques pequeños de una arena salen de sus chunks y vuelven todos al
+// soltarla, los grandes van a los tiers, y sin slots libres se usa el heap
+// normal. Después el stress de ui_benchmark_stress_switch sin caché de vistas
+// ni snapshots: N cambios de vista (argumento, MEM_STRESS_CYCLES por defecto)
+// con líneas MEMSTRESS. Cada arena creada se suelta, el pico no crece tras el
+// calentamiento y el bloque libre mayor de cada tier no encoge entre las
+// primeras y las últimas rondas.
+
+#include "host_test.h"
+#include "controllers/mem_manager/mem_manager.h"
+#include "controllers/screen_manager/screen_manager.h"
+#include "controllers/screen_manager/nav_snapshot.h"
+#include "config.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <cstdio>
+#include <cstdlib>
+
+#define MEM_STRESS_CYCLES   1200
+#define MEM_STRESS_REPORT   200
+#define MEM_WARMUP_ROUNDS   3       // Rondas antes de tomar la referencia
+#define MEM_WINDOW_ROUNDS   5       // Rondas de la ventana inicial y de la final
+#define MEM_PEAK_SLACK      256     // Textos que cambian de longitud con el reloj
+
+static const view_id_t cycle_views[] = { VIEW_CLOCK, VIEW_SETTINGS, VIEW_SYSTEM_INFO, VIEW_SPECTRUM };
+static const uint32_t num_views = sizeof(cycle_views) / sizeof(cycle_views[0]);
+
+static void run_frames(uint32_t frames) {
+    for (uint32_t i = 0; i < frames; i++) {
+        vTaskDelay(pdMS_TO_TICKS(LV_DEF_REFR_PERIOD));
+        lv_timer_handler();
+    }
+}
+
+static void test_arena() {
+    mem_manager_stats_t before, st;
+    mem_manager_get_stats(&before);
+
+    mem_arena_t* arena = mem_arena_create("test");
+    CHECK(arena != nullptr);
+    mem_arena_t* previous = mem_arena_enter(arena);
+    CHECK(mem_arena_current() == arena);
+
+    // Pequeños: de la arena, en un solo chunk del tier interno
+    void* small[16];
+    for (void*& p : small) p = lv_malloc(64);
+    const size_t arena_bytes = mem_arena_get_bytes(arena);
+    CHECK(arena_bytes >= 16 * 64);
+    mem_manager_get_stats(&st);
+    CHECK_EQ(st.arenas_live, before.arenas_live + 1);
+    CHECK_EQ(st.internal.allocated_blocks, before.internal.allocated_blocks + 1);
+
+    // Grande: no va a la arena
+    void* big = lv_malloc(LVGL_MEM_ARENA_MAX_ALLOC + 1);
+    CHECK(big != nullptr);
+    CHECK_EQ(mem_arena_get_bytes(arena), arena_bytes);
+
+    // Liberar dentro de la arena no devuelve nada hasta soltarla
+    lv_free(small[0]);
+    mem_manager_get_stats(&st);
+    CHECK(st.arena_wasted_bytes > before.arena_wasted_bytes);
+    CHECK_EQ(st.arena_bytes, before.arena_bytes + arena_bytes);
+
+    mem_arena_exit(previous);
+    CHECK(mem_arena_current() == previous);
+    lv_free(big);
+    mem_arena_release(arena);
+
+    mem_manager_get_stats(&st);
+    CHECK_EQ(st.arenas_live, before.arenas_live);
+    CHECK_EQ(st.arena_bytes, before.arena_bytes);
+    CHECK_EQ(st.arena_releases, before.arena_releases + 1);
+    CHECK_EQ(st.internal.free_bytes, before.internal.free_bytes);
+    CHECK_EQ(st.psram.free_bytes, before.psram.free_bytes);
+    CHECK(lv_mem_test() == LV_RESULT_OK);
+}
+
+static void test_arena_slots() {
+    mem_manager_stats_t before;
+    mem_manager_get_stats(&before);
+
+    mem_arena_t* taken[LVGL_MEM_ARENA_MAX] = {};
+    uint32_t n = 0;
+    while (n < LVGL_MEM_ARENA_MAX && (taken[n] = mem_arena_create("slot"))) n++;
+    CHECK_EQ(n, LVGL_MEM_ARENA_MAX - before.arenas_live);
+    CHECK(mem_arena_create("extra") == nullptr);
+
+    // Sin arena activa, lv_malloc sigue funcionando desde los tiers
+    mem_arena_t* previous = mem_arena_enter(nullptr);
+    void* p = lv_malloc(32);
+    CHECK(p != nullptr);
+    lv_free(p);
+    mem_arena_exit(previous);
+
+    for (uint32_t i = 0; i < n; i++) mem_arena_release(taken[i]);
+    mem_manager_stats_t st;
+    mem_manager_get_stats(&st);
+    CHECK_EQ(st.arenas_live, before.arenas_live);
+}
+
+static void test_tiers() {
+    mem_manager_stats_t before, st;
+    mem_manager_get_stats(&before);
+
+    void* small = lv_malloc(LVGL_MEM_SMALL_MAX);
+    void* big = lv_malloc(LVGL_MEM_SMALL_MAX + 1);
+    mem_manager_get_stats(&st);
+    CHECK_EQ(st.internal.allocated_blocks, before.internal.allocated_blocks + 1);
+    CHECK_EQ(st.psram.allocated_blocks, before.psram.allocated_blocks + 1);
+
+    // realloc conserva el contenido al crecer
+    memset(small, 0x5a, LVGL_MEM_SMALL_MAX);
+    uint8_t* grown = (uint8_t*)lv_realloc(small, 4 * LVGL_MEM_SMALL_MAX);
+    CHECK(grown != nullptr);
+    bool same = true;
+    for (uint32_t i = 0; i < LVGL_MEM_SMALL_MAX; i++) same &= grown[i] == 0x5a;
+    CHECK(same);
+
+    lv_free(grown);
+    lv_free(big);
+    mem_manager_get_stats(&st);
+    CHECK_EQ(st.internal.free_bytes, before.internal.free_bytes);
+    CHECK_EQ(st.psram.free_bytes, before.psram.free_bytes);
+    CHECK(lv_mem_test() == LV_RESULT_OK);
+}
+
+typedef struct {
+    size_t int_largest;
+    size_t psram_largest;
+    size_t tier_peak;
+    size_t arena_peak;
+} mem_round_t;
+
+static void round_sample(mem_round_t* out) {
+    mem_manager_stats_t st;
+    mem_manager_get_stats(&st);
+    out->int_largest = st.internal.largest_free_block;
+    out->psram_largest = st.psram.largest_free_block;
+    out->tier_peak = st.internal.peak_used_bytes + st.psram.peak_used_bytes;
+    out->arena_peak = st.arena_peak_bytes;
+}
+
+// Lo peor de un tramo de rondas: el bloque libre mayor más pequeño y el último pico
+static void window_merge(mem_round_t* acc, const mem_round_t& r, bool first) {
+    if (first || r.int_largest < acc->int_largest) acc->int_largest = r.int_largest;
+    if (first || r.psram_largest < acc->psram_largest) acc->psram_largest = r.psram_largest;
+    acc->tier_peak = r.tier_peak;
+    acc->arena_peak = r.arena_peak;
+}
+
+static void test_switch_stress(uint32_t cycles) {
+    screen_set_view_cache_budget(0);
+    nav_snapshot_set_budget(0);
+
+    mem_manager_stats_t start;
+    mem_manager_get_stats(&start);
+    screen_switch_stats_t sw_start;
+    screen_get_switch_stats(&sw_start);
+
+    const uint32_t rounds = cycles / num_views;
+    mem_round_t early = {}, late = {};
+    uint32_t max_live = 0;
+
+    printf("MEMSTRESS,cycle,int_free,int_largest,int_frag,psram_free,psram_largest,psram_frag,arenas_live,system_bytes\n");
+    for (uint32_t i = 1; i <= rounds * num_views; i++) {
+        switch_screen(cycle_views[i % num_views]);
+        run_frames(2);
+
+        mem_manager_stats_t st;
+        mem_manager_get_stats(&st);
+        // La vista actual y, hasta el siguiente cambio, la que acaba de salir
+        if (st.arenas_live > max_live) max_live = st.arenas_live;
+
+        if (i % MEM_STRESS_REPORT == 0) {
+            printf("MEMSTRESS,%lu,%u,%u,%u,%u,%u,%u,%lu,%u\n", (unsigned long)i,
+                   (unsigned)st.internal.free_bytes, (unsigned)st.internal.largest_free_block, st.internal.frag_pct,
+                   (unsigned)st.psram.free_bytes, (unsigned)st.psram.largest_free_block, st.psram.frag_pct,
+                   (unsigned long)st.arenas_live, (unsigned)st.system_bytes);
+            CHECK(lv_mem_test() == LV_RESULT_OK);
+        }
+
+        if (i % num_views) continue;
+        const uint32_t round = i / num_views;
+        mem_round_t r;
+        round_sample(&r);
+        if (round > MEM_WARMUP_ROUNDS && round <= MEM_WARMUP_ROUNDS + MEM_WINDOW_ROUNDS) {
+            window_merge(&early, r, round == MEM_WARMUP_ROUNDS + 1);
+        }
+        if (round > rounds - MEM_WINDOW_ROUNDS) {
+            window_merge(&late, r, round == rounds - MEM_WINDOW_ROUNDS + 1);
+        }
+    }
+
+    // Sin caché solo queda la vista en pantalla
+    screen_set_view_cache_budget(0);
+    mem_manager_stats_t end;
+    mem_manager_get_stats(&end);
+    screen_switch_stats_t sw_end;
+    screen_get_switch_stats(&sw_end);
+
+    const uint32_t created = sw_end.cache_misses - sw_start.cache_misses;
+    CHECK(created >= rounds * num_views);
+    CHECK(max_live <= 2);
+    CHECK_EQ(end.arenas_live, 1);
+    CHECK_EQ(end.arena_releases - start.arena_releases + end.arenas_live - start.arenas_live, created);
+    CHECK(end.arena_bytes > 0);
+
+    printf("MEMSTRESS_WINDOW,window,int_largest,psram_largest,tier_peak,arena_peak\n");
+    printf("MEMSTRESS_WINDOW,early,%u,%u,%u,%u\n", (unsigned)early.int_largest, (unsigned)early.psram_largest,
+           (unsigned)early.tier_peak, (unsigned)early.arena_peak);
+    printf("MEMSTRESS_WINDOW,late,%u,%u,%u,%u\n", (unsigned)late.int_largest, (unsigned)late.psram_largest,
+           (unsigned)late.tier_peak, (unsigned)late.arena_peak);
+    CHECK(late.int_largest >= early.int_largest);
+    CHECK(late.psram_largest >= early.psram_largest);
+    CHECK(late.tier_peak <= early.tier_peak + MEM_PEAK_SLACK);
+    CHECK(late.arena_peak <= early.arena_peak + MEM_PEAK_SLACK);
+    CHECK(lv_mem_test() == LV_RESULT_OK);
+
+    screen_set_view_cache_budget(VIEW_CACHE_BUDGET_BYTES);
+    nav_snapshot_set_budget(NAV_SNAPSHOT_BUDGET_BYTES);
+}
+
+int main(int argc, char** argv) {
+    const uint32_t cycles = argc > 1 ? (uint32_t)strtoul(argv[1], nullptr, 10) : MEM_STRESS_CYCLES;
+    esp_log_level_set("*", ESP_LOG_WARN);
+    screen_init();
+    switch_screen(VIEW_CLOCK);
+    run_frames(2);
+
+    test_arena();
+    test_arena_slots();
+    test_tiers();
+    test_switch_stress(cycles);
+    mem_manager_log_stats();
+    return host_test_result();
+}
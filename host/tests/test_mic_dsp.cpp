@@ -0,0 +1,297 @@
+// Procesado del micrófono en el PC: mic_wav.h lee WAVs generados aquí y
+// mic_dsp los procesa con MIC_BLOCK_SAMPLES y MIC_SPECTRUM_BANDS de config.h.
+// Las bandas se comparan con una FFT en double con la misma ventana de Hann y
+// la misma referencia de 0 dBFS (seno a fondo de escala).
+
+#include "host_test.h"
+#include "controllers/microphone/mic_dsp.h"
+#include "controllers/microphone/mic_wav.h"
+#include "config.h"
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#define N               MIC_BLOCK_SAMPLES
+#define LEVEL_TOL       3       // Niveles de banda (80 dB / 255 ≈ 0,3 dB por nivel)
+// Solo se comparan bandas a menos de 30 dB de la más fuerte: más abajo manda el
+// ruido de redondeo de la FFT Q15 (unos 35 dB de rango limpio con Hann)
+#define RANGE_LEVELS    96
+
+static const double PI = 3.14159265358979323846;
+static mic_dsp_t dsp;
+static std::string tmp_dir;
+
+// --- WAVs de prueba ------------------------------------------------------------
+
+static void put_u16(std::vector<uint8_t>& v, uint16_t x) {
+    v.push_back(x & 0xFF);
+    v.push_back(x >> 8);
+}
+
+static void put_u32(std::vector<uint8_t>& v, uint32_t x) {
+    put_u16(v, x & 0xFFFF);
+    put_u16(v, x >> 16);
+}
+
+static void put_chunk(std::vector<uint8_t>& v, const char* id, const std::vector<uint8_t>& body) {
+    v.insert(v.end(), id, id + 4);
+    put_u32(v, (uint32_t)body.size());
+    v.insert(v.end(), body.begin(), body.end());
+    if (body.size() & 1) v.push_back(0);
+}
+
+// 'extra_fmt' alarga el chunk fmt (WAVEFORMATEX); 'junk' añade un chunk impar antes de data
+static std::string write_wav(const char* name, uint16_t channels, uint16_t bits, const std::vector<int16_t>& samples,
+                             uint16_t extra_fmt = 0, bool junk = false, bool fmt_first = true) {
+    std::vector<uint8_t> fmt;
+    put_u16(fmt, 1);
+    put_u16(fmt, channels);
+    put_u32(fmt, MIC_SAMPLE_RATE);
+    put_u32(fmt, MIC_SAMPLE_RATE * channels * bits / 8);
+    put_u16(fmt, channels * bits / 8);
+    put_u16(fmt, bits);
+    fmt.resize(fmt.size() + extra_fmt, 0);
+
+    std::vector<uint8_t> data;
+    for (int16_t s : samples) put_u16(data, (uint16_t)s);
+
+    std::vector<uint8_t> body = { 'W', 'A', 'V', 'E' };
+    if (fmt_first) put_chunk(body, "fmt ", fmt);
+    if (junk) put_chunk(body, "LIST", { 'I', 'N', 'F', 'O', 'x' });
+    put_chunk(body, "data", data);
+    if (!fmt_first) put_chunk(body, "fmt ", fmt);
+
+    std::vector<uint8_t> file = { 'R', 'I', 'F', 'F' };
+    put_u32(file, (uint32_t)body.size());
+    file.insert(file.end(), body.begin(), body.end());
+
+    const std::string path = tmp_dir + "/" + name;
+    FILE* f = fopen(path.c_str(), "wb");
+    fwrite(file.data(), 1, file.size(), f);
+    fclose(f);
+    return path;
+}
+
+static std::vector<int16_t> tone(uint32_t count, double bin, double amplitude, int dc = 0) {
+    std::vector<int16_t> x(count);
+    for (uint32_t i = 0; i < count; i++) {
+        x[i] = (int16_t)lround(dc + amplitude * sin(2.0 * PI * bin * i / N + 0.3));
+    }
+    return x;
+}
+
+// --- Referencia en double --------------------------------------------------------
+
+static void reference_bands(const int16_t* x, uint8_t* out) {
+    double mean = 0;
+    for (uint32_t i = 0; i < N; i++) mean += x[i];
+    mean /= N;
+
+    for (uint32_t b = 0; b < dsp.bands; b++) {
+        double power = 0;
+        for (uint32_t k = dsp.band_edge[b]; k < dsp.band_edge[b + 1]; k++) {
+            double re = 0, im = 0;
+            for (uint32_t i = 0; i < N; i++) {
+                const double w = 0.5 * (1.0 - cos(2.0 * PI * i / N));
+                re += (x[i] - mean) * w * cos(2.0 * PI * k * i / N);
+                im -= (x[i] - mean) * w * sin(2.0 * PI * k * i / N);
+            }
+            power += (re * re + im * im) / ((double)N * N);
+        }
+        // 0 dBFS: seno de amplitud 2^15 → |X| = 2^13 → P = 2^26
+        const double db = power > 0 ? 10.0 * log10(power / 67108864.0) : -1000.0;
+        const double level = (db - MIC_SPECTRUM_FLOOR_DB) * MIC_DSP_LEVEL_MAX / -MIC_SPECTRUM_FLOOR_DB;
+        out[b] = (uint8_t)(level < 0 ? 0 : level > MIC_DSP_LEVEL_MAX ? MIC_DSP_LEVEL_MAX : level);
+    }
+}
+
+static void spectrum(const int16_t* x, uint8_t* bands, mic_dsp_level_t* lvl) {
+    alignas(4) int16_t block[N];
+    memcpy(block, x, sizeof(block));
+    mic_dsp_level(block, N, lvl);
+    mic_dsp_spectrum(&dsp, block, lvl, bands);
+}
+
+static uint32_t loudest(const uint8_t* bands) {
+    uint32_t best = 0;
+    for (uint32_t b = 1; b < dsp.bands; b++) {
+        if (bands[b] > bands[best]) best = b;
+    }
+    return best;
+}
+
+// Bin central de una banda
+static uint32_t band_bin(uint32_t b) {
+    return (dsp.band_edge[b] + dsp.band_edge[b + 1] - 1) / 2;
+}
+
+// --- Tests ------------------------------------------------------------------------
+
+static void test_wav_headers() {
+    const std::vector<int16_t> x = tone(3 * N + 10, 8, 1000);
+    mic_wav_info_t info = {};
+
+    FILE* f = fopen(write_wav("mono.wav", 1, 16, x, 2, true).c_str(), "rb");
+    CHECK(mic_wav_read_header(f, &info));
+    CHECK_EQ(info.channels, 1);
+    CHECK_EQ(info.sample_rate, MIC_SAMPLE_RATE);
+    CHECK_EQ(info.data_bytes, x.size() * 2);
+    int16_t buf[N];
+    uint32_t blocks = 0;
+    bool same = true;
+    while (mic_wav_read_block(f, &info, buf, N)) {
+        same = same && !memcmp(buf, &x[blocks * N], sizeof(buf));
+        blocks++;
+    }
+    CHECK_EQ(blocks, 3);
+    CHECK(same);
+    fclose(f);
+
+    // No soportados: 8 bits, sin RIFF, data antes que fmt
+    f = fopen(write_wav("u8.wav", 1, 8, x).c_str(), "rb");
+    CHECK(!mic_wav_read_header(f, &info));
+    fclose(f);
+    f = fopen(write_wav("late_fmt.wav", 1, 16, x, 0, false, false).c_str(), "rb");
+    CHECK(!mic_wav_read_header(f, &info));
+    fclose(f);
+    const std::string bad = write_wav("rifx.wav", 1, 16, x);
+    f = fopen(bad.c_str(), "r+b");
+    fputs("RIFX", f);
+    rewind(f);
+    CHECK(!mic_wav_read_header(f, &info));
+    fclose(f);
+}
+
+static void test_wav_stereo() {
+    // Izquierdo: tono; derecho: ruido que no debe colarse
+    const std::vector<int16_t> left = tone(2 * N, 20, 12000);
+    std::vector<int16_t> frames;
+    srand(7);
+    for (int16_t s : left) {
+        frames.push_back(s);
+        frames.push_back((int16_t)(rand() % 65536 - 32768));
+    }
+    mic_wav_info_t info = {};
+    FILE* f = fopen(write_wav("stereo.wav", 2, 16, frames, 0, true).c_str(), "rb");
+    CHECK(mic_wav_read_header(f, &info));
+    CHECK_EQ(info.channels, 2);
+    int16_t buf[2 * N];
+    for (uint32_t b = 0; b < 2; b++) {
+        CHECK(mic_wav_read_block(f, &info, buf, N));
+        CHECK(!memcmp(buf, &left[b * N], N * sizeof(int16_t)));
+    }
+    CHECK(!mic_wav_read_block(f, &info, buf, N));
+    fclose(f);
+}
+
+static void test_level() {
+    // 16 muestras por periodo: los picos caen justo en muestras
+    alignas(4) int16_t block[N];
+    for (uint32_t i = 0; i < N; i++) {
+        block[i] = (int16_t)lround(1000 + 16384 * sin(2.0 * PI * i / 16));
+    }
+    mic_dsp_level_t lvl;
+    mic_dsp_level(block, N, &lvl);
+    CHECK_EQ(lvl.mean, 1000);
+    CHECK(std::abs((int)lvl.rms - 11585) <= 12);
+    CHECK(std::abs((int)lvl.peak - 16384) <= 1);
+    // -9 dBFS de RMS, -6 de pico, con el error de log2 de mic_dsp_dbfs_x10 (< 0,6 dB)
+    CHECK(std::abs(mic_dsp_dbfs_x10(lvl.rms) + 90) <= 6);
+    CHECK(std::abs(mic_dsp_dbfs_x10(lvl.peak) + 60) <= 6);
+
+    memset(block, 0, sizeof(block));
+    mic_dsp_level(block, N, &lvl);
+    CHECK_EQ(lvl.rms, 0);
+    CHECK_EQ(lvl.peak, 0);
+    CHECK_EQ(mic_dsp_dbfs_x10(0), -999);
+    uint8_t bands[MIC_DSP_MAX_BANDS];
+    memset(bands, 0xAA, sizeof(bands));
+    mic_dsp_spectrum(&dsp, block, &lvl, bands);
+    for (uint32_t b = 0; b < dsp.bands; b++) CHECK_EQ(bands[b], 0);
+}
+
+static void test_bands_vs_reference() {
+    static const double amplitudes[] = { 16384.0, 1036.0, 33.0 };   // -6, -30 y -60 dBFS
+    uint32_t compared = 0;
+    uint32_t worst = 0;
+    for (double amp : amplitudes) {
+        for (uint32_t b = 0; b < dsp.bands; b++) {
+            // Bin central y un tono entre dos bins, que reparte energía en varias bandas
+            for (double bin : { (double)band_bin(b), band_bin(b) + 0.5 }) {
+                const std::vector<int16_t> x = tone(N, bin, amp, 200);
+                uint8_t got[MIC_DSP_MAX_BANDS];
+                uint8_t ref[MIC_DSP_MAX_BANDS];
+                mic_dsp_level_t lvl;
+                spectrum(x.data(), got, &lvl);
+                reference_bands(x.data(), ref);
+                if (bin == band_bin(b)) CHECK_EQ(loudest(got), b);
+                for (uint32_t k = 0; k < dsp.bands; k++) {
+                    if (ref[k] + RANGE_LEVELS < ref[loudest(ref)]) continue;
+                    const uint32_t diff = (uint32_t)std::abs((int)got[k] - (int)ref[k]);
+                    if (diff > LEVEL_TOL) {
+                        fprintf(stderr, "amp %.0f bin %.1f banda %u: %u != ref %u\n", amp, bin, k, got[k], ref[k]);
+                    }
+                    CHECK(diff <= LEVEL_TOL);
+                    if (diff > worst) worst = diff;
+                    compared++;
+                }
+            }
+        }
+    }
+    CHECK(compared >= 3 * dsp.bands);
+    printf("bandas comparadas %u, error máximo %u niveles\n", compared, worst);
+}
+
+static void test_wav_tones() {
+    // Cuatro tonos de cuatro bloques cada uno, en estéreo, como un WAV de la SD
+    static const uint32_t tone_bands[] = { 3, 7, 11, 14 };
+    std::vector<int16_t> frames;
+    for (uint32_t t = 0; t < 4; t++) {
+        const std::vector<int16_t> x = tone(4 * N, band_bin(tone_bands[t]), 8000);
+        for (int16_t s : x) {
+            frames.push_back(s);
+            frames.push_back(0);
+        }
+    }
+    mic_wav_info_t info = {};
+    FILE* f = fopen(write_wav("tones.wav", 2, 16, frames).c_str(), "rb");
+    CHECK(mic_wav_read_header(f, &info));
+    alignas(4) int16_t buf[2 * N];
+    uint32_t block = 0;
+    while (mic_wav_read_block(f, &info, buf, N)) {
+        uint8_t bands[MIC_DSP_MAX_BANDS];
+        mic_dsp_level_t lvl;
+        spectrum(buf, bands, &lvl);
+        CHECK_EQ(loudest(bands), tone_bands[block / 4]);
+        CHECK(std::abs(mic_dsp_dbfs_x10(lvl.peak) + 123) <= 10);     // 8000 ≈ -12,3 dBFS
+        block++;
+    }
+    CHECK_EQ(block, 16);
+    fclose(f);
+}
+
+int main() {
+    char tmpl[] = "/tmp/mic_dsp_XXXXXX";
+    if (!mkdtemp(tmpl)) return 1;
+    tmp_dir = tmpl;
+
+    CHECK(mic_dsp_init(&dsp, N, MIC_SPECTRUM_BANDS, MIC_SPECTRUM_FLOOR_DB));
+    CHECK(!mic_dsp_init(&dsp, 100, MIC_SPECTRUM_BANDS, MIC_SPECTRUM_FLOOR_DB));
+    CHECK(mic_dsp_init(&dsp, N, MIC_SPECTRUM_BANDS, MIC_SPECTRUM_FLOOR_DB));
+    for (uint32_t b = 0; b < dsp.bands; b++) CHECK(dsp.band_edge[b] < dsp.band_edge[b + 1]);
+    CHECK_EQ(dsp.band_edge[dsp.bands], N / 2);
+
+    test_wav_headers();
+    test_wav_stereo();
+    test_level();
+    test_bands_vs_reference();
+    test_wav_tones();
+
+    for (const char* name : { "mono.wav", "u8.wav", "late_fmt.wav", "rifx.wav", "stereo.wav", "tones.wav" }) {
+        unlink((tmp_dir + "/" + name).c_str());
+    }
+    rmdir(tmp_dir.c_str());
+    return host_test_result();
+}
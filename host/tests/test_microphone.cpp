@@ -0,0 +1,299 @@
+// microphone.cpp entero en el PC, con la tarea 'mic' en su hilo y el canal I2S
+// de i2s_host.cpp: MIC_DMA_BLOCKS buffers DMA en anillo que el test llena con
+// host_i2s_rx_push (el hilo del test hace de ISR).
+//   - microphone_feed_wav: troceo en bloques contiguos sin solape, cola parcial
+//     descartada, canal parado mientras entra el WAV y bandas iguales a mic_dsp.
+//   - Entrega por la SpscQueue: bloque a bloque llegan intactos; con la tarea
+//     atascada la cola se llena (dropped) y el DMA pisa lo encolado (overruns).
+//   - Coste por bloque: ns de pared de feed_wav y microphone_benchmark (en el
+//     PC los "ciclos" son ns).
+
+#include "host_test.h"
+#include "controllers/microphone/microphone.h"
+#include "controllers/microphone/mic_dsp.h"
+#include "config.h"
+#include "driver/i2s_std.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#define N               MIC_BLOCK_SAMPLES
+#define WAIT_MS         2000        // Margen de la tarea 'mic' para vaciar la cola
+#define BURST_BLOCKS    20          // Más que la cola (8) y que el anillo DMA
+#define TIMING_BLOCKS   200
+
+static std::string tmp_dir;
+
+// --- Consumidor de bloques ----------------------------------------------------
+
+static std::mutex rec_lock;
+static std::vector<std::vector<int16_t>> received;
+static std::vector<bool> received_with_rx;          // Canal I2S habilitado al recibirlo
+static std::atomic<bool> stall{false};
+static std::atomic<bool> stalled{false};
+
+static void recorder(const int16_t* samples, uint32_t count, void*) {
+    {
+        std::lock_guard<std::mutex> guard(rec_lock);
+        received.emplace_back(samples, samples + count);
+        received_with_rx.push_back(host_i2s_rx_enabled(MIC_I2S_PORT));
+    }
+    // Tarea 'mic' ocupada: el "DMA" sigue entregando bloques mientras tanto
+    while (stall.load()) {
+        stalled.store(true);
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+}
+
+static void clear_received() {
+    std::lock_guard<std::mutex> guard(rec_lock);
+    received.clear();
+    received_with_rx.clear();
+}
+
+static size_t received_count() {
+    std::lock_guard<std::mutex> guard(rec_lock);
+    return received.size();
+}
+
+// Hasta que 'blocks' bloques se hayan procesado o perdido en el ISR (o se agote WAIT_MS)
+static void wait_processed(uint32_t blocks) {
+    const int64_t deadline = esp_timer_get_time() + WAIT_MS * 1000LL;
+    mic_stats_t st;
+    do {
+        microphone_get_stats(&st);
+        if (st.blocks + st.dropped >= blocks) return;
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    } while (esp_timer_get_time() < deadline);
+}
+
+// Muestra 'i' del flujo: rampa que no se repite en todo el test
+static int16_t sample_at(uint32_t i) {
+    return (int16_t)((i * 7 + 3) & 0x7FFF);
+}
+
+// --- WAV ------------------------------------------------------------------------
+
+static void put_u16(std::vector<uint8_t>& v, uint16_t x) {
+    v.push_back(x & 0xFF);
+    v.push_back(x >> 8);
+}
+
+static void put_u32(std::vector<uint8_t>& v, uint32_t x) {
+    put_u16(v, x & 0xFFFF);
+    put_u16(v, x >> 16);
+}
+
+// Estéreo: izquierdo = sample_at(i), derecho = su opuesto (no debe aparecer)
+static std::string write_stereo_wav(const char* name, uint32_t frames) {
+    std::vector<uint8_t> file = { 'R', 'I', 'F', 'F' };
+    put_u32(file, 36 + frames * 4);
+    file.insert(file.end(), { 'W', 'A', 'V', 'E', 'f', 'm', 't', ' ' });
+    put_u32(file, 16);
+    put_u16(file, 1);
+    put_u16(file, 2);
+    put_u32(file, MIC_SAMPLE_RATE);
+    put_u32(file, MIC_SAMPLE_RATE * 4);
+    put_u16(file, 4);
+    put_u16(file, 16);
+    file.insert(file.end(), { 'd', 'a', 't', 'a' });
+    put_u32(file, frames * 4);
+    for (uint32_t i = 0; i < frames; i++) {
+        put_u16(file, (uint16_t)sample_at(i));
+        put_u16(file, (uint16_t)-sample_at(i));
+    }
+
+    const std::string path = tmp_dir + "/" + name;
+    FILE* f = fopen(path.c_str(), "wb");
+    fwrite(file.data(), 1, file.size(), f);
+    fclose(f);
+    return path;
+}
+
+static void test_feed_wav() {
+    const uint32_t blocks = 5;
+    const std::string path = write_stereo_wav("blocks.wav", blocks * N + N / 2);
+
+    microphone_reset_stats();
+    clear_received();
+    CHECK_EQ(microphone_feed_wav(path.c_str(), false), ESP_OK);
+
+    // Cola parcial descartada, cada bloque es el tramo contiguo del canal izquierdo
+    {
+        std::lock_guard<std::mutex> guard(rec_lock);
+        CHECK_EQ(received.size(), blocks);
+        for (uint32_t b = 0; b < received.size(); b++) {
+            bool same = received[b].size() == N;
+            for (uint32_t i = 0; same && i < N; i++) same = received[b][i] == sample_at(b * N + i);
+            CHECK(same);
+            CHECK(!received_with_rx[b]);
+        }
+    }
+    // Terminado el WAV vuelve la captura que pedía el block_cb
+    CHECK(host_i2s_rx_enabled(MIC_I2S_PORT));
+
+    mic_levels_t lv;
+    microphone_get_levels(&lv);
+    CHECK_EQ(lv.seq, blocks);
+    mic_stats_t st;
+    microphone_get_stats(&st);
+    CHECK_EQ(st.blocks, blocks);
+    CHECK_EQ(st.spectrum_blocks, 0);
+    CHECK(st.capturing);
+    CHECK(strcmp(st.source, "i2s") == 0);
+
+    // Con espectro, las bandas publicadas son las de mic_dsp sobre el último bloque
+    microphone_set_spectrum_enabled(true);
+    microphone_reset_stats();
+    CHECK_EQ(microphone_feed_wav(path.c_str(), false), ESP_OK);
+    microphone_get_stats(&st);
+    CHECK_EQ(st.spectrum_blocks, blocks);
+
+    static mic_dsp_t dsp;
+    mic_dsp_init(&dsp, N, MIC_SPECTRUM_BANDS, MIC_SPECTRUM_FLOOR_DB);
+    std::vector<int16_t> last(N);
+    for (uint32_t i = 0; i < N; i++) last[i] = sample_at((blocks - 1) * N + i);
+    mic_dsp_level_t ref;
+    uint8_t bands[MIC_SPECTRUM_BANDS];
+    mic_dsp_level(last.data(), N, &ref);
+    mic_dsp_spectrum(&dsp, last.data(), &ref, bands);
+    microphone_get_levels(&lv);
+    CHECK_EQ(lv.rms, ref.rms);
+    CHECK_EQ(lv.peak, ref.peak);
+    CHECK(memcmp(lv.bands, bands, MIC_SPECTRUM_BANDS) == 0);
+    microphone_set_spectrum_enabled(false);
+    unlink(path.c_str());
+}
+
+// Coste de pared por bloque del camino del WAV, con y sin espectro
+static void time_feed_wav() {
+    const std::string path = write_stereo_wav("timing.wav", TIMING_BLOCKS * N);
+    microphone_set_block_cb(nullptr, nullptr);
+    printf("MICHOST,blocks,spectrum,ns_per_block\n");
+    for (bool spectrum : { false, true }) {
+        microphone_set_spectrum_enabled(spectrum);
+        const int64_t t0 = esp_timer_get_time();
+        CHECK_EQ(microphone_feed_wav(path.c_str(), false), ESP_OK);
+        const int64_t us = esp_timer_get_time() - t0;
+        printf("MICHOST,%d,%d,%lld\n", TIMING_BLOCKS, spectrum ? 1 : 0, (long long)(us * 1000 / TIMING_BLOCKS));
+    }
+    microphone_set_spectrum_enabled(false);
+    unlink(path.c_str());
+}
+
+// --- I2S ------------------------------------------------------------------------
+
+static uint32_t stream_pos = 0;
+
+static uint32_t push_blocks(uint32_t blocks) {
+    std::vector<int16_t> x(blocks * N);
+    for (uint32_t i = 0; i < x.size(); i++) x[i] = sample_at(stream_pos + i);
+    stream_pos += x.size();
+    return host_i2s_rx_push(MIC_I2S_PORT, x.data(), x.size());
+}
+
+static void test_ring_in_order() {
+    microphone_reset_stats();
+    clear_received();
+    const uint32_t first = stream_pos;
+
+    // Medio bloque no completa ningún buffer DMA; la otra mitad sí
+    std::vector<int16_t> half(N / 2);
+    for (uint32_t i = 0; i < N / 2; i++) half[i] = sample_at(stream_pos + i);
+    CHECK_EQ(host_i2s_rx_push(MIC_I2S_PORT, half.data(), N / 2), 0);
+    for (uint32_t i = 0; i < N / 2; i++) half[i] = sample_at(stream_pos + N / 2 + i);
+    CHECK_EQ(host_i2s_rx_push(MIC_I2S_PORT, half.data(), N / 2), 1);
+    stream_pos += N;
+    wait_processed(1);
+
+    // Más vueltas que buffers tiene el anillo, esperando a la tarea en cada una
+    const uint32_t blocks = 3 * MIC_DMA_BLOCKS;
+    for (uint32_t b = 1; b < blocks; b++) {
+        CHECK_EQ(push_blocks(1), 1);
+        wait_processed(b + 1);
+    }
+
+    mic_stats_t st;
+    microphone_get_stats(&st);
+    CHECK_EQ(st.blocks, blocks);
+    CHECK_EQ(st.dropped, 0);
+    CHECK_EQ(st.overruns, 0);
+
+    std::lock_guard<std::mutex> guard(rec_lock);
+    CHECK_EQ(received.size(), blocks);
+    for (uint32_t b = 0; b < received.size(); b++) {
+        bool same = true;
+        for (uint32_t i = 0; same && i < N; i++) same = received[b][i] == sample_at(first + b * N + i);
+        CHECK(same);
+        CHECK(received_with_rx[b]);
+    }
+}
+
+static void test_ring_stalled() {
+    microphone_reset_stats();
+    clear_received();
+
+    // La tarea se queda dentro del block_cb con el primer bloque
+    stall.store(true);
+    stalled.store(false);
+    CHECK_EQ(push_blocks(1), 1);
+    const int64_t deadline = esp_timer_get_time() + WAIT_MS * 1000LL;
+    while (!stalled.load() && esp_timer_get_time() < deadline) std::this_thread::sleep_for(std::chrono::microseconds(200));
+    CHECK(stalled.load());
+
+    // El DMA no espera: la cola se llena y el resto se pierde en el ISR
+    CHECK_EQ(push_blocks(BURST_BLOCKS), BURST_BLOCKS);
+    stall.store(false);
+    wait_processed(1 + BURST_BLOCKS);
+
+    mic_stats_t st;
+    microphone_get_stats(&st);
+    CHECK_EQ(st.blocks + st.dropped, 1 + BURST_BLOCKS);
+    CHECK(st.dropped > 0);
+    // Todo lo que esperaba en la cola apunta a buffers que el DMA ya reescribió
+    CHECK(st.overruns > 0);
+    CHECK(st.overruns <= st.blocks);
+    CHECK_EQ(received_count(), st.blocks);
+}
+
+int main() {
+    esp_log_level_set("*", ESP_LOG_WARN);
+    char tmpl[] = "/tmp/microphone_XXXXXX";
+    if (!mkdtemp(tmpl)) return 1;
+    tmp_dir = tmpl;
+
+    CHECK_EQ(microphone_init(), ESP_OK);
+    CHECK_EQ(microphone_init(), ESP_OK);
+    CHECK(microphone_is_running());
+    // Configurado pero parado: nadie pide bloques
+    CHECK(!host_i2s_rx_enabled(MIC_I2S_PORT));
+    CHECK_EQ(push_blocks(1), 0);
+
+    microphone_set_block_cb(recorder, nullptr);
+    CHECK(host_i2s_rx_enabled(MIC_I2S_PORT));
+
+    test_feed_wav();
+    test_ring_in_order();
+    test_ring_stalled();
+
+    // Sin consumidores el canal se para y el DMA no entrega nada
+    microphone_set_block_cb(nullptr, nullptr);
+    CHECK(!host_i2s_rx_enabled(MIC_I2S_PORT));
+    CHECK_EQ(push_blocks(1), 0);
+    mic_stats_t st;
+    microphone_get_stats(&st);
+    CHECK(!st.capturing);
+
+    time_feed_wav();
+    microphone_benchmark(MIC_BENCH_BLOCKS);
+
+    rmdir(tmp_dir.c_str());
+    return host_test_result();
+}
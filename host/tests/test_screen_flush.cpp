@@ -0,0 +1,287 @@
+// Camino de flush real (screen_flush.cpp) sobre el panel simulado, con un bus
+// de velocidad fija. El test hace lo que LVGL con dos buffers: pinta un área,
+// espera con screen_flush_wait_stall si el otro buffer sigue en el bus y lanza
+// screen_flush_area. Con el render más lento que el bus la transferencia queda
+// escondida (solape > 0, stall < transferencia); con el render más rápido es
+// al revés. En los tres modos la GRAM acaba con lo pintado, ningún buffer
+// cambia mientras está en el bus, los trozos y bytes son los esperados y un
+// draw_bitmap que falla devuelve el buffer sin colgar el flush.
+
+#include "host_test.h"
+#include "controllers/screen_manager/screen_manager.h"
+#include "config.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "host_panel.h"
+#include <cstdio>
+
+#define NS_PER_BYTE 200     // 5 MB/s: el SPI a EXAMPLE_LCD_PIXEL_CLOCK_HZ (40 MHz)
+#define FRAMES 3
+#define STRIP_LINES 40
+#define BOUNCE_LINES 20
+
+static const char* const mode_names[] = { "partial", "psram-direct", "psram-bounce" };
+
+static uint16_t pattern(uint32_t frame, int32_t x, int32_t y) {
+    return (uint16_t)(frame * 7919 + y * 241 + x * 3);
+}
+
+static uint32_t transfer_us(uint32_t bytes) {
+    return (uint32_t)((uint64_t)bytes * NS_PER_BYTE / 1000);
+}
+
+// Pinta 'area' del frame en 'buf', cuyo píxel (0, 0) es (ox, oy) de la pantalla,
+// y tarda al menos render_us como un render de LVGL
+static void render(uint8_t* buf, int32_t stride, int32_t ox, int32_t oy, const lv_area_t* area, uint32_t frame,
+                   uint32_t render_us) {
+    const int64_t t0 = esp_timer_get_time();
+    uint16_t* px = (uint16_t*)buf;
+    for (int32_t y = area->y1; y <= area->y2; y++) {
+        for (int32_t x = area->x1; x <= area->x2; x++) {
+            px[(y - oy) * stride + (x - ox)] = pattern(frame, x, y);
+        }
+    }
+    while (esp_timer_get_time() - t0 < render_us) {
+    }
+}
+
+// LVGL (wait_for_flushing): solo espera si el otro buffer sigue en vuelo
+static void lvgl_flush(screen_t* s, const lv_area_t* area, uint8_t* buf, bool last) {
+    if (s->flush_pending) screen_flush_wait_stall(s);
+    screen_flush_area(s, area, buf, last);
+}
+
+// Frames de LVGL: en PARTIAL cada área va a un strip y los buffers se alternan
+// por área; en los modos PSRAM el frame entero está en un buffer y se alternan
+// por frame
+static void run_frames(screen_t* s, const lv_area_t* areas, uint32_t n_areas, uint32_t first_frame, uint32_t frames,
+                       uint32_t render_us) {
+    uint8_t* bufs[2] = { (uint8_t*)s->lvgl_buf1, (uint8_t*)s->lvgl_buf2 };
+    const bool partial = s->render_cfg.mode == SCREEN_RENDER_PARTIAL;
+    uint32_t next = 0;
+    for (uint32_t f = first_frame; f < first_frame + frames; f++) {
+        for (uint32_t i = 0; i < n_areas; i++) {
+            const lv_area_t* a = &areas[i];
+            uint8_t* buf;
+            if (partial) {
+                buf = bufs[next];
+                next ^= 1;
+                render(buf, lv_area_get_width(a), a->x1, a->y1, a, f, render_us);
+            } else {
+                buf = bufs[f & 1];
+                render(buf, SCREEN_WIDTH, 0, 0, a, f, render_us);
+            }
+            lvgl_flush(s, a, buf, i == n_areas - 1);
+        }
+    }
+    screen_flush_wait(s);
+    host_panel_wait_idle(s->panel_handle);
+}
+
+static bool gram_matches(screen_t* s, const lv_area_t* area, uint32_t frame) {
+#if SCREEN_RGB565_SWAP
+    return true;    // Los bytes llegan invertidos; el contenido ya lo cubre test_draw_accel
+#else
+    const uint16_t* gram = host_panel_pixels(s->panel_handle);
+    for (int32_t y = area->y1; y <= area->y2; y++) {
+        for (int32_t x = area->x1; x <= area->x2; x++) {
+            if (gram[y * SCREEN_WIDTH + x] != pattern(frame, x, y)) return false;
+        }
+    }
+    return true;
+#endif
+}
+
+static screen_t* open_screen(screen_render_mode_t mode) {
+    const screen_render_config_t cfg = { mode, STRIP_LINES, BOUNCE_LINES };
+    screen_t* s = screen_init_with_config(&cfg);
+    host_panel_set_ns_per_byte(s->panel_handle, NS_PER_BYTE);
+    CHECK_EQ(s->render_cfg.mode, mode);
+    return s;
+}
+
+// Áreas que cubren la pantalla: strips en PARTIAL, dos mitades en los modos PSRAM
+static uint32_t screen_areas(screen_t* s, lv_area_t* out) {
+    if (s->render_cfg.mode == SCREEN_RENDER_PARTIAL) {
+        uint32_t n = 0;
+        for (int32_t y = 0; y < SCREEN_HEIGHT; y += STRIP_LINES) {
+            out[n++] = { 0, y, SCREEN_WIDTH - 1, LV_MIN(y + STRIP_LINES, SCREEN_HEIGHT) - 1 };
+        }
+        return n;
+    }
+    out[0] = { 0, 0, SCREEN_WIDTH - 1, SCREEN_HEIGHT / 2 - 1 };
+    out[1] = { 0, SCREEN_HEIGHT / 2, SCREEN_WIDTH - 1, SCREEN_HEIGHT - 1 };
+    return 2;
+}
+
+static uint32_t chunks_of(screen_t* s, const lv_area_t* a) {
+    const int32_t rows = lv_area_get_height(a);
+    switch (s->render_cfg.mode) {
+        case SCREEN_RENDER_FULL_PSRAM_DIRECT:
+            return (rows + BOUNCE_LINES - 1) / BOUNCE_LINES;
+        case SCREEN_RENDER_PSRAM_BOUNCE: {
+            const int32_t lines = LV_MIN(SCREEN_WIDTH * BOUNCE_LINES / lv_area_get_width(a), rows);
+            return (rows + lines - 1) / lines;
+        }
+        default:
+            return 1;
+    }
+}
+
+// DIRECT manda bandas de ancho completo; los otros modos, solo el área
+static uint64_t bytes_of(screen_t* s, const lv_area_t* a) {
+    const int32_t width = s->render_cfg.mode == SCREEN_RENDER_FULL_PSRAM_DIRECT ? SCREEN_WIDTH : lv_area_get_width(a);
+    return (uint64_t)width * lv_area_get_height(a) * SCREEN_BYTES_PER_PIXEL;
+}
+
+static void reset(screen_t* s) {
+    screen_reset_flush_stats(s);
+    host_panel_reset_stats(s->panel_handle);
+}
+
+// Contadores, trozos, bytes y contenido de 'frames' frames de 'areas'
+static void check_frames(screen_t* s, const lv_area_t* areas, uint32_t n_areas, uint32_t first_frame, uint32_t frames) {
+    uint32_t chunks = 0;
+    uint64_t bytes = 0;
+    for (uint32_t i = 0; i < n_areas; i++) {
+        chunks += chunks_of(s, &areas[i]);
+        bytes += bytes_of(s, &areas[i]);
+    }
+
+    screen_flush_stats_t st;
+    screen_get_flush_stats(s, &st);
+    host_panel_stats_t bus;
+    host_panel_get_stats(s->panel_handle, &bus);
+    CHECK_EQ(st.flush_count, frames * n_areas);
+    CHECK_EQ(st.flushed_bytes, frames * bytes);
+    CHECK_EQ(bus.transfers, frames * chunks);
+    CHECK_EQ(bus.bytes, st.flushed_bytes);
+    CHECK_EQ(bus.overwritten, 0);
+    CHECK_EQ(s->chunks_done, s->chunks_issued);
+    CHECK(!s->flush_pending);
+    for (uint32_t i = 0; i < n_areas; i++) CHECK(gram_matches(s, &areas[i], first_frame + frames - 1));
+}
+
+static void print_stats(screen_t* s, const char* render) {
+    screen_flush_stats_t st;
+    screen_get_flush_stats(s, &st);
+    printf("FLUSH,%s,%s,%lu,%llu,%llu,%llu,%lu\n", mode_names[s->render_cfg.mode], render,
+           (unsigned long)st.flush_count, (unsigned long long)st.transfer_us, (unsigned long long)st.stall_us,
+           (unsigned long long)st.overlap_us, (unsigned long)st.max_stall_us);
+}
+
+static void test_mode(screen_render_mode_t mode) {
+    screen_t* s = open_screen(mode);
+    lv_area_t areas[SCREEN_HEIGHT / STRIP_LINES + 1];
+    const uint32_t n = screen_areas(s, areas);
+    uint32_t area_us = 0;
+    for (uint32_t i = 0; i < n; i++) area_us = LV_MAX(area_us, transfer_us((uint32_t)bytes_of(s, &areas[i])));
+    uint32_t frame = 0;
+
+    // Render más lento que el bus: cuando LVGL vuelve a necesitar el buffer
+    // ya está libre, así que casi todo el tiempo en el bus es solape
+    reset(s);
+    const uint32_t frames_before = s->frames_flushed;
+    run_frames(s, areas, n, frame, FRAMES, 2 * area_us);
+    check_frames(s, areas, n, frame, FRAMES);
+    CHECK_EQ(s->frames_flushed - frames_before, FRAMES);
+    print_stats(s, "slow");
+    screen_flush_stats_t st;
+    screen_get_flush_stats(s, &st);
+    CHECK(st.transfer_us >= (uint64_t)FRAMES * n * area_us);
+    CHECK(st.overlap_us > 0);
+    CHECK(st.stall_us < st.transfer_us);
+    CHECK(st.overlap_us > st.stall_us);
+    CHECK(st.max_stall_us < area_us);
+    frame += FRAMES;
+
+    // Render instantáneo: LVGL espera al bus en cada área. En BOUNCE parte de
+    // la espera ocurre dentro del flush (el bounce libre), que no es stall
+    // sino bounce_wait_us; entre las dos cubren la mayor parte del bus.
+    reset(s);
+    const uint64_t bounce_wait_before = s->bounce_wait_us;
+    run_frames(s, areas, n, frame, FRAMES, 0);
+    check_frames(s, areas, n, frame, FRAMES);
+    print_stats(s, "fast");
+    screen_get_flush_stats(s, &st);
+    const uint64_t bounce_wait = s->bounce_wait_us - bounce_wait_before;
+    CHECK(st.stall_us > 0);
+    if (mode != SCREEN_RENDER_PSRAM_BOUNCE) {
+        CHECK_EQ(bounce_wait, 0);
+        CHECK(st.stall_us > st.overlap_us);
+        CHECK(st.stall_us * 2 >= st.transfer_us);
+        CHECK(st.max_stall_us * 2 >= area_us);
+    } else {
+        CHECK(bounce_wait > 0);
+        CHECK((st.stall_us + bounce_wait) * 2 >= st.transfer_us);
+    }
+    frame += FRAMES;
+
+    // Un área estrecha: DIRECT manda bandas enteras, BOUNCE mete más filas por
+    // trozo, PARTIAL un solo trozo del tamaño del strip
+    const lv_area_t narrow = mode == SCREEN_RENDER_PARTIAL ? lv_area_t{ 10, 10, 49, 10 + STRIP_LINES - 1 }
+                                                          : lv_area_t{ 10, 10, 49, 229 };
+    reset(s);
+    run_frames(s, &narrow, 1, frame, 1, 0);
+    check_frames(s, &narrow, 1, frame, 1);
+    frame++;
+
+    screen_deinit(s);
+}
+
+// Falla el tercer trozo de un área: se esperan los dos ya en el bus, el buffer
+// vuelve a LVGL, los bounce quedan libres y el siguiente flush sale entero
+static void test_abort() {
+    screen_t* s = open_screen(SCREEN_RENDER_PSRAM_BOUNCE);
+    const lv_area_t area = { 0, 0, SCREEN_WIDTH - 1, 6 * BOUNCE_LINES - 1 };
+    uint8_t* buf = (uint8_t*)s->lvgl_buf1;
+
+    reset(s);
+    host_panel_fail_after(s->panel_handle, 2);
+    render(buf, SCREEN_WIDTH, 0, 0, &area, 100, 0);
+    screen_flush_area(s, &area, buf, true);
+    CHECK(!s->flush_pending);
+    CHECK_EQ(s->chunks_done, s->chunks_issued);
+    screen_flush_wait(s);
+    host_panel_stats_t bus;
+    host_panel_get_stats(s->panel_handle, &bus);
+    CHECK_EQ(bus.transfers, 2);
+    CHECK(xSemaphoreTake(s->bounce_free_sem, 0) == pdTRUE);
+    CHECK(xSemaphoreTake(s->bounce_free_sem, 0) == pdTRUE);
+    xSemaphoreGive(s->bounce_free_sem);
+    xSemaphoreGive(s->bounce_free_sem);
+
+    reset(s);
+    run_frames(s, &area, 1, 101, 1, 0);
+    check_frames(s, &area, 1, 101, 1);
+    screen_deinit(s);
+}
+
+// screen_flush_buffer (los slots de ui_pipeline): sin swap ni flush_ready, pero
+// con los mismos contadores
+static void test_flush_buffer() {
+    screen_t* s = open_screen(SCREEN_RENDER_PARTIAL);
+    static uint16_t slot[SCREEN_WIDTH * STRIP_LINES];
+    const lv_area_t area = { 0, 80, SCREEN_WIDTH - 1, 80 + STRIP_LINES - 1 };
+    render((uint8_t*)slot, SCREEN_WIDTH, 0, 80, &area, 200, 0);
+
+    reset(s);
+    const uint32_t frames_before = s->frames_flushed;
+    screen_flush_buffer(s, &area, (uint8_t*)slot, true);
+    screen_flush_wait(s);
+    host_panel_wait_idle(s->panel_handle);
+    CHECK_EQ(s->frames_flushed - frames_before, 1);
+    check_frames(s, &area, 1, 200, 1);
+    screen_deinit(s);
+}
+
+int main() {
+    esp_log_level_set("*", ESP_LOG_WARN);
+    printf("FLUSH,mode,render,flushes,transfer_us,stall_us,overlap_us,max_stall_us\n");
+    test_mode(SCREEN_RENDER_PARTIAL);
+    test_mode(SCREEN_RENDER_FULL_PSRAM_DIRECT);
+    test_mode(SCREEN_RENDER_PSRAM_BOUNCE);
+    test_abort();
+    test_flush_buffer();
+    return host_test_result();
+}
@@ -0,0 +1,258 @@
+// Ring multi-productor (utils/mpsc_ring.h) y writer de la SD (sd_card.cpp)
+// con hilos reales:
+// * el ring entrega en orden los registros de cada productor, sin perder ni
+//   duplicar ninguno, con vueltas y paddings;
+// * un registro reservado y sin publicar detiene al consumidor;
+// * el writer, sobre el backend POSIX en un directorio temporal, escribe los
+//   bytes exactos de cada fichero, con una escritura alineada por frontera de
+//   bloque cruzada;
+// * con el backend bloqueado, sd_card_write descarta lo que no cabe tras el
+//   timeout y lo cuenta.
+
+#include "host_test.h"
+#include "controllers/sd_card/sd_card.h"
+#include "utils/mpsc_ring.h"
+#include "esp_log.h"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#define RING_PRODUCERS      4
+#define RING_RECORDS        20000
+#define WRITER_FILES        3
+#define WRITER_BYTES        (40 * 1024 + 123)
+#define WRITER_BLOCK_BYTES  512         // block_bytes del writer sin FAT
+#define APPEND_PREFIX_BYTES 100
+
+// Payload del registro 'seq' del productor 'producer': longitud y bytes
+// deducibles de los dos números, para que el consumidor pueda comprobarlos
+static uint32_t record_len(uint32_t producer, uint32_t seq) {
+    return 4 + (seq * 7 + producer * 13) % 90;
+}
+
+static uint8_t record_byte(uint32_t producer, uint32_t seq, uint32_t i) {
+    return (uint8_t)(producer * 31 + seq + i);
+}
+
+static void test_ring_threads() {
+    alignas(8) static uint8_t mem[1024];    // Pequeño: muchas vueltas, paddings y ring lleno
+    MpscRing ring;
+    CHECK(ring.init(mem, sizeof(mem)));
+
+    std::vector<std::thread> producers;
+    for (uint32_t p = 0; p < RING_PRODUCERS; p++) {
+        producers.emplace_back([&ring, p]() {
+            for (uint32_t seq = 0; seq < RING_RECORDS; seq++) {
+                const uint32_t len = record_len(p, seq);
+                uint8_t* dst;
+                while ((dst = ring.reserve(len, (uint16_t)p)) == nullptr) {
+                    std::this_thread::yield();
+                }
+                memcpy(dst, &seq, 4);
+                for (uint32_t i = 4; i < len; i++) dst[i] = record_byte(p, seq, i);
+                ring.commit(dst);
+            }
+        });
+    }
+
+    uint32_t next_seq[RING_PRODUCERS] = {};
+    uint32_t received = 0;
+    uint32_t bad = 0;
+    while (received < RING_PRODUCERS * RING_RECORDS) {
+        uint32_t len;
+        uint16_t tag;
+        const uint8_t* rec = ring.peek(&len, &tag);
+        if (!rec) {
+            std::this_thread::yield();
+            continue;
+        }
+        uint32_t seq;
+        memcpy(&seq, rec, 4);
+        if (tag >= RING_PRODUCERS || seq != next_seq[tag] || len != record_len(tag, seq)) {
+            bad++;
+        } else {
+            for (uint32_t i = 4; i < len; i++) {
+                if (rec[i] != record_byte(tag, seq, i)) {
+                    bad++;
+                    break;
+                }
+            }
+            next_seq[tag]++;
+        }
+        ring.release();
+        received++;
+    }
+    for (std::thread& t : producers) t.join();
+
+    CHECK_EQ(bad, 0);
+    for (uint32_t p = 0; p < RING_PRODUCERS; p++) {
+        CHECK_EQ(next_seq[p], RING_RECORDS);
+    }
+    CHECK_EQ(ring.used(), 0);
+}
+
+static void test_ring_publish_order() {
+    alignas(8) static uint8_t mem[256];
+    MpscRing ring;
+    CHECK(ring.init(mem, sizeof(mem)));
+    CHECK(ring.reserve(ring.max_payload() + 1, 0) == nullptr);
+
+    uint8_t* a = ring.reserve(10, 1);
+    uint8_t* b = ring.reserve(20, 2);
+    CHECK(a != nullptr && b != nullptr);
+
+    uint32_t len;
+    uint16_t tag;
+    ring.commit(b);
+    CHECK(ring.peek(&len, &tag) == nullptr);    // 'a' sigue sin publicar
+
+    ring.commit(a);
+    CHECK(ring.peek(&len, &tag) == a);
+    CHECK_EQ(tag, 1);
+    CHECK_EQ(len, 10);
+    ring.release();
+    CHECK(ring.peek(&len, &tag) == b);
+    CHECK_EQ(tag, 2);
+    ring.release();
+    CHECK(ring.peek(&len, &tag) == nullptr);
+    CHECK_EQ(ring.used(), 0);
+}
+
+// Backend POSIX con una compuerta: cerrada, write() se queda esperando
+static std::atomic<bool> backend_gate{true};
+
+static int gated_write(int fd, const void* data, size_t len) {
+    while (!backend_gate.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return sd_card_posix_backend.write(fd, data, len);
+}
+
+static const sd_card_backend_t gated_backend = {
+    .name = "gated",
+    .open = sd_card_posix_backend.open,
+    .write = gated_write,
+    .sync = sd_card_posix_backend.sync,
+    .close = sd_card_posix_backend.close,
+};
+
+static std::vector<uint8_t> read_file(const std::string& path) {
+    std::vector<uint8_t> data;
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return data;
+    int c;
+    while ((c = fgetc(f)) != EOF) data.push_back((uint8_t)c);
+    fclose(f);
+    return data;
+}
+
+static uint8_t file_byte(uint32_t file, uint32_t pos) {
+    return (uint8_t)(pos * 5 + file * 71 + (pos >> 9));
+}
+
+static void test_writer(const std::string& dir) {
+    // Un fichero previo para el modo append: la primera escritura completa su bloque
+    std::vector<uint8_t> prefix(APPEND_PREFIX_BYTES, 0xAB);
+    FILE* f = fopen((dir + "/F0.BIN").c_str(), "wb");
+    fwrite(prefix.data(), 1, prefix.size(), f);
+    fclose(f);
+
+    sd_card_reset_stats();
+    std::vector<std::thread> producers;
+    for (uint32_t n = 0; n < WRITER_FILES; n++) {
+        producers.emplace_back([n]() {
+            const std::string name = "F" + std::to_string(n) + ".BIN";
+            const sd_file_t file = sd_card_open(name.c_str(), n == 0);
+            CHECK(file != SD_FILE_INVALID);
+            uint8_t chunk[700];
+            uint32_t pos = 0;
+            uint32_t step = 1;
+            while (pos < WRITER_BYTES) {
+                const uint32_t len = std::min<uint32_t>(step, WRITER_BYTES - pos);
+                for (uint32_t i = 0; i < len; i++) chunk[i] = file_byte(n, pos + i);
+                CHECK_EQ(sd_card_write(file, chunk, len, 1000), len);
+                pos += len;
+                step = step * 3 % sizeof(chunk) + 1;
+            }
+            sd_card_close(file);
+        });
+    }
+    for (std::thread& t : producers) t.join();
+    CHECK_EQ(sd_card_drain(5000), ESP_OK);
+
+    uint32_t boundaries = 0;
+    for (uint32_t n = 0; n < WRITER_FILES; n++) {
+        const std::vector<uint8_t> data = read_file(dir + "/F" + std::to_string(n) + ".BIN");
+        const uint32_t start = n == 0 ? APPEND_PREFIX_BYTES : 0;
+        CHECK_EQ(data.size(), start + WRITER_BYTES);
+        bool same = data.size() == start + WRITER_BYTES;
+        for (uint32_t i = 0; same && i < start; i++) same = data[i] == 0xAB;
+        for (uint32_t i = 0; same && i < WRITER_BYTES; i++) same = data[start + i] == file_byte(n, i);
+        CHECK(same);
+        boundaries += (start + WRITER_BYTES) / WRITER_BLOCK_BYTES - start / WRITER_BLOCK_BYTES;
+    }
+
+    sd_card_stats_t st;
+    sd_card_get_stats(&st);
+    CHECK_EQ(st.cluster_bytes, WRITER_BLOCK_BYTES);
+    CHECK_EQ(st.bytes_in, WRITER_FILES * WRITER_BYTES);
+    CHECK_EQ(st.bytes_written, WRITER_FILES * WRITER_BYTES);
+    CHECK_EQ(st.dropped_bytes, 0);
+    CHECK_EQ(st.errors, 0);
+    // Cada frontera de bloque cruzada acaba exactamente una escritura
+    CHECK_EQ(st.aligned_writes, boundaries);
+    CHECK(st.fsyncs >= WRITER_FILES);
+}
+
+static void test_back_pressure(const std::string& dir) {
+    sd_card_reset_stats();
+    const sd_file_t file = sd_card_open("DROP.BIN", false);
+    CHECK(file != SD_FILE_INVALID);
+    CHECK_EQ(sd_card_drain(5000), ESP_OK);     // Abierto antes de cerrar la compuerta
+
+    // Con el backend parado caben el ring y el bloque en curso; el resto se descarta
+    backend_gate = false;
+    std::vector<uint8_t> big(2 * SD_CARD_RING_BYTES, 0x5A);
+    const size_t accepted = sd_card_write(file, big.data(), big.size(), 20);
+    CHECK(accepted > 0);
+    CHECK(accepted < big.size());
+
+    sd_card_stats_t st;
+    sd_card_get_stats(&st);
+    CHECK_EQ(st.bytes_in, accepted);
+    CHECK_EQ(st.dropped_bytes, big.size() - accepted);
+    CHECK_EQ(st.dropped_records, 1);
+    CHECK(st.back_pressure_waits >= 1);
+
+    backend_gate = true;
+    sd_card_close(file);
+    CHECK_EQ(sd_card_drain(5000), ESP_OK);
+    sd_card_get_stats(&st);
+    CHECK_EQ(st.bytes_written, accepted);
+    CHECK_EQ(read_file(dir + "/DROP.BIN").size(), accepted);
+}
+
+int main() {
+    esp_log_level_set("*", ESP_LOG_WARN);
+
+    test_ring_publish_order();
+    test_ring_threads();
+
+    char tmpl[] = "/tmp/sd_writer_XXXXXX";
+    const char* dir = mkdtemp(tmpl);
+    CHECK(dir != nullptr);
+    if (!dir) return host_test_result();
+    CHECK_EQ(sd_card_init(), ESP_ERR_NOT_SUPPORTED);
+    CHECK_EQ(sd_card_init_with_backend(&gated_backend, dir), ESP_OK);
+
+    test_writer(dir);
+    test_back_pressure(dir);
+
+    for (const char* name : { "F0.BIN", "F1.BIN", "F2.BIN", "DROP.BIN" }) {
+        unlink((std::string(dir) + "/" + name).c_str());
+    }
+    rmdir(dir);
+    return host_test_result();
+}
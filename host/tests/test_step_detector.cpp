@@ -0,0 +1,290 @@
+// step_detector sobre trazas CSV, leídas con pedo_csv.h como hace
+// pedometer_replay_csv y pasadas en lotes del tamaño de la FIFO.
+//
+//   test_step_detector [traza.csv...]
+//
+// Sin argumentos genera las trazas: marcha a varias cadencias y orientaciones,
+// rachas con pausas, sacudidas sueltas y rachas demasiado cortas. Con
+// argumentos reproduce trazas grabadas, que deben llevar "# steps=N", y las
+// da por buenas si el error no pasa de REPLAY_TOL_PCT. Cada traza imprime una
+// línea PEDOREPLAY con las columnas de la placa (ns medidos en el PC).
+
+#include "host_test.h"
+#include "controllers/pedometer/step_detector.h"
+#include "controllers/pedometer/pedo_csv.h"
+#include "config.h"
+#include "esp_timer.h"
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#define REPLAY_TOL_PCT  5
+#define MAX_SAMPLES     (60 * 60 * PEDO_SAMPLE_RATE)
+
+static const double PI = 3.14159265358979323846;
+static std::string tmp_dir;
+
+typedef struct {
+    std::vector<int16_t> xyz;
+    uint32_t expected;
+    bool has_expected;
+} trace_t;
+
+static bool load_trace(const std::string& path, trace_t* t) {
+    FILE* f = fopen(path.c_str(), "r");
+    if (!f) return false;
+    t->xyz.clear();
+    t->has_expected = false;
+    char line[96];
+    int16_t s[3];
+    while (fgets(line, sizeof(line), f) && t->xyz.size() < 3u * MAX_SAMPLES) {
+        switch (pedo_csv_parse_line(line, PEDO_LSB_PER_G, s, &t->expected)) {
+            case PEDO_CSV_SAMPLE: t->xyz.insert(t->xyz.end(), s, s + 3); break;
+            case PEDO_CSV_EXPECTED: t->has_expected = true; break;
+            case PEDO_CSV_SKIP: break;
+        }
+    }
+    fclose(f);
+    return true;
+}
+
+static void detector_init(step_detector_t* sd) {
+    step_detector_init(sd, PEDO_SAMPLE_RATE, PEDO_LSB_PER_G, PEDO_MIN_AMPLITUDE_MG, PEDO_CONFIRM_STEPS);
+}
+
+// En lotes de 'batch' muestras; devuelve la cadencia máxima vista entre lotes
+static uint16_t replay(step_detector_t* sd, const trace_t& t, uint32_t batch, int64_t* us) {
+    const uint32_t samples = (uint32_t)(t.xyz.size() / 3);
+    uint16_t cadence_max = 0;
+    const int64_t t0 = esp_timer_get_time();
+    for (uint32_t i = 0; i < samples; i += batch) {
+        const uint32_t n = samples - i < batch ? samples - i : batch;
+        step_detector_process(sd, &t.xyz[3 * i], n);
+        const uint16_t c = step_detector_cadence(sd);
+        if (c > cadence_max) cadence_max = c;
+    }
+    if (us) *us = esp_timer_get_time() - t0;
+    return cadence_max;
+}
+
+static void print_replay(const char* name, const step_detector_t* sd, uint32_t expected, int64_t us) {
+    const int32_t err_x100 = expected ? (int32_t)(((int64_t)sd->steps - expected) * 10000 / expected) : 0;
+    const uint32_t ns_per_sample = sd->samples ? (uint32_t)(us * 1000 / (int64_t)sd->samples) : 0;
+    printf("PEDOREPLAY,%s,%llu,%u,%u,%d,%u,%u,%u\n", name, (unsigned long long)sd->samples, sd->steps, expected,
+           err_x100, sd->rejected, ns_per_sample, (uint32_t)((uint64_t)ns_per_sample * PEDO_SAMPLE_RATE / 10000));
+}
+
+// --- Trazas sintéticas ------------------------------------------------------------
+
+typedef struct {
+    double seconds;
+    double step_hz;             // 0 = quieto
+    double amplitude_g;
+    bool shake;                 // Una sacudida en mitad del tramo (solo quieto)
+} segment_t;
+
+// Escribe el CSV en mg con "# steps=N" y marca de tiempo en ms, como un registrador
+static std::string write_trace(const char* name, const segment_t* segs, uint32_t count, const double gravity[3],
+                               uint32_t expected, double noise_g) {
+    const std::string path = tmp_dir + "/" + name;
+    FILE* f = fopen(path.c_str(), "w");
+    fprintf(f, "# %s\n# steps=%u\nt_ms,x_mg,y_mg,z_mg\n", name, expected);
+    uint32_t i = 0;
+    for (uint32_t k = 0; k < count; k++) {
+        const segment_t& s = segs[k];
+        const uint32_t n = (uint32_t)lround(s.seconds * PEDO_SAMPLE_RATE);
+        for (uint32_t j = 0; j < n; j++, i++) {
+            const double t = (double)j / PEDO_SAMPLE_RATE;
+            double a = 0.0;
+            if (s.step_hz > 0) {
+                // Un paso por periodo, con un armónico como el talón y la punta
+                a = s.amplitude_g * (sin(2 * PI * s.step_hz * t) + 0.3 * sin(4 * PI * s.step_hz * t + 1.0));
+            } else if (s.shake && j == n / 2) {
+                a = 0.6;
+            }
+            int mg[3];
+            for (int ax = 0; ax < 3; ax++) {
+                const double noise = noise_g * ((rand() % 2001) - 1000) / 1000.0;
+                mg[ax] = (int)lround((gravity[ax] * (1.0 + a) + noise) * 1000.0);
+            }
+            fprintf(f, "%u,%d,%d,%d\n", i * 1000 / PEDO_SAMPLE_RATE, mg[0], mg[1], mg[2]);
+        }
+    }
+    fclose(f);
+    return path;
+}
+
+static uint32_t walk_steps(double seconds, double step_hz) {
+    return (uint32_t)(seconds * step_hz);
+}
+
+typedef struct {
+    const char* name;
+    uint32_t steps;
+    uint16_t cadence;
+    uint32_t rejected;
+} run_t;
+
+static run_t run_trace(const char* name, const std::string& path, uint32_t batch = PEDO_FIFO_WATERMARK) {
+    trace_t t;
+    CHECK(load_trace(path, &t));
+    static step_detector_t sd;
+    detector_init(&sd);
+    int64_t us = 0;
+    const uint16_t cadence = replay(&sd, t, batch, &us);
+    print_replay(name, &sd, t.expected, us);
+    return { name, sd.steps, cadence, sd.rejected };
+}
+
+static void check_steps(const run_t& r, uint32_t expected, uint32_t tol) {
+    if ((uint32_t)std::abs((int)r.steps - (int)expected) > tol) {
+        fprintf(stderr, "%s: %u pasos, esperados %u ± %u\n", r.name, r.steps, expected, tol);
+    }
+    CHECK((uint32_t)std::abs((int)r.steps - (int)expected) <= tol);
+}
+
+static void test_walks() {
+    static const double wrist[3] = { 0.48, -0.36, 0.80 };
+    static const double flat[3] = { 0.0, 0.0, 1.0 };
+    static const double side[3] = { -1.0, 0.0, 0.0 };
+
+    // Cadencias de andar despacio a correr, 2 minutos cada una
+    static const double rates[] = { 1.0, 1.8, 2.8 };
+    static const double amps[] = { 0.15, 0.3, 0.6 };
+    for (int r = 0; r < 3; r++) {
+        const segment_t seg = { 120, rates[r], amps[r], false };
+        const uint32_t expected = walk_steps(seg.seconds, seg.step_hz);
+        char name[32];
+        snprintf(name, sizeof(name), "walk_%.1fhz.csv", rates[r]);
+        const run_t run = run_trace(name, write_trace(name, &seg, 1, wrist, expected, 0.02));
+        check_steps(run, expected, expected / 50 + 1);
+        const uint16_t spm = (uint16_t)lround(rates[r] * 60);
+        CHECK(std::abs((int)run.cadence - spm) <= spm / 20 + 1);
+    }
+
+    // La orientación del reloj no cambia el recuento
+    const segment_t seg = { 60, 1.8, 0.3, false };
+    const uint32_t expected = walk_steps(seg.seconds, seg.step_hz);
+    const run_t a = run_trace("flat.csv", write_trace("flat.csv", &seg, 1, flat, expected, 0.02));
+    const run_t b = run_trace("side.csv", write_trace("side.csv", &seg, 1, side, expected, 0.02));
+    check_steps(a, expected, 2);
+    check_steps(b, expected, 2);
+}
+
+static void test_bursts_and_idle() {
+    static const double g[3] = { 0.2, 0.3, 0.93 };
+
+    // Rachas de 20 s separadas por pausas de 10 s con una sacudida: como PEDOBENCH
+    std::vector<segment_t> segs;
+    uint32_t expected = 0;
+    for (int k = 0; k < 6; k++) {
+        segs.push_back({ 20, 1.8, 0.3, false });
+        segs.push_back({ 10, 0, 0, true });
+        expected += walk_steps(20, 1.8);
+    }
+    const run_t r = run_trace("bursts.csv", write_trace("bursts.csv", segs.data(), (uint32_t)segs.size(), g, expected, 0.02));
+    check_steps(r, expected, 6 * 2);
+    CHECK(r.cadence > 0);
+
+    // Quieto con sacudidas sueltas cada 3 s: ningún paso
+    segs.clear();
+    for (int k = 0; k < 40; k++) segs.push_back({ 3, 0, 0, true });
+    const run_t idle = run_trace("shakes.csv", write_trace("shakes.csv", segs.data(), (uint32_t)segs.size(), g, 0, 0.03));
+    CHECK_EQ(idle.steps, 0);
+
+    // Rachas de 3 pasos (menos que PEDO_CONFIRM_STEPS) con pausas de 3 s: se descartan
+    static_assert(PEDO_CONFIRM_STEPS > 3, "las rachas cortas tienen que quedar por debajo de la confirmación");
+    segs.clear();
+    for (int k = 0; k < 10; k++) {
+        segs.push_back({ 3 / 1.8, 1.8, 0.3, false });
+        segs.push_back({ 3, 0, 0, false });
+    }
+    const run_t shortr = run_trace("short.csv", write_trace("short.csv", segs.data(), (uint32_t)segs.size(), g, 0, 0.02));
+    CHECK_EQ(shortr.steps, 0);
+    CHECK(shortr.rejected > 0);
+}
+
+// El tamaño de lote no cambia nada: el estado entre lotes es el mismo
+static void test_batch_invariance() {
+    static const double g[3] = { 0.48, -0.36, 0.80 };
+    std::vector<segment_t> segs = { { 30, 2.0, 0.35, false }, { 5, 0, 0, true }, { 30, 1.5, 0.25, false } };
+    const std::string path = write_trace("batches.csv", segs.data(), (uint32_t)segs.size(), g, 0, 0.02);
+    trace_t t;
+    CHECK(load_trace(path, &t));
+
+    static step_detector_t ref, sd;
+    detector_init(&ref);
+    replay(&ref, t, (uint32_t)(t.xyz.size() / 3), nullptr);
+    for (uint32_t batch : { 1u, 7u, (uint32_t)PEDO_FIFO_WATERMARK, 32u }) {
+        detector_init(&sd);
+        replay(&sd, t, batch, nullptr);
+        CHECK_EQ(sd.steps, ref.steps);
+        CHECK_EQ(sd.rejected, ref.rejected);
+        CHECK_EQ(sd.lp, ref.lp);
+    }
+    CHECK(ref.steps > 0);
+
+    // reset deja el detector como recién creado
+    step_detector_reset(&sd);
+    CHECK_EQ(sd.steps, 0);
+    CHECK_EQ(step_detector_cadence(&sd), 0);
+}
+
+static void test_csv_format() {
+    const std::string path = tmp_dir + "/format.csv";
+    FILE* f = fopen(path.c_str(), "w");
+    fputs("# grabado a mano\nx,y,z\n\n1000,-500,0\n10,250,-1000,2000\n# steps=17\n99999,-99999,0\n", f);
+    fclose(f);
+    trace_t t;
+    CHECK(load_trace(path, &t));
+    CHECK(t.has_expected);
+    CHECK_EQ(t.expected, 17);
+    const int16_t want[] = { PEDO_LSB_PER_G, -PEDO_LSB_PER_G / 2, 0,
+                             PEDO_LSB_PER_G / 4, -PEDO_LSB_PER_G, 2 * PEDO_LSB_PER_G,
+                             INT16_MAX, INT16_MIN, 0 };
+    CHECK_EQ(t.xyz.size(), 9);
+    for (uint32_t i = 0; i < t.xyz.size() && i < 9; i++) CHECK_EQ(t.xyz[i], want[i]);
+}
+
+// Trazas grabadas: el error tiene que quedar en REPLAY_TOL_PCT
+static void replay_recorded(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        trace_t t;
+        CHECK(load_trace(argv[i], &t));
+        CHECK(t.has_expected);
+        static step_detector_t sd;
+        detector_init(&sd);
+        int64_t us = 0;
+        replay(&sd, t, PEDO_FIFO_WATERMARK, &us);
+        const char* name = strrchr(argv[i], '/');
+        print_replay(name ? name + 1 : argv[i], &sd, t.expected, us);
+        CHECK(std::abs((int)sd.steps - (int)t.expected) * 100 <= (int)t.expected * REPLAY_TOL_PCT);
+    }
+}
+
+int main(int argc, char** argv) {
+    printf("PEDOREPLAY,name,samples,steps,expected,error_pct_x100,rejected,ns_per_sample,cpu_pct_x1000\n");
+    if (argc > 1) {
+        replay_recorded(argc, argv);
+        return host_test_result();
+    }
+
+    char tmpl[] = "/tmp/step_detector_XXXXXX";
+    if (!mkdtemp(tmpl)) return 1;
+    tmp_dir = tmpl;
+    srand(1);
+
+    test_csv_format();
+    test_walks();
+    test_bursts_and_idle();
+    test_batch_invariance();
+
+    for (const char* name : { "format.csv", "walk_1.0hz.csv", "walk_1.8hz.csv", "walk_2.8hz.csv", "flat.csv",
+                              "side.csv", "bursts.csv", "shakes.csv", "short.csv", "batches.csv" }) {
+        unlink((tmp_dir + "/" + name).c_str());
+    }
+    rmdir(tmp_dir.c_str());
+    return host_test_result();
+}
@@ -0,0 +1,194 @@
+// Tema compartido: los estilos const dan los valores documentados, los de
+// label se crean una sola vez, theme_audit cuenta bien las propiedades
+// locales y ninguna vista deja color, fuente, borde, radio o padding como
+// propiedad local. Termina con el ahorro medido en un PC: N
+// labels con propiedades locales frente a N con el estilo compartido
+// (línea THEMEBENCH).
+
+#include "host_test.h"
+#include "views/theme/theme.h"
+#include "controllers/screen_manager/screen_manager.h"
+#include "config.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <cstdio>
+
+#define BENCH_LABELS 60         // Como la antigua cuadrícula de segundos
+#define BENCH_ROUNDS 200
+
+// Lo que el tema cubre: nada de esto debería quedar como propiedad local
+static const lv_style_prop_t theme_props[] = {
+    LV_STYLE_BG_COLOR, LV_STYLE_BG_OPA, LV_STYLE_TEXT_COLOR, LV_STYLE_TEXT_FONT,
+    LV_STYLE_BORDER_COLOR, LV_STYLE_BORDER_WIDTH, LV_STYLE_RADIUS,
+    LV_STYLE_PAD_TOP, LV_STYLE_PAD_BOTTOM, LV_STYLE_PAD_LEFT, LV_STYLE_PAD_RIGHT,
+};
+static const lv_style_selector_t theme_selectors[] = {
+    LV_PART_MAIN, LV_PART_MAIN | LV_STATE_CHECKED, LV_PART_INDICATOR, LV_PART_ITEMS, LV_PART_SCROLLBAR,
+};
+
+static uint32_t lv_heap_used() {
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    return mon.total_size - mon.free_size;
+}
+
+static lv_obj_tree_walk_res_t count_theme_locals_cb(lv_obj_t* obj, void* user) {
+    for (lv_style_selector_t sel : theme_selectors) {
+        for (lv_style_prop_t prop : theme_props) {
+            lv_style_value_t v;
+            if (lv_obj_get_local_style_prop(obj, prop, &v, sel) == LV_RESULT_OK) (*(uint32_t*)user)++;
+        }
+    }
+    return LV_OBJ_TREE_WALK_NEXT;
+}
+
+static uint32_t count_theme_locals(lv_obj_t* root) {
+    uint32_t n = 0;
+    lv_obj_tree_walk(root, count_theme_locals_cb, &n);
+    return n;
+}
+
+static bool style_has(const lv_style_t* style, lv_style_prop_t prop, lv_style_value_t* v) {
+    return lv_style_get_prop(style, prop, v) == LV_STYLE_RES_FOUND;
+}
+
+static void test_const_styles() {
+    const lv_style_t* consts[] = { &theme_screen, &theme_grid, &theme_grid_cell, &theme_panel_dark,
+                                   theme_label_style(THEME_LABEL_BODY) };
+    for (const lv_style_t* s : consts) CHECK(lv_style_is_const(s));
+
+    lv_style_value_t v;
+    CHECK(style_has(&theme_screen, LV_STYLE_BG_COLOR, &v) && lv_color_eq(v.color, lv_color_white()));
+    CHECK(style_has(&theme_panel_dark, LV_STYLE_PAD_LEFT, &v) && v.num == THEME_PANEL_PAD);
+    CHECK(style_has(&theme_panel_dark, LV_STYLE_PAD_BOTTOM, &v) && v.num == THEME_PANEL_PAD);
+    CHECK(!style_has(&theme_screen, LV_STYLE_TEXT_FONT, &v));
+
+    // La celda dibujada a mano sale del mismo estilo que una celda con lv_obj
+    lv_draw_rect_dsc_t dsc;
+    theme_cell_dsc(&dsc);
+    CHECK(style_has(&theme_grid_cell, LV_STYLE_RADIUS, &v) && dsc.radius == v.num);
+    CHECK(style_has(&theme_grid_cell, LV_STYLE_BORDER_WIDTH, &v) && dsc.border_width == v.num);
+    CHECK(style_has(&theme_grid_cell, LV_STYLE_BORDER_COLOR, &v) && lv_color_eq(dsc.border_color, v.color));
+    CHECK(style_has(&theme_grid_cell, LV_STYLE_BG_COLOR, &v) && lv_color_eq(dsc.bg_color, v.color));
+}
+
+static void test_label_styles() {
+    // Se crean una vez: las llamadas siguientes no reservan nada
+    const lv_style_t* first[THEME_LABEL_COUNT];
+    for (int k = 0; k < THEME_LABEL_COUNT; k++) first[k] = theme_label_style((theme_label_t)k);
+    const uint32_t used = lv_heap_used();
+    for (int k = 0; k < THEME_LABEL_COUNT; k++) CHECK(theme_label_style((theme_label_t)k) == first[k]);
+    CHECK_EQ(lv_heap_used(), used);
+
+    // Sin pack de assets en el PC: las fuentes integradas
+    lv_obj_t* root = lv_obj_create(nullptr);
+    lv_obj_t* title = lv_label_create(root);
+    lv_obj_t* key = lv_label_create(root);
+    lv_obj_t* value = lv_label_create(root);
+    theme_apply_label(title, THEME_LABEL_TITLE);
+    theme_apply_label(key, THEME_LABEL_KEY);
+    theme_apply_label(value, THEME_LABEL_VALUE);
+    CHECK(lv_obj_get_style_text_font(title, LV_PART_MAIN) == &lv_font_montserrat_24);
+    CHECK(lv_obj_get_style_text_font(key, LV_PART_MAIN) == &lv_font_montserrat_14);
+    CHECK(lv_color_eq(lv_obj_get_style_text_color(key, LV_PART_MAIN), lv_color_hex(0x404040)));
+    CHECK(lv_color_eq(lv_obj_get_style_text_color(value, LV_PART_MAIN), lv_color_black()));
+    CHECK_EQ(count_theme_locals(root), 0);
+    lv_obj_delete(root);
+}
+
+// Árbol con propiedades locales conocidas: dos en un hijo, una en el estado
+// CHECKED de otro y ninguna en la pantalla ni en el tercero
+static void test_audit_counts() {
+    lv_obj_t* root = lv_obj_create(nullptr);
+    lv_obj_t* a = lv_obj_create(root);
+    lv_obj_t* b = lv_obj_create(root);
+    lv_obj_t* c = lv_obj_create(root);
+    lv_obj_set_style_bg_color(a, lv_color_black(), LV_PART_MAIN);
+    lv_obj_set_style_radius(a, 5, LV_PART_MAIN);
+    lv_obj_set_style_text_color(b, lv_color_white(), LV_PART_MAIN | LV_STATE_CHECKED);
+
+    theme_audit_t audit;
+    theme_audit(root, 10, &audit);
+    CHECK_EQ(audit.objs, 4);
+    CHECK_EQ(audit.local_objs, 2);
+    CHECK_EQ(audit.local_props, 3);
+    CHECK_EQ(audit.lookups, 10 * 4 * 7);
+
+    // Otra parte del tercer hijo: un objeto y una propiedad más
+    lv_obj_set_style_bg_opa(c, LV_OPA_50, LV_PART_SCROLLBAR);
+    theme_audit(root, 0, &audit);
+    CHECK_EQ(audit.local_objs, 3);
+    CHECK_EQ(audit.local_props, 4);
+    CHECK_EQ(audit.lookups, 0);
+    CHECK_EQ(count_theme_locals(root), 4);
+    lv_obj_delete(root);
+}
+
+// Cada vista, una vez dibujada: ninguna propiedad del tema como local
+static void test_views() {
+    static const view_id_t views[] = { VIEW_BOOT, VIEW_CLOCK, VIEW_SETTINGS, VIEW_SYSTEM_INFO, VIEW_SPECTRUM };
+    for (view_id_t view : views) {
+        switch_screen(view);
+        for (int i = 0; i < 3; i++) {
+            vTaskDelay(pdMS_TO_TICKS(UI_REPLAY_FRAME_MS));
+            lv_timer_handler();
+        }
+        if (screen_get_current_view() != view) continue;   // Boot se va sola a Clock
+        const uint32_t locals = count_theme_locals(lv_screen_active());
+        if (locals) fprintf(stderr, "%s: %lu propiedades locales del tema\n", screen_get_view_name(view), (unsigned long)locals);
+        CHECK_EQ(locals, 0);
+    }
+}
+
+typedef struct {
+    uint32_t heap_bytes;
+    theme_audit_t audit;
+} label_bench_t;
+
+static void bench_labels(bool shared, label_bench_t* out) {
+    lv_obj_t* root = lv_obj_create(nullptr);
+    const uint32_t before = lv_heap_used();
+    for (int i = 0; i < BENCH_LABELS; i++) {
+        lv_obj_t* label = lv_label_create(root);
+        lv_label_set_text_static(label, "00");
+        if (shared) {
+            theme_apply_label(label, THEME_LABEL_VALUE);
+        } else {
+            lv_obj_set_style_text_font(label, &lv_font_montserrat_14, LV_PART_MAIN);
+            lv_obj_set_style_text_color(label, lv_color_black(), LV_PART_MAIN);
+        }
+    }
+    out->heap_bytes = lv_heap_used() - before;
+    theme_audit(root, BENCH_ROUNDS, &out->audit);
+    lv_obj_delete(root);
+}
+
+static void test_savings() {
+    theme_label_style(THEME_LABEL_VALUE);   // Creado fuera de la medida, como en la placa
+    label_bench_t local, shared;
+    bench_labels(false, &local);
+    bench_labels(true, &shared);
+
+    printf("THEMEBENCH,mode,labels,heap_bytes,local_props,resolve_ns_avg\n");
+    printf("THEMEBENCH,local,%d,%lu,%lu,%lu\n", BENCH_LABELS, (unsigned long)local.heap_bytes,
+           (unsigned long)local.audit.local_props, (unsigned long)local.audit.resolve_ns_avg);
+    printf("THEMEBENCH,shared,%d,%lu,%lu,%lu\n", BENCH_LABELS, (unsigned long)shared.heap_bytes,
+           (unsigned long)shared.audit.local_props, (unsigned long)shared.audit.resolve_ns_avg);
+
+    CHECK_EQ(local.audit.local_props - shared.audit.local_props, 2 * BENCH_LABELS);
+    CHECK(shared.heap_bytes < local.heap_bytes);
+    CHECK_EQ(shared.audit.lookups, local.audit.lookups);
+}
+
+int main() {
+    esp_log_level_set("*", ESP_LOG_WARN);
+    screen_init();
+
+    test_const_styles();
+    test_label_styles();
+    test_audit_counts();
+    test_views();
+    test_savings();
+    return host_test_result();
+}
@@ -0,0 +1,225 @@
+// ui_replay en el display sin panel: los escenarios recorren la navegación
+// sin errores ni fugas, dos ejecuciones dan los mismos frames y, al volver
+// al reloj normal, el tick de LVGL sigue desde donde lo dejó el reloj virtual
+// (antes volvía atrás y lv_tick_elaps daba saltos de 49 días). La pasada
+// completa compara con el baseline de ui_replay_baseline.csv, y un timer que
+// gasta tiempo en cada frame tiene que dar SLOW frente a un baseline sembrado.
+//
+//   test_ui_replay <ui_replay_baseline.csv>
+
+#include "host_test.h"
+#include "controllers/ui_replay/ui_replay.h"
+#include "controllers/screen_manager/screen_manager.h"
+#include "config.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <cstring>
+#include <vector>
+
+#define CYCLES 3
+
+static uint32_t timer_fires = 0;
+static uint32_t spin_us = 0;
+
+static void count_timer_cb(lv_timer_t*) {
+    timer_fires++;
+}
+
+// Vista que se ha vuelto más lenta: cada lv_timer_handler gasta 'spin_us' de
+// tiempo real, que es lo que mide replay_frame con esp_timer_get_time
+static void spin_timer_cb(lv_timer_t*) {
+    const int64_t until = esp_timer_get_time() + spin_us;
+    while (esp_timer_get_time() < until) {
+    }
+}
+
+static uint32_t low_tick_cb() {
+    return 5;
+}
+
+static const ui_replay_scenario_t* find_scenario(const char* name) {
+    for (uint32_t i = 0; i < ui_replay_scenario_count; i++) {
+        if (strcmp(ui_replay_scenarios[i].name, name) == 0) return &ui_replay_scenarios[i];
+    }
+    return nullptr;
+}
+
+// El reloj virtual avanza UI_REPLAY_FRAME_MS por frame sin vTaskDelay: al
+// acabar va por delante del normal y el tick debe quedarse ahí
+static void test_tick_resumes_forward(screen_t* screen) {
+    const ui_replay_scenario_t* boot = find_scenario("boot");
+    CHECK(boot != nullptr);
+    if (!boot) return;
+
+    lv_timer_t* timer = lv_timer_create(count_timer_cb, 100, nullptr);
+    const uint32_t before = lv_tick_get();
+    ui_replay_result_t r;
+    ui_replay_run_scenario(screen, boot, CYCLES, &r);
+    const uint32_t after = lv_tick_get();
+    CHECK_EQ(r.nav_errors, 0);
+    CHECK((int32_t)(after - before) >= (int32_t)(r.frames * UI_REPLAY_FRAME_MS));
+
+    // Desde ahí avanza con el reloj normal, sin saltos
+    vTaskDelay(pdMS_TO_TICKS(1000));
+    CHECK_EQ(lv_tick_get() - after, 1000);
+
+    // Un timer creado antes del replay sigue a su ritmo: 10 disparos en 1 s,
+    // no uno en cada lv_timer_handler como con un lv_tick_elaps enorme
+    lv_timer_handler();
+    timer_fires = 0;
+    for (int i = 0; i < 100; i++) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+        lv_timer_handler();
+    }
+    CHECK(timer_fires >= 9 && timer_fires <= 11);
+    lv_timer_delete(timer);
+
+    // Un reloj alternativo que va por detrás no mueve el normal
+    const uint32_t now = lv_tick_get();
+    screen_set_tick_cb(low_tick_cb);
+    CHECK_EQ(lv_tick_get(), 5);
+    screen_set_tick_cb(nullptr);
+    CHECK_EQ(lv_tick_get(), now);
+}
+
+// Los escenarios acaban en la vista esperada, sin objetos de más tras el
+// primer ciclo, y repetirlos da exactamente los mismos frames y objetos
+static void test_scenarios(screen_t* screen) {
+    for (uint32_t i = 0; i < ui_replay_scenario_count; i++) {
+        const ui_replay_scenario_t* scenario = &ui_replay_scenarios[i];
+        ui_replay_result_t first;
+        ui_replay_run_scenario(screen, scenario, CYCLES, &first);
+        CHECK_EQ(first.cycles, CYCLES);
+        CHECK_EQ(first.nav_errors, 0);
+        CHECK(first.frames > 0);
+        CHECK(first.objs_first > 0);
+        CHECK(first.objs_last <= first.objs_first);
+        CHECK((int32_t)(first.heap_last - first.heap_first) <= UI_REPLAY_LEAK_TOLERANCE_BYTES);
+        CHECK(first.lv_heap_peak >= first.heap_last);
+
+        ui_replay_result_t again;
+        ui_replay_run_scenario(screen, scenario, CYCLES, &again);
+        CHECK_EQ(again.frames, first.frames);
+        CHECK_EQ(again.switches, first.switches);
+        CHECK_EQ(again.objs_last, first.objs_last);
+        CHECK_EQ(again.nav_errors, 0);
+    }
+    // La navegación la cambian los escenarios con botones
+    const ui_replay_scenario_t* nav = find_scenario("nav_loop");
+    CHECK(nav != nullptr);
+    if (nav) {
+        ui_replay_result_t r;
+        ui_replay_run_scenario(screen, nav, 1, &r);
+        CHECK(r.switches >= 6);
+        CHECK_EQ(screen_get_current_view(), VIEW_CLOCK);
+    }
+}
+
+// Los límites de la comparación, sin LVGL de por medio
+static void test_compare() {
+    ui_replay_result_t r = {};
+    r.frames = 100;
+    r.objs_first = r.objs_last = 40;
+    r.heap_first = r.heap_last = 10000;
+    const ui_replay_baseline_t base = { 100, 1000, 2000, 20000 };
+
+    // Justo en el umbral pasa; un microsegundo o un byte más es SLOW
+    r.frame_us_avg = 1000 + 1000 * UI_REPLAY_THRESHOLD_PCT / 100 + UI_REPLAY_SLACK_US;
+    r.switch_us_avg = 2000 + 2000 * UI_REPLAY_THRESHOLD_PCT / 100 + UI_REPLAY_SLACK_US;
+    r.lv_heap_peak = 20000 + 20000 * UI_REPLAY_THRESHOLD_PCT / 100;
+    CHECK_EQ(ui_replay_compare(&r, &base), REPLAY_PASS);
+    r.frame_us_avg++;
+    CHECK_EQ(ui_replay_compare(&r, &base), REPLAY_SLOW);
+    r.frame_us_avg--;
+    r.switch_us_avg++;
+    CHECK_EQ(ui_replay_compare(&r, &base), REPLAY_SLOW);
+    r.switch_us_avg--;
+    r.lv_heap_peak++;
+    CHECK_EQ(ui_replay_compare(&r, &base), REPLAY_SLOW);
+
+    // Con lv_heap_peak = 0 en el baseline el heap no se compara
+    const ui_replay_baseline_t no_heap = { 100, 1000, 2000, 0 };
+    CHECK_EQ(ui_replay_compare(&r, &no_heap), REPLAY_PASS);
+
+    // Más rápido que el baseline también pasa
+    ui_replay_result_t fast = r;
+    fast.frame_us_avg = 10;
+    fast.switch_us_avg = 10;
+    fast.lv_heap_peak = 100;
+    CHECK_EQ(ui_replay_compare(&fast, &base), REPLAY_PASS);
+    CHECK_EQ(ui_replay_compare(&fast, nullptr), REPLAY_BASELINE);
+
+    // Fugas y navegación van antes que el tiempo
+    ui_replay_result_t leak = fast;
+    leak.heap_last += UI_REPLAY_LEAK_TOLERANCE_BYTES;
+    CHECK_EQ(ui_replay_compare(&leak, &base), REPLAY_PASS);
+    leak.heap_last++;
+    CHECK_EQ(ui_replay_compare(&leak, &base), REPLAY_LEAK);
+    leak = fast;
+    leak.objs_last++;
+    CHECK_EQ(ui_replay_compare(&leak, nullptr), REPLAY_LEAK);
+    leak.nav_errors = 1;
+    CHECK_EQ(ui_replay_compare(&leak, &base), REPLAY_NAV);
+}
+
+// El CSV del repositorio llega a db_manager y la pasada completa lo usa: los
+// frames coinciden (no se regraba como BASELINE) y todo cabe en el presupuesto
+static void test_checked_in_baseline(screen_t* screen, const char* path) {
+    CHECK_EQ(ui_replay_load_baselines("/nonexistent/ui_replay_baseline.csv"), ESP_ERR_NOT_FOUND);
+    CHECK_EQ(ui_replay_load_baselines(path), ESP_OK);
+
+    std::vector<ui_replay_status_t> statuses(ui_replay_scenario_count);
+    CHECK_EQ(ui_replay_run_all(screen, CYCLES, statuses.data()), 0);
+    for (uint32_t i = 0; i < ui_replay_scenario_count; i++) {
+        CHECK_EQ(statuses[i], REPLAY_PASS);
+    }
+}
+
+// Baseline sembrado con una vista que gasta SPIN_US por frame. Un 5 % más
+// queda dentro del umbral; un 50 % más tiene que dar SLOW en todos
+#define SPIN_US 3000
+
+static void test_slowdown(screen_t* screen) {
+    lv_timer_t* timer = lv_timer_create(spin_timer_cb, 0, nullptr);
+    spin_us = SPIN_US;
+    for (uint32_t i = 0; i < ui_replay_scenario_count; i++) {
+        ui_replay_result_t r;
+        ui_replay_run_scenario(screen, &ui_replay_scenarios[i], 1, &r);
+        CHECK(r.frame_us_avg >= SPIN_US);
+        const ui_replay_baseline_t base = { r.frames, r.frame_us_avg, r.switch_us_avg, r.lv_heap_peak };
+        CHECK_EQ(ui_replay_set_baseline(ui_replay_scenarios[i].name, &base), ESP_OK);
+    }
+
+    std::vector<ui_replay_status_t> statuses(ui_replay_scenario_count);
+    spin_us = SPIN_US * 105 / 100;
+    CHECK_EQ(ui_replay_run_all(screen, 1, statuses.data()), 0);
+    for (uint32_t i = 0; i < ui_replay_scenario_count; i++) {
+        CHECK_EQ(statuses[i], REPLAY_PASS);
+    }
+
+    spin_us = SPIN_US * 3 / 2;
+    CHECK_EQ(ui_replay_run_all(screen, 1, statuses.data()), ui_replay_scenario_count);
+    for (uint32_t i = 0; i < ui_replay_scenario_count; i++) {
+        CHECK_EQ(statuses[i], REPLAY_SLOW);
+    }
+    lv_timer_delete(timer);
+    spin_us = 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "uso: %s <ui_replay_baseline.csv>\n", argv[0]);
+        return 2;
+    }
+    esp_log_level_set("*", ESP_LOG_WARN);
+    screen_t* screen = screen_init();
+
+    test_compare();
+    test_tick_resumes_forward(screen);
+    test_scenarios(screen);
+    test_checked_in_baseline(screen, argv[1]);
+    test_slowdown(screen);
+    return host_test_result();
+}
@@ -0,0 +1,269 @@
+// VirtualList sobre el display sin panel: el pool no depende del número de
+// elementos, avanzar una fila cuesta un solo bind, cada fila enseña el
+// elemento k % pool en su sitio, la selección da la vuelta en los extremos y
+// al recortarse deja el resaltado en su fila, y un refresh sin cambios no
+// invalida nada. Recorrer la lista entera no deja memoria reservada en el
+// heap de LVGL.
+
+#include "host_test.h"
+#include "views/widgets/virtual_list/virtual_list.h"
+#include "controllers/screen_manager/screen_manager.h"
+#include "esp_log.h"
+#include <cstdio>
+#include <cstring>
+
+#define LIST_W 240
+#define LIST_H 200
+#define ROW_H 40
+#define ITEMS 10000
+
+static uint32_t value_offset = 0;
+static uint32_t activated = UINT32_MAX;
+static uint32_t activations = 0;
+static uint64_t invalidated_px = 0;
+
+static void bind(uint32_t index, char* title, char* value, size_t cap, void* user) {
+    (void)user;
+    snprintf(title, cap, "Item %lu", (unsigned long)index);
+    snprintf(value, cap, "%lu", (unsigned long)(index + value_offset));
+}
+
+static void on_activate(uint32_t index, void* user) {
+    (void)user;
+    activated = index;
+    activations++;
+}
+
+static void invalidate_cb(lv_event_t* e) {
+    const lv_area_t* area = (const lv_area_t*)lv_event_get_param(e);
+    if (area) invalidated_px += lv_area_get_size(area);
+}
+
+static uint32_t lv_heap_used() {
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    return mon.total_size - mon.free_size;
+}
+
+// Deja que las animaciones terminen y que el frame se dibuje
+static void run_frames(uint32_t ms) {
+    for (uint32_t t = 0; t < ms; t += 10) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+        lv_timer_handler();
+    }
+}
+
+// Las filas son los primeros hijos de la lista, en orden de pool; el
+// indicador de posición es el último
+static lv_obj_t* row_obj(VirtualList& list, uint32_t slot) {
+    return lv_obj_get_child(list.get_obj(), (int32_t)slot);
+}
+
+// Cada elemento visible está en su fila, con su texto y en su posición
+static void check_rows(VirtualList& list) {
+    const uint32_t pool = (uint32_t)list.get_row_pool();
+    const uint32_t first = (uint32_t)(list.get_scroll() / ROW_H);
+    lv_obj_update_layout(list.get_obj());
+    for (uint32_t k = first; k < first + pool && k < list.get_count(); k++) {
+        lv_obj_t* row = row_obj(list, k % pool);
+        char expect[VLIST_TEXT_MAX];
+        snprintf(expect, sizeof(expect), "Item %lu", (unsigned long)k);
+        CHECK(!lv_obj_has_flag(row, LV_OBJ_FLAG_HIDDEN));
+        CHECK(strcmp(lv_label_get_text(lv_obj_get_child(row, 0)), expect) == 0);
+        snprintf(expect, sizeof(expect), "%lu", (unsigned long)(k + value_offset));
+        CHECK(strcmp(lv_label_get_text(lv_obj_get_child(row, 1)), expect) == 0);
+        CHECK_EQ(lv_obj_get_y(row), (int32_t)k * ROW_H - list.get_scroll());
+        CHECK_EQ(lv_obj_has_state(row, LV_STATE_CHECKED), k == list.get_selected());
+    }
+}
+
+static uint32_t checked_rows(VirtualList& list) {
+    uint32_t n = 0;
+    for (uint32_t slot = 0; slot < list.get_row_pool(); slot++) {
+        lv_obj_t* row = row_obj(list, slot);
+        if (!lv_obj_has_flag(row, LV_OBJ_FLAG_HIDDEN) && lv_obj_has_state(row, LV_STATE_CHECKED)) n++;
+    }
+    return n;
+}
+
+static void test_recycling(lv_obj_t* screen) {
+    VirtualList list(screen, LIST_W, LIST_H, ROW_H, bind, nullptr);
+    const uint32_t pool = (uint32_t)list.get_row_pool();
+    CHECK_EQ(pool, (LIST_H + ROW_H - 1) / ROW_H + 1 + VLIST_MARGIN_ROWS);
+    CHECK_EQ(list.get_bind_count(), 0);
+
+    list.set_count(ITEMS);
+    CHECK_EQ(list.get_row_pool(), pool);
+    CHECK_EQ(list.get_bind_count(), pool);
+    check_rows(list);
+
+    // Una fila más abajo: un solo objeto cambia de elemento
+    uint32_t binds = list.get_bind_count();
+    list.scroll_to(ROW_H);
+    CHECK_EQ(list.get_bind_count() - binds, 1);
+    check_rows(list);
+
+    // Dentro de la misma fila solo se recolocan los objetos
+    binds = list.get_bind_count();
+    list.scroll_to(ROW_H + ROW_H / 2);
+    CHECK_EQ(list.get_bind_count(), binds);
+    check_rows(list);
+
+    // Un salto lejano reasigna como mucho el pool
+    binds = list.get_bind_count();
+    list.scroll_to(ITEMS / 2 * ROW_H + 7);
+    CHECK(list.get_bind_count() - binds <= pool);
+    check_rows(list);
+
+    // El desplazamiento se queda en los límites del contenido
+    list.scroll_to(INT32_MAX);
+    CHECK_EQ(list.get_scroll(), ITEMS * ROW_H - LIST_H);
+    check_rows(list);
+    list.scroll_to(-100);
+    CHECK_EQ(list.get_scroll(), 0);
+    check_rows(list);
+}
+
+static void test_selection(lv_obj_t* screen) {
+    VirtualList list(screen, LIST_W, LIST_H, ROW_H, bind, nullptr);
+    list.set_activate_cb(on_activate);
+    list.set_count(20);
+    run_frames(50);
+    CHECK_EQ(list.get_selected(), 0);
+    CHECK_EQ(checked_rows(list), 1);
+
+    // Del primero al último con la animación hasta dejarlo visible
+    list.select_prev();
+    CHECK_EQ(list.get_selected(), 19);
+    run_frames(VLIST_SCROLL_MS * 2);
+    CHECK_EQ(list.get_scroll(), 20 * ROW_H - LIST_H);
+    CHECK_EQ(checked_rows(list), 1);
+    check_rows(list);
+
+    list.select_next();
+    CHECK_EQ(list.get_selected(), 0);
+    run_frames(VLIST_SCROLL_MS * 2);
+    CHECK_EQ(list.get_scroll(), 0);
+    CHECK_EQ(checked_rows(list), 1);
+    check_rows(list);
+
+    // Bajar paso a paso desplaza lo justo: la seleccionada queda abajo del todo
+    for (int i = 0; i < 7; i++) list.select_next();
+    run_frames(VLIST_SCROLL_MS * 2);
+    CHECK_EQ(list.get_selected(), 7);
+    CHECK_EQ(list.get_scroll(), 8 * ROW_H - LIST_H);
+    CHECK_EQ(checked_rows(list), 1);
+    check_rows(list);
+
+    list.activate();
+    CHECK_EQ(activations, 1);
+    CHECK_EQ(activated, 7);
+
+    // Menos elementos: la selección y el desplazamiento se recortan y las
+    // filas sobrantes se ocultan
+    list.set_count(3);
+    CHECK_EQ(list.get_selected(), 2);
+    CHECK_EQ(list.get_scroll(), 0);
+    uint32_t visible = 0;
+    for (uint32_t slot = 0; slot < list.get_row_pool(); slot++) {
+        if (!lv_obj_has_flag(row_obj(list, slot), LV_OBJ_FLAG_HIDDEN)) visible++;
+    }
+    CHECK_EQ(visible, 3);
+    check_rows(list);
+
+    // Lista vacía: ni selección ni activación
+    list.set_count(0);
+    list.select_next();
+    list.activate();
+    CHECK_EQ(activations, 1);
+}
+
+// La selección se recorta a un elemento cuya fila ya estaba enlazada: el
+// resaltado tiene que pasar a esa fila aunque no haga falta un bind
+static void test_shrink_below_selection(lv_obj_t* screen) {
+    VirtualList list(screen, LIST_W, LIST_H, ROW_H, bind, nullptr);
+    list.set_count(20);
+    list.select(4, false);
+    run_frames(50);
+    CHECK_EQ(list.get_scroll(), 0);
+    CHECK(lv_obj_has_state(row_obj(list, 4), LV_STATE_CHECKED));
+
+    // Las filas 0..2 siguen enlazadas a los mismos elementos: sin binds nuevos
+    // en ellas, la fila 2 pasa a CHECKED y la 4 se oculta
+    list.set_count(3);
+    CHECK_EQ(list.get_selected(), 2);
+    CHECK(lv_obj_has_state(row_obj(list, 2), LV_STATE_CHECKED));
+    CHECK(!lv_obj_has_state(row_obj(list, 0), LV_STATE_CHECKED));
+    CHECK(!lv_obj_has_state(row_obj(list, 1), LV_STATE_CHECKED));
+    CHECK(lv_obj_has_flag(row_obj(list, 4), LV_OBJ_FLAG_HIDDEN));
+    CHECK_EQ(checked_rows(list), 1);
+    check_rows(list);
+
+    // Al volver a crecer, la fila que tenía la selección vieja no la conserva
+    list.set_count(20);
+    CHECK_EQ(list.get_selected(), 2);
+    CHECK(!lv_obj_has_state(row_obj(list, 4), LV_STATE_CHECKED));
+    CHECK_EQ(checked_rows(list), 1);
+    check_rows(list);
+
+    // Recorte con la lista desplazada: el último elemento ya estaba en el pool
+    list.select(12, false);
+    list.set_count(11);
+    CHECK_EQ(list.get_selected(), 10);
+    CHECK(lv_obj_has_state(row_obj(list, 10 % list.get_row_pool()), LV_STATE_CHECKED));
+    CHECK_EQ(checked_rows(list), 1);
+    check_rows(list);
+}
+
+static void test_refresh(lv_obj_t* screen) {
+    VirtualList list(screen, LIST_W, LIST_H, ROW_H, bind, nullptr);
+    list.set_count(ITEMS);
+    run_frames(50);
+
+    // Mismo texto: se vuelve a pedir, pero no se invalida nada
+    invalidated_px = 0;
+    const uint32_t binds = list.get_bind_count();
+    list.refresh();
+    CHECK_EQ(list.get_bind_count() - binds, list.get_row_pool());
+    CHECK_EQ(invalidated_px, 0);
+
+    // Texto nuevo: solo cambian los labels, dentro del área de la lista
+    value_offset = 1;
+    list.refresh();
+    CHECK(invalidated_px > 0);
+    CHECK(invalidated_px <= (uint64_t)LIST_W * LIST_H);
+    check_rows(list);
+    value_offset = 0;
+}
+
+static void test_memory(lv_obj_t* screen) {
+    VirtualList list(screen, LIST_W, LIST_H, ROW_H, bind, nullptr);
+    list.set_count(ITEMS);
+    run_frames(50);
+
+    const uint32_t used = lv_heap_used();
+    for (int32_t y = 0; y <= ITEMS * ROW_H - LIST_H; y += ROW_H * 7 + 3) {
+        list.scroll_to(y);
+        lv_timer_handler();
+    }
+    list.scroll_to(INT32_MAX);
+    run_frames(50);
+    CHECK_EQ(lv_heap_used(), used);
+}
+
+int main() {
+    esp_log_level_set("*", ESP_LOG_WARN);
+    screen_init();
+    lv_display_add_event_cb(lv_display_get_default(), invalidate_cb, LV_EVENT_INVALIDATE_AREA, nullptr);
+
+    lv_obj_t* screen = lv_obj_create(nullptr);
+    lv_screen_load(screen);
+    run_frames(50);
+
+    test_recycling(screen);
+    test_selection(screen);
+    test_shrink_below_selection(screen);
+    test_refresh(screen);
+    test_memory(screen);
+    return host_test_result();
+}
@@ -19,8 +19,31 @@
 #define BUTTON_OK_PIN      GPIO_NUM_5
 #define BUTTON_RIGHT_PIN   GPIO_NUM_4
 #define BUTTON_ON_OFF_PIN  GPIO_NUM_1
+#define BUTTON_POWER_SAVE_ENABLED  true   // Sin escaneo periódico mientras no se pulsa nada
 
 
+// Tarjeta SD por SPI (controllers/sd_card). GPIO 33-37 los usa la PSRAM octal
+#define SD_MOSI   GPIO_NUM_40
+#define SD_MISO   GPIO_NUM_41
+#define SD_SCLK   GPIO_NUM_39
+#define SD_CS     GPIO_NUM_42
+
+// Micrófono I2S (INMP441 o similar, L/R a GND → canal izquierdo)
+#define MIC_SCK   GPIO_NUM_15
+#define MIC_WS    GPIO_NUM_16
+#define MIC_SD    GPIO_NUM_17
+
+// Acelerómetro I2C del podómetro (LIS3DH, SA0 a GND)
+#define ACC_SDA   GPIO_NUM_18
+#define ACC_SCL   GPIO_NUM_21
+#define ACC_INT   GPIO_NUM_38     // INT1: watermark de la FIFO
+
+// Tira WS2812 (controllers/leds), GPIO_NUM_NC = sin tira
+#define LEDS_GPIO GPIO_NUM_48
+
+// Zumbador pasivo (controllers/buzzer), GPIO_NUM_NC = sin zumbador
+#define BUZZER_GPIO GPIO_NUM_2
+
 // Resolución de la pantalla
 #define SCREEN_WIDTH  240
 #define SCREEN_HEIGHT 240
@@ -30,4 +53,174 @@
 #define EXAMPLE_LCD_PIXEL_CLOCK_HZ     (40 * 1000 * 1000)
 #define EXAMPLE_LCD_BK_LIGHT_ON_LEVEL  1
 
+// Buffers de render por defecto (ver screen_render_mode_t en screen_manager.h)
+#define SCREEN_RENDER_MODE_DEFAULT     SCREEN_RENDER_PARTIAL
+#define SCREEN_STRIP_LINES             40
+#define SCREEN_BOUNCE_LINES            20
+// Invertir los bytes RGB565 antes de enviarlos (paneles big-endian). No aplica en modo DIRECT
+#define SCREEN_RGB565_SWAP             0
+
+// Heap de LVGL (controllers/mem_manager, CONFIG_LV_USE_CUSTOM_MALLOC)
+#define LVGL_MEM_INTERNAL_POOL_BYTES   (48 * 1024)
+#define LVGL_MEM_PSRAM_POOL_BYTES      (256 * 1024)
+#define LVGL_MEM_SMALL_MAX             256     // Hasta aquí, tier interno primero
+#define LVGL_MEM_ARENA_CHUNK_BYTES     2048
+#define LVGL_MEM_ARENA_MAX_ALLOC       512     // Bloques mayores no van a la arena
+#define LVGL_MEM_ARENA_MAX             8
+
+// Unidad de dibujo RGB565 propia para rellenos sólidos (controllers/draw_accel)
+#define DRAW_ACCEL_ENABLED             1
+#define DRAW_ACCEL_PIE_ENABLED         1
+
+// Pipeline de UI: render y transferencia en núcleos distintos
+#define UI_RENDER_CORE          1
+#define UI_FLUSH_CORE           0
+#define UI_FPS_CAP_DEFAULT      30
+#define UI_STRIP_SLOTS          3       // Strips en vuelo en modo PARTIAL (cada uno, una copia en RAM DMA)
+#define UI_IDLE_MAX_SLEEP_MS    1000    // Sueño máximo sin timers LVGL pendientes
+
+// Gestión de energía (requiere CONFIG_PM_ENABLE; light sleep automático en reposo)
+#define UI_PM_MIN_FREQ_MHZ      40
+#define UI_LIGHT_SLEEP_ENABLED  1
+
+// Caché de vistas: heap LVGL máximo que pueden ocupar las vistas suspendidas
+#define VIEW_CACHE_BUDGET_BYTES (24 * 1024)
+
+// Snapshots de navegación en PSRAM (una captura RGB565 de 240x240 ocupa 112.5 KB)
+#define NAV_SNAPSHOT_BUDGET_BYTES   (3 * SCREEN_WIDTH * SCREEN_HEIGHT * 2)
+#define NAV_TRANSITION_MS           200
+#define NAV_HISTORY_DEPTH           8
+
+// Reloj dibujado desde un atlas de glifos (0 = lv_label clásico, para comparar)
+#define CLOCK_DIGIT_ATLAS_ENABLED   1
+#define CLOCK_ATLAS_IN_PSRAM        1
+
+// Escritura asíncrona en SD: ring multi-productor + tarea writer
+#define SD_CARD_HOST                SPI3_HOST
+#define SD_CARD_MOUNT_POINT         "/sdcard"
+#define SD_CARD_MAX_FILES           4
+#define SD_CARD_RING_BYTES          (32 * 1024)   // Potencia de 2
+#define SD_CARD_RING_IN_PSRAM       1
+#define SD_CARD_STAGE_MAX_BYTES     (8 * 1024)    // Bloque por fichero: cluster de la FAT hasta este tope
+#define SD_CARD_FSYNC_INTERVAL_MS   2000          // Datos como mucho así de viejos sin llegar a la tarjeta
+#define SD_CARD_WRITER_PRIORITY     2             // Por debajo del pipeline de UI
+#define SD_CARD_WRITER_CORE         0
+#define SD_CARD_BENCH_BYTES         (256 * 1024)
+
+// Pack de assets mapeado desde flash (controllers/fs_manager, tools/pack_assets.py)
+#define FS_ASSET_PARTITION_LABEL    "assets"
+#define FS_ASSET_PARTITION_SUBTYPE  0x40
+#define FS_ASSET_BENCH_ITERATIONS   1000
+
+// Historial y ajustes en flash, log-structured (controllers/db_manager)
+#define DB_PARTITION_LABEL          "db"
+#define DB_PARTITION_SUBTYPE        0x41
+#define DB_SEGMENT_BYTES            (16 * 1024)   // Múltiplo del sector de 4 KB
+#define DB_BATCH_BYTES              2048          // Lote en RAM antes de forzar un commit
+#define DB_COMMIT_INTERVAL_MS       60000         // Como mucho un minuto de datos sin confirmar
+#define DB_RETENTION_S              (30 * 24 * 3600)
+#define DB_COMPACT_FREE_SEGMENTS    3             // Compactar en segundo plano por debajo de esto
+#define DB_TASK_PRIORITY            1
+#define DB_TASK_CORE                0
+#define DB_BENCH_SAMPLES            20000
+#define DB_BENCH_POWER_CUTS         50
+
+// Captura de audio y espectro (controllers/microphone, views/apps/spectrum)
+#define MIC_I2S_PORT                I2S_NUM_0
+#define MIC_SAMPLE_RATE             16000
+#define MIC_BLOCK_SAMPLES           256           // Potencia de 2: bloque DMA = tamaño de la FFT (16 ms)
+#define MIC_DMA_BLOCKS              6             // Margen de la tarea antes de que el DMA pise un bloque
+#define MIC_SPECTRUM_BANDS          16
+#define MIC_SPECTRUM_FLOOR_DB       (-80)
+#define MIC_TASK_PRIORITY           4             // Por debajo de render y flush, por encima del writer de SD
+#define MIC_TASK_CORE               0             // Fuera del núcleo de render
+#define MIC_VIEW_PERIOD_MS          (1000 / UI_FPS_CAP_DEFAULT)
+#define MIC_BENCH_BLOCKS            500
+
+// Podómetro (controllers/pedometer)
+#define PEDO_I2C_PORT               I2C_NUM_0
+#define PEDO_I2C_ADDR               0x18
+#define PEDO_SAMPLE_RATE            50
+#define PEDO_LSB_PER_G              8192          // ±4 g, dato justificado a la izquierda
+#define PEDO_FIFO_WATERMARK         25            // Muestras por lote: la tarea despierta 2 veces por segundo
+#define PEDO_MIN_AMPLITUDE_MG       120           // Pico-valle mínimo de un paso
+#define PEDO_CONFIRM_STEPS          4             // Pasos seguidos antes de empezar a contar una racha
+#define PEDO_TASK_PRIORITY          3
+#define PEDO_TASK_CORE              0
+#define PEDO_LOG_INTERVAL_S         60            // Pasos nuevos → db_manager
+#define PEDO_BENCH_SAMPLES          (30 * 60 * PEDO_SAMPLE_RATE)
+
+// Tira de LEDs (controllers/leds)
+#define LEDS_COUNT                  60            // Un LED por celda de la cuadrícula de segundos
+#define LEDS_FPS_DEFAULT            30
+#define LEDS_FPS_MAX                100           // Por encima no queda hueco de reset entre frames
+#define LEDS_BRIGHTNESS_DEFAULT     64
+#define LEDS_PERIOD_MS_DEFAULT      4000          // Vuelta del arcoíris / respiración
+#define LEDS_RMT_RESOLUTION_HZ      (10 * 1000 * 1000)
+#define LEDS_RMT_DMA                1
+#define LEDS_RMT_MEM_SYMBOLS        1024          // Con DMA: tamaño del buffer de símbolos
+#define LEDS_TASK_PRIORITY          2
+#define LEDS_TASK_CORE              0
+#define LEDS_BENCH_FRAMES           200
+
+// Zumbador (controllers/buzzer)
+#define BUZZER_LEDC_TIMER           LEDC_TIMER_0
+#define BUZZER_LEDC_CHANNEL         LEDC_CHANNEL_0
+#define BUZZER_VOLUME_LEVELS        4             // 0 = mudo
+#define BUZZER_VOLUME_DEFAULT       2
+#define BUZZER_KEY_CLICK_ENABLED    1             // Clic en cada pulsación despachada
+#define BUZZER_TASK_PRIORITY        7             // Solo aplica cambios de nota: por encima de render y flush
+#define BUZZER_TASK_CORE            0
+#define BUZZER_BENCH_STEPS          64
+
+// Lista virtual (views/widgets/virtual_list)
+#define VLIST_TEXT_MAX              32            // Bytes por texto de fila (título y valor)
+#define VLIST_MARGIN_ROWS           1             // Filas de más sobre las visibles
+#define VLIST_SCROLL_MS             120           // Animación al mover la selección
+#define VLIST_BENCH_ITEMS           10000
+#define VLIST_BENCH_STEP_PX         6             // Desplazamiento por frame del benchmark
+
+// Ajustes persistentes (claves de db_manager)
+#define SETTINGS_KEY_FPS_CAP        "ui.fps"
+#define SETTINGS_KEY_LEDS_FX        "leds.fx"
+#define SETTINGS_KEY_VOLUME         "snd.vol"
+
+// Benchmark de vistas al arrancar (salida CSV por consola)
+#define UI_BENCHMARK_ENABLED    0
+#define UI_BENCHMARK_FRAMES     60
+#define UI_BENCHMARK_FRAME_MS   (1000 / UI_FPS_CAP_DEFAULT)
+#define UI_BENCHMARK_INPUT_FRAMES 10      // Frames entre pulsaciones del script de cada vista
+#define UI_BENCHMARK_STRESS_CYCLES 1000   // Cambios de vista del stress de memoria (0 = no)
+#define THEME_AUDIT_ROUNDS      100       // Pasadas por el árbol al medir la resolución de estilos
+
+// Replay de scripts de navegación con reloj virtual (controllers/ui_replay)
+#define UI_REPLAY_CYCLES            20      // Ciclos por escenario (0 = no)
+#define UI_REPLAY_FRAME_MS          (1000 / UI_FPS_CAP_DEFAULT)
+#define UI_REPLAY_SETTLE_MS         500     // Frames extra tras el último paso de cada ciclo
+#define UI_REPLAY_THRESHOLD_PCT     15      // Empeoramiento tolerado respecto al baseline
+#define UI_REPLAY_SLACK_US          50      // Margen absoluto para tiempos muy cortos
+#define UI_REPLAY_LEAK_TOLERANCE_BYTES 256  // Heap de LVGL que puede variar entre ciclos (textos)
+#define UI_REPLAY_UPDATE_BASELINE   0       // 1 = grabar los resultados como nuevo baseline
+
+// Telemetría de campo (controllers/telemetry): SystemInfoView y comando "telemetry"
+#define TELEMETRY_ENABLED           1
+#define TELEMETRY_PERIOD_MS         1000
+#define TELEMETRY_HISTORY           60      // Muestras para mín/máx/media
+#define TELEMETRY_MAX_TASKS         32      // Debe cubrir todas las tareas del sistema
+#define TELEMETRY_CONSOLE_ENABLED   1       // REPL por UART con el comando "telemetry"
+#define TELEMETRY_VIEW_TASKS        4       // Tareas (las de más CPU) en SystemInfoView
+
+// Log diferido (controllers/dlog): DLOGx guarda registros binarios, la tarea 'dlog' formatea
+#define DLOG_ENABLED                1       // 0 = las macros DLOGx son ESP_LOGx
+#define DLOG_RING_BYTES             4096    // Por núcleo, potencia de 2
+#define DLOG_MAX_WORDS              8       // Palabras de 32 bits de argumentos por registro
+#define DLOG_LINE_MAX               160     // Línea formateada (se corta si no cabe)
+#define DLOG_TASK_PRIORITY          1       // Por debajo de la UI y de los controladores
+#define DLOG_TASK_CORE              0
+#define DLOG_BENCH_CALLS            200
+
+// Profiler de frames del display (0 = sin coste, las macros desaparecen)
+#define DISPLAY_PROFILER_ENABLED    0
+#define DISPLAY_PROFILER_RING_SIZE  64
+
 #endif // CONFIG_H
\ No newline at end of file
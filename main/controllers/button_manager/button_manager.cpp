@@ -1,18 +1,57 @@
 #include "controllers/button_manager/button_manager.h"
+#include "controllers/buzzer/buzzer.h"
+#include "controllers/dlog/dlog.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "utils/spsc_queue.h"
+#include <atomic>
 #include <cassert>
 
 static const char *TAG = "BTN_MGR";
 
+#define BUTTON_EVENT_QUEUE_SIZE 16
+
+typedef struct {
+    button_id_t button;
+    int64_t timestamp_us;
+} button_event_t;
+
 static button_handle_t buttons[BUTTON_COUNT];
-static button_handlers_t button_handlers[BUTTON_COUNT] = { {nullptr, nullptr} }; // Estructura para ambos handlers
+static button_handler_t default_handlers[BUTTON_COUNT] = { nullptr };
+static std::atomic<const button_handler_t*> view_handlers{nullptr};
 
+// Productor: callback de iot_button. Consumidor: tarea de UI.
+static SpscQueue<button_event_t, BUTTON_EVENT_QUEUE_SIZE> event_queue;
+// Productor: ui_replay u otra tarea de pruebas. Cola aparte para no tener dos
+// productores sobre event_queue.
+static SpscQueue<button_event_t, BUTTON_EVENT_QUEUE_SIZE> inject_queue;
+static std::atomic<uint32_t> dropped_events{0};
+static std::atomic<TaskHandle_t> wakeup_task{nullptr};
+static button_latency_stats_t latency_stats = {};
+static uint64_t latency_total_us = 0;
 
-static void default_button_left_handler() { ESP_LOGI(TAG, "Botón LEFT (Default)"); }
-static void default_button_cancel_handler() { ESP_LOGI(TAG, "Botón CANCEL (Default)"); }
-static void default_button_ok_handler() { ESP_LOGI(TAG, "Botón OK (Default)"); }
-static void default_button_right_handler() { ESP_LOGI(TAG, "Botón RIGHT (Default)"); }
-static void default_button_on_off_handler() { ESP_LOGI(TAG, "Botón ON/OFF (Default)"); }
+static void default_button_left_handler() { DLOGI(TAG, "Botón LEFT (Default)"); }
+static void default_button_cancel_handler() { DLOGI(TAG, "Botón CANCEL (Default)"); }
+static void default_button_ok_handler() { DLOGI(TAG, "Botón OK (Default)"); }
+static void default_button_right_handler() { DLOGI(TAG, "Botón RIGHT (Default)"); }
+static void default_button_on_off_handler() { DLOGI(TAG, "Botón ON/OFF (Default)"); }
+
+// Callback permanente: solo encola el evento con su marca de tiempo.
+// No se llama a LVGL ni a switch_screen desde el contexto de iot_button.
+static void button_event_cb(void* arg, void* usr_data) {
+    const button_event_t event = {
+        .button = (button_id_t)(intptr_t)usr_data,
+        .timestamp_us = esp_timer_get_time(),
+    };
+    if (!event_queue.push(event)) {
+        dropped_events++;
+    }
+
+    TaskHandle_t task = wakeup_task.load();
+    if (task) {
+        xTaskNotifyGive(task);
+    }
+}
 
 void button_manager_init() {
     button_config_t btn_config = {
@@ -20,16 +59,22 @@ void button_manager_init() {
         .short_press_time = 0,
     };
     
+    // Con power save iot_button para su timer de escaneo cuando no hay pulsaciones
+    // y despierta por interrupción GPIO (también desde light sleep)
     const button_gpio_config_t gpio_config[BUTTON_COUNT] = {
-        {BUTTON_LEFT_PIN, 0, false, false},   // BUTTON_LEFT
-        {BUTTON_CANCEL_PIN, 0, false, false}, // BUTTON_CANCEL
-        {BUTTON_OK_PIN, 0, false, false},     // BUTTON_OK
-        {BUTTON_RIGHT_PIN, 0, false, false},  // BUTTON_RIGHT
-        {BUTTON_ON_OFF_PIN, 0, false, false}  // BUTTON_ON_OFF
+        {BUTTON_LEFT_PIN, 0, BUTTON_POWER_SAVE_ENABLED, false},   // BUTTON_LEFT
+        {BUTTON_CANCEL_PIN, 0, BUTTON_POWER_SAVE_ENABLED, false}, // BUTTON_CANCEL
+        {BUTTON_OK_PIN, 0, BUTTON_POWER_SAVE_ENABLED, false},     // BUTTON_OK
+        {BUTTON_RIGHT_PIN, 0, BUTTON_POWER_SAVE_ENABLED, false},  // BUTTON_RIGHT
+        {BUTTON_ON_OFF_PIN, 0, BUTTON_POWER_SAVE_ENABLED, false}  // BUTTON_ON_OFF
     };
 
     for (int i = 0; i < BUTTON_COUNT; i++) {
         ESP_ERROR_CHECK(iot_button_new_gpio_device(&btn_config, &gpio_config[i], &buttons[i]));
+
+        // Un único callback por botón durante toda la vida del programa
+        ESP_ERROR_CHECK(iot_button_register_cb(buttons[i], BUTTON_SINGLE_CLICK, NULL,
+                                               button_event_cb, (void*)(intptr_t)i));
     }
     
     // Registrar handlers por defecto
@@ -42,95 +87,71 @@ void button_manager_init() {
 
 void button_manager_register_default_handler(button_id_t button, button_handler_t handler) {
     if (button < BUTTON_COUNT) {
-        ESP_LOGI(TAG, "Registrando handler por defecto para el botón %d", button);
-        button_handlers[button].default_handler = handler;
-        
-        // Registrar solo si no hay handler de vista
-        if (!button_handlers[button].view_handler) {
-            esp_err_t err = iot_button_register_cb(
-                buttons[button], 
-                BUTTON_SINGLE_CLICK,
-                NULL,
-                [](void* arg, void* usr_data) {
-                    ((button_handler_t)usr_data)();
-                },
-                (void*)handler
-            );
-            if (err != ESP_OK) {
-                ESP_LOGE(TAG, "Error al registrar handler por defecto: %s", esp_err_to_name(err));
-            } else {
-                ESP_LOGI(TAG, "Handler por defecto registrado correctamente para el botón %d", button);
-            }
-        } else {
-            ESP_LOGI(TAG, "No se registra handler por defecto para el botón %d porque ya hay un handler de vista", button);
-        }
+        DLOGI(TAG, "Registrando handler por defecto para el botón %d", button);
+        default_handlers[button] = handler;
     }
 }
 
-void button_manager_register_view_handler(button_id_t button, button_handler_t handler) {
-    if (button < BUTTON_COUNT) {
-        ESP_LOGI(TAG, "Registrando handler de vista para el botón %d", button);
-
-        // 1. Desregistrar handler por defecto si está registrado
-        if (button_handlers[button].default_handler) {
-            esp_err_t err = iot_button_unregister_cb(buttons[button], BUTTON_SINGLE_CLICK, NULL);
-            if (err != ESP_OK) {
-                ESP_LOGE(TAG, "Error al desregistrar handler por defecto: %s", esp_err_to_name(err));
-            } else {
-                ESP_LOGI(TAG, "Handler por defecto desregistrado correctamente para el botón %d", button);
-            }
-        }
+void button_manager_set_view_handlers(const button_handler_t* handlers) {
+    view_handlers.store(handlers, std::memory_order_release);
+}
 
-        // 2. Registrar nuevo handler de vista
-        button_handlers[button].view_handler = handler;
-        esp_err_t err = iot_button_register_cb(
-            buttons[button], 
-            BUTTON_SINGLE_CLICK,
-            NULL,
-            [](void* arg, void* usr_data) {
-                ((button_handler_t)usr_data)();
-            },
-            (void*)handler
-        );
-        if (err != ESP_OK) {
-            ESP_LOGE(TAG, "Error al registrar handler de vista: %s", esp_err_to_name(err));
-        } else {
-            ESP_LOGI(TAG, "Handler de vista registrado correctamente para el botón %d", button);
-        }
+bool button_manager_inject(button_id_t button) {
+    if (button >= BUTTON_COUNT) return false;
+    const button_event_t event = {
+        .button = button,
+        .timestamp_us = esp_timer_get_time(),
+    };
+    if (!inject_queue.push(event)) {
+        dropped_events++;
+        return false;
+    }
+
+    TaskHandle_t task = wakeup_task.load();
+    if (task) {
+        xTaskNotifyGive(task);
     }
+    return true;
 }
 
-void button_manager_unregister_view_handlers() {
-    for (int i = 0; i < BUTTON_COUNT; i++) {
-        if (button_handlers[i].view_handler) {
-            ESP_LOGI(TAG, "Desregistrando handler de vista para el botón %d", i);
-
-            // 1. Eliminar handler de vista
-            esp_err_t err = iot_button_unregister_cb(buttons[i], BUTTON_SINGLE_CLICK, NULL);
-            if (err != ESP_OK) {
-                ESP_LOGE(TAG, "Error al desregistrar handler de vista: %s", esp_err_to_name(err));
-            } else {
-                ESP_LOGI(TAG, "Handler de vista desregistrado correctamente para el botón %d", i);
-            }
-            button_handlers[i].view_handler = nullptr;
-            
-            // 2. Restaurar handler por defecto si existe
-            if (button_handlers[i].default_handler) {
-                err = iot_button_register_cb(
-                    buttons[i], 
-                    BUTTON_SINGLE_CLICK,
-                    NULL,
-                    [](void* arg, void* usr_data) {
-                        ((button_handler_t)usr_data)();
-                    },
-                    (void*)button_handlers[i].default_handler
-                );
-                if (err != ESP_OK) {
-                    ESP_LOGE(TAG, "Error al restaurar handler por defecto: %s", esp_err_to_name(err));
-                } else {
-                    ESP_LOGI(TAG, "Handler por defecto restaurado correctamente para el botón %d", i);
-                }
-            }
+// Saca el siguiente evento; los reales van antes que los inyectados
+static bool pop_event(button_event_t& event) {
+    return event_queue.pop(event) || inject_queue.pop(event);
+}
+
+void button_manager_process_events() {
+    button_event_t event;
+    while (pop_event(event)) {
+        const button_handler_t* table = view_handlers.load(std::memory_order_acquire);
+        button_handler_t handler = (table && table[event.button]) ? table[event.button] : default_handlers[event.button];
+#if BUZZER_KEY_CLICK_ENABLED
+        // Solo encola: el clic lo secuencia el gptimer del zumbador
+        buzzer_play(buzzer_melody_click, true);
+#endif
+        if (handler) {
+            handler();
+        }
+
+        const uint32_t latency = (uint32_t)(esp_timer_get_time() - event.timestamp_us);
+        latency_stats.events++;
+        latency_stats.last_us = latency;
+        latency_total_us += latency;
+        latency_stats.avg_us = (uint32_t)(latency_total_us / latency_stats.events);
+        if (latency_stats.min_us == 0 || latency < latency_stats.min_us) {
+            latency_stats.min_us = latency;
+        }
+        if (latency > latency_stats.max_us) {
+            latency_stats.max_us = latency;
         }
     }
-}
\ No newline at end of file
+}
+
+void button_manager_set_wakeup_task(TaskHandle_t task) {
+    wakeup_task = task;
+}
+
+void button_manager_get_latency_stats(button_latency_stats_t* out) {
+    if (!out) return;
+    *out = latency_stats;
+    out->dropped = dropped_events.load();
+}
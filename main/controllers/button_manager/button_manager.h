@@ -4,6 +4,8 @@
 #include "iot_button.h"
 #include "button_gpio.h"
 #include "config.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 
 typedef enum {
     BUTTON_LEFT = 0,
@@ -16,15 +18,36 @@ typedef enum {
 
 typedef void (*button_handler_t)(void);
 
-// Nuevo: Tipo para almacenar ambos tipos de handlers
+// Latencia desde la pulsación (callback de iot_button) hasta que el handler termina
 typedef struct {
-    button_handler_t default_handler;
-    button_handler_t view_handler;
-} button_handlers_t;
+    uint32_t events;        // Eventos despachados
+    uint32_t dropped;       // Eventos perdidos por cola llena
+    uint32_t last_us;
+    uint32_t min_us;
+    uint32_t avg_us;
+    uint32_t max_us;
+} button_latency_stats_t;
 
 void button_manager_init();
 void button_manager_register_default_handler(button_id_t button, button_handler_t handler);
-void button_manager_register_view_handler(button_id_t button, button_handler_t handler);
-void button_manager_unregister_view_handlers();
 
-#endif
\ No newline at end of file
+// Tabla de handlers de la vista activa (BUTTON_COUNT entradas, nullptr = usar el
+// handler por defecto). Cambiar de tabla es O(1) y no toca iot_button.
+// La tabla debe seguir viva mientras esté instalada (normalmente static const).
+void button_manager_set_view_handlers(const button_handler_t* handlers);
+
+// Encola una pulsación como si viniera de iot_button: pasa por el mismo
+// despacho (handlers de la vista, clic, latencia). Para scripts de prueba
+// (controllers/ui_replay); un solo productor. false = cola llena.
+bool button_manager_inject(button_id_t button);
+
+// Despacha los eventos pendientes. Llamar una vez por frame desde la tarea de UI.
+void button_manager_process_events();
+
+// Tarea a la que se envía una notificación con cada pulsación, para que pueda
+// dormir hasta su próximo deadline sin perder entradas (nullptr = ninguna).
+void button_manager_set_wakeup_task(TaskHandle_t task);
+
+void button_manager_get_latency_stats(button_latency_stats_t* out);
+
+#endif
@@ -0,0 +1,305 @@
+#include "buzzer.h"
+#include "driver/gptimer.h"
+#include "driver/ledc.h"
+#include "esp_check.h"
+#include "esp_cpu.h"
+#include "esp_log.h"
+#include "esp_pm.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <atomic>
+#include <cstdio>
+
+static const char* TAG = "BUZZER";
+
+#define BUZZER_TASK_STACK       2560
+#define BUZZER_TIMER_HZ         (1000 * 1000)   // Una cuenta por µs: el reloj del secuenciador
+#define BUZZER_LEDC_MIN_HZ      100             // Por debajo, el divisor de LEDC a 10 bits no llega
+#define BUZZER_NO_TONE          0xFFFFFFFFu
+
+// Duty de cada nivel de volumen (10 bits). Un zumbador pasivo suena más fuerte al 50 %.
+static const uint16_t volume_duty[BUZZER_VOLUME_LEVELS] = { 0, 8, 64, 512 };
+
+static std::atomic<const buzzer_backend_t*> backend{nullptr};
+static gptimer_handle_t timer = nullptr;
+static TaskHandle_t buzzer_task = nullptr;
+static buzzer_seq_t seq;
+static std::atomic<uint8_t> volume{BUZZER_VOLUME_DEFAULT};
+
+// Último cambio de tono del ISR: frecuencia en los 16 bits altos e instante
+// programado (µs módulo 65536) en los bajos. Solo importa el último.
+static std::atomic<uint32_t> pending_tone{BUZZER_NO_TONE};
+static std::atomic<bool> kick_requested{false};
+static bool timer_running = false;     // Solo lo toca la tarea 'buzzer'
+
+#if CONFIG_PM_ENABLE
+// Mientras suena: APB fijo para LEDC (con DFS cambiaría la frecuencia) y sin light sleep
+static esp_pm_lock_handle_t pm_lock = nullptr;
+#endif
+
+static buzzer_stats_t stats = {};
+static uint64_t late_total_us = 0;
+static std::atomic<uint32_t> isr_cycles_max{0};
+static portMUX_TYPE stats_mux = portMUX_INITIALIZER_UNLOCKED;
+
+// --- Backends -------------------------------------------------------------------
+
+static esp_err_t ledc_backend_init() {
+    ledc_timer_config_t timer_cfg = {};
+    timer_cfg.speed_mode = LEDC_LOW_SPEED_MODE;
+    timer_cfg.duty_resolution = LEDC_TIMER_10_BIT;
+    timer_cfg.timer_num = BUZZER_LEDC_TIMER;
+    timer_cfg.freq_hz = 2000;
+    timer_cfg.clk_cfg = LEDC_AUTO_CLK;
+    ESP_RETURN_ON_ERROR(ledc_timer_config(&timer_cfg), TAG, "ledc timer");
+
+    ledc_channel_config_t chan_cfg = {};
+    chan_cfg.gpio_num = BUZZER_GPIO;
+    chan_cfg.speed_mode = LEDC_LOW_SPEED_MODE;
+    chan_cfg.channel = BUZZER_LEDC_CHANNEL;
+    chan_cfg.timer_sel = BUZZER_LEDC_TIMER;
+    chan_cfg.duty = 0;
+    chan_cfg.hpoint = 0;
+    return ledc_channel_config(&chan_cfg);
+}
+
+static void ledc_backend_tone(uint16_t freq_hz, uint16_t duty) {
+    if (freq_hz < BUZZER_LEDC_MIN_HZ || duty == 0) {
+        duty = 0;
+    } else {
+        ledc_set_freq(LEDC_LOW_SPEED_MODE, BUZZER_LEDC_TIMER, freq_hz);
+    }
+    ledc_set_duty(LEDC_LOW_SPEED_MODE, BUZZER_LEDC_CHANNEL, duty);
+    ledc_update_duty(LEDC_LOW_SPEED_MODE, BUZZER_LEDC_CHANNEL);
+}
+
+const buzzer_backend_t buzzer_ledc_backend = { "ledc", ledc_backend_init, ledc_backend_tone };
+
+static esp_err_t null_backend_init() { return ESP_OK; }
+static void null_backend_tone(uint16_t, uint16_t) {}
+
+const buzzer_backend_t buzzer_null_backend = { "null", null_backend_init, null_backend_tone };
+
+// --- Secuenciador en el ISR -----------------------------------------------------
+// El ISR del gptimer no es IRAM-safe (CONFIG_GPTIMER_ISR_IRAM_SAFE desactivado):
+// durante una escritura en flash se retrasa, y la melodía recupera el paso perdido
+// porque cada nota se programa desde el final teórico de la anterior.
+
+static void isr_tone(uint16_t freq_hz, uint64_t at_us, void* ctx) {
+    pending_tone.store(((uint32_t)freq_hz << 16) | (uint16_t)at_us, std::memory_order_release);
+    vTaskNotifyGiveFromISR(buzzer_task, (BaseType_t*)ctx);
+}
+
+static bool buzzer_on_alarm(gptimer_handle_t t, const gptimer_alarm_event_data_t* edata, void*) {
+    const uint32_t c0 = esp_cpu_get_cycle_count();
+    BaseType_t woken = pdFALSE;
+
+    const uint64_t next = buzzer_seq_advance(&seq, edata->count_value, isr_tone, &woken);
+    if (next) {
+        gptimer_alarm_config_t alarm = {};
+        alarm.alarm_count = next;
+        gptimer_set_alarm_action(t, &alarm);
+    } else {
+        gptimer_set_alarm_action(t, nullptr);   // Sin melodía no hay más interrupciones
+    }
+
+    const uint32_t cycles = esp_cpu_get_cycle_count() - c0;
+    if (cycles > isr_cycles_max.load(std::memory_order_relaxed)) {
+        isr_cycles_max.store(cycles, std::memory_order_relaxed);
+    }
+    return woken == pdTRUE;
+}
+
+// --- Tarea ----------------------------------------------------------------------
+
+static void timer_on() {
+    if (timer_running) return;
+#if CONFIG_PM_ENABLE
+    esp_pm_lock_acquire(pm_lock);
+#endif
+    gptimer_enable(timer);
+    gptimer_start(timer);
+    timer_running = true;
+}
+
+// El gptimer activo retiene su propio lock de PM: solo se deja encendido mientras suena algo
+static void timer_off() {
+    if (!timer_running) return;
+    gptimer_stop(timer);
+    gptimer_disable(timer);
+#if CONFIG_PM_ENABLE
+    esp_pm_lock_release(pm_lock);
+#endif
+    timer_running = false;
+}
+
+static void buzzer_task_fn(void*) {
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        if (kick_requested.exchange(false)) {
+            timer_on();
+            // Alarma en la cuenta actual: ya alcanzada, el ISR salta enseguida y
+            // atiende el comando nuevo aunque hubiera otra alarma programada
+            uint64_t now;
+            gptimer_get_raw_count(timer, &now);
+            gptimer_alarm_config_t alarm = {};
+            alarm.alarm_count = now;
+            gptimer_set_alarm_action(timer, &alarm);
+        }
+
+        const uint32_t tone = pending_tone.exchange(BUZZER_NO_TONE, std::memory_order_acquire);
+        if (tone != BUZZER_NO_TONE) {
+            const uint16_t freq_hz = (uint16_t)(tone >> 16);
+            backend.load()->tone(freq_hz, freq_hz ? volume_duty[volume.load()] : 0);
+
+            uint64_t now;
+            gptimer_get_raw_count(timer, &now);
+            const uint32_t late = (uint16_t)((uint16_t)now - (uint16_t)tone);
+            taskENTER_CRITICAL(&stats_mux);
+            stats.tones++;
+            late_total_us += late;
+            if (late > stats.late_us_max) stats.late_us_max = late;
+            taskEXIT_CRITICAL(&stats_mux);
+        }
+
+        // Lecturas del estado del ISR sin lock: si un comando llega justo después,
+        // trae su propio aviso y vuelve a encender el timer
+        if (timer_running && seq.freq_hz == 0 && buzzer_seq_is_idle(&seq) && !kick_requested.load()) {
+            timer_off();
+        }
+    }
+}
+
+// --- API ------------------------------------------------------------------------
+
+esp_err_t buzzer_init() {
+    if (BUZZER_GPIO == GPIO_NUM_NC) return buzzer_init_with_backend(&buzzer_null_backend);
+    return buzzer_init_with_backend(&buzzer_ledc_backend);
+}
+
+esp_err_t buzzer_init_with_backend(const buzzer_backend_t* be) {
+    if (buzzer_task) return ESP_OK;
+
+    esp_err_t err = be->init();
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Sin zumbador (%s): %s", be->name, esp_err_to_name(err));
+        return err;
+    }
+    backend = be;
+    buzzer_seq_init(&seq);
+
+    // XTAL: la frecuencia no cambia con DFS y el timer no retiene APB al máximo
+    gptimer_config_t timer_cfg = {};
+    timer_cfg.clk_src = GPTIMER_CLK_SRC_XTAL;
+    timer_cfg.direction = GPTIMER_COUNT_UP;
+    timer_cfg.resolution_hz = BUZZER_TIMER_HZ;
+    ESP_RETURN_ON_ERROR(gptimer_new_timer(&timer_cfg, &timer), TAG, "gptimer");
+    gptimer_event_callbacks_t cbs = {};
+    cbs.on_alarm = buzzer_on_alarm;
+    ESP_RETURN_ON_ERROR(gptimer_register_event_callbacks(timer, &cbs, nullptr), TAG, "gptimer cb");
+#if CONFIG_PM_ENABLE
+    ESP_RETURN_ON_ERROR(esp_pm_lock_create(ESP_PM_APB_FREQ_MAX, 0, "buzzer", &pm_lock), TAG, "pm lock");
+#endif
+
+    if (xTaskCreatePinnedToCore(buzzer_task_fn, "buzzer", BUZZER_TASK_STACK, nullptr, BUZZER_TASK_PRIORITY,
+                                &buzzer_task, BUZZER_TASK_CORE) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    ESP_LOGI(TAG, "%s en GPIO %d, volumen %d", be->name, BUZZER_GPIO, BUZZER_VOLUME_DEFAULT);
+    return ESP_OK;
+}
+
+bool buzzer_is_running() {
+    return buzzer_task != nullptr;
+}
+
+bool buzzer_play(const buzzer_step_t* melody, bool interrupt) {
+    if (!buzzer_task || volume.load() == 0) return false;
+    if (!buzzer_seq_post(&seq, melody, interrupt)) return false;
+    kick_requested.store(true);
+    xTaskNotifyGive(buzzer_task);
+    return true;
+}
+
+void buzzer_stop() {
+    if (!buzzer_task) return;
+    buzzer_seq_post(&seq, nullptr, true);
+    kick_requested.store(true);
+    xTaskNotifyGive(buzzer_task);
+}
+
+bool buzzer_is_idle() {
+    return !buzzer_task || (buzzer_seq_is_idle(&seq) && !timer_running);
+}
+
+void buzzer_set_volume(uint8_t level) {
+    volume = level < BUZZER_VOLUME_LEVELS ? level : BUZZER_VOLUME_LEVELS - 1;
+}
+
+uint8_t buzzer_get_volume() {
+    return volume.load();
+}
+
+void buzzer_get_stats(buzzer_stats_t* out) {
+    taskENTER_CRITICAL(&stats_mux);
+    *out = stats;
+    const uint64_t late_total = late_total_us;
+    taskEXIT_CRITICAL(&stats_mux);
+    const buzzer_backend_t* be = backend.load();
+    out->backend = be ? be->name : "-";
+    out->played = seq.played;
+    out->preempted = seq.preempted;
+    out->dropped = seq.dropped;
+    out->late_us_avg = out->tones ? (uint32_t)(late_total / out->tones) : 0;
+    out->isr_cycles_max = isr_cycles_max.load();
+}
+
+void buzzer_reset_stats() {
+    taskENTER_CRITICAL(&stats_mux);
+    stats = {};
+    late_total_us = 0;
+    taskEXIT_CRITICAL(&stats_mux);
+    isr_cycles_max = 0;
+}
+
+// --- Benchmark ------------------------------------------------------------------
+
+void buzzer_benchmark(uint32_t steps) {
+    static buzzer_step_t melody[BUZZER_BENCH_STEPS + 1];
+    if (steps > BUZZER_BENCH_STEPS) steps = BUZZER_BENCH_STEPS;
+    if (!buzzer_task && buzzer_init_with_backend(&buzzer_null_backend) != ESP_OK) return;
+
+    // Notas de 5 a 20 ms con silencios entre medias: muchos cambios seguidos
+    uint32_t total_ms = 0;
+    for (uint32_t i = 0; i < steps; i++) {
+        melody[i].note = (i % 4 == 3) ? BUZZER_NOTE_REST : (uint8_t)(72 + (i * 7) % 24);
+        melody[i].ms = (uint16_t)(5 + (i * 11) % 16);
+        total_ms += melody[i].ms;
+    }
+    melody[steps] = { 0, 0 };
+
+    // Sin salida real mientras se mide; el volumen no puede ser 0 o no se encola
+    const buzzer_backend_t* previous = backend.exchange(&buzzer_null_backend);
+    const uint8_t previous_volume = volume.exchange(BUZZER_VOLUME_LEVELS - 1);
+    while (!buzzer_is_idle()) vTaskDelay(pdMS_TO_TICKS(10));
+    buzzer_reset_stats();
+
+    const uint32_t c0 = esp_cpu_get_cycle_count();
+    buzzer_play(melody, false);
+    const uint32_t post_cycles = esp_cpu_get_cycle_count() - c0;
+
+    const TickType_t deadline = xTaskGetTickCount() + pdMS_TO_TICKS(total_ms + 1000);
+    while (!buzzer_is_idle() && xTaskGetTickCount() < deadline) vTaskDelay(pdMS_TO_TICKS(10));
+
+    buzzer_stats_t st;
+    buzzer_get_stats(&st);
+    printf("BUZZBENCH,steps,duration_ms,tones,late_us_avg,late_us_max,isr_cycles_max,post_cycles\n");
+    printf("BUZZBENCH,%lu,%lu,%lu,%lu,%lu,%lu,%lu\n", (unsigned long)steps, (unsigned long)total_ms,
+           (unsigned long)st.tones, (unsigned long)st.late_us_avg, (unsigned long)st.late_us_max,
+           (unsigned long)st.isr_cycles_max, (unsigned long)post_cycles);
+
+    backend = previous;
+    volume = previous_volume;
+}
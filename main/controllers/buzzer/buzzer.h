@@ -0,0 +1,56 @@
+#ifndef BUZZER_H
+#define BUZZER_H
+
+#include "esp_err.h"
+#include "config.h"
+#include "buzzer_seq.h"
+#include <stdint.h>
+
+// Zumbador pasivo con PWM de LEDC. Quien quiera un sonido encola la melodía en
+// O(1) y sigue (buzzer_play no bloquea ni toca el periférico). El secuenciador
+// corre en el ISR de un gptimer cuya alarma se programa en el siguiente cambio
+// de nota: sin melodía no hay interrupciones. Cada cambio se pasa por
+// notificación a la tarea 'buzzer', que reprograma el PWM.
+
+// Salida de tono. 'tone' se llama desde la tarea 'buzzer', nunca desde el ISR.
+typedef struct {
+    const char* name;
+    esp_err_t (*init)();
+    void (*tone)(uint16_t freq_hz, uint16_t duty);  // freq_hz o duty 0 = silencio
+} buzzer_backend_t;
+
+extern const buzzer_backend_t buzzer_ledc_backend;
+extern const buzzer_backend_t buzzer_null_backend;     // Sin salida (benchmark, placas sin zumbador)
+
+typedef struct {
+    const char* backend;
+    uint32_t played;
+    uint32_t preempted;
+    uint32_t dropped;
+    uint32_t tones;             // Cambios aplicados al backend
+    uint32_t late_us_avg;       // Retraso entre el instante programado y el aplicado
+    uint32_t late_us_max;
+    uint32_t isr_cycles_max;
+} buzzer_stats_t;
+
+esp_err_t buzzer_init();
+esp_err_t buzzer_init_with_backend(const buzzer_backend_t* backend);
+bool buzzer_is_running();
+
+// Productor: la tarea de UI (handlers de botones). 'interrupt' corta lo que
+// suene; si no, la melodía espera a que termine la anterior.
+bool buzzer_play(const buzzer_step_t* melody, bool interrupt);
+void buzzer_stop();
+bool buzzer_is_idle();
+
+// 0 = mudo .. BUZZER_VOLUME_LEVELS - 1
+void buzzer_set_volume(uint8_t level);
+uint8_t buzzer_get_volume();
+
+void buzzer_get_stats(buzzer_stats_t* out);
+void buzzer_reset_stats();
+
+// Melodía de prueba sobre buzzer_null_backend: retraso de cada cambio y coste de buzzer_play
+void buzzer_benchmark(uint32_t steps);
+
+#endif
@@ -0,0 +1,101 @@
+#include "buzzer_seq.h"
+
+// Temperamento igual, La4 = 440 Hz, redondeado a Hz enteros
+static const uint16_t note_hz[128] = {
+        0,     9,     9,    10,    10,    11,    12,    12,    13,    14,    15,    15,
+       16,    17,    18,    19,    21,    22,    23,    24,    26,    28,    29,    31,
+       33,    35,    37,    39,    41,    44,    46,    49,    52,    55,    58,    62,
+       65,    69,    73,    78,    82,    87,    92,    98,   104,   110,   117,   123,
+      131,   139,   147,   156,   165,   175,   185,   196,   208,   220,   233,   247,
+      262,   277,   294,   311,   330,   349,   370,   392,   415,   440,   466,   494,
+      523,   554,   587,   622,   659,   698,   740,   784,   831,   880,   932,   988,
+     1047,  1109,  1175,  1245,  1319,  1397,  1480,  1568,  1661,  1760,  1865,  1976,
+     2093,  2217,  2349,  2489,  2637,  2794,  2960,  3136,  3322,  3520,  3729,  3951,
+     4186,  4435,  4699,  4978,  5274,  5588,  5920,  6272,  6645,  7040,  7459,  7902,
+     8372,  8870,  9397,  9956, 10548, 11175, 11840, 12544,
+};
+
+const buzzer_step_t buzzer_melody_click[] = { { 96, 12 }, { 0, 0 } };
+const buzzer_step_t buzzer_melody_confirm[] = { { 88, 60 }, { 0, 20 }, { 93, 90 }, { 0, 0 } };
+const buzzer_step_t buzzer_melody_error[] = { { 76, 120 }, { 0, 40 }, { 71, 200 }, { 0, 0 } };
+const buzzer_step_t buzzer_melody_startup[] = {
+    { 84, 80 }, { 88, 80 }, { 91, 80 }, { 96, 160 }, { 0, 0 }
+};
+
+uint16_t buzzer_note_hz(uint8_t note) {
+    return note < 128 ? note_hz[note] : 0;
+}
+
+void buzzer_seq_init(buzzer_seq_t* seq) {
+    seq->has_next = false;
+    seq->step = nullptr;
+    seq->step_end_us = 0;
+    seq->freq_hz = 0;
+    seq->played = 0;
+    seq->preempted = 0;
+    seq->dropped = 0;
+}
+
+bool buzzer_seq_post(buzzer_seq_t* seq, const buzzer_step_t* melody, bool interrupt) {
+    if (!seq->queue.push({ melody, interrupt })) {
+        seq->dropped++;
+        return false;
+    }
+    return true;
+}
+
+bool buzzer_seq_is_idle(const buzzer_seq_t* seq) {
+    return seq->step == nullptr && !seq->has_next && seq->queue.empty();
+}
+
+// Solo se avisa al backend si la frecuencia cambia
+static void set_freq(buzzer_seq_t* seq, uint16_t hz, uint64_t at_us, buzzer_tone_fn tone, void* ctx) {
+    if (hz == seq->freq_hz) return;
+    seq->freq_hz = hz;
+    tone(hz, at_us, ctx);
+}
+
+static void start(buzzer_seq_t* seq, const buzzer_step_t* melody, uint64_t now_us, buzzer_tone_fn tone, void* ctx) {
+    if (!melody || melody->ms == 0) {
+        seq->step = nullptr;
+        set_freq(seq, 0, now_us, tone, ctx);
+        return;
+    }
+    seq->step = melody;
+    seq->step_end_us = now_us + (uint64_t)melody->ms * 1000;
+    set_freq(seq, buzzer_note_hz(melody->note), now_us, tone, ctx);
+}
+
+uint64_t buzzer_seq_advance(buzzer_seq_t* seq, uint64_t now_us, buzzer_tone_fn tone, void* ctx) {
+    // Una melodía que espera turno empieza justo donde acabó la anterior
+    uint64_t idle_at = now_us;
+    for (;;) {
+        // Un comando de adelanto: si interrumpe, empieza ya; si no, cuando acabe la melodía
+        if (!seq->has_next && seq->queue.pop(seq->next)) {
+            seq->has_next = true;
+        }
+        if (seq->has_next && (seq->step == nullptr || seq->next.interrupt)) {
+            if (seq->step) seq->preempted++;
+            seq->has_next = false;
+            start(seq, seq->next.melody, seq->step ? now_us : idle_at, tone, ctx);
+            continue;
+        }
+
+        if (seq->step == nullptr) return 0;
+        if (now_us < seq->step_end_us) return seq->step_end_us;
+
+        // Paso terminado. El siguiente empieza en el instante programado, no en
+        // 'now_us': la latencia del ISR no se acumula a lo largo de la melodía.
+        const uint64_t at = seq->step_end_us;
+        seq->step++;
+        if (seq->step->ms == 0) {
+            seq->step = nullptr;
+            seq->played++;
+            idle_at = at;
+            set_freq(seq, 0, at, tone, ctx);
+            continue;
+        }
+        seq->step_end_us = at + (uint64_t)seq->step->ms * 1000;
+        set_freq(seq, buzzer_note_hz(seq->step->note), at, tone, ctx);
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef BUZZER_SEQ_H
+#define BUZZER_SEQ_H
+
+// Secuenciador de melodías sin dependencias de ESP-IDF ni de FreeRTOS: el
+// mismo código corre en el ISR del gptimer y en un PC con un reloj simulado.
+//
+// Los productores encolan comandos en O(1) (SpscQueue, sin locks). El
+// consumidor llama a buzzer_seq_advance con el instante actual; la función
+// aplica los cambios de nota pendientes por el callback 'tone' y devuelve el
+// instante del siguiente cambio, que es cuando hay que volver a llamarla.
+
+#include "utils/spsc_queue.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define BUZZER_SEQ_QUEUE_DEPTH  8
+#define BUZZER_NOTE_REST        0       // Nota MIDI 0 = silencio
+
+// Un paso de melodía. Las melodías terminan en un paso con ms == 0.
+typedef struct {
+    uint8_t note;                       // MIDI (69 = La 440 Hz)
+    uint16_t ms;
+} buzzer_step_t;
+
+typedef struct {
+    const buzzer_step_t* melody;        // nullptr = parar
+    bool interrupt;                     // Corta la melodía en curso en vez de esperar a que acabe
+} buzzer_cmd_t;
+
+// Cambio de frecuencia (0 = silencio). 'at_us' es el instante programado del cambio.
+typedef void (*buzzer_tone_fn)(uint16_t freq_hz, uint64_t at_us, void* ctx);
+
+typedef struct {
+    SpscQueue<buzzer_cmd_t, BUZZER_SEQ_QUEUE_DEPTH> queue;
+    buzzer_cmd_t next;                  // Comando sacado de la cola que espera turno
+    bool has_next;
+    const buzzer_step_t* step;          // Paso en curso (nullptr = parado)
+    uint64_t step_end_us;
+    uint16_t freq_hz;                   // Última frecuencia enviada
+    uint32_t played;                    // Melodías terminadas
+    uint32_t preempted;                 // Melodías cortadas por un comando 'interrupt'
+    uint32_t dropped;                   // Comandos perdidos por cola llena
+} buzzer_seq_t;
+
+void buzzer_seq_init(buzzer_seq_t* seq);
+
+// Productor (un solo hilo). O(1) y sin bloqueo. false si la cola está llena.
+bool buzzer_seq_post(buzzer_seq_t* seq, const buzzer_step_t* melody, bool interrupt);
+
+// Consumidor. Devuelve el instante del siguiente cambio o 0 si no queda nada.
+// Se puede llamar antes de tiempo: entonces solo atiende los comandos nuevos.
+uint64_t buzzer_seq_advance(buzzer_seq_t* seq, uint64_t now_us, buzzer_tone_fn tone, void* ctx);
+
+bool buzzer_seq_is_idle(const buzzer_seq_t* seq);
+
+// Frecuencia de una nota MIDI (tabla precalculada, 0 para BUZZER_NOTE_REST)
+uint16_t buzzer_note_hz(uint8_t note);
+
+// Melodías de la interfaz
+extern const buzzer_step_t buzzer_melody_click[];
+extern const buzzer_step_t buzzer_melody_confirm[];
+extern const buzzer_step_t buzzer_melody_error[];
+extern const buzzer_step_t buzzer_melody_startup[];
+
+#endif
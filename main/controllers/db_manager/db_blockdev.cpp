@@ -0,0 +1,251 @@
+#include "db_blockdev.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+#ifdef ESP_PLATFORM
+#include "esp_partition.h"
+#include "esp_heap_caps.h"
+#endif
+
+// --- Helpers comunes: contadores y corte de alimentación ---------------------
+
+int db_blockdev_read(db_blockdev_t* dev, uint32_t offset, void* dst, uint32_t len) {
+    if (offset + len > dev->size) return -1;
+    dev->bytes_read += len;
+    return dev->read(dev, offset, dst, len);
+}
+
+int db_blockdev_write(db_blockdev_t* dev, uint32_t offset, const void* src, uint32_t len) {
+    if (offset + len > dev->size || dev->powered_off) return -1;
+
+    if (dev->power_cut_after && len >= dev->power_cut_after) {
+        // Solo llega a la flash el principio de la escritura
+        const uint32_t partial = dev->power_cut_after - 1;
+        if (partial) {
+            dev->write(dev, offset, src, partial);
+            dev->bytes_written += partial;
+        }
+        dev->power_cut_after = 0;
+        dev->powered_off = true;
+        return -1;
+    }
+    if (dev->power_cut_after) {
+        dev->power_cut_after -= len;
+    }
+
+    dev->bytes_written += len;
+    return dev->write(dev, offset, src, len);
+}
+
+int db_blockdev_erase(db_blockdev_t* dev, uint32_t offset, uint32_t len) {
+    if (offset % dev->erase_size || len % dev->erase_size || offset + len > dev->size) return -1;
+    if (dev->powered_off) return -1;
+
+    const uint32_t sectors = len / dev->erase_size;
+    if (dev->erase_cut_after && sectors >= dev->erase_cut_after) {
+        // Los sectores anteriores al corte se borran; el del corte, a medias.
+        // Solo RAM y fichero aceptan medio sector (la simulación no se usa sobre la partición).
+        const uint32_t done = dev->erase_cut_after - 1;
+        if (done) dev->erase(dev, offset, done * dev->erase_size);
+        dev->erase(dev, offset + done * dev->erase_size, dev->erase_size / 2);
+        dev->erases += done;
+        dev->erase_cut_after = 0;
+        dev->powered_off = true;
+        return -1;
+    }
+    if (dev->erase_cut_after) {
+        dev->erase_cut_after -= sectors;
+    }
+
+    dev->erases += sectors;
+    return dev->erase(dev, offset, len);
+}
+
+void db_blockdev_power_cut_after(db_blockdev_t* dev, uint32_t bytes) {
+    dev->power_cut_after = bytes;
+}
+
+void db_blockdev_erase_cut_after(db_blockdev_t* dev, uint32_t sectors) {
+    dev->erase_cut_after = sectors;
+}
+
+void db_blockdev_power_restore(db_blockdev_t* dev) {
+    dev->power_cut_after = 0;
+    dev->erase_cut_after = 0;
+    dev->powered_off = false;
+}
+
+void db_blockdev_destroy(db_blockdev_t* dev) {
+    if (dev && dev->destroy) {
+        dev->destroy(dev);
+    }
+}
+
+static db_blockdev_t* blockdev_alloc(const char* name, uint32_t size, uint32_t erase_size) {
+    db_blockdev_t* dev = (db_blockdev_t*)calloc(1, sizeof(db_blockdev_t));
+    if (dev) {
+        dev->name = name;
+        dev->size = size;
+        dev->erase_size = erase_size;
+    }
+    return dev;
+}
+
+// --- RAM (PSRAM en el dispositivo) -----------------------------------------
+
+static int ram_read(db_blockdev_t* dev, uint32_t offset, void* dst, uint32_t len) {
+    memcpy(dst, (const uint8_t*)dev->ctx + offset, len);
+    return 0;
+}
+
+static int ram_write(db_blockdev_t* dev, uint32_t offset, const void* src, uint32_t len) {
+    uint8_t* mem = (uint8_t*)dev->ctx + offset;
+    const uint8_t* s = (const uint8_t*)src;
+    for (uint32_t i = 0; i < len; i++) {
+        mem[i] &= s[i];   // NOR: solo 1 -> 0
+    }
+    return 0;
+}
+
+static int ram_erase(db_blockdev_t* dev, uint32_t offset, uint32_t len) {
+    memset((uint8_t*)dev->ctx + offset, 0xFF, len);
+    return 0;
+}
+
+static void ram_destroy(db_blockdev_t* dev) {
+#ifdef ESP_PLATFORM
+    heap_caps_free(dev->ctx);
+#else
+    free(dev->ctx);
+#endif
+    free(dev);
+}
+
+db_blockdev_t* db_blockdev_ram_create(uint32_t size, uint32_t erase_size) {
+    db_blockdev_t* dev = blockdev_alloc("ram", size, erase_size);
+    if (!dev) return nullptr;
+#ifdef ESP_PLATFORM
+    dev->ctx = heap_caps_malloc(size, MALLOC_CAP_SPIRAM);
+    if (!dev->ctx) dev->ctx = heap_caps_malloc(size, MALLOC_CAP_8BIT);
+#else
+    dev->ctx = malloc(size);
+#endif
+    if (!dev->ctx) {
+        free(dev);
+        return nullptr;
+    }
+    memset(dev->ctx, 0xFF, size);
+    dev->read = ram_read;
+    dev->write = ram_write;
+    dev->erase = ram_erase;
+    dev->destroy = ram_destroy;
+    return dev;
+}
+
+// --- Fichero (stdio: VFS de la SD o un PC) -----------------------------------
+// Cada escritura y cada borrado terminan en fflush + fsync. db_store cuenta con
+// que, como en la flash, lo que vuelve está escrito y en orden: sin el fsync
+// un corte podría dejar en el medio el COMMIT de un lote y no sus registros.
+
+static int file_sync(FILE* f) {
+    return fflush(f) == 0 && fsync(fileno(f)) == 0 ? 0 : -1;
+}
+
+static int file_read(db_blockdev_t* dev, uint32_t offset, void* dst, uint32_t len) {
+    FILE* f = (FILE*)dev->ctx;
+    if (fseek(f, offset, SEEK_SET) != 0) return -1;
+    return fread(dst, 1, len, f) == len ? 0 : -1;
+}
+
+static int file_write(db_blockdev_t* dev, uint32_t offset, const void* src, uint32_t len) {
+    // NOR: leer, AND y reescribir por trozos
+    FILE* f = (FILE*)dev->ctx;
+    const uint8_t* s = (const uint8_t*)src;
+    uint8_t buf[256];
+    while (len > 0) {
+        const uint32_t n = len < sizeof(buf) ? len : sizeof(buf);
+        if (fseek(f, offset, SEEK_SET) != 0 || fread(buf, 1, n, f) != n) return -1;
+        for (uint32_t i = 0; i < n; i++) buf[i] &= s[i];
+        if (fseek(f, offset, SEEK_SET) != 0 || fwrite(buf, 1, n, f) != n) return -1;
+        offset += n;
+        s += n;
+        len -= n;
+    }
+    return file_sync(f);
+}
+
+static int file_fill(FILE* f, uint32_t offset, uint32_t len) {
+    uint8_t ff[256];
+    memset(ff, 0xFF, sizeof(ff));
+    if (fseek(f, offset, SEEK_SET) != 0) return -1;
+    while (len > 0) {
+        const uint32_t n = len < sizeof(ff) ? len : sizeof(ff);
+        if (fwrite(ff, 1, n, f) != n) return -1;
+        len -= n;
+    }
+    return file_sync(f);
+}
+
+static int file_erase(db_blockdev_t* dev, uint32_t offset, uint32_t len) {
+    return file_fill((FILE*)dev->ctx, offset, len);
+}
+
+static void file_destroy(db_blockdev_t* dev) {
+    fclose((FILE*)dev->ctx);
+    free(dev);
+}
+
+db_blockdev_t* db_blockdev_file_open(const char* path, uint32_t size, uint32_t erase_size) {
+    FILE* f = fopen(path, "r+b");
+    if (!f) {
+        f = fopen(path, "w+b");
+        if (!f || file_fill(f, 0, size) != 0) {
+            if (f) fclose(f);
+            return nullptr;
+        }
+    }
+    db_blockdev_t* dev = blockdev_alloc("file", size, erase_size);
+    if (!dev) {
+        fclose(f);
+        return nullptr;
+    }
+    dev->ctx = f;
+    dev->read = file_read;
+    dev->write = file_write;
+    dev->erase = file_erase;
+    dev->destroy = file_destroy;
+    return dev;
+}
+
+// --- Partición de flash --------------------------------------------------------
+
+#ifdef ESP_PLATFORM
+static int part_read(db_blockdev_t* dev, uint32_t offset, void* dst, uint32_t len) {
+    return esp_partition_read((const esp_partition_t*)dev->ctx, offset, dst, len) == ESP_OK ? 0 : -1;
+}
+
+static int part_write(db_blockdev_t* dev, uint32_t offset, const void* src, uint32_t len) {
+    return esp_partition_write((const esp_partition_t*)dev->ctx, offset, src, len) == ESP_OK ? 0 : -1;
+}
+
+static int part_erase(db_blockdev_t* dev, uint32_t offset, uint32_t len) {
+    return esp_partition_erase_range((const esp_partition_t*)dev->ctx, offset, len) == ESP_OK ? 0 : -1;
+}
+
+db_blockdev_t* db_blockdev_partition_open(const char* label, uint8_t subtype) {
+    const esp_partition_t* part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                                           (esp_partition_subtype_t)subtype, label);
+    if (!part) return nullptr;
+
+    db_blockdev_t* dev = blockdev_alloc("partition", part->size, part->erase_size);
+    if (!dev) return nullptr;
+    dev->ctx = (void*)part;
+    dev->read = part_read;
+    dev->write = part_write;
+    dev->erase = part_erase;
+    dev->destroy = [](db_blockdev_t* d) { free(d); };
+    return dev;
+}
+#endif
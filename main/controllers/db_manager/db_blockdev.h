@@ -0,0 +1,57 @@
+#ifndef DB_BLOCKDEV_H
+#define DB_BLOCKDEV_H
+
+// Dispositivo de bloques con semántica de flash NOR: borrar pone los bytes
+// a 0xFF y escribir solo puede pasar bits de 1 a 0. db_store trabaja
+// siempre sobre esta interfaz, así que el mismo código corre sobre la
+// partición, sobre RAM o sobre un fichero (tarjeta SD o un PC).
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct db_blockdev db_blockdev_t;
+
+struct db_blockdev {
+    const char* name;
+    uint32_t size;
+    uint32_t erase_size;
+    // 0 = OK, < 0 = error. Offsets y longitudes de erase, múltiplos de erase_size
+    int (*read)(db_blockdev_t* dev, uint32_t offset, void* dst, uint32_t len);
+    int (*write)(db_blockdev_t* dev, uint32_t offset, const void* src, uint32_t len);
+    int (*erase)(db_blockdev_t* dev, uint32_t offset, uint32_t len);
+    void (*destroy)(db_blockdev_t* dev);
+    void* ctx;
+
+    // Contadores (los actualizan los helpers db_blockdev_*)
+    uint64_t bytes_read;
+    uint64_t bytes_written;
+    uint32_t erases;
+
+    // Simulación de corte de alimentación: la escritura que alcance el byte número
+    // 'power_cut_after' (contando desde que se arma) se queda a medias y el dispositivo
+    // no acepta más escrituras ni borrados hasta db_blockdev_power_restore(). 0 = desactivada.
+    uint32_t power_cut_after;
+    // Igual para borrados, contando sectores: el sector número 'erase_cut_after' se
+    // queda borrado solo en su primera mitad y los siguientes del mismo borrado, intactos
+    uint32_t erase_cut_after;
+    bool powered_off;
+};
+
+int db_blockdev_read(db_blockdev_t* dev, uint32_t offset, void* dst, uint32_t len);
+int db_blockdev_write(db_blockdev_t* dev, uint32_t offset, const void* src, uint32_t len);
+int db_blockdev_erase(db_blockdev_t* dev, uint32_t offset, uint32_t len);
+void db_blockdev_power_cut_after(db_blockdev_t* dev, uint32_t bytes);
+void db_blockdev_erase_cut_after(db_blockdev_t* dev, uint32_t sectors);
+void db_blockdev_power_restore(db_blockdev_t* dev);
+void db_blockdev_destroy(db_blockdev_t* dev);
+
+// Dispositivos. Devuelven nullptr si falla la reserva o la apertura.
+db_blockdev_t* db_blockdev_ram_create(uint32_t size, uint32_t erase_size);
+// Fichero de 'size' bytes; se crea borrado (0xFF) si no existe
+db_blockdev_t* db_blockdev_file_open(const char* path, uint32_t size, uint32_t erase_size);
+#ifdef ESP_PLATFORM
+db_blockdev_t* db_blockdev_partition_open(const char* label, uint8_t subtype);
+#endif
+
+#endif
@@ -0,0 +1,278 @@
+#include "db_manager.h"
+#include "esp_log.h"
+#include "esp_random.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include <cstdio>
+#include <cstring>
+
+static const char* TAG = "DB_MANAGER";
+
+#define DB_TASK_STACK   4096
+
+static db_store_t store;
+static db_blockdev_t* device = nullptr;
+static SemaphoreHandle_t lock = nullptr;
+static TaskHandle_t db_task = nullptr;
+static uint32_t commit_us_max = 0;
+static uint32_t compact_us_max = 0;
+static uint32_t query_us_last = 0;
+
+static esp_err_t to_esp_err(int rc) {
+    switch (rc) {
+    case DB_OK: return ESP_OK;
+    case DB_ERR_FULL: return ESP_ERR_NO_MEM;
+    case DB_ERR_NOT_FOUND: return ESP_ERR_NOT_FOUND;
+    case DB_ERR_ARG: return ESP_ERR_INVALID_ARG;
+    case DB_ERR_NO_MEM: return ESP_ERR_NO_MEM;
+    default: return ESP_FAIL;
+    }
+}
+
+static int commit_locked() {
+    const int64_t t0 = esp_timer_get_time();
+    const int rc = db_store_commit(&store);
+    const uint32_t us = (uint32_t)(esp_timer_get_time() - t0);
+    if (us > commit_us_max) commit_us_max = us;
+    return rc;
+}
+
+// Confirma el lote periódicamente y recicla segmentos antes de que la
+// aplicación se quede sin sitio (así la compactación no cae en un commit)
+static void db_background_task(void* arg) {
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(DB_COMMIT_INTERVAL_MS));
+
+        xSemaphoreTake(lock, portMAX_DELAY);
+        const int rc = commit_locked();
+        if (rc != DB_OK) {
+            ESP_LOGW(TAG, "commit: %d", rc);
+        }
+        if (db_store_free_segments(&store) < DB_COMPACT_FREE_SEGMENTS) {
+            const int64_t t0 = esp_timer_get_time();
+            db_store_compact(&store);
+            const uint32_t us = (uint32_t)(esp_timer_get_time() - t0);
+            if (us > compact_us_max) compact_us_max = us;
+        }
+        xSemaphoreGive(lock);
+
+        // Una compactación por vuelta: si aún faltan segmentos, otra enseguida
+        if (db_store_free_segments(&store) < DB_COMPACT_FREE_SEGMENTS) {
+            xTaskNotifyGive(db_task);
+        }
+    }
+}
+
+esp_err_t db_manager_init() {
+    if (db_task) return ESP_OK;
+
+    device = db_blockdev_partition_open(DB_PARTITION_LABEL, DB_PARTITION_SUBTYPE);
+    if (!device) {
+        ESP_LOGW(TAG, "Sin partición '%s'", DB_PARTITION_LABEL);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    const int64_t t0 = esp_timer_get_time();
+    const int rc = db_store_open(&store, device, DB_SEGMENT_BYTES, DB_BATCH_BYTES, DB_RETENTION_S);
+    if (rc != DB_OK) {
+        ESP_LOGE(TAG, "No se pudo montar el almacén: %d", rc);
+        db_blockdev_destroy(device);
+        device = nullptr;
+        return to_esp_err(rc);
+    }
+
+    lock = xSemaphoreCreateMutex();
+    if (!lock || xTaskCreatePinnedToCore(db_background_task, "db", DB_TASK_STACK, nullptr,
+                                         DB_TASK_PRIORITY, &db_task, DB_TASK_CORE) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    db_store_stats_t st;
+    db_store_get_stats(&store, &st);
+    ESP_LOGI(TAG, "Montado en %lld ms: %lu segmentos (%lu libres), %lu claves, %lu lotes rotos descartados",
+             (esp_timer_get_time() - t0) / 1000, (unsigned long)st.segments, (unsigned long)st.free_segments,
+             (unsigned long)store.kv_count, (unsigned long)st.torn_batches);
+    return ESP_OK;
+}
+
+bool db_manager_is_ready() {
+    return db_task != nullptr;
+}
+
+esp_err_t db_log_sample(uint16_t series, uint32_t ts, const void* value, uint16_t len) {
+    if (!db_task) return ESP_ERR_INVALID_STATE;
+    xSemaphoreTake(lock, portMAX_DELAY);
+    const int rc = db_store_append(&store, series, ts, value, len);
+    xSemaphoreGive(lock);
+    return to_esp_err(rc);
+}
+
+esp_err_t db_put(const char* key, const void* value, uint16_t len) {
+    if (!db_task) return ESP_ERR_INVALID_STATE;
+    xSemaphoreTake(lock, portMAX_DELAY);
+    const int rc = db_store_put(&store, key, value, len);
+    xSemaphoreGive(lock);
+    return to_esp_err(rc);
+}
+
+int db_get(const char* key, void* value, uint16_t cap) {
+    if (!db_task) return -1;
+    xSemaphoreTake(lock, portMAX_DELAY);
+    const int rc = db_store_get(&store, key, value, cap);
+    xSemaphoreGive(lock);
+    return rc >= 0 ? rc : -1;
+}
+
+esp_err_t db_delete(const char* key) {
+    if (!db_task) return ESP_ERR_INVALID_STATE;
+    xSemaphoreTake(lock, portMAX_DELAY);
+    const int rc = db_store_delete(&store, key);
+    xSemaphoreGive(lock);
+    return to_esp_err(rc);
+}
+
+esp_err_t db_commit() {
+    if (!db_task) return ESP_ERR_INVALID_STATE;
+    xSemaphoreTake(lock, portMAX_DELAY);
+    const int rc = commit_locked();
+    xSemaphoreGive(lock);
+    return to_esp_err(rc);
+}
+
+int db_query(uint16_t series, uint32_t t0, uint32_t t1, db_sample_cb_t cb, void* user) {
+    if (!db_task) return -1;
+    xSemaphoreTake(lock, portMAX_DELAY);
+    const int64_t start = esp_timer_get_time();
+    const int rc = db_store_query(&store, series, t0, t1, cb, user);
+    query_us_last = (uint32_t)(esp_timer_get_time() - start);
+    xSemaphoreGive(lock);
+    return rc >= 0 ? rc : -1;
+}
+
+void db_manager_get_stats(db_manager_stats_t* out) {
+    *out = {};
+    if (!db_task) return;
+    xSemaphoreTake(lock, portMAX_DELAY);
+    db_store_get_stats(&store, &out->store);
+    out->commit_us_max = commit_us_max;
+    out->compact_us_max = compact_us_max;
+    out->query_us_last = query_us_last;
+    xSemaphoreGive(lock);
+}
+
+// --- Benchmark ------------------------------------------------------------------
+
+static bool bench_count_cb(uint16_t series, uint32_t ts, const void* value, uint16_t len, void* user) {
+    (*(uint32_t*)user)++;
+    return true;
+}
+
+typedef struct {
+    uint32_t first;
+    uint32_t last;
+    uint32_t count;
+    bool values_ok;
+} bench_range_t;
+
+static bool bench_range_cb(uint16_t series, uint32_t ts, const void* value, uint16_t len, void* user) {
+    bench_range_t* r = (bench_range_t*)user;
+    uint32_t v;
+    memcpy(&v, value, sizeof(v));
+    if (len != sizeof(v) || v != ts * 3) r->values_ok = false;
+    if (r->count == 0 || ts < r->first) r->first = ts;
+    if (r->count == 0 || ts > r->last) r->last = ts;
+    r->count++;
+    return true;
+}
+
+void db_manager_benchmark(uint32_t samples, uint32_t power_cuts) {
+    const uint32_t dev_bytes = 16 * DB_SEGMENT_BYTES;
+    db_blockdev_t* dev = db_blockdev_ram_create(dev_bytes, 4096);
+    if (!dev) return;
+
+    // Una muestra por minuto + un ajuste cada hora; commit cada 10 minutos.
+    // Estático: db_store_t no cabe con holgura en la pila de app_main
+    static db_store_t db;
+    db_store_open(&db, dev, DB_SEGMENT_BYTES, DB_BATCH_BYTES, 0);
+    uint64_t append_us = 0;
+    uint32_t commit_max = 0;
+    uint32_t compact_max = 0;
+    for (uint32_t i = 0; i < samples; i++) {
+        const uint32_t v = i * 3;
+        int64_t t0 = esp_timer_get_time();
+        db_store_append(&db, DB_SERIES_STEPS, i, &v, sizeof(v));
+        if (i % 60 == 0) db_store_put(&db, "steps_day", &v, sizeof(v));
+        append_us += esp_timer_get_time() - t0;
+
+        if (i % 10 == 9) {
+            t0 = esp_timer_get_time();
+            db_store_commit(&db);
+            const uint32_t us = (uint32_t)(esp_timer_get_time() - t0);
+            if (us > commit_max) commit_max = us;
+        }
+        if (db_store_free_segments(&db) < DB_COMPACT_FREE_SEGMENTS) {
+            t0 = esp_timer_get_time();
+            db_store_compact(&db);
+            const uint32_t us = (uint32_t)(esp_timer_get_time() - t0);
+            if (us > compact_max) compact_max = us;
+        }
+    }
+    db_store_commit(&db);
+
+    uint32_t found = 0;
+    const int64_t q0 = esp_timer_get_time();
+    db_store_query(&db, DB_SERIES_STEPS, samples > 1440 ? samples - 1440 : 0, samples, bench_count_cb, &found);
+    const uint32_t query_us = (uint32_t)(esp_timer_get_time() - q0);
+
+    db_store_stats_t st;
+    db_store_get_stats(&db, &st);
+    printf("DBBENCH,samples,user_bytes,flash_bytes,wa_x100,erases,compactions,evicted,append_us_avg,commit_us_max,compact_us_max,query_day_us,query_day_found\n");
+    printf("DBBENCH,%lu,%llu,%llu,%llu,%lu,%lu,%lu,%llu,%lu,%lu,%lu,%lu\n",
+           (unsigned long)samples, (unsigned long long)st.user_bytes, (unsigned long long)st.flash_bytes,
+           (unsigned long long)(st.user_bytes ? st.flash_bytes * 100 / st.user_bytes : 0),
+           (unsigned long)st.erases, (unsigned long)st.compactions, (unsigned long)st.evicted_samples,
+           (unsigned long long)(samples ? append_us / samples : 0), (unsigned long)commit_max,
+           (unsigned long)compact_max, (unsigned long)query_us, (unsigned long)found);
+    db_store_close(&db);
+
+    // Cortes de alimentación en un punto aleatorio: tras remontar tienen que
+    // estar todos los lotes confirmados (salvo los reciclados) y ninguno a medias
+    uint32_t failures = 0;
+    for (uint32_t trial = 0; trial < power_cuts; trial++) {
+        db_blockdev_power_restore(dev);
+        db_store_open(&db, dev, DB_SEGMENT_BYTES, DB_BATCH_BYTES, 0);
+        db_store_format(&db);
+        db_blockdev_power_cut_after(dev, 1 + esp_random() % (dev_bytes / 2));
+
+        uint32_t committed = 0;
+        uint32_t written = 0;
+        for (;; written++) {
+            const uint32_t v = written * 3;
+            if (db_store_append(&db, DB_SERIES_STEPS, written, &v, sizeof(v)) != DB_OK) break;
+            if (written % 37 == 36) {
+                if (db_store_commit(&db) != DB_OK) break;
+                committed = written + 1;
+            }
+            if (db_store_free_segments(&db) < DB_COMPACT_FREE_SEGMENTS && db_store_compact(&db) != DB_OK) break;
+        }
+        db_store_close(&db);
+
+        db_blockdev_power_restore(dev);
+        db_store_open(&db, dev, DB_SEGMENT_BYTES, DB_BATCH_BYTES, 0);
+        bench_range_t r = { 0, 0, 0, true };
+        db_store_query(&db, DB_SERIES_STEPS, 0, UINT32_MAX, bench_range_cb, &r);
+        const bool ok = r.values_ok && (committed == 0 ? r.count == 0 || r.last <= written
+                                                       : r.count > 0 && r.last + 1 >= committed &&
+                                                         r.last <= written && r.count == r.last - r.first + 1);
+        if (!ok) {
+            failures++;
+            printf("DBCRASH,trial=%lu,committed=%lu,recovered=%lu,first=%lu,last=%lu\n", (unsigned long)trial,
+                   (unsigned long)committed, (unsigned long)r.count, (unsigned long)r.first, (unsigned long)r.last);
+        }
+        db_store_close(&db);
+    }
+    printf("DBCRASH,trials,%lu,failures,%lu\n", (unsigned long)power_cuts, (unsigned long)failures);
+    db_blockdev_destroy(dev);
+}
@@ -0,0 +1,49 @@
+#ifndef DB_MANAGER_H
+#define DB_MANAGER_H
+
+#include "esp_err.h"
+#include "config.h"
+#include "db_store.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Historial de la aplicación (pasos por minuto, lecturas...) y ajustes clave/valor
+// en la partición "db", sobre db_store. Las escrituras van a un lote en RAM;
+// una tarea de baja prioridad lo confirma cada DB_COMMIT_INTERVAL_MS y
+// compacta cuando quedan pocos segmentos libres. Todas las funciones son
+// thread-safe.
+
+// Series de muestras (bit serie % 32 en el índice de cada segmento)
+typedef enum {
+    DB_SERIES_STEPS = 1,
+} db_series_t;
+
+typedef struct {
+    db_store_stats_t store;
+    uint32_t commit_us_max;
+    uint32_t compact_us_max;
+    uint32_t query_us_last;
+} db_manager_stats_t;
+
+esp_err_t db_manager_init();
+bool db_manager_is_ready();
+
+esp_err_t db_log_sample(uint16_t series, uint32_t ts, const void* value, uint16_t len);
+esp_err_t db_put(const char* key, const void* value, uint16_t len);
+// Longitud del valor o -1 si no existe
+int db_get(const char* key, void* value, uint16_t cap);
+esp_err_t db_delete(const char* key);
+// Confirma ya el lote pendiente (antes de apagar, por ejemplo)
+esp_err_t db_commit();
+
+// Muestras con t0 <= ts <= t1. El callback se llama con el almacén bloqueado:
+// no debe llamar a db_manager. Devuelve cuántas entregó o -1.
+int db_query(uint16_t series, uint32_t t0, uint32_t t1, db_sample_cb_t cb, void* user);
+
+void db_manager_get_stats(db_manager_stats_t* out);
+
+// Sobre un dispositivo en RAM (no toca la partición): write amplification,
+// latencias y recuperación tras 'power_cuts' cortes de alimentación simulados.
+void db_manager_benchmark(uint32_t samples, uint32_t power_cuts);
+
+#endif
@@ -0,0 +1,640 @@
+#include "db_store.h"
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+
+#define DB_SEGMENT_MAGIC    0x47534244u     // "DBSG"
+#define DB_RECORD_MAGIC     0x5A
+#define DB_HDR_BYTES        16              // Cabecera de segmento y de registro
+
+enum : uint8_t {
+    REC_SAMPLE = 1,
+    REC_KV_PUT,         // payload: clave (key_len bytes) + valor
+    REC_KV_DEL,         // payload: clave
+    REC_COMMIT,
+};
+
+typedef struct {
+    uint32_t magic;
+    uint32_t seq;
+    uint32_t reserved;
+    uint32_t crc;       // De los 12 bytes anteriores
+} segment_hdr_t;
+
+typedef struct {
+    uint8_t magic;
+    uint8_t type;
+    uint16_t len;       // Payload
+    uint32_t ts;
+    uint16_t series;
+    uint16_t key_len;
+    uint32_t crc;       // Cabecera (con crc = 0) + payload
+} record_hdr_t;
+
+static_assert(sizeof(segment_hdr_t) == DB_HDR_BYTES, "segment_hdr_t");
+static_assert(sizeof(record_hdr_t) == DB_HDR_BYTES, "record_hdr_t");
+
+// Devuelve false para dejar de recorrer
+typedef bool (*record_fn_t)(db_store_t* db, uint32_t seg, uint32_t offset,
+                            const record_hdr_t* h, const uint8_t* payload, void* user);
+
+// CRC32 de zlib con tabla de 16 entradas
+static uint32_t crc32_update(uint32_t crc, const void* data, size_t len) {
+    static const uint32_t table[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+    };
+    const uint8_t* p = (const uint8_t*)data;
+    crc = ~crc;
+    while (len--) {
+        crc ^= *p++;
+        crc = (crc >> 4) ^ table[crc & 15];
+        crc = (crc >> 4) ^ table[crc & 15];
+    }
+    return ~crc;
+}
+
+static uint32_t rec_size(uint32_t payload) {
+    return (DB_HDR_BYTES + payload + 3) & ~3u;
+}
+
+static uint32_t record_crc(const record_hdr_t* h, const uint8_t* payload) {
+    record_hdr_t tmp = *h;
+    tmp.crc = 0;
+    return crc32_update(crc32_update(0, &tmp, sizeof(tmp)), payload, h->len);
+}
+
+static uint32_t segment_hdr_crc(const segment_hdr_t* h) {
+    return crc32_update(0, h, offsetof(segment_hdr_t, crc));
+}
+
+static bool all_erased(const uint8_t* p, uint32_t len) {
+    for (uint32_t i = 0; i < len; i++) {
+        if (p[i] != 0xFF) return false;
+    }
+    return true;
+}
+
+// --- Índice de claves --------------------------------------------------------
+
+static db_kv_slot_t* kv_find(db_store_t* db, const char* key, uint16_t key_len) {
+    for (uint32_t i = 0; i < db->kv_count; i++) {
+        if (strncmp(db->kv[i].key, key, key_len) == 0 && db->kv[i].key[key_len] == '\0') {
+            return &db->kv[i];
+        }
+    }
+    return nullptr;
+}
+
+static void live_sub(db_store_t* db, uint32_t offset, uint32_t bytes) {
+    db_segment_info_t* s = &db->segs[offset / db->segment_bytes];
+    s->live_bytes = s->live_bytes > bytes ? s->live_bytes - bytes : 0;
+}
+
+// Aplica un registro confirmado al índice en RAM
+static void index_record(db_store_t* db, uint32_t seg, uint32_t offset, const record_hdr_t* h, const uint8_t* payload) {
+    db_segment_info_t* s = &db->segs[seg];
+    const uint32_t size = rec_size(h->len);
+
+    switch (h->type) {
+    case REC_SAMPLE:
+        if (s->samples == 0 || h->ts < s->min_ts) s->min_ts = h->ts;
+        if (s->samples == 0 || h->ts > s->max_ts) s->max_ts = h->ts;
+        if (h->ts > db->newest_ts) db->newest_ts = h->ts;
+        s->series_mask |= 1u << (h->series & 31);
+        s->samples++;
+        s->live_bytes += size;
+        break;
+
+    case REC_KV_PUT: {
+        db_kv_slot_t* slot = kv_find(db, (const char*)payload, h->key_len);
+        if (slot) {
+            live_sub(db, slot->offset, slot->rec_bytes);
+        } else if (db->kv_count < DB_KV_MAX_KEYS && h->key_len <= DB_KEY_MAX) {
+            slot = &db->kv[db->kv_count++];
+            memcpy(slot->key, payload, h->key_len);
+            slot->key[h->key_len] = '\0';
+        } else {
+            return;
+        }
+        slot->offset = offset;
+        slot->rec_bytes = size;
+        s->live_bytes += size;
+        break;
+    }
+
+    case REC_KV_DEL: {
+        db_kv_slot_t* slot = kv_find(db, (const char*)payload, h->key_len);
+        if (slot) {
+            live_sub(db, slot->offset, slot->rec_bytes);
+            *slot = db->kv[--db->kv_count];
+        }
+        break;
+    }
+    }
+}
+
+static bool index_fn(db_store_t* db, uint32_t seg, uint32_t offset, const record_hdr_t* h,
+                     const uint8_t* payload, void* user) {
+    index_record(db, seg, seg * db->segment_bytes + offset, h, payload);
+    return true;
+}
+
+// Recorre los registros de lotes confirmados de un segmento leído en 'buf'.
+// Devuelve el final del último COMMIT válido; *torn indica que detrás hay
+// bytes escritos que no forman un lote completo.
+static uint32_t walk_committed(db_store_t* db, uint32_t seg, const uint8_t* buf, uint32_t len,
+                               record_fn_t fn, void* user, bool* torn) {
+    uint32_t off = DB_HDR_BYTES;
+    uint32_t batch_start = off;
+    uint32_t committed = off;
+    bool stop = false;
+
+    while (!stop && off + DB_HDR_BYTES <= len) {
+        const record_hdr_t* h = (const record_hdr_t*)(buf + off);
+        if (h->magic != DB_RECORD_MAGIC) break;
+        const uint32_t size = rec_size(h->len);
+        if (off + size > len) break;
+        if (record_crc(h, buf + off + DB_HDR_BYTES) != h->crc) {
+            db->stats.crc_errors++;
+            break;
+        }
+
+        if (h->type == REC_COMMIT) {
+            for (uint32_t o = batch_start; o < off && !stop;) {
+                const record_hdr_t* r = (const record_hdr_t*)(buf + o);
+                stop = !fn(db, seg, o, r, buf + o + DB_HDR_BYTES, user);
+                o += rec_size(r->len);
+            }
+            committed = off + size;
+            batch_start = committed;
+        }
+        off += size;
+    }
+
+    if (torn) {
+        *torn = !all_erased(buf + committed, len - committed);
+    }
+    return committed;
+}
+
+// --- Segmentos ----------------------------------------------------------------
+
+uint32_t db_store_free_segments(const db_store_t* db) {
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < db->segment_count; i++) {
+        if (db->segs[i].seq == 0) n++;
+    }
+    return n;
+}
+
+// Un borrado cortado a medias no puede dejar un segmento que parezca libre con
+// datos viejos en el cuerpo: se anula la cabecera (solo bits 1 -> 0) y se borra
+// sector a sector de atrás hacia delante, el de la cabecera el último. Hasta
+// que termina, la cabecera no está ni borrada ni válida y el montaje lo repite.
+static int erase_segment(db_store_t* db, uint32_t seg) {
+    const uint32_t base = seg * db->segment_bytes;
+    const bool had_data = db->segs[seg].seq != 0;
+    memset(&db->segs[seg], 0, sizeof(db_segment_info_t));
+    if (had_data) {
+        static const uint8_t zeros[DB_HDR_BYTES] = {};
+        if (db_blockdev_write(db->dev, base, zeros, sizeof(zeros)) != 0) return DB_ERR_IO;
+    }
+    for (uint32_t off = db->segment_bytes; off > 0; off -= db->dev->erase_size) {
+        if (db_blockdev_erase(db->dev, base + off - db->dev->erase_size, db->dev->erase_size) != 0) return DB_ERR_IO;
+    }
+    return DB_OK;
+}
+
+// La aplicación nunca se queda el último segmento libre: es el que usa la
+// compactación para copiar lo vivo antes de borrar el más antiguo.
+static int take_segment(db_store_t* db, bool for_compaction) {
+    if (db_store_free_segments(db) < (for_compaction ? 1u : 2u)) return DB_ERR_FULL;
+
+    // El siguiente libre tras el activo, en orden circular: reparte el desgaste
+    const uint32_t start = db->active >= 0 ? (uint32_t)db->active + 1 : 0;
+    for (uint32_t k = 0; k < db->segment_count; k++) {
+        const uint32_t i = (start + k) % db->segment_count;
+        if (db->segs[i].seq != 0) continue;
+
+        segment_hdr_t hdr = { DB_SEGMENT_MAGIC, db->next_seq, 0xFFFFFFFF, 0 };
+        hdr.crc = segment_hdr_crc(&hdr);
+        if (db_blockdev_write(db->dev, i * db->segment_bytes, &hdr, sizeof(hdr)) != 0) {
+            erase_segment(db, i);
+            return DB_ERR_IO;
+        }
+        if (db->active >= 0) {
+            db->segs[db->active].sealed = true;
+        }
+        db->segs[i].seq = db->next_seq++;
+        db->segs[i].used = DB_HDR_BYTES;
+        db->active = i;
+        return DB_OK;
+    }
+    return DB_ERR_FULL;
+}
+
+// Escribe un lote terminado en COMMIT al final del segmento activo
+static int write_batch(db_store_t* db, const uint8_t* buf, uint32_t len, bool for_compaction) {
+    for (int attempt = 0; attempt < 2; attempt++) {
+        db_segment_info_t* s = db->active >= 0 ? &db->segs[db->active] : nullptr;
+        if (!s || s->sealed || s->used + len > db->segment_bytes) {
+            const int rc = take_segment(db, for_compaction);
+            if (rc != DB_OK) return rc;
+            s = &db->segs[db->active];
+        }
+
+        const uint32_t base = db->active * db->segment_bytes + s->used;
+        if (db_blockdev_write(db->dev, base, buf, len) != 0) {
+            // Lo que haya quedado a medias no se puede sobrescribir: a otro segmento
+            s->sealed = true;
+            if (db->dev->powered_off) return DB_ERR_IO;
+            continue;
+        }
+
+        for (uint32_t o = 0; o < len;) {
+            const record_hdr_t* h = (const record_hdr_t*)(buf + o);
+            index_record(db, db->active, base + o, h, buf + o + DB_HDR_BYTES);
+            o += rec_size(h->len);
+        }
+        s->used += len;
+        db->stats.commits++;
+        return DB_OK;
+    }
+    return DB_ERR_IO;
+}
+
+static uint32_t put_record(uint8_t* dst, uint8_t type, uint16_t series, uint32_t ts,
+                           const void* key, uint16_t key_len, const void* value, uint16_t len) {
+    record_hdr_t h = {};
+    h.magic = DB_RECORD_MAGIC;
+    h.type = type;
+    h.len = key_len + len;
+    h.ts = ts;
+    h.series = series;
+    h.key_len = key_len;
+
+    uint8_t* payload = dst + DB_HDR_BYTES;
+    if (key_len) memcpy(payload, key, key_len);
+    if (len) memcpy(payload + key_len, value, len);
+    const uint32_t size = rec_size(h.len);
+    memset(payload + h.len, 0, size - DB_HDR_BYTES - h.len);
+
+    h.crc = record_crc(&h, payload);
+    memcpy(dst, &h, sizeof(h));
+    return size;
+}
+
+static uint32_t put_commit(uint8_t* dst) {
+    return put_record(dst, REC_COMMIT, 0, 0, nullptr, 0, nullptr, 0);
+}
+
+// --- Montaje ------------------------------------------------------------------
+
+static void release_buffers(db_store_t* db) {
+    free(db->segs);
+    free(db->scratch);
+    free(db->batch);
+    free(db->copy);
+    db->segs = nullptr;
+    db->scratch = db->batch = db->copy = nullptr;
+}
+
+int db_store_open(db_store_t* db, db_blockdev_t* dev, uint32_t segment_bytes,
+                  uint32_t batch_bytes, uint32_t retention_s) {
+    memset(db, 0, sizeof(*db));
+    if (!dev || segment_bytes % dev->erase_size || dev->size / segment_bytes < 3 ||
+        batch_bytes < 4 * DB_HDR_BYTES || batch_bytes > segment_bytes - DB_HDR_BYTES) {
+        return DB_ERR_ARG;
+    }
+
+    db->dev = dev;
+    db->segment_bytes = segment_bytes;
+    db->segment_count = dev->size / segment_bytes;
+    db->retention_s = retention_s;
+    db->batch_cap = batch_bytes & ~3u;
+    db->active = -1;
+    db->next_seq = 1;
+    db->segs = (db_segment_info_t*)calloc(db->segment_count, sizeof(db_segment_info_t));
+    db->scratch = (uint8_t*)malloc(segment_bytes);
+    db->batch = (uint8_t*)malloc(db->batch_cap);
+    db->copy = (uint8_t*)malloc(db->batch_cap);
+    if (!db->segs || !db->scratch || !db->batch || !db->copy) {
+        release_buffers(db);
+        return DB_ERR_NO_MEM;
+    }
+
+    // Cabeceras: segmentos con datos, libres o con basura (se borran). Uno libre
+    // tiene que estar borrado entero: escribir sobre restos de un borrado
+    // interrumpido dejaría registros con CRC erróneo.
+    for (uint32_t i = 0; i < db->segment_count; i++) {
+        segment_hdr_t hdr;
+        if (db_blockdev_read(dev, i * segment_bytes, &hdr, sizeof(hdr)) != 0) {
+            release_buffers(db);
+            return DB_ERR_IO;
+        }
+        if (hdr.magic == DB_SEGMENT_MAGIC && hdr.crc == segment_hdr_crc(&hdr) && hdr.seq != 0) {
+            db->segs[i].seq = hdr.seq;
+            continue;
+        }
+        if (all_erased((const uint8_t*)&hdr, sizeof(hdr))) {
+            if (db_blockdev_read(dev, i * segment_bytes, db->scratch, segment_bytes) != 0) {
+                release_buffers(db);
+                return DB_ERR_IO;
+            }
+            if (all_erased(db->scratch, segment_bytes)) continue;
+        }
+        erase_segment(db, i);
+    }
+
+    // Índice: segmentos en orden de secuencia, para que las claves más nuevas ganen
+    uint32_t last_seq = 0;
+    for (;;) {
+        int32_t next = -1;
+        for (uint32_t i = 0; i < db->segment_count; i++) {
+            const uint32_t seq = db->segs[i].seq;
+            if (seq > last_seq && (next < 0 || seq < db->segs[next].seq)) next = i;
+        }
+        if (next < 0) break;
+
+        db_segment_info_t* s = &db->segs[next];
+        if (db_blockdev_read(dev, next * segment_bytes, db->scratch, segment_bytes) != 0) {
+            release_buffers(db);
+            return DB_ERR_IO;
+        }
+        bool torn = false;
+        s->used = walk_committed(db, next, db->scratch, segment_bytes, index_fn, nullptr, &torn);
+        if (torn) {
+            db->stats.torn_batches++;
+        }
+        if (db->active >= 0) {
+            db->segs[db->active].sealed = true;
+        }
+        s->sealed = torn;
+        db->active = next;
+        last_seq = s->seq;
+        db->next_seq = s->seq + 1;
+    }
+    return DB_OK;
+}
+
+void db_store_close(db_store_t* db) {
+    release_buffers(db);
+}
+
+int db_store_format(db_store_t* db) {
+    for (uint32_t i = 0; i < db->segment_count; i++) {
+        if (erase_segment(db, i) != DB_OK) return DB_ERR_IO;
+    }
+    db->active = -1;
+    db->next_seq = 1;
+    db->batch_len = 0;
+    db->kv_count = 0;
+    db->newest_ts = 0;
+    return DB_OK;
+}
+
+// --- Escritura ----------------------------------------------------------------
+
+static int batch_add(db_store_t* db, uint8_t type, uint16_t series, uint32_t ts,
+                     const void* key, uint16_t key_len, const void* value, uint16_t len) {
+    const uint32_t size = rec_size(key_len + len);
+    if (db->batch_len + size + DB_HDR_BYTES > db->batch_cap) {
+        const int rc = db_store_commit(db);
+        if (rc != DB_OK) return rc;
+    }
+    db->batch_len += put_record(db->batch + db->batch_len, type, series, ts, key, key_len, value, len);
+    db->stats.user_bytes += key_len + len;
+    db->stats.records++;
+    return DB_OK;
+}
+
+int db_store_append(db_store_t* db, uint16_t series, uint32_t ts, const void* value, uint16_t len) {
+    if (len > DB_VALUE_MAX) return DB_ERR_ARG;
+    return batch_add(db, REC_SAMPLE, series, ts, nullptr, 0, value, len);
+}
+
+int db_store_put(db_store_t* db, const char* key, const void* value, uint16_t len) {
+    const size_t key_len = strlen(key);
+    if (key_len == 0 || key_len > DB_KEY_MAX || len > DB_VALUE_MAX) return DB_ERR_ARG;
+    if (!kv_find(db, key, key_len) && db->kv_count >= DB_KV_MAX_KEYS) return DB_ERR_FULL;
+    return batch_add(db, REC_KV_PUT, 0, 0, key, key_len, value, len);
+}
+
+int db_store_delete(db_store_t* db, const char* key) {
+    const size_t key_len = strlen(key);
+    if (key_len == 0 || key_len > DB_KEY_MAX) return DB_ERR_ARG;
+    return batch_add(db, REC_KV_DEL, 0, 0, key, key_len, nullptr, 0);
+}
+
+int db_store_commit(db_store_t* db) {
+    if (db->batch_len == 0) return DB_OK;
+
+    const uint32_t commit_at = db->batch_len;
+    db->batch_len += put_commit(db->batch + commit_at);
+
+    int rc;
+    for (;;) {
+        rc = write_batch(db, db->batch, db->batch_len, false);
+        // Sin segmento libre para la aplicación: reciclar el más antiguo y reintentar
+        if (rc != DB_ERR_FULL || db_store_compact(db) != DB_OK) break;
+    }
+
+    if (rc == DB_OK) {
+        db->batch_len = 0;
+    } else {
+        db->batch_len = commit_at;   // El lote sigue pendiente
+    }
+    return rc;
+}
+
+// --- Lectura ------------------------------------------------------------------
+
+int db_store_get(db_store_t* db, const char* key, void* value, uint16_t cap) {
+    const size_t key_len = strlen(key);
+    if (key_len == 0 || key_len > DB_KEY_MAX) return DB_ERR_ARG;
+
+    // Lo pendiente manda: el último registro de la clave en el lote
+    const record_hdr_t* latest = nullptr;
+    for (uint32_t o = 0; o < db->batch_len;) {
+        const record_hdr_t* h = (const record_hdr_t*)(db->batch + o);
+        if ((h->type == REC_KV_PUT || h->type == REC_KV_DEL) && h->key_len == key_len &&
+            memcmp(db->batch + o + DB_HDR_BYTES, key, key_len) == 0) {
+            latest = h;
+        }
+        o += rec_size(h->len);
+    }
+
+    uint8_t buf[DB_HDR_BYTES + DB_KEY_MAX + DB_VALUE_MAX + 4];
+    if (!latest) {
+        const db_kv_slot_t* slot = kv_find(db, key, key_len);
+        if (!slot) return DB_ERR_NOT_FOUND;
+        if (db_blockdev_read(db->dev, slot->offset, buf, slot->rec_bytes) != 0) return DB_ERR_IO;
+        latest = (const record_hdr_t*)buf;
+        if (record_crc(latest, buf + DB_HDR_BYTES) != latest->crc) {
+            db->stats.crc_errors++;
+            return DB_ERR_IO;
+        }
+    }
+    if (latest->type == REC_KV_DEL) return DB_ERR_NOT_FOUND;
+
+    const uint16_t len = latest->len - latest->key_len;
+    memcpy(value, (const uint8_t*)latest + DB_HDR_BYTES + key_len, len < cap ? len : cap);
+    return len;
+}
+
+typedef struct {
+    uint16_t series;
+    uint32_t t0;
+    uint32_t t1;
+    db_sample_cb_t cb;
+    void* user;
+    int count;
+    bool stopped;
+} query_ctx_t;
+
+static bool query_fn(db_store_t* db, uint32_t seg, uint32_t offset, const record_hdr_t* h,
+                     const uint8_t* payload, void* user) {
+    query_ctx_t* q = (query_ctx_t*)user;
+    if (h->type != REC_SAMPLE || h->series != q->series || h->ts < q->t0 || h->ts > q->t1) return true;
+    q->count++;
+    q->stopped = !q->cb(h->series, h->ts, payload, h->len, q->user);
+    return !q->stopped;
+}
+
+int db_store_query(db_store_t* db, uint16_t series, uint32_t t0, uint32_t t1, db_sample_cb_t cb, void* user) {
+    query_ctx_t q = { series, t0, t1, cb, user, 0, false };
+
+    // Segmentos en orden de secuencia; el índice descarta los que no solapan
+    uint32_t last_seq = 0;
+    while (!q.stopped) {
+        int32_t next = -1;
+        for (uint32_t i = 0; i < db->segment_count; i++) {
+            const uint32_t seq = db->segs[i].seq;
+            if (seq > last_seq && (next < 0 || seq < db->segs[next].seq)) next = i;
+        }
+        if (next < 0) break;
+
+        const db_segment_info_t* s = &db->segs[next];
+        last_seq = s->seq;
+        if (s->samples == 0 || !(s->series_mask & (1u << (series & 31))) || s->max_ts < t0 || s->min_ts > t1) {
+            continue;
+        }
+        if (db_blockdev_read(db->dev, next * db->segment_bytes, db->scratch, s->used) != 0) return DB_ERR_IO;
+        walk_committed(db, next, db->scratch, s->used, query_fn, &q, nullptr);
+    }
+
+    // Lote pendiente
+    for (uint32_t o = 0; o < db->batch_len && !q.stopped;) {
+        const record_hdr_t* h = (const record_hdr_t*)(db->batch + o);
+        if (!query_fn(db, 0, o, h, db->batch + o + DB_HDR_BYTES, &q)) break;
+        o += rec_size(h->len);
+    }
+    return q.count;
+}
+
+// --- Compactación ---------------------------------------------------------------
+
+typedef struct {
+    uint32_t victim_base;
+    uint32_t cutoff;            // Muestras con ts < cutoff han caducado
+    bool evict;                 // Descartar también las vigentes (sin espacio)
+    uint32_t kv_live;
+    uint32_t sample_live;
+    uint32_t copy_len;
+    int rc;
+} compact_ctx_t;
+
+static bool record_is_live(db_store_t* db, const compact_ctx_t* c, uint32_t offset,
+                           const record_hdr_t* h, const uint8_t* payload) {
+    if (h->type == REC_KV_PUT) {
+        const db_kv_slot_t* slot = kv_find(db, (const char*)payload, h->key_len);
+        return slot && slot->offset == c->victim_base + offset;
+    }
+    return h->type == REC_SAMPLE && h->ts >= c->cutoff;
+}
+
+static bool measure_fn(db_store_t* db, uint32_t seg, uint32_t offset, const record_hdr_t* h,
+                       const uint8_t* payload, void* user) {
+    compact_ctx_t* c = (compact_ctx_t*)user;
+    if (!record_is_live(db, c, offset, h, payload)) return true;
+    if (h->type == REC_KV_PUT) c->kv_live += rec_size(h->len);
+    else c->sample_live += rec_size(h->len);
+    return true;
+}
+
+static int flush_copy(db_store_t* db, compact_ctx_t* c) {
+    if (c->copy_len == 0) return DB_OK;
+    c->copy_len += put_commit(db->copy + c->copy_len);
+    const int rc = write_batch(db, db->copy, c->copy_len, true);
+    db->stats.copied_bytes += c->copy_len;
+    c->copy_len = 0;
+    return rc;
+}
+
+static bool copy_fn(db_store_t* db, uint32_t seg, uint32_t offset, const record_hdr_t* h,
+                    const uint8_t* payload, void* user) {
+    compact_ctx_t* c = (compact_ctx_t*)user;
+    if (h->type == REC_SAMPLE) {
+        if (h->ts < c->cutoff) {
+            db->stats.expired_samples++;
+            return true;
+        }
+        if (c->evict) {
+            db->stats.evicted_samples++;
+            return true;
+        }
+    } else if (!record_is_live(db, c, offset, h, payload)) {
+        return true;
+    }
+
+    const uint32_t size = rec_size(h->len);
+    if (c->copy_len + size + DB_HDR_BYTES > db->batch_cap) {
+        c->rc = flush_copy(db, c);
+        if (c->rc != DB_OK) return false;
+    }
+    memcpy(db->copy + c->copy_len, h, size);
+    c->copy_len += size;
+    return true;
+}
+
+int db_store_compact(db_store_t* db) {
+    // Víctima: el segmento cerrado más antiguo
+    int32_t victim = -1;
+    for (uint32_t i = 0; i < db->segment_count; i++) {
+        const db_segment_info_t* s = &db->segs[i];
+        if (s->seq == 0 || (int32_t)i == db->active) continue;
+        if (victim < 0 || s->seq < db->segs[victim].seq) victim = i;
+    }
+    if (victim < 0) return DB_ERR_NOT_FOUND;
+
+    const uint32_t used = db->segs[victim].used;
+    if (db_blockdev_read(db->dev, victim * db->segment_bytes, db->scratch, used) != 0) return DB_ERR_IO;
+
+    compact_ctx_t c = {};
+    c.victim_base = victim * db->segment_bytes;
+    c.cutoff = db->retention_s && db->newest_ts > db->retention_s ? db->newest_ts - db->retention_s : 0;
+    c.rc = DB_OK;
+    walk_committed(db, victim, db->scratch, used, measure_fn, &c, nullptr);
+
+    // Si copiar lo vigente no libera al menos medio segmento, el historial más
+    // antiguo se pierde: es un log circular, las claves sí se conservan siempre
+    c.evict = c.kv_live + c.sample_live > (db->segment_bytes - DB_HDR_BYTES) / 2;
+
+    walk_committed(db, victim, db->scratch, used, copy_fn, &c, nullptr);
+    if (c.rc == DB_OK) {
+        c.rc = flush_copy(db, &c);
+    }
+    if (c.rc != DB_OK) return c.rc;
+
+    db->stats.compactions++;
+    return erase_segment(db, victim);
+}
+
+void db_store_get_stats(const db_store_t* db, db_store_stats_t* out) {
+    *out = db->stats;
+    out->flash_bytes = db->dev->bytes_written;
+    out->erases = db->dev->erases;
+    out->segments = db->segment_count;
+    out->free_segments = db_store_free_segments(db);
+}
@@ -0,0 +1,112 @@
+#ifndef DB_STORE_H
+#define DB_STORE_H
+
+// Almacén log-structured sobre un db_blockdev_t. Sin dependencias de
+// FreeRTOS: no es thread-safe, db_manager lo protege con un mutex.
+//
+// El dispositivo se divide en segmentos (múltiplos del bloque de borrado).
+// Solo se escribe al final del segmento activo, por lotes: cada lote termina
+// en un registro COMMIT y al montar se ignora todo lo que no esté confirmado.
+// La compactación recicla siempre el segmento más antiguo (FIFO), así el
+// desgaste se reparte por igual y los segmentos quedan ordenados en el tiempo.
+//
+//   segmento: [cabecera 16 B][registro][registro]...[COMMIT][registro]...[COMMIT] 0xFF...
+//   registro: [db_record_hdr_t 16 B][payload][relleno a 4]
+
+#include "db_blockdev.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define DB_OK               0
+#define DB_ERR_IO           (-1)
+#define DB_ERR_FULL         (-2)
+#define DB_ERR_NOT_FOUND    (-3)
+#define DB_ERR_ARG          (-4)
+#define DB_ERR_NO_MEM       (-5)
+
+#define DB_KV_MAX_KEYS      32
+#define DB_KEY_MAX          23
+#define DB_VALUE_MAX        128
+
+typedef struct {
+    uint32_t seq;               // 0 = libre (borrado)
+    uint32_t used;              // Bytes confirmados, cabecera incluida
+    uint32_t live_bytes;        // Registros que sobrevivirían a una compactación
+    uint32_t min_ts;
+    uint32_t max_ts;
+    uint32_t series_mask;       // Bit (serie % 32) por cada serie con muestras
+    uint32_t samples;
+    bool sealed;                // Lleno o con un lote roto: no se escribe más en él
+} db_segment_info_t;
+
+typedef struct {
+    char key[DB_KEY_MAX + 1];
+    uint32_t offset;            // Registro vigente en el dispositivo
+    uint16_t rec_bytes;
+} db_kv_slot_t;
+
+typedef struct {
+    uint64_t user_bytes;        // Payload pedido por la aplicación
+    uint64_t flash_bytes;       // Escrito en el dispositivo (cabeceras, COMMIT, copias)
+    uint32_t erases;
+    uint32_t commits;
+    uint32_t records;
+    uint32_t compactions;
+    uint64_t copied_bytes;      // Reescrito por la compactación
+    uint32_t expired_samples;   // Descartadas por retención
+    uint32_t evicted_samples;   // Descartadas por falta de espacio
+    uint32_t torn_batches;      // Lotes sin COMMIT encontrados al montar
+    uint32_t crc_errors;
+    uint32_t segments;
+    uint32_t free_segments;
+} db_store_stats_t;
+
+typedef bool (*db_sample_cb_t)(uint16_t series, uint32_t ts, const void* value, uint16_t len, void* user);
+
+typedef struct {
+    db_blockdev_t* dev;
+    uint32_t segment_bytes;
+    uint32_t segment_count;
+    uint32_t retention_s;       // 0 = sin caducidad
+    db_segment_info_t* segs;
+    uint8_t* scratch;           // Un segmento: montaje, compactación y consultas
+    uint8_t* batch;             // Lote pendiente de la aplicación
+    uint8_t* copy;              // Lote de la compactación
+    uint32_t batch_cap;
+    uint32_t batch_len;
+    uint32_t next_seq;
+    int32_t active;
+    uint32_t newest_ts;
+    uint32_t kv_count;
+    db_kv_slot_t kv[DB_KV_MAX_KEYS];
+    db_store_stats_t stats;
+} db_store_t;
+
+// Monta el almacén (reconstruye el índice leyendo cada segmento) o lo
+// inicializa si el dispositivo está vacío. 'segment_bytes' múltiplo de erase_size.
+int db_store_open(db_store_t* db, db_blockdev_t* dev, uint32_t segment_bytes,
+                  uint32_t batch_bytes, uint32_t retention_s);
+// Libera la RAM. Lo no confirmado se pierde: llamar antes a db_store_commit.
+void db_store_close(db_store_t* db);
+int db_store_format(db_store_t* db);
+
+// Se añaden al lote; se confirma solo cuando se llena o con db_store_commit
+int db_store_append(db_store_t* db, uint16_t series, uint32_t ts, const void* value, uint16_t len);
+int db_store_put(db_store_t* db, const char* key, const void* value, uint16_t len);
+int db_store_delete(db_store_t* db, const char* key);
+int db_store_commit(db_store_t* db);
+
+// Devuelve la longitud del valor (copiado hasta 'cap') o DB_ERR_NOT_FOUND
+int db_store_get(db_store_t* db, const char* key, void* value, uint16_t cap);
+// Muestras de 'series' con t0 <= ts <= t1 en orden de escritura, incluido el
+// lote pendiente. El callback devuelve false para parar. Devuelve cuántas entregó.
+int db_store_query(db_store_t* db, uint16_t series, uint32_t t0, uint32_t t1, db_sample_cb_t cb, void* user);
+
+uint32_t db_store_free_segments(const db_store_t* db);
+// Recicla el segmento más antiguo: copia lo vivo y lo borra. DB_ERR_NOT_FOUND si no hay candidato.
+int db_store_compact(db_store_t* db);
+
+void db_store_get_stats(const db_store_t* db, db_store_stats_t* out);
+
+#endif
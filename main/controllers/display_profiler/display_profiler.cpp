@@ -0,0 +1,207 @@
+#include "controllers/display_profiler/display_profiler.h"
+#include "esp_console.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+
+static const char* TAG = "DISP_PROF";
+
+#define OVERLAY_UPDATE_PERIOD_MS 500
+
+static std::atomic<bool> enabled{false};
+static lv_display_t* profiled_disp = nullptr;
+static lv_obj_t* overlay_label = nullptr;
+// Petición de overlay desde otra tarea (consola); la aplica la tarea de UI
+static std::atomic<bool> overlay_wanted{false};
+static uint32_t overlay_last_update_ms = 0;
+
+// Frame en curso. Los contadores se tocan desde la tarea de flush y desde el ISR
+static std::atomic<uint32_t> acc_transfer_us{0};
+static std::atomic<uint32_t> acc_flushed_bytes{0};
+static std::atomic<uint32_t> acc_draw_calls{0};
+static display_profiler_frame_t current = {};
+static int64_t frame_start_us = 0;
+static uint32_t frame_counter = 0;
+
+// Ring de frames terminados
+static portMUX_TYPE ring_lock = portMUX_INITIALIZER_UNLOCKED;
+static display_profiler_frame_t ring[DISPLAY_PROFILER_RING_SIZE];
+static uint32_t ring_head = 0;  // Próxima posición a escribir
+static uint32_t ring_count = 0;
+
+static void profiler_invalidate_cb(lv_event_t* e) {
+    if (!enabled) return;
+
+    const lv_area_t* area = (const lv_area_t*)lv_event_get_param(e);
+    if (!area) return;
+
+    if (current.area_count < DISPLAY_PROFILER_MAX_AREAS) {
+        current.areas[current.area_count] = *area;
+    }
+    current.area_count++;
+    current.invalidated_px += lv_area_get_size(area);
+}
+
+void display_profiler_init(lv_display_t* disp) {
+    profiled_disp = disp;
+    lv_display_add_event_cb(disp, profiler_invalidate_cb, LV_EVENT_INVALIDATE_AREA, nullptr);
+    enabled = DISPLAY_PROFILER_ENABLED != 0;
+    ESP_LOGI(TAG, "Profiler %s (%d frames)", enabled ? "activo" : "inactivo", DISPLAY_PROFILER_RING_SIZE);
+}
+
+void display_profiler_set_enabled(bool enable) {
+    enabled = enable;
+}
+
+void display_profiler_set_overlay(bool visible) {
+    overlay_wanted = visible;
+    if (visible && !overlay_label) {
+        overlay_label = lv_label_create(lv_layer_top());
+        lv_obj_set_style_bg_color(overlay_label, lv_color_black(), LV_PART_MAIN);
+        lv_obj_set_style_bg_opa(overlay_label, LV_OPA_70, LV_PART_MAIN);
+        lv_obj_set_style_text_color(overlay_label, lv_color_white(), LV_PART_MAIN);
+        lv_obj_set_style_text_font(overlay_label, &lv_font_montserrat_14, LV_PART_MAIN);
+        lv_obj_align(overlay_label, LV_ALIGN_BOTTOM_MID, 0, 0);
+        lv_label_set_text(overlay_label, "-");
+    } else if (!visible && overlay_label) {
+        lv_obj_del(overlay_label);
+        overlay_label = nullptr;
+    }
+}
+
+void display_profiler_reset() {
+    taskENTER_CRITICAL(&ring_lock);
+    ring_head = 0;
+    ring_count = 0;
+    taskEXIT_CRITICAL(&ring_lock);
+}
+
+void display_profiler_request_overlay(bool visible) {
+    overlay_wanted = visible;
+}
+
+void display_profiler_frame_begin() {
+    if (!enabled) return;
+    if (overlay_wanted != (overlay_label != nullptr)) {
+        display_profiler_set_overlay(overlay_wanted);
+    }
+    frame_start_us = esp_timer_get_time();
+}
+
+void display_profiler_frame_end(uint32_t period_us) {
+    if (!enabled) return;
+
+    current.frame = frame_counter++;
+    current.render_us = (uint32_t)(esp_timer_get_time() - frame_start_us);
+    current.transfer_us = acc_transfer_us.exchange(0);
+    current.flushed_bytes = acc_flushed_bytes.exchange(0);
+    current.draw_calls = (uint16_t)acc_draw_calls.exchange(0);
+    current.deadline_missed = current.render_us > period_us;
+
+    // Los frames sin actividad no ocupan sitio en el ring
+    if (current.area_count || current.draw_calls || current.transfer_us || current.deadline_missed) {
+        current.timestamp_ms = (uint32_t)(frame_start_us / 1000);
+
+        taskENTER_CRITICAL(&ring_lock);
+        ring[ring_head] = current;
+        ring_head = (ring_head + 1) % DISPLAY_PROFILER_RING_SIZE;
+        if (ring_count < DISPLAY_PROFILER_RING_SIZE) ring_count++;
+        taskEXIT_CRITICAL(&ring_lock);
+
+        if (overlay_label && current.timestamp_ms - overlay_last_update_ms >= OVERLAY_UPDATE_PERIOD_MS) {
+            overlay_last_update_ms = current.timestamp_ms;
+            lv_label_set_text_fmt(overlay_label, "R %lu us  T %lu us  %lu B  %u A",
+                                  (unsigned long)current.render_us, (unsigned long)current.transfer_us,
+                                  (unsigned long)current.flushed_bytes, current.area_count);
+        }
+    }
+
+    current = {};
+}
+
+void display_profiler_on_flush(const lv_area_t* area) {
+    if (!enabled) return;
+    acc_draw_calls++;
+    acc_flushed_bytes += lv_area_get_size(area) * (LV_COLOR_DEPTH / 8); // RGB565: sizeof(lv_color_t) es 3
+}
+
+void display_profiler_on_transfer_done(uint32_t transfer_us) {
+    if (!enabled) return;
+    acc_transfer_us += transfer_us;
+}
+
+uint32_t display_profiler_get_frames(display_profiler_frame_t* out, uint32_t max) {
+    taskENTER_CRITICAL(&ring_lock);
+    const uint32_t count = ring_count < max ? ring_count : max;
+    const uint32_t first = (ring_head + DISPLAY_PROFILER_RING_SIZE - count) % DISPLAY_PROFILER_RING_SIZE;
+    for (uint32_t i = 0; i < count; i++) {
+        out[i] = ring[(first + i) % DISPLAY_PROFILER_RING_SIZE];
+    }
+    taskEXIT_CRITICAL(&ring_lock);
+    return count;
+}
+
+void display_profiler_dump() {
+    static display_profiler_frame_t frames[DISPLAY_PROFILER_RING_SIZE];
+    const uint32_t count = display_profiler_get_frames(frames, DISPLAY_PROFILER_RING_SIZE);
+    const uint32_t full_screen_px = lv_display_get_horizontal_resolution(profiled_disp) *
+                                    lv_display_get_vertical_resolution(profiled_disp);
+
+    uint32_t missed = 0;
+    uint32_t full_redraws = 0;
+
+    printf("frame,t_ms,render_us,transfer_us,bytes,draw_calls,inval_px,areas\n");
+    for (uint32_t i = 0; i < count; i++) {
+        const display_profiler_frame_t& f = frames[i];
+        printf("%lu,%lu,%lu,%lu,%lu,%u,%lu,%u%s",
+               (unsigned long)f.frame, (unsigned long)f.timestamp_ms, (unsigned long)f.render_us,
+               (unsigned long)f.transfer_us, (unsigned long)f.flushed_bytes, f.draw_calls,
+               (unsigned long)f.invalidated_px, f.area_count, f.deadline_missed ? " MISS" : "");
+
+        const uint16_t stored = f.area_count < DISPLAY_PROFILER_MAX_AREAS ? f.area_count : DISPLAY_PROFILER_MAX_AREAS;
+        for (uint16_t a = 0; a < stored; a++) {
+            printf(" (%ld,%ld)-(%ld,%ld)", (long)f.areas[a].x1, (long)f.areas[a].y1,
+                   (long)f.areas[a].x2, (long)f.areas[a].y2);
+        }
+        printf("\n");
+
+        if (f.deadline_missed) missed++;
+        if (f.invalidated_px >= full_screen_px) full_redraws++;
+    }
+    printf("frames=%lu missed_deadlines=%lu full_screen_redraws=%lu\n",
+           (unsigned long)count, (unsigned long)missed, (unsigned long)full_redraws);
+}
+
+static int dprof_cmd(int argc, char** argv) {
+    if (argc == 2 && strcmp(argv[1], "dump") == 0) {
+        if (!DISPLAY_PROFILER_ENABLED) {
+            printf("display profiler disabled (DISPLAY_PROFILER_ENABLED 0)\n");
+            return 1;
+        }
+        display_profiler_dump();
+        return 0;
+    }
+    if (argc == 3 && strcmp(argv[1], "overlay") == 0 &&
+        (strcmp(argv[2], "on") == 0 || strcmp(argv[2], "off") == 0)) {
+        if (!DISPLAY_PROFILER_ENABLED) {
+            printf("display profiler disabled (DISPLAY_PROFILER_ENABLED 0)\n");
+            return 1;
+        }
+        display_profiler_request_overlay(strcmp(argv[2], "on") == 0);
+        return 0;
+    }
+    printf("usage: dprof dump | dprof overlay on|off\n");
+    return 1;
+}
+
+esp_err_t display_profiler_console_register() {
+    esp_console_cmd_t cmd = {};
+    cmd.command = "dprof";
+    cmd.help = "Display profiler: 'dump' prints the frame ring, 'overlay on|off' toggles the on-screen label";
+    cmd.hint = "dump | overlay on|off";
+    cmd.func = dprof_cmd;
+    return esp_console_cmd_register(&cmd);
+}
@@ -0,0 +1,58 @@
+#ifndef DISPLAY_PROFILER_H
+#define DISPLAY_PROFILER_H
+
+#include "lvgl.h"
+#include "esp_err.h"
+#include "config.h"
+#include <stdint.h>
+
+#define DISPLAY_PROFILER_MAX_AREAS 4
+
+// Un registro por frame en el que algo se invalidó o se envió al panel
+typedef struct {
+    uint32_t frame;                 // Número de iteración de lv_timer_handler
+    uint32_t timestamp_ms;
+    uint32_t render_us;             // Duración de lv_timer_handler
+    uint32_t transfer_us;           // Tiempo de bus de los strips terminados en este frame
+    uint32_t flushed_bytes;         // Bytes enviados a EXAMPLE_LCD_PIXEL_CLOCK_HZ
+    uint32_t invalidated_px;
+    uint16_t draw_calls;            // Llamadas a esp_lcd_panel_draw_bitmap
+    uint16_t area_count;            // Áreas invalidadas (puede superar las guardadas)
+    lv_area_t areas[DISPLAY_PROFILER_MAX_AREAS];
+    bool deadline_missed;           // El frame superó el periodo objetivo
+} display_profiler_frame_t;
+
+void display_profiler_init(lv_display_t* disp);
+void display_profiler_set_enabled(bool enabled);
+void display_profiler_set_overlay(bool visible);             // Solo desde la tarea de UI
+void display_profiler_request_overlay(bool visible);         // Desde cualquier tarea: se aplica en el próximo frame
+void display_profiler_reset();
+
+// Copia hasta 'max' frames, del más antiguo al más reciente. Devuelve cuántos copió.
+uint32_t display_profiler_get_frames(display_profiler_frame_t* out, uint32_t max);
+
+// Vuelca el ring por consola en texto, con un resumen de redibujados completos.
+void display_profiler_dump();
+
+// Comando "dprof dump|overlay on|off"; lo registra telemetry_console_start junto a "telemetry"
+esp_err_t display_profiler_console_register();
+
+// Puntos de instrumentación (usar las macros de abajo)
+void display_profiler_frame_begin();
+void display_profiler_frame_end(uint32_t period_us);
+void display_profiler_on_flush(const lv_area_t* area);
+void display_profiler_on_transfer_done(uint32_t transfer_us);
+
+#if DISPLAY_PROFILER_ENABLED
+#define DISPLAY_PROFILER_FRAME_BEGIN()              display_profiler_frame_begin()
+#define DISPLAY_PROFILER_FRAME_END(period_us)       display_profiler_frame_end(period_us)
+#define DISPLAY_PROFILER_FLUSH(area)                display_profiler_on_flush(area)
+#define DISPLAY_PROFILER_TRANSFER_DONE(us)          display_profiler_on_transfer_done(us)
+#else
+#define DISPLAY_PROFILER_FRAME_BEGIN()              do {} while (0)
+#define DISPLAY_PROFILER_FRAME_END(period_us)       do {} while (0)
+#define DISPLAY_PROFILER_FLUSH(area)                do {} while (0)
+#define DISPLAY_PROFILER_TRANSFER_DONE(us)          do {} while (0)
+#endif
+
+#endif
@@ -0,0 +1,289 @@
+#include "dlog.h"
+#include "utils/mpsc_ring.h"
+#include "esp_cpu.h"
+#include "esp_private/esp_clk.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+
+static const char* TAG = "DLOG";
+
+#define DLOG_TASK_STACK     3072
+#define DLOG_CORES          2
+
+// Cabecera de cada registro; detrás van 'count' palabras de argumentos
+typedef struct {
+    const dlog_desc_t* desc;
+    const char* tag;
+    uint32_t ts_us;             // 32 bits bajos de esp_timer (se reconstruye al formatear)
+} dlog_record_t;
+
+// Un ring por núcleo: los productores de un núcleo no tocan las líneas de
+// caché del otro. Una tarea sin afinidad que migre a mitad de llamada sigue
+// siendo correcta (MpscRing admite varios productores).
+static MpscRing rings[DLOG_CORES];
+static uint8_t ring_mem[DLOG_CORES][DLOG_RING_BYTES] __attribute__((aligned(8)));
+
+static std::atomic<bool> ready{false};
+static std::atomic<bool> decoder_waiting{false};
+static TaskHandle_t decoder_task = nullptr;
+static SemaphoreHandle_t decode_lock = nullptr;     // Un solo consumidor: tarea o dlog_flush
+
+static std::atomic<uint32_t> written{0};
+static std::atomic<uint32_t> dropped{0};
+static std::atomic<uint32_t> truncated{0};
+static std::atomic<uint32_t> direct{0};
+static std::atomic<uint32_t> ring_used_max{0};
+static uint32_t decoded = 0;
+static uint32_t decode_us_max = 0;
+
+bool dlog_write(const dlog_desc_t* desc, const char* tag, const uint32_t* words, uint32_t count) {
+    if (!ready.load(std::memory_order_acquire)) {
+        direct.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    if (count > DLOG_MAX_WORDS) {
+        count = DLOG_MAX_WORDS;
+        truncated.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    MpscRing& ring = rings[esp_cpu_get_core_id()];
+    const uint32_t len = sizeof(dlog_record_t) + count * sizeof(uint32_t);
+    uint8_t* payload = ring.reserve(len, (uint16_t)desc->level);
+    if (!payload) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    dlog_record_t* rec = (dlog_record_t*)payload;
+    rec->desc = desc;
+    rec->tag = tag;
+    rec->ts_us = (uint32_t)esp_timer_get_time();
+    if (count) {
+        memcpy(rec + 1, words, count * sizeof(uint32_t));
+    }
+    ring.commit(payload);
+    written.fetch_add(1, std::memory_order_relaxed);
+
+    const uint32_t used = ring.used();
+    if (used > ring_used_max.load(std::memory_order_relaxed)) {
+        ring_used_max.store(used, std::memory_order_relaxed);
+    }
+
+    // Solo se despierta al decodificador si está dormido: una ráfaga cuesta una
+    // notificación. La barrera empareja con la de dlog_task_fn (ver allí).
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (decoder_waiting.load(std::memory_order_acquire) && decoder_waiting.exchange(false)) {
+        if (xPortInIsrContext()) {
+            BaseType_t woken = pdFALSE;
+            vTaskNotifyGiveFromISR(decoder_task, &woken);
+            portYIELD_FROM_ISR(woken);
+        } else {
+            xTaskNotifyGive(decoder_task);
+        }
+    }
+    return true;
+}
+
+static char level_letter(esp_log_level_t level) {
+    static const char letters[] = { 'N', 'E', 'W', 'I', 'D', 'V' };
+    return level < sizeof(letters) ? letters[level] : '?';
+}
+
+// Registro más antiguo de los dos rings (las marcas de 32 bits se comparan con signo)
+static MpscRing* oldest_ring(const dlog_record_t** out, uint32_t* len) {
+    MpscRing* best = nullptr;
+    for (MpscRing& ring : rings) {
+        uint32_t l;
+        uint16_t tag;
+        const dlog_record_t* rec = (const dlog_record_t*)ring.peek(&l, &tag);
+        if (rec && (!best || (int32_t)(rec->ts_us - (*out)->ts_us) < 0)) {
+            best = &ring;
+            *out = rec;
+            *len = l;
+        }
+    }
+    return best;
+}
+
+// Formatea y escribe todo lo publicado. Llamar con decode_lock tomado.
+static uint32_t drain_locked() {
+    static char line[DLOG_LINE_MAX];
+    uint32_t count = 0;
+
+    const dlog_record_t* rec = nullptr;
+    uint32_t len = 0;
+    while (MpscRing* ring = oldest_ring(&rec, &len)) {
+        const int64_t t_start = esp_timer_get_time();
+        const uint32_t words = (len - sizeof(dlog_record_t)) / sizeof(uint32_t);
+        dlog_format(line, sizeof(line), rec->desc->fmt, (const uint32_t*)(rec + 1), words);
+
+        // Marca de tiempo completa: el registro es más antiguo que 'now' y de hace menos de 71 minutos
+        const uint64_t now = (uint64_t)t_start;
+        uint64_t ts = (now & ~0xFFFFFFFFull) | rec->ts_us;
+        if (ts > now) ts -= 1ull << 32;
+
+        esp_log_write(rec->desc->level, rec->tag, "%c (%lu) %s: %s\n", level_letter(rec->desc->level),
+                      (unsigned long)(ts / 1000), rec->tag, line);
+        ring->release();
+        count++;
+
+        const uint32_t elapsed = (uint32_t)(esp_timer_get_time() - t_start);
+        if (elapsed > decode_us_max) decode_us_max = elapsed;
+    }
+    decoded += count;
+    return count;
+}
+
+static bool rings_empty() {
+    for (MpscRing& ring : rings) {
+        if (ring.used()) return false;
+    }
+    return true;
+}
+
+static void dlog_task_fn(void* arg) {
+    for (;;) {
+        xSemaphoreTake(decode_lock, portMAX_DELAY);
+        const uint32_t count = drain_locked();
+        xSemaphoreGive(decode_lock);
+
+        // Se anuncia que va a dormir y se vuelve a mirar: un registro publicado
+        // entre medias, o ve el aviso y notifica, o aparece en esta comprobación.
+        decoder_waiting.store(true);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (rings_empty()) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        } else if (!count) {
+            vTaskDelay(1);  // Reservado pero sin publicar: el productor sigue copiando
+        }
+        decoder_waiting.store(false);
+    }
+}
+
+esp_err_t dlog_init() {
+    if (ready) return ESP_OK;
+
+    for (int i = 0; i < DLOG_CORES; i++) {
+        if (!rings[i].init(ring_mem[i], DLOG_RING_BYTES)) return ESP_ERR_INVALID_SIZE;
+    }
+    decode_lock = xSemaphoreCreateMutex();
+    if (!decode_lock || xTaskCreatePinnedToCore(dlog_task_fn, "dlog", DLOG_TASK_STACK, nullptr,
+                                                DLOG_TASK_PRIORITY, &decoder_task, DLOG_TASK_CORE) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    ready.store(true, std::memory_order_release);
+    ESP_LOGI(TAG, "Log diferido: %d rings de %d bytes", DLOG_CORES, DLOG_RING_BYTES);
+    return ESP_OK;
+}
+
+void dlog_flush() {
+    if (!ready) return;
+    xSemaphoreTake(decode_lock, portMAX_DELAY);
+    drain_locked();
+    xSemaphoreGive(decode_lock);
+}
+
+void dlog_get_stats(dlog_stats_t* out) {
+    if (!out) return;
+    *out = {};
+    out->written = written.load();
+    out->dropped = dropped.load();
+    out->truncated = truncated.load();
+    out->direct = direct.load();
+    out->ring_bytes = DLOG_RING_BYTES;
+    out->ring_used_max = ring_used_max.load();
+    if (decode_lock) {
+        xSemaphoreTake(decode_lock, portMAX_DELAY);
+        out->decoded = decoded;
+        out->decode_us_max = decode_us_max;
+        xSemaphoreGive(decode_lock);
+    }
+}
+
+typedef struct {
+    uint64_t total;
+    uint32_t max;
+} bench_cycles_t;
+
+static void bench_print(const char* mode, uint32_t calls, const bench_cycles_t& c, uint32_t drops) {
+    const uint32_t avg = calls ? (uint32_t)(c.total / calls) : 0;
+    printf("DLOGBENCH,%s,%lu,%lu,%lu,%lu,%lu\n", mode, (unsigned long)calls, (unsigned long)avg,
+           (unsigned long)c.max, (unsigned long)((uint64_t)avg * 1000000000ULL / esp_clk_cpu_freq()),
+           (unsigned long)drops);
+}
+
+void dlog_benchmark(uint32_t calls) {
+    static const char* BENCH_TAG = "DLOG_BENCH";
+    if (!ready) {
+        ESP_LOGW(TAG, "dlog no inicializado: sin benchmark");
+        return;
+    }
+    ESP_LOGI(TAG, "Benchmark de log: %lu llamadas por modo", (unsigned long)calls);
+
+    // Con el lock tomado la tarea no consume: el benchmark decide cuándo se vacía el ring
+    xSemaphoreTake(decode_lock, portMAX_DELAY);
+    drain_locked();
+    // Registros que caben seguro en el ring de este núcleo antes de vaciarlo
+    const uint32_t batch = DLOG_RING_BYTES / 2 / MpscRing::record_bytes(sizeof(dlog_record_t) + 2 * sizeof(uint32_t));
+
+    printf("DLOGBENCH,mode,calls,cycles_avg,cycles_max,ns_avg,dropped\n");
+
+    // Antes: formateo y escritura síncronos por la UART
+    bench_cycles_t c = {};
+    for (uint32_t i = 0; i < calls; i++) {
+        const uint32_t c0 = esp_cpu_get_cycle_count();
+        ESP_LOGI(BENCH_TAG, "bench %lu value %d", (unsigned long)i, -(int)i);
+        const uint32_t dt = esp_cpu_get_cycle_count() - c0;
+        c.total += dt;
+        if (dt > c.max) c.max = dt;
+    }
+    bench_print("esp_log", calls, c, 0);
+
+    // Después: solo el registro binario. El ring se vacía fuera de la medida.
+    c = {};
+    uint32_t drops_before = dropped.load();
+    for (uint32_t i = 0; i < calls; i++) {
+        if (i % batch == 0) drain_locked();
+        const uint32_t c0 = esp_cpu_get_cycle_count();
+        DLOGI(BENCH_TAG, "bench %lu value %d", (unsigned long)i, -(int)i);
+        const uint32_t dt = esp_cpu_get_cycle_count() - c0;
+        c.total += dt;
+        if (dt > c.max) c.max = dt;
+    }
+    bench_print("dlog", calls, c, dropped.load() - drops_before);
+
+    // Coste diferido: formatear y escribir un registro desde la tarea
+    drain_locked();
+    const uint32_t pending = calls < batch ? calls : batch;
+    for (uint32_t i = 0; i < pending; i++) {
+        DLOGI(BENCH_TAG, "bench %lu value %d", (unsigned long)i, -(int)i);
+    }
+    const uint32_t d0 = esp_cpu_get_cycle_count();
+    const uint32_t n = drain_locked();
+    c = { (uint64_t)(esp_cpu_get_cycle_count() - d0), 0 };
+    bench_print("decode", n, c, 0);
+
+    // Ring lleno: lo que cuesta descartar (el peor caso de una ráfaga)
+    drops_before = dropped.load();
+    for (uint32_t i = 0; i < 4 * batch && dropped.load() == drops_before; i++) {
+        DLOGI(BENCH_TAG, "fill %lu", (unsigned long)i);
+    }
+    c = {};
+    drops_before = dropped.load();
+    for (uint32_t i = 0; i < calls; i++) {
+        const uint32_t c0 = esp_cpu_get_cycle_count();
+        DLOGI(BENCH_TAG, "bench %lu value %d", (unsigned long)i, -(int)i);
+        const uint32_t dt = esp_cpu_get_cycle_count() - c0;
+        c.total += dt;
+        if (dt > c.max) c.max = dt;
+    }
+    bench_print("dlog_full", calls, c, dropped.load() - drops_before);
+
+    drain_locked();
+    xSemaphoreGive(decode_lock);
+}
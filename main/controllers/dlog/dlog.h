@@ -0,0 +1,86 @@
+#ifndef DLOG_H
+#define DLOG_H
+
+#include "esp_err.h"
+#include "esp_log.h"
+#include "config.h"
+#include "dlog_format.h"
+#include <stdint.h>
+
+// Log diferido. En el punto de llamada solo se guarda un registro binario:
+// el descriptor estático del mensaje (su dirección es el id, fijado al
+// compilar), el tag, la marca de tiempo y los argumentos en crudo. Va a un
+// MpscRing por núcleo, sin locks, así que sirve también dentro de ISRs. La
+// tarea 'dlog' (baja prioridad) formatea y escribe por esp_log_write más tarde.
+//
+// Las macros DLOGx tienen la misma firma que ESP_LOGx: convertir una llamada
+// es cambiar el nombre. Limitación: %s guarda el puntero, no la cadena, así
+// que solo vale para cadenas que sigan vivas al formatear (literales, TAG,
+// nombres de vistas...), nunca buffers en la pila.
+
+typedef struct {
+    esp_log_level_t level;
+    const char* fmt;
+} dlog_desc_t;
+
+typedef struct {
+    uint32_t written;           // Registros guardados en los rings
+    uint32_t dropped;           // Perdidos por ring lleno
+    uint32_t truncated;         // Con más argumentos de los que caben (DLOG_MAX_WORDS)
+    uint32_t direct;            // Escritos con ESP_LOG porque dlog aún no estaba listo
+    uint32_t decoded;
+    uint32_t ring_bytes;        // Capacidad de cada ring
+    uint32_t ring_used_max;     // Mayor ocupación vista en cualquier ring
+    uint32_t decode_us_max;     // Peor formateo + escritura de un registro
+} dlog_stats_t;
+
+esp_err_t dlog_init();
+
+// Guarda un registro. false = dlog no está listo (el llamador escribe en directo).
+// Con el ring lleno devuelve true y cuenta el registro en 'dropped'.
+bool dlog_write(const dlog_desc_t* desc, const char* tag, const uint32_t* words, uint32_t count);
+
+// Formatea ya todo lo pendiente desde la tarea que llama (antes de dormir o de un reset)
+void dlog_flush();
+
+void dlog_get_stats(dlog_stats_t* out);
+
+// Coste por llamada de ESP_LOGI frente a DLOGI (con sitio y con el ring lleno)
+// y coste de formateo por registro. Una línea DLOGBENCH por modo.
+void dlog_benchmark(uint32_t calls);
+
+template <typename... Args>
+inline bool dlog_emit(const dlog_desc_t* desc, const char* tag, Args... args) {
+    if constexpr (sizeof...(Args) == 0) {
+        return dlog_write(desc, tag, nullptr, 0);
+    } else {
+        uint32_t words[(dlog_arg_words<Args>() + ...)];
+        uint32_t n = 0;
+        (dlog_pack_arg(words, n, args), ...);
+        return dlog_write(desc, tag, words, n);
+    }
+}
+
+#if DLOG_ENABLED
+// El descriptor es static const con inicialización constante: sin guardas ni
+// código en tiempo de ejecución. Los niveles por encima de LOG_LOCAL_LEVEL
+// desaparecen al compilar, igual que con ESP_LOG.
+#define DLOG_LEVEL(level, tag, format, ...) do {                                    \
+        if (LOG_LOCAL_LEVEL >= (level)) {                                           \
+            static const dlog_desc_t dlog_desc_ = { (level), (format) };            \
+            if (!dlog_emit(&dlog_desc_, (tag), ##__VA_ARGS__)) {                    \
+                ESP_LOG_LEVEL_LOCAL((level), (tag), format, ##__VA_ARGS__);         \
+            }                                                                       \
+        }                                                                           \
+    } while (0)
+#else
+#define DLOG_LEVEL(level, tag, format, ...) ESP_LOG_LEVEL_LOCAL((level), (tag), format, ##__VA_ARGS__)
+#endif
+
+#define DLOGE(tag, format, ...) DLOG_LEVEL(ESP_LOG_ERROR,   tag, format, ##__VA_ARGS__)
+#define DLOGW(tag, format, ...) DLOG_LEVEL(ESP_LOG_WARN,    tag, format, ##__VA_ARGS__)
+#define DLOGI(tag, format, ...) DLOG_LEVEL(ESP_LOG_INFO,    tag, format, ##__VA_ARGS__)
+#define DLOGD(tag, format, ...) DLOG_LEVEL(ESP_LOG_DEBUG,   tag, format, ##__VA_ARGS__)
+#define DLOGV(tag, format, ...) DLOG_LEVEL(ESP_LOG_VERBOSE, tag, format, ##__VA_ARGS__)
+
+#endif
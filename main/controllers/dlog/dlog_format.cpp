@@ -0,0 +1,126 @@
+#include "dlog_format.h"
+#include <cstdio>
+
+// Copia 'len' bytes a la salida sin pasarse de 'cap' (siempre deja sitio al '\0')
+static void emit(char* out, size_t cap, size_t& pos, const char* src, size_t len) {
+    if (pos + 1 >= cap) {
+        pos += len;
+        return;
+    }
+    const size_t room = cap - 1 - pos;
+    memcpy(out + pos, src, len < room ? len : room);
+    pos += len;
+}
+
+size_t dlog_format(char* out, size_t cap, const char* fmt, const uint32_t* words, uint32_t count) {
+    if (!out || cap == 0) return 0;
+    size_t pos = 0;
+    uint32_t w = 0;
+
+    const char* p = fmt;
+    while (*p) {
+        // Texto literal hasta el siguiente '%'
+        const char* lit = p;
+        while (*p && *p != '%') p++;
+        if (p > lit) emit(out, cap, pos, lit, (size_t)(p - lit));
+        if (!*p) break;
+
+        if (p[1] == '%') {
+            emit(out, cap, pos, "%", 1);
+            p += 2;
+            continue;
+        }
+
+        // Especificación: flags, ancho y precisión se conservan; la longitud
+        // se reescribe según lo que se empaquetó ('ll' para 64 bits, nada si no)
+        char spec[24];
+        size_t s = 0;
+        spec[s++] = *p++;
+        while (*p && strchr("-+ #0", *p) && s < 8) spec[s++] = *p++;
+        while (*p && ((*p >= '0' && *p <= '9') || *p == '.') && s < 16) spec[s++] = *p++;
+
+        bool wide = false;
+        if (p[0] == 'l' && p[1] == 'l') { wide = true; p += 2; }
+        else if (*p == 'j') { wide = true; p++; }
+        else if (*p == 'l' || *p == 'z' || *p == 't') { wide = sizeof(long) > 4; p++; }   // 64 bits en un PC
+        else if (p[0] == 'h' && p[1] == 'h') { p += 2; }
+        else if (*p == 'h' || *p == 'L') { p++; }
+
+        const char conv = *p;
+        if (!conv) break;
+        p++;
+
+        uint32_t need;
+        switch (conv) {
+            case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+                need = 2;
+                break;
+            case 's': case 'p':
+                need = sizeof(uintptr_t) / 4;
+                break;
+            default:
+                need = wide ? 2 : 1;
+                break;
+        }
+        if (w + need > count) {
+            emit(out, cap, pos, "?", 1);
+            continue;
+        }
+
+        char tmp[64];
+        int len = 0;
+        switch (conv) {
+            case 'd': case 'i': case 'u': case 'o': case 'x': case 'X': case 'c': {
+                if (wide) {
+                    spec[s++] = 'l';
+                    spec[s++] = 'l';
+                }
+                spec[s++] = conv;
+                spec[s] = '\0';
+                if (wide) {
+                    uint64_t v;
+                    memcpy(&v, words + w, sizeof(v));
+                    len = snprintf(tmp, sizeof(tmp), spec, (unsigned long long)v);
+                } else {
+                    len = snprintf(tmp, sizeof(tmp), spec, (unsigned)words[w]);
+                }
+                break;
+            }
+            case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A': {
+                double d;
+                memcpy(&d, words + w, sizeof(d));
+                spec[s++] = conv;
+                spec[s] = '\0';
+                len = snprintf(tmp, sizeof(tmp), spec, d);
+                break;
+            }
+            case 's': case 'p': {
+                uintptr_t ptr;
+                memcpy(&ptr, words + w, sizeof(ptr));
+                spec[s++] = conv;
+                spec[s] = '\0';
+                if (conv == 's') {
+                    // La cadena puede ser larga: se formatea directamente en la salida
+                    const char* str = ptr ? (const char*)ptr : "(null)";
+                    len = snprintf(pos < cap ? out + pos : nullptr, pos < cap ? cap - pos : 0, spec, str);
+                    pos += len > 0 ? (size_t)len : 0;
+                    w += need;
+                    continue;
+                }
+                len = snprintf(tmp, sizeof(tmp), spec, (void*)ptr);
+                break;
+            }
+            default:
+                // Conversión desconocida: se copia tal cual sin consumir argumentos
+                spec[s++] = conv;
+                emit(out, cap, pos, spec, s);
+                continue;
+        }
+        w += need;
+        if (len > 0) emit(out, cap, pos, tmp, (size_t)len < sizeof(tmp) ? (size_t)len : sizeof(tmp) - 1);
+    }
+
+    const size_t end = pos < cap ? pos : cap - 1;
+    out[end] = '\0';
+    return end;
+}
@@ -0,0 +1,48 @@
+#ifndef DLOG_FORMAT_H
+#define DLOG_FORMAT_H
+
+// Empaquetado y formateo de los argumentos del log diferido, sin dependencias
+// de ESP-IDF: el mismo código corre en la tarea decodificadora y en un PC.
+//
+// Cada argumento se guarda en palabras de 32 bits según su tipo:
+//  * enteros de hasta 32 bits, bool y enums: 1 palabra
+//  * enteros de 64 bits: 2 palabras (%lld, %llu, %jd...)
+//  * float y double: 2 palabras, siempre como double (lo que espera printf)
+//  * punteros (%s, %p): sizeof(uintptr_t) / 4 palabras
+// Al formatear, el formato dice cuántas palabras consume cada conversión.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+template <typename T>
+constexpr uint32_t dlog_arg_words() {
+    using U = std::decay_t<T>;
+    if constexpr (std::is_floating_point_v<U>) return 2;
+    else if constexpr (std::is_pointer_v<U>) return sizeof(uintptr_t) / 4;
+    else return sizeof(U) > 4 ? 2 : 1;
+}
+
+template <typename T>
+inline void dlog_pack_arg(uint32_t* words, uint32_t& n, T value) {
+    if constexpr (std::is_floating_point_v<T>) {
+        const double d = value;
+        memcpy(words + n, &d, sizeof(d));
+    } else if constexpr (std::is_pointer_v<T>) {
+        const uintptr_t p = (uintptr_t)value;
+        memcpy(words + n, &p, sizeof(p));
+    } else if constexpr (sizeof(T) > 4) {
+        const uint64_t x = (uint64_t)value;
+        memcpy(words + n, &x, sizeof(x));
+    } else {
+        words[n] = (uint32_t)value;
+    }
+    n += dlog_arg_words<T>();
+}
+
+// Formatea 'fmt' con los argumentos empaquetados en 'words'. Las conversiones
+// que se queden sin palabras salen como "?". Devuelve la longitud escrita.
+size_t dlog_format(char* out, size_t cap, const char* fmt, const uint32_t* words, uint32_t count);
+
+#endif
@@ -0,0 +1,526 @@
+#include "controllers/draw_accel/draw_accel.h"
+#include "sdkconfig.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include <cstdio>
+#include <cstring>
+
+static const char* TAG = "DRAW_ACCEL";
+
+// Por debajo del 100 del renderer SW: LVGL nos da los FILL que aceptamos
+#define DRAW_ACCEL_PREFERENCE 80
+
+// Relleno con las instrucciones vectoriales (PIE) del ESP32-S3
+#if defined(CONFIG_IDF_TARGET_ESP32S3) && DRAW_ACCEL_PIE_ENABLED
+#define DRAW_ACCEL_USE_PIE 1
+#else
+#define DRAW_ACCEL_USE_PIE 0
+#endif
+
+// Máscara de lv_color_16_16_mix: separa R, G y B con huecos para el producto
+#define RGB565_MIX_MASK 0x7E0F81Fu
+
+static lv_draw_unit_t* accel_unit = nullptr;
+static draw_accel_stats_t stats = {};
+static bool claim_tasks = true;     // false: todo a lv_draw_sw (referencia del benchmark)
+
+void draw_accel_fill_rgb565(uint16_t* dst, uint32_t len, uint16_t color) {
+    // Cabeza hasta alinear a 16 bytes, así el cuerpo usa stores completos
+    while (len && ((uintptr_t)dst & 0xF)) {
+        *dst++ = color;
+        len--;
+    }
+
+#if DRAW_ACCEL_USE_PIE
+    uint32_t blocks = len >> 3; // 8 píxeles por registro q de 128 bits
+    if (blocks) {
+        const uint16_t c = color;
+        asm volatile(
+            "ee.vldbc.16 q0, %[c]\n"
+            "1:\n"
+            "ee.vst.128.ip q0, %[d], 16\n"
+            "addi %[n], %[n], -1\n"
+            "bnez %[n], 1b\n"
+            : [d] "+r"(dst), [n] "+r"(blocks)
+            : [c] "r"(&c)
+            : "memory");
+        len &= 7;
+    }
+#else
+    const uint32_t pair = color | ((uint32_t)color << 16);
+    uint32_t* dst32 = (uint32_t*)dst;
+    uint32_t words = len >> 1;
+    while (words >= 4) {
+        dst32[0] = pair;
+        dst32[1] = pair;
+        dst32[2] = pair;
+        dst32[3] = pair;
+        dst32 += 4;
+        words -= 4;
+    }
+    while (words--) {
+        *dst32++ = pair;
+    }
+    dst = (uint16_t*)dst32;
+    len &= 1;
+#endif
+
+    while (len--) {
+        *dst++ = color;
+    }
+}
+
+// Misma aritmética que lv_color_16_16_mix, con el color y la mezcla calculados
+// una vez por span. Como LVGL, reutiliza el resultado si el fondo no cambia.
+static void blend_span_scalar(uint16_t* dst, uint32_t len, uint32_t fg, uint32_t mix) {
+    if (len == 0) return;
+    uint16_t last_bg = (uint16_t)~dst[0];
+    uint16_t last_res = 0;
+    for (uint32_t i = 0; i < len; i++) {
+        const uint16_t bg16 = dst[i];
+        if (bg16 != last_bg) {
+            const uint32_t bg = (bg16 | ((uint32_t)bg16 << 16)) & RGB565_MIX_MASK;
+            const uint32_t res = ((((fg - bg) * mix) >> 5) + bg) & RGB565_MIX_MASK;
+            last_res = (uint16_t)((res >> 16) | res);
+            last_bg = bg16;
+        }
+        dst[i] = last_res;
+    }
+}
+
+#if DRAW_ACCEL_USE_PIE
+// Con el truco de 0x7E0F81F cada canal sale independiente de los demás:
+// c = bg + floor((fg - bg) * mix / 32). En carriles de 16 bits eso es una resta,
+// un ee.vmul.s16 con SAR = 5 y una suma por canal, 8 píxeles a la vez.
+// Orden de la tabla: máscara 5 bits, B, mix, R, máscara 6 bits, G.
+static void blend_blocks_pie(uint16_t* dst, uint32_t blocks, uint16_t color, uint32_t mix) {
+    alignas(16) uint16_t k[6][8];
+    const uint16_t values[6] = { 0x1F, (uint16_t)(color & 0x1F), (uint16_t)mix,
+                                 (uint16_t)(color >> 11), 0x3F, (uint16_t)((color >> 5) & 0x3F) };
+    for (int row = 0; row < 6; row++) {
+        for (int lane = 0; lane < 8; lane++) {
+            k[row][lane] = values[row];
+        }
+    }
+
+    uint16_t* kp = &k[0][0];
+    asm volatile(
+        "1:\n"
+        "ee.vld.128.ip q0, %[d], 0\n"      // Fondo
+        "ee.vld.128.ip q1, %[k], 16\n"     // 0x1F
+        "ee.vld.128.ip q6, %[k], 16\n"     // B del color
+        "ee.vld.128.ip q4, %[k], 16\n"     // mix
+        // B: bits 0-4
+        "ee.andq q2, q0, q1\n"
+        "ee.vsubs.s16 q3, q6, q2\n"
+        "ssai 5\n"
+        "ee.vmul.s16 q3, q3, q4\n"
+        "ee.vadds.s16 q5, q3, q2\n"
+        // R: bits 11-15 (desplazamiento en carriles de 32 bits y máscara)
+        "ssai 11\n"
+        "ee.vsr.32 q2, q0\n"
+        "ee.andq q2, q2, q1\n"
+        "ee.vld.128.ip q6, %[k], 16\n"     // R del color
+        "ee.vsubs.s16 q3, q6, q2\n"
+        "ssai 5\n"
+        "ee.vmul.s16 q3, q3, q4\n"
+        "ee.vadds.s16 q3, q3, q2\n"
+        "ssai 11\n"
+        "ee.vsl.32 q3, q3\n"
+        "ee.orq q5, q5, q3\n"
+        // G: bits 5-10
+        "ssai 5\n"
+        "ee.vsr.32 q2, q0\n"
+        "ee.vld.128.ip q1, %[k], 16\n"     // 0x3F
+        "ee.andq q2, q2, q1\n"
+        "ee.vld.128.ip q6, %[k], -80\n"    // G del color; k vuelve al principio
+        "ee.vsubs.s16 q3, q6, q2\n"
+        "ee.vmul.s16 q3, q3, q4\n"
+        "ee.vadds.s16 q3, q3, q2\n"
+        "ee.vsl.32 q3, q3\n"
+        "ee.orq q5, q5, q3\n"
+        "ee.vst.128.ip q5, %[d], 16\n"
+        "addi %[n], %[n], -1\n"
+        "bnez %[n], 1b\n"
+        : [d] "+r"(dst), [k] "+r"(kp), [n] "+r"(blocks)
+        :
+        : "memory");
+}
+#endif
+
+void draw_accel_blend_rgb565(uint16_t* dst, uint32_t len, uint16_t color, lv_opa_t opa) {
+    if (opa <= LV_OPA_MIN || len == 0) return;
+    if (opa >= LV_OPA_MAX) {
+        draw_accel_fill_rgb565(dst, len, color);
+        return;
+    }
+
+    const uint32_t fg = (color | ((uint32_t)color << 16)) & RGB565_MIX_MASK;
+    const uint32_t mix = ((uint32_t)opa + 4) >> 3;
+
+#if DRAW_ACCEL_USE_PIE
+    uint32_t head = (uint32_t)((16 - ((uintptr_t)dst & 0xF)) & 0xF) >> 1;
+    if (head > len) head = len;
+    blend_span_scalar(dst, head, fg, mix);
+    dst += head;
+    len -= head;
+
+    const uint32_t blocks = len >> 3;
+    if (blocks) {
+        blend_blocks_pie(dst, blocks, color, mix);
+        dst += blocks << 3;
+        len &= 7;
+    }
+#endif
+    blend_span_scalar(dst, len, fg, mix);
+}
+
+// Solo se usa en las filas de esquina: pocos píxeles, se llama a la función de LVGL
+void draw_accel_blend_mask_rgb565(uint16_t* dst, uint32_t len, uint16_t color, const lv_opa_t* mask, lv_opa_t opa) {
+    for (uint32_t i = 0; i < len; i++) {
+        const lv_opa_t m = opa >= LV_OPA_MAX ? mask[i] : (lv_opa_t)LV_OPA_MIX2(mask[i], opa);
+        if (m) {
+            dst[i] = lv_color_16_16_mix(color, dst[i], m);
+        }
+    }
+}
+
+static inline uint32_t swap_pair(uint32_t v) {
+    return ((v & 0x00FF00FFu) << 8) | ((v >> 8) & 0x00FF00FFu);
+}
+
+#if DRAW_ACCEL_USE_PIE
+// swap_pair sobre 4 palabras por registro: desplazamientos de 8 en carriles de
+// 32 bits y las dos máscaras. Vale en sitio (src == dst).
+static void swap_blocks_pie(uint16_t* dst, const uint16_t* src, uint32_t blocks) {
+    const uint32_t lo = 0x00FF00FFu;
+    const uint32_t hi = 0xFF00FF00u;
+    asm volatile(
+        "ee.vldbc.32 q3, %[lo]\n"
+        "ee.vldbc.32 q4, %[hi]\n"
+        "ssai 8\n"
+        "1:\n"
+        "ee.vld.128.ip q0, %[s], 16\n"
+        "ee.vsl.32 q1, q0\n"
+        "ee.vsr.32 q2, q0\n"
+        "ee.andq q1, q1, q4\n"
+        "ee.andq q2, q2, q3\n"
+        "ee.orq q1, q1, q2\n"
+        "ee.vst.128.ip q1, %[d], 16\n"
+        "addi %[n], %[n], -1\n"
+        "bnez %[n], 1b\n"
+        : [d] "+r"(dst), [s] "+r"(src), [n] "+r"(blocks)
+        : [lo] "r"(&lo), [hi] "r"(&hi)
+        : "memory");
+}
+#endif
+
+void draw_accel_swap_rgb565(uint16_t* buf, uint32_t len) {
+#if DRAW_ACCEL_USE_PIE
+    while (len && ((uintptr_t)buf & 0xF)) {
+        *buf = __builtin_bswap16(*buf);
+        buf++;
+        len--;
+    }
+    if (len >> 3) {
+        swap_blocks_pie(buf, buf, len >> 3);
+        buf += len & ~7u;
+        len &= 7;
+    }
+#endif
+    if (len && ((uintptr_t)buf & 0x2)) {
+        *buf = __builtin_bswap16(*buf);
+        buf++;
+        len--;
+    }
+
+    uint32_t* buf32 = (uint32_t*)buf;
+    for (uint32_t i = 0; i < (len >> 1); i++) {
+        buf32[i] = swap_pair(buf32[i]);
+    }
+    if (len & 1) {
+        buf[len - 1] = __builtin_bswap16(buf[len - 1]);
+    }
+}
+
+void draw_accel_swap_copy_rgb565(uint16_t* dst, const uint16_t* src, uint32_t len) {
+#if DRAW_ACCEL_USE_PIE
+    // Registros de 128 bits solo si origen y destino comparten alineación a 16 bytes
+    if ((((uintptr_t)dst ^ (uintptr_t)src) & 0xF) == 0) {
+        while (len && ((uintptr_t)dst & 0xF)) {
+            *dst++ = __builtin_bswap16(*src++);
+            len--;
+        }
+        if (len >> 3) {
+            swap_blocks_pie(dst, src, len >> 3);
+            dst += len & ~7u;
+            src += len & ~7u;
+            len &= 7;
+        }
+    }
+#endif
+    // Palabras de 32 bits solo si origen y destino comparten alineación
+    if ((((uintptr_t)dst ^ (uintptr_t)src) & 0x2) == 0) {
+        if (len && ((uintptr_t)dst & 0x2)) {
+            *dst++ = __builtin_bswap16(*src++);
+            len--;
+        }
+        uint32_t* dst32 = (uint32_t*)dst;
+        const uint32_t* src32 = (const uint32_t*)src;
+        for (uint32_t i = 0; i < (len >> 1); i++) {
+            dst32[i] = swap_pair(src32[i]);
+        }
+        dst += len & ~1u;
+        src += len & ~1u;
+        len &= 1;
+    }
+
+    while (len--) {
+        *dst++ = __builtin_bswap16(*src++);
+    }
+}
+
+// Réplica de lv_draw_sw_fill para color sólido: mismo recorte, mismo límite de
+// radio y las máscaras de esquina de LVGL, con los kernels de arriba.
+static void draw_accel_fill_task(lv_draw_unit_t* u, lv_draw_task_t* t) {
+    const lv_draw_fill_dsc_t* dsc = (const lv_draw_fill_dsc_t*)t->draw_dsc;
+    if (dsc->opa <= LV_OPA_MIN) return;
+
+    lv_area_t clipped;
+    if (!lv_area_intersect(&clipped, &t->area, u->clip_area)) return;
+
+    const lv_opa_t opa = dsc->opa >= LV_OPA_MAX ? LV_OPA_COVER : dsc->opa;
+    const uint16_t color = lv_color_to_u16(dsc->color);
+    const int32_t width = lv_area_get_width(&clipped);
+    lv_layer_t* layer = u->target_layer;
+
+    int32_t radius = dsc->radius;
+    const int32_t short_side = LV_MIN(lv_area_get_width(&t->area), lv_area_get_height(&t->area));
+    if (radius > short_side >> 1) radius = short_side >> 1;
+
+    lv_draw_sw_mask_radius_param_t radius_mask;
+    void* masks[2] = { &radius_mask, nullptr };
+    lv_opa_t* mask_buf = nullptr;
+    if (radius > 0) {
+        lv_draw_sw_mask_radius_init(&radius_mask, &t->area, radius, false);
+        mask_buf = (lv_opa_t*)lv_malloc(width);
+        LV_ASSERT_MALLOC(mask_buf);
+        stats.rounded_tasks++;
+    } else {
+        stats.fill_tasks++;
+    }
+    if (opa != LV_OPA_COVER) stats.blend_tasks++;
+
+    for (int32_t y = clipped.y1; y <= clipped.y2; y++) {
+        uint16_t* row = (uint16_t*)lv_draw_buf_goto_xy(layer->draw_buf, clipped.x1 - layer->buf_area.x1,
+                                                        y - layer->buf_area.y1);
+        const bool corner_row = radius > 0 && (y < t->area.y1 + radius || y > t->area.y2 - radius);
+
+        lv_draw_sw_mask_res_t res = LV_DRAW_SW_MASK_RES_FULL_COVER;
+        if (corner_row) {
+            lv_memset(mask_buf, 0xFF, width);
+            res = lv_draw_sw_mask_apply(masks, mask_buf, clipped.x1, y, width);
+        }
+
+        if (res == LV_DRAW_SW_MASK_RES_TRANSP) continue;
+        if (res == LV_DRAW_SW_MASK_RES_FULL_COVER) {
+            draw_accel_blend_rgb565(row, width, color, opa);
+        } else {
+            draw_accel_blend_mask_rgb565(row, width, color, mask_buf, opa);
+        }
+    }
+    stats.pixels += lv_area_get_size(&clipped);
+
+    if (radius > 0) {
+        lv_draw_sw_mask_free_param(&radius_mask);
+        lv_free(mask_buf);
+    }
+}
+
+static int32_t draw_accel_evaluate(lv_draw_unit_t* u, lv_draw_task_t* t) {
+    if (!claim_tasks || t->type != LV_DRAW_TASK_TYPE_FILL) return 0;
+
+    const lv_draw_fill_dsc_t* dsc = (const lv_draw_fill_dsc_t*)t->draw_dsc;
+    if (dsc->grad.dir != LV_GRAD_DIR_NONE) return 0;
+    if (dsc->base.layer->color_format != LV_COLOR_FORMAT_RGB565) return 0;
+
+    if (t->preference_score > DRAW_ACCEL_PREFERENCE) {
+        t->preference_score = DRAW_ACCEL_PREFERENCE;
+        t->preferred_draw_unit_id = DRAW_ACCEL_UNIT_ID;
+    }
+    return 0;
+}
+
+// Sin LV_USE_OS todo es síncrono: la tarea se ejecuta entera aquí dentro
+static int32_t draw_accel_dispatch(lv_draw_unit_t* u, lv_layer_t* layer) {
+    lv_draw_task_t* t = lv_draw_get_next_available_task(layer, nullptr, DRAW_ACCEL_UNIT_ID);
+    if (!t || t->preferred_draw_unit_id != DRAW_ACCEL_UNIT_ID) return LV_DRAW_UNIT_IDLE;
+    if (!lv_draw_layer_alloc_buf(layer)) return LV_DRAW_UNIT_IDLE;
+
+    t->state = LV_DRAW_TASK_STATE_IN_PROGRESS;
+    u->target_layer = layer;
+    u->clip_area = &t->clip_area;
+
+    const int64_t t_start = esp_timer_get_time();
+    draw_accel_fill_task(u, t);
+    stats.busy_us += (uint32_t)(esp_timer_get_time() - t_start);
+
+    t->state = LV_DRAW_TASK_STATE_READY;
+    lv_draw_dispatch_request();
+    return 1;
+}
+
+void draw_accel_init() {
+    if (accel_unit) return;
+
+    accel_unit = (lv_draw_unit_t*)lv_draw_create_unit(sizeof(lv_draw_unit_t));
+    accel_unit->evaluate_cb = draw_accel_evaluate;
+    accel_unit->dispatch_cb = draw_accel_dispatch;
+    ESP_LOGI(TAG, "Unidad de dibujo RGB565 registrada (%s)", DRAW_ACCEL_USE_PIE ? "PIE" : "escalar");
+}
+
+void draw_accel_get_stats(draw_accel_stats_t* out) {
+    if (!out) return;
+    *out = stats;
+}
+
+void draw_accel_reset_stats() {
+    stats = {};
+}
+
+// Escenas del benchmark: cada una dibuja los mismos tres rectángulos (uno
+// grande, uno recortado por arriba y por la izquierda y uno de 5 px de ancho en
+// una x impar) sobre un fondo de ruido, para cubrir cabeza, cuerpo y cola de los
+// kernels, las filas de esquina y el recorte.
+typedef struct {
+    const char* name;
+    int32_t radius;
+    lv_opa_t opa;
+} accel_scene_t;
+
+static const accel_scene_t accel_scenes[] = {
+    { "fill",    0,                LV_OPA_COVER },
+    { "blend70", 0,                LV_OPA_70 },
+    { "blend30", 0,                LV_OPA_30 },
+    { "round",   12,               LV_OPA_COVER },
+    { "round50", 12,               LV_OPA_50 },
+    { "pill",    LV_RADIUS_CIRCLE, LV_OPA_80 },
+};
+
+static void bench_pattern(uint16_t* buf, uint32_t len) {
+    uint32_t x = 0x12345678;
+    for (uint32_t i = 0; i < len; i++) {
+        x = x * 1664525u + 1013904223u;
+        buf[i] = (uint16_t)(x >> 16);
+    }
+}
+
+// Dibuja la escena en el canvas con lo que reclame cada unidad; devuelve los µs
+static uint32_t scene_render(lv_obj_t* canvas, lv_draw_buf_t* buf, const uint16_t* background,
+                             const accel_scene_t& scene) {
+    const int32_t w = buf->header.w;
+    const int32_t h = buf->header.h;
+    for (int32_t y = 0; y < h; y++) {
+        memcpy(lv_draw_buf_goto_xy(buf, 0, y), background + y * w, w * sizeof(uint16_t));
+    }
+    lv_canvas_set_draw_buf(canvas, buf);
+
+    const lv_area_t rects[] = {
+        { 8, 4, w - 9, h - 5 },
+        { -20, -10, w / 4, h / 2 },
+        { w - 13, 3, w - 9, h - 3 },
+    };
+    static const uint32_t colors[] = { 0xE0407A, 0x1E90FF, 0x7FFF00 };
+
+    const int64_t t_start = esp_timer_get_time();
+    lv_layer_t layer;
+    lv_canvas_init_layer(canvas, &layer);
+    for (size_t i = 0; i < sizeof(rects) / sizeof(rects[0]); i++) {
+        lv_draw_rect_dsc_t dsc;
+        lv_draw_rect_dsc_init(&dsc);
+        dsc.bg_color = lv_color_hex(colors[i]);
+        dsc.bg_opa = scene.opa;
+        dsc.radius = scene.radius;
+        lv_draw_rect(&layer, &dsc, &rects[i]);
+    }
+    lv_canvas_finish_layer(canvas, &layer);
+    return (uint32_t)(esp_timer_get_time() - t_start);
+}
+
+bool draw_accel_benchmark(uint32_t pixels) {
+    if (!accel_unit) {
+        ESP_LOGW(TAG, "Unidad no registrada: sin benchmark de kernels");
+        return false;
+    }
+
+    const int32_t w = SCREEN_WIDTH;
+    const int32_t h = (int32_t)(pixels / SCREEN_WIDTH);
+    const size_t bytes = (size_t)w * h * sizeof(uint16_t);
+    uint16_t* background = (uint16_t*)heap_caps_aligned_alloc(16, bytes, MALLOC_CAP_INTERNAL);
+    uint16_t* swap_ref = (uint16_t*)heap_caps_aligned_alloc(16, bytes, MALLOC_CAP_INTERNAL);
+    uint16_t* swap_out = (uint16_t*)heap_caps_aligned_alloc(16, bytes, MALLOC_CAP_INTERNAL);
+    lv_draw_buf_t* sw_buf = lv_draw_buf_create(w, h, LV_COLOR_FORMAT_RGB565, LV_STRIDE_AUTO);
+    lv_draw_buf_t* accel_buf = lv_draw_buf_create(w, h, LV_COLOR_FORMAT_RGB565, LV_STRIDE_AUTO);
+    if (!background || !swap_ref || !swap_out || !sw_buf || !accel_buf) {
+        ESP_LOGE(TAG, "Sin memoria para el benchmark de kernels");
+        heap_caps_free(background);
+        heap_caps_free(swap_ref);
+        heap_caps_free(swap_out);
+        if (sw_buf) lv_draw_buf_destroy(sw_buf);
+        if (accel_buf) lv_draw_buf_destroy(accel_buf);
+        return false;
+    }
+    bool all_exact = true;
+
+    // Canvas oculto: solo sirve para tener una capa RGB565 en la que dibujar
+    lv_obj_t* canvas = lv_canvas_create(lv_layer_top());
+    lv_obj_add_flag(canvas, LV_OBJ_FLAG_HIDDEN);
+    bench_pattern(background, w * h);
+
+    // Referencia: el mismo lv_draw_rect con esta unidad sin reclamar nada (lv_draw_sw)
+    printf("KBENCH,kernel,pixels,sw_us,accel_us,exact\n");
+    for (const accel_scene_t& scene : accel_scenes) {
+        claim_tasks = false;
+        const uint32_t sw_us = scene_render(canvas, sw_buf, background, scene);
+        claim_tasks = true;
+        const uint32_t accel_us = scene_render(canvas, accel_buf, background, scene);
+
+        bool exact = true;
+        for (int32_t y = 0; y < h && exact; y++) {
+            exact = memcmp(lv_draw_buf_goto_xy(sw_buf, 0, y), lv_draw_buf_goto_xy(accel_buf, 0, y),
+                           w * sizeof(uint16_t)) == 0;
+        }
+        all_exact &= exact;
+        printf("KBENCH,%s,%lu,%lu,%lu,%d\n", scene.name, (unsigned long)(w * h),
+               (unsigned long)sw_us, (unsigned long)accel_us, exact);
+    }
+
+    lv_obj_delete(canvas);
+    lv_draw_buf_destroy(sw_buf);
+    lv_draw_buf_destroy(accel_buf);
+
+    // Intercambio de bytes: lv_draw_sw_rgb565_swap en sitio frente a la copia,
+    // y la versión en sitio debe deshacerlo
+    memcpy(swap_ref, background, bytes);
+    int64_t t0 = esp_timer_get_time();
+    lv_draw_sw_rgb565_swap(swap_ref, w * h);
+    int64_t t1 = esp_timer_get_time();
+    draw_accel_swap_copy_rgb565(swap_out, background, w * h);
+    int64_t t2 = esp_timer_get_time();
+    bool exact = memcmp(swap_ref, swap_out, bytes) == 0;
+    draw_accel_swap_rgb565(swap_out, w * h);
+    exact &= memcmp(background, swap_out, bytes) == 0;
+    all_exact &= exact;
+    printf("KBENCH,swap,%lu,%lu,%lu,%d\n", (unsigned long)(w * h),
+           (unsigned long)(t1 - t0), (unsigned long)(t2 - t1), exact);
+
+    heap_caps_free(background);
+    heap_caps_free(swap_ref);
+    heap_caps_free(swap_out);
+
+    if (!all_exact) {
+        ESP_LOGE(TAG, "La unidad no dibuja igual que lv_draw_sw");
+    }
+    return all_exact;
+}
@@ -0,0 +1,40 @@
+#ifndef DRAW_ACCEL_H
+#define DRAW_ACCEL_H
+
+#include "lvgl.h"
+#include "config.h"
+#include <stdint.h>
+#include <stddef.h>
+
+// Id de la unidad de dibujo (no coincide con las de LVGL: SW = 1, GPUs < 10)
+#define DRAW_ACCEL_UNIT_ID 50
+
+typedef struct {
+    uint32_t fill_tasks;        // Rectángulos sin radio
+    uint32_t rounded_tasks;     // Rectángulos con radio (esquinas con máscara de LVGL)
+    uint32_t blend_tasks;       // Con opacidad < LV_OPA_MAX
+    uint32_t pixels;            // Píxeles escritos
+    uint32_t busy_us;           // Tiempo dentro de los kernels
+} draw_accel_stats_t;
+
+// Registra la unidad de dibujo. Reclama los FILL de color sólido sobre capas
+// RGB565; el resto sigue en el renderer software de LVGL.
+void draw_accel_init();
+void draw_accel_get_stats(draw_accel_stats_t* out);
+void draw_accel_reset_stats();
+
+// Kernels RGB565. Los resultados son idénticos bit a bit a los de lv_draw_sw.
+void draw_accel_fill_rgb565(uint16_t* dst, uint32_t len, uint16_t color);
+void draw_accel_blend_rgb565(uint16_t* dst, uint32_t len, uint16_t color, lv_opa_t opa);
+void draw_accel_blend_mask_rgb565(uint16_t* dst, uint32_t len, uint16_t color, const lv_opa_t* mask, lv_opa_t opa);
+
+// Intercambio de bytes para paneles que esperan RGB565 big-endian
+void draw_accel_swap_rgb565(uint16_t* buf, uint32_t len);
+void draw_accel_swap_copy_rgb565(uint16_t* dst, const uint16_t* src, uint32_t len);
+
+// Compara cada kernel con la referencia de LVGL (lv_color_16_16_mix píxel a
+// píxel) sobre 'pixels' píxeles en RAM interna: imprime una línea CSV por kernel
+// con los tiempos y devuelve false si algún resultado difiere en un solo bit.
+bool draw_accel_benchmark(uint32_t pixels);
+
+#endif
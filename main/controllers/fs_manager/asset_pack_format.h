@@ -0,0 +1,130 @@
+#ifndef ASSET_PACK_FORMAT_H
+#define ASSET_PACK_FORMAT_H
+
+// Formato binario del pack de assets que genera tools/pack_assets.py.
+// Solo tipos C y funciones inline sin dependencias de ESP-IDF ni LVGL: el
+// mismo código de búsqueda sirve sobre la partición mapeada o sobre un
+// fichero leído en memoria en el PC.
+//
+//   [asset_pack_header_t]
+//   [asset_pack_entry_t x entry_count]   ordenadas por name_hash
+//   [tabla de nombres]                   cadenas terminadas en '\0'
+//   [datos]                              cada asset alineado a ASSET_PACK_DATA_ALIGN
+//
+// Todo en little-endian. Los offsets de las entradas son desde el inicio del pack.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define ASSET_PACK_MAGIC        0x4B415041u     // "APAK"
+#define ASSET_PACK_VERSION      1
+#define ASSET_PACK_DATA_ALIGN   16
+
+typedef enum {
+    ASSET_TYPE_RAW = 0,
+    ASSET_TYPE_IMAGE = 1,       // Píxeles listos para lv_image_dsc_t (cf, w, h, stride en la entrada)
+    ASSET_TYPE_FONT = 2,        // asset_font_header_t + tablas de lv_font_fmt_txt
+} asset_type_t;
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t entry_count;
+    uint32_t names_offset;
+    uint32_t data_offset;
+    uint32_t total_size;        // Bytes del pack completo (lo que se mapea)
+    uint32_t index_crc32;       // CRC32 (zlib) de [sizeof(cabecera), data_offset): entradas y nombres
+    uint32_t reserved[2];
+} asset_pack_header_t;
+
+typedef struct {
+    uint32_t name_hash;         // FNV-1a de 32 bits del nombre
+    uint32_t name_offset;       // Desde el inicio del pack
+    uint32_t offset;
+    uint32_t size;
+    uint8_t type;               // asset_type_t
+    uint8_t cf;                 // lv_color_format_t (imágenes)
+    uint16_t w;
+    uint16_t h;
+    uint16_t stride;
+} asset_pack_entry_t;
+
+// Fuente: cabecera seguida de las tablas en el layout de lv_font_fmt_txt, de
+// modo que glyph_dsc, bitmaps y listas de cmap se usan directamente desde flash.
+// Offsets relativos al inicio del asset.
+typedef struct {
+    uint16_t line_height;
+    int16_t base_line;
+    int16_t underline_position;
+    int16_t underline_thickness;
+    uint8_t bpp;
+    uint8_t subpx;
+    uint16_t cmap_num;
+    uint32_t glyph_count;
+    uint32_t glyph_dsc_offset;  // lv_font_fmt_txt_glyph_dsc_t[glyph_count] (8 bytes cada una)
+    uint32_t bitmap_offset;
+    uint32_t cmaps_offset;      // asset_font_cmap_t[cmap_num]
+} asset_font_header_t;
+
+typedef struct {
+    uint32_t range_start;
+    uint16_t range_length;
+    uint16_t glyph_id_start;
+    uint32_t unicode_list_offset;       // 0 = sin lista
+    uint32_t glyph_id_ofs_list_offset;  // 0 = sin lista
+    uint16_t list_length;
+    uint8_t type;                       // lv_font_fmt_txt_cmap_type_t
+    uint8_t reserved;
+} asset_font_cmap_t;
+
+#ifdef __cplusplus
+static_assert(sizeof(asset_pack_header_t) == 32, "asset_pack_header_t");
+static_assert(sizeof(asset_pack_entry_t) == 24, "asset_pack_entry_t");
+static_assert(sizeof(asset_font_header_t) == 28, "asset_font_header_t");
+static_assert(sizeof(asset_font_cmap_t) == 20, "asset_font_cmap_t");
+#endif
+
+static inline uint32_t asset_pack_hash(const char* name) {
+    uint32_t h = 2166136261u;
+    while (*name) {
+        h ^= (uint8_t)*name++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// Comprueba cabecera y límites del índice. No calcula el CRC.
+static inline int asset_pack_check(const uint8_t* base, size_t size) {
+    if (size < sizeof(asset_pack_header_t)) return 0;
+    const asset_pack_header_t* hdr = (const asset_pack_header_t*)base;
+    if (hdr->magic != ASSET_PACK_MAGIC || hdr->version != ASSET_PACK_VERSION) return 0;
+    if (hdr->total_size > size) return 0;
+    const size_t index_end = sizeof(asset_pack_header_t) + (size_t)hdr->entry_count * sizeof(asset_pack_entry_t);
+    return index_end <= hdr->names_offset && hdr->names_offset <= hdr->data_offset &&
+           hdr->data_offset <= hdr->total_size;
+}
+
+// Búsqueda binaria por hash; el nombre se compara solo en la entrada candidata.
+// El empaquetador rechaza colisiones, así que a lo sumo hay una.
+static inline const asset_pack_entry_t* asset_pack_find(const uint8_t* base, const char* name) {
+    const asset_pack_header_t* hdr = (const asset_pack_header_t*)base;
+    const asset_pack_entry_t* entries = (const asset_pack_entry_t*)(base + sizeof(asset_pack_header_t));
+    const uint32_t hash = asset_pack_hash(name);
+
+    uint32_t lo = 0;
+    uint32_t hi = hdr->entry_count;
+    while (lo < hi) {
+        const uint32_t mid = (lo + hi) / 2;
+        if (entries[mid].name_hash < hash) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo == hdr->entry_count || entries[lo].name_hash != hash) return NULL;
+    if (strcmp((const char*)base + entries[lo].name_offset, name) != 0) return NULL;
+    return &entries[lo];
+}
+
+#endif
@@ -0,0 +1,259 @@
+#include "fs_manager.h"
+#include "asset_pack_format.h"
+#include "esp_partition.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_rom_crc.h"
+#include "esp_timer.h"
+#include <cstdio>
+
+static const char* TAG = "FS_MANAGER";
+
+static_assert(sizeof(lv_font_fmt_txt_glyph_dsc_t) == 8, "El pack asume LV_FONT_FMT_TXT_LARGE = 0");
+
+// Fuente construida sobre el pack: solo estas estructuras viven en RAM
+typedef struct {
+    lv_font_t font;
+    lv_font_fmt_txt_dsc_t dsc;
+    lv_font_fmt_txt_cmap_t cmaps[];
+} pack_font_t;
+
+static const uint8_t* pack_base = nullptr;
+static esp_partition_mmap_handle_t pack_handle;
+static const esp_partition_t* pack_partition = nullptr;
+// Un descriptor por entrada, creado en el primer acceso (mismo orden que el índice)
+static void** descriptors = nullptr;
+static fs_manager_stats_t stats = {};
+
+static const asset_pack_header_t* pack_header() {
+    return (const asset_pack_header_t*)pack_base;
+}
+
+static const asset_pack_entry_t* pack_entries() {
+    return (const asset_pack_entry_t*)(pack_base + sizeof(asset_pack_header_t));
+}
+
+esp_err_t fs_manager_init() {
+    if (pack_base) return ESP_OK;
+
+    pack_partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                              (esp_partition_subtype_t)FS_ASSET_PARTITION_SUBTYPE,
+                                              FS_ASSET_PARTITION_LABEL);
+    if (!pack_partition) {
+        ESP_LOGW(TAG, "Sin partición '%s': se usan los assets integrados", FS_ASSET_PARTITION_LABEL);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    // Primero la cabecera, para mapear solo lo que ocupa el pack
+    asset_pack_header_t hdr;
+    esp_err_t err = esp_partition_read(pack_partition, 0, &hdr, sizeof(hdr));
+    if (err != ESP_OK) return err;
+    if (hdr.magic != ASSET_PACK_MAGIC || hdr.version != ASSET_PACK_VERSION ||
+        hdr.total_size > pack_partition->size) {
+        ESP_LOGW(TAG, "Partición '%s' sin pack válido (¿falta flashear assets.bin?)", FS_ASSET_PARTITION_LABEL);
+        return ESP_ERR_INVALID_VERSION;
+    }
+
+    const void* ptr = nullptr;
+    err = esp_partition_mmap(pack_partition, 0, hdr.total_size, ESP_PARTITION_MMAP_DATA, &ptr, &pack_handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "esp_partition_mmap: %s", esp_err_to_name(err));
+        return err;
+    }
+    const uint8_t* base = (const uint8_t*)ptr;
+
+    const uint32_t crc = esp_rom_crc32_le(0, base + sizeof(asset_pack_header_t),
+                                          hdr.data_offset - sizeof(asset_pack_header_t));
+    if (!asset_pack_check(base, hdr.total_size) || crc != hdr.index_crc32) {
+        ESP_LOGE(TAG, "Índice del pack corrupto (crc %08lx, esperado %08lx)",
+                 (unsigned long)crc, (unsigned long)hdr.index_crc32);
+        esp_partition_munmap(pack_handle);
+        return ESP_ERR_INVALID_CRC;
+    }
+
+    descriptors = (void**)heap_caps_calloc(hdr.entry_count ? hdr.entry_count : 1, sizeof(void*),
+                                           MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (!descriptors) {
+        esp_partition_munmap(pack_handle);
+        return ESP_ERR_NO_MEM;
+    }
+
+    pack_base = base;
+    stats.mounted = true;
+    stats.entries = hdr.entry_count;
+    stats.pack_bytes = hdr.total_size;
+    stats.partition_bytes = pack_partition->size;
+    stats.ram_bytes = hdr.entry_count * sizeof(void*);
+    ESP_LOGI(TAG, "Pack montado: %u assets, %lu KB mapeados en %p",
+             hdr.entry_count, (unsigned long)(hdr.total_size / 1024), ptr);
+    return ESP_OK;
+}
+
+bool fs_manager_is_mounted() {
+    return pack_base != nullptr;
+}
+
+static const asset_pack_entry_t* find_entry(const char* name) {
+    if (!pack_base) return nullptr;
+    stats.lookups++;
+    const asset_pack_entry_t* entry = asset_pack_find(pack_base, name);
+    if (!entry) {
+        stats.misses++;
+    }
+    return entry;
+}
+
+static void** descriptor_slot(const asset_pack_entry_t* entry) {
+    return &descriptors[entry - pack_entries()];
+}
+
+static lv_image_dsc_t* build_image(const asset_pack_entry_t* entry) {
+    lv_image_dsc_t* img = (lv_image_dsc_t*)heap_caps_calloc(1, sizeof(lv_image_dsc_t),
+                                                            MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (!img) return nullptr;
+
+    img->header.magic = LV_IMAGE_HEADER_MAGIC;
+    img->header.cf = entry->cf;
+    img->header.w = entry->w;
+    img->header.h = entry->h;
+    img->header.stride = entry->stride;
+    img->data = pack_base + entry->offset;
+    img->data_size = entry->size;
+
+    stats.images_built++;
+    stats.ram_bytes += sizeof(lv_image_dsc_t);
+    return img;
+}
+
+static lv_font_t* build_font(const asset_pack_entry_t* entry) {
+    const uint8_t* asset = pack_base + entry->offset;
+    const asset_font_header_t* fh = (const asset_font_header_t*)asset;
+    if (entry->size < sizeof(asset_font_header_t) || fh->cmaps_offset + fh->cmap_num * sizeof(asset_font_cmap_t) > entry->size) {
+        ESP_LOGE(TAG, "Fuente corrupta en el pack");
+        return nullptr;
+    }
+
+    const size_t bytes = sizeof(pack_font_t) + fh->cmap_num * sizeof(lv_font_fmt_txt_cmap_t);
+    pack_font_t* pf = (pack_font_t*)heap_caps_calloc(1, bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (!pf) return nullptr;
+
+    // Las cmaps llevan punteros absolutos: se traducen aquí, las listas siguen en flash
+    const asset_font_cmap_t* src = (const asset_font_cmap_t*)(asset + fh->cmaps_offset);
+    for (uint16_t i = 0; i < fh->cmap_num; i++) {
+        lv_font_fmt_txt_cmap_t& c = pf->cmaps[i];
+        c.range_start = src[i].range_start;
+        c.range_length = src[i].range_length;
+        c.glyph_id_start = src[i].glyph_id_start;
+        c.unicode_list = src[i].unicode_list_offset ? (const uint16_t*)(asset + src[i].unicode_list_offset) : nullptr;
+        c.glyph_id_ofs_list = src[i].glyph_id_ofs_list_offset ? asset + src[i].glyph_id_ofs_list_offset : nullptr;
+        c.list_length = src[i].list_length;
+        c.type = (lv_font_fmt_txt_cmap_type_t)src[i].type;
+    }
+
+    pf->dsc.glyph_bitmap = asset + fh->bitmap_offset;
+    pf->dsc.glyph_dsc = (const lv_font_fmt_txt_glyph_dsc_t*)(asset + fh->glyph_dsc_offset);
+    pf->dsc.cmaps = pf->cmaps;
+    pf->dsc.kern_dsc = nullptr;
+    pf->dsc.cmap_num = fh->cmap_num;
+    pf->dsc.bpp = fh->bpp;
+    pf->dsc.bitmap_format = LV_FONT_FMT_TXT_PLAIN;
+
+    pf->font.get_glyph_dsc = lv_font_get_glyph_dsc_fmt_txt;
+    pf->font.get_glyph_bitmap = lv_font_get_bitmap_fmt_txt;
+    pf->font.line_height = fh->line_height;
+    pf->font.base_line = fh->base_line;
+    pf->font.subpx = fh->subpx;
+    pf->font.underline_position = fh->underline_position;
+    pf->font.underline_thickness = fh->underline_thickness;
+    pf->font.dsc = &pf->dsc;
+
+    stats.fonts_built++;
+    stats.ram_bytes += bytes;
+    return &pf->font;
+}
+
+const lv_image_dsc_t* fs_manager_get_image(const char* name) {
+    const asset_pack_entry_t* entry = find_entry(name);
+    if (!entry || entry->type != ASSET_TYPE_IMAGE) return nullptr;
+
+    void** slot = descriptor_slot(entry);
+    if (!*slot) {
+        *slot = build_image(entry);
+    }
+    return (const lv_image_dsc_t*)*slot;
+}
+
+const lv_font_t* fs_manager_get_font(const char* name) {
+    const asset_pack_entry_t* entry = find_entry(name);
+    if (!entry || entry->type != ASSET_TYPE_FONT) return nullptr;
+
+    void** slot = descriptor_slot(entry);
+    if (!*slot) {
+        *slot = build_font(entry);
+    }
+    return (const lv_font_t*)*slot;
+}
+
+const lv_font_t* fs_manager_font_or(const char* name, const lv_font_t* fallback) {
+    const lv_font_t* font = fs_manager_get_font(name);
+    return font ? font : fallback;
+}
+
+const void* fs_manager_get_raw(const char* name, size_t* size) {
+    const asset_pack_entry_t* entry = find_entry(name);
+    if (!entry) return nullptr;
+    if (size) *size = entry->size;
+    return pack_base + entry->offset;
+}
+
+void fs_manager_get_stats(fs_manager_stats_t* out) {
+    *out = stats;
+}
+
+void fs_manager_benchmark(uint32_t iterations) {
+    if (!pack_base) {
+        ESP_LOGW(TAG, "Benchmark sin pack montado");
+        return;
+    }
+    const asset_pack_header_t* hdr = pack_header();
+    const asset_pack_entry_t* entries = pack_entries();
+    if (hdr->entry_count == 0 || iterations == 0) return;
+
+    printf("ABENCH,test,entries,iterations,ns_per_op\n");
+
+    // Búsqueda pura (hash + búsqueda binaria + strcmp), sin contar en stats
+    uint32_t found = 0;
+    int64_t t0 = esp_timer_get_time();
+    for (uint32_t it = 0; it < iterations; it++) {
+        for (uint32_t i = 0; i < hdr->entry_count; i++) {
+            found += asset_pack_find(pack_base, (const char*)pack_base + entries[i].name_offset) != nullptr;
+        }
+    }
+    int64_t elapsed = esp_timer_get_time() - t0;
+    const uint64_t ops = (uint64_t)iterations * hdr->entry_count;
+    printf("ABENCH,lookup,%u,%lu,%llu\n", hdr->entry_count, (unsigned long)iterations,
+           (unsigned long long)(elapsed * 1000 / ops));
+
+    // Nombre inexistente: recorre la búsqueda entera
+    t0 = esp_timer_get_time();
+    for (uint32_t it = 0; it < iterations; it++) {
+        found += asset_pack_find(pack_base, "__missing__") != nullptr;
+    }
+    elapsed = esp_timer_get_time() - t0;
+    printf("ABENCH,miss,%u,%lu,%llu\n", hdr->entry_count, (unsigned long)iterations,
+           (unsigned long long)(elapsed * 1000 / iterations));
+
+    // Primer acceso a cada asset (crea el descriptor; los siguientes son gratis)
+    t0 = esp_timer_get_time();
+    for (uint32_t i = 0; i < hdr->entry_count; i++) {
+        const char* name = (const char*)pack_base + entries[i].name_offset;
+        if (entries[i].type == ASSET_TYPE_IMAGE) fs_manager_get_image(name);
+        else if (entries[i].type == ASSET_TYPE_FONT) fs_manager_get_font(name);
+    }
+    elapsed = esp_timer_get_time() - t0;
+    printf("ABENCH,descriptors,%u,1,%llu\n", hdr->entry_count,
+           (unsigned long long)(elapsed * 1000 / hdr->entry_count));
+
+    ESP_LOGI(TAG, "Encontrados %lu de %llu, RAM de descriptores %lu bytes",
+             (unsigned long)found, (unsigned long long)ops, (unsigned long)stats.ram_bytes);
+}
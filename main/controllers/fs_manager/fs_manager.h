@@ -0,0 +1,48 @@
+#ifndef FS_MANAGER_H
+#define FS_MANAGER_H
+
+#include "esp_err.h"
+#include "lvgl.h"
+#include "config.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Pack de assets en su propia partición de flash (ver tools/pack_assets.py y
+// asset_pack_format.h). La partición se mapea entera con esp_partition_mmap y
+// los descriptores de LVGL apuntan directamente a flash: los píxeles y los
+// glifos nunca se copian a RAM.
+
+typedef struct {
+    bool mounted;
+    uint32_t entries;
+    uint32_t pack_bytes;            // Tamaño del pack (cabecera.total_size)
+    uint32_t partition_bytes;
+    uint32_t lookups;
+    uint32_t misses;
+    uint32_t images_built;          // Descriptores creados (uno por asset, se reutilizan)
+    uint32_t fonts_built;
+    uint32_t ram_bytes;             // RAM usada por tabla de descriptores y lv_font_t
+} fs_manager_stats_t;
+
+// Busca la partición FS_ASSET_PARTITION_LABEL, valida cabecera y CRC del
+// índice y la mapea. Sin partición o con pack inválido devuelve error y las
+// búsquedas fallan (las vistas usan sus fuentes integradas).
+esp_err_t fs_manager_init();
+bool fs_manager_is_mounted();
+
+// Descriptores persistentes: válidos hasta el reinicio, no hay que liberarlos.
+// Solo desde la tarea de LVGL. nullptr si no existe o el tipo no coincide.
+const lv_image_dsc_t* fs_manager_get_image(const char* name);
+const lv_font_t* fs_manager_get_font(const char* name);
+// La fuente del pack si existe, si no 'fallback'
+const lv_font_t* fs_manager_font_or(const char* name, const lv_font_t* fallback);
+// Bytes en crudo de cualquier asset, también apuntando a flash
+const void* fs_manager_get_raw(const char* name, size_t* size);
+
+void fs_manager_get_stats(fs_manager_stats_t* out);
+
+// Mide la búsqueda por nombre de todas las entradas 'iterations' veces y la
+// creación de descriptores. Imprime líneas CSV ABENCH.
+void fs_manager_benchmark(uint32_t iterations);
+
+#endif
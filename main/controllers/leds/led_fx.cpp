@@ -0,0 +1,137 @@
+#include "led_fx.h"
+#include <string.h>
+
+// Gamma 2,2: el brillo percibido sube de forma uniforme con el valor lineal
+static const uint8_t gamma8[256] = {
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   1,
+      1,   1,   1,   1,   1,   1,   1,   1,   1,   2,   2,   2,   2,   2,   2,   2,
+      3,   3,   3,   3,   3,   4,   4,   4,   4,   5,   5,   5,   5,   6,   6,   6,
+      6,   7,   7,   7,   8,   8,   8,   9,   9,   9,  10,  10,  11,  11,  11,  12,
+     12,  13,  13,  13,  14,  14,  15,  15,  16,  16,  17,  17,  18,  18,  19,  19,
+     20,  20,  21,  22,  22,  23,  23,  24,  25,  25,  26,  26,  27,  28,  28,  29,
+     30,  30,  31,  32,  33,  33,  34,  35,  35,  36,  37,  38,  39,  39,  40,  41,
+     42,  43,  43,  44,  45,  46,  47,  48,  49,  49,  50,  51,  52,  53,  54,  55,
+     56,  57,  58,  59,  60,  61,  62,  63,  64,  65,  66,  67,  68,  69,  70,  71,
+     73,  74,  75,  76,  77,  78,  79,  81,  82,  83,  84,  85,  87,  88,  89,  90,
+     91,  93,  94,  95,  97,  98,  99, 100, 102, 103, 105, 106, 107, 109, 110, 111,
+    113, 114, 116, 117, 119, 120, 121, 123, 124, 126, 127, 129, 130, 132, 133, 135,
+    137, 138, 140, 141, 143, 145, 146, 148, 149, 151, 153, 154, 156, 158, 159, 161,
+    163, 165, 166, 168, 170, 172, 173, 175, 177, 179, 181, 182, 184, 186, 188, 190,
+    192, 194, 196, 197, 199, 201, 203, 205, 207, 209, 211, 213, 215, 217, 219, 221,
+    223, 225, 227, 229, 231, 234, 236, 238, 240, 242, 244, 246, 248, 251, 253, 255,
+};
+
+static const char* const fx_names[LED_FX_COUNT] = { "Off", "Solid", "Gradient", "Breathe", "Seconds" };
+
+const char* led_fx_name(led_fx_effect_t effect) {
+    return (unsigned)effect < LED_FX_COUNT ? fx_names[effect] : "?";
+}
+
+bool led_fx_is_animated(led_fx_effect_t effect) {
+    return effect == LED_FX_GRADIENT || effect == LED_FX_BREATHE;
+}
+
+led_rgb_t led_fx_hue(uint16_t hue) {
+    const uint8_t f = (uint8_t)(hue & 0xFF);
+    const uint8_t up = f;
+    const uint8_t down = (uint8_t)(255 - f);
+    switch (hue >> 8) {
+        case 0:  return { 255, up, 0 };
+        case 1:  return { down, 255, 0 };
+        case 2:  return { 0, 255, up };
+        case 3:  return { 0, down, 255 };
+        case 4:  return { up, 0, 255 };
+        default: return { 255, 0, down };
+    }
+}
+
+// Brillo global + gamma, en el orden de la tira
+static inline void put_pixel(uint8_t* px, led_rgb_t c, uint8_t brightness) {
+    px[0] = gamma8[led_fx_scale8(c.g, brightness)];
+    px[1] = gamma8[led_fx_scale8(c.r, brightness)];
+    px[2] = gamma8[led_fx_scale8(c.b, brightness)];
+}
+
+// Todos los píxeles iguales: se calcula uno y se replica
+static void fill(uint8_t* grb, uint32_t count, led_rgb_t c, uint8_t brightness) {
+    if (count == 0) return;
+    put_pixel(grb, c, brightness);
+    const uint8_t g = grb[0], r = grb[1], b = grb[2];
+    if (g == r && r == b) {
+        memset(grb, g, count * 3);
+        return;
+    }
+    for (uint32_t i = 1; i < count; i++) {
+        uint8_t* px = grb + i * 3;
+        px[0] = g;
+        px[1] = r;
+        px[2] = b;
+    }
+}
+
+static void render_gradient(const led_fx_params_t* p, uint32_t t_ms, uint8_t* grb, uint32_t count) {
+    const uint32_t period = p->period_ms ? p->period_ms : 1;
+    // Tono en Q16: una división por frame y una suma por píxel
+    const uint32_t step_q16 = ((uint32_t)LED_FX_HUE_MAX << 16) / count;
+    uint32_t hue_q16 = (uint32_t)((uint64_t)(t_ms % period) * LED_FX_HUE_MAX / period) << 16;
+    const uint32_t wrap_q16 = (uint32_t)LED_FX_HUE_MAX << 16;
+
+    for (uint32_t i = 0; i < count; i++) {
+        put_pixel(grb + i * 3, led_fx_hue((uint16_t)(hue_q16 >> 16)), p->brightness);
+        hue_q16 += step_q16;
+        if (hue_q16 >= wrap_q16) {
+            hue_q16 -= wrap_q16;
+        }
+    }
+}
+
+static void render_breathe(const led_fx_params_t* p, uint32_t t_ms, uint8_t* grb, uint32_t count) {
+    const uint32_t period = p->period_ms ? p->period_ms : 1;
+    // Triángulo 0..255..0; la gamma lo convierte en una subida lenta y un pico corto
+    const uint32_t phase = (uint32_t)((uint64_t)(t_ms % period) * 512 / period);
+    const uint8_t level = (uint8_t)(phase < 256 ? phase : 511 - phase);
+    fill(grb, count, p->color, led_fx_scale8(level, p->brightness));
+}
+
+static void render_seconds(const led_fx_params_t* p, uint8_t* grb, uint32_t count) {
+    // Celda del píxel i = ⌊i·60/count⌋ exacta, con el resto acumulado en vez
+    // de dividir por píxel (en Q16 el paso truncado deja píxeles en la celda
+    // anterior, p. ej. el 50 de 1000). Como en la cuadrícula, la celda 0 no se
+    // enciende.
+    uint32_t cell = 0;
+    uint32_t rem = 0;
+    const led_rgb_t off = { 0, 0, 0 };
+
+    for (uint32_t i = 0; i < count; i++) {
+        const bool lit = cell > 0 && cell <= p->second;
+        put_pixel(grb + i * 3, lit ? p->seconds[cell] : off, p->brightness);
+        rem += LED_FX_CELLS;
+        while (rem >= count) {
+            rem -= count;
+            cell++;
+        }
+    }
+}
+
+void led_fx_render(const led_fx_params_t* p, uint32_t t_ms, uint8_t* grb, uint32_t count) {
+    if (count == 0) return;
+
+    switch (p->effect) {
+        case LED_FX_SOLID:
+            fill(grb, count, p->color, p->brightness);
+            break;
+        case LED_FX_GRADIENT:
+            render_gradient(p, t_ms, grb, count);
+            break;
+        case LED_FX_BREATHE:
+            render_breathe(p, t_ms, grb, count);
+            break;
+        case LED_FX_SECONDS:
+            render_seconds(p, grb, count);
+            break;
+        case LED_FX_OFF:
+        default:
+            memset(grb, 0, count * 3);
+            break;
+    }
+}
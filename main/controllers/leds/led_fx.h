@@ -0,0 +1,55 @@
+#ifndef LED_FX_H
+#define LED_FX_H
+
+// Efectos de la tira de LEDs en punto fijo, sin dependencias de ESP-IDF ni de
+// FreeRTOS: el mismo código calcula los frames de la tarea 'leds' y los de un
+// PC. Cada frame se escribe directamente en el orden de bytes de la tira
+// (G, R, B por píxel), listo para el encoder del RMT.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define LED_FX_HUE_MAX      1536        // 6 sectores × 256
+#define LED_FX_CELLS        60          // Celdas del patrón de segundos (como la cuadrícula del reloj)
+
+typedef enum {
+    LED_FX_OFF = 0,
+    LED_FX_SOLID,
+    LED_FX_GRADIENT,                    // Arcoíris que gira una vuelta por period_ms
+    LED_FX_BREATHE,                     // 'color' sube y baja una vez por period_ms
+    LED_FX_SECONDS,                     // Celdas 1..second encendidas con su color
+    LED_FX_COUNT
+} led_fx_effect_t;
+
+typedef struct {
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+} led_rgb_t;
+
+typedef struct {
+    led_fx_effect_t effect;
+    led_rgb_t color;                    // SOLID y BREATHE
+    uint8_t brightness;                 // Global, 0..255 (antes de la corrección gamma)
+    uint16_t period_ms;                 // GRADIENT y BREATHE
+    uint8_t second;                     // SECONDS: 0..59
+    led_rgb_t seconds[LED_FX_CELLS];    // SECONDS: color de cada celda
+} led_fx_params_t;
+
+const char* led_fx_name(led_fx_effect_t effect);
+
+// Los efectos no animados solo cambian cuando cambian sus parámetros
+bool led_fx_is_animated(led_fx_effect_t effect);
+
+// Un frame de 'count' píxeles en 'grb' (3 bytes por píxel) para el instante 't_ms'
+void led_fx_render(const led_fx_params_t* p, uint32_t t_ms, uint8_t* grb, uint32_t count);
+
+// Tono 0..LED_FX_HUE_MAX-1 a saturación y valor máximos
+led_rgb_t led_fx_hue(uint16_t hue);
+
+// v·s/255 sin división, con error menor que 1; s = 255 deja v intacto
+static inline uint8_t led_fx_scale8(uint8_t v, uint8_t s) {
+    return (uint8_t)(((uint16_t)v * (uint16_t)(s + 1)) >> 8);
+}
+
+#endif
@@ -0,0 +1,322 @@
+#include "leds.h"
+#include "driver/rmt_tx.h"
+#include "esp_check.h"
+#include "esp_cpu.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_private/esp_clk.h"
+#include "esp_rom_crc.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static const char* TAG = "LEDS";
+
+#define LEDS_TASK_STACK         3072
+#define LEDS_BENCH_MAX_PIXELS   1024
+
+// Tiempos WS2812 a LEDS_RMT_RESOLUTION_HZ (10 MHz → 0,1 µs por tick)
+#define WS2812_T0H_TICKS        3       // 0,3 µs
+#define WS2812_T0L_TICKS        9       // 0,9 µs
+#define WS2812_T1H_TICKS        9
+#define WS2812_T1L_TICKS        3
+
+static rmt_channel_handle_t channel = nullptr;
+static rmt_encoder_handle_t encoder = nullptr;
+static SemaphoreHandle_t tx_done = nullptr;
+static TaskHandle_t leds_task = nullptr;
+// rmt_enable toma un lock NO_LIGHT_SLEEP con DMA: el canal solo está activo
+// mientras sale un frame. Solo lo toca la tarea 'leds' (y leds_init).
+static bool channel_enabled = false;
+
+// Un solo buffer GRB: release_channel espera al fin de cada frame antes de
+// dormir, así que el siguiente nunca se calcula con el RMT leyéndolo (ver README).
+// Del frame enviado solo queda su CRC, para no repetir transmisiones.
+static uint8_t* frame = nullptr;
+static uint32_t sent_crc = 0;
+
+// Parámetros compartidos: los setters escriben aquí y la tarea copia una vez por frame
+static led_fx_params_t params = {};
+static uint32_t fps = LEDS_FPS_DEFAULT;
+static portMUX_TYPE params_mux = portMUX_INITIALIZER_UNLOCKED;
+
+static leds_stats_t stats = {};
+static uint64_t cycles_total = 0;
+static portMUX_TYPE stats_mux = portMUX_INITIALIZER_UNLOCKED;
+
+static bool IRAM_ATTR leds_on_trans_done(rmt_channel_handle_t chan, const rmt_tx_done_event_data_t* edata, void* user_ctx) {
+    BaseType_t woken = pdFALSE;
+    xSemaphoreGiveFromISR(tx_done, &woken);
+    return woken == pdTRUE;
+}
+
+// Saca 'frame' por el RMT. El envío anterior ya terminó en release_channel.
+static void transmit_frame() {
+    xSemaphoreTake(tx_done, portMAX_DELAY);
+
+    if (!channel_enabled) {
+        if (rmt_enable(channel) != ESP_OK) {
+            xSemaphoreGive(tx_done);
+            taskENTER_CRITICAL(&stats_mux);
+            stats.tx_errors++;
+            taskEXIT_CRITICAL(&stats_mux);
+            return;
+        }
+        channel_enabled = true;
+        taskENTER_CRITICAL(&stats_mux);
+        stats.rmt_enables++;
+        taskEXIT_CRITICAL(&stats_mux);
+    }
+
+    rmt_transmit_config_t tx = {};
+    if (rmt_transmit(channel, encoder, frame, LEDS_COUNT * 3, &tx) != ESP_OK) {
+        xSemaphoreGive(tx_done);
+        taskENTER_CRITICAL(&stats_mux);
+        stats.tx_errors++;
+        taskEXIT_CRITICAL(&stats_mux);
+        return;
+    }
+    taskENTER_CRITICAL(&stats_mux);
+    stats.sent++;
+    taskEXIT_CRITICAL(&stats_mux);
+}
+
+// Antes de dormir: espera a que termine el frame en curso (1,8 ms con 60 LEDs)
+// y desactiva el canal, que suelta el lock de energía hasta el siguiente envío
+static void release_channel() {
+    if (!channel_enabled) return;
+    xSemaphoreTake(tx_done, portMAX_DELAY);
+    rmt_disable(channel);
+    channel_enabled = false;
+    xSemaphoreGive(tx_done);
+}
+
+static void leds_task_fn(void*) {
+    static led_fx_params_t frame_params;    // Fuera de la pila: ~190 bytes
+    TickType_t last_wake = xTaskGetTickCount();
+    bool first = true;
+
+    for (;;) {
+        taskENTER_CRITICAL(&params_mux);
+        frame_params = params;
+        const uint32_t frame_fps = fps;
+        taskEXIT_CRITICAL(&params_mux);
+
+        const uint32_t t_ms = (uint32_t)(esp_timer_get_time() / 1000);
+        const uint32_t c0 = esp_cpu_get_cycle_count();
+        led_fx_render(&frame_params, t_ms, frame, LEDS_COUNT);
+        const uint32_t cycles = esp_cpu_get_cycle_count() - c0;
+
+        const uint32_t crc = esp_rom_crc32_le(0, frame, LEDS_COUNT * 3);
+        const bool changed = first || crc != sent_crc;
+        first = false;
+
+        taskENTER_CRITICAL(&stats_mux);
+        stats.frames++;
+        cycles_total += cycles;
+        if (cycles > stats.cycles_max) stats.cycles_max = cycles;
+        if (!changed) stats.unchanged++;
+        taskEXIT_CRITICAL(&stats_mux);
+
+        if (changed) {
+            sent_crc = crc;
+            transmit_frame();
+        }
+        release_channel();
+
+        if (led_fx_is_animated(frame_params.effect)) {
+            const TickType_t period = pdMS_TO_TICKS(1000 / frame_fps);
+            vTaskDelayUntil(&last_wake, period ? period : 1);
+        } else {
+            // Sin animación no hay nada que recalcular hasta que cambie un parámetro
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            last_wake = xTaskGetTickCount();
+        }
+    }
+}
+
+static void notify_task() {
+    if (leds_task) xTaskNotifyGive(leds_task);
+}
+
+esp_err_t leds_init() {
+    if (leds_task) return ESP_OK;
+    if (LEDS_GPIO == GPIO_NUM_NC) return ESP_ERR_NOT_SUPPORTED;
+
+    frame = (uint8_t*)heap_caps_calloc(LEDS_COUNT * 3, 1, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    tx_done = xSemaphoreCreateBinary();
+    if (!frame || !tx_done) return ESP_ERR_NO_MEM;
+    xSemaphoreGive(tx_done);
+
+    rmt_tx_channel_config_t chan_cfg = {};
+    chan_cfg.gpio_num = LEDS_GPIO;
+    chan_cfg.clk_src = RMT_CLK_SRC_DEFAULT;
+    chan_cfg.resolution_hz = LEDS_RMT_RESOLUTION_HZ;
+    chan_cfg.mem_block_symbols = LEDS_RMT_MEM_SYMBOLS;
+    chan_cfg.trans_queue_depth = 1;
+    chan_cfg.flags.with_dma = LEDS_RMT_DMA;
+    esp_err_t err = rmt_new_tx_channel(&chan_cfg, &channel);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Sin canal RMT: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    rmt_bytes_encoder_config_t enc_cfg = {};
+    enc_cfg.bit0 = { WS2812_T0H_TICKS, 1, WS2812_T0L_TICKS, 0 };
+    enc_cfg.bit1 = { WS2812_T1H_TICKS, 1, WS2812_T1L_TICKS, 0 };
+    enc_cfg.flags.msb_first = 1;
+    ESP_RETURN_ON_ERROR(rmt_new_bytes_encoder(&enc_cfg, &encoder), TAG, "encoder");
+
+    rmt_tx_event_callbacks_t cbs = {};
+    cbs.on_trans_done = leds_on_trans_done;
+    ESP_RETURN_ON_ERROR(rmt_tx_register_event_callbacks(channel, &cbs, nullptr), TAG, "callbacks");
+    // Sin rmt_enable: lo hace transmit_frame en cada envío
+
+    params.effect = LED_FX_SECONDS;
+    params.color = { 255, 96, 0 };
+    params.brightness = LEDS_BRIGHTNESS_DEFAULT;
+    params.period_ms = LEDS_PERIOD_MS_DEFAULT;
+
+    if (xTaskCreatePinnedToCore(leds_task_fn, "leds", LEDS_TASK_STACK, nullptr, LEDS_TASK_PRIORITY,
+                                &leds_task, LEDS_TASK_CORE) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    ESP_LOGI(TAG, "%d LEDs en GPIO %d, %s, %d fps", LEDS_COUNT, LEDS_GPIO,
+             LEDS_RMT_DMA ? "DMA" : "sin DMA", LEDS_FPS_DEFAULT);
+    return ESP_OK;
+}
+
+bool leds_is_running() {
+    return leds_task != nullptr;
+}
+
+void leds_set_effect(led_fx_effect_t effect) {
+    if ((unsigned)effect >= LED_FX_COUNT) return;
+    taskENTER_CRITICAL(&params_mux);
+    params.effect = effect;
+    taskEXIT_CRITICAL(&params_mux);
+    notify_task();
+}
+
+led_fx_effect_t leds_get_effect() {
+    taskENTER_CRITICAL(&params_mux);
+    const led_fx_effect_t effect = params.effect;
+    taskEXIT_CRITICAL(&params_mux);
+    return effect;
+}
+
+void leds_set_color(led_rgb_t color) {
+    taskENTER_CRITICAL(&params_mux);
+    params.color = color;
+    taskEXIT_CRITICAL(&params_mux);
+    notify_task();
+}
+
+void leds_set_brightness(uint8_t brightness) {
+    taskENTER_CRITICAL(&params_mux);
+    params.brightness = brightness;
+    taskEXIT_CRITICAL(&params_mux);
+    notify_task();
+}
+
+void leds_set_period(uint16_t period_ms) {
+    taskENTER_CRITICAL(&params_mux);
+    params.period_ms = period_ms;
+    taskEXIT_CRITICAL(&params_mux);
+    notify_task();
+}
+
+void leds_set_fps(uint32_t new_fps) {
+    if (new_fps == 0 || new_fps > LEDS_FPS_MAX) {
+        ESP_LOGE(TAG, "FPS fuera de rango: %lu", (unsigned long)new_fps);
+        return;
+    }
+    taskENTER_CRITICAL(&params_mux);
+    fps = new_fps;
+    taskEXIT_CRITICAL(&params_mux);
+}
+
+void leds_set_second(uint8_t second, led_rgb_t color) {
+    if (second >= LED_FX_CELLS) return;
+    taskENTER_CRITICAL(&params_mux);
+    if (second == 0) {
+        memset(params.seconds, 0, sizeof(params.seconds));
+    }
+    params.seconds[second] = color;
+    params.second = second;
+    const bool wake = params.effect == LED_FX_SECONDS;
+    taskEXIT_CRITICAL(&params_mux);
+    if (wake) notify_task();
+}
+
+void leds_get_stats(leds_stats_t* out) {
+    taskENTER_CRITICAL(&stats_mux);
+    *out = stats;
+    const uint64_t cycles = cycles_total;
+    taskEXIT_CRITICAL(&stats_mux);
+    taskENTER_CRITICAL(&params_mux);
+    out->effect = params.effect;
+    out->fps = fps;
+    taskEXIT_CRITICAL(&params_mux);
+
+    out->pixels = LEDS_COUNT;
+    out->cycles_avg = out->frames ? (uint32_t)(cycles / out->frames) : 0;
+    // Coste si el efecto corre a 'fps' (los estáticos casi nunca recalculan)
+    out->cpu_pct_x100 = (uint32_t)((uint64_t)out->cycles_avg * out->fps * 10000 / esp_clk_cpu_freq());
+}
+
+void leds_reset_stats() {
+    taskENTER_CRITICAL(&stats_mux);
+    stats = {};
+    cycles_total = 0;
+    taskEXIT_CRITICAL(&stats_mux);
+}
+
+// --- Benchmark ------------------------------------------------------------------
+
+void leds_benchmark(uint32_t frames) {
+    static const uint16_t sizes[] = { 8, 60, 256, LEDS_BENCH_MAX_PIXELS };
+    static const led_fx_effect_t effects[] = { LED_FX_SOLID, LED_FX_GRADIENT, LED_FX_BREATHE, LED_FX_SECONDS };
+
+    uint8_t* buf = (uint8_t*)heap_caps_malloc(LEDS_BENCH_MAX_PIXELS * 3, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    static led_fx_params_t p;
+    if (!buf || frames == 0) {
+        free(buf);
+        return;
+    }
+
+    p = {};
+    p.color = { 255, 96, 0 };
+    p.brightness = LEDS_BRIGHTNESS_DEFAULT;
+    p.period_ms = LEDS_PERIOD_MS_DEFAULT;
+    p.second = 45;
+    for (int i = 0; i < LED_FX_CELLS; i++) {
+        p.seconds[i] = led_fx_hue((uint16_t)(i * LED_FX_HUE_MAX / LED_FX_CELLS));
+    }
+
+    const uint32_t cpu_hz = esp_clk_cpu_freq();
+    printf("LEDBENCH,effect,pixels,frames,cycles_per_frame,ns_per_pixel,frames_per_s\n");
+    for (led_fx_effect_t effect : effects) {
+        p.effect = effect;
+        for (uint16_t n : sizes) {
+            uint64_t cycles = 0;
+            for (uint32_t f = 0; f < frames; f++) {
+                const uint32_t c0 = esp_cpu_get_cycle_count();
+                led_fx_render(&p, f * 33, buf, n);     // Pasos de 33 ms: un frame a 30 fps
+                cycles += esp_cpu_get_cycle_count() - c0;
+            }
+            const uint32_t per_frame = (uint32_t)(cycles / frames);
+            const uint32_t ns_per_px = (uint32_t)((uint64_t)per_frame * 1000000 / (cpu_hz / 1000) / n);
+            printf("LEDBENCH,%s,%u,%lu,%lu,%lu,%lu\n", led_fx_name(effect), n, (unsigned long)frames,
+                   (unsigned long)per_frame, (unsigned long)ns_per_px,
+                   (unsigned long)(per_frame ? cpu_hz / per_frame : 0));
+        }
+        vTaskDelay(1);  // Deja correr al watchdog de la tarea idle
+    }
+    free(buf);
+}
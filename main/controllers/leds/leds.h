@@ -0,0 +1,48 @@
+#ifndef LEDS_H
+#define LEDS_H
+
+#include "esp_err.h"
+#include "config.h"
+#include "led_fx.h"
+#include <stdint.h>
+
+// Tira WS2812 por RMT. La tarea 'leds' (núcleo LEDS_TASK_CORE, no el de
+// render) calcula el efecto a LEDS_FPS_DEFAULT en un único buffer que el RMT
+// saca por DMA sin CPU. Los efectos sin animación solo se recalculan cuando
+// cambia algún parámetro; si el frame nuevo es igual al enviado (por CRC), no
+// se transmite. El canal RMT solo está activo mientras sale un frame, así que
+// la tira no impide el light sleep.
+
+typedef struct {
+    led_fx_effect_t effect;
+    uint16_t pixels;
+    uint32_t fps;
+    uint32_t frames;            // Frames calculados
+    uint32_t sent;              // Frames transmitidos
+    uint32_t unchanged;         // Iguales al anterior: no se transmiten
+    uint32_t tx_errors;
+    uint32_t rmt_enables;       // Veces que se activó el canal (una por frame enviado tras dormir)
+    uint32_t cycles_avg;        // Coste de led_fx_render por frame
+    uint32_t cycles_max;
+    uint32_t cpu_pct_x100;      // cycles_avg × fps / frecuencia de CPU
+} leds_stats_t;
+
+esp_err_t leds_init();
+bool leds_is_running();
+
+void leds_set_effect(led_fx_effect_t effect);
+led_fx_effect_t leds_get_effect();
+void leds_set_color(led_rgb_t color);
+void leds_set_brightness(uint8_t brightness);
+void leds_set_period(uint16_t period_ms);
+void leds_set_fps(uint32_t fps);
+// Patrón de segundos: enciende la celda 'second' con 'color' (0 apaga todas)
+void leds_set_second(uint8_t second, led_rgb_t color);
+
+void leds_get_stats(leds_stats_t* out);
+void leds_reset_stats();
+
+// Ciclos por frame de cada efecto para tiras de 8 a 1024 píxeles (LEDBENCH)
+void leds_benchmark(uint32_t frames);
+
+#endif
@@ -0,0 +1,372 @@
+#include "controllers/mem_manager/mem_manager.h"
+#include "lvgl.h"
+#include "esp_heap_caps.h"
+#include "multi_heap.h"
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+#include <cstring>
+
+static const char* TAG = "MEM_MGR";
+
+#define MEM_BLOCK_MAGIC 0x4C56   // "LV"
+#define MEM_ALIGN(x) (((x) + 7) & ~(size_t)7)
+
+typedef enum : uint8_t {
+    MEM_SRC_INTERNAL = 0,
+    MEM_SRC_PSRAM,
+    MEM_SRC_ARENA,
+    MEM_SRC_SYSTEM,
+} mem_source_t;
+
+// Cabecera delante de cada bloque entregado a LVGL: permite liberar y
+// redimensionar sin buscar a qué tier o arena pertenece.
+typedef struct {
+    uint32_t size;      // Tamaño pedido por LVGL
+    uint8_t source;     // mem_source_t
+    uint8_t arena;      // Slot de la arena (solo MEM_SRC_ARENA)
+    uint16_t magic;
+} mem_block_hdr_t;
+static_assert(sizeof(mem_block_hdr_t) == 8, "La cabecera debe mantener la alineación a 8");
+
+typedef struct {
+    const char* name;
+    uint8_t* base;
+    multi_heap_handle_t heap;
+    portMUX_TYPE lock;      // multi_heap_set_lock: telemetría lee el tier desde la tarea de esp_timer
+} mem_tier_t;
+
+typedef struct mem_arena_chunk {
+    struct mem_arena_chunk* next;
+    uint32_t size;      // Bytes útiles tras la cabecera
+    uint32_t used;
+    uint8_t source;     // Tier del que sale el chunk
+    uint8_t pad[3];
+} mem_arena_chunk_t;
+
+struct mem_arena {
+    const char* name;
+    bool in_use;
+    uint8_t slot;
+    mem_arena_chunk_t* chunks;  // El primero es el que se está llenando
+    size_t bytes;
+    size_t wasted;
+};
+
+static mem_tier_t internal_tier = { "internal", nullptr, nullptr, portMUX_INITIALIZER_UNLOCKED };
+static mem_tier_t psram_tier = { "psram", nullptr, nullptr, portMUX_INITIALIZER_UNLOCKED };
+static mem_arena_t arenas[LVGL_MEM_ARENA_MAX];
+static mem_arena_t* active_arena = nullptr;
+
+static size_t system_bytes = 0;
+static size_t arena_peak_bytes = 0;
+static uint32_t arena_releases = 0;
+
+static bool tier_init(mem_tier_t& tier, size_t bytes, uint32_t caps) {
+    tier.base = (uint8_t*)heap_caps_malloc(bytes, caps);
+    if (!tier.base) {
+        ESP_LOGW(TAG, "No se pudo reservar el tier %s (%u bytes)", tier.name, (unsigned)bytes);
+        return false;
+    }
+    tier.heap = multi_heap_register(tier.base, bytes);
+    if (!tier.heap) return false;
+    // Sin lock, multi_heap no protege nada: lo pide el muestreo de telemetría,
+    // que recorre el heap mientras la tarea de render reserva
+    multi_heap_set_lock(tier.heap, &tier.lock);
+    return true;
+}
+
+static void tier_deinit(mem_tier_t& tier) {
+    heap_caps_free(tier.base);
+    tier.base = nullptr;
+    tier.heap = nullptr;
+}
+
+// Pide 'bytes' a los tiers en el orden indicado y, si ambos están llenos, al heap del sistema
+static void* mem_alloc_raw(size_t bytes, bool internal_first, uint8_t* source) {
+    mem_tier_t* order[2] = { &internal_tier, &psram_tier };
+    if (!internal_first) {
+        order[0] = &psram_tier;
+        order[1] = &internal_tier;
+    }
+
+    for (mem_tier_t* tier : order) {
+        if (!tier->heap) continue;
+        void* p = multi_heap_malloc(tier->heap, bytes);
+        if (p) {
+            *source = tier == &internal_tier ? MEM_SRC_INTERNAL : MEM_SRC_PSRAM;
+            return p;
+        }
+    }
+
+    void* p = heap_caps_malloc(bytes, MALLOC_CAP_8BIT);
+    if (p) {
+        *source = MEM_SRC_SYSTEM;
+        system_bytes += bytes;
+    }
+    return p;
+}
+
+static void mem_free_raw(void* p, uint8_t source, size_t bytes) {
+    switch (source) {
+        case MEM_SRC_INTERNAL: multi_heap_free(internal_tier.heap, p); break;
+        case MEM_SRC_PSRAM:    multi_heap_free(psram_tier.heap, p); break;
+        default:
+            heap_caps_free(p);
+            system_bytes -= bytes;
+            break;
+    }
+}
+
+static size_t arena_total_bytes() {
+    size_t total = 0;
+    for (const mem_arena_t& a : arenas) {
+        if (a.in_use) total += a.bytes;
+    }
+    return total;
+}
+
+static void* arena_alloc(mem_arena_t* a, size_t bytes) {
+    bytes = MEM_ALIGN(bytes);
+
+    mem_arena_chunk_t* chunk = a->chunks;
+    if (!chunk || chunk->used + bytes > chunk->size) {
+        // Los objetos de las vistas son pequeños y se recorren en cada frame: chunks en RAM interna
+        uint8_t source;
+        chunk = (mem_arena_chunk_t*)mem_alloc_raw(sizeof(mem_arena_chunk_t) + LVGL_MEM_ARENA_CHUNK_BYTES, true, &source);
+        if (!chunk) return nullptr;
+        chunk->next = a->chunks;
+        chunk->size = LVGL_MEM_ARENA_CHUNK_BYTES;
+        chunk->used = 0;
+        chunk->source = source;
+        a->chunks = chunk;
+    }
+
+    void* p = (uint8_t*)(chunk + 1) + chunk->used;
+    chunk->used += bytes;
+    a->bytes += bytes;
+
+    const size_t total = arena_total_bytes();
+    if (total > arena_peak_bytes) arena_peak_bytes = total;
+    return p;
+}
+
+mem_arena_t* mem_arena_create(const char* name) {
+    for (uint8_t i = 0; i < LVGL_MEM_ARENA_MAX; i++) {
+        if (!arenas[i].in_use) {
+            arenas[i] = {};
+            arenas[i].name = name;
+            arenas[i].in_use = true;
+            arenas[i].slot = i;
+            return &arenas[i];
+        }
+    }
+    ESP_LOGW(TAG, "Sin slots de arena para %s", name);
+    return nullptr;
+}
+
+mem_arena_t* mem_arena_enter(mem_arena_t* arena) {
+    mem_arena_t* previous = active_arena;
+    active_arena = arena;
+    return previous;
+}
+
+void mem_arena_exit(mem_arena_t* previous) {
+    active_arena = previous;
+}
+
+mem_arena_t* mem_arena_current() {
+    return active_arena;
+}
+
+size_t mem_arena_get_bytes(const mem_arena_t* arena) {
+    return arena ? arena->bytes : 0;
+}
+
+void mem_arena_release(mem_arena_t* arena) {
+    if (!arena || !arena->in_use) return;
+    if (active_arena == arena) active_arena = nullptr;
+
+    mem_arena_chunk_t* chunk = arena->chunks;
+    while (chunk) {
+        mem_arena_chunk_t* next = chunk->next;
+        mem_free_raw(chunk, chunk->source, sizeof(mem_arena_chunk_t) + chunk->size);
+        chunk = next;
+    }
+    ESP_LOGD(TAG, "Arena %s liberada: %u bytes (%u ya libres)", arena->name,
+             (unsigned)arena->bytes, (unsigned)arena->wasted);
+    *arena = {};
+    arena_releases++;
+}
+
+static void tier_stats(const mem_tier_t& tier, mem_tier_stats_t* out) {
+    *out = {};
+    if (!tier.heap) return;
+
+    multi_heap_info_t info;
+    multi_heap_get_info(tier.heap, &info);
+    out->total_bytes = info.total_free_bytes + info.total_allocated_bytes;
+    out->free_bytes = info.total_free_bytes;
+    out->largest_free_block = info.largest_free_block;
+    out->peak_used_bytes = out->total_bytes - info.minimum_free_bytes;
+    out->allocated_blocks = info.allocated_blocks;
+    out->frag_pct = info.total_free_bytes ? (uint8_t)(100 - info.largest_free_block * 100 / info.total_free_bytes) : 0;
+}
+
+void mem_manager_get_stats(mem_manager_stats_t* out) {
+    if (!out) return;
+
+    *out = {};
+    tier_stats(internal_tier, &out->internal);
+    tier_stats(psram_tier, &out->psram);
+    out->system_bytes = system_bytes;
+    for (const mem_arena_t& a : arenas) {
+        if (!a.in_use) continue;
+        out->arenas_live++;
+        out->arena_bytes += a.bytes;
+        out->arena_wasted_bytes += a.wasted;
+    }
+    out->arena_peak_bytes = arena_peak_bytes;
+    out->arena_releases = arena_releases;
+}
+
+void mem_manager_log_stats() {
+    mem_manager_stats_t st;
+    mem_manager_get_stats(&st);
+    ESP_LOGI(TAG, "internal: %u/%u libres, mayor %u, pico %u, frag %u%%",
+             (unsigned)st.internal.free_bytes, (unsigned)st.internal.total_bytes,
+             (unsigned)st.internal.largest_free_block, (unsigned)st.internal.peak_used_bytes, st.internal.frag_pct);
+    ESP_LOGI(TAG, "psram: %u/%u libres, mayor %u, pico %u, frag %u%%",
+             (unsigned)st.psram.free_bytes, (unsigned)st.psram.total_bytes,
+             (unsigned)st.psram.largest_free_block, (unsigned)st.psram.peak_used_bytes, st.psram.frag_pct);
+    ESP_LOGI(TAG, "arenas: %lu vivas, %u bytes (%u libres), pico %u, %lu liberadas, sistema %u",
+             (unsigned long)st.arenas_live, (unsigned)st.arena_bytes, (unsigned)st.arena_wasted_bytes,
+             (unsigned)st.arena_peak_bytes, (unsigned long)st.arena_releases, (unsigned)st.system_bytes);
+}
+
+// ---- Interfaz LV_STDLIB_CUSTOM de LVGL ----
+
+static void* block_init(void* raw, size_t size, uint8_t source, uint8_t arena) {
+    mem_block_hdr_t* hdr = (mem_block_hdr_t*)raw;
+    hdr->size = size;
+    hdr->source = source;
+    hdr->arena = arena;
+    hdr->magic = MEM_BLOCK_MAGIC;
+    return hdr + 1;
+}
+
+static mem_block_hdr_t* block_header(void* p) {
+    mem_block_hdr_t* hdr = (mem_block_hdr_t*)p - 1;
+    LV_ASSERT_MSG(hdr->magic == MEM_BLOCK_MAGIC, "Bloque LVGL corrupto o liberado dos veces");
+    return hdr;
+}
+
+extern "C" {
+
+void lv_mem_init(void) {
+    if (internal_tier.heap) return;
+
+    tier_init(internal_tier, LVGL_MEM_INTERNAL_POOL_BYTES, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    tier_init(psram_tier, LVGL_MEM_PSRAM_POOL_BYTES, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    ESP_LOGI(TAG, "Heap LVGL: %u bytes internos + %u bytes PSRAM, %d arenas",
+             internal_tier.heap ? (unsigned)LVGL_MEM_INTERNAL_POOL_BYTES : 0,
+             psram_tier.heap ? (unsigned)LVGL_MEM_PSRAM_POOL_BYTES : 0, LVGL_MEM_ARENA_MAX);
+}
+
+void lv_mem_deinit(void) {
+    for (mem_arena_t& a : arenas) {
+        mem_arena_release(&a);
+    }
+    tier_deinit(internal_tier);
+    tier_deinit(psram_tier);
+}
+
+// Los tiers son fijos: no se admiten pools adicionales
+lv_mem_pool_t lv_mem_add_pool(void* mem, size_t bytes) {
+    ESP_LOGW(TAG, "lv_mem_add_pool no soportado");
+    return nullptr;
+}
+
+void lv_mem_remove_pool(lv_mem_pool_t pool) {
+}
+
+void* lv_malloc_core(size_t size) {
+    const size_t total = sizeof(mem_block_hdr_t) + size;
+
+    if (active_arena && size <= LVGL_MEM_ARENA_MAX_ALLOC) {
+        void* raw = arena_alloc(active_arena, total);
+        if (raw) return block_init(raw, size, MEM_SRC_ARENA, active_arena->slot);
+    }
+
+    uint8_t source;
+    void* raw = mem_alloc_raw(total, size <= LVGL_MEM_SMALL_MAX, &source);
+    return raw ? block_init(raw, size, source, 0) : nullptr;
+}
+
+// Los bloques que se redimensionan (arrays, textos) nunca van a una arena:
+// suelen ser estructuras que sobreviven a la vista que los creó.
+void* lv_realloc_core(void* p, size_t new_size) {
+    if (!p) {
+        uint8_t source;
+        void* raw = mem_alloc_raw(sizeof(mem_block_hdr_t) + new_size, new_size <= LVGL_MEM_SMALL_MAX, &source);
+        return raw ? block_init(raw, new_size, source, 0) : nullptr;
+    }
+
+    mem_block_hdr_t* hdr = block_header(p);
+    if (hdr->source == MEM_SRC_INTERNAL || hdr->source == MEM_SRC_PSRAM) {
+        multi_heap_handle_t heap = hdr->source == MEM_SRC_INTERNAL ? internal_tier.heap : psram_tier.heap;
+        mem_block_hdr_t* grown = (mem_block_hdr_t*)multi_heap_realloc(heap, hdr, sizeof(mem_block_hdr_t) + new_size);
+        if (grown) {
+            grown->size = new_size;
+            return grown + 1;
+        }
+    }
+
+    // Arena, heap del sistema o tier lleno: copiar a un bloque nuevo
+    uint8_t source;
+    void* raw = mem_alloc_raw(sizeof(mem_block_hdr_t) + new_size, new_size <= LVGL_MEM_SMALL_MAX, &source);
+    if (!raw) return nullptr;
+    void* np = block_init(raw, new_size, source, 0);
+    memcpy(np, p, hdr->size < new_size ? hdr->size : new_size);
+    lv_free_core(p);
+    return np;
+}
+
+void lv_free_core(void* p) {
+    if (!p) return;
+
+    mem_block_hdr_t* hdr = block_header(p);
+    hdr->magic = 0;
+    if (hdr->source == MEM_SRC_ARENA) {
+        // Se recupera cuando se suelta la arena entera
+        arenas[hdr->arena].wasted += MEM_ALIGN(sizeof(mem_block_hdr_t) + hdr->size);
+        return;
+    }
+    mem_free_raw(hdr, hdr->source, sizeof(mem_block_hdr_t) + hdr->size);
+}
+
+void lv_mem_monitor_core(lv_mem_monitor_t* mon_p) {
+    mem_tier_stats_t in, ps;
+    tier_stats(internal_tier, &in);
+    tier_stats(psram_tier, &ps);
+
+    lv_memzero(mon_p, sizeof(lv_mem_monitor_t));
+    mon_p->total_size = in.total_bytes + ps.total_bytes;
+    mon_p->free_size = in.free_bytes + ps.free_bytes;
+    mon_p->free_biggest_size = in.largest_free_block > ps.largest_free_block ? in.largest_free_block : ps.largest_free_block;
+    mon_p->used_cnt = in.allocated_blocks + ps.allocated_blocks;
+    mon_p->max_used = in.peak_used_bytes + ps.peak_used_bytes;
+    if (mon_p->total_size) {
+        mon_p->used_pct = (uint8_t)((mon_p->total_size - mon_p->free_size) * 100 / mon_p->total_size);
+    }
+    if (mon_p->free_size) {
+        mon_p->frag_pct = (uint8_t)(100 - mon_p->free_biggest_size * 100 / mon_p->free_size);
+    }
+}
+
+lv_result_t lv_mem_test_core(void) {
+    if (internal_tier.heap && !multi_heap_check(internal_tier.heap, true)) return LV_RESULT_INVALID;
+    if (psram_tier.heap && !multi_heap_check(psram_tier.heap, true)) return LV_RESULT_INVALID;
+    return LV_RESULT_OK;
+}
+
+}
@@ -0,0 +1,50 @@
+#ifndef MEM_MANAGER_H
+#define MEM_MANAGER_H
+
+#include "config.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Allocator de LVGL (CONFIG_LV_USE_CUSTOM_MALLOC). Implementa lv_mem_init,
+// lv_malloc_core, lv_realloc_core, lv_free_core y lv_mem_monitor_core sobre:
+//  * Tier interno: bloques pequeños y calientes (<= LVGL_MEM_SMALL_MAX).
+//  * Tier PSRAM: bloques grandes y desbordes del interno.
+//  * Arenas: mientras hay una activa, los bloques pequeños salen de ella y se
+//    liberan todos juntos con mem_arena_release.
+
+typedef struct {
+    size_t total_bytes;
+    size_t free_bytes;
+    size_t largest_free_block;
+    size_t peak_used_bytes;         // Desde el arranque
+    uint32_t allocated_blocks;
+    uint8_t frag_pct;               // 100 - bloque libre mayor / libre total
+} mem_tier_stats_t;
+
+typedef struct {
+    mem_tier_stats_t internal;
+    mem_tier_stats_t psram;
+    size_t system_bytes;            // Desbordado al heap del sistema (ambos tiers llenos)
+    uint32_t arenas_live;
+    size_t arena_bytes;             // Reservado en arenas vivas
+    size_t arena_wasted_bytes;      // Liberado dentro de arenas vivas (se recupera al soltarlas)
+    size_t arena_peak_bytes;
+    uint32_t arena_releases;
+} mem_manager_stats_t;
+
+typedef struct mem_arena mem_arena_t;
+
+// Devuelve nullptr si no quedan slots (LVGL_MEM_ARENA_MAX): se usa el heap normal.
+mem_arena_t* mem_arena_create(const char* name);
+// Activa 'arena' para las siguientes lv_malloc y devuelve la que estaba activa
+mem_arena_t* mem_arena_enter(mem_arena_t* arena);
+void mem_arena_exit(mem_arena_t* previous);
+mem_arena_t* mem_arena_current();
+size_t mem_arena_get_bytes(const mem_arena_t* arena);
+// Devuelve de golpe todos los chunks. Ningún objeto de la arena puede seguir vivo.
+void mem_arena_release(mem_arena_t* arena);
+
+void mem_manager_get_stats(mem_manager_stats_t* out);
+void mem_manager_log_stats();
+
+#endif
@@ -0,0 +1,207 @@
+#include "mic_dsp.h"
+#include <cmath>
+#include <cstring>
+
+// Potencia de un bin para un seno a fondo de escala, en log2: amplitud 2^15,
+// ganancia coherente de Hann 1/2 y FFT escalada por 1/N → |X| = 2^13, P = 2^26
+#define FULL_SCALE_LOG2     26
+// 10·log10(2) en Q8
+#define DB_PER_LOG2_Q8      771
+
+static uint32_t isqrt32(uint32_t v) {
+    uint32_t root = 0;
+    uint32_t bit = 1u << 30;
+    while (bit > v) bit >>= 2;
+    while (bit) {
+        if (v >= root + bit) {
+            v -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+// log2 en Q8 con la mantisa interpolada linealmente (error < 0,09)
+static int32_t log2_q8(uint64_t v) {
+    const int e = 63 - __builtin_clzll(v);
+    const uint32_t frac = e >= 8 ? (uint32_t)(v >> (e - 8)) & 0xFF : (uint32_t)(v << (8 - e)) & 0xFF;
+    return e * 256 + (int32_t)frac;
+}
+
+bool mic_dsp_init(mic_dsp_t* dsp, uint16_t n, uint8_t bands, int16_t floor_db) {
+    if (n < 8 || n > MIC_DSP_MAX_FFT || (n & (n - 1)) || bands == 0 || bands > MIC_DSP_MAX_BANDS ||
+        bands > n / 2 - 1 || floor_db >= 0) {
+        return false;
+    }
+    memset(dsp, 0, sizeof(*dsp));
+    dsp->n = n;
+    dsp->bands = bands;
+    dsp->floor_db = floor_db;
+    while ((1u << dsp->log2n) < n) dsp->log2n++;
+
+    const double pi = 3.14159265358979323846;
+    for (uint32_t i = 0; i < n; i++) {
+        dsp->window[i] = (int16_t)lround(32767.0 * 0.5 * (1.0 - cos(2.0 * pi * i / n)));
+
+        uint32_t r = 0;
+        for (uint32_t b = 0; b < dsp->log2n; b++) {
+            if (i & (1u << b)) r |= 1u << (dsp->log2n - 1 - b);
+        }
+        dsp->bitrev[i] = (uint16_t)r;
+    }
+    for (uint32_t k = 0; k < n / 2; k++) {
+        dsp->twiddle[2 * k] = (int16_t)lround(32767.0 * cos(2.0 * pi * k / n));
+        dsp->twiddle[2 * k + 1] = (int16_t)lround(-32767.0 * sin(2.0 * pi * k / n));
+    }
+
+    // Bordes logarítmicos entre el bin 1 y n/2, al menos un bin por banda
+    const uint32_t last = n / 2;
+    dsp->band_edge[0] = 1;
+    for (uint32_t b = 1; b <= bands; b++) {
+        uint32_t edge = (uint32_t)lround(pow((double)last, (double)b / bands));
+        const uint32_t min_edge = dsp->band_edge[b - 1] + 1u;
+        const uint32_t max_edge = last - (bands - b);
+        if (edge < min_edge) edge = min_edge;
+        if (edge > max_edge) edge = max_edge;
+        dsp->band_edge[b] = (uint16_t)edge;
+    }
+    return true;
+}
+
+void mic_dsp_level(const int16_t* x, uint32_t n, mic_dsp_level_t* out) {
+    // Dos muestras por carga de 32 bits; los cuadrados de un par caben en 32 bits
+    const uint32_t* w = (const uint32_t*)__builtin_assume_aligned(x, 4);
+    int32_t sum = 0;
+    uint64_t sum_sq = 0;
+    int32_t lo = INT16_MAX;
+    int32_t hi = INT16_MIN;
+    for (uint32_t i = 0; i < n / 2; i++) {
+        const uint32_t v = w[i];
+        const int32_t a = (int16_t)(v & 0xFFFF);
+        const int32_t b = (int16_t)(v >> 16);
+        sum += a + b;
+        sum_sq += (uint32_t)(a * a) + (uint32_t)(b * b);
+        if (a < lo) lo = a;
+        if (a > hi) hi = a;
+        if (b < lo) lo = b;
+        if (b > hi) hi = b;
+    }
+
+    if (n < 2) {
+        *out = {};
+        return;
+    }
+    const int32_t mean = sum / (int32_t)(n & ~1u);
+    const uint64_t mean_sq = (uint64_t)((int64_t)mean * mean);
+    const uint64_t msq = sum_sq / (n & ~1u);
+    out->mean = mean;
+    out->rms = (uint16_t)isqrt32((uint32_t)(msq > mean_sq ? msq - mean_sq : 0));
+    const int32_t up = hi - mean;
+    const int32_t down = mean - lo;
+    out->peak = (uint16_t)(up > down ? up : down);
+}
+
+void mic_dsp_load(mic_dsp_t* dsp, const int16_t* x, const mic_dsp_level_t* level) {
+    const uint32_t n = dsp->n;
+    dsp->silent = level->peak == 0;
+    if (dsp->silent) return;
+
+    // Coma flotante por bloque: |x - mean| << shift < 2^14. El bit libre
+    // garantiza que ninguna etapa de la FFT desborda int16
+    const int msb = 31 - __builtin_clz(level->peak);
+    const int shift = 13 - msb;
+    dsp->shift = (int8_t)shift;
+
+    const int32_t mean = level->mean;
+    int16_t* work = dsp->work;
+    for (uint32_t i = 0; i < n; i++) {
+        const uint32_t src = dsp->bitrev[i];
+        int32_t v = x[src] - mean;
+        v = shift >= 0 ? v << shift : v >> -shift;
+        work[2 * i] = (int16_t)((v * dsp->window[src]) >> 15);
+        work[2 * i + 1] = 0;
+    }
+}
+
+void mic_dsp_fft(mic_dsp_t* dsp) {
+    if (dsp->silent) return;
+    const uint32_t n = dsp->n;
+    int16_t* d = dsp->work;
+
+    // Primera etapa: twiddle = 1, sin multiplicaciones
+    for (uint32_t i = 0; i < n; i += 2) {
+        int16_t* a = &d[2 * i];
+        const int32_t ar = a[0], ai = a[1], br = a[2], bi = a[3];
+        a[0] = (int16_t)((ar + br) >> 1);
+        a[1] = (int16_t)((ai + bi) >> 1);
+        a[2] = (int16_t)((ar - br) >> 1);
+        a[3] = (int16_t)((ai - bi) >> 1);
+    }
+
+    // Resto de etapas radix-2 DIT, escalando ½ en cada una (salida = X/N)
+    for (uint32_t len = 4; len <= n; len <<= 1) {
+        const uint32_t half = len >> 1;
+        const uint32_t step = n / len;
+        for (uint32_t i = 0; i < n; i += len) {
+            const int16_t* tw = dsp->twiddle;
+            for (uint32_t j = 0; j < half; j++, tw += 2 * step) {
+                int16_t* a = &d[2 * (i + j)];
+                int16_t* b = &d[2 * (i + j + half)];
+                const int32_t wr = tw[0], wi = tw[1];
+                const int32_t br = b[0], bi = b[1];
+                const int32_t tr = (br * wr - bi * wi) >> 15;
+                const int32_t ti = (br * wi + bi * wr) >> 15;
+                const int32_t ar = a[0], ai = a[1];
+                a[0] = (int16_t)((ar + tr) >> 1);
+                a[1] = (int16_t)((ai + ti) >> 1);
+                b[0] = (int16_t)((ar - tr) >> 1);
+                b[1] = (int16_t)((ai - ti) >> 1);
+            }
+        }
+    }
+}
+
+void mic_dsp_bands(const mic_dsp_t* dsp, uint8_t* levels) {
+    if (dsp->silent) {
+        memset(levels, 0, dsp->bands);
+        return;
+    }
+
+    // Referencia de 0 dBFS en el dominio normalizado: P se multiplicó por 2^(2·shift)
+    const int32_t ref_q8 = (FULL_SCALE_LOG2 + 2 * dsp->shift) * 256;
+    const int32_t floor_q8 = dsp->floor_db * 256;
+    const int16_t* d = dsp->work;
+    for (uint32_t b = 0; b < dsp->bands; b++) {
+        uint64_t power = 0;
+        for (uint32_t k = dsp->band_edge[b]; k < dsp->band_edge[b + 1]; k++) {
+            const int32_t re = d[2 * k];
+            const int32_t im = d[2 * k + 1];
+            power += (uint32_t)(re * re) + (uint32_t)(im * im);
+        }
+        if (!power) {
+            levels[b] = 0;
+            continue;
+        }
+        const int32_t db_q8 = ((log2_q8(power) - ref_q8) * DB_PER_LOG2_Q8) >> 8;
+        int32_t level = (db_q8 - floor_q8) * MIC_DSP_LEVEL_MAX / -floor_q8;
+        if (level < 0) level = 0;
+        if (level > MIC_DSP_LEVEL_MAX) level = MIC_DSP_LEVEL_MAX;
+        levels[b] = (uint8_t)level;
+    }
+}
+
+void mic_dsp_spectrum(mic_dsp_t* dsp, const int16_t* x, const mic_dsp_level_t* level, uint8_t* levels) {
+    mic_dsp_load(dsp, x, level);
+    mic_dsp_fft(dsp);
+    mic_dsp_bands(dsp, levels);
+}
+
+int16_t mic_dsp_dbfs_x10(uint32_t amplitude) {
+    if (!amplitude) return -999;
+    // 200·log10(a / 2^15) = 60,206·(log2 a - 15); 60,206 / 256 en Q16 = 15413
+    const int32_t db_x10 = ((log2_q8(amplitude) - 15 * 256) * 15413) >> 16;
+    return (int16_t)(db_x10 < -999 ? -999 : db_x10);
+}
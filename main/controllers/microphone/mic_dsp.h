@@ -0,0 +1,58 @@
+#ifndef MIC_DSP_H
+#define MIC_DSP_H
+
+// Kernels de audio en punto fijo, sin dependencias de ESP-IDF ni de FreeRTOS:
+// el mismo código procesa los bloques del I2S y los de un WAV en el PC.
+//
+// Por bloque de N muestras int16:
+//   1. mic_dsp_level: media (DC), RMS de la parte alterna y pico, en una pasada.
+//   2. mic_dsp_spectrum: quita la DC, normaliza el bloque (coma flotante por
+//      bloque), aplica Hann, FFT compleja radix-2 Q15 con escalado por etapa
+//      y agrupa los bins en bandas logarítmicas en dBFS.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define MIC_DSP_MAX_FFT     1024
+#define MIC_DSP_MAX_BANDS   32
+#define MIC_DSP_LEVEL_MAX   255         // Nivel de banda para 0 dBFS
+
+typedef struct {
+    int32_t mean;
+    uint16_t rms;           // De la señal sin DC
+    uint16_t peak;          // |x - mean| máximo
+} mic_dsp_level_t;
+
+typedef struct {
+    uint16_t n;                         // Tamaño de la FFT (potencia de 2)
+    uint8_t log2n;
+    uint8_t bands;
+    int16_t floor_db;                   // dBFS que corresponde al nivel 0
+    int16_t window[MIC_DSP_MAX_FFT];    // Hann Q15
+    int16_t twiddle[MIC_DSP_MAX_FFT];   // N/2 pares (cos, -sin) Q15
+    uint16_t bitrev[MIC_DSP_MAX_FFT];
+    uint16_t band_edge[MIC_DSP_MAX_BANDS + 1];  // Primer bin de cada banda
+    int16_t work[2 * MIC_DSP_MAX_FFT];  // Re/Im intercalados
+    int8_t shift;                       // Normalización del último bloque (x << shift)
+    bool silent;                        // Último bloque sin parte alterna
+} mic_dsp_t;
+
+// Tablas para una FFT de 'n' puntos y 'bands' bandas entre el bin 1 y n/2
+bool mic_dsp_init(mic_dsp_t* dsp, uint16_t n, uint8_t bands, int16_t floor_db);
+
+// 'x' alineado a 4 bytes y 'n' par: se leen dos muestras por acceso de 32 bits
+void mic_dsp_level(const int16_t* x, uint32_t n, mic_dsp_level_t* out);
+
+// dsp->n muestras de 'x' → 'levels' (dsp->bands valores 0..MIC_DSP_LEVEL_MAX).
+// Necesita el resultado de mic_dsp_level del mismo bloque. Equivale a las
+// tres etapas de abajo, separadas para medir cada una.
+void mic_dsp_spectrum(mic_dsp_t* dsp, const int16_t* x, const mic_dsp_level_t* level, uint8_t* levels);
+
+void mic_dsp_load(mic_dsp_t* dsp, const int16_t* x, const mic_dsp_level_t* level); // DC, escala, Hann, bit-reverse
+void mic_dsp_fft(mic_dsp_t* dsp);
+void mic_dsp_bands(const mic_dsp_t* dsp, uint8_t* levels);
+
+// Amplitud (unidades int16) → dBFS ×10, con 0 → -999
+int16_t mic_dsp_dbfs_x10(uint32_t amplitude);
+
+#endif
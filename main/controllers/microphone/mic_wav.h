@@ -0,0 +1,66 @@
+#ifndef MIC_WAV_H
+#define MIC_WAV_H
+
+// Lectura de WAV PCM de 16 bits para microphone_feed_wav. Solo stdio y
+// funciones inline, sin ESP-IDF: el PC lee los ficheros con el mismo código.
+//
+//   RIFF <size> WAVE  ["fmt " 16+ B] [otros chunks] "data" <size> <muestras>
+//
+// Los chunks de tamaño impar llevan un byte de relleno. Estéreo: se usa el
+// canal izquierdo, que es el que lee el I2S.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+typedef struct {
+    uint16_t channels;          // 1 o 2
+    uint32_t sample_rate;
+    uint32_t data_bytes;
+} mic_wav_info_t;
+
+// Deja 'f' al principio de las muestras. false si no es RIFF/WAVE PCM de 16 bits.
+static inline bool mic_wav_read_header(FILE* f, mic_wav_info_t* info) {
+    uint8_t riff[12];
+    if (fread(riff, 1, sizeof(riff), f) != sizeof(riff) || memcmp(riff, "RIFF", 4) || memcmp(riff + 8, "WAVE", 4)) {
+        return false;
+    }
+    bool have_fmt = false;
+    for (;;) {
+        uint8_t chunk[8];
+        if (fread(chunk, 1, sizeof(chunk), f) != sizeof(chunk)) return false;
+        uint32_t size;
+        memcpy(&size, chunk + 4, 4);
+        if (!memcmp(chunk, "fmt ", 4)) {
+            uint8_t fmt[16];
+            if (size < sizeof(fmt) || fread(fmt, 1, sizeof(fmt), f) != sizeof(fmt)) return false;
+            uint16_t format, bits;
+            memcpy(&format, fmt, 2);
+            memcpy(&info->channels, fmt + 2, 2);
+            memcpy(&info->sample_rate, fmt + 4, 4);
+            memcpy(&bits, fmt + 14, 2);
+            if (format != 1 || bits != 16 || info->channels == 0 || info->channels > 2) return false;
+            fseek(f, (long)(size - sizeof(fmt) + (size & 1)), SEEK_CUR);
+            have_fmt = true;
+        } else if (!memcmp(chunk, "data", 4)) {
+            info->data_bytes = size;
+            return have_fmt;
+        } else {
+            fseek(f, (long)(size + (size & 1)), SEEK_CUR);
+        }
+    }
+}
+
+// Lee 'frames' muestras del canal izquierdo en 'buf', que tiene sitio para
+// 'frames' tramas completas (2 × frames int16 en estéreo): la trama entrelazada
+// se compacta en el mismo buffer. false al final de los datos.
+static inline bool mic_wav_read_block(FILE* f, const mic_wav_info_t* info, int16_t* buf, uint32_t frames) {
+    if (fread(buf, 2u * info->channels, frames, f) != frames) return false;
+    if (info->channels == 2) {
+        for (uint32_t i = 0; i < frames; i++) buf[i] = buf[2 * i];
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,382 @@
+#include "microphone.h"
+#include "mic_wav.h"
+#include "utils/spsc_queue.h"
+#include "driver/i2s_std.h"
+#include "esp_check.h"
+#include "esp_cpu.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_private/esp_clk.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+static const char* TAG = "MICROPHONE";
+
+#define MIC_TASK_STACK      4096
+
+static_assert(MIC_DMA_BLOCKS >= 3 && MIC_DMA_BLOCKS <= 8, "MIC_DMA_BLOCKS entre 3 y 8");
+static_assert((MIC_BLOCK_SAMPLES & (MIC_BLOCK_SAMPLES - 1)) == 0, "MIC_BLOCK_SAMPLES debe ser potencia de 2");
+
+// Referencia a un buffer DMA del driver: el bloque no se copia
+typedef struct {
+    const int16_t* data;
+    uint32_t seq;
+} mic_block_t;
+
+static i2s_chan_handle_t rx_chan = nullptr;
+static TaskHandle_t mic_task = nullptr;
+static SpscQueue<mic_block_t, 8> block_queue;
+static std::atomic<uint32_t> isr_seq{0};
+static std::atomic<uint32_t> isr_dropped{0};
+
+// El canal solo está habilitado mientras alguien quiere bloques (espectro o
+// block_cb) y no hay un WAV entrando: habilitado, el driver mantiene un lock
+// APB_FREQ_MAX que impide el light sleep. Protegido por proc_lock.
+static bool chan_ready = false;
+static bool capturing = false;
+static bool wav_feeding = false;
+static uint32_t stale_seq = 0;          // Bloques encolados antes del último arranque
+static const char* source = "-";
+
+// Procesado: lo usan la tarea, microphone_feed_wav y el benchmark, nunca a la vez
+static SemaphoreHandle_t proc_lock = nullptr;
+static mic_dsp_t* dsp = nullptr;
+static std::atomic<bool> spectrum_enabled{false};
+static mic_block_cb_t block_cb = nullptr;
+static void* block_cb_user = nullptr;
+
+// Instantánea publicada con un seqlock: impar = escritura en curso
+static mic_levels_t levels = {};
+static std::atomic<uint32_t> levels_seq{0};
+
+static mic_stats_t stats = {};
+static uint64_t level_cycles_total = 0;
+static uint64_t spectrum_cycles_total = 0;
+
+// ISR de fin de bloque DMA: solo pasa el puntero. El driver sigue llenando
+// los demás buffers; con MIC_DMA_BLOCKS descriptores, la tarea tiene
+// MIC_DMA_BLOCKS - 1 bloques de margen antes de que se pise este.
+static bool IRAM_ATTR mic_on_recv(i2s_chan_handle_t handle, i2s_event_data_t* event, void* user_ctx) {
+    const mic_block_t block = { (const int16_t*)event->dma_buf, isr_seq.fetch_add(1, std::memory_order_relaxed) + 1 };
+    if (!block_queue.push(block)) {
+        isr_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(mic_task, &woken);
+    return woken == pdTRUE;
+}
+
+static void publish_levels(const mic_dsp_level_t* lvl, const uint8_t* bands, bool with_bands, uint32_t seq) {
+    levels_seq.fetch_add(1, std::memory_order_acq_rel);
+    levels.seq = seq;
+    levels.rms = lvl->rms;
+    levels.peak = lvl->peak;
+    levels.rms_dbfs_x10 = mic_dsp_dbfs_x10(lvl->rms);
+    levels.peak_dbfs_x10 = mic_dsp_dbfs_x10(lvl->peak);
+    if (with_bands) {
+        memcpy(levels.bands, bands, MIC_SPECTRUM_BANDS);
+    } else {
+        memset(levels.bands, 0, MIC_SPECTRUM_BANDS);
+    }
+    levels_seq.fetch_add(1, std::memory_order_release);
+}
+
+// El mismo camino para bloques del I2S y de un WAV. Llamar con proc_lock tomado.
+static void process_block(const int16_t* samples, uint32_t seq) {
+    const uint32_t c0 = esp_cpu_get_cycle_count();
+    mic_dsp_level_t lvl;
+    mic_dsp_level(samples, MIC_BLOCK_SAMPLES, &lvl);
+    const uint32_t c1 = esp_cpu_get_cycle_count();
+
+    uint8_t bands[MIC_SPECTRUM_BANDS];
+    const bool with_bands = spectrum_enabled.load(std::memory_order_relaxed);
+    if (with_bands) {
+        mic_dsp_spectrum(dsp, samples, &lvl, bands);
+    }
+    const uint32_t c2 = esp_cpu_get_cycle_count();
+
+    publish_levels(&lvl, bands, with_bands, seq);
+    if (block_cb) {
+        block_cb(samples, MIC_BLOCK_SAMPLES, block_cb_user);
+    }
+
+    stats.blocks++;
+    level_cycles_total += c1 - c0;
+    if (with_bands) {
+        stats.spectrum_blocks++;
+        spectrum_cycles_total += c2 - c1;
+    }
+    if (c2 - c0 > stats.block_cycles_max) {
+        stats.block_cycles_max = c2 - c0;
+    }
+}
+
+static void mic_task_fn(void* arg) {
+    for (;;) {
+        mic_block_t block;
+        if (!block_queue.pop(block)) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+        xSemaphoreTake(proc_lock, portMAX_DELAY);
+        // Lo encolado antes de parar el canal apunta a buffers DMA ya reciclados
+        if (capturing && block.seq > stale_seq) {
+            process_block(block.data, block.seq);
+            // Si el DMA dio la vuelta mientras tanto, el bloque pudo cambiar bajo nuestros pies
+            if (isr_seq.load(std::memory_order_relaxed) - block.seq >= MIC_DMA_BLOCKS - 1) {
+                stats.overruns++;
+            }
+        }
+        xSemaphoreGive(proc_lock);
+    }
+}
+
+static esp_err_t mic_i2s_init() {
+    i2s_chan_config_t chan_cfg = I2S_CHANNEL_DEFAULT_CONFIG(MIC_I2S_PORT, I2S_ROLE_MASTER);
+    // Un descriptor DMA por bloque: cada on_recv entrega exactamente un bloque
+    chan_cfg.dma_desc_num = MIC_DMA_BLOCKS;
+    chan_cfg.dma_frame_num = MIC_BLOCK_SAMPLES;
+    ESP_RETURN_ON_ERROR(i2s_new_channel(&chan_cfg, nullptr, &rx_chan), TAG, "i2s_new_channel");
+
+    // Muestras de 16 bits en slots de 32: el periférico se queda con los 16 bits
+    // altos del dato de 24 del micrófono, así el DMA ya entrega int16 mono
+    i2s_std_config_t std_cfg = {};
+    std_cfg.clk_cfg = I2S_STD_CLK_DEFAULT_CONFIG(MIC_SAMPLE_RATE);
+    std_cfg.slot_cfg = I2S_STD_PHILIPS_SLOT_DEFAULT_CONFIG(I2S_DATA_BIT_WIDTH_16BIT, I2S_SLOT_MODE_MONO);
+    std_cfg.slot_cfg.slot_bit_width = I2S_SLOT_BIT_WIDTH_32BIT;
+    std_cfg.slot_cfg.slot_mask = I2S_STD_SLOT_LEFT;
+    std_cfg.gpio_cfg.mclk = I2S_GPIO_UNUSED;
+    std_cfg.gpio_cfg.bclk = MIC_SCK;
+    std_cfg.gpio_cfg.ws = MIC_WS;
+    std_cfg.gpio_cfg.dout = I2S_GPIO_UNUSED;
+    std_cfg.gpio_cfg.din = MIC_SD;
+    ESP_RETURN_ON_ERROR(i2s_channel_init_std_mode(rx_chan, &std_cfg), TAG, "i2s_channel_init_std_mode");
+
+    i2s_event_callbacks_t cbs = {};
+    cbs.on_recv = mic_on_recv;
+    return i2s_channel_register_event_callback(rx_chan, &cbs, nullptr);
+}
+
+// Habilita o para el canal según la demanda. Llamar con proc_lock tomado.
+static void capture_update() {
+    const bool wanted = chan_ready && !wav_feeding &&
+                        (spectrum_enabled.load(std::memory_order_relaxed) || block_cb != nullptr);
+    if (wanted != capturing) {
+        if (wanted) {
+            stale_seq = isr_seq.load(std::memory_order_relaxed);
+            capturing = i2s_channel_enable(rx_chan) == ESP_OK;
+        } else {
+            i2s_channel_disable(rx_chan);
+            capturing = false;
+        }
+        ESP_LOGD(TAG, "Captura %s", capturing ? "en marcha" : "parada");
+    }
+    source = capturing ? "i2s" : wav_feeding ? "wav" : "-";
+}
+
+esp_err_t microphone_init() {
+    if (mic_task) return ESP_OK;
+
+    dsp = (mic_dsp_t*)heap_caps_malloc(sizeof(mic_dsp_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    proc_lock = xSemaphoreCreateMutex();
+    if (!dsp || !proc_lock) return ESP_ERR_NO_MEM;
+    mic_dsp_init(dsp, MIC_BLOCK_SAMPLES, MIC_SPECTRUM_BANDS, MIC_SPECTRUM_FLOOR_DB);
+
+    if (xTaskCreatePinnedToCore(mic_task_fn, "mic", MIC_TASK_STACK, nullptr, MIC_TASK_PRIORITY,
+                                &mic_task, MIC_TASK_CORE) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    const esp_err_t err = mic_i2s_init();
+    if (err != ESP_OK) {
+        // Sin micrófono el procesado sigue disponible para WAV y benchmark
+        ESP_LOGW(TAG, "Sin captura I2S: %s", esp_err_to_name(err));
+        return err;
+    }
+    // El canal queda configurado pero parado hasta que alguien pida bloques
+    chan_ready = true;
+    ESP_LOGI(TAG, "I2S a %d Hz, bloques de %d muestras (%d ms), %d buffers DMA",
+             MIC_SAMPLE_RATE, MIC_BLOCK_SAMPLES, MIC_BLOCK_SAMPLES * 1000 / MIC_SAMPLE_RATE, MIC_DMA_BLOCKS);
+    return ESP_OK;
+}
+
+bool microphone_is_running() {
+    return chan_ready;
+}
+
+void microphone_set_spectrum_enabled(bool enabled) {
+    spectrum_enabled.store(enabled, std::memory_order_relaxed);
+    if (!proc_lock) return;
+    xSemaphoreTake(proc_lock, portMAX_DELAY);
+    capture_update();
+    xSemaphoreGive(proc_lock);
+}
+
+void microphone_get_levels(mic_levels_t* out) {
+    for (;;) {
+        const uint32_t s1 = levels_seq.load(std::memory_order_acquire);
+        if (s1 & 1) continue;
+        memcpy(out, &levels, sizeof(*out));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (levels_seq.load(std::memory_order_relaxed) == s1) return;
+    }
+}
+
+void microphone_get_stats(mic_stats_t* out) {
+    if (!proc_lock) {
+        *out = {};
+        return;
+    }
+    xSemaphoreTake(proc_lock, portMAX_DELAY);
+    *out = stats;
+    out->running = chan_ready;
+    out->capturing = capturing;
+    out->source = source;
+    out->dropped = isr_dropped.load(std::memory_order_relaxed);
+    out->level_cycles_avg = stats.blocks ? (uint32_t)(level_cycles_total / stats.blocks) : 0;
+    out->spectrum_cycles_avg = stats.spectrum_blocks ? (uint32_t)(spectrum_cycles_total / stats.spectrum_blocks) : 0;
+    xSemaphoreGive(proc_lock);
+}
+
+void microphone_reset_stats() {
+    if (!proc_lock) return;
+    xSemaphoreTake(proc_lock, portMAX_DELAY);
+    stats = {};
+    level_cycles_total = 0;
+    spectrum_cycles_total = 0;
+    isr_dropped.store(0, std::memory_order_relaxed);
+    xSemaphoreGive(proc_lock);
+}
+
+void microphone_set_block_cb(mic_block_cb_t cb, void* user) {
+    if (!proc_lock) return;
+    xSemaphoreTake(proc_lock, portMAX_DELAY);
+    block_cb = cb;
+    block_cb_user = user;
+    capture_update();
+    xSemaphoreGive(proc_lock);
+}
+
+// --- WAV ------------------------------------------------------------------------
+
+esp_err_t microphone_feed_wav(const char* path, bool realtime) {
+    if (!mic_task) return ESP_ERR_INVALID_STATE;
+
+    FILE* f = fopen(path, "rb");
+    if (!f) return ESP_ERR_NOT_FOUND;
+    mic_wav_info_t info = {};
+    if (!mic_wav_read_header(f, &info)) {
+        fclose(f);
+        ESP_LOGE(TAG, "%s: no es un WAV PCM de 16 bits", path);
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    if (info.sample_rate != MIC_SAMPLE_RATE) {
+        ESP_LOGW(TAG, "%s: %lu Hz (las bandas asumen %d Hz)", path, (unsigned long)info.sample_rate, MIC_SAMPLE_RATE);
+    }
+
+    // Estéreo: se lee el bloque entrelazado y se compacta el canal izquierdo en el mismo buffer
+    const uint32_t frame_bytes = 2 * info.channels;
+    int16_t* buf = (int16_t*)heap_caps_malloc(MIC_BLOCK_SAMPLES * frame_bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (!buf) {
+        fclose(f);
+        return ESP_ERR_NO_MEM;
+    }
+
+    // Captura parada: el WAV sustituye al micrófono por el mismo camino
+    xSemaphoreTake(proc_lock, portMAX_DELAY);
+    wav_feeding = true;
+    capture_update();
+    xSemaphoreGive(proc_lock);
+
+    const int64_t block_us = (int64_t)MIC_BLOCK_SAMPLES * 1000000 / MIC_SAMPLE_RATE;
+    int64_t next_us = esp_timer_get_time();
+    uint32_t remaining = info.data_bytes / frame_bytes;
+    uint32_t fed = 0;
+    while (remaining >= MIC_BLOCK_SAMPLES) {
+        if (!mic_wav_read_block(f, &info, buf, MIC_BLOCK_SAMPLES)) break;
+        remaining -= MIC_BLOCK_SAMPLES;
+
+        xSemaphoreTake(proc_lock, portMAX_DELAY);
+        process_block(buf, ++fed);
+        xSemaphoreGive(proc_lock);
+
+        if (realtime) {
+            next_us += block_us;
+            const int64_t wait_us = next_us - esp_timer_get_time();
+            if (wait_us > 0) vTaskDelay(pdMS_TO_TICKS(wait_us / 1000) + 1);
+        }
+    }
+    fclose(f);
+    heap_caps_free(buf);
+    ESP_LOGI(TAG, "%s: %lu bloques procesados", path, (unsigned long)fed);
+
+    // Vuelve la captura si alguien la estaba pidiendo
+    xSemaphoreTake(proc_lock, portMAX_DELAY);
+    wav_feeding = false;
+    capture_update();
+    xSemaphoreGive(proc_lock);
+    return ESP_OK;
+}
+
+// --- Benchmark ------------------------------------------------------------------
+
+void microphone_benchmark(uint32_t blocks) {
+    if (!dsp || blocks == 0) return;
+
+    int16_t* x = (int16_t*)heap_caps_aligned_alloc(4, MIC_BLOCK_SAMPLES * sizeof(int16_t), MALLOC_CAP_INTERNAL);
+    if (!x) return;
+
+    uint64_t total[4] = {};
+    uint32_t worst[4] = {};
+    uint8_t bands[MIC_SPECTRUM_BANDS];
+    const double pi = 3.14159265358979323846;
+    double phase = 0.0;
+
+    xSemaphoreTake(proc_lock, portMAX_DELAY);
+    for (uint32_t b = 0; b < blocks; b++) {
+        // Barrido de 100 Hz a Nyquist con ruido: todas las bandas y escalas pasan por la FFT
+        const double f0 = 100.0 + (MIC_SAMPLE_RATE / 2 - 200.0) * b / blocks;
+        const double amp = 200.0 + 30000.0 * ((b * 7) % 16) / 16.0;
+        for (uint32_t i = 0; i < MIC_BLOCK_SAMPLES; i++) {
+            phase += 2.0 * pi * f0 / MIC_SAMPLE_RATE;
+            x[i] = (int16_t)(amp * sin(phase) + (int)(esp_cpu_get_cycle_count() & 63) - 32);
+        }
+
+        uint32_t c[5];
+        mic_dsp_level_t lvl;
+        c[0] = esp_cpu_get_cycle_count();
+        mic_dsp_level(x, MIC_BLOCK_SAMPLES, &lvl);
+        c[1] = esp_cpu_get_cycle_count();
+        mic_dsp_load(dsp, x, &lvl);
+        c[2] = esp_cpu_get_cycle_count();
+        mic_dsp_fft(dsp);
+        c[3] = esp_cpu_get_cycle_count();
+        mic_dsp_bands(dsp, bands);
+        c[4] = esp_cpu_get_cycle_count();
+
+        for (int s = 0; s < 4; s++) {
+            const uint32_t d = c[s + 1] - c[s];
+            total[s] += d;
+            if (d > worst[s]) worst[s] = d;
+        }
+    }
+    xSemaphoreGive(proc_lock);
+    heap_caps_free(x);
+
+    const uint32_t mhz = esp_clk_cpu_freq() / 1000000;
+    const uint64_t sum = total[0] + total[1] + total[2] + total[3];
+    const uint64_t budget = (uint64_t)esp_clk_cpu_freq() * MIC_BLOCK_SAMPLES / MIC_SAMPLE_RATE;
+    printf("MICBENCH,blocks,samples,level_cyc,load_cyc,fft_cyc,bands_cyc,block_cyc_max,block_us,budget_pct_x100\n");
+    printf("MICBENCH,%lu,%d,%llu,%llu,%llu,%llu,%lu,%llu,%llu\n", (unsigned long)blocks, MIC_BLOCK_SAMPLES,
+           (unsigned long long)(total[0] / blocks), (unsigned long long)(total[1] / blocks),
+           (unsigned long long)(total[2] / blocks), (unsigned long long)(total[3] / blocks),
+           (unsigned long)(worst[0] + worst[1] + worst[2] + worst[3]),
+           (unsigned long long)(sum / blocks / (mhz ? mhz : 1)),
+           (unsigned long long)(sum * 10000 / blocks / budget));
+}
@@ -0,0 +1,70 @@
+#ifndef MICROPHONE_H
+#define MICROPHONE_H
+
+#include "esp_err.h"
+#include "config.h"
+#include "mic_dsp.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Captura I2S de un micrófono digital (INMP441 o similar, canal izquierdo).
+// Los bloques de MIC_BLOCK_SAMPLES muestras son los propios buffers DMA del
+// driver: el ISR de fin de bloque pasa el puntero a la tarea 'mic' por una
+// SpscQueue y nadie los copia. La tarea (núcleo MIC_TASK_CORE, fuera del de
+// render) calcula RMS, pico y, si hay alguien mirando, el espectro, y publica
+// el resultado en una instantánea que la UI lee sin bloquear.
+// El canal solo se habilita mientras alguien pide bloques (espectro o
+// block_cb): parado, el driver suelta su lock de PM y el chip puede dormir.
+
+typedef struct {
+    uint32_t seq;                       // Bloque del que sale (0 = aún ninguno)
+    uint16_t rms;
+    uint16_t peak;
+    int16_t rms_dbfs_x10;
+    int16_t peak_dbfs_x10;
+    uint8_t bands[MIC_SPECTRUM_BANDS];  // 0 = MIC_SPECTRUM_FLOOR_DB, 255 = 0 dBFS
+} mic_levels_t;
+
+typedef struct {
+    bool running;                       // Canal I2S configurado
+    bool capturing;                     // Canal habilitado ahora mismo
+    const char* source;                 // "i2s", "wav" o "-"
+    uint32_t blocks;                    // Procesados
+    uint32_t dropped;                   // Cola llena en el ISR
+    uint32_t overruns;                  // El DMA pudo pisar el bloque mientras se procesaba
+    uint32_t spectrum_blocks;
+    // Ciclos de CPU por bloque
+    uint32_t level_cycles_avg;
+    uint32_t spectrum_cycles_avg;
+    uint32_t block_cycles_max;
+} mic_stats_t;
+
+// Bloque prestado: solo es válido durante la llamada
+typedef void (*mic_block_cb_t)(const int16_t* samples, uint32_t count, void* user);
+
+// Configura el canal I2S sin habilitarlo
+esp_err_t microphone_init();
+// Hay micrófono (la captura puede estar parada)
+bool microphone_is_running();
+
+// Captura y FFT solo mientras alguien las pide (SpectrumView en pantalla)
+void microphone_set_spectrum_enabled(bool enabled);
+
+// Copia consistente de los últimos niveles (seqlock: el lector nunca bloquea a la tarea)
+void microphone_get_levels(mic_levels_t* out);
+void microphone_get_stats(mic_stats_t* out);
+void microphone_reset_stats();
+
+// Consumidor adicional de los bloques crudos (grabación, detección...). Corre en la
+// tarea 'mic'. Mientras haya uno la captura sigue en marcha; nullptr lo quita.
+void microphone_set_block_cb(mic_block_cb_t cb, void* user);
+
+// Pasa un WAV PCM de 16 bits (mono o estéreo → canal izquierdo) por el mismo
+// procesado que los bloques del I2S, con la captura parada. Con 'realtime' respeta
+// la duración de cada bloque, para verlo en SpectrumView; sin él va tan rápido como puede.
+esp_err_t microphone_feed_wav(const char* path, bool realtime);
+
+// Coste por bloque de cada etapa (nivel, carga+ventana, FFT, bandas) con un barrido sintético
+void microphone_benchmark(uint32_t blocks);
+
+#endif
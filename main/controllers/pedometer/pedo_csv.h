@@ -0,0 +1,43 @@
+#ifndef PEDO_CSV_H
+#define PEDO_CSV_H
+
+// Líneas de las trazas CSV del podómetro. Solo stdio y funciones inline:
+// pedometer_replay_csv en la placa y el test de host leen igual los ficheros.
+//
+//   # steps=N        valor esperado de la traza (opcional)
+//   x,y,z            una muestra en mg
+//   t,x,y,z          con marca de tiempo, que se ignora
+//
+// Las demás líneas (cabeceras, vacías, comentarios) se saltan.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+typedef enum {
+    PEDO_CSV_SKIP,
+    PEDO_CSV_SAMPLE,        // 'xyz' tiene la muestra en cuentas de 'lsb_per_g'
+    PEDO_CSV_EXPECTED,      // '*expected' tiene el N de "# steps=N"
+} pedo_csv_line_t;
+
+static inline pedo_csv_line_t pedo_csv_parse_line(const char* line, uint16_t lsb_per_g,
+                                                  int16_t* xyz, uint32_t* expected) {
+    if (line[0] == '#') {
+        unsigned long v;
+        if (sscanf(line, "# steps=%lu", &v) != 1) return PEDO_CSV_SKIP;
+        *expected = (uint32_t)v;
+        return PEDO_CSV_EXPECTED;
+    }
+    long c[4];
+    const int cols = sscanf(line, "%ld,%ld,%ld,%ld", &c[0], &c[1], &c[2], &c[3]);
+    if (cols < 3) return PEDO_CSV_SKIP;
+    const long* mg = cols == 4 ? &c[1] : &c[0];
+    for (int a = 0; a < 3; a++) {
+        long raw = mg[a] * lsb_per_g / 1000;
+        raw = raw > INT16_MAX ? INT16_MAX : raw < INT16_MIN ? INT16_MIN : raw;
+        xyz[a] = (int16_t)raw;
+    }
+    return PEDO_CSV_SAMPLE;
+}
+
+#endif
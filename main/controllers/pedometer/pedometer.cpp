@@ -0,0 +1,347 @@
+#include "pedometer.h"
+#include "pedo_csv.h"
+#include "controllers/db_manager/db_manager.h"
+#include "driver/i2c_master.h"
+#include "esp_check.h"
+#include "esp_cpu.h"
+#include "esp_log.h"
+#include "esp_private/esp_clk.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+static const char* TAG = "PEDOMETER";
+
+#define PEDO_TASK_STACK     3072
+#define PEDO_FIFO_MAX       32          // Profundidad de la FIFO del LIS3DH
+#define PEDO_REPLAY_BATCH   32
+
+// Snapshot empaquetado: pasos en los 24 bits bajos, cadencia en los 8 altos
+#define SNAP_STEPS_MASK     0x00FFFFFFu
+#define SNAP_CADENCE_SHIFT  24
+
+static const pedometer_source_t* source = nullptr;
+static TaskHandle_t pedo_task = nullptr;
+static step_detector_t detector;
+static std::atomic<uint32_t> snapshot{0};
+static std::atomic<bool> reset_requested{false};
+
+static pedometer_stats_t stats = {};
+static uint64_t process_cycles_total = 0;
+static portMUX_TYPE stats_mux = portMUX_INITIALIZER_UNLOCKED;
+
+// --- LIS3DH ---------------------------------------------------------------------
+
+#define LIS3DH_WHO_AM_I         0x0F
+#define LIS3DH_WHO_AM_I_VALUE   0x33
+#define LIS3DH_CTRL_REG1        0x20
+#define LIS3DH_CTRL_REG3        0x22
+#define LIS3DH_CTRL_REG4        0x23
+#define LIS3DH_CTRL_REG5        0x24
+#define LIS3DH_OUT_X_L          0x28
+#define LIS3DH_FIFO_CTRL_REG    0x2E
+#define LIS3DH_FIFO_SRC_REG     0x2F
+#define LIS3DH_AUTO_INCREMENT   0x80
+
+static i2c_master_bus_handle_t i2c_bus = nullptr;
+static i2c_master_dev_handle_t lis3dh = nullptr;
+
+static esp_err_t lis3dh_write(uint8_t reg, uint8_t value) {
+    const uint8_t buf[2] = { reg, value };
+    return i2c_master_transmit(lis3dh, buf, sizeof(buf), 50);
+}
+
+static esp_err_t lis3dh_read(uint8_t reg, void* dst, size_t len) {
+    if (len > 1) reg |= LIS3DH_AUTO_INCREMENT;
+    return i2c_master_transmit_receive(lis3dh, &reg, 1, (uint8_t*)dst, len, 50);
+}
+
+static esp_err_t lis3dh_init(uint16_t rate_hz, uint8_t watermark) {
+    i2c_master_bus_config_t bus_cfg = {};
+    bus_cfg.i2c_port = PEDO_I2C_PORT;
+    bus_cfg.sda_io_num = ACC_SDA;
+    bus_cfg.scl_io_num = ACC_SCL;
+    bus_cfg.clk_source = I2C_CLK_SRC_DEFAULT;
+    bus_cfg.glitch_ignore_cnt = 7;
+    bus_cfg.flags.enable_internal_pullup = true;
+    ESP_RETURN_ON_ERROR(i2c_new_master_bus(&bus_cfg, &i2c_bus), TAG, "i2c_new_master_bus");
+
+    i2c_device_config_t dev_cfg = {};
+    dev_cfg.dev_addr_length = I2C_ADDR_BIT_LEN_7;
+    dev_cfg.device_address = PEDO_I2C_ADDR;
+    dev_cfg.scl_speed_hz = 400000;
+    ESP_RETURN_ON_ERROR(i2c_master_bus_add_device(i2c_bus, &dev_cfg, &lis3dh), TAG, "i2c_master_bus_add_device");
+
+    uint8_t who = 0;
+    ESP_RETURN_ON_ERROR(lis3dh_read(LIS3DH_WHO_AM_I, &who, 1), TAG, "Sin respuesta en 0x%02x", PEDO_I2C_ADDR);
+    if (who != LIS3DH_WHO_AM_I_VALUE) {
+        ESP_LOGE(TAG, "WHO_AM_I 0x%02x", who);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    // ODR: el primero que alcanza rate_hz
+    static const uint16_t odr_hz[] = { 1, 10, 25, 50, 100, 200, 400 };
+    uint8_t odr = 7;
+    for (uint8_t i = 0; i < sizeof(odr_hz) / sizeof(odr_hz[0]); i++) {
+        if (odr_hz[i] >= rate_hz) {
+            odr = i + 1;
+            break;
+        }
+    }
+
+    // Modo normal (10 bits, ~11 µA a 50 Hz); el dato sale justificado a la izquierda,
+    // así que a ±4 g son 8192 cuentas por g en cualquier modo
+    ESP_RETURN_ON_ERROR(lis3dh_write(LIS3DH_CTRL_REG1, (uint8_t)(odr << 4 | 0x07)), TAG, "CTRL_REG1");
+    ESP_RETURN_ON_ERROR(lis3dh_write(LIS3DH_CTRL_REG4, 0x80 | 0x10), TAG, "CTRL_REG4");    // BDU, ±4 g
+    ESP_RETURN_ON_ERROR(lis3dh_write(LIS3DH_CTRL_REG5, 0x40), TAG, "CTRL_REG5");           // FIFO_EN
+    ESP_RETURN_ON_ERROR(lis3dh_write(LIS3DH_FIFO_CTRL_REG, (uint8_t)(0x80 | (watermark & 0x1F))), TAG, "FIFO_CTRL");   // Stream
+    ESP_RETURN_ON_ERROR(lis3dh_write(LIS3DH_CTRL_REG3, 0x04), TAG, "CTRL_REG3");           // Watermark en INT1
+    return ESP_OK;
+}
+
+static int lis3dh_read_fifo(int16_t* xyz, uint32_t max, bool* overrun) {
+    uint8_t src = 0;
+    if (lis3dh_read(LIS3DH_FIFO_SRC_REG, &src, 1) != ESP_OK) return -1;
+    *overrun = (src & 0x40) != 0;
+    uint32_t count = *overrun ? PEDO_FIFO_MAX : (src & 0x1F);
+    if (count > max) count = max;
+    if (count == 0) return 0;
+
+    // Con la FIFO activa la dirección vuelve de 0x2D a 0x28: una sola ráfaga
+    // trae todo el lote, y los int16 little-endian caen tal cual en 'xyz'
+    if (lis3dh_read(LIS3DH_OUT_X_L, xyz, count * 6) != ESP_OK) return -1;
+    return (int)count;
+}
+
+const pedometer_source_t pedometer_lis3dh_source = {
+    "lis3dh",
+    lis3dh_init,
+    lis3dh_read_fifo,
+    ACC_INT,
+};
+
+// --- Tarea ----------------------------------------------------------------------
+
+static void IRAM_ATTR pedo_int_isr(void* arg) {
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(pedo_task, &woken);
+    if (woken) portYIELD_FROM_ISR();
+}
+
+static void publish(uint32_t steps, uint16_t cadence) {
+    if (cadence > 255) cadence = 255;
+    snapshot.store((steps & SNAP_STEPS_MASK) | (uint32_t)cadence << SNAP_CADENCE_SHIFT, std::memory_order_release);
+}
+
+static void pedo_task_fn(void* arg) {
+    static int16_t batch[PEDO_FIFO_MAX * 3];
+    // Con interrupción se despierta al llegar al watermark; sin ella sondea al mismo ritmo
+    const TickType_t wait = pdMS_TO_TICKS((PEDO_FIFO_WATERMARK + 4) * 1000 / PEDO_SAMPLE_RATE);
+    uint32_t logged_steps = 0;
+    int64_t next_log_us = esp_timer_get_time() + (int64_t)PEDO_LOG_INTERVAL_S * 1000000;
+
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, wait);
+
+        if (reset_requested.exchange(false)) {
+            step_detector_reset(&detector);
+            logged_steps = 0;
+            publish(0, 0);
+        }
+
+        const int64_t t0 = esp_timer_get_time();
+        bool overrun = false;
+        const int n = source->read_fifo(batch, PEDO_FIFO_MAX, &overrun);
+        if (n > 0) {
+            // Un lote dura menos de un tick de esp_timer: se mide en ciclos
+            const uint32_t c0 = esp_cpu_get_cycle_count();
+            step_detector_process(&detector, batch, (uint32_t)n);
+            const uint32_t c1 = esp_cpu_get_cycle_count();
+            publish(detector.steps, step_detector_cadence(&detector));
+            const int64_t t2 = esp_timer_get_time();
+
+            taskENTER_CRITICAL(&stats_mux);
+            stats.samples += n;
+            stats.batches++;
+            process_cycles_total += c1 - c0;
+            if (overrun) stats.fifo_overruns++;
+            if (t2 - t0 > stats.batch_us_max) stats.batch_us_max = (uint32_t)(t2 - t0);
+            stats.rejected = detector.rejected;
+            taskEXIT_CRITICAL(&stats_mux);
+        } else if (n < 0) {
+            taskENTER_CRITICAL(&stats_mux);
+            stats.read_errors++;
+            taskEXIT_CRITICAL(&stats_mux);
+        }
+
+        // Historial por minuto: solo los pasos nuevos, y solo si los hay
+        if (t0 >= next_log_us) {
+            next_log_us += (int64_t)PEDO_LOG_INTERVAL_S * 1000000;
+            const uint32_t delta = detector.steps - logged_steps;
+            if (delta && db_manager_is_ready()) {
+                const uint16_t value = delta > UINT16_MAX ? UINT16_MAX : (uint16_t)delta;
+                db_log_sample(DB_SERIES_STEPS, (uint32_t)time(nullptr), &value, sizeof(value));
+            }
+            logged_steps = detector.steps;
+        }
+    }
+}
+
+esp_err_t pedometer_init() {
+    return pedometer_init_with_source(&pedometer_lis3dh_source);
+}
+
+esp_err_t pedometer_init_with_source(const pedometer_source_t* src) {
+    if (pedo_task) return ESP_OK;
+
+    esp_err_t err = src->init(PEDO_SAMPLE_RATE, PEDO_FIFO_WATERMARK);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Sin acelerómetro (%s): %s", src->name, esp_err_to_name(err));
+        return err;
+    }
+    source = src;
+    step_detector_init(&detector, PEDO_SAMPLE_RATE, PEDO_LSB_PER_G, PEDO_MIN_AMPLITUDE_MG, PEDO_CONFIRM_STEPS);
+
+    if (xTaskCreatePinnedToCore(pedo_task_fn, "pedo", PEDO_TASK_STACK, nullptr, PEDO_TASK_PRIORITY,
+                                &pedo_task, PEDO_TASK_CORE) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    if (src->int_pin != GPIO_NUM_NC) {
+        gpio_config_t io = {};
+        io.pin_bit_mask = 1ULL << src->int_pin;
+        io.mode = GPIO_MODE_INPUT;
+        io.intr_type = GPIO_INTR_POSEDGE;
+        gpio_config(&io);
+        err = gpio_install_isr_service(0);
+        if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) return err;   // Ya instalado por otro controller
+        gpio_isr_handler_add(src->int_pin, pedo_int_isr, nullptr);
+    }
+
+    ESP_LOGI(TAG, "%s a %d Hz, lotes de %d muestras", src->name, PEDO_SAMPLE_RATE, PEDO_FIFO_WATERMARK);
+    return ESP_OK;
+}
+
+bool pedometer_is_running() {
+    return pedo_task != nullptr;
+}
+
+void pedometer_get_snapshot(pedometer_snapshot_t* out) {
+    const uint32_t s = snapshot.load(std::memory_order_acquire);
+    out->steps = s & SNAP_STEPS_MASK;
+    out->cadence_spm = (uint8_t)(s >> SNAP_CADENCE_SHIFT);
+}
+
+void pedometer_reset_steps() {
+    reset_requested.store(true);
+    if (pedo_task) xTaskNotifyGive(pedo_task);
+}
+
+void pedometer_get_stats(pedometer_stats_t* out) {
+    taskENTER_CRITICAL(&stats_mux);
+    *out = stats;
+    const uint64_t cycles = process_cycles_total;
+    taskEXIT_CRITICAL(&stats_mux);
+    out->source = source ? source->name : "-";
+    out->ns_per_sample = out->samples ? (uint32_t)(cycles * 1000 / (esp_clk_cpu_freq() / 1000000) / out->samples) : 0;
+}
+
+// --- Replay y benchmark ---------------------------------------------------------
+
+// Pasa 'count' muestras por 'sd' y acumula los ciclos de proceso
+static void timed_process(step_detector_t* sd, const int16_t* xyz, uint32_t count, uint64_t* cycles) {
+    const uint32_t c0 = esp_cpu_get_cycle_count();
+    step_detector_process(sd, xyz, count);
+    *cycles += esp_cpu_get_cycle_count() - c0;
+}
+
+static void print_result(const char* tag, const char* name, const step_detector_t* sd,
+                         uint32_t expected, uint64_t cycles) {
+    const uint64_t ns = cycles * 1000 / (esp_clk_cpu_freq() / 1000000);
+    const int32_t err_x100 = expected ? (int32_t)(((int64_t)sd->steps - expected) * 10000 / expected) : 0;
+    const uint32_t ns_per_sample = sd->samples ? (uint32_t)(ns / sd->samples) : 0;
+    // Coste en tiempo real: ns por muestra × muestras por segundo, en milésimas de %
+    const uint32_t cpu_x1000 = (uint32_t)((uint64_t)ns_per_sample * PEDO_SAMPLE_RATE / 10000);
+    printf("%s,name,samples,steps,expected,error_pct_x100,rejected,ns_per_sample,cpu_pct_x1000\n", tag);
+    printf("%s,%s,%llu,%lu,%lu,%ld,%lu,%lu,%lu\n", tag, name, (unsigned long long)sd->samples,
+           (unsigned long)sd->steps, (unsigned long)expected, (long)err_x100, (unsigned long)sd->rejected,
+           (unsigned long)ns_per_sample, (unsigned long)cpu_x1000);
+}
+
+esp_err_t pedometer_replay_csv(const char* path, uint32_t expected) {
+    FILE* f = fopen(path, "r");
+    if (!f) return ESP_ERR_NOT_FOUND;
+
+    static step_detector_t sd;
+    step_detector_init(&sd, PEDO_SAMPLE_RATE, PEDO_LSB_PER_G, PEDO_MIN_AMPLITUDE_MG, PEDO_CONFIRM_STEPS);
+    static int16_t batch[PEDO_REPLAY_BATCH * 3];
+    uint32_t n = 0;
+    uint64_t cycles = 0;
+    char line[96];
+
+    // Mismos lotes que la FIFO; el parseo queda fuera de la medida
+    uint32_t in_file = 0;
+    while (fgets(line, sizeof(line), f)) {
+        if (pedo_csv_parse_line(line, PEDO_LSB_PER_G, &batch[n * 3], &in_file) != PEDO_CSV_SAMPLE) continue;
+        if (++n == PEDO_REPLAY_BATCH) {
+            timed_process(&sd, batch, n, &cycles);
+            n = 0;
+        }
+    }
+    if (n) timed_process(&sd, batch, n, &cycles);
+    fclose(f);
+    if (!expected) expected = in_file;
+
+    const char* name = strrchr(path, '/');
+    print_result("PEDOREPLAY", name ? name + 1 : path, &sd, expected, cycles);
+    return ESP_OK;
+}
+
+void pedometer_benchmark(uint32_t samples) {
+    static step_detector_t sd;
+    step_detector_init(&sd, PEDO_SAMPLE_RATE, PEDO_LSB_PER_G, PEDO_MIN_AMPLITUDE_MG, PEDO_CONFIRM_STEPS);
+    static int16_t batch[PEDO_FIFO_WATERMARK * 3];
+
+    // Gravedad repartida entre los tres ejes; tramos de 20 s andando y 10 s quieto con una sacudida
+    const double g = PEDO_LSB_PER_G;
+    const double gx = 0.48, gy = -0.36, gz = 0.80;
+    const double pi = 3.14159265358979323846;
+    const uint32_t walk = 20 * PEDO_SAMPLE_RATE;
+    const uint32_t idle = 10 * PEDO_SAMPLE_RATE;
+    const double step_hz = 1.8;
+    uint32_t expected = 0;
+    uint64_t cycles = 0;
+    uint32_t n = 0;
+    srand(1);
+
+    for (uint32_t i = 0; i < samples; i++) {
+        const uint32_t t = i % (walk + idle);
+        double a = 0.0;
+        if (t < walk) {
+            const double s = (double)t / PEDO_SAMPLE_RATE;
+            a = 0.3 * sin(2 * pi * step_hz * s) + 0.09 * sin(4 * pi * step_hz * s + 1.0);
+        } else if (t == walk + idle / 2) {
+            a = 0.6;
+        }
+        const double noise = ((rand() & 255) - 128) / 4096.0;
+        batch[n * 3 + 0] = (int16_t)lround((gx * (1 + a) + noise) * g);
+        batch[n * 3 + 1] = (int16_t)lround((gy * (1 + a) - noise) * g);
+        batch[n * 3 + 2] = (int16_t)lround((gz * (1 + a) + noise) * g);
+        if (++n == PEDO_FIFO_WATERMARK) {
+            timed_process(&sd, batch, n, &cycles);
+            n = 0;
+        }
+        if (t == walk - 1) {
+            expected += (uint32_t)(step_hz * walk / PEDO_SAMPLE_RATE);
+        }
+    }
+    if (n) timed_process(&sd, batch, n, &cycles);
+
+    print_result("PEDOBENCH", "synthetic", &sd, expected, cycles);
+}
@@ -0,0 +1,63 @@
+#ifndef PEDOMETER_H
+#define PEDOMETER_H
+
+#include "esp_err.h"
+#include "driver/gpio.h"
+#include "config.h"
+#include "step_detector.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Podómetro siempre activo. El acelerómetro acumula muestras en su FIFO y
+// avisa por interrupción al llegar a PEDO_FIFO_WATERMARK; la tarea 'pedo'
+// (núcleo PEDO_TASK_CORE, no el de render) lee el lote de una vez, lo pasa por
+// step_detector y publica el resultado en un único uint32_t atómico. La UI lo
+// lee con una carga, sin locks. Cada PEDO_LOG_INTERVAL_S los pasos nuevos se
+// guardan en db_manager (serie DB_SERIES_STEPS).
+
+// Origen de las muestras. La FIFO entrega x,y,z int16 a PEDO_LSB_PER_G.
+typedef struct {
+    const char* name;
+    esp_err_t (*init)(uint16_t rate_hz, uint8_t watermark);
+    // Vacía la FIFO en 'xyz' (hasta 'max' muestras). Devuelve cuántas o < 0.
+    // '*overrun' indica que la FIFO se llenó y se perdieron muestras.
+    int (*read_fifo)(int16_t* xyz, uint32_t max, bool* overrun);
+    gpio_num_t int_pin;         // Interrupción de watermark (GPIO_NUM_NC = sondeo)
+} pedometer_source_t;
+
+extern const pedometer_source_t pedometer_lis3dh_source;
+
+typedef struct {
+    uint32_t steps;             // Desde el arranque o el último pedometer_reset_steps
+    uint8_t cadence_spm;        // Pasos por minuto, 0 = parado (satura en 255)
+} pedometer_snapshot_t;
+
+typedef struct {
+    const char* source;
+    uint64_t samples;
+    uint32_t batches;
+    uint32_t fifo_overruns;
+    uint32_t read_errors;
+    uint32_t rejected;          // Candidatos que no llegaron a paso
+    uint32_t ns_per_sample;     // Coste medio de step_detector_process
+    uint32_t batch_us_max;      // Lectura I2C + procesado del peor lote
+} pedometer_stats_t;
+
+esp_err_t pedometer_init();
+esp_err_t pedometer_init_with_source(const pedometer_source_t* source);
+bool pedometer_is_running();
+
+// Una carga atómica: se puede llamar desde cualquier tarea en cada frame
+void pedometer_get_snapshot(pedometer_snapshot_t* out);
+void pedometer_reset_steps();
+void pedometer_get_stats(pedometer_stats_t* out);
+
+// Reproduce una traza CSV por un detector aparte (no toca el recuento en vivo).
+// Cada línea: "x,y,z" o "t,x,y,z", en mg. "# steps=N" en el fichero da el valor
+// esperado si 'expected' es 0. Imprime una línea PEDOREPLAY con precisión y ns/muestra.
+esp_err_t pedometer_replay_csv(const char* path, uint32_t expected);
+
+// Marcha sintética con gravedad en un eje cualquiera, sacudidas y ruido
+void pedometer_benchmark(uint32_t samples);
+
+#endif
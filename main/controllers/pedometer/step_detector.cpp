@@ -0,0 +1,141 @@
+#include "step_detector.h"
+
+#define GRAVITY_SHIFT       6       // τ = 64 muestras (1,3 s a 50 Hz)
+#define LOWPASS_SHIFT       2
+#define MIN_STEP_HZ_X10     5       // 0,5 pasos/s: por debajo se rompe la racha
+#define MAX_STEP_HZ         4       // 240 pasos/min
+
+static inline int32_t iabs(int32_t v) {
+    const int32_t m = v >> 31;
+    return (v ^ m) - m;
+}
+
+static inline int32_t imin(int32_t a, int32_t b) { return a < b ? a : b; }
+static inline int32_t imax(int32_t a, int32_t b) { return a > b ? a : b; }
+
+void step_detector_init(step_detector_t* sd, uint16_t rate_hz, uint16_t lsb_per_g,
+                        uint16_t min_amplitude_mg, uint8_t confirm_steps) {
+    sd->rate_hz = rate_hz;
+    sd->lsb_per_g = lsb_per_g;
+    sd->confirm_steps = confirm_steps ? confirm_steps : 1;
+    sd->min_interval = rate_hz / MAX_STEP_HZ;
+    sd->max_interval = rate_hz * 10 / MIN_STEP_HZ_X10;
+    sd->min_amplitude = (int32_t)min_amplitude_mg * lsb_per_g / 1000;
+    step_detector_reset(sd);
+}
+
+void step_detector_reset(step_detector_t* sd) {
+    sd->gravity_q6 = (int32_t)sd->lsb_per_g << GRAVITY_SHIFT;
+    sd->lp = 0;
+    sd->peak = 0;
+    sd->valley = 0;
+    sd->avg_amplitude = sd->min_amplitude * 2;
+    sd->rising = true;
+    sd->walking = false;
+    sd->pending = 0;
+    sd->since_step = 0;
+    sd->since_turn = 0;
+    sd->interval_avg_q4 = 0;
+    sd->steps = 0;
+    sd->samples = 0;
+    sd->rejected = 0;
+}
+
+// Valle tras un pico: decide si es un paso
+static inline uint32_t on_valley(step_detector_t* sd) {
+    const int32_t amplitude = sd->peak - sd->valley;
+    if (amplitude < sd->min_amplitude || sd->since_step < sd->min_interval) {
+        sd->rejected++;
+        return 0;
+    }
+    sd->avg_amplitude += (amplitude - sd->avg_amplitude) >> 2;
+
+    const uint32_t interval = sd->since_step;
+    sd->since_step = 0;
+    if (interval > sd->max_interval) {
+        // Racha rota: este paso empieza una nueva
+        if (sd->pending) sd->rejected += sd->pending;
+        sd->walking = false;
+        sd->pending = 0;
+        sd->interval_avg_q4 = 0;
+    } else {
+        const int32_t interval_q4 = (int32_t)(interval << 4);
+        sd->interval_avg_q4 += sd->interval_avg_q4 ? (interval_q4 - sd->interval_avg_q4) >> 2 : interval_q4;
+    }
+
+    if (sd->walking) {
+        sd->steps++;
+        return 1;
+    }
+    if (++sd->pending >= sd->confirm_steps) {
+        const uint32_t added = sd->pending;
+        sd->steps += added;
+        sd->pending = 0;
+        sd->walking = true;
+        return added;
+    }
+    return 0;
+}
+
+uint32_t step_detector_process(step_detector_t* sd, const int16_t* xyz, uint32_t count) {
+    uint32_t added = 0;
+    int32_t gravity_q6 = sd->gravity_q6;
+    int32_t lp = sd->lp;
+
+    for (uint32_t i = 0; i < count; i++, xyz += 3) {
+        // 1-3: sin saltos
+        const int32_t ax = iabs(xyz[0]);
+        const int32_t ay = iabs(xyz[1]);
+        const int32_t az = iabs(xyz[2]);
+        const int32_t hi = imax(ax, imax(ay, az));
+        const int32_t lo = imin(ax, imin(ay, az));
+        const int32_t mid = ax + ay + az - hi - lo;
+        const int32_t mag = hi + (((mid + lo) * 11) >> 5);
+
+        gravity_q6 += ((mag << GRAVITY_SHIFT) - gravity_q6) >> GRAVITY_SHIFT;
+        const int32_t ac = mag - (gravity_q6 >> GRAVITY_SHIFT);
+        lp += (ac - lp) >> LOWPASS_SHIFT;
+        sd->since_step++;
+        if (++sd->since_turn > sd->max_interval / 2) {
+            sd->rising = true;
+            sd->peak = lp;
+            sd->since_turn = 0;
+        }
+
+        // 4: histéresis de un cuarto de la amplitud típica, nunca menos de la mitad del mínimo
+        const int32_t hyst = imax(sd->min_amplitude >> 1, sd->avg_amplitude >> 2);
+        if (sd->rising) {
+            sd->peak = imax(sd->peak, lp);
+            if (lp < sd->peak - hyst) {
+                sd->rising = false;
+                sd->valley = lp;
+                sd->since_turn = 0;
+            }
+        } else {
+            sd->valley = imin(sd->valley, lp);
+            if (lp > sd->valley + hyst) {
+                added += on_valley(sd);
+                sd->rising = true;
+                sd->peak = lp;
+                sd->since_turn = 0;
+            }
+        }
+    }
+
+    // La racha también se rompe sin más pasos: lo pendiente se descarta
+    if (sd->since_step > sd->max_interval && (sd->walking || sd->pending)) {
+        sd->rejected += sd->pending;
+        sd->pending = 0;
+        sd->walking = false;
+    }
+
+    sd->gravity_q6 = gravity_q6;
+    sd->lp = lp;
+    sd->samples += count;
+    return added;
+}
+
+uint16_t step_detector_cadence(const step_detector_t* sd) {
+    if (!sd->walking || !sd->interval_avg_q4 || sd->since_step > sd->max_interval) return 0;
+    return (uint16_t)((60u * sd->rate_hz << 4) / sd->interval_avg_q4);
+}
@@ -0,0 +1,58 @@
+#ifndef STEP_DETECTOR_H
+#define STEP_DETECTOR_H
+
+// Detector de pasos en punto fijo, sin dependencias de ESP-IDF: procesa lotes
+// de muestras x,y,z (int16, PEDO_LSB_PER_G cuentas por g) tal como salen de la
+// FIFO del acelerómetro.
+//
+// Por muestra:
+//   1. Módulo aproximado sin raíz: max + 11/32·(medio + mínimo), con abs/min/max
+//      sin saltos (Xtensa tiene MIN/MAX).
+//   2. Gravedad: media exponencial lenta del módulo (τ ≈ 64 muestras); se resta.
+//   3. Paso bajo de un polo (>> 2) para quitar el ruido del andar.
+//   4. Pico y valle con histéresis adaptativa. Un valle tras un pico cuenta como
+//      paso si la amplitud pico-valle y el intervalo desde el anterior son de andar.
+//      Un extremo de hace más de medio paso lento se olvida: una sacudida suelta
+//      no se empareja con el primer valle de la siguiente racha.
+//   5. Regularidad: los primeros pasos de una racha quedan pendientes hasta
+//      juntar 'confirm_steps' seguidos; así sacudidas sueltas no cuentan.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct {
+    uint16_t rate_hz;
+    uint16_t lsb_per_g;
+    uint8_t confirm_steps;
+    uint32_t min_interval;      // Muestras entre pasos (cadencia máxima)
+    uint32_t max_interval;      // Más que esto rompe la racha
+    int32_t min_amplitude;      // Pico-valle mínimo, en cuentas
+
+    int32_t gravity_q6;         // Módulo medio << 6
+    int32_t lp;                 // Señal sin gravedad, filtrada
+    int32_t peak;
+    int32_t valley;
+    int32_t avg_amplitude;      // Media de las amplitudes aceptadas
+    bool rising;                // Buscando pico (true) o valle (false)
+    bool walking;               // Racha confirmada: cada paso cuenta ya
+    uint8_t pending;
+    uint32_t since_step;
+    uint32_t since_turn;        // Muestras desde el último pico o valle
+    int32_t interval_avg_q4;    // Muestras entre pasos << 4, para la cadencia
+
+    uint32_t steps;
+    uint64_t samples;
+    uint32_t rejected;          // Candidatos descartados (amplitud, cadencia o racha rota)
+} step_detector_t;
+
+void step_detector_init(step_detector_t* sd, uint16_t rate_hz, uint16_t lsb_per_g,
+                        uint16_t min_amplitude_mg, uint8_t confirm_steps);
+void step_detector_reset(step_detector_t* sd);
+
+// 'count' muestras de 'xyz' (x0,y0,z0,x1,...). Devuelve los pasos añadidos a sd->steps.
+uint32_t step_detector_process(step_detector_t* sd, const int16_t* xyz, uint32_t count);
+
+// Pasos por minuto (0 si no se anda)
+uint16_t step_detector_cadence(const step_detector_t* sd);
+
+#endif
@@ -0,0 +1,123 @@
+#include "controllers/screen_manager/nav_snapshot.h"
+#include "config.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+static const char* TAG = "NAV_SNAPSHOT";
+
+#define NAV_SNAPSHOT_SLOTS 8
+
+typedef struct {
+    lv_draw_buf_t buf;
+    void* data;             // PSRAM
+    size_t bytes;
+    uint32_t last_used;
+} nav_snapshot_t;
+
+static nav_snapshot_t snapshots[NAV_SNAPSHOT_SLOTS] = {};
+static size_t snapshot_budget = NAV_SNAPSHOT_BUDGET_BYTES;
+static uint32_t use_counter = 0;
+static int pinned_slot = -1;
+static nav_snapshot_stats_t stats = {};
+
+static size_t snapshot_bytes() {
+    size_t total = 0;
+    for (int i = 0; i < NAV_SNAPSHOT_SLOTS; i++) {
+        if (snapshots[i].data) total += snapshots[i].bytes;
+    }
+    return total;
+}
+
+// Libera los snapshots menos usados hasta dejar sitio para 'needed' bytes
+static void snapshot_evict(size_t needed, int keep) {
+    while (snapshot_bytes() + needed > snapshot_budget) {
+        int victim = -1;
+        for (int i = 0; i < NAV_SNAPSHOT_SLOTS; i++) {
+            if (!snapshots[i].data || i == keep || i == pinned_slot) continue;
+            if (victim < 0 || snapshots[i].last_used < snapshots[victim].last_used) {
+                victim = i;
+            }
+        }
+        if (victim < 0) break;
+
+        nav_snapshot_drop(victim);
+        stats.evictions++;
+    }
+}
+
+bool nav_snapshot_capture(uint32_t slot, lv_obj_t* screen) {
+    if (slot >= NAV_SNAPSHOT_SLOTS || !screen) return false;
+
+    const int64_t t_start = esp_timer_get_time();
+    const uint32_t w = lv_obj_get_width(screen);
+    const uint32_t h = lv_obj_get_height(screen);
+    const uint32_t stride = lv_draw_buf_width_to_stride(w, LV_COLOR_FORMAT_RGB565);
+    const size_t size = stride * h;
+
+    nav_snapshot_t& snap = snapshots[slot];
+    if (snap.data && snap.bytes != size) {
+        nav_snapshot_drop(slot);
+    }
+    if (!snap.data) {
+        snapshot_evict(size, slot);
+        if (snapshot_bytes() + size > snapshot_budget) {
+            ESP_LOGW(TAG, "Snapshot de %u bytes no cabe en el presupuesto", (unsigned)size);
+            return false;
+        }
+        snap.data = heap_caps_malloc(size, MALLOC_CAP_SPIRAM);
+        if (!snap.data) {
+            ESP_LOGE(TAG, "Sin PSRAM para el snapshot (%u bytes)", (unsigned)size);
+            return false;
+        }
+        snap.bytes = size;
+    }
+
+    lv_draw_buf_init(&snap.buf, w, h, LV_COLOR_FORMAT_RGB565, stride, snap.data, size);
+    if (lv_snapshot_take_to_draw_buf(screen, LV_COLOR_FORMAT_RGB565, &snap.buf) != LV_RESULT_OK) {
+        ESP_LOGE(TAG, "Fallo al capturar el snapshot %lu", (unsigned long)slot);
+        nav_snapshot_drop(slot);
+        return false;
+    }
+    snap.last_used = ++use_counter;
+
+    stats.captures++;
+    stats.last_capture_us = (uint32_t)(esp_timer_get_time() - t_start);
+    return true;
+}
+
+const lv_draw_buf_t* nav_snapshot_get(uint32_t slot) {
+    if (slot >= NAV_SNAPSHOT_SLOTS || !snapshots[slot].data) return nullptr;
+
+    snapshots[slot].last_used = ++use_counter;
+    stats.hits++;
+    return &snapshots[slot].buf;
+}
+
+void nav_snapshot_pin(int slot) {
+    pinned_slot = slot;
+}
+
+void nav_snapshot_drop(uint32_t slot) {
+    if (slot >= NAV_SNAPSHOT_SLOTS || !snapshots[slot].data) return;
+
+    heap_caps_free(snapshots[slot].data);
+    snapshots[slot] = {};
+}
+
+void nav_snapshot_set_budget(size_t bytes) {
+    snapshot_budget = bytes;
+    snapshot_evict(0, -1);
+}
+
+void nav_snapshot_get_stats(nav_snapshot_stats_t* out) {
+    if (!out) return;
+
+    *out = stats;
+    out->count = 0;
+    for (int i = 0; i < NAV_SNAPSHOT_SLOTS; i++) {
+        if (snapshots[i].data) out->count++;
+    }
+    out->bytes = snapshot_bytes();
+    out->budget = snapshot_budget;
+}
@@ -0,0 +1,32 @@
+#ifndef NAV_SNAPSHOT_H
+#define NAV_SNAPSHOT_H
+
+#include "lvgl.h"
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct {
+    uint32_t count;         // Snapshots guardados ahora
+    size_t bytes;           // PSRAM ocupada por los snapshots
+    size_t budget;
+    uint32_t captures;
+    uint32_t hits;          // Navegaciones que mostraron un snapshot
+    uint32_t evictions;
+    uint32_t last_capture_us;
+} nav_snapshot_stats_t;
+
+// Guarda en PSRAM una imagen RGB565 de 'screen' asociada a 'slot'.
+// Si no cabe en el presupuesto se expulsan los snapshots menos usados.
+bool nav_snapshot_capture(uint32_t slot, lv_obj_t* screen);
+
+// Devuelve el snapshot de 'slot' o nullptr. Se puede usar como fuente de lv_image.
+const lv_draw_buf_t* nav_snapshot_get(uint32_t slot);
+
+// Marca el snapshot que se está mostrando para que no se expulse (-1 = ninguno)
+void nav_snapshot_pin(int slot);
+
+void nav_snapshot_drop(uint32_t slot);
+void nav_snapshot_set_budget(size_t bytes);
+void nav_snapshot_get_stats(nav_snapshot_stats_t* out);
+
+#endif
@@ -0,0 +1,307 @@
+// Camino de flush asíncrono: buffers de render, trozos por DMA, bounce buffers,
+// ISR de fin de transferencia y contadores de stall/solape. Solo habla con el
+// panel a través de esp_lcd (draw_bitmap y el callback de fin de color), así
+// que el build de host lo enlaza tal cual sobre un panel simulado.
+
+#include "controllers/screen_manager/screen_manager.h"
+#include "config.h"
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "freertos/task.h"
+#include "controllers/display_profiler/display_profiler.h"
+#include "controllers/draw_accel/draw_accel.h"
+#include <cassert>
+#include <cstring>
+
+static const char* TAG = "SCREEN_MGR";
+
+// Tiempo máximo esperando un fin de DMA antes de volver a comprobar el estado
+#define SCREEN_FLUSH_WAIT_TIMEOUT_MS 100
+
+static const char* const render_mode_names[] = { "partial", "psram-direct", "psram-bounce" };
+
+// ISR de fin de transferencia de color. Un flush puede ir en varios trozos
+// (modos PSRAM); cada trozo terminado libera su bounce buffer y solo el último
+// devuelve el buffer a LVGL. Es el único punto que señala lv_display_flush_ready.
+static bool screen_color_trans_done(esp_lcd_panel_io_handle_t io, esp_lcd_panel_io_event_data_t* edata, void* user_ctx) {
+    screen_t* s = (screen_t*)user_ctx;
+    BaseType_t high_task_woken = pdFALSE;
+
+    const uint32_t done = ++s->chunks_done;
+    if (s->render_cfg.mode == SCREEN_RENDER_PSRAM_BOUNCE) {
+        xSemaphoreGiveFromISR(s->bounce_free_sem, &high_task_woken);
+    }
+    if (done != s->last_chunk_seq) {
+        return high_task_woken == pdTRUE;
+    }
+
+    const uint32_t transfer_us = (uint32_t)(esp_timer_get_time() - s->flush_start_us);
+    s->flush_stats.transfer_us += transfer_us;
+    DISPLAY_PROFILER_TRANSFER_DONE(transfer_us);
+    if (s->last_chunk_ends_frame) {
+        s->frames_flushed++;
+    }
+    s->flush_pending = false;
+    if (s->flush_releases_lvgl) {
+        lv_display_flush_ready(s->lvgl_disp);
+    }
+
+    xSemaphoreGiveFromISR(s->flush_done_sem, &high_task_woken);
+    return high_task_woken == pdTRUE;
+}
+
+// Encola un trozo por DMA. El ISR lo contará en chunks_done al terminar.
+static bool screen_send_chunk(screen_t* s, int x1, int y1, int x2, int y2, const void* data) {
+    s->chunks_issued++;
+    esp_err_t err = esp_lcd_panel_draw_bitmap(s->panel_handle, x1, y1, x2, y2, data);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "draw_bitmap failed: %s", esp_err_to_name(err));
+        s->chunks_issued--;
+        return false;
+    }
+    s->flush_stats.flushed_bytes += (x2 - x1) * (y2 - y1) * SCREEN_BYTES_PER_PIXEL;
+    return true;
+}
+
+// Frame completo en PSRAM (modo DIRECT): el área no es contigua en memoria, así
+// que se envían bandas de ancho completo de bounce_lines filas. El driver SPI
+// copia cada banda a RAM interna DMA antes de transmitirla.
+static bool screen_flush_direct(screen_t* s, const lv_area_t* area, uint8_t* px_map) {
+    const int32_t lines = s->render_cfg.bounce_lines;
+    const size_t stride = SCREEN_WIDTH * SCREEN_BYTES_PER_PIXEL;
+
+    s->last_chunk_seq = s->chunks_issued + (lv_area_get_height(area) + lines - 1) / lines;
+    for (int32_t y = area->y1; y <= area->y2; y += lines) {
+        const int32_t y_end = LV_MIN(y + lines, area->y2 + 1);
+        if (!screen_send_chunk(s, 0, y, SCREEN_WIDTH, y_end, px_map + y * stride)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Frame en PSRAM + bounce buffers internos: las filas del área se copian al
+// bounce libre mientras el otro está en el bus. Solo viaja el rectángulo sucio.
+static bool screen_flush_bounce(screen_t* s, const lv_area_t* area, uint8_t* px_map) {
+    const int32_t width = lv_area_get_width(area);
+    const int32_t rows = lv_area_get_height(area);
+    const size_t row_bytes = width * SCREEN_BYTES_PER_PIXEL;
+    const size_t stride = SCREEN_WIDTH * SCREEN_BYTES_PER_PIXEL;
+
+    // Un área estrecha cabe en más filas por bounce
+    const int32_t lines = LV_MIN((int32_t)(SCREEN_WIDTH * s->render_cfg.bounce_lines) / width, rows);
+    const uint8_t* src = px_map + area->y1 * stride + area->x1 * SCREEN_BYTES_PER_PIXEL;
+
+    s->last_chunk_seq = s->chunks_issued + (rows + lines - 1) / lines;
+    for (int32_t y = area->y1; y <= area->y2; y += lines) {
+        const int32_t count = LV_MIN(lines, area->y2 + 1 - y);
+
+        const int64_t t_wait = esp_timer_get_time();
+        xSemaphoreTake(s->bounce_free_sem, portMAX_DELAY);
+        s->bounce_wait_us += esp_timer_get_time() - t_wait;
+        uint8_t* dst = s->bounce_buf[s->bounce_next];
+        s->bounce_next ^= 1;
+        for (int32_t r = 0; r < count; r++) {
+#if SCREEN_RGB565_SWAP
+            draw_accel_swap_copy_rgb565((uint16_t*)(dst + r * row_bytes), (const uint16_t*)src, width);
+#else
+            memcpy(dst + r * row_bytes, src, row_bytes);
+#endif
+            src += stride;
+        }
+
+        if (!screen_send_chunk(s, area->x1, y, area->x2 + 1, y + count, dst)) {
+            xSemaphoreGive(s->bounce_free_sem);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Un trozo falló: se espera a los ya encolados y se devuelve el buffer a LVGL a mano
+static void screen_flush_abort(screen_t* s) {
+    while (s->chunks_done != s->chunks_issued) {
+        vTaskDelay(1);
+    }
+    s->last_chunk_seq = s->chunks_issued;
+    s->flush_pending = false;
+    if (s->flush_releases_lvgl) {
+        lv_display_flush_ready(s->lvgl_disp);
+    }
+    xSemaphoreGive(s->flush_done_sem);
+}
+
+static void screen_flush_begin(screen_t* s, const lv_area_t* area, bool frame_end, bool releases_lvgl) {
+    xSemaphoreTake(s->flush_done_sem, 0); // Descarta un aviso antiguo ya consumido por LVGL
+    s->flush_releases_lvgl = releases_lvgl;
+    s->flush_pending = true;
+    s->flush_start_us = esp_timer_get_time();
+    s->last_chunk_ends_frame = frame_end;
+    s->flush_stats.flush_count++;
+    DISPLAY_PROFILER_FLUSH(area);
+}
+
+// Lanza el área por DMA y vuelve sin esperar al último trozo: LVGL puede
+// renderizar en el otro buffer mientras este se transmite.
+void screen_flush_area(screen_t* s, const lv_area_t* area, uint8_t* px_map, bool frame_end) {
+    screen_flush_begin(s, area, frame_end, true);
+
+    bool ok;
+    switch (s->render_cfg.mode) {
+        case SCREEN_RENDER_FULL_PSRAM_DIRECT:
+            ok = screen_flush_direct(s, area, px_map);
+            break;
+        case SCREEN_RENDER_PSRAM_BOUNCE:
+            ok = screen_flush_bounce(s, area, px_map);
+            break;
+        default:
+#if SCREEN_RGB565_SWAP
+            draw_accel_swap_rgb565((uint16_t*)px_map, lv_area_get_size(area));
+#endif
+            s->last_chunk_seq = s->chunks_issued + 1;
+            ok = screen_send_chunk(s, area->x1, area->y1, area->x2 + 1, area->y2 + 1, px_map);
+            break;
+    }
+
+    if (!ok) {
+        screen_flush_abort(s);
+    }
+}
+
+void screen_flush_buffer(screen_t* s, const lv_area_t* area, uint8_t* buf, bool frame_end) {
+    screen_flush_begin(s, area, frame_end, false);
+    s->last_chunk_seq = s->chunks_issued + 1;
+    if (!screen_send_chunk(s, area->x1, area->y1, area->x2 + 1, area->y2 + 1, buf)) {
+        screen_flush_abort(s);
+    }
+}
+
+void screen_flush_wait(screen_t* s) {
+    while (s->flush_pending) {
+        xSemaphoreTake(s->flush_done_sem, pdMS_TO_TICKS(SCREEN_FLUSH_WAIT_TIMEOUT_MS));
+    }
+}
+
+void screen_flush_wait_stall(screen_t* s) {
+    const int64_t t_start = esp_timer_get_time();
+    screen_flush_wait(s);
+    const uint32_t stall = (uint32_t)(esp_timer_get_time() - t_start);
+
+    s->flush_stats.stall_us += stall;
+    if (stall > s->flush_stats.max_stall_us) {
+        s->flush_stats.max_stall_us = stall;
+    }
+}
+
+static void screen_flush_cb(lv_display_t* disp, const lv_area_t* area, uint8_t* px_map) {
+    screen_flush_area((screen_t*)lv_display_get_user_data(disp), area, px_map, lv_display_flush_is_last(disp));
+}
+
+// Sin panel: LVGL renderiza igual pero el buffer se libera al momento
+static void screen_headless_flush_cb(lv_display_t* disp, const lv_area_t* area, uint8_t* px_map) {
+    lv_display_flush_ready(disp);
+}
+
+// LVGL llama a esta función cuando necesita el buffer que aún se está enviando.
+// Bloquea en el semáforo (sin busy-wait) y contabiliza el tiempo perdido.
+static void screen_flush_wait_cb(lv_display_t* disp) {
+    screen_flush_wait_stall((screen_t*)lv_display_get_user_data(disp));
+}
+
+// Reserva los buffers de la estrategia elegida. Si la PSRAM no alcanza se vuelve
+// a strips internos del alto de un bounce (el bus ya está dimensionado para ello).
+static lv_display_render_mode_t screen_alloc_render_buffers(screen_t* screen, uint32_t* buf_size) {
+    screen_render_config_t& cfg = screen->render_cfg;
+    const size_t line_bytes = SCREEN_WIDTH * SCREEN_BYTES_PER_PIXEL;
+
+    if (cfg.mode != SCREEN_RENDER_PARTIAL) {
+        const size_t frame_bytes = line_bytes * SCREEN_HEIGHT;
+        const size_t bounce_bytes = line_bytes * cfg.bounce_lines;
+
+        screen->lvgl_buf1 = (lv_color_t*)heap_caps_malloc(frame_bytes, MALLOC_CAP_SPIRAM);
+        screen->lvgl_buf2 = (lv_color_t*)heap_caps_malloc(frame_bytes, MALLOC_CAP_SPIRAM);
+        if (cfg.mode == SCREEN_RENDER_PSRAM_BOUNCE) {
+            screen->bounce_buf[0] = (uint8_t*)heap_caps_malloc(bounce_bytes, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+            screen->bounce_buf[1] = (uint8_t*)heap_caps_malloc(bounce_bytes, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+            screen->bounce_free_sem = xSemaphoreCreateCounting(2, 2);
+        }
+
+        const bool bounce_ok = cfg.mode != SCREEN_RENDER_PSRAM_BOUNCE ||
+                               (screen->bounce_buf[0] && screen->bounce_buf[1] && screen->bounce_free_sem);
+        if (screen->lvgl_buf1 && screen->lvgl_buf2 && bounce_ok) {
+            screen->psram_bytes = 2 * frame_bytes;
+            // En DIRECT el driver SPI copia cada banda a un buffer interno temporal
+            screen->internal_ram_bytes = cfg.mode == SCREEN_RENDER_PSRAM_BOUNCE ? 2 * bounce_bytes : bounce_bytes;
+            *buf_size = frame_bytes;
+            return LV_DISPLAY_RENDER_MODE_DIRECT;
+        }
+
+        ESP_LOGW(TAG, "Sin memoria para el modo %s, uso strips de %u líneas",
+                 render_mode_names[cfg.mode], cfg.bounce_lines);
+        heap_caps_free(screen->lvgl_buf1);
+        heap_caps_free(screen->lvgl_buf2);
+        heap_caps_free(screen->bounce_buf[0]);
+        heap_caps_free(screen->bounce_buf[1]);
+        if (screen->bounce_free_sem) vSemaphoreDelete(screen->bounce_free_sem);
+        screen->bounce_buf[0] = screen->bounce_buf[1] = nullptr;
+        screen->bounce_free_sem = nullptr;
+        cfg.mode = SCREEN_RENDER_PARTIAL;
+        cfg.strip_lines = cfg.bounce_lines;
+    }
+
+    const size_t strip_bytes = line_bytes * cfg.strip_lines;
+    screen->lvgl_buf1 = (lv_color_t*)heap_caps_malloc(strip_bytes, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    screen->lvgl_buf2 = (lv_color_t*)heap_caps_malloc(strip_bytes, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    assert(screen->lvgl_buf1 && screen->lvgl_buf2);
+    screen->internal_ram_bytes = 2 * strip_bytes;
+    screen->psram_bytes = 0;
+    *buf_size = strip_bytes;
+    return LV_DISPLAY_RENDER_MODE_PARTIAL;
+}
+
+void screen_flush_setup(screen_t* screen) {
+    // El heap de LVGL lo gestiona mem_manager (lv_mem_init ya se llamó en lv_init);
+    // los buffers de render son aparte, en RAM DMA o PSRAM según el modo.
+    uint32_t buf_size = 0;
+    const lv_display_render_mode_t lv_mode = screen_alloc_render_buffers(screen, &buf_size);
+    ESP_LOGI(TAG, "Render %s: %u B RAM interna, %u B PSRAM",
+             render_mode_names[screen->render_cfg.mode],
+             (unsigned)screen->internal_ram_bytes, (unsigned)screen->psram_bytes);
+
+    screen->flush_done_sem = xSemaphoreCreateBinary();
+    assert(screen->flush_done_sem);
+
+    screen->lvgl_disp = lv_display_create(SCREEN_WIDTH, SCREEN_HEIGHT);
+    lv_display_set_user_data(screen->lvgl_disp, screen);
+    lv_display_set_buffers(screen->lvgl_disp, screen->lvgl_buf1, screen->lvgl_buf2, buf_size, lv_mode);
+
+    // Callbacks de refresco: el flush solo encola el DMA, el fin de transferencia
+    // libera el buffer y la espera se hace sobre el semáforo.
+    lv_display_set_flush_cb(screen->lvgl_disp, screen_flush_cb);
+    lv_display_set_flush_wait_cb(screen->lvgl_disp, screen_flush_wait_cb);
+
+    const esp_lcd_panel_io_callbacks_t io_callbacks = {
+        .on_color_trans_done = screen_color_trans_done,
+    };
+    ESP_ERROR_CHECK(esp_lcd_panel_io_register_event_callbacks(screen->io_handle, &io_callbacks, screen));
+}
+
+void screen_set_headless(screen_t* screen, bool headless) {
+    if (!screen || !screen->lvgl_disp) return;
+    screen_flush_wait(screen);
+    lv_display_set_flush_cb(screen->lvgl_disp, headless ? screen_headless_flush_cb : screen_flush_cb);
+}
+
+void screen_get_flush_stats(const screen_t* screen, screen_flush_stats_t* out) {
+    if (!screen || !out) return;
+
+    *out = screen->flush_stats;
+    out->overlap_us = out->transfer_us > out->stall_us ? out->transfer_us - out->stall_us : 0;
+}
+
+void screen_reset_flush_stats(screen_t* screen) {
+    if (!screen) return;
+    screen->flush_stats = {};
+}
@@ -6,48 +6,40 @@
 #include "driver/spi_master.h"
 #include "esp_check.h"
 #include "esp_timer.h"
-#include <vector>
-#include <cstring>
-#include "views/apps/clock/clock_view.h"
-#include "views/system/boot_screen/boot_view.h"
-#include "views/system/settings/settings_view.h"
-#include "views/system/system_info/system_info_view.h"
+#include "esp_heap_caps.h"
+#include "controllers/display_profiler/display_profiler.h"
+#include "controllers/draw_accel/draw_accel.h"
 
 static const char* TAG = "SCREEN_MGR";
 
-static esp_timer_handle_t lv_tick_timer = nullptr;
-static BaseView* current_view = nullptr; //  Para gestionar la vista actual
+// Lo que el tick de LVGL va por delante del reloj real tras un reloj alternativo
+static uint32_t tick_offset_ms = 0;
 
-static void screen_init_lvgl_tick() {
-    const esp_timer_create_args_t lv_tick_timer_args = {
-        .callback = [](void* arg) { lv_tick_inc(1); },
-        .arg = nullptr,
-        .dispatch_method = ESP_TIMER_TASK,
-        .name = "lv_tick",
-        .skip_unhandled_events = true
-    };
-
-    ESP_ERROR_CHECK(esp_timer_create(&lv_tick_timer_args, &lv_tick_timer));
-    ESP_ERROR_CHECK(esp_timer_start_periodic(lv_tick_timer, 1000));
-    ESP_LOGI(TAG, "LVGL tick timer initialized");
+// LVGL lee el tiempo bajo demanda: sin timer periódico que despierte al chip
+static uint32_t screen_tick_get_cb() {
+    return (uint32_t)(esp_timer_get_time() / 1000) + tick_offset_ms;
 }
 
-static void screen_deinit_lvgl_tick() {
-    if (lv_tick_timer) {
-        esp_timer_stop(lv_tick_timer);
-        esp_timer_delete(lv_tick_timer);
-        lv_tick_timer = nullptr;
-        ESP_LOGI(TAG, "LVGL tick timer deinitialized");
-    }
+screen_t* screen_init() {
+    const screen_render_config_t cfg = {
+        .mode = SCREEN_RENDER_MODE_DEFAULT,
+        .strip_lines = SCREEN_STRIP_LINES,
+        .bounce_lines = SCREEN_BOUNCE_LINES,
+    };
+    return screen_init_with_config(&cfg);
 }
 
-screen_t* screen_init() {
+screen_t* screen_init_with_config(const screen_render_config_t* cfg) {
     ESP_LOGI(TAG, "Initializing screen hardware");
-    screen_t* screen = new screen_t;
+    screen_t* screen = new screen_t(); // Inicializa a cero contadores y handles
     if (!screen) {
         ESP_LOGE(TAG, "Memory allocation failed for screen");
         return nullptr;
     }
+    screen->render_cfg = *cfg;
+
+    // Cada transferencia SPI lleva como mucho un strip (PARTIAL) o un bounce (modos PSRAM)
+    const uint16_t transfer_lines = cfg->mode == SCREEN_RENDER_PARTIAL ? cfg->strip_lines : cfg->bounce_lines;
 
     // Configuración SPI
      spi_bus_config_t buscfg = {
@@ -61,7 +53,7 @@ screen_t* screen_init() {
         .data6_io_num = -1,
         .data7_io_num = -1,
         .data_io_default_level = false,
-        .max_transfer_sz = SCREEN_WIDTH * 40 * sizeof(lv_color_t),
+        .max_transfer_sz = SCREEN_WIDTH * transfer_lines * SCREEN_BYTES_PER_PIXEL,
         .flags = 0,
         .isr_cpu_id = ESP_INTR_CPU_AFFINITY_AUTO,
         .intr_flags = 0,
@@ -128,82 +120,70 @@ screen_t* screen_init() {
     gpio_set_level(TFT_BL, EXAMPLE_LCD_BK_LIGHT_ON_LEVEL);
     // Inicializar LVGL
     screen_init_lvgl(screen);
-    screen_init_lvgl_tick();
 
     return screen;
 }
 
 void screen_init_lvgl(screen_t* screen) {
     lv_init();
+    lv_tick_set_cb(screen_tick_get_cb);
+
+    screen_flush_setup(screen);
+    screen->fps_last_us = esp_timer_get_time();
 
-    // Configura LVGL para usar memoria personalizada (opcional, pero recomendado)
-#if LV_MEM_CUSTOM == 1
-    lv_mem_init(screen->lvgl_buf1, SCREEN_WIDTH * 40 * sizeof(lv_color_t));
-    lv_mem_init(screen->lvgl_buf2, SCREEN_WIDTH * 40 * sizeof(lv_color_t));
-#else
-    // Buffers DMA (si LV_MEM_CUSTOM no está habilitado)
-    screen->lvgl_buf1 = (lv_color_t*)heap_caps_malloc(SCREEN_WIDTH * 40 * sizeof(lv_color_t), MALLOC_CAP_DMA);
-    screen->lvgl_buf2 = (lv_color_t*)heap_caps_malloc(SCREEN_WIDTH * 40 * sizeof(lv_color_t), MALLOC_CAP_DMA);
-    assert(screen->lvgl_buf1 && screen->lvgl_buf2);
+#if DRAW_ACCEL_ENABLED
+    draw_accel_init();
 #endif
 
-    // Configurar display LVGL
-    screen->lvgl_disp = lv_display_create(SCREEN_WIDTH, SCREEN_HEIGHT);
-    lv_display_set_buffers(screen->lvgl_disp, screen->lvgl_buf1, screen->lvgl_buf2,
-                          SCREEN_WIDTH * 40 * sizeof(lv_color_t), LV_DISPLAY_RENDER_MODE_PARTIAL);
+#if DISPLAY_PROFILER_ENABLED
+    display_profiler_init(screen->lvgl_disp);
+#endif
+}
 
-    // Callback de refresco
-    lv_display_set_flush_cb(screen->lvgl_disp, [](lv_display_t* disp, const lv_area_t* area, uint8_t* px_map) {
-        screen_t* s = (screen_t*)lv_display_get_user_data(disp);
-        esp_lcd_panel_draw_bitmap(s->panel_handle, area->x1, area->y1, area->x2 + 1, area->y2 + 1, (lv_color_t*)px_map);
-        lv_display_flush_ready(disp);
-    });
+void screen_set_tick_cb(lv_tick_get_cb_t cb) {
+    if (!cb) {
+        // El reloj que se deja (el virtual de ui_replay) puede ir por delante
+        // del real: se sigue desde el mayor de los dos para que lv_tick_elaps
+        // de los timers y las vistas nunca vea el tiempo ir hacia atrás
+        const uint32_t left = lv_tick_get();
+        const uint32_t real = screen_tick_get_cb();
+        if ((int32_t)(left - real) > 0) {
+            tick_offset_ms += left - real;
+        }
+        cb = screen_tick_get_cb;
+    }
+    lv_tick_set_cb(cb);
+}
+
+void screen_get_render_info(screen_t* screen, screen_render_info_t* out) {
+    if (!screen || !out) return;
+
+    const int64_t now = esp_timer_get_time();
+    const uint32_t frames = screen->frames_flushed;
+    const int64_t elapsed_us = now - screen->fps_last_us;
 
-    lv_display_set_user_data(screen->lvgl_disp, screen);
+    out->mode = screen->render_cfg.mode;
+    out->internal_ram_bytes = screen->internal_ram_bytes;
+    out->psram_bytes = screen->psram_bytes;
+    out->frames_flushed = frames;
+    out->fps = elapsed_us > 0 ? (uint32_t)((uint64_t)(frames - screen->fps_last_frames) * 1000000 / elapsed_us) : 0;
+
+    screen->fps_last_frames = frames;
+    screen->fps_last_us = now;
 }
 
 void screen_deinit(screen_t* screen) {
     ESP_LOGI(TAG, "Deinitializing screen");
 
-    screen_deinit_lvgl_tick();
-
     if (screen) {
         if (screen->panel_handle) esp_lcd_panel_del(screen->panel_handle);
         if (screen->io_handle) esp_lcd_panel_io_del(screen->io_handle);
-#if LV_MEM_CUSTOM != 1
-        if (screen->lvgl_buf1) free(screen->lvgl_buf1);
-        if (screen->lvgl_buf2) free(screen->lvgl_buf2);
-#endif
+        if (screen->flush_done_sem) vSemaphoreDelete(screen->flush_done_sem);
+        if (screen->bounce_free_sem) vSemaphoreDelete(screen->bounce_free_sem);
+        heap_caps_free(screen->lvgl_buf1);
+        heap_caps_free(screen->lvgl_buf2);
+        heap_caps_free(screen->bounce_buf[0]);
+        heap_caps_free(screen->bounce_buf[1]);
         delete screen;
     }
 }
-void switch_screen(const std::string& view_name) {
-    ESP_LOGI(TAG, "Switching to view: %s", view_name.c_str());
-
-    // Destruir la vista actual (si existe).
-    if (current_view) {
-        current_view->unregister_button_handlers();
-        current_view->destroy();
-        delete current_view; // Destruye la instancia anterior.
-        current_view = nullptr; // Importante para evitar doble destrucción.
-    }
-
-    // Crear y mostrar la nueva vista.
-    if (view_name == "Clock") {
-        current_view = new ClockView(); // Crea una nueva instancia.
-    } else if (view_name == "Boot") {
-        current_view = new BootView();
-    } else if (view_name == "Settings") {
-        current_view = new SettingsView();
-    } else if (view_name == "System Info") {
-        current_view = new SystemInfoView();
-    } else {
-        ESP_LOGE(TAG, "Unknown view: %s", view_name.c_str());
-        return;
-    }
-
-    if (current_view) {
-        current_view->register_button_handlers();
-        lv_disp_load_scr(current_view->get_screen());
-    }
-}
\ No newline at end of file
@@ -4,22 +4,133 @@
 #include "esp_lcd_panel_io.h"
 #include "esp_lcd_panel_vendor.h"
 #include "esp_lcd_panel_ops.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 #include "lvgl.h"
 #include "views/base_view.h"
 
+// Bytes por píxel enviados al panel (RGB565). Ojo: sizeof(lv_color_t) es 3 en LVGL 9.
+#define SCREEN_BYTES_PER_PIXEL (LV_COLOR_DEPTH / 8)
+
+// Disposición de los buffers de render
+typedef enum {
+    SCREEN_RENDER_PARTIAL = 0,          // Dos strips de N líneas en RAM interna DMA
+    SCREEN_RENDER_FULL_PSRAM_DIRECT,    // Dos frames completos en PSRAM, modo DIRECT
+    SCREEN_RENDER_PSRAM_BOUNCE,         // Frames en PSRAM + dos bounce buffers internos para el DMA
+} screen_render_mode_t;
+
+typedef struct {
+    screen_render_mode_t mode;
+    uint16_t strip_lines;       // Alto de cada strip en modo PARTIAL
+    uint16_t bounce_lines;      // Líneas por transferencia en los modos PSRAM
+} screen_render_config_t;
+
+typedef struct {
+    screen_render_mode_t mode;
+    size_t internal_ram_bytes;  // Buffers en RAM interna (incluye la copia temporal del driver SPI)
+    size_t psram_bytes;
+    uint32_t fps;               // Frames completos enviados por segundo desde la última consulta
+    uint32_t frames_flushed;
+} screen_render_info_t;
+
+// Contadores del camino de flush asíncrono (DMA)
+typedef struct {
+    uint32_t flush_count;   // Strips enviados al panel
+    uint64_t flushed_bytes; // Bytes de píxel enviados por SPI
+    uint64_t transfer_us;   // Tiempo total en el bus: draw_bitmap -> fin de DMA
+    uint64_t stall_us;      // Tiempo que LVGL esperó a que el otro buffer quedara libre
+    uint64_t overlap_us;    // transfer_us - stall_us: render solapado con la transferencia
+    uint32_t max_stall_us;  // Peor espera individual
+} screen_flush_stats_t;
+
 typedef struct {
     esp_lcd_panel_io_handle_t io_handle;
     esp_lcd_panel_handle_t panel_handle;
     lv_display_t *lvgl_disp;
     lv_color_t *lvgl_buf1;
     lv_color_t *lvgl_buf2;
+
+    // Estrategia de buffers elegida al inicializar
+    screen_render_config_t render_cfg;
+    uint8_t *bounce_buf[2];
+    uint8_t bounce_next;
+    SemaphoreHandle_t bounce_free_sem;
+    uint64_t bounce_wait_us;    // Acumulado que el flush esperó un bounce libre (no se pone a cero)
+    size_t internal_ram_bytes;
+    size_t psram_bytes;
+
+    // Estado del flush en curso (compartido con el ISR de fin de transferencia).
+    // Un flush puede partirse en varios trozos; el ISR cuenta los terminados y
+    // libera el buffer de LVGL al completar el último.
+    SemaphoreHandle_t flush_done_sem;
+    volatile bool flush_pending;
+    volatile bool flush_releases_lvgl;  // false: el buffer no es de LVGL (screen_flush_buffer)
+    volatile int64_t flush_start_us;
+    volatile uint32_t chunks_issued;
+    volatile uint32_t chunks_done;
+    volatile uint32_t last_chunk_seq;
+    volatile bool last_chunk_ends_frame;
+    volatile uint32_t frames_flushed;
+    screen_flush_stats_t flush_stats;
+
+    // Ventana para calcular FPS en screen_get_render_info
+    uint32_t fps_last_frames;
+    int64_t fps_last_us;
 } screen_t;
 
+// Identificadores compactos de las vistas registradas
+typedef enum {
+    VIEW_BOOT = 0,
+    VIEW_CLOCK,
+    VIEW_SETTINGS,
+    VIEW_SYSTEM_INFO,
+    VIEW_SPECTRUM,
+    VIEW_COUNT
+} view_id_t;
+
+typedef struct {
+    uint32_t switch_count;
+    uint32_t last_us;       // Latencia del último switch_screen (hasta lv_screen_load)
+    uint32_t avg_us;
+    uint32_t max_us;
+    uint32_t cache_hits;    // Vistas recuperadas de la caché sin reconstruir
+    uint32_t cache_misses;
+    uint32_t evictions;
+    uint32_t snapshot_hits; // Navegaciones resueltas mostrando un snapshot
+    uint32_t last_lazy_build_us; // Reconstrucción diferida detrás del último snapshot
+    size_t cache_bytes;     // Heap LVGL estimado de las vistas cacheadas
+    size_t cache_budget;
+} screen_switch_stats_t;
+
 void screen_init_lvgl(screen_t* screen);
+// Buffers de render, display de LVGL y callbacks de flush y de fin de DMA
+// (screen_flush.cpp). La llama screen_init_lvgl después de lv_init.
+void screen_flush_setup(screen_t* screen);
+void screen_flush_area(screen_t* screen, const lv_area_t* area, uint8_t* px_map, bool frame_end);
+// Envía un buffer propio (una copia del strip, no el de LVGL): sin intercambio de
+// bytes ni lv_display_flush_ready al terminar. Solo para áreas contiguas (modo PARTIAL).
+void screen_flush_buffer(screen_t* screen, const lv_area_t* area, uint8_t* buf, bool frame_end);
+// Bloquea hasta que termine el flush en curso
+void screen_flush_wait(screen_t* screen);
+// La espera de LVGL por el buffer en vuelo: como screen_flush_wait, pero suma
+// lo esperado a stall_us y max_stall_us
+void screen_flush_wait_stall(screen_t* screen);
+void screen_get_flush_stats(const screen_t* screen, screen_flush_stats_t* out);
+void screen_reset_flush_stats(screen_t* screen);
+// Sin panel: el flush devuelve el buffer al instante (espera al DMA en curso)
+void screen_set_headless(screen_t* screen, bool headless);
+// Reloj de LVGL alternativo, p. ej. virtual para reproducir scripts (nullptr = esp_timer).
+// Al volver a esp_timer el tick sigue desde el mayor de los dos: nunca retrocede.
+void screen_set_tick_cb(lv_tick_get_cb_t cb);
 
 extern screen_t* screen_init();
+extern screen_t* screen_init_with_config(const screen_render_config_t* cfg);
+extern void screen_get_render_info(screen_t* screen, screen_render_info_t* out);
 extern void screen_deinit(screen_t* screen);
-extern void switch_screen(const std::string& view_name);
-extern void destroy_current_view();
+extern void switch_screen(view_id_t view);
+extern view_id_t screen_get_current_view();
+extern const char* screen_get_view_name(view_id_t view);
+extern void screen_set_view_cache_budget(size_t bytes);
+extern void screen_get_switch_stats(screen_switch_stats_t* out);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,270 @@
+#include "controllers/screen_manager/screen_manager.h"
+#include "config.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "controllers/dlog/dlog.h"
+#include "controllers/mem_manager/mem_manager.h"
+#include "controllers/screen_manager/nav_snapshot.h"
+#include "views/apps/clock/clock_view.h"
+#include "views/system/boot_screen/boot_view.h"
+#include "views/system/settings/settings_view.h"
+#include "views/system/system_info/system_info_view.h"
+#include "views/apps/spectrum/spectrum_view.h"
+
+// Gestión de vistas: registro, caché, pila de navegación y snapshots. Solo usa
+// LVGL, así que el build de host (host/) la enlaza tal cual con un display sin panel.
+
+static const char* TAG = "SCREEN_MGR";
+
+static BaseView* current_view = nullptr; //  Para gestionar la vista actual
+
+// Registro de vistas indexado por view_id_t: la búsqueda es un acceso directo al array
+typedef BaseView* (*view_factory_t)();
+
+typedef struct {
+    const char* name;
+    view_factory_t create;
+    bool cacheable;     // Las vistas de un solo uso (Boot) no se guardan
+    bool snapshot;      // Guardar un snapshot en PSRAM al expulsarla de la caché
+} view_info_t;
+
+static const view_info_t view_registry[VIEW_COUNT] = {
+    { "Boot",        []() -> BaseView* { return new BootView(); },       false, false },
+    { "Clock",       []() -> BaseView* { return new ClockView(); },      true,  true  },
+    { "Settings",    []() -> BaseView* { return new SettingsView(); },   true,  true  },
+    { "System Info", []() -> BaseView* { return new SystemInfoView(); }, true,  true  },
+    { "Spectrum",    []() -> BaseView* { return new SpectrumView(); },   true,  false },
+};
+
+// Caché LRU de vistas construidas, también indexada por id
+typedef struct {
+    BaseView* view;
+    size_t bytes;       // Heap LVGL consumido al construir la vista
+    uint32_t last_used;
+} view_cache_entry_t;
+
+static view_cache_entry_t view_cache[VIEW_COUNT] = {};
+static view_id_t current_view_id = VIEW_COUNT;
+static uint32_t view_use_counter = 0;
+static size_t view_cache_budget = VIEW_CACHE_BUDGET_BYTES;
+static screen_switch_stats_t switch_stats = {};
+static uint64_t switch_total_us = 0;
+
+// Pila de navegación: volver a la vista de la cima se considera "atrás"
+static view_id_t nav_history[NAV_HISTORY_DEPTH];
+static int nav_history_len = 0;
+
+// Reconstrucción diferida detrás de un snapshot
+static lv_obj_t* placeholder_screen = nullptr;
+static lv_timer_t* pending_build_timer = nullptr;
+
+static size_t lv_heap_used() {
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    return mon.total_size - mon.free_size;
+}
+
+static size_t view_cache_bytes() {
+    size_t total = 0;
+    for (int i = 0; i < VIEW_COUNT; i++) {
+        if (view_cache[i].view) total += view_cache[i].bytes;
+    }
+    return total;
+}
+
+static void view_cache_release(int id) {
+    // Antes de borrarla se guarda su imagen para poder volver a ella al instante
+    if (view_registry[id].snapshot) {
+        nav_snapshot_capture(id, view_cache[id].view->get_screen());
+    }
+    view_cache[id].view->destroy();
+    delete view_cache[id].view;
+    view_cache[id] = {};
+}
+
+// Expulsa las vistas suspendidas menos usadas hasta respetar el presupuesto.
+// La vista activa y 'protect' (la que sale animada) nunca se expulsan.
+static void view_cache_evict(int protect) {
+    while (view_cache_bytes() > view_cache_budget) {
+        int victim = -1;
+        for (int i = 0; i < VIEW_COUNT; i++) {
+            if (!view_cache[i].view || i == current_view_id || i == protect) continue;
+            if (victim < 0 || view_cache[i].last_used < view_cache[victim].last_used) {
+                victim = i;
+            }
+        }
+        if (victim < 0) break;
+
+        DLOGI(TAG, "Evicting cached view: %s (%u bytes)", view_registry[victim].name, (unsigned)view_cache[victim].bytes);
+        view_cache_release(victim);
+        switch_stats.evictions++;
+    }
+}
+
+// Devuelve true si 'view_id' es la vista anterior en la pila (navegación hacia atrás)
+static bool nav_history_update(view_id_t view_id) {
+    if (nav_history_len > 0 && nav_history[nav_history_len - 1] == view_id) {
+        nav_history_len--;
+        return true;
+    }
+    if (current_view_id < VIEW_COUNT && view_registry[current_view_id].cacheable) {
+        if (nav_history_len == NAV_HISTORY_DEPTH) {
+            // Pila llena: se descarta la entrada más antigua
+            for (int i = 1; i < NAV_HISTORY_DEPTH; i++) nav_history[i - 1] = nav_history[i];
+            nav_history_len--;
+        }
+        nav_history[nav_history_len++] = current_view_id;
+    }
+    return false;
+}
+
+// Recupera la vista de la caché o la construye, y la muestra.
+static void activate_view(view_id_t view_id) {
+    view_cache_entry_t& entry = view_cache[view_id];
+    if (entry.view) {
+        entry.view->resume();
+        switch_stats.cache_hits++;
+    } else {
+        // Todo lo que la vista reserve al construirse sale de su arena y se
+        // devuelve de una vez en BaseView::destroy()
+        const size_t heap_before = lv_heap_used();
+        mem_arena_t* previous = mem_arena_enter(mem_arena_create(view_registry[view_id].name));
+        entry.view = view_registry[view_id].create();
+        mem_arena_exit(previous);
+        const size_t heap_after = lv_heap_used();
+        entry.bytes = heap_after > heap_before ? heap_after - heap_before : 0;
+        switch_stats.cache_misses++;
+    }
+    entry.last_used = ++view_use_counter;
+
+    current_view = entry.view;
+    current_view_id = view_id;
+    current_view->register_button_handlers();
+    lv_screen_load(current_view->get_screen());
+}
+
+static void delete_placeholder() {
+    if (pending_build_timer) {
+        lv_timer_delete(pending_build_timer);
+        pending_build_timer = nullptr;
+    }
+    if (placeholder_screen && placeholder_screen != lv_screen_active()) {
+        lv_obj_delete(placeholder_screen);
+        placeholder_screen = nullptr;
+        nav_snapshot_pin(-1);
+    }
+}
+
+// Construye la vista real cuando el snapshot ya está en pantalla y la transición terminó
+static void pending_build_cb(lv_timer_t* timer) {
+    if (lv_anim_get(placeholder_screen, nullptr)) {
+        return; // Transición aún en curso: reintentar en el siguiente periodo
+    }
+    pending_build_timer = nullptr;
+    lv_timer_delete(timer);
+
+    const int64_t t_start = esp_timer_get_time();
+    activate_view(current_view_id);
+    delete_placeholder();
+    view_cache_evict(-1);
+    switch_stats.last_lazy_build_us = (uint32_t)(esp_timer_get_time() - t_start);
+    DLOGI(TAG, "View %s rebuilt behind snapshot in %lu us", view_registry[current_view_id].name,
+          (unsigned long)switch_stats.last_lazy_build_us);
+}
+
+// Muestra el snapshot de la vista destino y programa su reconstrucción.
+static void show_snapshot(view_id_t view_id, const lv_draw_buf_t* snapshot, bool animate) {
+    lv_obj_t* placeholder = lv_obj_create(nullptr);
+    lv_obj_remove_style_all(placeholder);
+    lv_obj_set_size(placeholder, SCREEN_WIDTH, SCREEN_HEIGHT);
+    lv_obj_t* image = lv_image_create(placeholder);
+    lv_image_set_src(image, snapshot);
+    nav_snapshot_pin(view_id); // No expulsarlo mientras esté en pantalla
+
+    if (animate) {
+        lv_screen_load_anim(placeholder, LV_SCR_LOAD_ANIM_MOVE_RIGHT, NAV_TRANSITION_MS, 0, false);
+    } else {
+        lv_screen_load(placeholder);
+    }
+    placeholder_screen = placeholder;
+
+    current_view = nullptr;
+    current_view_id = view_id;
+    pending_build_timer = lv_timer_create(pending_build_cb, animate ? NAV_TRANSITION_MS + LV_DEF_REFR_PERIOD : LV_DEF_REFR_PERIOD, nullptr);
+    switch_stats.snapshot_hits++;
+}
+
+view_id_t screen_get_current_view() {
+    return current_view_id;
+}
+
+const char* screen_get_view_name(view_id_t view) {
+    return view < VIEW_COUNT ? view_registry[view].name : "?";
+}
+
+void screen_set_view_cache_budget(size_t bytes) {
+    view_cache_budget = bytes;
+    view_cache_evict(-1);
+}
+
+void screen_get_switch_stats(screen_switch_stats_t* out) {
+    if (!out) return;
+    *out = switch_stats;
+    out->cache_bytes = view_cache_bytes();
+    out->cache_budget = view_cache_budget;
+}
+
+void switch_screen(view_id_t view_id) {
+    if (view_id >= VIEW_COUNT) {
+        ESP_LOGE(TAG, "Unknown view id: %d", view_id);
+        return;
+    }
+    DLOGI(TAG, "Switching to view: %s", view_registry[view_id].name);
+    const int64_t t_start = esp_timer_get_time();
+
+    const bool back = nav_history_update(view_id);
+    const view_id_t previous_id = current_view_id;
+    bool previous_alive = false;
+
+    // Sacar la vista actual: se suspende si es cacheable, si no se destruye.
+    if (current_view) {
+        current_view->unregister_button_handlers();
+        if (view_registry[current_view_id].cacheable) {
+            current_view->suspend();
+            previous_alive = true;
+        } else {
+            current_view->destroy();
+            delete current_view; // Destruye la instancia anterior.
+            view_cache[current_view_id] = {};
+        }
+        current_view = nullptr; // Importante para evitar doble destrucción.
+    }
+
+    // Si la vista no está en caché pero hay snapshot, se muestra ya y se reconstruye después.
+    const lv_draw_buf_t* snapshot = view_cache[view_id].view ? nullptr : nav_snapshot_get(view_id);
+    if (snapshot) {
+        if (pending_build_timer) {
+            lv_timer_delete(pending_build_timer);
+            pending_build_timer = nullptr;
+        }
+        lv_obj_t* old_placeholder = placeholder_screen;
+        show_snapshot(view_id, snapshot, back && previous_alive);
+        if (old_placeholder) lv_obj_delete(old_placeholder);
+    } else {
+        activate_view(view_id);
+        delete_placeholder();
+    }
+
+    // Con la nueva pantalla ya activa se pueden borrar las vistas sobrantes.
+    view_cache_evict(previous_id);
+
+    const uint32_t elapsed = (uint32_t)(esp_timer_get_time() - t_start);
+    switch_stats.switch_count++;
+    switch_stats.last_us = elapsed;
+    switch_total_us += elapsed;
+    switch_stats.avg_us = (uint32_t)(switch_total_us / switch_stats.switch_count);
+    if (elapsed > switch_stats.max_us) {
+        switch_stats.max_us = elapsed;
+    }
+    DLOGI(TAG, "View %s ready in %lu us", view_registry[view_id].name, (unsigned long)elapsed);
+}
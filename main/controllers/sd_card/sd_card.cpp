@@ -0,0 +1,561 @@
+#include "sd_card.h"
+#include "utils/mpsc_ring.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifdef ESP_PLATFORM
+#include "driver/sdspi_host.h"
+#include "driver/spi_common.h"
+#include "esp_vfs_fat.h"
+#include "diskio_impl.h"
+#include "diskio_sdmmc.h"
+#include "sdmmc_cmd.h"
+#endif
+
+static const char* TAG = "SD_CARD";
+
+#define SD_WRITER_TASK_STACK    4096
+#define SD_MAX_RECORD_BYTES     2048    // Las escrituras grandes se trocean en registros de este tamaño
+#define SD_PATH_MAX             64
+#define SD_SYNC_ALL             0xFF
+
+// Tag de registro: tipo en el byte alto, fichero en el bajo
+enum : uint8_t {
+    REC_DATA = 1,
+    REC_OPEN,       // payload: uint8_t append + ruta
+    REC_CLOSE,
+    REC_SYNC,       // Fichero o SD_SYNC_ALL
+};
+
+static inline uint16_t make_tag(uint8_t type, uint8_t file) {
+    return (uint16_t)(type << 8 | file);
+}
+
+// Estado de cada fichero; solo lo toca la tarea writer
+typedef struct {
+    int fd;
+    bool dirty;                     // Escrito desde el último fsync
+    uint8_t* stage;
+    uint32_t stage_len;
+    uint32_t stage_limit;           // Bytes hasta la siguiente frontera de bloque
+    uint32_t pos;                   // Offset en el fichero de stage[0]
+} sd_file_state_t;
+
+static const sd_card_backend_t* backend = nullptr;
+static char root_path[SD_PATH_MAX];
+#ifdef ESP_PLATFORM
+static sdmmc_card_t* card = nullptr;
+#endif
+static bool mounted = false;
+static uint32_t block_bytes = 512;
+
+static MpscRing ring;
+static TaskHandle_t writer_task = nullptr;
+static std::atomic<uint32_t> open_mask{0};   // Slots de fichero en uso
+static sd_file_state_t files[SD_CARD_MAX_FILES];
+static std::atomic<uint32_t> sync_all_requested{0};
+static std::atomic<uint32_t> sync_all_done{0};
+
+// Contadores de productores (varias tareas) y del writer
+static std::atomic<uint64_t> stat_bytes_in{0};
+static std::atomic<uint64_t> stat_dropped_bytes{0};
+static std::atomic<uint32_t> stat_records{0};
+static std::atomic<uint32_t> stat_dropped_records{0};
+static std::atomic<uint32_t> stat_back_pressure{0};
+static std::atomic<uint32_t> stat_ring_peak{0};
+static uint64_t stat_bytes_written = 0;
+static uint32_t stat_writes = 0;
+static uint32_t stat_aligned_writes = 0;
+static uint32_t stat_fsyncs = 0;
+static uint32_t stat_errors = 0;
+static uint32_t stat_write_us_max = 0;
+static uint32_t stat_fsync_us_max = 0;
+
+// --- Backends -------------------------------------------------------------
+
+static int posix_open(const char* path, bool append, uint32_t* size) {
+    const int fd = open(path, O_WRONLY | O_CREAT | (append ? O_APPEND : O_TRUNC), 0666);
+    if (fd >= 0) {
+        const off_t end = append ? lseek(fd, 0, SEEK_END) : 0;
+        *size = end > 0 ? (uint32_t)end : 0;
+    }
+    return fd;
+}
+
+static int posix_write(int fd, const void* data, size_t len) {
+    return write(fd, data, len);
+}
+
+const sd_card_backend_t sd_card_posix_backend = {
+    .name = "posix",
+    .open = posix_open,
+    .write = posix_write,
+    .sync = fsync,
+    .close = close,
+};
+
+static int null_open(const char* path, bool append, uint32_t* size) {
+    *size = 0;
+    return 0;
+}
+
+static int null_write(int fd, const void* data, size_t len) {
+    return (int)len;
+}
+
+static int null_sync(int fd) {
+    return 0;
+}
+
+const sd_card_backend_t sd_card_null_backend = {
+    .name = "null",
+    .open = null_open,
+    .write = null_write,
+    .sync = null_sync,
+    .close = null_sync,
+};
+
+// --- Writer ---------------------------------------------------------------
+
+static void stage_reset(sd_file_state_t* f) {
+    f->stage_len = 0;
+    f->stage_limit = block_bytes - (f->pos % block_bytes);
+}
+
+static void stage_write(sd_file_state_t* f) {
+    if (f->stage_len == 0) return;
+
+    const int64_t t0 = esp_timer_get_time();
+    const int written = backend->write(f->fd, f->stage, f->stage_len);
+    const uint32_t us = (uint32_t)(esp_timer_get_time() - t0);
+    if (us > stat_write_us_max) stat_write_us_max = us;
+
+    if (written != (int)f->stage_len) {
+        stat_errors++;
+        ESP_LOGE(TAG, "write: %d de %lu bytes", written, (unsigned long)f->stage_len);
+    }
+    if (written > 0) {
+        f->pos += written;
+        stat_bytes_written += written;
+    }
+    stat_writes++;
+    if (f->pos % block_bytes == 0) {
+        stat_aligned_writes++;
+    }
+    f->dirty = true;
+    stage_reset(f);
+}
+
+static void file_sync(sd_file_state_t* f) {
+    if (f->fd < 0) return;
+    stage_write(f);
+    if (!f->dirty) return;
+
+    const int64_t t0 = esp_timer_get_time();
+    if (backend->sync(f->fd) != 0) {
+        stat_errors++;
+    }
+    const uint32_t us = (uint32_t)(esp_timer_get_time() - t0);
+    if (us > stat_fsync_us_max) stat_fsync_us_max = us;
+    stat_fsyncs++;
+    f->dirty = false;
+}
+
+static void file_open(uint8_t slot, const uint8_t* payload, uint32_t len) {
+    sd_file_state_t* f = &files[slot];
+    char path[SD_PATH_MAX * 2];
+    snprintf(path, sizeof(path), "%s/%.*s", root_path, (int)(len - 1), (const char*)payload + 1);
+
+    uint32_t size = 0;
+    f->fd = backend->open(path, payload[0] != 0, &size);
+    f->stage = (uint8_t*)heap_caps_aligned_alloc(4, block_bytes, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    if (f->fd < 0 || !f->stage) {
+        ESP_LOGE(TAG, "No se pudo abrir %s", path);
+        stat_errors++;
+        if (f->fd >= 0) backend->close(f->fd);
+        heap_caps_free(f->stage);
+        f->fd = -1;
+        f->stage = nullptr;
+        return;
+    }
+    // Si se añade a un fichero existente, la primera escritura solo completa su bloque
+    f->pos = size;
+    f->dirty = false;
+    stage_reset(f);
+}
+
+static void file_close(uint8_t slot) {
+    sd_file_state_t* f = &files[slot];
+    if (f->fd >= 0) {
+        file_sync(f);
+        backend->close(f->fd);
+    }
+    heap_caps_free(f->stage);
+    f->stage = nullptr;
+    f->fd = -1;
+    open_mask.fetch_and(~(1u << slot), std::memory_order_release);
+}
+
+static void file_append(uint8_t slot, const uint8_t* data, uint32_t len) {
+    sd_file_state_t* f = &files[slot];
+    if (f->fd < 0) return;   // Falló el open: se descarta
+
+    while (len > 0) {
+        const uint32_t room = f->stage_limit - f->stage_len;
+        const uint32_t n = len < room ? len : room;
+        memcpy(f->stage + f->stage_len, data, n);
+        f->stage_len += n;
+        data += n;
+        len -= n;
+        if (f->stage_len == f->stage_limit) {
+            stage_write(f);
+        }
+    }
+}
+
+static void handle_record(uint16_t tag, const uint8_t* payload, uint32_t len) {
+    const uint8_t type = tag >> 8;
+    const uint8_t slot = tag & 0xFF;
+
+    switch (type) {
+    case REC_DATA:
+        file_append(slot, payload, len);
+        break;
+    case REC_OPEN:
+        file_open(slot, payload, len);
+        break;
+    case REC_CLOSE:
+        file_close(slot);
+        break;
+    case REC_SYNC:
+        if (slot == SD_SYNC_ALL) {
+            for (int i = 0; i < SD_CARD_MAX_FILES; i++) file_sync(&files[i]);
+            sync_all_done.fetch_add(1, std::memory_order_release);
+        } else {
+            file_sync(&files[slot]);
+        }
+        break;
+    }
+}
+
+static void sd_writer_task(void* arg) {
+    const int64_t interval_us = (int64_t)SD_CARD_FSYNC_INTERVAL_MS * 1000;
+    int64_t next_sync = esp_timer_get_time() + interval_us;
+
+    for (;;) {
+        uint32_t len;
+        uint16_t tag;
+        const uint8_t* payload;
+        while ((payload = ring.peek(&len, &tag)) != nullptr) {
+            handle_record(tag, payload, len);
+            ring.release();
+        }
+
+        // Límite de pérdida de datos: lo pendiente se escribe aunque no llene un bloque
+        const int64_t now = esp_timer_get_time();
+        if (now >= next_sync) {
+            for (int i = 0; i < SD_CARD_MAX_FILES; i++) file_sync(&files[i]);
+            next_sync = now + interval_us;
+        }
+
+        const TickType_t wait = pdMS_TO_TICKS((next_sync - esp_timer_get_time()) / 1000);
+        ulTaskNotifyTake(pdTRUE, wait > 0 ? wait : 1);
+    }
+}
+
+static bool enqueue_control(uint8_t type, uint8_t slot, const void* payload, uint32_t len) {
+    // Los registros de control no se descartan: esperan a que haya sitio
+    uint8_t* dst;
+    while ((dst = ring.reserve(len, make_tag(type, slot))) == nullptr) {
+        if (!writer_task) return false;
+        xTaskNotifyGive(writer_task);
+        vTaskDelay(1);
+    }
+    if (len) memcpy(dst, payload, len);
+    ring.commit(dst);
+    xTaskNotifyGive(writer_task);
+    return true;
+}
+
+// --- API ------------------------------------------------------------------
+
+esp_err_t sd_card_init_with_backend(const sd_card_backend_t* be, const char* root) {
+    if (writer_task) return ESP_ERR_INVALID_STATE;
+
+    uint8_t* mem = (uint8_t*)heap_caps_malloc(SD_CARD_RING_BYTES,
+                                              SD_CARD_RING_IN_PSRAM ? MALLOC_CAP_SPIRAM : MALLOC_CAP_INTERNAL);
+    if (!mem) {
+        mem = (uint8_t*)heap_caps_malloc(SD_CARD_RING_BYTES, MALLOC_CAP_8BIT);
+    }
+    if (!mem || !ring.init(mem, SD_CARD_RING_BYTES)) {
+        heap_caps_free(mem);
+        return ESP_ERR_NO_MEM;
+    }
+
+    backend = be;
+    snprintf(root_path, sizeof(root_path), "%s", root);
+    for (int i = 0; i < SD_CARD_MAX_FILES; i++) {
+        files[i].fd = -1;
+    }
+
+    if (xTaskCreatePinnedToCore(sd_writer_task, "sd_writer", SD_WRITER_TASK_STACK, nullptr,
+                                SD_CARD_WRITER_PRIORITY, &writer_task, SD_CARD_WRITER_CORE) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    ESP_LOGI(TAG, "Writer '%s' en %s: ring de %u KB, bloques de %lu bytes, fsync cada %d ms",
+             be->name, root, SD_CARD_RING_BYTES / 1024, (unsigned long)block_bytes, SD_CARD_FSYNC_INTERVAL_MS);
+    return ESP_OK;
+}
+
+esp_err_t sd_card_init() {
+#ifndef ESP_PLATFORM
+    // En el PC no hay SD: el writer se arranca con sd_card_init_with_backend
+    return ESP_ERR_NOT_SUPPORTED;
+#else
+    spi_bus_config_t buscfg = {
+        .mosi_io_num = SD_MOSI,
+        .miso_io_num = SD_MISO,
+        .sclk_io_num = SD_SCLK,
+        .quadwp_io_num = -1,
+        .quadhd_io_num = -1,
+        .data4_io_num = -1,
+        .data5_io_num = -1,
+        .data6_io_num = -1,
+        .data7_io_num = -1,
+        .data_io_default_level = false,
+        .max_transfer_sz = SD_CARD_STAGE_MAX_BYTES,
+        .flags = 0,
+        .isr_cpu_id = ESP_INTR_CPU_AFFINITY_AUTO,
+        .intr_flags = 0,
+    };
+    esp_err_t err = spi_bus_initialize(SD_CARD_HOST, &buscfg, SDSPI_DEFAULT_DMA);
+    if (err != ESP_OK) return err;
+
+    sdmmc_host_t host = SDSPI_HOST_DEFAULT();
+    host.slot = SD_CARD_HOST;
+    sdspi_device_config_t slot = SDSPI_DEVICE_CONFIG_DEFAULT();
+    slot.gpio_cs = SD_CS;
+    slot.host_id = SD_CARD_HOST;
+
+    esp_vfs_fat_mount_config_t mount_cfg = {};
+    mount_cfg.format_if_mount_failed = false;
+    mount_cfg.max_files = SD_CARD_MAX_FILES + 1;
+    mount_cfg.allocation_unit_size = 16 * 1024;
+
+    err = esp_vfs_fat_sdspi_mount(SD_CARD_MOUNT_POINT, &host, &slot, &mount_cfg, &card);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Sin tarjeta SD (%s)", esp_err_to_name(err));
+        spi_bus_free(SD_CARD_HOST);
+        return err;
+    }
+    mounted = true;
+
+    // Tamaño de cluster real de la FAT: las escrituras nunca cruzan uno
+    FATFS* fs = nullptr;
+    DWORD free_clusters = 0;
+    const char drv[3] = { (char)('0' + ff_diskio_get_pdrv_card(card)), ':', 0 };
+    if (f_getfree(drv, &free_clusters, &fs) == FR_OK) {
+        const uint32_t cluster = fs->csize * card->csd.sector_size;
+        block_bytes = cluster < SD_CARD_STAGE_MAX_BYTES ? cluster : SD_CARD_STAGE_MAX_BYTES;
+    }
+    sdmmc_card_print_info(stdout, card);
+
+    return sd_card_init_with_backend(&sd_card_posix_backend, SD_CARD_MOUNT_POINT);
+#endif
+}
+
+bool sd_card_is_mounted() {
+    return mounted;
+}
+
+sd_file_t sd_card_open(const char* path, bool append) {
+    if (!writer_task) return SD_FILE_INVALID;
+
+    const size_t path_len = strlen(path);
+    if (path_len == 0 || path_len >= SD_PATH_MAX) return SD_FILE_INVALID;
+
+    // Reserva del slot sin locks
+    uint32_t mask = open_mask.load(std::memory_order_acquire);
+    int slot;
+    do {
+        slot = -1;
+        for (int i = 0; i < SD_CARD_MAX_FILES; i++) {
+            if (!(mask & (1u << i))) {
+                slot = i;
+                break;
+            }
+        }
+        if (slot < 0) {
+            ESP_LOGW(TAG, "Sin slots libres para %s", path);
+            return SD_FILE_INVALID;
+        }
+    } while (!open_mask.compare_exchange_weak(mask, mask | (1u << slot), std::memory_order_acq_rel));
+
+    uint8_t payload[SD_PATH_MAX + 1];
+    payload[0] = append ? 1 : 0;
+    memcpy(payload + 1, path, path_len);
+    enqueue_control(REC_OPEN, slot, payload, path_len + 1);
+    return slot;
+}
+
+static void update_ring_peak() {
+    const uint32_t used = ring.used();
+    uint32_t peak = stat_ring_peak.load(std::memory_order_relaxed);
+    while (used > peak && !stat_ring_peak.compare_exchange_weak(peak, used, std::memory_order_relaxed)) {
+    }
+}
+
+size_t sd_card_write(sd_file_t file, const void* data, size_t len, uint32_t timeout_ms) {
+    if (!writer_task || file < 0 || file >= SD_CARD_MAX_FILES) return 0;
+
+    const uint8_t* src = (const uint8_t*)data;
+    const int64_t deadline = esp_timer_get_time() + (int64_t)timeout_ms * 1000;
+    const uint16_t tag = make_tag(REC_DATA, (uint8_t)file);
+    bool waited = false;
+    size_t done = 0;
+
+    while (done < len) {
+        const uint32_t chunk = len - done < SD_MAX_RECORD_BYTES ? len - done : SD_MAX_RECORD_BYTES;
+        uint8_t* dst = ring.reserve(chunk, tag);
+        if (!dst) {
+            // Back-pressure: despertar al writer y esperar a que libere sitio
+            if (!waited) {
+                stat_back_pressure.fetch_add(1, std::memory_order_relaxed);
+                waited = true;
+            }
+            xTaskNotifyGive(writer_task);
+            if (esp_timer_get_time() >= deadline) break;
+            vTaskDelay(1);
+            continue;
+        }
+        memcpy(dst, src + done, chunk);
+        ring.commit(dst);
+        done += chunk;
+        stat_records.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    stat_bytes_in.fetch_add(done, std::memory_order_relaxed);
+    if (done < len) {
+        stat_dropped_records.fetch_add(1, std::memory_order_relaxed);
+        stat_dropped_bytes.fetch_add(len - done, std::memory_order_relaxed);
+    }
+
+    update_ring_peak();
+    // Con menos de un bloque pendiente no merece la pena despertar al writer
+    if (ring.used() >= block_bytes) {
+        xTaskNotifyGive(writer_task);
+    }
+    return done;
+}
+
+void sd_card_flush(sd_file_t file) {
+    if (!writer_task || file < 0 || file >= SD_CARD_MAX_FILES) return;
+    enqueue_control(REC_SYNC, (uint8_t)file, nullptr, 0);
+}
+
+void sd_card_close(sd_file_t file) {
+    if (!writer_task || file < 0 || file >= SD_CARD_MAX_FILES) return;
+    enqueue_control(REC_CLOSE, (uint8_t)file, nullptr, 0);
+}
+
+esp_err_t sd_card_drain(uint32_t timeout_ms) {
+    if (!writer_task) return ESP_ERR_INVALID_STATE;
+
+    const uint32_t ticket = sync_all_requested.fetch_add(1, std::memory_order_relaxed) + 1;
+    enqueue_control(REC_SYNC, SD_SYNC_ALL, nullptr, 0);
+
+    const int64_t deadline = esp_timer_get_time() + (int64_t)timeout_ms * 1000;
+    while ((int32_t)(sync_all_done.load(std::memory_order_acquire) - ticket) < 0) {
+        if (esp_timer_get_time() >= deadline) return ESP_ERR_TIMEOUT;
+        vTaskDelay(1);
+    }
+    return ESP_OK;
+}
+
+void sd_card_get_stats(sd_card_stats_t* out) {
+    out->mounted = mounted;
+    out->backend = backend ? backend->name : "none";
+    out->cluster_bytes = block_bytes;
+    out->ring_bytes = ring.capacity();
+    out->ring_used = ring.used();
+    out->ring_peak = stat_ring_peak.load(std::memory_order_relaxed);
+    out->bytes_in = stat_bytes_in.load(std::memory_order_relaxed);
+    out->bytes_written = stat_bytes_written;
+    out->dropped_bytes = stat_dropped_bytes.load(std::memory_order_relaxed);
+    out->records = stat_records.load(std::memory_order_relaxed);
+    out->dropped_records = stat_dropped_records.load(std::memory_order_relaxed);
+    out->back_pressure_waits = stat_back_pressure.load(std::memory_order_relaxed);
+    out->writes = stat_writes;
+    out->aligned_writes = stat_aligned_writes;
+    out->fsyncs = stat_fsyncs;
+    out->errors = stat_errors;
+    out->write_us_max = stat_write_us_max;
+    out->fsync_us_max = stat_fsync_us_max;
+}
+
+void sd_card_reset_stats() {
+    stat_bytes_in = 0;
+    stat_dropped_bytes = 0;
+    stat_records = 0;
+    stat_dropped_records = 0;
+    stat_back_pressure = 0;
+    stat_ring_peak = 0;
+    stat_bytes_written = 0;
+    stat_writes = 0;
+    stat_aligned_writes = 0;
+    stat_fsyncs = 0;
+    stat_errors = 0;
+    stat_write_us_max = 0;
+    stat_fsync_us_max = 0;
+}
+
+void sd_card_benchmark(uint32_t total_bytes, uint32_t record_bytes) {
+    if (!writer_task || record_bytes == 0) return;
+
+    uint8_t* record = (uint8_t*)heap_caps_malloc(record_bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (!record) return;
+    for (uint32_t i = 0; i < record_bytes; i++) {
+        record[i] = (uint8_t)i;
+    }
+
+    sd_card_drain(5000);
+    sd_card_reset_stats();
+    const sd_file_t file = sd_card_open("SDBENCH.BIN", false);
+
+    uint32_t call_max_us = 0;
+    uint64_t call_total_us = 0;
+    uint32_t calls = 0;
+    const int64_t t0 = esp_timer_get_time();
+    for (uint32_t sent = 0; sent < total_bytes; sent += record_bytes) {
+        const int64_t c0 = esp_timer_get_time();
+        sd_card_write(file, record, record_bytes, 1000);
+        const uint32_t us = (uint32_t)(esp_timer_get_time() - c0);
+        call_total_us += us;
+        if (us > call_max_us) call_max_us = us;
+        calls++;
+    }
+    const int64_t produced_us = esp_timer_get_time() - t0;
+    sd_card_close(file);
+    sd_card_drain(30000);
+    const int64_t total_us = esp_timer_get_time() - t0;
+
+    sd_card_stats_t st;
+    sd_card_get_stats(&st);
+    printf("SDBENCH,backend,record_bytes,total_bytes,call_avg_us,call_max_us,produce_kB_s,end_to_end_kB_s,writes,aligned,back_pressure,dropped_bytes\n");
+    printf("SDBENCH,%s,%lu,%lu,%lu,%lu,%llu,%llu,%lu,%lu,%lu,%llu\n",
+           st.backend, (unsigned long)record_bytes, (unsigned long)total_bytes,
+           (unsigned long)(calls ? call_total_us / calls : 0), (unsigned long)call_max_us,
+           (unsigned long long)(produced_us > 0 ? (uint64_t)total_bytes * 1000 / produced_us : 0),
+           (unsigned long long)(total_us > 0 ? (uint64_t)total_bytes * 1000 / total_us : 0),
+           (unsigned long)st.writes, (unsigned long)st.aligned_writes,
+           (unsigned long)st.back_pressure_waits, (unsigned long long)st.dropped_bytes);
+    heap_caps_free(record);
+}
@@ -0,0 +1,80 @@
+#ifndef SD_CARD_H
+#define SD_CARD_H
+
+#include "esp_err.h"
+#include "config.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Escritura asíncrona en la tarjeta SD. Los productores (UI, sensores...)
+// copian sus datos a un ring lock-free multi-productor y vuelven enseguida;
+// una tarea de baja prioridad agrupa los datos por fichero en bloques del
+// tamaño del cluster, alineados con el offset del fichero, y hace fsync
+// cada SD_CARD_FSYNC_INTERVAL_MS.
+
+typedef int sd_file_t;              // < 0 = inválido
+#define SD_FILE_INVALID (-1)
+
+// Almacenamiento que hay debajo del writer. El backend POSIX sirve para la
+// FAT de la SD (VFS de ESP-IDF) y para cualquier directorio con open/write/
+// fsync, por ejemplo un fichero normal en el PC; el nulo solo cuenta bytes.
+typedef struct {
+    const char* name;
+    int (*open)(const char* path, bool append, uint32_t* size);    // fd o < 0
+    int (*write)(int fd, const void* data, size_t len);             // bytes o < 0
+    int (*sync)(int fd);
+    int (*close)(int fd);
+} sd_card_backend_t;
+
+extern const sd_card_backend_t sd_card_posix_backend;
+extern const sd_card_backend_t sd_card_null_backend;
+
+typedef struct {
+    bool mounted;
+    const char* backend;
+    uint32_t cluster_bytes;         // Tamaño de las escrituras agrupadas
+    uint32_t ring_bytes;
+    uint32_t ring_used;
+    uint32_t ring_peak;
+    uint64_t bytes_in;              // Aceptados en el ring
+    uint64_t bytes_written;         // Entregados al backend
+    uint64_t dropped_bytes;
+    uint32_t records;
+    uint32_t dropped_records;       // sd_card_write sin sitio tras agotar el timeout
+    uint32_t back_pressure_waits;   // Veces que un productor tuvo que esperar sitio
+    uint32_t writes;                // Llamadas a write() del backend
+    uint32_t aligned_writes;        // De ellas, bloques completos terminados en frontera de cluster
+    uint32_t fsyncs;
+    uint32_t errors;
+    uint32_t write_us_max;
+    uint32_t fsync_us_max;
+} sd_card_stats_t;
+
+// Monta la SD por SPI (SD_CARD_HOST) en SD_CARD_MOUNT_POINT con FATFS y
+// arranca el writer con el backend POSIX.
+esp_err_t sd_card_init();
+// Arranca el writer sobre otro backend; las rutas se resuelven bajo 'root'
+esp_err_t sd_card_init_with_backend(const sd_card_backend_t* backend, const char* root);
+bool sd_card_is_mounted();
+
+// Las tres operaciones son asíncronas: se encolan y las ejecuta el writer en orden.
+// 'path' es relativo a la raíz (nombres 8.3: CONFIG_FATFS_LFN_NONE).
+sd_file_t sd_card_open(const char* path, bool append);
+// Copia 'data' al ring. Si no hay sitio espera hasta 'timeout_ms' (back-pressure)
+// y después descarta el resto. Devuelve los bytes aceptados. No usar desde ISR.
+size_t sd_card_write(sd_file_t file, const void* data, size_t len, uint32_t timeout_ms);
+// Escribe lo pendiente del fichero (aunque no complete un cluster) y hace fsync
+void sd_card_flush(sd_file_t file);
+void sd_card_close(sd_file_t file);
+
+// Espera a que el writer vacíe el ring y sincronice todos los ficheros
+esp_err_t sd_card_drain(uint32_t timeout_ms);
+
+void sd_card_get_stats(sd_card_stats_t* out);
+void sd_card_reset_stats();
+
+// Escribe 'total_bytes' en registros de 'record_bytes' desde la tarea que llama
+// e imprime SDBENCH con latencia por llamada y throughput hasta el fsync final.
+void sd_card_benchmark(uint32_t total_bytes, uint32_t record_bytes);
+
+#endif
@@ -0,0 +1,247 @@
+#include "controllers/telemetry/telemetry.h"
+#include "controllers/display_profiler/display_profiler.h"
+#include "controllers/mem_manager/mem_manager.h"
+#include "controllers/ui_pipeline/ui_pipeline.h"
+#include "esp_check.h"
+#include "esp_console.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+
+static const char* TAG = "TELEMETRY";
+
+static const char* const metric_names[TELEM_METRIC_COUNT] = {
+    "internal_free", "internal_largest", "psram_free", "psram_largest",
+    "lv_used", "lv_frag_pct", "fps", "cpu0_pct", "cpu1_pct",
+};
+
+static esp_timer_handle_t sample_timer = nullptr;
+static SemaphoreHandle_t lock = nullptr;
+static std::atomic<bool> running{false};
+
+// El muestreo escribe en 'work' y solo bloquea para copiarlo a 'published'
+static telemetry_snapshot_t work = {};
+static telemetry_snapshot_t published = {};
+
+// Ventana circular por métrica para mín/máx/media
+static uint32_t history[TELEM_METRIC_COUNT][TELEMETRY_HISTORY];
+static uint32_t history_head = 0;
+
+#if CONFIG_FREERTOS_USE_TRACE_FACILITY && CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+// Contador de ejecución de cada tarea en la muestra anterior, por xTaskNumber
+typedef struct {
+    UBaseType_t number;
+    configRUN_TIME_COUNTER_TYPE runtime;
+} task_runtime_t;
+
+static TaskStatus_t task_status[TELEMETRY_MAX_TASKS];
+static task_runtime_t prev_runtime[TELEMETRY_MAX_TASKS];
+static uint32_t prev_count = 0;
+static configRUN_TIME_COUNTER_TYPE prev_total = 0;
+
+static configRUN_TIME_COUNTER_TYPE previous_runtime(UBaseType_t number, configRUN_TIME_COUNTER_TYPE current) {
+    for (uint32_t i = 0; i < prev_count; i++) {
+        if (prev_runtime[i].number == number) return prev_runtime[i].runtime;
+    }
+    return current; // Tarea nueva: sin historia, 0 %
+}
+
+// Estado de todas las tareas; CPU = fracción de un núcleo desde la muestra anterior
+static void sample_tasks(uint32_t* metrics) {
+    const UBaseType_t count = uxTaskGetNumberOfTasks();
+    configRUN_TIME_COUNTER_TYPE total = 0;
+    const UBaseType_t got = count <= TELEMETRY_MAX_TASKS ? uxTaskGetSystemState(task_status, TELEMETRY_MAX_TASKS, &total) : 0;
+    work.tasks_missing = count > got ? (uint8_t)(count - got) : 0;
+    if (!got) {
+        work.task_count = 0;
+        return;
+    }
+
+    const configRUN_TIME_COUNTER_TYPE elapsed = total - prev_total;
+    const TaskHandle_t idle[2] = { xTaskGetIdleTaskHandleForCore(0), xTaskGetIdleTaskHandleForCore(1) };
+    uint8_t idle_pct[2] = { 100, 100 };
+
+    for (UBaseType_t i = 0; i < got; i++) {
+        const TaskStatus_t& ts = task_status[i];
+        const configRUN_TIME_COUNTER_TYPE ran = ts.ulRunTimeCounter - previous_runtime(ts.xTaskNumber, ts.ulRunTimeCounter);
+        uint32_t pct = elapsed ? (uint32_t)((uint64_t)ran * 100 / elapsed) : 0;
+        if (pct > 100) pct = 100;
+
+        telemetry_task_t& t = work.tasks[i];
+        strlcpy(t.name, ts.pcTaskName, sizeof(t.name));
+        t.stack_free = ts.usStackHighWaterMark;   // StackType_t es de 1 byte en ESP-IDF
+        t.cpu_pct = (uint8_t)pct;
+        t.priority = (uint8_t)ts.uxCurrentPriority;
+        for (int core = 0; core < 2; core++) {
+            if (ts.xHandle == idle[core]) idle_pct[core] = (uint8_t)pct;
+        }
+
+        prev_runtime[i] = { ts.xTaskNumber, ts.ulRunTimeCounter };
+    }
+    prev_count = got;
+    prev_total = total;
+    work.task_count = (uint8_t)got;
+
+    // Pocas tareas: inserción, de más a menos CPU
+    for (uint32_t i = 1; i < work.task_count; i++) {
+        const telemetry_task_t t = work.tasks[i];
+        uint32_t j = i;
+        while (j > 0 && work.tasks[j - 1].cpu_pct < t.cpu_pct) {
+            work.tasks[j] = work.tasks[j - 1];
+            j--;
+        }
+        work.tasks[j] = t;
+    }
+
+    metrics[TELEM_CPU0] = 100 - idle_pct[0];
+    metrics[TELEM_CPU1] = 100 - idle_pct[1];
+}
+#else
+static void sample_tasks(uint32_t* metrics) {
+    // Sin CONFIG_FREERTOS_USE_TRACE_FACILITY / GENERATE_RUN_TIME_STATS no hay datos por tarea
+    work.task_count = 0;
+}
+#endif
+
+static void sample_cb(void* arg) {
+    const int64_t t_start = esp_timer_get_time();
+    uint32_t cur[TELEM_METRIC_COUNT] = {};
+
+    cur[TELEM_INTERNAL_FREE] = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    cur[TELEM_INTERNAL_LARGEST] = heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL);
+    cur[TELEM_PSRAM_FREE] = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+    cur[TELEM_PSRAM_LARGEST] = heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM);
+
+    mem_manager_stats_t mem;
+    mem_manager_get_stats(&mem);
+    cur[TELEM_LV_USED] = (mem.internal.total_bytes - mem.internal.free_bytes) + (mem.psram.total_bytes - mem.psram.free_bytes);
+    cur[TELEM_LV_FRAG] = mem.internal.frag_pct;
+    work.lv_total = mem.internal.total_bytes + mem.psram.total_bytes;
+
+    ui_pipeline_stats_t ui;
+    ui_pipeline_get_stats(&ui);
+    cur[TELEM_FPS] = ui.fps;
+
+    sample_tasks(cur);
+
+    // Ventana: se recorre entera en cada muestra (TELEMETRY_HISTORY es pequeño)
+    work.samples++;
+    work.window = work.samples < TELEMETRY_HISTORY ? work.samples : TELEMETRY_HISTORY;
+    for (int m = 0; m < TELEM_METRIC_COUNT; m++) {
+        history[m][history_head] = cur[m];
+        telemetry_value_t& v = work.metrics[m];
+        v.cur = cur[m];
+        v.min = UINT32_MAX;
+        v.max = 0;
+        uint64_t sum = 0;
+        for (uint32_t i = 0; i < work.window; i++) {
+            const uint32_t x = history[m][i];
+            if (x < v.min) v.min = x;
+            if (x > v.max) v.max = x;
+            sum += x;
+        }
+        v.avg = (uint32_t)(sum / work.window);
+    }
+    history_head = (history_head + 1) % TELEMETRY_HISTORY;
+
+    work.uptime_s = (uint32_t)(t_start / 1000000);
+    work.sample_us = (uint32_t)(esp_timer_get_time() - t_start);
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    published = work;
+    xSemaphoreGive(lock);
+}
+
+esp_err_t telemetry_init() {
+    if (running) return ESP_OK;
+
+    lock = xSemaphoreCreateMutex();
+    if (!lock) return ESP_ERR_NO_MEM;
+
+    const esp_timer_create_args_t args = {
+        .callback = sample_cb,
+        .arg = nullptr,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "telemetry",
+        .skip_unhandled_events = true,
+    };
+    ESP_RETURN_ON_ERROR(esp_timer_create(&args, &sample_timer), TAG, "timer");
+
+    // Primera muestra ya, para que la vista y la consola no empiecen vacías
+    sample_cb(nullptr);
+    ESP_RETURN_ON_ERROR(esp_timer_start_periodic(sample_timer, TELEMETRY_PERIOD_MS * 1000ULL), TAG, "start");
+    running = true;
+    ESP_LOGI(TAG, "Telemetría cada %d ms, ventana de %d muestras", TELEMETRY_PERIOD_MS, TELEMETRY_HISTORY);
+    return ESP_OK;
+}
+
+bool telemetry_is_running() {
+    return running;
+}
+
+void telemetry_get(telemetry_snapshot_t* out) {
+    if (!out) return;
+    if (!lock) {
+        *out = {};
+        return;
+    }
+    xSemaphoreTake(lock, portMAX_DELAY);
+    *out = published;
+    xSemaphoreGive(lock);
+}
+
+const char* telemetry_metric_name(telemetry_metric_t metric) {
+    return metric < TELEM_METRIC_COUNT ? metric_names[metric] : "?";
+}
+
+void telemetry_print() {
+    // static: el struct no cabe con holgura en la pila de la tarea de consola
+    static telemetry_snapshot_t snap;
+    telemetry_get(&snap);
+
+    printf("samples %lu, window %lu, uptime %lu s, sample %lu us, lv_total %lu\n",
+           (unsigned long)snap.samples, (unsigned long)snap.window, (unsigned long)snap.uptime_s,
+           (unsigned long)snap.sample_us, (unsigned long)snap.lv_total);
+    printf("%-18s %10s %10s %10s %10s\n", "metric", "cur", "min", "max", "avg");
+    for (int m = 0; m < TELEM_METRIC_COUNT; m++) {
+        const telemetry_value_t& v = snap.metrics[m];
+        printf("%-18s %10lu %10lu %10lu %10lu\n", metric_names[m], (unsigned long)v.cur,
+               (unsigned long)v.min, (unsigned long)v.max, (unsigned long)v.avg);
+    }
+    printf("%-18s %5s %10s %5s\n", "task", "cpu%", "stack_free", "prio");
+    for (uint32_t i = 0; i < snap.task_count; i++) {
+        const telemetry_task_t& t = snap.tasks[i];
+        printf("%-18s %5u %10lu %5u\n", t.name, t.cpu_pct, (unsigned long)t.stack_free, t.priority);
+    }
+    if (snap.tasks_missing) {
+        printf("(%u tasks over TELEMETRY_MAX_TASKS)\n", snap.tasks_missing);
+    }
+}
+
+static int telemetry_cmd(int argc, char** argv) {
+    telemetry_print();
+    return 0;
+}
+
+esp_err_t telemetry_console_start() {
+    esp_console_repl_t* repl = nullptr;
+    esp_console_repl_config_t repl_config = ESP_CONSOLE_REPL_CONFIG_DEFAULT();
+    repl_config.prompt = "watch>";
+    esp_console_dev_uart_config_t uart_config = ESP_CONSOLE_DEV_UART_CONFIG_DEFAULT();
+    ESP_RETURN_ON_ERROR(esp_console_new_repl_uart(&uart_config, &repl_config, &repl), TAG, "repl");
+
+    esp_console_cmd_t cmd = {};
+    cmd.command = "telemetry";
+    cmd.help = "Heap, LVGL pool, FPS, CPU and stack per task (min/max/avg over the window)";
+    cmd.func = telemetry_cmd;
+    ESP_RETURN_ON_ERROR(esp_console_cmd_register(&cmd), TAG, "cmd");
+    ESP_RETURN_ON_ERROR(display_profiler_console_register(), TAG, "dprof");
+    esp_console_register_help_command();
+
+    return esp_console_start_repl(repl);
+}
@@ -0,0 +1,68 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include "esp_err.h"
+#include "config.h"
+#include "freertos/FreeRTOS.h"
+#include <stdint.h>
+
+// Telemetría de campo. Un esp_timer de TELEMETRY_PERIOD_MS toma una muestra
+// (heap interno y PSRAM, pool de LVGL, FPS, CPU por núcleo y por tarea) y la
+// publica en un struct de tamaño fijo. Cada métrica guarda mín/máx/media de
+// las últimas TELEMETRY_HISTORY muestras. La leen SystemInfoView y el comando
+// de consola "telemetry".
+
+typedef enum {
+    TELEM_INTERNAL_FREE = 0,    // Heap interno libre (bytes)
+    TELEM_INTERNAL_LARGEST,     // Mayor bloque interno libre
+    TELEM_PSRAM_FREE,
+    TELEM_PSRAM_LARGEST,
+    TELEM_LV_USED,              // Pool de LVGL en uso (ambos tiers de mem_manager)
+    TELEM_LV_FRAG,              // Fragmentación del tier interno de LVGL (%)
+    TELEM_FPS,                  // Frames renderizados en el último segundo
+    TELEM_CPU0,                 // Carga del núcleo 0 (%, 100 - IDLE0)
+    TELEM_CPU1,
+    TELEM_METRIC_COUNT
+} telemetry_metric_t;
+
+// Valor actual y estadística de la ventana
+typedef struct {
+    uint32_t cur;
+    uint32_t min;
+    uint32_t max;
+    uint32_t avg;
+} telemetry_value_t;
+
+typedef struct {
+    char name[configMAX_TASK_NAME_LEN];
+    uint32_t stack_free;        // Marca de agua de la pila (bytes que nunca se usaron)
+    uint8_t cpu_pct;            // Porcentaje de un núcleo desde la muestra anterior
+    uint8_t priority;
+} telemetry_task_t;
+
+typedef struct {
+    uint32_t samples;           // Muestras tomadas desde telemetry_init
+    uint32_t window;            // Muestras en la ventana (hasta TELEMETRY_HISTORY)
+    uint32_t uptime_s;
+    uint32_t lv_total;          // Tamaño total del pool de LVGL
+    uint32_t sample_us;         // Coste de la última muestra
+    telemetry_value_t metrics[TELEM_METRIC_COUNT];
+    uint8_t task_count;         // Tareas en 'tasks', de más a menos CPU
+    uint8_t tasks_missing;      // Tareas que no cupieron en TELEMETRY_MAX_TASKS
+    telemetry_task_t tasks[TELEMETRY_MAX_TASKS];
+} telemetry_snapshot_t;
+
+esp_err_t telemetry_init();
+bool telemetry_is_running();
+
+// Copia la última muestra. Thread-safe: solo espera a la copia, no al muestreo.
+void telemetry_get(telemetry_snapshot_t* out);
+const char* telemetry_metric_name(telemetry_metric_t metric);
+
+// Vuelca la última muestra por consola
+void telemetry_print();
+
+// REPL por la consola del sistema con el comando "telemetry"
+esp_err_t telemetry_console_start();
+
+#endif
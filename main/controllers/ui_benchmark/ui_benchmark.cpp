@@ -0,0 +1,281 @@
+#include "controllers/ui_benchmark/ui_benchmark.h"
+#include "controllers/button_manager/button_manager.h"
+#include "controllers/draw_accel/draw_accel.h"
+#include "controllers/fs_manager/fs_manager.h"
+#include "controllers/mem_manager/mem_manager.h"
+#include "controllers/screen_manager/nav_snapshot.h"
+#include "views/theme/theme.h"
+#include "views/widgets/virtual_list/virtual_list.h"
+#include "esp_random.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <cstdio>
+
+static const char* TAG = "UI_BENCH";
+
+// Entradas que cada vista atiende sin salir de ella. Se inyectan por
+// button_manager como una pulsación real, una cada UI_BENCHMARK_INPUT_FRAMES frames.
+static const button_id_t clock_inputs[] = { BUTTON_OK };
+static const button_id_t settings_inputs[] = { BUTTON_RIGHT, BUTTON_RIGHT, BUTTON_LEFT, BUTTON_LEFT };
+static const button_id_t spectrum_inputs[] = { BUTTON_OK };
+
+typedef struct {
+    view_id_t view;
+    const button_id_t* inputs;
+    uint8_t input_count;
+} bench_view_t;
+
+#define BENCH_VIEW(view, inputs) { view, inputs, sizeof(inputs) / sizeof(inputs[0]) }
+
+static const bench_view_t bench_views[] = {
+    { VIEW_BOOT, nullptr, 0 },
+    BENCH_VIEW(VIEW_CLOCK, clock_inputs),
+    BENCH_VIEW(VIEW_SETTINGS, settings_inputs),
+    { VIEW_SYSTEM_INFO, nullptr, 0 },
+    BENCH_VIEW(VIEW_SPECTRUM, spectrum_inputs),
+};
+
+static uint64_t invalidated_px = 0;
+
+static void bench_invalidate_cb(lv_event_t* e) {
+    const lv_area_t* area = (const lv_area_t*)lv_event_get_param(e);
+    if (area) {
+        invalidated_px += lv_area_get_size(area);
+    }
+}
+
+static uint32_t bench_lv_heap_used() {
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    return mon.total_size - mon.free_size;
+}
+
+// Espera a que el último strip termine de salir por el bus para que los
+// contadores de flush reflejen el frame completo.
+static void bench_wait_flush_idle(screen_t* screen) {
+    while (screen->flush_pending) {
+        vTaskDelay(1);
+    }
+}
+
+static const bench_view_t* bench_find_view(view_id_t view) {
+    for (const bench_view_t& b : bench_views) {
+        if (b.view == view) return &b;
+    }
+    return nullptr;
+}
+
+void ui_benchmark_run_view(screen_t* screen, view_id_t view, uint32_t frames, ui_benchmark_result_t* out) {
+    *out = {};
+    out->view = screen_get_view_name(view);
+    const bench_view_t* bench = bench_find_view(view);
+
+    // Construcción + primer frame completo
+    bench_wait_flush_idle(screen);
+    lv_display_add_event_cb(screen->lvgl_disp, bench_invalidate_cb, LV_EVENT_INVALIDATE_AREA, nullptr);
+    int64_t t_start = esp_timer_get_time();
+    switch_screen(view);
+    lv_refr_now(screen->lvgl_disp);
+    bench_wait_flush_idle(screen);
+    out->build_us = (uint32_t)(esp_timer_get_time() - t_start);
+    out->lv_heap_peak = bench_lv_heap_used();
+
+    // Frames medidos: la vista corre con sus timers y sus entradas, al ritmo de
+    // UI_BENCHMARK_FRAME_MS. Solo se redibuja lo que ella misma invalida. Si la
+    // vista se va por su cuenta (Boot pasa a Clock) la medida termina ahí.
+    screen_flush_stats_t before, after;
+    screen_get_flush_stats(screen, &before);
+    invalidated_px = 0;
+    uint64_t render_total_us = 0;
+    uint32_t next_input = 0;
+    TickType_t last_wake = xTaskGetTickCount();
+
+    for (uint32_t i = 0; i < frames && screen_get_current_view() == view; i++) {
+        if (bench && bench->input_count && i % UI_BENCHMARK_INPUT_FRAMES == UI_BENCHMARK_INPUT_FRAMES - 1) {
+            if (button_manager_inject(bench->inputs[next_input % bench->input_count])) {
+                next_input++;
+            }
+        }
+
+        screen_flush_stats_t frame_before, frame_after;
+        screen_get_flush_stats(screen, &frame_before);
+
+        t_start = esp_timer_get_time();
+        button_manager_process_events();
+        lv_timer_handler();
+        const uint32_t elapsed = (uint32_t)(esp_timer_get_time() - t_start);
+
+        screen_get_flush_stats(screen, &frame_after);
+        const uint32_t stall = (uint32_t)(frame_after.stall_us - frame_before.stall_us);
+        const uint32_t render_us = elapsed > stall ? elapsed - stall : 0;
+
+        out->frames++;
+        if (frame_after.flush_count != frame_before.flush_count) {
+            out->dirty_frames++;
+        }
+        render_total_us += render_us;
+        if (render_us > out->render_us_max) {
+            out->render_us_max = render_us;
+        }
+
+        const uint32_t used = bench_lv_heap_used();
+        if (used > out->lv_heap_peak) {
+            out->lv_heap_peak = used;
+        }
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(UI_BENCHMARK_FRAME_MS));
+    }
+    bench_wait_flush_idle(screen);
+    lv_display_remove_event_cb_with_user_data(screen->lvgl_disp, bench_invalidate_cb, nullptr);
+
+    screen_get_flush_stats(screen, &after);
+    out->inputs = next_input;
+    out->render_us_avg = out->frames ? (uint32_t)(render_total_us / out->frames) : 0;
+    out->invalidated_px = invalidated_px;
+    out->flushed_bytes = after.flushed_bytes - before.flushed_bytes;
+}
+
+void ui_benchmark_run(screen_t* screen, uint32_t frames) {
+    ESP_LOGI(TAG, "Benchmark de vistas: %lu frames por vista", (unsigned long)frames);
+
+    // Formato estable para poder comparar entre versiones (grep "^BENCH,")
+    printf("BENCH,view,frames,build_us,render_us_avg,render_us_max,dirty_frames,inputs,invalidated_px,flushed_bytes,lv_heap_peak\n");
+    for (const bench_view_t& b : bench_views) {
+        ui_benchmark_result_t r;
+        ui_benchmark_run_view(screen, b.view, frames, &r);
+        printf("BENCH,%s,%lu,%lu,%lu,%lu,%lu,%lu,%llu,%llu,%lu\n",
+               r.view, (unsigned long)r.frames, (unsigned long)r.build_us,
+               (unsigned long)r.render_us_avg, (unsigned long)r.render_us_max,
+               (unsigned long)r.dirty_frames, (unsigned long)r.inputs,
+               (unsigned long long)r.invalidated_px, (unsigned long long)r.flushed_bytes,
+               (unsigned long)r.lv_heap_peak);
+    }
+
+#if DRAW_ACCEL_ENABLED
+    draw_accel_benchmark(SCREEN_WIDTH * SCREEN_STRIP_LINES);
+#endif
+    if (fs_manager_is_mounted()) {
+        fs_manager_benchmark(FS_ASSET_BENCH_ITERATIONS);
+    }
+    ESP_LOGI(TAG, "Benchmark terminado");
+}
+
+void ui_benchmark_style_audit(screen_t* screen, uint32_t rounds) {
+    printf("STYLEAUDIT,view,objs,local_objs,local_props,lookups,resolve_ns_avg,lv_heap_used\n");
+    for (const bench_view_t& b : bench_views) {
+        const view_id_t view = b.view;
+        bench_wait_flush_idle(screen);
+        switch_screen(view);
+        lv_refr_now(screen->lvgl_disp);
+
+        theme_audit_t a;
+        theme_audit(lv_screen_active(), rounds, &a);
+        printf("STYLEAUDIT,%s,%lu,%lu,%lu,%lu,%lu,%lu\n", screen_get_view_name(view),
+               (unsigned long)a.objs, (unsigned long)a.local_objs, (unsigned long)a.local_props,
+               (unsigned long)a.lookups, (unsigned long)a.resolve_ns_avg, (unsigned long)bench_lv_heap_used());
+    }
+    bench_wait_flush_idle(screen);
+}
+
+static const int32_t BENCH_VLIST_ROW_HEIGHT = 40;
+
+static void bench_bind_item(uint32_t index, char* title, char* value, size_t cap, void* user) {
+    snprintf(title, cap, "Item %lu", (unsigned long)index);
+    snprintf(value, cap, "%lu", (unsigned long)(index * 7 % 1000));
+}
+
+void ui_benchmark_virtual_list(screen_t* screen, uint32_t items, uint32_t frames) {
+    ESP_LOGI(TAG, "Benchmark de lista virtual: %lu elementos", (unsigned long)items);
+
+    lv_obj_t* previous = lv_screen_active();
+    lv_obj_t* bench_screen = lv_obj_create(nullptr);
+    lv_obj_clear_flag(bench_screen, LV_OBJ_FLAG_SCROLLABLE);
+    {
+        VirtualList list(bench_screen, SCREEN_WIDTH, SCREEN_HEIGHT, BENCH_VLIST_ROW_HEIGHT, bench_bind_item, nullptr);
+        list.set_count(items);
+        lv_screen_load(bench_screen);
+        lv_refr_now(screen->lvgl_disp);
+        bench_wait_flush_idle(screen);
+
+        printf("VLISTBENCH,mode,items,frames,pool_rows,binds,layout_us_avg,render_us_avg,render_us_max,lv_heap_start,lv_heap_end,lv_heap_peak\n");
+        for (int mode = 0; mode < 2; mode++) {
+            const uint32_t heap_start = bench_lv_heap_used();
+            const uint32_t binds_start = list.get_bind_count();
+            uint32_t heap_peak = heap_start;
+            uint64_t layout_total_us = 0;
+            uint64_t render_total_us = 0;
+            uint32_t render_max_us = 0;
+
+            for (uint32_t i = 0; i < frames; i++) {
+                // Modo 0: desplazamiento continuo (una fila nueva cada pocos frames).
+                // Modo 1: saltos a cualquier punto (todas las filas se reasignan).
+                const int32_t target = mode == 0 ? list.get_scroll() + VLIST_BENCH_STEP_PX
+                                                 : (int32_t)(esp_random() % items) * BENCH_VLIST_ROW_HEIGHT;
+                int64_t t_start = esp_timer_get_time();
+                list.scroll_to(target);
+                layout_total_us += (uint64_t)(esp_timer_get_time() - t_start);
+
+                screen_flush_stats_t frame_before, frame_after;
+                screen_get_flush_stats(screen, &frame_before);
+                t_start = esp_timer_get_time();
+                lv_refr_now(screen->lvgl_disp);
+                const uint32_t elapsed = (uint32_t)(esp_timer_get_time() - t_start);
+                screen_get_flush_stats(screen, &frame_after);
+                const uint32_t stall = (uint32_t)(frame_after.stall_us - frame_before.stall_us);
+                const uint32_t render_us = elapsed > stall ? elapsed - stall : 0;
+
+                render_total_us += render_us;
+                if (render_us > render_max_us) {
+                    render_max_us = render_us;
+                }
+                const uint32_t used = bench_lv_heap_used();
+                if (used > heap_peak) {
+                    heap_peak = used;
+                }
+            }
+            bench_wait_flush_idle(screen);
+
+            printf("VLISTBENCH,%s,%lu,%lu,%u,%lu,%lu,%lu,%lu,%lu,%lu,%lu\n",
+                   mode == 0 ? "scroll" : "jump", (unsigned long)items, (unsigned long)frames,
+                   (unsigned)list.get_row_pool(), (unsigned long)(list.get_bind_count() - binds_start),
+                   (unsigned long)(frames ? layout_total_us / frames : 0),
+                   (unsigned long)(frames ? render_total_us / frames : 0), (unsigned long)render_max_us,
+                   (unsigned long)heap_start, (unsigned long)bench_lv_heap_used(), (unsigned long)heap_peak);
+        }
+
+        lv_screen_load(previous);
+        lv_obj_delete(bench_screen);    // También borra los objetos de la lista
+    }
+    lv_refr_now(screen->lvgl_disp);
+    bench_wait_flush_idle(screen);
+}
+
+void ui_benchmark_stress_switch(screen_t* screen, uint32_t cycles, uint32_t report_every) {
+    static const view_id_t cycle_views[] = { VIEW_CLOCK, VIEW_SETTINGS, VIEW_SYSTEM_INFO };
+    const size_t num_views = sizeof(cycle_views) / sizeof(cycle_views[0]);
+
+    ESP_LOGI(TAG, "Stress de cambios de vista: %lu ciclos", (unsigned long)cycles);
+    screen_set_view_cache_budget(0);
+    nav_snapshot_set_budget(0);
+
+    printf("MEMSTRESS,cycle,int_free,int_largest,int_frag,psram_free,psram_largest,psram_frag,arenas_live,system_bytes\n");
+    for (uint32_t i = 1; i <= cycles; i++) {
+        switch_screen(cycle_views[i % num_views]);
+        lv_refr_now(screen->lvgl_disp);
+        bench_wait_flush_idle(screen);
+
+        if (i % report_every == 0 || i == cycles) {
+            mem_manager_stats_t st;
+            mem_manager_get_stats(&st);
+            printf("MEMSTRESS,%lu,%u,%u,%u,%u,%u,%u,%lu,%u\n", (unsigned long)i,
+                   (unsigned)st.internal.free_bytes, (unsigned)st.internal.largest_free_block, st.internal.frag_pct,
+                   (unsigned)st.psram.free_bytes, (unsigned)st.psram.largest_free_block, st.psram.frag_pct,
+                   (unsigned long)st.arenas_live, (unsigned)st.system_bytes);
+        }
+    }
+
+    screen_set_view_cache_budget(VIEW_CACHE_BUDGET_BYTES);
+    nav_snapshot_set_budget(NAV_SNAPSHOT_BUDGET_BYTES);
+    mem_manager_log_stats();
+}
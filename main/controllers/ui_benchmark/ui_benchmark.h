@@ -0,0 +1,42 @@
+#ifndef UI_BENCHMARK_H
+#define UI_BENCHMARK_H
+
+#include "controllers/screen_manager/screen_manager.h"
+
+typedef struct {
+    const char* view;
+    uint32_t frames;            // Frames medidos (menos si la vista se fue antes)
+    uint32_t build_us;          // Construcción de la vista + primer frame completo
+    uint32_t render_us_avg;     // Botones + timers + render por frame, sin esperas de DMA
+    uint32_t render_us_max;
+    uint32_t dirty_frames;      // Frames en los que la vista invalidó algo y hubo flush
+    uint32_t inputs;            // Pulsaciones inyectadas
+    uint64_t invalidated_px;    // Píxeles invalidados durante los frames medidos
+    uint64_t flushed_bytes;     // Bytes enviados al panel durante los frames medidos
+    uint32_t lv_heap_peak;      // Pico de uso del heap de LVGL durante la medida
+} ui_benchmark_result_t;
+
+// Recorre todas las vistas, deja correr cada una 'frames' frames con sus timers
+// y su script de botones, y escribe una línea CSV por vista. Debe llamarse antes
+// de ui_pipeline_start (usa LVGL directamente).
+void ui_benchmark_run(screen_t* screen, uint32_t frames);
+
+// Mide una sola vista y deja el resultado en 'out'.
+void ui_benchmark_run_view(screen_t* screen, view_id_t view, uint32_t frames, ui_benchmark_result_t* out);
+
+// Auditoría de estilos de cada vista (ver views/theme): propiedades locales y
+// coste medio de resolver una propiedad al dibujar. Una línea CSV por vista.
+void ui_benchmark_style_audit(screen_t* screen, uint32_t rounds);
+
+// Desplaza una VirtualList de 'items' elementos durante 'frames' frames a
+// VLIST_BENCH_STEP_PX por frame y luego hace 'frames' saltos aleatorios. Una
+// línea CSV por modo con coste de bind/maquetado, render y heap de LVGL al
+// principio y al final (debe ser el mismo: la memoria no depende de 'items').
+void ui_benchmark_virtual_list(screen_t* screen, uint32_t items, uint32_t frames);
+
+// Cambia de vista 'cycles' veces sin caché ni snapshots (cada cambio construye
+// y destruye una vista) y escribe cada 'report_every' ciclos una línea CSV con
+// el estado del heap de LVGL, para ver si la fragmentación crece.
+void ui_benchmark_stress_switch(screen_t* screen, uint32_t cycles, uint32_t report_every);
+
+#endif
@@ -0,0 +1,380 @@
+#include "controllers/ui_pipeline/ui_pipeline.h"
+#include "config.h"
+#include "controllers/display_profiler/display_profiler.h"
+#include "controllers/button_manager/button_manager.h"
+#include "controllers/draw_accel/draw_accel.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_check.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "esp_pm.h"
+#include <atomic>
+#include <cstring>
+
+static const char* TAG = "UI_PIPELINE";
+
+#define UI_RENDER_TASK_STACK   8192
+#define UI_FLUSH_TASK_STACK    4096
+#define UI_RENDER_TASK_PRIO    5
+#define UI_FLUSH_TASK_PRIO     6   // Por encima del render: un strip listo sale al bus cuanto antes
+#define UI_STATS_WINDOW_US     1000000
+
+typedef struct {
+    lv_area_t area;
+    uint8_t* px_map;
+    bool frame_end;     // Último área del frame (lv_display_flush_is_last)
+} ui_strip_t;
+
+static screen_t* ui_screen = nullptr;
+static QueueHandle_t strip_queue = nullptr;
+static std::atomic<uint32_t> fps_cap{UI_FPS_CAP_DEFAULT};
+
+// Modo PARTIAL: cada strip se copia a un slot propio y el buffer de LVGL se
+// libera al momento, así que hasta UI_STRIP_SLOTS strips pueden estar
+// renderizados y pendientes de salir mientras LVGL sigue con el siguiente.
+// En los modos PSRAM (frames completos) no se copia: manda el doble buffer de LVGL.
+static QueueHandle_t free_slots = nullptr;
+static uint8_t* slots[UI_STRIP_SLOTS] = {};
+static uint32_t slot_count = 0;
+
+// Contadores de la ventana actual
+static std::atomic<uint32_t> flush_busy_us{0};
+static std::atomic<uint32_t> flush_stall_us{0};
+static std::atomic<uint32_t> rendered_frames{0};
+static std::atomic<uint32_t> in_flight{0};     // Strips entregados por LVGL y aún no enviados
+static std::atomic<uint32_t> in_flight_max{0};
+
+// Último resultado publicado, protegido por spinlock
+static portMUX_TYPE stats_lock = portMUX_INITIALIZER_UNLOCKED;
+static ui_pipeline_stats_t stats = {};
+static ui_power_stats_t power_stats = {};
+
+#if CONFIG_PM_ENABLE
+// Mientras se renderiza la CPU va a máxima frecuencia; al dormir se suelta
+static esp_pm_lock_handle_t render_pm_lock = nullptr;
+#endif
+
+static void ui_render_awake(bool awake) {
+#if CONFIG_PM_ENABLE
+    if (awake) {
+        esp_pm_lock_acquire(render_pm_lock);
+    } else {
+        esp_pm_lock_release(render_pm_lock);
+    }
+#endif
+}
+
+static void ui_note_in_flight() {
+    const uint32_t depth = ++in_flight;
+    uint32_t max = in_flight_max.load(std::memory_order_relaxed);
+    while (depth > max && !in_flight_max.compare_exchange_weak(max, depth, std::memory_order_relaxed)) {
+    }
+}
+
+// Sin slots: el strip se encola y la tarea de flush del otro núcleo lo envía.
+// flush_pending se marca aquí para que el wait_cb de LVGL no vea el buffer como
+// libre antes de que el strip salga de la cola. Con dos buffers de LVGL, como
+// mucho hay uno en vuelo mientras se renderiza el otro.
+static void ui_pipeline_flush_cb(lv_display_t* disp, const lv_area_t* area, uint8_t* px_map) {
+    ui_screen->flush_pending = true;
+
+    const ui_strip_t strip = { *area, px_map, lv_display_flush_is_last(disp) };
+    ui_note_in_flight();
+    xQueueSend(strip_queue, &strip, portMAX_DELAY);
+}
+
+// Con slots: copia a un slot libre (con el intercambio de bytes si hace falta,
+// en la misma pasada) y devuelve el buffer a LVGL sin esperar al bus. Solo se
+// bloquea si los UI_STRIP_SLOTS slots están en vuelo; esa espera cuenta como stall.
+static void ui_pipeline_slot_flush_cb(lv_display_t* disp, const lv_area_t* area, uint8_t* px_map) {
+    uint8_t* slot = nullptr;
+    if (xQueueReceive(free_slots, &slot, 0) != pdTRUE) {
+        const int64_t t_start = esp_timer_get_time();
+        xQueueReceive(free_slots, &slot, portMAX_DELAY);
+        const uint32_t stall = (uint32_t)(esp_timer_get_time() - t_start);
+        ui_screen->flush_stats.stall_us += stall;
+        if (stall > ui_screen->flush_stats.max_stall_us) {
+            ui_screen->flush_stats.max_stall_us = stall;
+        }
+    }
+
+    const uint32_t px = lv_area_get_size(area);
+#if SCREEN_RGB565_SWAP
+    draw_accel_swap_copy_rgb565((uint16_t*)slot, (const uint16_t*)px_map, px);
+#else
+    memcpy(slot, px_map, px * SCREEN_BYTES_PER_PIXEL);
+#endif
+    const ui_strip_t strip = { *area, slot, lv_display_flush_is_last(disp) };
+    lv_display_flush_ready(disp);
+
+    ui_note_in_flight();
+    xQueueSend(strip_queue, &strip, portMAX_DELAY);
+}
+
+static void ui_pipeline_render_ready_cb(lv_event_t* e) {
+    rendered_frames++;
+}
+
+static void ui_flush_task(void* arg) {
+    ui_strip_t strip;
+    while (true) {
+        if (xQueueReceive(strip_queue, &strip, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+        // Ocupada: desde que toma el strip hasta lanzar el último draw_bitmap.
+        // Lo que espera al bus (fin de DMA o un bounce libre) va aparte.
+        const int64_t t_start = esp_timer_get_time();
+        const uint64_t bounce_wait_before = ui_screen->bounce_wait_us;
+        int64_t t_issued;
+        if (free_slots) {
+            // El slot vuelve a estar libre cuando el DMA termina de leerlo
+            screen_flush_buffer(ui_screen, &strip.area, strip.px_map, strip.frame_end);
+            t_issued = esp_timer_get_time();
+            screen_flush_wait(ui_screen);
+            xQueueSend(free_slots, &strip.px_map, 0);
+        } else {
+            screen_flush_area(ui_screen, &strip.area, strip.px_map, strip.frame_end);
+            t_issued = esp_timer_get_time();
+        }
+        in_flight--;
+        const int64_t t_end = esp_timer_get_time();
+        const uint32_t bounce_wait_us = (uint32_t)(ui_screen->bounce_wait_us - bounce_wait_before);
+        flush_busy_us += (uint32_t)(t_issued - t_start) - bounce_wait_us;
+        flush_stall_us += (uint32_t)(t_end - t_issued) + bounce_wait_us;
+    }
+}
+
+// Tiempo acumulado de la tarea IDLE de un núcleo (µs, reloj de esp_timer)
+static bool ui_idle_runtime(int core, uint32_t* out) {
+#if CONFIG_FREERTOS_USE_TRACE_FACILITY && CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+    TaskStatus_t status;
+    vTaskGetInfo(xTaskGetIdleTaskHandleForCore(core), &status, pdFALSE, eRunning);
+    *out = (uint32_t)status.ulRunTimeCounter;
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Ocupación de un núcleo en la ventana: todo lo que no fue su tarea IDLE
+static uint8_t ui_core_busy_pct(uint32_t idle_before, uint32_t idle_after, int64_t window_us) {
+    const uint32_t idle_us = idle_after - idle_before;
+    return idle_us >= window_us ? 0 : (uint8_t)(100 - (uint64_t)idle_us * 100 / window_us);
+}
+
+// Reserva los slots de strip en RAM interna DMA. Si no caben se sigue sin ellos.
+static void ui_alloc_slots(screen_t* screen) {
+    if (screen->render_cfg.mode != SCREEN_RENDER_PARTIAL) {
+        return;
+    }
+    const size_t slot_bytes = SCREEN_WIDTH * screen->render_cfg.strip_lines * SCREEN_BYTES_PER_PIXEL;
+    free_slots = xQueueCreate(UI_STRIP_SLOTS, sizeof(uint8_t*));
+    for (uint32_t i = 0; free_slots && i < UI_STRIP_SLOTS; i++) {
+        slots[i] = (uint8_t*)heap_caps_malloc(slot_bytes, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+        if (!slots[i]) break;
+        xQueueSend(free_slots, &slots[i], 0);
+        slot_count++;
+    }
+    if (slot_count < 2) {
+        ESP_LOGW(TAG, "Sin RAM DMA para los slots de strip: como mucho un strip en vuelo");
+        for (uint32_t i = 0; i < slot_count; i++) {
+            heap_caps_free(slots[i]);
+            slots[i] = nullptr;
+        }
+        slot_count = 0;
+        if (free_slots) vQueueDelete(free_slots);
+        free_slots = nullptr;
+    }
+}
+
+// Cuánto puede dormir la tarea de render: hasta el próximo timer de LVGL (o
+// UI_IDLE_MAX_SLEEP_MS si no hay ninguno), pero nunca menos que lo que queda
+// del periodo del frame para respetar el límite de FPS.
+static uint32_t ui_render_sleep_ms(uint32_t until_next_ms, uint32_t elapsed_us) {
+    const uint32_t period_ms = 1000 / fps_cap.load();
+    const uint32_t elapsed_ms = elapsed_us / 1000;
+    const uint32_t frame_left_ms = elapsed_ms < period_ms ? period_ms - elapsed_ms : 0;
+
+    uint32_t sleep_ms = until_next_ms == LV_NO_TIMER_READY ? UI_IDLE_MAX_SLEEP_MS
+                                                           : LV_MIN(until_next_ms, UI_IDLE_MAX_SLEEP_MS);
+    return sleep_ms > frame_left_ms ? sleep_ms : frame_left_ms;
+}
+
+static void ui_render_task(void* arg) {
+    int64_t window_start = esp_timer_get_time();
+    uint32_t idle_start[2] = {};
+    const bool idle_stats = ui_idle_runtime(0, &idle_start[0]) && ui_idle_runtime(1, &idle_start[1]);
+    uint64_t window_busy_us = 0;
+    uint32_t window_iterations = 0;
+    uint32_t window_max_us = 0;
+
+    while (true) {
+        ui_render_awake(true);
+        const int64_t t_start = esp_timer_get_time();
+
+        DISPLAY_PROFILER_FRAME_BEGIN();
+        button_manager_process_events(); // Los handlers corren aquí, nunca en el contexto de iot_button
+        const uint32_t until_next_ms = lv_timer_handler();
+        DISPLAY_PROFILER_FRAME_END(1000000 / fps_cap.load());
+
+        const int64_t t_end = esp_timer_get_time();
+        const uint32_t elapsed_us = (uint32_t)(t_end - t_start);
+        window_busy_us += elapsed_us;
+        window_iterations++;
+        if (elapsed_us > window_max_us) {
+            window_max_us = elapsed_us;
+        }
+
+        // Publicar estadísticas una vez por ventana
+        const int64_t window_us = t_end - window_start;
+        if (window_us >= UI_STATS_WINDOW_US) {
+            const uint32_t frames = rendered_frames.exchange(0);
+            const uint32_t flush_us = flush_busy_us.exchange(0);
+            const uint32_t flush_stall = flush_stall_us.exchange(0);
+            uint32_t idle_now[2] = {};
+            if (idle_stats) {
+                ui_idle_runtime(0, &idle_now[0]);
+                ui_idle_runtime(1, &idle_now[1]);
+            }
+
+            taskENTER_CRITICAL(&stats_lock);
+            stats.fps = (uint32_t)((uint64_t)frames * 1000000 / window_us);
+            stats.frames += frames;
+            stats.frame_time_avg_us = (uint32_t)(window_busy_us / window_iterations);
+            stats.frame_time_max_us = window_max_us;
+            stats.render_task_busy_pct = (uint8_t)(window_busy_us * 100 / window_us);
+            stats.flush_task_busy_pct = (uint8_t)((uint64_t)flush_us * 100 / window_us);
+            stats.flush_task_stall_pct = (uint8_t)((uint64_t)flush_stall * 100 / window_us);
+            if (idle_stats) {
+                stats.render_core_busy_pct = ui_core_busy_pct(idle_start[UI_RENDER_CORE], idle_now[UI_RENDER_CORE], window_us);
+                stats.flush_core_busy_pct = ui_core_busy_pct(idle_start[UI_FLUSH_CORE], idle_now[UI_FLUSH_CORE], window_us);
+            }
+            taskEXIT_CRITICAL(&stats_lock);
+            idle_start[0] = idle_now[0];
+            idle_start[1] = idle_now[1];
+
+            window_start = t_end;
+            window_busy_us = 0;
+            window_iterations = 0;
+            window_max_us = 0;
+        }
+
+        taskENTER_CRITICAL(&stats_lock);
+        stats.frame_time_us = elapsed_us;
+        taskEXIT_CRITICAL(&stats_lock);
+
+        // Sin tick periódico: se duerme hasta el próximo deadline o hasta que un
+        // botón notifique a la tarea. Con la pantalla estática el sistema puede
+        // entrar en light sleep durante toda la espera.
+        const uint32_t sleep_ms = ui_render_sleep_ms(until_next_ms, elapsed_us);
+        const TickType_t sleep_ticks = pdMS_TO_TICKS(sleep_ms);
+        ui_render_awake(false);
+        const bool by_input = ulTaskNotifyTake(pdTRUE, sleep_ticks ? sleep_ticks : 1) > 0; // Ceder siempre al menos un tick
+        const uint32_t slept_us = (uint32_t)(esp_timer_get_time() - t_end);
+
+        taskENTER_CRITICAL(&stats_lock);
+        power_stats.active_us += elapsed_us;
+        power_stats.idle_us += slept_us;
+        power_stats.wakeups++;
+        if (by_input) {
+            power_stats.wakeups_input++;
+        } else {
+            power_stats.wakeups_deadline++;
+        }
+        power_stats.last_sleep_ms = sleep_ms;
+        if (sleep_ms > power_stats.max_sleep_ms) {
+            power_stats.max_sleep_ms = sleep_ms;
+        }
+        taskEXIT_CRITICAL(&stats_lock);
+    }
+}
+
+esp_err_t ui_pipeline_start(screen_t* screen) {
+    if (!screen || ui_screen) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    ui_screen = screen;
+
+    ui_alloc_slots(screen);
+    // La cola nunca llena: caben todos los strips que pueden estar en vuelo
+    strip_queue = xQueueCreate(slot_count ? slot_count : 2, sizeof(ui_strip_t));
+    if (!strip_queue) {
+        ESP_LOGE(TAG, "No se pudo crear la cola de strips");
+        return ESP_ERR_NO_MEM;
+    }
+
+#if CONFIG_PM_ENABLE
+    const esp_pm_config_t pm_config = {
+        .max_freq_mhz = CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ,
+        .min_freq_mhz = UI_PM_MIN_FREQ_MHZ,
+        .light_sleep_enable = UI_LIGHT_SLEEP_ENABLED != 0,
+    };
+    ESP_RETURN_ON_ERROR(esp_pm_configure(&pm_config), TAG, "esp_pm_configure");
+    ESP_RETURN_ON_ERROR(esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "ui_render", &render_pm_lock), TAG, "pm lock");
+#endif
+
+    lv_display_set_flush_cb(screen->lvgl_disp, free_slots ? ui_pipeline_slot_flush_cb : ui_pipeline_flush_cb);
+    lv_display_add_event_cb(screen->lvgl_disp, ui_pipeline_render_ready_cb, LV_EVENT_RENDER_READY, nullptr);
+    stats.fps_cap = fps_cap.load();
+
+    if (xTaskCreatePinnedToCore(ui_flush_task, "ui_flush", UI_FLUSH_TASK_STACK, nullptr,
+                                UI_FLUSH_TASK_PRIO, nullptr, UI_FLUSH_CORE) != pdPASS) {
+        ESP_LOGE(TAG, "No se pudo crear la tarea de flush");
+        return ESP_ERR_NO_MEM;
+    }
+    TaskHandle_t render_task = nullptr;
+    if (xTaskCreatePinnedToCore(ui_render_task, "ui_render", UI_RENDER_TASK_STACK, nullptr,
+                                UI_RENDER_TASK_PRIO, &render_task, UI_RENDER_CORE) != pdPASS) {
+        ESP_LOGE(TAG, "No se pudo crear la tarea de render");
+        return ESP_ERR_NO_MEM;
+    }
+    button_manager_set_wakeup_task(render_task);
+
+    ESP_LOGI(TAG, "Pipeline iniciado: render en core %d, flush en core %d, %lu FPS, %lu slots de strip",
+             UI_RENDER_CORE, UI_FLUSH_CORE, (unsigned long)fps_cap.load(), (unsigned long)slot_count);
+    return ESP_OK;
+}
+
+void ui_pipeline_set_fps_cap(uint32_t fps) {
+    if (fps == 0 || fps > 1000) {
+        ESP_LOGE(TAG, "FPS cap fuera de rango: %lu", (unsigned long)fps);
+        return;
+    }
+    fps_cap = fps;
+
+    taskENTER_CRITICAL(&stats_lock);
+    stats.fps_cap = fps;
+    taskEXIT_CRITICAL(&stats_lock);
+}
+
+void ui_pipeline_get_stats(ui_pipeline_stats_t* out) {
+    if (!out) return;
+
+    taskENTER_CRITICAL(&stats_lock);
+    *out = stats;
+    taskEXIT_CRITICAL(&stats_lock);
+
+    out->strip_slots = slot_count;
+    out->queue_depth = in_flight.load();
+    out->queue_depth_max = in_flight_max.load();
+}
+
+void ui_pipeline_get_power_stats(ui_power_stats_t* out) {
+    if (!out) return;
+
+    taskENTER_CRITICAL(&stats_lock);
+    *out = power_stats;
+    taskEXIT_CRITICAL(&stats_lock);
+
+    const uint64_t total_us = out->active_us + out->idle_us;
+    out->idle_pct = total_us ? (uint8_t)(out->idle_us * 100 / total_us) : 0;
+}
+
+void ui_pipeline_reset_power_stats() {
+    taskENTER_CRITICAL(&stats_lock);
+    power_stats = {};
+    taskEXIT_CRITICAL(&stats_lock);
+}
@@ -0,0 +1,44 @@
+#ifndef UI_PIPELINE_H
+#define UI_PIPELINE_H
+
+#include "esp_err.h"
+#include "controllers/screen_manager/screen_manager.h"
+
+typedef struct {
+    uint32_t fps_cap;               // Límite de frames por segundo configurado
+    uint32_t fps;                   // Frames renderizados en la última ventana de 1 s
+    uint32_t frames;                // Frames renderizados desde el arranque
+    uint32_t frame_time_us;         // Duración del último lv_timer_handler()
+    uint32_t frame_time_avg_us;     // Media de la última ventana
+    uint32_t frame_time_max_us;     // Máximo de la última ventana
+    uint32_t strip_slots;           // Copias de strip disponibles (0 = doble buffer de LVGL)
+    uint32_t queue_depth;           // Strips renderizados y aún sin terminar de enviar
+    uint32_t queue_depth_max;       // Máximo alcanzado desde el arranque
+    uint8_t render_core_busy_pct;   // Ocupación de UI_RENDER_CORE (100 - tarea IDLE), todas las tareas
+    uint8_t flush_core_busy_pct;    // Ocupación de UI_FLUSH_CORE (100 - tarea IDLE)
+    uint8_t render_task_busy_pct;   // Parte de la ventana que la tarea de render estuvo despierta
+    uint8_t flush_task_busy_pct;    // Parte de la ventana entre tomar un strip y lanzar su draw_bitmap
+    uint8_t flush_task_stall_pct;   // Parte de la ventana que la tarea de flush esperó al bus
+} ui_pipeline_stats_t;
+
+// Dónde pasa el tiempo la tarea de render (residencia y despertares)
+typedef struct {
+    uint64_t active_us;             // Despierta ejecutando handlers y lv_timer_handler
+    uint64_t idle_us;               // Bloqueada esperando deadline o entrada (el chip puede estar en light sleep)
+    uint32_t wakeups;
+    uint32_t wakeups_input;         // Despertada por un botón
+    uint32_t wakeups_deadline;      // Por el próximo timer de LVGL o el límite de FPS
+    uint32_t last_sleep_ms;         // Último sueño pedido
+    uint32_t max_sleep_ms;
+    uint8_t idle_pct;               // idle_us / (active_us + idle_us)
+} ui_power_stats_t;
+
+// Arranca la tarea de render (UI_RENDER_CORE) y la de flush (UI_FLUSH_CORE).
+// A partir de aquí solo la tarea de render debe llamar a LVGL.
+esp_err_t ui_pipeline_start(screen_t* screen);
+void ui_pipeline_set_fps_cap(uint32_t fps);
+void ui_pipeline_get_stats(ui_pipeline_stats_t* out);
+void ui_pipeline_get_power_stats(ui_power_stats_t* out);
+void ui_pipeline_reset_power_stats();
+
+#endif
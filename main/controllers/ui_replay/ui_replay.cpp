@@ -0,0 +1,310 @@
+#include "controllers/ui_replay/ui_replay.h"
+#include "controllers/buzzer/buzzer.h"
+#include "controllers/db_manager/db_manager.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <cstdio>
+#include <cstring>
+
+static const char* TAG = "UI_REPLAY";
+
+// Boot -> Clock por el timer de la propia vista (solo avanza el reloj virtual)
+static const ui_replay_step_t script_boot[] = {
+    { 2200, BUTTON_COUNT,  VIEW_CLOCK },
+};
+
+// Clock -> Settings -> System Info -> Settings -> Clock -> Spectrum -> Clock.
+// La selección de Settings vuelve a la primera fila antes de salir, así que
+// todos los ciclos recorren lo mismo aunque la vista siga en caché.
+static const ui_replay_step_t script_nav_loop[] = {
+    {  300, BUTTON_RIGHT,  VIEW_SETTINGS },
+    {  600, BUTTON_LEFT,   VIEW_SETTINGS },     // Última fila: System info
+    {  900, BUTTON_OK,     VIEW_SYSTEM_INFO },
+    { 1500, BUTTON_OK,     VIEW_SETTINGS },
+    { 1800, BUTTON_RIGHT,  VIEW_SETTINGS },     // Vuelve a la primera fila
+    { 2100, BUTTON_CANCEL, VIEW_CLOCK },
+    { 2400, BUTTON_LEFT,   VIEW_SPECTRUM },
+    { 3000, BUTTON_CANCEL, VIEW_CLOCK },
+};
+
+// Recorre la lista de Settings hasta el final y vuelve, a un paso por animación
+static const ui_replay_step_t script_settings_scroll[] = {
+    {  300, BUTTON_RIGHT,  VIEW_SETTINGS },
+    {  600, BUTTON_RIGHT,  VIEW_SETTINGS },
+    {  750, BUTTON_RIGHT,  VIEW_SETTINGS },
+    {  900, BUTTON_RIGHT,  VIEW_SETTINGS },
+    { 1050, BUTTON_RIGHT,  VIEW_SETTINGS },
+    { 1200, BUTTON_RIGHT,  VIEW_SETTINGS },
+    { 1350, BUTTON_RIGHT,  VIEW_SETTINGS },
+    { 1500, BUTTON_RIGHT,  VIEW_SETTINGS },
+    { 1650, BUTTON_RIGHT,  VIEW_SETTINGS },
+    { 1800, BUTTON_LEFT,   VIEW_SETTINGS },
+    { 1950, BUTTON_LEFT,   VIEW_SETTINGS },
+    { 2100, BUTTON_LEFT,   VIEW_SETTINGS },
+    { 2250, BUTTON_LEFT,   VIEW_SETTINGS },
+    { 2400, BUTTON_LEFT,   VIEW_SETTINGS },
+    { 2550, BUTTON_LEFT,   VIEW_SETTINGS },
+    { 2700, BUTTON_LEFT,   VIEW_SETTINGS },
+    { 2850, BUTTON_LEFT,   VIEW_SETTINGS },
+    { 3100, BUTTON_CANCEL, VIEW_CLOCK },
+};
+
+#define SCRIPT(name, start, steps) { name, start, steps, sizeof(steps) / sizeof(steps[0]) }
+
+const ui_replay_scenario_t ui_replay_scenarios[] = {
+    SCRIPT("boot",            VIEW_BOOT,  script_boot),
+    SCRIPT("nav_loop",        VIEW_CLOCK, script_nav_loop),
+    SCRIPT("settings_scroll", VIEW_CLOCK, script_settings_scroll),
+};
+const uint32_t ui_replay_scenario_count = sizeof(ui_replay_scenarios) / sizeof(ui_replay_scenarios[0]);
+
+static const char* const replay_status_names[] = { "PASS", "BASELINE", "NOBASE", "SLOW", "LEAK", "NAV" };
+
+// Reloj virtual: solo avanza en replay_frame
+static uint32_t replay_tick_ms = 0;
+
+static uint32_t replay_tick_cb() {
+    return replay_tick_ms;
+}
+
+static uint32_t replay_lv_heap_used() {
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    return mon.total_size - mon.free_size;
+}
+
+static lv_obj_tree_walk_res_t replay_count_cb(lv_obj_t* obj, void* user) {
+    (*(uint32_t*)user)++;
+    return LV_OBJ_TREE_WALK_NEXT;
+}
+
+// Objetos vivos en todas las pantallas (también las de vistas cacheadas)
+static uint32_t replay_count_objects() {
+    uint32_t count = 0;
+    lv_obj_tree_walk(nullptr, replay_count_cb, &count);
+    return count;
+}
+
+typedef struct {
+    ui_replay_result_t* out;
+    uint64_t frame_total_us;
+    uint64_t switch_total_us;
+    uint32_t switch_count;      // Último switch_count visto en screen_switch_stats_t
+} replay_state_t;
+
+// Un frame virtual: despacha botones y corre los timers de LVGL (incluido el refresco)
+static void replay_frame(replay_state_t* st) {
+    replay_tick_ms += UI_REPLAY_FRAME_MS;
+
+    const int64_t t_start = esp_timer_get_time();
+    button_manager_process_events();
+    lv_timer_handler();
+    const uint32_t elapsed = (uint32_t)(esp_timer_get_time() - t_start);
+
+    ui_replay_result_t* out = st->out;
+    out->frames++;
+    st->frame_total_us += elapsed;
+    if (elapsed > out->frame_us_max) {
+        out->frame_us_max = elapsed;
+    }
+
+    screen_switch_stats_t sw;
+    screen_get_switch_stats(&sw);
+    if (sw.switch_count != st->switch_count) {
+        st->switch_count = sw.switch_count;
+        out->switches++;
+        st->switch_total_us += sw.last_us;
+        if (sw.last_us > out->switch_us_max) {
+            out->switch_us_max = sw.last_us;
+        }
+    }
+
+    const uint32_t used = replay_lv_heap_used();
+    if (used > out->lv_heap_peak) {
+        out->lv_heap_peak = used;
+    }
+}
+
+void ui_replay_run_scenario(screen_t* screen, const ui_replay_scenario_t* scenario, uint32_t cycles, ui_replay_result_t* out) {
+    *out = {};
+    out->cycles = cycles;
+    replay_state_t st = {};
+    st.out = out;
+
+    // Sin clics durante el script, sin panel y con el reloj de LVGL parado
+    // salvo cuando avanza un frame. Arranca en el tick real para que los
+    // timers ya creados no vean un salto hacia atrás.
+    const uint8_t volume = buzzer_get_volume();
+    buzzer_set_volume(0);
+    screen_set_headless(screen, true);
+    replay_tick_ms = lv_tick_get();
+    screen_set_tick_cb(replay_tick_cb);
+
+    screen_switch_stats_t sw;
+    screen_get_switch_stats(&sw);
+    st.switch_count = sw.switch_count;
+
+    const uint32_t last_at = scenario->count ? scenario->steps[scenario->count - 1].at_ms : 0;
+    for (uint32_t cycle = 1; cycle <= cycles; cycle++) {
+        const uint32_t cycle_start = replay_tick_ms;
+        if (screen_get_current_view() != scenario->start) {
+            switch_screen(scenario->start);
+        }
+
+        for (uint16_t i = 0; i < scenario->count; i++) {
+            const ui_replay_step_t& step = scenario->steps[i];
+            while (replay_tick_ms - cycle_start < step.at_ms) {
+                replay_frame(&st);
+            }
+            if (step.button < BUTTON_COUNT && !button_manager_inject(step.button)) {
+                ESP_LOGW(TAG, "%s: cola de botones llena en el paso %u", scenario->name, i);
+            }
+            replay_frame(&st);
+
+            const view_id_t current = screen_get_current_view();
+            if (step.expect != VIEW_COUNT && current != step.expect) {
+                ESP_LOGW(TAG, "%s ciclo %lu paso %u: %s en lugar de %s", scenario->name, (unsigned long)cycle, i,
+                         screen_get_view_name(current), screen_get_view_name(step.expect));
+                out->nav_errors++;
+            }
+        }
+
+        // Deja terminar animaciones y reconstrucciones diferidas antes de contar
+        while (replay_tick_ms - cycle_start < last_at + UI_REPLAY_SETTLE_MS) {
+            replay_frame(&st);
+        }
+
+        const uint32_t objs = replay_count_objects();
+        const uint32_t heap = replay_lv_heap_used();
+        if (cycle == 1) {
+            out->objs_first = objs;
+            out->heap_first = heap;
+        }
+        out->objs_last = objs;
+        out->heap_last = heap;
+        printf("REPLAYCYCLE,%s,%lu,%lu,%lu,%lu\n", scenario->name, (unsigned long)cycle,
+               (unsigned long)out->frames, (unsigned long)objs, (unsigned long)heap);
+    }
+
+    // El reloj virtual suele ir por delante del real: screen_set_tick_cb sigue
+    // desde el mayor, así que el tick no retrocede para los timers ni para ClockView
+    screen_set_tick_cb(nullptr);
+    screen_set_headless(screen, false);
+    buzzer_set_volume(volume);
+
+    out->frame_us_avg = out->frames ? (uint32_t)(st.frame_total_us / out->frames) : 0;
+    out->switch_us_avg = out->switches ? (uint32_t)(st.switch_total_us / out->switches) : 0;
+}
+
+// Supera el baseline en más de UI_REPLAY_THRESHOLD_PCT (más un margen absoluto)
+static bool replay_exceeds(uint32_t value, uint32_t base, uint32_t slack) {
+    return value > base + base * UI_REPLAY_THRESHOLD_PCT / 100 + slack;
+}
+
+ui_replay_status_t ui_replay_compare(const ui_replay_result_t* r, const ui_replay_baseline_t* base) {
+    // El primer ciclo llena cachés y snapshots; a partir de ahí nada debería crecer
+    const int32_t leaked_objs = (int32_t)(r->objs_last - r->objs_first);
+    const int32_t leaked_bytes = (int32_t)(r->heap_last - r->heap_first);
+
+    if (r->nav_errors) return REPLAY_NAV;
+    if (leaked_objs > 0 || leaked_bytes > UI_REPLAY_LEAK_TOLERANCE_BYTES) return REPLAY_LEAK;
+    if (!base) return REPLAY_BASELINE;
+    if (replay_exceeds(r->frame_us_avg, base->frame_us_avg, UI_REPLAY_SLACK_US) ||
+        replay_exceeds(r->switch_us_avg, base->switch_us_avg, UI_REPLAY_SLACK_US) ||
+        (base->lv_heap_peak && replay_exceeds(r->lv_heap_peak, base->lv_heap_peak, 0))) {
+        return REPLAY_SLOW;
+    }
+    return REPLAY_PASS;
+}
+
+static void replay_key(const char* name, char* key, size_t size) {
+    snprintf(key, size, "rpl.%s", name);
+}
+
+esp_err_t ui_replay_set_baseline(const char* name, const ui_replay_baseline_t* base) {
+    char key[DB_KEY_MAX + 1];
+    replay_key(name, key, sizeof(key));
+    return db_put(key, base, sizeof(*base));
+}
+
+esp_err_t ui_replay_load_baselines(const char* path) {
+    FILE* f = fopen(path, "r");
+    if (!f) return ESP_ERR_NOT_FOUND;
+
+    esp_err_t err = ESP_OK;
+    uint32_t loaded = 0;
+    char line[128];
+    while (fgets(line, sizeof(line), f)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '#' || line[0] == '\0') continue;
+
+        char name[DB_KEY_MAX + 1];
+        unsigned long frames, frame_us, switch_us, heap_peak;
+        if (sscanf(line, "%23[^,],%lu,%lu,%lu,%lu", name, &frames, &frame_us, &switch_us, &heap_peak) != 5) {
+            ESP_LOGW(TAG, "%s: línea no válida: %s", path, line);
+            err = ESP_ERR_INVALID_ARG;
+            continue;
+        }
+        const ui_replay_baseline_t base = { (uint32_t)frames, (uint32_t)frame_us, (uint32_t)switch_us,
+                                            (uint32_t)heap_peak };
+        if (ui_replay_set_baseline(name, &base) != ESP_OK) {
+            err = ESP_FAIL;
+            continue;
+        }
+        loaded++;
+    }
+    fclose(f);
+    ESP_LOGI(TAG, "%lu baselines cargados de %s", (unsigned long)loaded, path);
+    return err;
+}
+
+uint32_t ui_replay_run_all(screen_t* screen, uint32_t cycles, ui_replay_status_t* statuses) {
+    ESP_LOGI(TAG, "Replay de %lu escenarios, %lu ciclos cada uno", (unsigned long)ui_replay_scenario_count,
+             (unsigned long)cycles);
+
+    uint32_t regressions = 0;
+    printf("REPLAYCYCLE,scenario,cycle,frames,objs,lv_heap_used\n");
+    printf("REPLAY,scenario,cycles,frames,frame_us_avg,frame_us_max,switches,switch_us_avg,switch_us_max,"
+           "lv_heap_peak,leaked_objs,leaked_bytes,nav_errors,base_frame_us,base_switch_us,base_heap_peak,status\n");
+    for (uint32_t i = 0; i < ui_replay_scenario_count; i++) {
+        const ui_replay_scenario_t* scenario = &ui_replay_scenarios[i];
+        ui_replay_result_t r;
+        ui_replay_run_scenario(screen, scenario, cycles, &r);
+
+        char key[DB_KEY_MAX + 1];
+        replay_key(scenario->name, key, sizeof(key));
+        ui_replay_baseline_t base = {};
+        const bool has_base = !UI_REPLAY_UPDATE_BASELINE &&
+                              db_get(key, &base, sizeof(base)) == sizeof(base) && base.frames == r.frames;
+
+        ui_replay_status_t status = ui_replay_compare(&r, has_base ? &base : nullptr);
+        if (status == REPLAY_BASELINE) {
+            const ui_replay_baseline_t now = { r.frames, r.frame_us_avg, r.switch_us_avg, r.lv_heap_peak };
+            if (ui_replay_set_baseline(scenario->name, &now) != ESP_OK) {
+                status = REPLAY_NOBASE;
+            }
+        }
+        if (status >= REPLAY_SLOW) {
+            regressions++;
+        }
+        if (statuses) {
+            statuses[i] = status;
+        }
+
+        const int32_t leaked_objs = (int32_t)(r.objs_last - r.objs_first);
+        const int32_t leaked_bytes = (int32_t)(r.heap_last - r.heap_first);
+        printf("REPLAY,%s,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%ld,%ld,%lu,%lu,%lu,%lu,%s\n", scenario->name,
+               (unsigned long)r.cycles, (unsigned long)r.frames, (unsigned long)r.frame_us_avg,
+               (unsigned long)r.frame_us_max, (unsigned long)r.switches, (unsigned long)r.switch_us_avg,
+               (unsigned long)r.switch_us_max, (unsigned long)r.lv_heap_peak, (long)leaked_objs, (long)leaked_bytes,
+               (unsigned long)r.nav_errors, (unsigned long)base.frame_us_avg, (unsigned long)base.switch_us_avg,
+               (unsigned long)base.lv_heap_peak, replay_status_names[status]);
+    }
+
+    if (regressions) {
+        ESP_LOGE(TAG, "%lu escenarios con regresión", (unsigned long)regressions);
+    } else {
+        ESP_LOGI(TAG, "Replay sin regresiones");
+    }
+    return regressions;
+}
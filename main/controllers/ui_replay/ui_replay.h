@@ -0,0 +1,90 @@
+#ifndef UI_REPLAY_H
+#define UI_REPLAY_H
+
+#include "controllers/button_manager/button_manager.h"
+#include "controllers/screen_manager/screen_manager.h"
+#include "esp_err.h"
+#include <stdint.h>
+
+// Reproduce scripts de botones con marca de tiempo sobre el grafo de navegación
+// real (switch_screen + tablas de handlers de cada vista). Las pulsaciones
+// entran por button_manager_inject; LVGL corre con un reloj virtual que avanza
+// UI_REPLAY_FRAME_MS por iteración y sin panel (screen_set_headless), así que
+// dos ejecuciones del mismo script recorren exactamente los mismos frames.
+
+// Un paso del script. 'button' = BUTTON_COUNT no pulsa nada (solo espera y comprueba).
+typedef struct {
+    uint32_t at_ms;             // Desde el inicio del ciclo, en tiempo virtual
+    button_id_t button;
+    view_id_t expect;           // Vista activa tras el paso (VIEW_COUNT = no comprobar)
+} ui_replay_step_t;
+
+// Cada ciclo empieza en 'start' (se cambia a ella si hace falta)
+typedef struct {
+    const char* name;           // También da la clave del baseline ("rpl.<name>")
+    view_id_t start;
+    const ui_replay_step_t* steps;
+    uint16_t count;
+} ui_replay_scenario_t;
+
+typedef struct {
+    uint32_t cycles;
+    uint32_t frames;
+    uint32_t frame_us_avg;      // lv_timer_handler + despacho de botones
+    uint32_t frame_us_max;
+    uint32_t switches;
+    uint32_t switch_us_avg;     // Latencia de switch_screen
+    uint32_t switch_us_max;
+    uint32_t lv_heap_peak;      // Pico del heap de LVGL muestreado tras cada frame
+    uint32_t objs_first;        // Objetos LVGL vivos al acabar el primer ciclo
+    uint32_t objs_last;         // ... y al acabar el último
+    uint32_t heap_first;        // Heap de LVGL en uso al acabar el primer ciclo
+    uint32_t heap_last;
+    uint32_t nav_errors;        // Pasos en los que la vista activa no era la esperada
+} ui_replay_result_t;
+
+// Lo que se guarda en db_manager por escenario
+typedef struct {
+    uint32_t frames;            // Si cambia, el script cambió: se vuelve a grabar
+    uint32_t frame_us_avg;
+    uint32_t switch_us_avg;
+    uint32_t lv_heap_peak;      // 0 = no se compara
+} ui_replay_baseline_t;
+
+// Resultado de comparar con el baseline; desde REPLAY_SLOW cuenta como regresión
+typedef enum {
+    REPLAY_PASS = 0,
+    REPLAY_BASELINE,            // No había baseline (o cambió el script): se guarda este
+    REPLAY_NOBASE,              // No había baseline y db_manager no pudo guardarlo
+    REPLAY_SLOW,
+    REPLAY_LEAK,
+    REPLAY_NAV,
+} ui_replay_status_t;
+
+extern const ui_replay_scenario_t ui_replay_scenarios[];
+extern const uint32_t ui_replay_scenario_count;
+
+// Ejecuta 'cycles' ciclos del escenario. Escribe una línea REPLAYCYCLE por ciclo.
+// Debe llamarse antes de ui_pipeline_start (usa LVGL directamente).
+void ui_replay_run_scenario(screen_t* screen, const ui_replay_scenario_t* scenario, uint32_t cycles, ui_replay_result_t* out);
+
+// Clasifica un resultado frente a 'base' (nullptr = sin baseline para este
+// script). No guarda nada: sin baseline devuelve REPLAY_BASELINE.
+ui_replay_status_t ui_replay_compare(const ui_replay_result_t* r, const ui_replay_baseline_t* base);
+
+// Guarda el baseline de un escenario en db_manager (clave "rpl.<name>")
+esp_err_t ui_replay_set_baseline(const char* name, const ui_replay_baseline_t* base);
+
+// Carga baselines desde un CSV, una línea por escenario:
+//   escenario,frames,frame_us_avg,switch_us_avg,lv_heap_peak
+// Las líneas vacías y las que empiezan por '#' se ignoran. ESP_ERR_NOT_FOUND
+// sin fichero, ESP_ERR_INVALID_ARG si alguna línea no se entiende.
+esp_err_t ui_replay_load_baselines(const char* path);
+
+// Ejecuta todos los escenarios y compara cada uno con su baseline en db_manager.
+// Una línea REPLAY por escenario con PASS, SLOW, LEAK, NAV o BASELINE (guardado).
+// Si 'statuses' no es nullptr recibe el estado de cada escenario, en el orden
+// de ui_replay_scenarios. Devuelve el número de escenarios con regresión.
+uint32_t ui_replay_run_all(screen_t* screen, uint32_t cycles, ui_replay_status_t* statuses);
+
+#endif
@@ -6,11 +6,27 @@
 #include "controllers/screen_manager/screen_manager.h"
 #include "config.h"
 #include "controllers/button_manager/button_manager.h"
+#include "controllers/fs_manager/fs_manager.h"
+#include "controllers/sd_card/sd_card.h"
+#include "controllers/db_manager/db_manager.h"
+#include "controllers/microphone/microphone.h"
+#include "controllers/pedometer/pedometer.h"
+#include "controllers/leds/leds.h"
+#include "controllers/buzzer/buzzer.h"
+#include "controllers/telemetry/telemetry.h"
+#include "controllers/dlog/dlog.h"
+#include "controllers/ui_pipeline/ui_pipeline.h"
+#include "controllers/ui_benchmark/ui_benchmark.h"
+#include "controllers/ui_replay/ui_replay.h"
 
 static const char *TAG = "main";
 
 extern "C" void app_main(void) {
     ESP_LOGI(TAG, "Iniciando aplicación");
+#if DLOG_ENABLED
+    // Lo primero: a partir de aquí DLOGx ya no formatea en el punto de llamada
+    dlog_init();
+#endif
 
     // 1. Inicialización de hardware
     screen_t* screen = screen_init();
@@ -21,20 +37,80 @@ extern "C" void app_main(void) {
 
     button_manager_init();
 
+    // Pack de assets en flash; sin él las vistas usan las fuentes integradas
+    fs_manager_init();
+    // Tarjeta SD opcional: sin ella las escrituras se descartan
+    sd_card_init();
+    // Historial y ajustes persistentes en la partición "db"
+    db_manager_init();
+    // Límite de FPS elegido en Settings
+    uint8_t fps_cap;
+    if (db_get(SETTINGS_KEY_FPS_CAP, &fps_cap, sizeof(fps_cap)) == sizeof(fps_cap)) {
+        ui_pipeline_set_fps_cap(fps_cap);
+    }
+    // Micrófono I2S: niveles siempre, espectro solo con SpectrumView en pantalla
+    microphone_init();
+    // Podómetro siempre activo sobre la FIFO del acelerómetro
+    pedometer_init();
+    // Tira de LEDs: por defecto repite la cuadrícula de segundos del reloj
+    if (leds_init() == ESP_OK) {
+        uint8_t effect;
+        if (db_get(SETTINGS_KEY_LEDS_FX, &effect, sizeof(effect)) == sizeof(effect)) {
+            leds_set_effect((led_fx_effect_t)effect);
+        }
+    }
+    // Zumbador: las melodías se encolan sin bloquear y las secuencia un gptimer
+    if (buzzer_init() == ESP_OK) {
+        uint8_t level;
+        if (db_get(SETTINGS_KEY_VOLUME, &level, sizeof(level)) == sizeof(level)) {
+            buzzer_set_volume(level);
+        }
+    }
+#if TELEMETRY_ENABLED
+    // Muestreo de heap, LVGL, FPS y tareas para SystemInfoView y la consola
+    telemetry_init();
+#endif
+
+#if UI_BENCHMARK_ENABLED
+    // Medida de coste de cada vista antes de arrancar la UI normal
+    ui_benchmark_run(screen, UI_BENCHMARK_FRAMES);
+    ui_benchmark_style_audit(screen, THEME_AUDIT_ROUNDS);
+    ui_benchmark_virtual_list(screen, VLIST_BENCH_ITEMS, UI_BENCHMARK_FRAMES * 10);
+#if UI_REPLAY_CYCLES > 0
+    // Scripts de navegación contra el baseline guardado en db_manager
+    ui_replay_run_all(screen, UI_REPLAY_CYCLES, nullptr);
+#endif
+    // Sin tarjeta se mide solo el ring y el writer
+    if (!sd_card_is_mounted()) {
+        sd_card_init_with_backend(&sd_card_null_backend, "/null");
+    }
+    sd_card_benchmark(SD_CARD_BENCH_BYTES, 64);
+    sd_card_benchmark(SD_CARD_BENCH_BYTES, 4096);
+    db_manager_benchmark(DB_BENCH_SAMPLES, DB_BENCH_POWER_CUTS);
+    microphone_benchmark(MIC_BENCH_BLOCKS);
+    pedometer_benchmark(PEDO_BENCH_SAMPLES);
+    leds_benchmark(LEDS_BENCH_FRAMES);
+    buzzer_benchmark(BUZZER_BENCH_STEPS);
+#if DLOG_ENABLED
+    dlog_benchmark(DLOG_BENCH_CALLS);
+#endif
+#if UI_BENCHMARK_STRESS_CYCLES > 0
+    ui_benchmark_stress_switch(screen, UI_BENCHMARK_STRESS_CYCLES, 100);
+#endif
+#endif
+
     // 2. Gestión inicial de vistas
-    switch_screen("Boot");
+    switch_screen(VIEW_BOOT);
+    buzzer_play(buzzer_melody_startup, false);
     ESP_LOGI(TAG, "Vista Boot mostrada");
 
-    // 3. Bucle principal optimizado para 30 FPS
-    ESP_LOGI(TAG, "Entrando en bucle principal");
-    while (true) {
-        const uint32_t t_start = esp_log_timestamp();
+    // 3. Pipeline de UI: render y flush en núcleos separados.
+    // app_main puede terminar; LVGL queda en manos de la tarea de render.
+    ESP_ERROR_CHECK(ui_pipeline_start(screen));
+    ESP_LOGI(TAG, "Pipeline de UI en marcha");
 
-        lv_timer_handler();
-
-        // Control de FPS: Asegurando 30 FPS
-        const uint32_t elapsed = esp_log_timestamp() - t_start;
-        const uint32_t delay_ms = elapsed < 33 ? 33 - elapsed : 1;  // Espera 33ms para mantener 30 FPS
-        vTaskDelay(pdMS_TO_TICKS(delay_ms));
-    }
+#if TELEMETRY_ENABLED && TELEMETRY_CONSOLE_ENABLED
+    // Consola por UART: "telemetry" vuelca la última muestra, "dprof" el profiler de display
+    telemetry_console_start();
+#endif
 }
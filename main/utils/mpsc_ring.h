@@ -0,0 +1,138 @@
+#ifndef MPSC_RING_H
+#define MPSC_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Ring de bytes lock-free con varios productores y un solo consumidor.
+// Cada productor reserva un registro contiguo con un CAS sobre 'write',
+// copia su payload sin bloquear a nadie y lo publica con commit(). El
+// consumidor lee en orden y se detiene en el primer registro sin publicar.
+// Si un registro no cabe hasta el final del buffer se rellena con un
+// registro de padding y empieza al principio.
+//
+// El consumidor pone a cero lo que libera: así una cabecera a 0 significa
+// "reservado pero sin publicar" aunque haya datos viejos de la vuelta anterior.
+class MpscRing {
+public:
+    static constexpr uint32_t HEADER_BYTES = 8;
+
+    // 'capacity' potencia de 2 y múltiplo de 8; 'mem' alineado a 4
+    bool init(uint8_t* mem, uint32_t capacity) {
+        if (!mem || capacity < 64 || (capacity & (capacity - 1)) != 0) return false;
+        buf = mem;
+        cap = capacity;
+        memset(buf, 0, cap);
+        write.store(0, std::memory_order_relaxed);
+        read.store(0, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Registro más grande que se puede reservar
+    uint32_t max_payload() const {
+        const uint32_t half = cap / 2 - HEADER_BYTES;
+        return half < 0xFFFF ? half : 0xFFFF;
+    }
+
+    // Devuelve el payload reservado o nullptr si no hay sitio ahora mismo
+    uint8_t* reserve(uint32_t len, uint16_t tag) {
+        if (len > max_payload()) return nullptr;
+        const uint32_t total = record_bytes(len);
+
+        uint32_t w = write.load(std::memory_order_relaxed);
+        uint32_t pad;
+        for (;;) {
+            const uint32_t r = read.load(std::memory_order_acquire);
+            const uint32_t contig = cap - (w & (cap - 1));
+            pad = total > contig ? contig : 0;
+            if (pad + total > cap - (w - r)) return nullptr;
+            if (write.compare_exchange_weak(w, w + pad + total, std::memory_order_acq_rel,
+                                            std::memory_order_relaxed)) {
+                break;
+            }
+        }
+
+        if (pad) {
+            header_at(w)->tag = 0;
+            header_at(w)->len = 0;
+            __atomic_store_n(&header_at(w)->state, pad | PAD | COMMITTED, __ATOMIC_RELEASE);
+        }
+        header_t* h = header_at(w + pad);
+        h->tag = tag;
+        h->len = (uint16_t)len;
+        return (uint8_t*)(h + 1);
+    }
+
+    void commit(uint8_t* payload) {
+        header_t* h = (header_t*)(payload - HEADER_BYTES);
+        __atomic_store_n(&h->state, record_bytes(h->len) | COMMITTED, __ATOMIC_RELEASE);
+    }
+
+    // Consumidor: siguiente registro publicado (los paddings se saltan solos)
+    const uint8_t* peek(uint32_t* len, uint16_t* tag) {
+        for (;;) {
+            const uint32_t r = read.load(std::memory_order_relaxed);
+            if (r == write.load(std::memory_order_acquire)) return nullptr;
+
+            header_t* h = header_at(r);
+            const uint32_t state = __atomic_load_n(&h->state, __ATOMIC_ACQUIRE);
+            if (!(state & COMMITTED)) return nullptr;   // Un productor sigue copiando
+
+            if (state & PAD) {
+                consume(r, state & SIZE_MASK);
+                continue;
+            }
+            *len = h->len;
+            *tag = h->tag;
+            return (const uint8_t*)(h + 1);
+        }
+    }
+
+    void release() {
+        const uint32_t r = read.load(std::memory_order_relaxed);
+        consume(r, __atomic_load_n(&header_at(r)->state, __ATOMIC_RELAXED) & SIZE_MASK);
+    }
+
+    uint32_t used() const {
+        return write.load(std::memory_order_acquire) - read.load(std::memory_order_acquire);
+    }
+
+    uint32_t capacity() const {
+        return cap;
+    }
+
+    // Tamaño ocupado en el ring por un registro de 'len' bytes
+    static uint32_t record_bytes(uint32_t len) {
+        return (HEADER_BYTES + len + 7) & ~7u;
+    }
+
+private:
+    static constexpr uint32_t COMMITTED = 0x80000000u;
+    static constexpr uint32_t PAD = 0x40000000u;
+    static constexpr uint32_t SIZE_MASK = 0x3FFFFFFFu;
+
+    // state: bytes que ocupa el registro + flags. len: payload exacto
+    struct header_t {
+        uint32_t state;
+        uint16_t tag;
+        uint16_t len;
+    };
+
+    header_t* header_at(uint32_t pos) const {
+        return (header_t*)(buf + (pos & (cap - 1)));
+    }
+
+    void consume(uint32_t r, uint32_t bytes) {
+        memset(buf + (r & (cap - 1)), 0, bytes);
+        read.store(r + bytes, std::memory_order_release);
+    }
+
+    uint8_t* buf = nullptr;
+    uint32_t cap = 0;
+    std::atomic<uint32_t> write{0};     // Reservado por los productores
+    std::atomic<uint32_t> read{0};      // Solo lo escribe el consumidor
+};
+
+#endif
@@ -3,6 +3,11 @@
 #include <atomic>
 #include "controllers/button_manager/button_manager.h"
 #include "controllers/screen_manager/screen_manager.h"
+#include "controllers/fs_manager/fs_manager.h"
+#include "controllers/pedometer/pedometer.h"
+#include "controllers/leds/leds.h"
+#include "controllers/dlog/dlog.h"
+#include "views/theme/theme.h"
 #include "esp_log.h"
 #include <cstdlib>
 
@@ -12,29 +17,40 @@ const int GRID_ROWS = 5;
 const int GRID_COLS = 12;
 const int CELL_SIZE = 10;
 const int CELL_SPACING = 3;
-const int CELL_RADIUS = 3;
+const uint32_t START_TIME_S = 12 * 3600;    // Hora inicial fija: 12:00:00
 
 static ClockView* currentClockView = nullptr; // Para update_time_task
 
-ClockView::ClockView() : BaseView("Clock"), time_label(nullptr), grid(nullptr), grid_cells(), timer(nullptr),
+ClockView::ClockView() : BaseView("Clock"),
+#if CLOCK_DIGIT_ATLAS_ENABLED
+                        time_display(screen, fs_manager_font_or("montserrat_36", &lv_font_montserrat_36)),
+#else
+                        time_label(nullptr),
+#endif
+                        grid(screen, GRID_ROWS, GRID_COLS, CELL_SIZE, CELL_SPACING),
+                        steps_label(nullptr), shown_steps(UINT32_MAX), timer(nullptr),
+                        start_tick(lv_tick_get()), shown_elapsed_s(0),
                         hours(12), minutes(0), seconds(0)
 {
-    // Crear grid
-    grid = lv_obj_create(screen);
-    int grid_width = GRID_COLS * (CELL_SIZE + CELL_SPACING) - CELL_SPACING + 27;
-    int grid_height = GRID_ROWS * (CELL_SIZE + CELL_SPACING) - CELL_SPACING + 27;
-    lv_obj_set_size(grid, grid_width, grid_height);
-    lv_obj_align(grid, LV_ALIGN_CENTER, 0, -40);
-    lv_obj_clear_flag(grid, LV_OBJ_FLAG_SCROLLABLE);
-    lv_obj_set_style_bg_color(grid, lv_color_hex(0xDDDDDD), LV_PART_MAIN);
-
-    this->create_grid_cells();
+    // Grid: un solo objeto con las 60 celdas dibujadas a mano
+    lv_obj_align(grid.get_obj(), LV_ALIGN_CENTER, 0, -40);
 
+#if CLOCK_DIGIT_ATLAS_ENABLED
+    // Hora desde el atlas de glifos: cada segundo solo se redibujan los dígitos que cambian
+    lv_obj_align(time_display.get_obj(), LV_ALIGN_CENTER, 0, 80);
+#else
     // Crear label de tiempo
     time_label = lv_label_create(screen);
     lv_label_set_text_fmt(time_label, "%02d:%02d:%02d", 12, 0, 0);
-    lv_obj_set_style_text_font(time_label, &lv_font_montserrat_36, LV_PART_MAIN);
+    theme_apply_label(time_label, THEME_LABEL_CLOCK);
     lv_obj_align(time_label, LV_ALIGN_CENTER, 0, 80);
+#endif
+
+    // Pasos del podómetro: se leen del snapshot atómico en el mismo tick de 1 s
+    steps_label = lv_label_create(screen);
+    theme_apply_label(steps_label, THEME_LABEL_BODY);
+    lv_obj_align(steps_label, LV_ALIGN_TOP_MID, 0, 8);
+    update_steps();
 
     timer = lv_timer_create(update_time_task, 1000, this);
     currentClockView = this; // Almacenar la instancia actual
@@ -55,88 +71,100 @@ void ClockView::destroy() {
     BaseView::destroy(); // Llamar a la clase base.
 }
 
-void ClockView::create_grid_cells() {
-    grid_cells.resize(GRID_ROWS, std::vector<lv_obj_t*>(GRID_COLS));
-
-    for (int i = 0; i < GRID_ROWS; i++) {
-        for (int j = 0; j < GRID_COLS; j++) {
-            lv_obj_t* cell = lv_obj_create(grid);
-            lv_obj_set_size(cell, CELL_SIZE, CELL_SIZE);
-            lv_obj_align(cell, LV_ALIGN_TOP_LEFT,
-                         j * (CELL_SIZE + CELL_SPACING),
-                         i * (CELL_SIZE + CELL_SPACING));
-            lv_obj_set_style_bg_color(cell, lv_color_white(), LV_PART_MAIN);
-            lv_obj_set_style_border_width(cell, 1, LV_PART_MAIN);
-            lv_obj_set_style_border_color(cell, lv_color_black(), LV_PART_MAIN);
-            lv_obj_set_style_radius(cell, CELL_RADIUS, LV_PART_MAIN);
-            grid_cells[i][j] = cell;
-        }
+void ClockView::suspend() {
+    if (timer) {
+        lv_timer_pause(timer);
     }
 }
 
-void ClockView::update_grid_animation() {
-    // Limpiar la cuadrícula si estamos al principio de un nuevo minuto (seconds == 0).
-    if (seconds == 0) {
-        for (auto& row : grid_cells) {
-            for (auto& cell : row) {
-                lv_obj_set_style_bg_color(cell, lv_color_white(), LV_PART_MAIN);
-            }
-        }
+void ClockView::resume() {
+    // El reloj siguió contando mientras la vista estaba en caché: se pinta la
+    // hora actual ya, sin esperar al siguiente tick del timer
+    refresh_time();
+    if (timer) {
+        lv_timer_resume(timer);
     }
+}
 
-    // Encender el cuadrado actual (basado en seconds).
-     if (seconds > 0 && seconds < GRID_ROWS * GRID_COLS) { // Ya no se ilumina el cuadrado 0
-        int row = (seconds % (GRID_ROWS * GRID_COLS)) / GRID_COLS;
-        int col = (seconds % (GRID_ROWS * GRID_COLS)) % GRID_COLS;
+void ClockView::update_grid_animation(int first, int last) {
+    for (int s = first; s <= last && s < GRID_ROWS * GRID_COLS; s++) {
+        if (s == 0) continue; // Ya no se ilumina el cuadrado 0
         //Color aleatorio, pero se puede usar un color fijo:
         lv_color_t color = lv_color_make(rand() % 256, rand() % 256, rand() % 256);
 
-        //Comprobación de seguridad
-        if(row < GRID_ROWS && col < GRID_COLS)
-            lv_obj_set_style_bg_color(grid_cells[row][col], color, LV_PART_MAIN);
+        // Solo se invalida el rectángulo de esta celda
+        grid.set_cell(s, color);
+        // La tira de LEDs repite la cuadrícula (efecto LED_FX_SECONDS)
+        leds_set_second(s, { color.red, color.green, color.blue });
+    }
+}
+
+void ClockView::refresh_time() {
+    // La hora sale del tick de LVGL, que no se para con la vista suspendida.
+    // El timer solo decide cuándo se redibuja.
+    const uint32_t elapsed_s = lv_tick_elaps(start_tick) / 1000;
+    if (elapsed_s == shown_elapsed_s) return;
+
+    const uint32_t prev_t = START_TIME_S + shown_elapsed_s;
+    const uint32_t t = START_TIME_S + elapsed_s;
+    shown_elapsed_s = elapsed_s;
+    hours = (int)((t / 3600) % 24);
+    minutes = (int)((t / 60) % 60);
+    seconds = (int)(t % 60);
+
+#if CLOCK_DIGIT_ATLAS_ENABLED
+    time_display.set_time(hours.load(), minutes.load(), seconds.load());
+#else
+    if (time_label) {
+        lv_label_set_text_fmt(time_label, "%02d:%02d:%02d", hours.load(), minutes.load(), seconds.load());
+    }
+#endif
+
+    // Mismo minuto: se encienden las celdas que falten desde la última vez (una
+    // en un tick normal, varias al volver de un suspend). Minuto nuevo: se limpia.
+    int first = 1;
+    if (prev_t / 60 == t / 60) {
+        first = (int)(prev_t % 60) + 1;
+    } else {
+        grid.clear();
+        leds_set_second(0, { 0, 0, 0 });
     }
+    update_grid_animation(first, seconds);
+}
+
+void ClockView::update_steps() {
+    pedometer_snapshot_t snap;
+    pedometer_get_snapshot(&snap);
+    if (snap.steps == shown_steps) return;   // Sin pasos nuevos no se invalida nada
+    shown_steps = snap.steps;
+    lv_label_set_text_fmt(steps_label, "%lu steps", (unsigned long)snap.steps);
 }
 
 void ClockView::update_time_task(lv_timer_t*) {
     if (currentClockView) { // Verificar si currentClockView es válido.
-        currentClockView->seconds++;
-        if (currentClockView->seconds >= 60) {
-            currentClockView->seconds = 0;
-            currentClockView->minutes++;
-            if (currentClockView->minutes >= 60) {
-                currentClockView->minutes = 0;
-                currentClockView->hours++;
-                if (currentClockView->hours >= 24) {
-                    currentClockView->hours = 0;
-                }
-            }
-        }
-
-        if (currentClockView->time_label) {
-            lv_label_set_text_fmt(currentClockView->time_label, "%02d:%02d:%02d",
-                                currentClockView->hours.load(),
-                                currentClockView->minutes.load(),
-                                currentClockView->seconds.load());
-        }
-
-        currentClockView->update_grid_animation();
+        currentClockView->refresh_time();
+        currentClockView->update_steps();
     }
 }
+// Tabla de handlers de la vista (indexada por button_id_t)
+static const button_handler_t clock_button_handlers[BUTTON_COUNT] = {
+    []() {                                                  // BUTTON_LEFT
+        DLOGI(TAG, "Botón LEFT - Ir a Spectrum");
+        switch_screen(VIEW_SPECTRUM);
+    },
+    nullptr,                                                // BUTTON_CANCEL
+    []() { DLOGI(TAG, "Botón OK - Cambiar Color"); },    // BUTTON_OK
+    []() {                                                  // BUTTON_RIGHT
+        DLOGI(TAG, "Botón RIGHT - Ir a Settings");
+        switch_screen(VIEW_SETTINGS);
+    },
+    nullptr,                                                // BUTTON_ON_OFF
+};
+
 void ClockView::register_button_handlers() {
-    button_manager_register_view_handler(BUTTON_LEFT, []() {
-        ESP_LOGI(TAG, "Botón LEFT - Modo Reloj");
-    });
-
-    button_manager_register_view_handler(BUTTON_OK, []() {
-        ESP_LOGI(TAG, "Botón OK - Cambiar Color");
-    });
-
-    button_manager_register_view_handler(BUTTON_RIGHT, []() {
-        ESP_LOGI(TAG, "Botón RIGHT - Ir a Settings");
-        switch_screen("Settings");
-    });
+    button_manager_set_view_handlers(clock_button_handlers);
 }
 
 void ClockView::unregister_button_handlers() {
-    button_manager_unregister_view_handlers();
+    button_manager_set_view_handlers(nullptr);
 }
\ No newline at end of file
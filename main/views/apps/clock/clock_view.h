@@ -2,22 +2,32 @@
 #define CLOCK_VIEW_H
 
 #include "../../base_view.h"
+#include "seconds_grid.h"
+#include "digit_clock.h"
+#include "config.h"
 #include <atomic>
-#include <vector>
 #include "lvgl.h"
 
 class ClockView : public BaseView {
 private:
+#if CLOCK_DIGIT_ATLAS_ENABLED
+    DigitClock time_display;
+#else
     lv_obj_t* time_label;
-    lv_obj_t* grid;
-    std::vector<std::vector<lv_obj_t*>> grid_cells;
+#endif
+    SecondsGrid grid;
+    lv_obj_t* steps_label;
+    uint32_t shown_steps;       // Último valor escrito en steps_label
     lv_timer_t* timer;
+    uint32_t start_tick;        // lv_tick_get() al crear la vista (12:00:00)
+    uint32_t shown_elapsed_s;   // Segundos desde start_tick que muestra la pantalla
     std::atomic<int> hours;
     std::atomic<int> minutes;
     std::atomic<int> seconds;
 
-    void create_grid_cells();
-    void update_grid_animation();
+    void update_grid_animation(int first, int last);
+    void refresh_time();
+    void update_steps();
     static void update_time_task(lv_timer_t* t); // Mantenemos update_time_task como static
 
      //  static void  delete_instance(); //Ya no es necesaria
@@ -28,6 +38,8 @@ public:
     void register_button_handlers() override;
     void unregister_button_handlers() override;
     void destroy() override;
+    void suspend() override;
+    void resume() override;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,140 @@
+#include "digit_clock.h"
+#include "config.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+
+static const char* TAG = "DIGIT_CLOCK";
+
+static const char* const glyph_text[] = { "0", "1", "2", "3", "4", "5", "6", "7", "8", "9", ":" };
+
+// Orden de las celdas: dígito, dígito, ':', dígito, dígito, ':', dígito, dígito
+static bool is_colon_cell(int index) {
+    return index == 2 || index == 5;
+}
+
+DigitClock::DigitClock(lv_obj_t* parent, const lv_font_t* font)
+    : obj(nullptr), digit_w(0), colon_w(0), cell_h(0), atlas(nullptr), atlas_buf{}, glyphs{},
+      text{ '1', '2', ':', '0', '0', ':', '0', '0' }
+{
+    // Celdas de ancho fijo: el dígito más ancho manda, así los números no bailan
+    for (char c = '0'; c <= '9'; c++) {
+        const int32_t w = lv_font_get_glyph_width(font, c, 0);
+        if (w > digit_w) digit_w = w;
+    }
+    colon_w = lv_font_get_glyph_width(font, ':', 0);
+    cell_h = lv_font_get_line_height(font);
+
+    obj = lv_obj_create(parent);
+    lv_obj_remove_style_all(obj);
+    lv_obj_set_size(obj, 6 * digit_w + 2 * colon_w, cell_h);
+
+    build_atlas(font, lv_obj_get_style_text_color(parent, LV_PART_MAIN),
+                lv_obj_get_style_bg_color(parent, LV_PART_MAIN));
+
+    lv_obj_add_event_cb(obj, draw_event_cb, LV_EVENT_DRAW_MAIN, this);
+}
+
+DigitClock::~DigitClock() {
+    heap_caps_free(atlas);
+}
+
+// Rasteriza los 11 glifos una vez en un canvas temporal sobre el atlas
+void DigitClock::build_atlas(const lv_font_t* font, lv_color_t text_color, lv_color_t bg_color) {
+    const int32_t atlas_w = 10 * digit_w + colon_w;
+    const uint32_t stride = lv_draw_buf_width_to_stride(atlas_w, LV_COLOR_FORMAT_RGB565);
+    const uint32_t size = stride * cell_h;
+
+    atlas = (uint8_t*)heap_caps_malloc(size, CLOCK_ATLAS_IN_PSRAM ? MALLOC_CAP_SPIRAM : MALLOC_CAP_INTERNAL);
+    if (!atlas) {
+        atlas = (uint8_t*)heap_caps_malloc(size, MALLOC_CAP_8BIT);
+    }
+    LV_ASSERT_MALLOC(atlas);
+    lv_draw_buf_init(&atlas_buf, atlas_w, cell_h, LV_COLOR_FORMAT_RGB565, stride, atlas, size);
+
+    lv_obj_t* canvas = lv_canvas_create(obj);
+    lv_canvas_set_draw_buf(canvas, &atlas_buf);
+    lv_canvas_fill_bg(canvas, bg_color, LV_OPA_COVER);
+
+    lv_layer_t layer;
+    lv_canvas_init_layer(canvas, &layer);
+
+    lv_draw_label_dsc_t dsc;
+    lv_draw_label_dsc_init(&dsc);
+    dsc.font = font;
+    dsc.color = text_color;
+    dsc.align = LV_TEXT_ALIGN_CENTER;
+
+    int32_t x = 0;
+    for (int i = 0; i < GLYPH_COUNT; i++) {
+        const int32_t w = i == 10 ? colon_w : digit_w;
+        const lv_area_t area = { x, 0, x + w - 1, cell_h - 1 };
+        dsc.text = glyph_text[i];
+        lv_draw_label(&layer, &dsc, &area);
+
+        // Cada glifo es una imagen que apunta a su columna del atlas
+        lv_image_dsc_t& g = glyphs[i];
+        g.header.magic = LV_IMAGE_HEADER_MAGIC;
+        g.header.cf = LV_COLOR_FORMAT_RGB565;
+        g.header.w = w;
+        g.header.h = cell_h;
+        g.header.stride = stride;
+        g.data = atlas + x * 2;
+        g.data_size = stride * (cell_h - 1) + w * 2;
+        x += w;
+    }
+
+    lv_canvas_finish_layer(canvas, &layer);
+    lv_obj_delete(canvas);
+    ESP_LOGI(TAG, "Atlas de %ldx%ld px (%lu bytes)", (long)atlas_w, (long)cell_h, (unsigned long)size);
+}
+
+void DigitClock::get_cell_area(int index, lv_area_t* area) const {
+    lv_area_t coords;
+    lv_obj_get_coords(obj, &coords);
+
+    int32_t x = coords.x1;
+    for (int i = 0; i < index; i++) {
+        x += is_colon_cell(i) ? colon_w : digit_w;
+    }
+    area->x1 = x;
+    area->y1 = coords.y1;
+    area->x2 = x + (is_colon_cell(index) ? colon_w : digit_w) - 1;
+    area->y2 = coords.y1 + cell_h - 1;
+}
+
+void DigitClock::set_time(int hours, int minutes, int seconds) {
+    const char next[CHAR_COUNT] = {
+        (char)('0' + hours / 10), (char)('0' + hours % 10), ':',
+        (char)('0' + minutes / 10), (char)('0' + minutes % 10), ':',
+        (char)('0' + seconds / 10), (char)('0' + seconds % 10),
+    };
+
+    for (int i = 0; i < CHAR_COUNT; i++) {
+        if (next[i] == text[i]) continue;
+        text[i] = next[i];
+
+        lv_area_t area;
+        get_cell_area(i, &area);
+        lv_obj_invalidate_area(obj, &area);
+    }
+}
+
+void DigitClock::draw_event_cb(lv_event_t* e) {
+    DigitClock* clock = (DigitClock*)lv_event_get_user_data(e);
+    lv_layer_t* layer = lv_event_get_layer(e);
+
+    lv_draw_image_dsc_t dsc;
+    lv_draw_image_dsc_init(&dsc);
+
+    for (int i = 0; i < CHAR_COUNT; i++) {
+        lv_area_t area;
+        clock->get_cell_area(i, &area);
+
+        // Solo las celdas que tocan la zona a redibujar
+        lv_area_t visible;
+        if (!lv_area_intersect(&visible, &area, &layer->_clip_area)) continue;
+
+        dsc.src = &clock->glyphs[glyph_index(clock->text[i])];
+        lv_draw_image(layer, &dsc, &area);
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef DIGIT_CLOCK_H
+#define DIGIT_CLOCK_H
+
+#include "lvgl.h"
+
+// Reloj HH:MM:SS dibujado desde un atlas RGB565 con los glifos 0-9 y ':'
+// rasterizados una sola vez. Cada carácter ocupa una celda fija y al cambiar
+// la hora solo se invalidan las celdas cuyo dígito cambió.
+class DigitClock {
+private:
+    static const int GLYPH_COUNT = 11;  // '0'..'9' y ':'
+    static const int CHAR_COUNT = 8;    // "HH:MM:SS"
+
+    lv_obj_t* obj;
+    int32_t digit_w;
+    int32_t colon_w;
+    int32_t cell_h;
+    uint8_t* atlas;
+    lv_draw_buf_t atlas_buf;
+    lv_image_dsc_t glyphs[GLYPH_COUNT]; // Subimágenes del atlas (comparten stride)
+    char text[CHAR_COUNT];
+
+    void build_atlas(const lv_font_t* font, lv_color_t text_color, lv_color_t bg_color);
+    void get_cell_area(int index, lv_area_t* area) const;
+    static int glyph_index(char c) { return c == ':' ? 10 : c - '0'; }
+    static void draw_event_cb(lv_event_t* e);
+
+public:
+    // Toma los colores de texto y fondo de 'parent' para que el atlas sea opaco
+    DigitClock(lv_obj_t* parent, const lv_font_t* font);
+    ~DigitClock();
+
+    lv_obj_t* get_obj() const { return obj; }
+    size_t get_atlas_bytes() const { return atlas_buf.data_size; }
+
+    void set_time(int hours, int minutes, int seconds);
+};
+
+#endif
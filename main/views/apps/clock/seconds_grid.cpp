@@ -0,0 +1,83 @@
+#include "seconds_grid.h"
+#include "views/theme/theme.h"
+
+// Margen interior del contenedor, igual que la cuadrícula original de objetos
+static const int GRID_PADDING = 27;
+
+SecondsGrid::SecondsGrid(lv_obj_t* parent, int rows, int cols, int cell_size, int cell_spacing)
+    : obj(nullptr), rows(rows), cols(cols), cell_size(cell_size), cell_spacing(cell_spacing), cell_dsc(), cells()
+{
+    // Radio, borde y color apagado de las celdas salen de theme_grid_cell
+    theme_cell_dsc(&cell_dsc);
+    cells.assign(rows * cols, cell_dsc.bg_color);
+
+    obj = lv_obj_create(parent);
+    int grid_width = cols * (cell_size + cell_spacing) - cell_spacing + GRID_PADDING;
+    int grid_height = rows * (cell_size + cell_spacing) - cell_spacing + GRID_PADDING;
+    lv_obj_set_size(obj, grid_width, grid_height);
+    lv_obj_clear_flag(obj, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_add_style(obj, &theme_grid, LV_PART_MAIN);
+
+    lv_obj_add_event_cb(obj, draw_event_cb, LV_EVENT_DRAW_MAIN_END, this);
+}
+
+void SecondsGrid::get_cell_area(const lv_area_t* content, int index, lv_area_t* area) const {
+    const int row = index / cols;
+    const int col = index % cols;
+    area->x1 = content->x1 + col * (cell_size + cell_spacing);
+    area->y1 = content->y1 + row * (cell_size + cell_spacing);
+    area->x2 = area->x1 + cell_size - 1;
+    area->y2 = area->y1 + cell_size - 1;
+}
+
+void SecondsGrid::set_cell(int index, lv_color_t color) {
+    if (index < 0 || index >= get_cell_count()) return;
+    if (lv_color_eq(cells[index], color)) return;
+
+    cells[index] = color;
+
+    lv_area_t content, area;
+    lv_obj_get_content_coords(obj, &content);
+    get_cell_area(&content, index, &area);
+    lv_obj_invalidate_area(obj, &area);
+}
+
+void SecondsGrid::clear() {
+    bool changed = false;
+    for (auto& cell : cells) {
+        if (!lv_color_eq(cell, cell_dsc.bg_color)) {
+            cell = cell_dsc.bg_color;
+            changed = true;
+        }
+    }
+
+    // Todas las celdas cambian a la vez: una sola invalidación del área de contenido
+    if (changed) {
+        lv_area_t content;
+        lv_obj_get_content_coords(obj, &content);
+        lv_obj_invalidate_area(obj, &content);
+    }
+}
+
+void SecondsGrid::draw_event_cb(lv_event_t* e) {
+    SecondsGrid* grid = (SecondsGrid*)lv_event_get_user_data(e);
+    lv_layer_t* layer = lv_event_get_layer(e);
+
+    lv_draw_rect_dsc_t dsc = grid->cell_dsc;
+
+    lv_area_t content;
+    lv_obj_get_content_coords(grid->obj, &content);
+
+    const int count = grid->get_cell_count();
+    for (int i = 0; i < count; i++) {
+        lv_area_t area;
+        grid->get_cell_area(&content, i, &area);
+
+        // Solo las celdas que tocan la zona a redibujar
+        lv_area_t visible;
+        if (!lv_area_intersect(&visible, &area, &layer->_clip_area)) continue;
+
+        dsc.bg_color = grid->cells[i];
+        lv_draw_rect(layer, &dsc, &area);
+    }
+}
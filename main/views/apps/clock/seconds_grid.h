@@ -0,0 +1,33 @@
+#ifndef SECONDS_GRID_H
+#define SECONDS_GRID_H
+
+#include "lvgl.h"
+#include <vector>
+
+// Cuadrícula de segundos dibujada en un único objeto LVGL.
+// El estado de las celdas es un array plano de colores y todas se pintan en
+// un solo pase del evento de dibujo; al cambiar una celda solo se invalida su rectángulo.
+class SecondsGrid {
+private:
+    lv_obj_t* obj;
+    int rows;
+    int cols;
+    int cell_size;
+    int cell_spacing;
+    lv_draw_rect_dsc_t cell_dsc;    // Celda apagada (theme_grid_cell); al dibujar solo cambia bg_color
+    std::vector<lv_color_t> cells;
+
+    void get_cell_area(const lv_area_t* content, int index, lv_area_t* area) const;
+    static void draw_event_cb(lv_event_t* e);
+
+public:
+    SecondsGrid(lv_obj_t* parent, int rows, int cols, int cell_size, int cell_spacing);
+
+    lv_obj_t* get_obj() const { return obj; }
+    int get_cell_count() const { return rows * cols; }
+
+    void set_cell(int index, lv_color_t color);
+    void clear();
+};
+
+#endif
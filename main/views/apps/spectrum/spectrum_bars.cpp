@@ -0,0 +1,93 @@
+#include "spectrum_bars.h"
+#include "views/theme/theme.h"
+
+// Zonas de color como fracción de la altura (en 1/16)
+static const int ZONE_YELLOW_16 = 10;
+static const int ZONE_RED_16 = 14;
+
+SpectrumBars::SpectrumBars(lv_obj_t* parent, int bar_count, int bar_width, int bar_spacing, int height)
+    : obj(nullptr), bar_count(bar_count), bar_width(bar_width), bar_spacing(bar_spacing), heights(bar_count, 0)
+{
+    obj = lv_obj_create(parent);
+    const int width = bar_count * (bar_width + bar_spacing) - bar_spacing + 2 * THEME_PANEL_PAD;
+    lv_obj_set_size(obj, width, height + 2 * THEME_PANEL_PAD);
+    lv_obj_add_style(obj, &theme_panel_dark, LV_PART_MAIN);
+    lv_obj_clear_flag(obj, LV_OBJ_FLAG_SCROLLABLE);
+
+    lv_obj_add_event_cb(obj, draw_event_cb, LV_EVENT_DRAW_MAIN_END, this);
+}
+
+int SpectrumBars::get_height() const {
+    return lv_obj_get_content_height(obj);
+}
+
+void SpectrumBars::get_bar_column(const lv_area_t* content, int index, lv_area_t* area) const {
+    area->x1 = content->x1 + index * (bar_width + bar_spacing);
+    area->x2 = area->x1 + bar_width - 1;
+    area->y1 = content->y1;
+    area->y2 = content->y2;
+}
+
+bool SpectrumBars::set_bar(int index, int height) {
+    if (index < 0 || index >= bar_count) return false;
+    const int max_height = get_height();
+    if (height < 0) height = 0;
+    if (height > max_height) height = max_height;
+    if (heights[index] == height) return false;
+
+    // Solo la franja que cambia: al subir se pinta, al bajar la repinta el fondo
+    const int lo = heights[index] < height ? heights[index] : height;
+    const int hi = heights[index] < height ? height : heights[index];
+    heights[index] = (int16_t)height;
+
+    lv_area_t content, area;
+    lv_obj_get_content_coords(obj, &content);
+    get_bar_column(&content, index, &area);
+    area.y1 = content.y2 - hi + 1;
+    area.y2 = content.y2 - lo;
+    lv_obj_invalidate_area(obj, &area);
+    return true;
+}
+
+void SpectrumBars::draw_event_cb(lv_event_t* e) {
+    SpectrumBars* bars = (SpectrumBars*)lv_event_get_user_data(e);
+    lv_layer_t* layer = lv_event_get_layer(e);
+
+    lv_area_t content;
+    lv_obj_get_content_coords(bars->obj, &content);
+    const int full = lv_area_get_height(&content);
+
+    // Límites de las zonas en coordenadas de pantalla (de abajo arriba)
+    const int32_t zone_top[3] = {
+        content.y2 - full * ZONE_YELLOW_16 / 16 + 1,
+        content.y2 - full * ZONE_RED_16 / 16 + 1,
+        content.y1,
+    };
+    static const uint32_t zone_color[3] = { 0x00C853, 0xFFD600, 0xD50000 };
+
+    lv_draw_rect_dsc_t dsc;
+    lv_draw_rect_dsc_init(&dsc);
+
+    for (int i = 0; i < bars->bar_count; i++) {
+        if (bars->heights[i] == 0) continue;
+        lv_area_t bar;
+        bars->get_bar_column(&content, i, &bar);
+        bar.y1 = content.y2 - bars->heights[i] + 1;
+
+        lv_area_t visible;
+        if (!lv_area_intersect(&visible, &bar, &layer->_clip_area)) continue;
+
+        // Un rectángulo por zona que toca la barra
+        int32_t bottom = bar.y2;
+        for (int z = 0; z < 3 && bottom >= bar.y1; z++) {
+            lv_area_t seg = bar;
+            seg.y2 = bottom;
+            seg.y1 = zone_top[z] > bar.y1 ? zone_top[z] : bar.y1;
+            if (seg.y1 <= seg.y2) {
+                dsc.bg_color = lv_color_hex(zone_color[z]);
+                lv_draw_rect(layer, &dsc, &seg);
+            }
+            bottom = seg.y1 - 1;
+        }
+    }
+}
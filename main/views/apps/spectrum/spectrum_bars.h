@@ -0,0 +1,34 @@
+#ifndef SPECTRUM_BARS_H
+#define SPECTRUM_BARS_H
+
+#include "lvgl.h"
+#include <vector>
+
+// Barras del espectro dibujadas en un único objeto LVGL, como SecondsGrid.
+// El color depende de la altura del píxel (verde, amarillo, rojo) y no de la
+// altura de la barra: al cambiar una barra solo se invalida la franja entre
+// su altura anterior y la nueva.
+class SpectrumBars {
+private:
+    lv_obj_t* obj;
+    int bar_count;
+    int bar_width;
+    int bar_spacing;
+    std::vector<int16_t> heights;       // Píxeles encendidos de cada barra
+
+    void get_bar_column(const lv_area_t* content, int index, lv_area_t* area) const;
+    static void draw_event_cb(lv_event_t* e);
+
+public:
+    SpectrumBars(lv_obj_t* parent, int bar_count, int bar_width, int bar_spacing, int height);
+
+    lv_obj_t* get_obj() const { return obj; }
+    int get_bar_count() const { return bar_count; }
+    int get_height() const;
+    int get_bar(int index) const { return heights[index]; }
+
+    // Devuelve true si la barra cambió (y se invalidó su franja)
+    bool set_bar(int index, int height);
+};
+
+#endif
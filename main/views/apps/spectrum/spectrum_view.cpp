@@ -0,0 +1,116 @@
+#include "spectrum_view.h"
+#include "controllers/button_manager/button_manager.h"
+#include "controllers/screen_manager/screen_manager.h"
+#include "controllers/microphone/microphone.h"
+#include "controllers/dlog/dlog.h"
+#include "views/theme/theme.h"
+#include "esp_log.h"
+
+static const char* TAG = "SPECTRUM_VIEW";
+
+const int BAR_WIDTH = 11;
+const int BAR_SPACING = 2;
+const int BARS_HEIGHT = 150;
+const int BAR_FALL_PX = 6;      // Caída por frame: las barras bajan suaves y suben al instante
+
+SpectrumView::SpectrumView() : BaseView("Spectrum"),
+                               bars(screen, MIC_SPECTRUM_BANDS, BAR_WIDTH, BAR_SPACING, BARS_HEIGHT),
+                               level_label(nullptr), timer(nullptr), last_seq(0), shown_db(INT16_MIN)
+{
+    lv_obj_align(bars.get_obj(), LV_ALIGN_BOTTOM_MID, 0, -16);
+
+    level_label = lv_label_create(screen);
+    theme_apply_label(level_label, THEME_LABEL_TITLE);
+    lv_obj_align(level_label, LV_ALIGN_TOP_MID, 0, 20);
+    lv_label_set_text(level_label, microphone_is_running() ? "-- dBFS" : "No mic");
+
+    microphone_set_spectrum_enabled(true);
+    timer = lv_timer_create(update_timer_cb, MIC_VIEW_PERIOD_MS, this);
+}
+
+SpectrumView::~SpectrumView() {
+    // La limpieza se hace en destroy().
+}
+
+void SpectrumView::destroy() {
+    microphone_set_spectrum_enabled(false);
+    if (timer) {
+        lv_timer_del(timer);
+        timer = nullptr;
+    }
+    BaseView::destroy();
+}
+
+void SpectrumView::suspend() {
+    // Fuera de pantalla no hacen falta ni la captura ni la FFT
+    microphone_set_spectrum_enabled(false);
+    if (timer) {
+        lv_timer_pause(timer);
+    }
+}
+
+void SpectrumView::resume() {
+    microphone_set_spectrum_enabled(true);
+    if (timer) {
+        lv_timer_resume(timer);
+    }
+}
+
+void SpectrumView::update() {
+    mic_levels_t levels;
+    microphone_get_levels(&levels);
+    const bool fresh = levels.seq != last_seq;
+    last_seq = levels.seq;
+
+    // Barras: sube al valor nuevo o cae BAR_FALL_PX; solo se invalida la franja que cambia
+    const int full = bars.get_height();
+    for (int i = 0; i < MIC_SPECTRUM_BANDS; i++) {
+        const int target = fresh ? levels.bands[i] * full / MIC_DSP_LEVEL_MAX : 0;
+        const int current = bars.get_bar(i);
+        if (target >= current) {
+            bars.set_bar(i, target);
+        } else {
+            bars.set_bar(i, current - BAR_FALL_PX > target ? current - BAR_FALL_PX : target);
+        }
+    }
+
+    // Label en dB enteros: cambia mucho menos que el valor ×10
+    if (fresh) {
+        const int16_t db = (int16_t)(levels.rms_dbfs_x10 / 10);
+        if (db != shown_db) {
+            shown_db = db;
+            lv_label_set_text_fmt(level_label, "%d dBFS", db);
+        }
+    }
+}
+
+void SpectrumView::update_timer_cb(lv_timer_t* t) {
+    SpectrumView* view = (SpectrumView*)lv_timer_get_user_data(t);
+    if (view) {
+        view->update();
+    }
+}
+
+// Tabla de handlers de la vista (indexada por button_id_t)
+static const button_handler_t spectrum_button_handlers[BUTTON_COUNT] = {
+    []() { switch_screen(VIEW_CLOCK); },                    // BUTTON_LEFT
+    []() { switch_screen(VIEW_CLOCK); },                    // BUTTON_CANCEL
+    []() {                                                  // BUTTON_OK
+        mic_stats_t st;
+        microphone_get_stats(&st);
+        // source es siempre un literal: vale para el %s diferido de dlog
+        DLOGI(TAG, "%s: %lu bloques, %lu descartados, %lu pisados, FFT %lu ciclos",
+              st.source, (unsigned long)st.blocks, (unsigned long)st.dropped,
+              (unsigned long)st.overruns, (unsigned long)st.spectrum_cycles_avg);
+    },
+    nullptr,                                                // BUTTON_RIGHT
+    nullptr,                                                // BUTTON_ON_OFF
+};
+
+void SpectrumView::register_button_handlers() {
+    button_manager_set_view_handlers(spectrum_button_handlers);
+}
+
+void SpectrumView::unregister_button_handlers() {
+    button_manager_set_view_handlers(nullptr);
+}
@@ -0,0 +1,33 @@
+#ifndef SPECTRUM_VIEW_H
+#define SPECTRUM_VIEW_H
+
+#include "../../base_view.h"
+#include "spectrum_bars.h"
+#include "config.h"
+#include "lvgl.h"
+
+// Nivel y espectro del micrófono. Un lv_timer a MIC_VIEW_PERIOD_MS lee la
+// instantánea de controllers/microphone; si no hay bloque nuevo ni barras
+// cayendo no invalida nada.
+class SpectrumView : public BaseView {
+private:
+    SpectrumBars bars;
+    lv_obj_t* level_label;
+    lv_timer_t* timer;
+    uint32_t last_seq;
+    int16_t shown_db;           // dBFS del label (evita reescribirlo si no cambia)
+
+    void update();
+    static void update_timer_cb(lv_timer_t* t);
+
+public:
+    SpectrumView();
+    virtual ~SpectrumView();
+    void register_button_handlers() override;
+    void unregister_button_handlers() override;
+    void destroy() override;
+    void suspend() override;
+    void resume() override;
+};
+
+#endif
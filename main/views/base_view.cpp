@@ -1,7 +1,8 @@
 #include "base_view.h"
+#include "views/theme/theme.h"
 #include "esp_log.h"
 
-BaseView::BaseView(const std::string& view_name) : name(view_name) {
+BaseView::BaseView(const std::string& view_name) : name(view_name), arena(mem_arena_current()) {
     screen = create_base_screen();
 }
 
@@ -13,12 +14,16 @@ void BaseView::destroy() {
         lv_obj_del(screen);
         screen = nullptr;
     }
+    if (arena) {
+        mem_arena_release(arena); // Todos los objetos de la vista ya están borrados
+        arena = nullptr;
+    }
 }
 
 lv_obj_t* BaseView::create_base_screen() {
     lv_obj_t* screen = lv_obj_create(nullptr);
     lv_obj_set_size(screen, 240, 240);
     lv_obj_clear_flag(screen, LV_OBJ_FLAG_SCROLLABLE);
-    lv_obj_set_style_bg_color(screen, lv_color_white(), LV_PART_MAIN);
+    lv_obj_add_style(screen, &theme_screen, LV_PART_MAIN);
     return screen;
 }
\ No newline at end of file
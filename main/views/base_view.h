@@ -2,12 +2,14 @@
 #define BASE_VIEW_H
 
 #include "lvgl.h"
+#include "controllers/mem_manager/mem_manager.h"
 #include <string>
 
 class BaseView {
 protected:
     lv_obj_t* screen;
     std::string name;
+    mem_arena_t* arena;     // Arena activa al construir la vista (puede ser nullptr)
 
 public:
     BaseView(const std::string& view_name);
@@ -15,8 +17,13 @@ public:
 
     virtual void register_button_handlers() = 0;
     virtual void unregister_button_handlers() = 0;
+    // Borra la pantalla y suelta la arena. Las subclases liberan antes sus timers.
     virtual void destroy();
 
+    // La caché de vistas suspende en vez de destruir: pausar timers/animaciones aquí
+    virtual void suspend() {}
+    virtual void resume() {}
+
     lv_obj_t* get_screen() const { return screen; }
     std::string get_name() const { return name; }
 
@@ -1,5 +1,6 @@
 #include "boot_view.h"
 #include "controllers/screen_manager/screen_manager.h"
+#include "views/theme/theme.h"
 #include "esp_log.h"
 
 static const char* TAG = "BOOT_VIEW";
@@ -8,20 +9,24 @@ BootView::BootView() : BaseView("Boot"), label(nullptr), timer(nullptr) {
     ESP_LOGI(TAG, "Creating Boot view");
     label = lv_label_create(screen);
     lv_label_set_text(label, "Booting...");
-    lv_obj_set_style_text_font(label, &lv_font_montserrat_24, LV_PART_MAIN);
-    lv_obj_set_style_text_color(label, lv_color_black(), LV_PART_MAIN);
+    theme_apply_label(label, THEME_LABEL_TITLE);
     lv_obj_align(label, LV_ALIGN_TOP_MID, 0, 20);
 
     timer = lv_timer_create([](lv_timer_t* t) {
-        switch_screen("Clock");
+        switch_screen(VIEW_CLOCK);
     }, 2000, nullptr);
     lv_timer_set_repeat_count(timer, 1);
 }
 
 BootView::~BootView() {
+    destroy(); // Llamada a destroy()
+}
+
+void BootView::destroy() {
+    // El timer vive en la arena de la vista: hay que borrarlo antes de soltarla
     if (timer) {
         lv_timer_del(timer);
-        timer = nullptr; // Añadido para consistencia
+        timer = nullptr;
     }
-    destroy(); // Llamada a destroy()
+    BaseView::destroy();
 }
\ No newline at end of file
@@ -12,6 +12,8 @@ public:
     BootView();
     virtual ~BootView();
 
+    void destroy() override;
+
     void register_button_handlers() override {}
     void unregister_button_handlers() override {}
 };
@@ -1,33 +1,222 @@
 #include "settings_view.h"
 #include "controllers/button_manager/button_manager.h"
 #include "controllers/screen_manager/screen_manager.h"
+#include "views/theme/theme.h"
+#include "controllers/ui_pipeline/ui_pipeline.h"
+#include "controllers/pedometer/pedometer.h"
+#include "controllers/db_manager/db_manager.h"
+#include "controllers/sd_card/sd_card.h"
+#include "controllers/leds/leds.h"
+#include "controllers/buzzer/buzzer.h"
+#include "esp_heap_caps.h"
 #include "esp_log.h"
+#include <cstdio>
 
 static const char* TAG = "SETTINGS_VIEW";
 
-SettingsView::SettingsView() : BaseView("Settings"), label(nullptr) {
+const int TITLE_HEIGHT = 40;
+const int ROW_HEIGHT = 40;
+const uint32_t REFRESH_PERIOD_MS = 1000;
+
+// Valores del límite de FPS que recorre OK
+static const uint8_t fps_options[] = { 15, 30, 60 };
+static const char* const volume_names[BUZZER_VOLUME_LEVELS] = { "Off", "Low", "Mid", "High" };
+
+enum settings_item_t {
+    ITEM_FPS_CAP = 0,
+    ITEM_STEPS,
+    ITEM_LEDS,
+    ITEM_VOLUME,
+    ITEM_STORAGE,
+    ITEM_SD_CARD,
+    ITEM_FREE_HEAP,
+    ITEM_SPECTRUM,
+    ITEM_SYSTEM_INFO,
+    ITEM_COUNT
+};
+
+static SettingsView* currentSettingsView = nullptr; // Para los handlers de botones
+
+SettingsView::SettingsView() : BaseView("Settings"), title(nullptr),
+                               list(screen, SCREEN_WIDTH, SCREEN_HEIGHT - TITLE_HEIGHT, ROW_HEIGHT, bind_item, this),
+                               timer(nullptr)
+{
     ESP_LOGI(TAG, "Creating Settings view");
-    label = lv_label_create(screen);
-    lv_label_set_text(label, "Settings");
-    lv_obj_set_style_text_font(label, &lv_font_montserrat_24, LV_PART_MAIN);
-    lv_obj_set_style_text_color(label, lv_color_black(), LV_PART_MAIN);
-    lv_obj_align(label, LV_ALIGN_TOP_MID, 0, 20);
+    title = lv_label_create(screen);
+    lv_label_set_text(title, "Settings");
+    theme_apply_label(title, THEME_LABEL_TITLE);
+    lv_obj_align(title, LV_ALIGN_TOP_MID, 0, 8);
+
+    lv_obj_align(list.get_obj(), LV_ALIGN_BOTTOM_MID, 0, 0);
+    list.set_activate_cb(activate_item);
+    list.set_count(ITEM_COUNT);
+
+    timer = lv_timer_create(refresh_timer_cb, REFRESH_PERIOD_MS, this);
+    currentSettingsView = this;
 }
 
 SettingsView::~SettingsView() {
      destroy(); // Llamada a destroy.
 }
 
-void SettingsView::register_button_handlers() {
-    button_manager_register_view_handler(BUTTON_LEFT, []() {
-        switch_screen("Clock");
-    });
+void SettingsView::destroy() {
+    if (currentSettingsView == this) {
+        currentSettingsView = nullptr;
+    }
+    if (timer) {
+        lv_timer_del(timer);
+        timer = nullptr;
+    }
+    BaseView::destroy();
+}
 
-    button_manager_register_view_handler(BUTTON_CANCEL, []() {
-        switch_screen("System Info");
-    });
+void SettingsView::suspend() {
+    if (timer) {
+        lv_timer_pause(timer);
+    }
+}
+
+void SettingsView::resume() {
+    if (timer) {
+        list.refresh();
+        lv_timer_resume(timer);
+    }
+}
+
+void SettingsView::bind_item(uint32_t index, char* title, char* value, size_t cap, void* user) {
+    switch (index) {
+        case ITEM_FPS_CAP: {
+            ui_pipeline_stats_t st;
+            ui_pipeline_get_stats(&st);
+            snprintf(title, cap, "FPS cap");
+            snprintf(value, cap, "%lu", (unsigned long)st.fps_cap);
+            break;
+        }
+        case ITEM_STEPS: {
+            pedometer_snapshot_t snap;
+            pedometer_get_snapshot(&snap);
+            snprintf(title, cap, "Steps");
+            if (pedometer_is_running()) {
+                snprintf(value, cap, "%lu", (unsigned long)snap.steps);
+            } else {
+                snprintf(value, cap, "--");
+            }
+            break;
+        }
+        case ITEM_LEDS:
+            snprintf(title, cap, "LEDs");
+            snprintf(value, cap, "%s", leds_is_running() ? led_fx_name(leds_get_effect()) : "--");
+            break;
+        case ITEM_VOLUME:
+            snprintf(title, cap, "Volume");
+            snprintf(value, cap, "%s", buzzer_is_running() ? volume_names[buzzer_get_volume()] : "--");
+            break;
+        case ITEM_STORAGE: {
+            snprintf(title, cap, "Storage");
+            if (db_manager_is_ready()) {
+                db_manager_stats_t st;
+                db_manager_get_stats(&st);
+                snprintf(value, cap, "%lu/%lu free", (unsigned long)st.store.free_segments,
+                         (unsigned long)st.store.segments);
+            } else {
+                snprintf(value, cap, "--");
+            }
+            break;
+        }
+        case ITEM_SD_CARD:
+            snprintf(title, cap, "SD card");
+            snprintf(value, cap, "%s", sd_card_is_mounted() ? "OK" : "None");
+            break;
+        case ITEM_FREE_HEAP:
+            snprintf(title, cap, "Free RAM");
+            snprintf(value, cap, "%u KB", (unsigned)(heap_caps_get_free_size(MALLOC_CAP_INTERNAL) / 1024));
+            break;
+        case ITEM_SPECTRUM:
+            snprintf(title, cap, "Spectrum");
+            snprintf(value, cap, ">");
+            break;
+        case ITEM_SYSTEM_INFO:
+            snprintf(title, cap, "System info");
+            snprintf(value, cap, ">");
+            break;
+        default:
+            break;
+    }
+}
+
+void SettingsView::activate_item(uint32_t index, void* user) {
+    SettingsView* view = (SettingsView*)user;
+    switch (index) {
+        case ITEM_FPS_CAP: {
+            ui_pipeline_stats_t st;
+            ui_pipeline_get_stats(&st);
+            const size_t n = sizeof(fps_options) / sizeof(fps_options[0]);
+            uint8_t fps = fps_options[0];
+            for (size_t i = 0; i < n; i++) {
+                if (fps_options[i] == st.fps_cap) {
+                    fps = fps_options[(i + 1) % n];
+                    break;
+                }
+            }
+            ui_pipeline_set_fps_cap(fps);
+            // Persistente: main lo restaura al arrancar
+            db_put(SETTINGS_KEY_FPS_CAP, &fps, sizeof(fps));
+            break;
+        }
+        case ITEM_STEPS:
+            pedometer_reset_steps();
+            break;
+        case ITEM_LEDS: {
+            if (!leds_is_running()) return;
+            const uint8_t effect = (uint8_t)((leds_get_effect() + 1) % LED_FX_COUNT);
+            leds_set_effect((led_fx_effect_t)effect);
+            db_put(SETTINGS_KEY_LEDS_FX, &effect, sizeof(effect));
+            break;
+        }
+        case ITEM_VOLUME: {
+            if (!buzzer_is_running()) return;
+            const uint8_t level = (uint8_t)((buzzer_get_volume() + 1) % BUZZER_VOLUME_LEVELS);
+            buzzer_set_volume(level);
+            buzzer_play(buzzer_melody_confirm, true);   // Para oír el nivel nuevo
+            db_put(SETTINGS_KEY_VOLUME, &level, sizeof(level));
+            break;
+        }
+        case ITEM_STORAGE:
+            db_commit();
+            break;
+        case ITEM_SPECTRUM:
+            switch_screen(VIEW_SPECTRUM);
+            return;
+        case ITEM_SYSTEM_INFO:
+            switch_screen(VIEW_SYSTEM_INFO);
+            return;
+        default:
+            return;
+    }
+    view->list.refresh();
+}
+
+void SettingsView::refresh_timer_cb(lv_timer_t* t) {
+    SettingsView* view = (SettingsView*)lv_timer_get_user_data(t);
+    if (view) {
+        view->list.refresh();
+    }
+}
+
+// Tabla de handlers de la vista (indexada por button_id_t)
+static const button_handler_t settings_button_handlers[BUTTON_COUNT] = {
+    []() { if (currentSettingsView) currentSettingsView->select_prev(); },  // BUTTON_LEFT
+    []() { switch_screen(VIEW_CLOCK); },                                    // BUTTON_CANCEL
+    []() { if (currentSettingsView) currentSettingsView->activate(); },     // BUTTON_OK
+    []() { if (currentSettingsView) currentSettingsView->select_next(); },  // BUTTON_RIGHT
+    nullptr,                                                                // BUTTON_ON_OFF
+};
+
+void SettingsView::register_button_handlers() {
+    currentSettingsView = this;
+    button_manager_set_view_handlers(settings_button_handlers);
 }
 
 void SettingsView::unregister_button_handlers() {
-    button_manager_unregister_view_handlers();
-}
\ No newline at end of file
+    button_manager_set_view_handlers(nullptr);
+}
@@ -2,10 +2,21 @@
 #define SETTINGS_VIEW_H
 
 #include "../../base_view.h"
+#include "views/widgets/virtual_list/virtual_list.h"
 
+// Menú de ajustes sobre una VirtualList: LEFT/RIGHT mueven la selección, OK
+// ejecuta la entrada y CANCEL vuelve al reloj. Los valores se piden al
+// controlador correspondiente en cada bind; un lv_timer de 1 s refresca las
+// filas visibles y solo se invalidan las que cambian.
 class SettingsView : public BaseView {
 private:
-    lv_obj_t* label;
+    lv_obj_t* title;
+    VirtualList list;
+    lv_timer_t* timer;
+
+    static void bind_item(uint32_t index, char* title, char* value, size_t cap, void* user);
+    static void activate_item(uint32_t index, void* user);
+    static void refresh_timer_cb(lv_timer_t* t);
 
 public:
     SettingsView();
@@ -13,6 +24,13 @@ public:
 
     void register_button_handlers() override;
     void unregister_button_handlers() override;
+    void destroy() override;
+    void suspend() override;
+    void resume() override;
+
+    void select_next() { list.select_next(); }
+    void select_prev() { list.select_prev(); }
+    void activate() { list.activate(); }
 };
 
-#endif
\ No newline at end of file
+#endif
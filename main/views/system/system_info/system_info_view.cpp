@@ -1,29 +1,170 @@
 #include "system_info_view.h"
 #include "controllers/button_manager/button_manager.h"
 #include "controllers/screen_manager/screen_manager.h"
+#include "views/theme/theme.h"
+#include "controllers/telemetry/telemetry.h"
 #include "esp_log.h"
+#include <cstdio>
+#include <cstring>
 
 static const char* TAG = "SYS_INFO_VIEW";
 
-SystemInfoView::SystemInfoView() : BaseView("System Info"), label(nullptr) {
+const int SYSINFO_FIRST_ROW_Y = 44;
+const int SYSINFO_ROW_HEIGHT = 18;
+const int SYSINFO_MARGIN_X = 8;
+
+// Filas fijas; las de tareas van a continuación
+enum sysinfo_row_t {
+    ROW_INTERNAL = 0,
+    ROW_PSRAM,
+    ROW_LVGL,
+    ROW_FPS,
+    ROW_CPU,
+    ROW_TASKS_HEADER,
+    ROW_FIRST_TASK,
+};
+
+// "512", "45k" o "7.9M"
+static void format_bytes(char* buf, size_t cap, uint32_t bytes) {
+    if (bytes < 10 * 1024) {
+        snprintf(buf, cap, "%lu", (unsigned long)bytes);
+    } else if (bytes < 1024 * 1024) {
+        snprintf(buf, cap, "%luk", (unsigned long)(bytes / 1024));
+    } else {
+        snprintf(buf, cap, "%lu.%luM", (unsigned long)(bytes >> 20), (unsigned long)((bytes & 0xFFFFF) * 10 >> 20));
+    }
+}
+
+SystemInfoView::SystemInfoView() : BaseView("System Info"), label(nullptr), rows(), timer(nullptr) {
     ESP_LOGI(TAG, "Creating System Info view");
     label = lv_label_create(screen);
     lv_label_set_text(label, "System Info");
-    lv_obj_set_style_text_font(label, &lv_font_montserrat_24, LV_PART_MAIN);
-    lv_obj_set_style_text_color(label, lv_color_black(), LV_PART_MAIN);
-    lv_obj_align(label, LV_ALIGN_TOP_MID, 0, 20);
+    theme_apply_label(label, THEME_LABEL_TITLE);
+    lv_obj_align(label, LV_ALIGN_TOP_MID, 0, 8);
+
+    for (int i = 0; i < SYSINFO_ROWS; i++) {
+        const int y = SYSINFO_FIRST_ROW_Y + i * SYSINFO_ROW_HEIGHT;
+        row_t& row = rows[i];
+        row.key = lv_label_create(screen);
+        row.value = lv_label_create(screen);
+        theme_apply_label(row.key, THEME_LABEL_KEY);
+        theme_apply_label(row.value, THEME_LABEL_VALUE);
+        lv_obj_align(row.key, LV_ALIGN_TOP_LEFT, SYSINFO_MARGIN_X, y);
+        lv_obj_align(row.value, LV_ALIGN_TOP_RIGHT, -SYSINFO_MARGIN_X, y);
+        lv_label_set_text_static(row.key, row.key_buf);
+        lv_label_set_text_static(row.value, row.value_buf);
+    }
+
+    update();
+    timer = lv_timer_create(refresh_timer_cb, TELEMETRY_PERIOD_MS, this);
 }
 
 SystemInfoView::~SystemInfoView() {
     destroy(); // Llamada a destroy.
 }
 
+void SystemInfoView::destroy() {
+    if (timer) {
+        lv_timer_del(timer);
+        timer = nullptr;
+    }
+    BaseView::destroy();
+}
+
+void SystemInfoView::suspend() {
+    if (timer) {
+        lv_timer_pause(timer);
+    }
+}
+
+void SystemInfoView::resume() {
+    if (timer) {
+        update();
+        lv_timer_resume(timer);
+    }
+}
+
+void SystemInfoView::refresh_timer_cb(lv_timer_t* t) {
+    static_cast<SystemInfoView*>(lv_timer_get_user_data(t))->update();
+}
+
+// Solo se reasigna (e invalida) el label cuyo texto cambió
+void SystemInfoView::set_row(int index, const char* key, const char* value) {
+    row_t& row = rows[index];
+    if (strcmp(key, row.key_buf) != 0) {
+        strlcpy(row.key_buf, key, sizeof(row.key_buf));
+        lv_label_set_text_static(row.key, row.key_buf);
+    }
+    if (strcmp(value, row.value_buf) != 0) {
+        strlcpy(row.value_buf, value, sizeof(row.value_buf));
+        lv_label_set_text_static(row.value, row.value_buf);
+    }
+}
+
+void SystemInfoView::update() {
+    // static: ~1 KB, y solo la tarea de render actualiza vistas
+    static telemetry_snapshot_t snap;
+    if (!telemetry_is_running()) {
+        set_row(ROW_INTERNAL, "Telemetry", "Off");
+        return;
+    }
+    telemetry_get(&snap);
+
+    char value[64];     // Holgado para -Wformat-truncation; set_row recorta a SYSINFO_TEXT_MAX
+    char a[12], b[12], c[12];
+    const telemetry_value_t* m = snap.metrics;
+
+    format_bytes(a, sizeof(a), m[TELEM_INTERNAL_FREE].cur);
+    format_bytes(b, sizeof(b), m[TELEM_INTERNAL_FREE].min);
+    format_bytes(c, sizeof(c), m[TELEM_INTERNAL_LARGEST].cur);
+    snprintf(value, sizeof(value), "%s, min %s, blk %s", a, b, c);
+    set_row(ROW_INTERNAL, "RAM", value);
+
+    format_bytes(a, sizeof(a), m[TELEM_PSRAM_FREE].cur);
+    format_bytes(b, sizeof(b), m[TELEM_PSRAM_FREE].min);
+    format_bytes(c, sizeof(c), m[TELEM_PSRAM_LARGEST].cur);
+    snprintf(value, sizeof(value), "%s, min %s, blk %s", a, b, c);
+    set_row(ROW_PSRAM, "PSRAM", value);
+
+    format_bytes(a, sizeof(a), m[TELEM_LV_USED].cur);
+    format_bytes(b, sizeof(b), snap.lv_total);
+    snprintf(value, sizeof(value), "%s/%s, frag %lu%%", a, b, (unsigned long)m[TELEM_LV_FRAG].cur);
+    set_row(ROW_LVGL, "LVGL", value);
+
+    snprintf(value, sizeof(value), "%lu (min %lu, avg %lu)", (unsigned long)m[TELEM_FPS].cur,
+             (unsigned long)m[TELEM_FPS].min, (unsigned long)m[TELEM_FPS].avg);
+    set_row(ROW_FPS, "FPS", value);
+
+    snprintf(value, sizeof(value), "%lu%% / %lu%% (max %lu/%lu)", (unsigned long)m[TELEM_CPU0].cur,
+             (unsigned long)m[TELEM_CPU1].cur, (unsigned long)m[TELEM_CPU0].max, (unsigned long)m[TELEM_CPU1].max);
+    set_row(ROW_CPU, "CPU", value);
+
+    set_row(ROW_TASKS_HEADER, "Task", "CPU, stack free");
+    for (int i = 0; i < TELEMETRY_VIEW_TASKS; i++) {
+        if (i < snap.task_count) {
+            const telemetry_task_t& t = snap.tasks[i];
+            format_bytes(a, sizeof(a), t.stack_free);
+            snprintf(value, sizeof(value), "%u%%, %s", t.cpu_pct, a);
+            set_row(ROW_FIRST_TASK + i, t.name, value);
+        } else {
+            set_row(ROW_FIRST_TASK + i, "", "");
+        }
+    }
+}
+
+// Tabla de handlers de la vista (indexada por button_id_t)
+static const button_handler_t system_info_button_handlers[BUTTON_COUNT] = {
+    nullptr,                                    // BUTTON_LEFT
+    nullptr,                                    // BUTTON_CANCEL
+    []() { switch_screen(VIEW_SETTINGS); },     // BUTTON_OK
+    nullptr,                                    // BUTTON_RIGHT
+    nullptr,                                    // BUTTON_ON_OFF
+};
+
 void SystemInfoView::register_button_handlers() {
-    button_manager_register_view_handler(BUTTON_OK, []() {
-        switch_screen("Settings");
-    });
+    button_manager_set_view_handlers(system_info_button_handlers);
 }
 
 void SystemInfoView::unregister_button_handlers() {
-    button_manager_unregister_view_handlers();
-}
\ No newline at end of file
+    button_manager_set_view_handlers(nullptr);
+}
@@ -2,10 +2,31 @@
 #define SYSTEM_INFO_VIEW_H
 
 #include "../../base_view.h"
+#include "config.h"
 
+#define SYSINFO_ROWS        (6 + TELEMETRY_VIEW_TASKS)
+#define SYSINFO_TEXT_MAX    32
+
+// Telemetría en pantalla: heap interno y PSRAM, pool de LVGL, FPS, carga por
+// núcleo y las tareas que más CPU gastan. Un lv_timer de TELEMETRY_PERIOD_MS
+// lee la última muestra de controllers/telemetry; cada fila guarda su texto
+// y solo se toca (e invalida) el label que cambia.
 class SystemInfoView : public BaseView {
 private:
+    typedef struct {
+        lv_obj_t* key;
+        lv_obj_t* value;
+        char key_buf[SYSINFO_TEXT_MAX];
+        char value_buf[SYSINFO_TEXT_MAX];
+    } row_t;
+
     lv_obj_t* label;
+    row_t rows[SYSINFO_ROWS];
+    lv_timer_t* timer;
+
+    void set_row(int index, const char* key, const char* value);
+    void update();
+    static void refresh_timer_cb(lv_timer_t* t);
 
 public:
     SystemInfoView();
@@ -13,6 +34,9 @@ public:
 
     void register_button_handlers() override;
     void unregister_button_handlers() override;
+    void destroy() override;
+    void suspend() override;
+    void resume() override;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,181 @@
+#include "theme.h"
+#include "controllers/fs_manager/fs_manager.h"
+#include "controllers/mem_manager/mem_manager.h"
+#include "esp_cpu.h"
+#include "esp_private/esp_clk.h"
+
+#define THEME_AUDIT_MAX_OBJS 128
+
+// Estilos const: tablas de propiedades en flash, sin lv_style_init ni heap
+static const lv_style_const_prop_t screen_props[] = {
+    LV_STYLE_CONST_BG_COLOR(LV_COLOR_MAKE(0xFF, 0xFF, 0xFF)),
+    LV_STYLE_CONST_PROPS_END
+};
+LV_STYLE_CONST_INIT(theme_screen, screen_props);
+
+static const lv_style_const_prop_t grid_props[] = {
+    LV_STYLE_CONST_BG_COLOR(LV_COLOR_MAKE(0xDD, 0xDD, 0xDD)),
+    LV_STYLE_CONST_PROPS_END
+};
+LV_STYLE_CONST_INIT(theme_grid, grid_props);
+
+static const lv_style_const_prop_t grid_cell_props[] = {
+    LV_STYLE_CONST_RADIUS(3),
+    LV_STYLE_CONST_BORDER_WIDTH(1),
+    LV_STYLE_CONST_BORDER_COLOR(LV_COLOR_MAKE(0x00, 0x00, 0x00)),
+    LV_STYLE_CONST_BG_COLOR(LV_COLOR_MAKE(0xFF, 0xFF, 0xFF)),
+    LV_STYLE_CONST_PROPS_END
+};
+LV_STYLE_CONST_INIT(theme_grid_cell, grid_cell_props);
+
+static const lv_style_const_prop_t panel_dark_props[] = {
+    LV_STYLE_CONST_PAD_TOP(THEME_PANEL_PAD),
+    LV_STYLE_CONST_PAD_BOTTOM(THEME_PANEL_PAD),
+    LV_STYLE_CONST_PAD_LEFT(THEME_PANEL_PAD),
+    LV_STYLE_CONST_PAD_RIGHT(THEME_PANEL_PAD),
+    LV_STYLE_CONST_BORDER_WIDTH(0),
+    LV_STYLE_CONST_RADIUS(4),
+    LV_STYLE_CONST_BG_COLOR(LV_COLOR_MAKE(0x20, 0x20, 0x20)),
+    LV_STYLE_CONST_PROPS_END
+};
+LV_STYLE_CONST_INIT(theme_panel_dark, panel_dark_props);
+
+static const lv_style_const_prop_t body_props[] = {
+    LV_STYLE_CONST_TEXT_COLOR(LV_COLOR_MAKE(0x00, 0x00, 0x00)),
+    LV_STYLE_CONST_PROPS_END
+};
+LV_STYLE_CONST_INIT(theme_label_body, body_props);
+
+// Labels con fuente: la fuente puede salir del pack de assets, se fijan al primer uso
+static lv_style_t label_title;
+static lv_style_t label_clock;
+static lv_style_t label_key;
+static lv_style_t label_value;
+static bool labels_ready = false;
+
+static void init_label_styles() {
+    if (labels_ready) return;
+    labels_ready = true;
+
+    // Los estilos sobreviven a la vista que los pide primero: fuera de su arena
+    mem_arena_t* previous = mem_arena_enter(nullptr);
+
+    lv_style_init(&label_title);
+    lv_style_set_text_font(&label_title, fs_manager_font_or("montserrat_24", &lv_font_montserrat_24));
+    lv_style_set_text_color(&label_title, lv_color_black());
+
+    lv_style_init(&label_clock);
+    lv_style_set_text_font(&label_clock, fs_manager_font_or("montserrat_36", &lv_font_montserrat_36));
+
+    const lv_font_t* small = fs_manager_font_or("montserrat_14", &lv_font_montserrat_14);
+    lv_style_init(&label_key);
+    lv_style_set_text_font(&label_key, small);
+    lv_style_set_text_color(&label_key, lv_color_hex(0x404040));
+
+    lv_style_init(&label_value);
+    lv_style_set_text_font(&label_value, small);
+    lv_style_set_text_color(&label_value, lv_color_black());
+
+    mem_arena_exit(previous);
+}
+
+const lv_style_t* theme_label_style(theme_label_t kind) {
+    switch (kind) {
+        case THEME_LABEL_BODY:
+            return &theme_label_body;
+        case THEME_LABEL_TITLE:
+            init_label_styles();
+            return &label_title;
+        case THEME_LABEL_CLOCK:
+            init_label_styles();
+            return &label_clock;
+        case THEME_LABEL_KEY:
+            init_label_styles();
+            return &label_key;
+        case THEME_LABEL_VALUE:
+        default:
+            init_label_styles();
+            return &label_value;
+    }
+}
+
+void theme_apply_label(lv_obj_t* label, theme_label_t kind) {
+    lv_obj_add_style(label, theme_label_style(kind), LV_PART_MAIN);
+}
+
+void theme_cell_dsc(lv_draw_rect_dsc_t* dsc) {
+    lv_draw_rect_dsc_init(dsc);
+    lv_style_value_t v;
+    if (lv_style_get_prop(&theme_grid_cell, LV_STYLE_RADIUS, &v) == LV_STYLE_RES_FOUND) dsc->radius = v.num;
+    if (lv_style_get_prop(&theme_grid_cell, LV_STYLE_BORDER_WIDTH, &v) == LV_STYLE_RES_FOUND) dsc->border_width = v.num;
+    if (lv_style_get_prop(&theme_grid_cell, LV_STYLE_BORDER_COLOR, &v) == LV_STYLE_RES_FOUND) dsc->border_color = v.color;
+    if (lv_style_get_prop(&theme_grid_cell, LV_STYLE_BG_COLOR, &v) == LV_STYLE_RES_FOUND) dsc->bg_color = v.color;
+}
+
+// Partes y estados que usan los widgets del proyecto
+static const lv_part_t audit_parts[] = {
+    LV_PART_MAIN, LV_PART_SCROLLBAR, LV_PART_INDICATOR, LV_PART_KNOB, LV_PART_SELECTED, LV_PART_ITEMS, LV_PART_CURSOR,
+};
+static const lv_state_t audit_states[] = { LV_STATE_DEFAULT, LV_STATE_CHECKED, LV_STATE_PRESSED, LV_STATE_FOCUSED };
+
+// Lo que se lee al dibujar un lv_obj o un label
+static const lv_style_prop_t resolve_props[] = {
+    LV_STYLE_BG_COLOR, LV_STYLE_BG_OPA, LV_STYLE_BORDER_WIDTH, LV_STYLE_RADIUS,
+    LV_STYLE_PAD_TOP, LV_STYLE_TEXT_COLOR, LV_STYLE_TEXT_FONT,
+};
+
+typedef struct {
+    lv_obj_t* objs[THEME_AUDIT_MAX_OBJS];
+    uint32_t count;
+} audit_walk_t;
+
+static lv_obj_tree_walk_res_t audit_collect_cb(lv_obj_t* obj, void* user) {
+    audit_walk_t* walk = (audit_walk_t*)user;
+    if (walk->count < THEME_AUDIT_MAX_OBJS) {
+        walk->objs[walk->count] = obj;
+    }
+    walk->count++;
+    return LV_OBJ_TREE_WALK_NEXT;
+}
+
+void theme_audit(lv_obj_t* root, uint32_t rounds, theme_audit_t* out) {
+    // static: la lista de objetos no cabe con holgura en la pila de la tarea principal
+    static audit_walk_t walk;
+    *out = {};
+    walk.count = 0;
+    lv_obj_tree_walk(root, audit_collect_cb, &walk);
+    out->objs = walk.count;
+    const uint32_t n = walk.count < THEME_AUDIT_MAX_OBJS ? walk.count : THEME_AUDIT_MAX_OBJS;
+
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t props = 0;
+        for (lv_part_t part : audit_parts) {
+            for (lv_state_t state : audit_states) {
+                for (uint32_t prop = 1; prop < LV_STYLE_LAST_BUILT_IN_PROP; prop++) {
+                    lv_style_value_t v;
+                    if (lv_obj_get_local_style_prop(walk.objs[i], (lv_style_prop_t)prop, &v, part | state) == LV_RESULT_OK) {
+                        props++;
+                    }
+                }
+            }
+        }
+        out->local_props += props;
+        if (props) out->local_objs++;
+    }
+
+    // Resolución: cada búsqueda recorre los estilos del objeto (y de sus padres si se hereda)
+    uint32_t sink = 0;
+    const uint32_t c0 = esp_cpu_get_cycle_count();
+    for (uint32_t r = 0; r < rounds; r++) {
+        for (uint32_t i = 0; i < n; i++) {
+            for (lv_style_prop_t prop : resolve_props) {
+                sink += lv_obj_get_style_prop(walk.objs[i], LV_PART_MAIN, prop).num;
+            }
+        }
+    }
+    const uint32_t cycles = esp_cpu_get_cycle_count() - c0;
+    (void)sink;
+
+    out->lookups = rounds * n * (sizeof(resolve_props) / sizeof(resolve_props[0]));
+    out->resolve_ns_avg = out->lookups ? (uint32_t)((uint64_t)cycles * 1000000000ULL / esp_clk_cpu_freq() / out->lookups) : 0;
+}
@@ -0,0 +1,53 @@
+#ifndef THEME_H
+#define THEME_H
+
+#include "lvgl.h"
+#include <stdint.h>
+
+// Estilos compartidos por todas las vistas. En lugar de propiedades locales
+// objeto a objeto (cada una reserva en el heap de LVGL y alarga la búsqueda de
+// estilos), los objetos añaden con lv_obj_add_style uno de estos estilos.
+//
+// Los que no dependen de nada en tiempo de ejecución son const
+// (LV_STYLE_CONST_INIT): viven en flash y no reservan nada. Los de los labels
+// llevan una fuente que puede venir del pack de assets, así que se crean una
+// vez, fuera de cualquier arena, la primera vez que se piden.
+
+#define THEME_PANEL_PAD     6       // Margen interior de theme_panel_dark
+
+extern const lv_style_t theme_screen;       // Fondo de las pantallas
+extern const lv_style_t theme_grid;         // Fondo de la cuadrícula de segundos
+extern const lv_style_t theme_grid_cell;    // Celda apagada: radio, borde y fondo
+extern const lv_style_t theme_panel_dark;   // Panel oscuro (barras del espectro)
+
+typedef enum {
+    THEME_LABEL_TITLE,      // montserrat_24, negro
+    THEME_LABEL_CLOCK,      // montserrat_36, color heredado
+    THEME_LABEL_BODY,       // Fuente por defecto, negro
+    THEME_LABEL_KEY,        // montserrat_14, gris
+    THEME_LABEL_VALUE,      // montserrat_14, negro
+    THEME_LABEL_COUNT
+} theme_label_t;
+
+const lv_style_t* theme_label_style(theme_label_t kind);
+
+// Atajo: añade a 'label' el estilo compartido de su tipo
+void theme_apply_label(lv_obj_t* label, theme_label_t kind);
+
+// Descriptor de dibujo de una celda a partir de theme_grid_cell, para los
+// widgets que pintan celdas a mano sin un lv_obj por celda
+void theme_cell_dsc(lv_draw_rect_dsc_t* dsc);
+
+typedef struct {
+    uint32_t objs;              // Objetos en el árbol
+    uint32_t local_objs;        // Objetos con al menos una propiedad local
+    uint32_t local_props;       // Propiedades locales (todas las partes y estados auditados)
+    uint32_t lookups;           // Búsquedas de estilo medidas
+    uint32_t resolve_ns_avg;    // Coste medio de lv_obj_get_style_prop
+} theme_audit_t;
+
+// Cuenta las propiedades locales bajo 'root' y mide cuánto cuesta resolver
+// las propiedades que se leen al dibujar ('rounds' pasadas por el árbol)
+void theme_audit(lv_obj_t* root, uint32_t rounds, theme_audit_t* out);
+
+#endif
@@ -0,0 +1,288 @@
+#include "virtual_list.h"
+#include "controllers/fs_manager/fs_manager.h"
+#include "controllers/mem_manager/mem_manager.h"
+#include <cstring>
+
+static const int32_t ROW_PAD_X = 8;
+static const int32_t THUMB_WIDTH = 3;
+static const int32_t THUMB_MIN_HEIGHT = 12;
+static const uint32_t NO_INDEX = UINT32_MAX;
+
+// Estilos compartidos por todas las filas de todas las listas: ningún objeto
+// lleva propiedades locales, así que una fila cuesta solo su lv_obj y dos labels
+static lv_style_t style_list;
+static lv_style_t style_row;
+static lv_style_t style_row_checked;
+static lv_style_t style_thumb;
+static bool styles_ready = false;
+
+static void init_styles() {
+    if (styles_ready) return;
+    styles_ready = true;
+
+    // Los estilos sobreviven a la vista que los crea: fuera de su arena
+    mem_arena_t* previous = mem_arena_enter(nullptr);
+
+    lv_style_init(&style_list);
+    lv_style_set_bg_color(&style_list, lv_color_white());
+    lv_style_set_bg_opa(&style_list, LV_OPA_COVER);
+
+    lv_style_init(&style_row);
+    lv_style_set_bg_color(&style_row, lv_color_white());
+    lv_style_set_bg_opa(&style_row, LV_OPA_COVER);
+    lv_style_set_border_side(&style_row, LV_BORDER_SIDE_BOTTOM);
+    lv_style_set_border_width(&style_row, 1);
+    lv_style_set_border_color(&style_row, lv_color_hex(0xDDDDDD));
+    lv_style_set_text_color(&style_row, lv_color_black());
+    lv_style_set_text_font(&style_row, fs_manager_font_or("montserrat_20", &lv_font_montserrat_20));
+
+    lv_style_init(&style_row_checked);
+    lv_style_set_bg_color(&style_row_checked, lv_color_hex(0x2196F3));
+    lv_style_set_text_color(&style_row_checked, lv_color_white());
+
+    lv_style_init(&style_thumb);
+    lv_style_set_bg_color(&style_thumb, lv_color_hex(0x888888));
+    lv_style_set_bg_opa(&style_thumb, LV_OPA_COVER);
+    lv_style_set_radius(&style_thumb, 1);
+
+    mem_arena_exit(previous);
+}
+
+VirtualList::VirtualList(lv_obj_t* parent, int32_t width, int32_t height, int32_t row_height,
+                         bind_cb_t bind, void* user)
+    : obj(nullptr), thumb(nullptr), width(width), height(height), row_height(row_height),
+      scroll_y(0), count(0), selected(0), binds(0), bind_cb(bind), activate_cb(nullptr), user(user)
+{
+    init_styles();
+
+    obj = lv_obj_create(parent);
+    lv_obj_remove_style_all(obj);
+    lv_obj_add_style(obj, &style_list, LV_PART_MAIN);
+    lv_obj_set_size(obj, width, height);
+    lv_obj_clear_flag(obj, LV_OBJ_FLAG_SCROLLABLE | LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_add_event_cb(obj, delete_event_cb, LV_EVENT_DELETE, this);
+
+    // Filas visibles (la primera y la última pueden verse a medias) + margen
+    const size_t pool = (size_t)((height + row_height - 1) / row_height + 1 + VLIST_MARGIN_ROWS);
+    rows.resize(pool);
+    for (Row& row : rows) {
+        row.index = NO_INDEX;
+        row.title_buf[0] = '\0';
+        row.value_buf[0] = '\0';
+
+        row.obj = lv_obj_create(obj);
+        lv_obj_remove_style_all(row.obj);
+        lv_obj_add_style(row.obj, &style_row, LV_PART_MAIN);
+        lv_obj_add_style(row.obj, &style_row_checked, LV_PART_MAIN | LV_STATE_CHECKED);
+        lv_obj_set_size(row.obj, width, row_height);
+        lv_obj_clear_flag(row.obj, LV_OBJ_FLAG_SCROLLABLE | LV_OBJ_FLAG_CLICKABLE);
+        lv_obj_add_flag(row.obj, LV_OBJ_FLAG_HIDDEN);
+
+        row.title = lv_label_create(row.obj);
+        lv_label_set_long_mode(row.title, LV_LABEL_LONG_CLIP);
+        lv_obj_set_width(row.title, width * 3 / 5 - ROW_PAD_X);
+        lv_obj_align(row.title, LV_ALIGN_LEFT_MID, ROW_PAD_X, 0);
+        lv_label_set_text_static(row.title, row.title_buf);
+
+        row.value = lv_label_create(row.obj);
+        lv_obj_align(row.value, LV_ALIGN_RIGHT_MID, -ROW_PAD_X - THUMB_WIDTH, 0);
+        lv_label_set_text_static(row.value, row.value_buf);
+    }
+
+    thumb = lv_obj_create(obj);
+    lv_obj_remove_style_all(thumb);
+    lv_obj_add_style(thumb, &style_thumb, LV_PART_MAIN);
+    lv_obj_clear_flag(thumb, LV_OBJ_FLAG_SCROLLABLE | LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_add_flag(thumb, LV_OBJ_FLAG_HIDDEN);
+}
+
+VirtualList::~VirtualList() {
+    lv_anim_delete(this, anim_exec_cb);
+    // Normalmente la pantalla de la vista ya se ha borrado (delete_event_cb)
+    if (obj) {
+        lv_obj_delete(obj);
+    }
+}
+
+void VirtualList::delete_event_cb(lv_event_t* e) {
+    VirtualList* list = (VirtualList*)lv_event_get_user_data(e);
+    lv_anim_delete(list, anim_exec_cb);
+    list->obj = nullptr;
+    list->thumb = nullptr;
+    for (Row& row : list->rows) {
+        row.obj = row.title = row.value = nullptr;
+    }
+}
+
+int32_t VirtualList::max_scroll() const {
+    const int64_t content = (int64_t)count * row_height;
+    return content > height ? (int32_t)(content - height) : 0;
+}
+
+void VirtualList::bind_row(Row& row, uint32_t index, bool force) {
+    const bool same = row.index == index;
+    if (same && !force) return;
+
+    char title[VLIST_TEXT_MAX] = "";
+    char value[VLIST_TEXT_MAX] = "";
+    bind_cb(index, title, value, VLIST_TEXT_MAX, user);
+    title[VLIST_TEXT_MAX - 1] = '\0';
+    value[VLIST_TEXT_MAX - 1] = '\0';
+    binds++;
+
+    // Un refresco que no cambia el texto no invalida nada
+    if (strcmp(title, row.title_buf) != 0) {
+        strcpy(row.title_buf, title);
+        lv_label_set_text_static(row.title, row.title_buf);
+    }
+    if (strcmp(value, row.value_buf) != 0) {
+        strcpy(row.value_buf, value);
+        lv_label_set_text_static(row.value, row.value_buf);
+    }
+
+    row.index = index;
+}
+
+void VirtualList::layout(bool force) {
+    if (!obj) return;
+
+    const uint32_t pool = (uint32_t)rows.size();
+    const uint32_t first = (uint32_t)(scroll_y / row_height);
+    for (uint32_t k = first; k < first + pool; k++) {
+        Row& row = rows[k % pool];
+        if (k >= count) {
+            if (row.index != NO_INDEX) {
+                row.index = NO_INDEX;
+                lv_obj_add_flag(row.obj, LV_OBJ_FLAG_HIDDEN);
+            }
+            continue;
+        }
+        if (row.index == NO_INDEX) {
+            lv_obj_remove_flag(row.obj, LV_OBJ_FLAG_HIDDEN);
+        }
+        bind_row(row, k, force);
+        // CHECKED no depende del bind: set_count puede recortar la selección a
+        // un elemento cuya fila ya estaba enlazada. Sin cambio no se invalida nada.
+        if (k == selected) {
+            lv_obj_add_state(row.obj, LV_STATE_CHECKED);
+        } else {
+            lv_obj_remove_state(row.obj, LV_STATE_CHECKED);
+        }
+        // Sin cambio de posición LVGL no invalida la fila
+        lv_obj_set_y(row.obj, (int32_t)k * row_height - scroll_y);
+    }
+}
+
+void VirtualList::update_thumb() {
+    if (!thumb) return;
+
+    const int64_t content = (int64_t)count * row_height;
+    if (content <= height) {
+        lv_obj_add_flag(thumb, LV_OBJ_FLAG_HIDDEN);
+        return;
+    }
+    int32_t h = (int32_t)((int64_t)height * height / content);
+    if (h < THUMB_MIN_HEIGHT) h = THUMB_MIN_HEIGHT;
+    const int32_t y = (int32_t)((int64_t)(height - h) * scroll_y / max_scroll());
+
+    lv_obj_set_size(thumb, THUMB_WIDTH, h);
+    lv_obj_set_pos(thumb, width - THUMB_WIDTH, y);
+    lv_obj_remove_flag(thumb, LV_OBJ_FLAG_HIDDEN);
+}
+
+void VirtualList::scroll_to(int32_t y) {
+    const int32_t limit = max_scroll();
+    if (y > limit) y = limit;
+    if (y < 0) y = 0;
+    if (y == scroll_y) return;
+
+    scroll_y = y;
+    layout(false);
+    update_thumb();
+}
+
+void VirtualList::anim_exec_cb(void* var, int32_t v) {
+    ((VirtualList*)var)->scroll_to(v);
+}
+
+void VirtualList::ensure_visible(uint32_t index, bool animate) {
+    const int32_t top = (int32_t)index * row_height;
+    int32_t target = scroll_y;
+    if (top < scroll_y) {
+        target = top;
+    } else if (top + row_height > scroll_y + height) {
+        target = top + row_height - height;
+    }
+
+    lv_anim_delete(this, anim_exec_cb);
+    if (target == scroll_y) return;
+    if (!animate) {
+        scroll_to(target);
+        return;
+    }
+
+    lv_anim_t a;
+    lv_anim_init(&a);
+    lv_anim_set_var(&a, this);
+    lv_anim_set_exec_cb(&a, anim_exec_cb);
+    lv_anim_set_values(&a, scroll_y, target);
+    lv_anim_set_duration(&a, VLIST_SCROLL_MS);
+    lv_anim_set_path_cb(&a, lv_anim_path_ease_out);
+    lv_anim_start(&a);
+}
+
+void VirtualList::set_count(uint32_t new_count) {
+    count = new_count;
+    if (selected >= count) {
+        selected = count ? count - 1 : 0;
+    }
+
+    lv_anim_delete(this, anim_exec_cb);
+    const int32_t limit = max_scroll();
+    if (scroll_y > limit) {
+        scroll_y = limit;
+    }
+    layout(true);
+    update_thumb();
+}
+
+void VirtualList::select(uint32_t index, bool animate) {
+    if (count == 0) return;
+    if (index >= count) index = count - 1;
+
+    if (index != selected && obj) {
+        // Solo las dos filas afectadas cambian de estado (si están en el pool)
+        const uint32_t pool = (uint32_t)rows.size();
+        Row& old_row = rows[selected % pool];
+        if (old_row.index == selected) {
+            lv_obj_remove_state(old_row.obj, LV_STATE_CHECKED);
+        }
+        Row& new_row = rows[index % pool];
+        if (new_row.index == index) {
+            lv_obj_add_state(new_row.obj, LV_STATE_CHECKED);
+        }
+    }
+    selected = index;
+    ensure_visible(index, animate);
+}
+
+void VirtualList::select_next() {
+    if (count == 0) return;
+    // Tres botones: al llegar al final se vuelve al principio
+    select(selected + 1 < count ? selected + 1 : 0, true);
+}
+
+void VirtualList::select_prev() {
+    if (count == 0) return;
+    select(selected > 0 ? selected - 1 : count - 1, true);
+}
+
+void VirtualList::activate() {
+    if (activate_cb && count > 0) {
+        activate_cb(selected, user);
+    }
+}
+
+void VirtualList::refresh() {
+    layout(true);
+}
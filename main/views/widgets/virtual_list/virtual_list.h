@@ -0,0 +1,81 @@
+#ifndef VIRTUAL_LIST_H
+#define VIRTUAL_LIST_H
+
+#include "lvgl.h"
+#include "config.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// Lista virtual: solo existen los objetos de las filas visibles más
+// VLIST_MARGIN_ROWS. El elemento k va siempre a la fila k % filas, así que al
+// avanzar una fila solo se reasigna un objeto y solo se llama una vez a 'bind'.
+// El contenido no vive en LVGL: el desplazamiento es un offset propio y la
+// memoria no depende del número de elementos.
+class VirtualList {
+public:
+    // Rellena título y valor del elemento 'index' (buffers de 'cap' bytes)
+    typedef void (*bind_cb_t)(uint32_t index, char* title, char* value, size_t cap, void* user);
+    typedef void (*activate_cb_t)(uint32_t index, void* user);
+
+private:
+    struct Row {
+        lv_obj_t* obj;
+        lv_obj_t* title;
+        lv_obj_t* value;
+        uint32_t index;                 // Elemento enlazado (UINT32_MAX = ninguno)
+        char title_buf[VLIST_TEXT_MAX]; // Texto estático de los labels: sin copias en el heap de LVGL
+        char value_buf[VLIST_TEXT_MAX];
+    };
+
+    lv_obj_t* obj;
+    lv_obj_t* thumb;                    // Indicador de posición
+    std::vector<Row> rows;              // Tamaño fijo desde el constructor (los labels apuntan a sus buffers)
+    int32_t width;
+    int32_t height;
+    int32_t row_height;
+    int32_t scroll_y;
+    uint32_t count;
+    uint32_t selected;
+    uint32_t binds;
+    bind_cb_t bind_cb;
+    activate_cb_t activate_cb;
+    void* user;
+
+    int32_t max_scroll() const;
+    void bind_row(Row& row, uint32_t index, bool force);
+    void layout(bool force);
+    void update_thumb();
+    void ensure_visible(uint32_t index, bool animate);
+    static void anim_exec_cb(void* var, int32_t v);
+    static void delete_event_cb(lv_event_t* e);
+
+public:
+    VirtualList(lv_obj_t* parent, int32_t width, int32_t height, int32_t row_height,
+                bind_cb_t bind, void* user);
+    ~VirtualList();
+
+    lv_obj_t* get_obj() const { return obj; }
+    uint32_t get_count() const { return count; }
+    uint32_t get_selected() const { return selected; }
+    size_t get_row_pool() const { return rows.size(); }
+    uint32_t get_bind_count() const { return binds; }
+    int32_t get_scroll() const { return scroll_y; }
+
+    void set_count(uint32_t count);
+    void set_activate_cb(activate_cb_t cb) { activate_cb = cb; }
+
+    // Selección con animación corta (VLIST_SCROLL_MS) hasta dejarla visible
+    void select(uint32_t index, bool animate);
+    void select_next();
+    void select_prev();
+    void activate();
+
+    // Desplazamiento directo en píxeles (sin cambiar la selección)
+    void scroll_to(int32_t y);
+
+    // Vuelve a pedir el texto de las filas visibles; solo toca los labels que cambian
+    void refresh();
+};
+
+#endif
@@ -0,0 +1,407 @@
+#!/usr/bin/env python3
+"""Empaqueta imágenes y fuentes en un blob para la partición 'assets'.
+
+Formato: main/controllers/fs_manager/asset_pack_format.h
+
+Entrada (directorio, por defecto ./assets):
+  images/*.png   -> RGB565, o RGB565A8 si hay transparencia (requiere Pillow)
+  images/*.bin   -> imagen binaria de LVGL 9 (LVGLImage.py), se copia tal cual
+  fonts/*.bin    -> fuente de lv_font_conv --format bin --no-compress
+  raw/*          -> bytes tal cual
+El nombre de cada asset es el del fichero sin extensión.
+
+Uso:
+  pack_assets.py pack [-i assets] [-o build/assets.bin] [--max-size 0x200000]
+  pack_assets.py list build/assets.bin
+  pack_assets.py bench build/assets.bin [-n 10000]
+"""
+
+import argparse
+import os
+import struct
+import sys
+import time
+import zlib
+
+MAGIC = 0x4B415041
+VERSION = 1
+DATA_ALIGN = 16
+
+HEADER_FMT = '<IHHIIIIII'
+ENTRY_FMT = '<IIIIBBHHH'
+FONT_HEADER_FMT = '<HhhhBBHIIII'
+FONT_CMAP_FMT = '<IHHIIHBB'
+HEADER_SIZE = struct.calcsize(HEADER_FMT)
+ENTRY_SIZE = struct.calcsize(ENTRY_FMT)
+
+TYPE_RAW, TYPE_IMAGE, TYPE_FONT = 0, 1, 2
+TYPE_NAMES = {TYPE_RAW: 'raw', TYPE_IMAGE: 'image', TYPE_FONT: 'font'}
+
+# lv_color_format_t (LVGL 9)
+CF_RGB565 = 0x12
+CF_RGB565A8 = 0x14
+LV_IMAGE_HEADER_MAGIC = 0x19
+
+# lv_font_fmt_txt_cmap_type_t
+CMAP_FORMAT0_FULL, CMAP_SPARSE_FULL, CMAP_FORMAT0_TINY, CMAP_SPARSE_TINY = 0, 1, 2, 3
+
+
+def fnv1a(name):
+    h = 2166136261
+    for b in name.encode('utf-8'):
+        h ^= b
+        h = (h * 16777619) & 0xFFFFFFFF
+    return h
+
+
+def align(value, to):
+    return (value + to - 1) // to * to
+
+
+def pad_to(buf, to):
+    buf.extend(b'\0' * (align(len(buf), to) - len(buf)))
+
+
+# --- Imágenes --------------------------------------------------------------
+
+def convert_png(path):
+    try:
+        from PIL import Image
+    except ImportError:
+        sys.exit('Pillow no está instalado: pip install pillow (o usa imágenes .bin de LVGLImage.py)')
+
+    img = Image.open(path).convert('RGBA')
+    w, h = img.size
+    pixels = img.tobytes()
+    has_alpha = any(pixels[i] != 255 for i in range(3, len(pixels), 4))
+
+    color = bytearray(w * h * 2)
+    alpha = bytearray(w * h) if has_alpha else None
+    for i in range(w * h):
+        r, g, b, a = pixels[i * 4:i * 4 + 4]
+        struct.pack_into('<H', color, i * 2, ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3))
+        if alpha is not None:
+            alpha[i] = a
+
+    if alpha is None:
+        return CF_RGB565, w, h, w * 2, bytes(color)
+    # RGB565A8: plano de color seguido del plano alfa (stride w)
+    return CF_RGB565A8, w, h, w * 2, bytes(color) + bytes(alpha)
+
+
+def read_lvgl_image_bin(path):
+    data = open(path, 'rb').read()
+    magic, cf, _flags, w, h, stride, _reserved = struct.unpack_from('<BBHHHHH', data, 0)
+    if magic != LV_IMAGE_HEADER_MAGIC:
+        sys.exit('%s: no es una imagen binaria de LVGL 9' % path)
+    return cf, w, h, stride, data[12:]
+
+
+# --- Fuentes (lv_font_conv --format bin) ---------------------------------------
+
+class BitReader:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def read(self, n):
+        value = 0
+        for _ in range(n):
+            byte = self.data[self.pos >> 3] if (self.pos >> 3) < len(self.data) else 0
+            value = (value << 1) | ((byte >> (7 - (self.pos & 7))) & 1)
+            self.pos += 1
+        return value
+
+    def read_signed(self, n):
+        value = self.read(n)
+        if n and value & (1 << (n - 1)):
+            value -= 1 << n
+        return value
+
+
+def read_tables(data):
+    tables = {}
+    pos = 0
+    while pos + 8 <= len(data):
+        size, tag = struct.unpack_from('<I4s', data, pos)
+        if size < 8:
+            break
+        tables[tag.decode('ascii')] = data[pos:pos + size]
+        pos += size
+    return tables
+
+
+def convert_font(path):
+    tables = read_tables(open(path, 'rb').read())
+    for tag in ('head', 'cmap', 'loca', 'glyf'):
+        if tag not in tables:
+            sys.exit('%s: falta la tabla %s' % (path, tag))
+
+    head = tables['head']
+    (_version, _tables, _size, ascent, descent, _ta, _td, _tlg, _miny, _maxy, default_adv, _kern_scale,
+     loc_fmt, _gid_fmt, adv_fmt, bpp, xy_bits, wh_bits, adv_bits, compression, subpx, _pad) = \
+        struct.unpack_from('<IHHHhHhHhhHHBBBBBBBBBB', head, 8)
+    underline_pos, underline_thick = 0, 0
+    if len(head) >= 8 + 40:
+        underline_pos, underline_thick = struct.unpack_from('<hH', head, 8 + 36)
+    if compression != 0:
+        sys.exit('%s: fuente comprimida, genera con --no-compress' % path)
+
+    # loca + glyf -> glyph_dsc (8 bytes, layout de lv_font_fmt_txt_glyph_dsc_t) y bitmaps
+    loca = tables['loca']
+    count = struct.unpack_from('<I', loca, 8)[0]
+    ofs_fmt = '<%d%s' % (count, 'H' if loc_fmt == 0 else 'I')
+    offsets = list(struct.unpack_from(ofs_fmt, loca, 12))
+    glyf = tables['glyf']
+
+    glyph_dsc = bytearray()
+    bitmap = bytearray()
+    for i in range(count):
+        start = offsets[i]
+        end = offsets[i + 1] if i + 1 < count else len(glyf)
+        if start < 8 or end <= start:
+            glyph_dsc += struct.pack('<IBBbb', 0, 0, 0, 0, 0)
+            continue
+        bits = BitReader(glyf[start:end])
+        adv = bits.read(adv_bits) if adv_bits else default_adv
+        if adv_fmt == 0:
+            adv *= 16
+        ofs_x = bits.read_signed(xy_bits)
+        ofs_y = bits.read_signed(xy_bits)
+        box_w = bits.read(wh_bits)
+        box_h = bits.read(wh_bits)
+
+        bitmap_index = len(bitmap)
+        if bitmap_index >= 1 << 20 or adv >= 1 << 12:
+            sys.exit('%s: fuente demasiado grande para LV_FONT_FMT_TXT_LARGE = 0' % path)
+        # Píxeles seguidos MSB primero, sin relleno entre filas (igual que lv_font_fmt_txt)
+        nbits = box_w * box_h * bpp
+        out = BitWriter()
+        for _ in range(nbits):
+            out.write(bits.read(1))
+        bitmap += out.bytes()
+        glyph_dsc += struct.pack('<IBBbb', bitmap_index | (adv << 20), box_w, box_h, ofs_x, ofs_y)
+
+    # cmap: las listas se copian; los punteros se resuelven en el dispositivo
+    cmap = tables['cmap']
+    cmap_num = struct.unpack_from('<I', cmap, 8)[0]
+    cmaps = []
+    for i in range(cmap_num):
+        data_ofs, range_start, range_len, gid_start, entries, fmt, _p = \
+            struct.unpack_from('<IIHHHBB', cmap, 12 + i * 16)
+        unicode_list = glyph_ids = None
+        if fmt == CMAP_FORMAT0_FULL:
+            glyph_ids = cmap[data_ofs:data_ofs + entries]
+        elif fmt in (CMAP_SPARSE_FULL, CMAP_SPARSE_TINY):
+            unicode_list = cmap[data_ofs:data_ofs + entries * 2]
+            if fmt == CMAP_SPARSE_FULL:
+                glyph_ids = cmap[data_ofs + entries * 2:data_ofs + entries * 4]
+        cmaps.append((range_start, range_len, gid_start, entries, fmt, unicode_list, glyph_ids))
+
+    if 'kern' in tables:
+        print('  aviso: %s lleva kerning, se ignora' % os.path.basename(path))
+
+    # Layout del asset: cabecera, glyph_dsc, bitmaps, cmaps, listas
+    header_size = struct.calcsize(FONT_HEADER_FMT)
+    blob = bytearray(header_size)
+    pad_to(blob, 4)
+    glyph_dsc_offset = len(blob)
+    blob += glyph_dsc
+    bitmap_offset = len(blob)
+    blob += bitmap
+    pad_to(blob, 4)
+    cmaps_offset = len(blob)
+    blob += b'\0' * (struct.calcsize(FONT_CMAP_FMT) * cmap_num)
+
+    cmap_records = bytearray()
+    for range_start, range_len, gid_start, entries, fmt, unicode_list, glyph_ids in cmaps:
+        unicode_ofs = glyph_ids_ofs = 0
+        if unicode_list is not None:
+            pad_to(blob, 2)
+            unicode_ofs = len(blob)
+            blob += unicode_list
+        if glyph_ids is not None:
+            pad_to(blob, 2)
+            glyph_ids_ofs = len(blob)
+            blob += glyph_ids
+        cmap_records += struct.pack(FONT_CMAP_FMT, range_start, range_len, gid_start,
+                                    unicode_ofs, glyph_ids_ofs, entries, fmt, 0)
+    blob[cmaps_offset:cmaps_offset + len(cmap_records)] = cmap_records
+
+    struct.pack_into(FONT_HEADER_FMT, blob, 0, ascent - descent, -descent, underline_pos, underline_thick,
+                     bpp, subpx, cmap_num, count, glyph_dsc_offset, bitmap_offset, cmaps_offset)
+    return bytes(blob)
+
+
+class BitWriter:
+    def __init__(self):
+        self.buf = bytearray()
+        self.nbits = 0
+
+    def write(self, bit):
+        if self.nbits % 8 == 0:
+            self.buf.append(0)
+        if bit:
+            self.buf[-1] |= 0x80 >> (self.nbits % 8)
+        self.nbits += 1
+
+    def bytes(self):
+        return bytes(self.buf)
+
+
+# --- Pack ----------------------------------------------------------------
+
+def collect(input_dir):
+    assets = []
+    for sub in ('images', 'fonts', 'raw'):
+        folder = os.path.join(input_dir, sub)
+        if not os.path.isdir(folder):
+            continue
+        for fname in sorted(os.listdir(folder)):
+            path = os.path.join(folder, fname)
+            name, ext = os.path.splitext(fname)
+            ext = ext.lower()
+            if sub == 'images' and ext == '.png':
+                cf, w, h, stride, data = convert_png(path)
+                assets.append((name, TYPE_IMAGE, cf, w, h, stride, data))
+            elif sub == 'images' and ext == '.bin':
+                cf, w, h, stride, data = read_lvgl_image_bin(path)
+                assets.append((name, TYPE_IMAGE, cf, w, h, stride, data))
+            elif sub == 'fonts' and ext == '.bin':
+                assets.append((name, TYPE_FONT, 0, 0, 0, 0, convert_font(path)))
+            elif sub == 'raw':
+                assets.append((name, TYPE_RAW, 0, 0, 0, 0, open(path, 'rb').read()))
+    return assets
+
+
+def build_pack(assets):
+    by_hash = {}
+    for asset in assets:
+        h = fnv1a(asset[0])
+        if h in by_hash:
+            sys.exit('Colisión de hash entre "%s" y "%s": renombra uno' % (by_hash[h][0], asset[0]))
+        by_hash[h] = asset
+    ordered = sorted(by_hash.items())
+    if len(ordered) > 0xFFFF:
+        sys.exit('Demasiados assets')
+
+    names = bytearray()
+    name_offsets = []
+    names_offset = HEADER_SIZE + ENTRY_SIZE * len(ordered)
+    for _, asset in ordered:
+        name_offsets.append(names_offset + len(names))
+        names += asset[0].encode('utf-8') + b'\0'
+    data_offset = align(names_offset + len(names), DATA_ALIGN)
+
+    index = bytearray()
+    data = bytearray()
+    for (h, (name, typ, cf, w, h_px, stride, blob)), name_ofs in zip(ordered, name_offsets):
+        offset = data_offset + len(data)
+        index += struct.pack(ENTRY_FMT, h, name_ofs, offset, len(blob), typ, cf, w, h_px, stride)
+        data += blob
+        pad_to(data, DATA_ALIGN)
+
+    body = bytes(index) + bytes(names)
+    body += b'\0' * (data_offset - HEADER_SIZE - len(body))
+    total = data_offset + len(data)
+    header = struct.pack(HEADER_FMT, MAGIC, VERSION, len(ordered), names_offset, data_offset,
+                         total, zlib.crc32(body) & 0xFFFFFFFF, 0, 0)
+    return header + body + bytes(data)
+
+
+# --- Lector sobre fichero (mismo algoritmo que asset_pack_find) ---------------------
+
+class PackReader:
+    def __init__(self, data):
+        self.data = data
+        (magic, version, self.count, self.names_offset, self.data_offset, self.total,
+         crc, _r0, _r1) = struct.unpack_from(HEADER_FMT, data, 0)
+        if magic != MAGIC or version != VERSION:
+            raise ValueError('no es un pack de assets v%d' % VERSION)
+        if zlib.crc32(data[HEADER_SIZE:self.data_offset]) & 0xFFFFFFFF != crc:
+            raise ValueError('CRC del índice incorrecto')
+        self.entries = [struct.unpack_from(ENTRY_FMT, data, HEADER_SIZE + i * ENTRY_SIZE)
+                        for i in range(self.count)]
+
+    def name(self, entry):
+        end = self.data.index(b'\0', entry[1])
+        return self.data[entry[1]:end].decode('utf-8')
+
+    def find(self, name):
+        h = fnv1a(name)
+        lo, hi = 0, self.count
+        while lo < hi:
+            mid = (lo + hi) // 2
+            if self.entries[mid][0] < h:
+                lo = mid + 1
+            else:
+                hi = mid
+        if lo == self.count or self.entries[lo][0] != h or self.name(self.entries[lo]) != name:
+            return None
+        return self.entries[lo]
+
+
+def cmd_pack(args):
+    assets = collect(args.input)
+    pack = build_pack(assets)
+    if args.max_size and len(pack) > args.max_size:
+        sys.exit('El pack ocupa %d bytes y la partición %d' % (len(pack), args.max_size))
+    os.makedirs(os.path.dirname(os.path.abspath(args.output)), exist_ok=True)
+    with open(args.output, 'wb') as f:
+        f.write(pack)
+    print('%s: %d assets, %d bytes' % (args.output, len(assets), len(pack)))
+
+
+def cmd_list(args):
+    reader = PackReader(open(args.pack, 'rb').read())
+    print('%-24s %-6s %8s %8s  %s' % ('nombre', 'tipo', 'offset', 'bytes', 'imagen'))
+    for e in reader.entries:
+        extra = '%dx%d cf=0x%02x' % (e[6], e[7], e[5]) if e[4] == TYPE_IMAGE else ''
+        print('%-24s %-6s %8d %8d  %s' % (reader.name(e), TYPE_NAMES.get(e[4], '?'), e[2], e[3], extra))
+    print('%d assets, %d bytes' % (reader.count, reader.total))
+
+
+def cmd_bench(args):
+    reader = PackReader(open(args.pack, 'rb').read())
+    names = [reader.name(e) for e in reader.entries]
+    if not names:
+        sys.exit('Pack vacío')
+    for name in names:
+        assert reader.find(name) is not None, name
+    assert reader.find('__missing__') is None
+
+    t0 = time.perf_counter()
+    for _ in range(args.iterations):
+        for name in names:
+            reader.find(name)
+    elapsed = time.perf_counter() - t0
+    print('ABENCH,test,entries,iterations,ns_per_op')
+    print('ABENCH,lookup,%d,%d,%d' % (len(names), args.iterations,
+                                      elapsed * 1e9 / (args.iterations * len(names))))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    sub = parser.add_subparsers(dest='cmd', required=True)
+
+    p = sub.add_parser('pack')
+    p.add_argument('-i', '--input', default='assets')
+    p.add_argument('-o', '--output', default='build/assets.bin')
+    p.add_argument('--max-size', type=lambda v: int(v, 0), default=0)
+    p.set_defaults(func=cmd_pack)
+
+    p = sub.add_parser('list')
+    p.add_argument('pack')
+    p.set_defaults(func=cmd_list)
+
+    p = sub.add_parser('bench')
+    p.add_argument('pack')
+    p.add_argument('-n', '--iterations', type=int, default=10000)
+    p.set_defaults(func=cmd_bench)
+
+    args = parser.parse_args()
+    args.func(args)
+
+
+if __name__ == '__main__':
+    main()